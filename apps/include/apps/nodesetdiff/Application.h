@@ -0,0 +1,108 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef APPS_NODESETDIFF_APPLICATION_H
+#define APPS_NODESETDIFF_APPLICATION_H
+
+#include "apps/nodesetdiff/NodesetDiff.h"
+#include "apps/nodesetdiff/NodesetDigest.h"
+#include "include/nodesetexporter/logger/StdLog.h"
+
+#include <boost/program_options.hpp>
+
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace apps::nodesetdiff
+{
+
+/**
+ * @brief Utility for comparing two NodeSet2 unloadings (or their digest snapshots): the added, the removed and the changed nodes are printed
+ *        with the changed fields and the number of the changed references.
+ */
+class Application // NOLINT(cppcoreguidelines-special-member-functions)
+{
+    // OptionsCliPars method statuses
+    constexpr static int info_print = 0;
+    constexpr static int input_param = 1;
+
+    using Logger = ::nodesetexporter::logger::ConsoleLogger;
+    using LogLevel = ::nodesetexporter::common::LogLevel;
+
+public:
+    // Exit codes, as for diff: no differences, differences found, error.
+    constexpr static int exit_no_differences = 0;
+    constexpr static int exit_differences = 1;
+    constexpr static int exit_error = 2;
+
+    Application() = delete;
+
+    explicit Application(std::span<const char*> args)
+        : m_args(args)
+        , m_logger_main("logger main")
+    {
+    }
+
+#pragma region Helper_methods
+public:
+    /**
+     * @brief Displays hints for working with application parameters on the command line.
+     */
+    void PrintHelp(std::ostream& out, boost::program_options::options_description const& options_description) const;
+
+    /**
+     * @brief Displays the application version and related information.
+     */
+    void PrintVersion(std::ostream& out) const;
+
+    /**
+     * @brief Method for parsing command line parameters.
+     * @return INFO_PRINT - in the case of displaying help information, INPUT_PARAM - in the case of working with parameters.
+     */
+    int OptionsCliPars();
+
+#pragma endregion Helper_methods
+
+private:
+    /**
+     * @brief Reading of the unloading (the NodeSet2 XML document or the digest snapshot, detected by the content).
+     * @param filename The file of the unloading.
+     * @param handler The handler of the digests of the nodes.
+     * @return The number of the nodes read.
+     * @throw std::runtime_error The file can't be opened or is malformed.
+     */
+    size_t ReadUnloading(const std::string& filename, const NodeDigestHandler& handler);
+
+    /**
+     * @brief Printing of the difference of the node: "+ NodeId", "- NodeId" or "~ NodeId: fields; references +added -removed".
+     */
+    void PrintDifference(const NodesetDiff::Difference& difference);
+
+public:
+    /**
+     * @brief Comparison of the unloadings.
+     * @return exit_no_differences, exit_differences or exit_error.
+     */
+    int Run();
+
+private:
+    std::span<const char*> const m_args;
+
+    Logger m_logger_main;
+    FieldNames m_field_names;
+
+    std::string m_base_filename{};
+    std::string m_new_filename{};
+    std::string m_snapshot_filename{};
+    bool m_summary_only = false;
+};
+
+} // namespace apps::nodesetdiff
+
+#endif // APPS_NODESETDIFF_APPLICATION_H
@@ -0,0 +1,195 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef APPS_NODESETDIFF_NODESETDIFF_H
+#define APPS_NODESETDIFF_NODESETDIFF_H
+
+#include "apps/nodesetdiff/NodesetDigest.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace apps::nodesetdiff
+{
+
+/**
+ * @brief Comparison of two unloadings by the node digests. The digests of the base unloading are kept in the hash table, the nodes of the new unloading
+ *        are compared one by one as they are read and are removed from the table, so the comparison is a single linear pass over both unloadings,
+ *        and the memory is proportional to the number of the nodes of the base unloading. What is left in the table are the removed nodes.
+ */
+class NodesetDiff final
+{
+public:
+    /**
+     * @brief The difference of the node.
+     */
+    struct Difference
+    {
+        enum class Kind
+        {
+            Added,
+            Removed,
+            Changed
+        };
+
+        Kind kind;
+        std::string node_id;
+        std::vector<std::string> changed_fields; // Changed: the fields that are changed, added or removed.
+        size_t added_references = 0; // Changed: the references of the new node that the base node does not have.
+        size_t removed_references = 0; // Changed: the references of the base node that the new node does not have.
+    };
+
+    explicit NodesetDiff(const FieldNames& field_names)
+        : m_field_names(field_names)
+    {
+    }
+
+    /**
+     * @brief Adding the node of the base unloading. The repeated NodeId replaces the previous node.
+     */
+    void AddBaseNode(std::string&& node_id, NodeDigest&& digest)
+    {
+        m_base_nodes.insert_or_assign(std::move(node_id), std::move(digest));
+    }
+
+    /**
+     * @brief Comparison of the node of the new unloading with the base one.
+     * @return The difference or nullopt if the node is not changed.
+     */
+    std::optional<Difference> CompareNode(std::string&& node_id, const NodeDigest& digest)
+    {
+        ++m_number_of_compared_nodes;
+        const auto base_node = m_base_nodes.find(node_id);
+        if (base_node == m_base_nodes.end())
+        {
+            ++m_number_of_added_nodes;
+            return Difference{Difference::Kind::Added, std::move(node_id), {}};
+        }
+        Difference difference{Difference::Kind::Changed, std::move(node_id), {}};
+        CompareFields(base_node->second, digest, difference.changed_fields);
+        CompareReferences(base_node->second, digest, difference);
+        m_base_nodes.erase(base_node);
+        if (difference.changed_fields.empty() && difference.added_references == 0 && difference.removed_references == 0)
+        {
+            return std::nullopt;
+        }
+        ++m_number_of_changed_nodes;
+        return difference;
+    }
+
+    /**
+     * @brief The nodes of the base unloading that are missing in the new one, sorted by NodeId. Called after all the nodes of the new unloading are compared.
+     */
+    std::vector<Difference> TakeRemovedNodes()
+    {
+        std::vector<Difference> removed;
+        removed.reserve(m_base_nodes.size());
+        for (auto& base_node : m_base_nodes)
+        {
+            removed.push_back({Difference::Kind::Removed, base_node.first, {}});
+        }
+        m_base_nodes.clear();
+        std::sort(removed.begin(), removed.end(), [](const auto& left, const auto& right) { return left.node_id < right.node_id; });
+        m_number_of_removed_nodes += removed.size();
+        return removed;
+    }
+
+    [[nodiscard]] size_t GetNumberOfBaseNodes() const noexcept
+    {
+        return m_base_nodes.size();
+    }
+
+    [[nodiscard]] size_t GetNumberOfComparedNodes() const noexcept
+    {
+        return m_number_of_compared_nodes;
+    }
+
+    [[nodiscard]] size_t GetNumberOfAddedNodes() const noexcept
+    {
+        return m_number_of_added_nodes;
+    }
+
+    [[nodiscard]] size_t GetNumberOfRemovedNodes() const noexcept
+    {
+        return m_number_of_removed_nodes;
+    }
+
+    [[nodiscard]] size_t GetNumberOfChangedNodes() const noexcept
+    {
+        return m_number_of_changed_nodes;
+    }
+
+private:
+    // Merge walk over the sorted fields.
+    void CompareFields(const NodeDigest& base, const NodeDigest& current, std::vector<std::string>& changed_fields) const
+    {
+        auto base_field = base.fields.begin();
+        auto current_field = current.fields.begin();
+        while (base_field != base.fields.end() || current_field != current.fields.end())
+        {
+            if (current_field == current.fields.end() || (base_field != base.fields.end() && base_field->first < current_field->first))
+            {
+                changed_fields.push_back(m_field_names.Name(base_field->first));
+                ++base_field;
+            }
+            else if (base_field == base.fields.end() || current_field->first < base_field->first)
+            {
+                changed_fields.push_back(m_field_names.Name(current_field->first));
+                ++current_field;
+            }
+            else
+            {
+                if (base_field->second != current_field->second)
+                {
+                    changed_fields.push_back(m_field_names.Name(base_field->first));
+                }
+                ++base_field;
+                ++current_field;
+            }
+        }
+    }
+
+    // Merge walk over the sorted reference hashes, the repeated references are counted as the multiset.
+    static void CompareReferences(const NodeDigest& base, const NodeDigest& current, Difference& difference)
+    {
+        auto base_reference = base.references.begin();
+        auto current_reference = current.references.begin();
+        while (base_reference != base.references.end() || current_reference != current.references.end())
+        {
+            if (current_reference == current.references.end() || (base_reference != base.references.end() && *base_reference < *current_reference))
+            {
+                ++difference.removed_references;
+                ++base_reference;
+            }
+            else if (base_reference == base.references.end() || *current_reference < *base_reference)
+            {
+                ++difference.added_references;
+                ++current_reference;
+            }
+            else
+            {
+                ++base_reference;
+                ++current_reference;
+            }
+        }
+    }
+
+    const FieldNames& m_field_names;
+    std::unordered_map<std::string, NodeDigest> m_base_nodes;
+    size_t m_number_of_compared_nodes = 0;
+    size_t m_number_of_added_nodes = 0;
+    size_t m_number_of_removed_nodes = 0;
+    size_t m_number_of_changed_nodes = 0;
+};
+
+} // namespace apps::nodesetdiff
+
+#endif // APPS_NODESETDIFF_NODESETDIFF_H
@@ -0,0 +1,673 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef APPS_NODESETDIFF_NODESETDIGEST_H
+#define APPS_NODESETDIFF_NODESETDIGEST_H
+
+#include "apps/nodesetdiff/XmlStreamReader.h"
+#include "include/nodesetexporter/common/ContentHash.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace apps::nodesetdiff
+{
+
+using ::nodesetexporter::common::ContentHash;
+
+/**
+ * @brief The table of the names of the node fields (the XML attributes and the child elements of the node). The digests store the indices of the names
+ *        instead of the names, so the memory for the names does not depend on the number of the nodes.
+ */
+class FieldNames final
+{
+public:
+    /**
+     * @brief The index of the name, the unknown name is added.
+     */
+    uint32_t Index(std::string_view name)
+    {
+        const auto found = m_indices.find(std::string{name});
+        if (found != m_indices.end())
+        {
+            return found->second;
+        }
+        const auto index = static_cast<uint32_t>(m_names.size());
+        m_names.emplace_back(name);
+        m_indices.emplace(m_names.back(), index);
+        return index;
+    }
+
+    [[nodiscard]] const std::string& Name(uint32_t index) const
+    {
+        return m_names.at(index);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return m_names.size();
+    }
+
+private:
+    std::vector<std::string> m_names;
+    std::unordered_map<std::string, uint32_t> m_indices;
+};
+
+/**
+ * @brief Compact digest of the node: the hash of each field and the hash of each reference. Both lists are sorted, so the digests are compared
+ *        by the merge walk.
+ */
+struct NodeDigest
+{
+    std::vector<std::pair<uint32_t, uint64_t>> fields; // The index of the field name in FieldNames, the hash of the field content.
+    std::vector<uint64_t> references; // The hash of "ReferenceType|IsForward|Target".
+};
+
+using NodeDigestHandler = std::function<void(std::string&& node_id, NodeDigest&& digest)>;
+
+/**
+ * @brief Streaming reading of the NodeSet2 XML document into the node digests. The document is read in one pass, the digest of the node is passed
+ *        to the handler as soon as the node element is closed, so only one node is kept in memory.
+ *        To make the documents comparable regardless of the order of the namespace array, the namespace indices of the NodeIds
+ *        and of the BrowseNames are replaced by the namespace URIs ("ns=1;i=5" -> "nsu=http://...;i=5"), the aliases are resolved.
+ *        The content of the child elements (DisplayName, Value, Definition, ...) is hashed as the canonical subtree: the local names of the elements,
+ *        the attributes sorted by the name and the trimmed text, so the formatting of the document does not affect the digest.
+ * @warning The NodeIds inside the Value (ExtensionObject, NodeId values) are hashed as is, without the namespace normalization.
+ *          The default values of the XSD are not applied: the omitted attribute and the attribute with the default value are the different fields.
+ */
+class NodesetDigestReader final
+{
+public:
+    explicit NodesetDigestReader(FieldNames& field_names)
+        : m_field_names(field_names)
+    {
+    }
+
+    /**
+     * @brief Reading of the document.
+     * @param input The stream of the NodeSet2 XML document.
+     * @param handler The handler of the digests of the nodes in the order of the document.
+     * @return The number of the nodes read.
+     * @throw std::runtime_error The document is malformed or is not the NodeSet2 document.
+     */
+    size_t Read(std::istream& input, const NodeDigestHandler& handler)
+    {
+        m_namespace_uris.clear();
+        m_aliases.clear();
+        XmlStreamReader reader(input);
+        auto event = reader.Next();
+        while (event == XmlStreamReader::Event::Text)
+        {
+            event = reader.Next();
+        }
+        if (event != XmlStreamReader::Event::StartElement || reader.GetLocalName() != "UANodeSet")
+        {
+            throw std::runtime_error("The document is not the NodeSet2 document: the root element UANodeSet is missing");
+        }
+        size_t number_of_nodes = 0;
+        for (event = reader.Next(); event != XmlStreamReader::Event::EndElement; event = reader.Next())
+        {
+            if (event == XmlStreamReader::Event::EndOfDocument)
+            {
+                throw std::runtime_error("Unexpected end of the document");
+            }
+            if (event != XmlStreamReader::Event::StartElement)
+            {
+                continue;
+            }
+            const auto local_name = reader.GetLocalName();
+            if (local_name == "NamespaceUris")
+            {
+                ReadNamespaceUris(reader);
+            }
+            else if (local_name == "Aliases")
+            {
+                ReadAliases(reader);
+            }
+            else if (const auto* const node_id = reader.FindAttribute("NodeId"); node_id != nullptr)
+            {
+                auto normalized_node_id = NormalizeNodeId(*node_id);
+                handler(std::move(normalized_node_id), ReadNode(reader));
+                ++number_of_nodes;
+            }
+            else
+            {
+                SkipElement(reader); // Models, Extensions, LastModified...
+            }
+        }
+        return number_of_nodes;
+    }
+
+private:
+    // The attributes of the node elements, which contain the NodeIds.
+    static constexpr std::array<std::string_view, 4> node_id_attributes{"ParentNodeId", "DataType", "MethodDeclarationId", "ReferenceType"};
+
+    static std::string_view Trim(std::string_view text) noexcept
+    {
+        constexpr std::string_view spaces = " \t\r\n";
+        const auto begin = text.find_first_not_of(spaces);
+        if (begin == std::string_view::npos)
+        {
+            return {};
+        }
+        return text.substr(begin, text.find_last_not_of(spaces) - begin + 1);
+    }
+
+    static void SkipElement(XmlStreamReader& reader)
+    {
+        for (size_t depth = 1; depth > 0;)
+        {
+            switch (reader.Next())
+            {
+            case XmlStreamReader::Event::StartElement:
+                ++depth;
+                break;
+            case XmlStreamReader::Event::EndElement:
+                --depth;
+                break;
+            case XmlStreamReader::Event::EndOfDocument:
+                throw std::runtime_error("Unexpected end of the document");
+            default:
+                break;
+            }
+        }
+    }
+
+    // The text of the simple element: <Uri>text</Uri>
+    static std::string ReadElementText(XmlStreamReader& reader)
+    {
+        std::string text;
+        for (size_t depth = 1; depth > 0;)
+        {
+            switch (reader.Next())
+            {
+            case XmlStreamReader::Event::StartElement:
+                ++depth;
+                break;
+            case XmlStreamReader::Event::EndElement:
+                --depth;
+                break;
+            case XmlStreamReader::Event::Text:
+                text += reader.GetText();
+                break;
+            case XmlStreamReader::Event::EndOfDocument:
+                throw std::runtime_error("Unexpected end of the document");
+            }
+        }
+        return std::string{Trim(text)};
+    }
+
+    void ReadNamespaceUris(XmlStreamReader& reader)
+    {
+        for (auto event = reader.Next(); event != XmlStreamReader::Event::EndElement; event = reader.Next())
+        {
+            if (event == XmlStreamReader::Event::StartElement)
+            {
+                m_namespace_uris.push_back(ReadElementText(reader));
+            }
+            else if (event == XmlStreamReader::Event::EndOfDocument)
+            {
+                throw std::runtime_error("Unexpected end of the document");
+            }
+        }
+    }
+
+    void ReadAliases(XmlStreamReader& reader)
+    {
+        for (auto event = reader.Next(); event != XmlStreamReader::Event::EndElement; event = reader.Next())
+        {
+            if (event == XmlStreamReader::Event::StartElement)
+            {
+                const auto* const alias = reader.FindAttribute("Alias");
+                auto alias_name = alias != nullptr ? *alias : std::string{};
+                auto node_id = ReadElementText(reader);
+                m_aliases.insert_or_assign(std::move(alias_name), NormalizeNodeId(node_id));
+            }
+            else if (event == XmlStreamReader::Event::EndOfDocument)
+            {
+                throw std::runtime_error("Unexpected end of the document");
+            }
+        }
+    }
+
+    /**
+     * @brief Resolving of the alias and replacing of the namespace index by the URI. The unknown indices are left as is.
+     */
+    [[nodiscard]] std::string NormalizeNodeId(std::string_view node_id) const
+    {
+        node_id = Trim(node_id);
+        // The NodeId always has the identifier type ("i=", "s=", ...), the alias is the name.
+        if (node_id.find('=') == std::string_view::npos)
+        {
+            const auto alias = m_aliases.find(std::string{node_id});
+            return alias != m_aliases.end() ? alias->second : std::string{node_id};
+        }
+        if (!node_id.starts_with("ns="))
+        {
+            return std::string{node_id};
+        }
+        const auto separator = node_id.find(';');
+        if (separator == std::string_view::npos)
+        {
+            return std::string{node_id};
+        }
+        const auto* const uri = FindNamespaceUri(node_id.substr(3, separator - 3));
+        if (uri == nullptr)
+        {
+            return std::string{node_id};
+        }
+        return "nsu=" + *uri + std::string{node_id.substr(separator)};
+    }
+
+    /**
+     * @brief Replacing of the namespace index of the qualified name by the URI: "1:Name" -> "http://...:Name".
+     */
+    [[nodiscard]] std::string NormalizeQualifiedName(std::string_view name) const
+    {
+        const auto separator = name.find(':');
+        if (separator == std::string_view::npos)
+        {
+            return std::string{name};
+        }
+        const auto* const uri = FindNamespaceUri(name.substr(0, separator));
+        if (uri == nullptr)
+        {
+            return std::string{name};
+        }
+        return *uri + std::string{name.substr(separator)};
+    }
+
+    // The URI of the namespace index of the document (the index 1 is the first URI of NamespaceUris). nullptr for ns=0, not a number or out of the range.
+    [[nodiscard]] const std::string* FindNamespaceUri(std::string_view index_text) const
+    {
+        size_t index = 0;
+        if (index_text.empty() || index_text.size() > 5) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers) UInt16
+        {
+            return nullptr;
+        }
+        for (const auto symbol : index_text)
+        {
+            if (symbol < '0' || symbol > '9')
+            {
+                return nullptr;
+            }
+            index = index * 10 + static_cast<size_t>(symbol - '0'); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+        if (index == 0 || index > m_namespace_uris.size())
+        {
+            return nullptr;
+        }
+        return &m_namespace_uris[index - 1];
+    }
+
+    [[nodiscard]] std::string NormalizeAttribute(std::string_view name, std::string_view value) const
+    {
+        if (name == "BrowseName")
+        {
+            return NormalizeQualifiedName(value);
+        }
+        if (std::find(node_id_attributes.begin(), node_id_attributes.end(), name) != node_id_attributes.end())
+        {
+            return NormalizeNodeId(value);
+        }
+        return std::string{value};
+    }
+
+    static uint64_t HashOf(std::string_view content) noexcept
+    {
+        ContentHash hash;
+        hash.Update(content.data(), content.size());
+        return hash.Digest();
+    }
+
+    static void HashString(ContentHash& hash, std::string_view content) noexcept
+    {
+        hash.Update(content.data(), content.size());
+        hash.Update('\0'); // The separator, so that "ab"+"c" and "a"+"bc" are different.
+    }
+
+    /**
+     * @brief Reading of the node element after its start tag up to and including the end tag.
+     */
+    NodeDigest ReadNode(XmlStreamReader& reader)
+    {
+        NodeDigest digest;
+        digest.fields.emplace_back(m_field_names.Index("NodeClass"), HashOf(reader.GetLocalName()));
+        for (const auto& [name, value] : reader.GetAttributes())
+        {
+            if (name == "NodeId")
+            {
+                continue;
+            }
+            digest.fields.emplace_back(m_field_names.Index(name), HashOf(NormalizeAttribute(name, value)));
+        }
+
+        // The repeated child elements (DisplayName in several locales, ...) are added to the same hash in the order of the document.
+        std::vector<std::pair<uint32_t, ContentHash>> child_hashes;
+        for (auto event = reader.Next(); event != XmlStreamReader::Event::EndElement; event = reader.Next())
+        {
+            if (event == XmlStreamReader::Event::EndOfDocument)
+            {
+                throw std::runtime_error("Unexpected end of the document");
+            }
+            if (event != XmlStreamReader::Event::StartElement)
+            {
+                continue;
+            }
+            const auto local_name = reader.GetLocalName();
+            if (local_name == "References")
+            {
+                ReadReferences(reader, digest.references);
+                continue;
+            }
+            const auto index = m_field_names.Index(local_name);
+            auto child_hash = std::find_if(child_hashes.begin(), child_hashes.end(), [index](const auto& child) { return child.first == index; });
+            if (child_hash == child_hashes.end())
+            {
+                child_hash = child_hashes.insert(child_hashes.end(), {index, ContentHash{}});
+            }
+            HashSubtree(reader, child_hash->second);
+        }
+        for (const auto& [index, hash] : child_hashes)
+        {
+            digest.fields.emplace_back(index, hash.Digest());
+        }
+        std::sort(digest.fields.begin(), digest.fields.end());
+        std::sort(digest.references.begin(), digest.references.end());
+        return digest;
+    }
+
+    void ReadReferences(XmlStreamReader& reader, std::vector<uint64_t>& references)
+    {
+        for (auto event = reader.Next(); event != XmlStreamReader::Event::EndElement; event = reader.Next())
+        {
+            if (event == XmlStreamReader::Event::EndOfDocument)
+            {
+                throw std::runtime_error("Unexpected end of the document");
+            }
+            if (event != XmlStreamReader::Event::StartElement)
+            {
+                continue;
+            }
+            const auto* const reference_type = reader.FindAttribute("ReferenceType");
+            const auto* const is_forward = reader.FindAttribute("IsForward");
+            auto reference = reference_type != nullptr ? NormalizeNodeId(*reference_type) : std::string{};
+            reference += is_forward != nullptr && Trim(*is_forward) == "false" ? "|0|" : "|1|";
+            reference += NormalizeNodeId(ReadElementText(reader));
+            references.push_back(HashOf(reference));
+        }
+    }
+
+    /**
+     * @brief Hashing of the element after its start tag up to and including the end tag as the canonical subtree.
+     */
+    void HashSubtree(XmlStreamReader& reader, ContentHash& hash) const
+    {
+        const auto hash_start_tag = [this, &reader, &hash]
+        {
+            hash.Update('<');
+            HashString(hash, reader.GetLocalName());
+            auto attributes = reader.GetAttributes();
+            std::sort(attributes.begin(), attributes.end());
+            for (const auto& [name, value] : attributes)
+            {
+                if (name == "xmlns" || name.starts_with("xmlns:"))
+                {
+                    continue; // The namespace declarations are the formatting of the document.
+                }
+                HashString(hash, XmlStreamReader::LocalName(name));
+                HashString(hash, NormalizeAttribute(XmlStreamReader::LocalName(name), value));
+            }
+        };
+        hash_start_tag();
+        for (size_t depth = 1; depth > 0;)
+        {
+            switch (reader.Next())
+            {
+            case XmlStreamReader::Event::StartElement:
+                ++depth;
+                hash_start_tag();
+                break;
+            case XmlStreamReader::Event::EndElement:
+                --depth;
+                hash.Update('>');
+                break;
+            case XmlStreamReader::Event::Text:
+                if (const auto text = Trim(reader.GetText()); !text.empty())
+                {
+                    hash.Update('"');
+                    HashString(hash, text);
+                }
+                break;
+            case XmlStreamReader::Event::EndOfDocument:
+                throw std::runtime_error("Unexpected end of the document");
+            }
+        }
+    }
+
+    FieldNames& m_field_names;
+    std::vector<std::string> m_namespace_uris;
+    std::unordered_map<std::string, std::string> m_aliases;
+};
+
+/**
+ * @brief Binary snapshot of the digests of the document. The snapshot is much smaller than the document and is read without the XML parsing,
+ *        so the unloading can be compared with the previous one without keeping the previous XML file.
+ *        Format (little-endian): the magic "NSDIGST1", then the records:
+ *        'F' u32 size, name - the definition of the next field name (the indices of the snapshot are numbered from 0 in the order of the definitions);
+ *        'N' u32 size, NodeId, u32 number of fields, {u32 field index, u64 hash}..., u32 number of references, {u64 hash}... - the node;
+ *        'E' - the end of the snapshot.
+ */
+class NodesetSnapshot final
+{
+public:
+    static constexpr std::string_view magic = "NSDIGST1";
+
+    /**
+     * @brief Checking the beginning of the stream for the snapshot magic. The stream position is restored.
+     */
+    static bool IsSnapshot(std::istream& input)
+    {
+        std::array<char, magic.size()> header{};
+        const auto position = input.tellg();
+        input.read(header.data(), header.size());
+        const bool is_snapshot = input.gcount() == static_cast<std::streamsize>(header.size()) && std::string_view(header.data(), header.size()) == magic;
+        input.clear();
+        input.seekg(position);
+        return is_snapshot;
+    }
+
+    /**
+     * @brief Writer of the snapshot, the nodes are written as they are read.
+     */
+    class Writer final
+    {
+    public:
+        Writer(std::ostream& output, const FieldNames& field_names)
+            : m_output(output)
+            , m_field_names(field_names)
+        {
+            m_output.write(magic.data(), magic.size());
+        }
+
+        void Write(const std::string& node_id, const NodeDigest& digest)
+        {
+            // The field names that appeared since the previous node are defined before the node.
+            for (; m_number_of_written_names < m_field_names.Size(); ++m_number_of_written_names)
+            {
+                const auto& name = m_field_names.Name(static_cast<uint32_t>(m_number_of_written_names));
+                m_output.put('F');
+                WriteString(name);
+            }
+            m_output.put('N');
+            WriteString(node_id);
+            WriteInteger(static_cast<uint32_t>(digest.fields.size()));
+            for (const auto& [index, hash] : digest.fields)
+            {
+                WriteInteger(index);
+                WriteInteger(hash);
+            }
+            WriteInteger(static_cast<uint32_t>(digest.references.size()));
+            for (const auto hash : digest.references)
+            {
+                WriteInteger(hash);
+            }
+        }
+
+        /**
+         * @brief Completion of the snapshot.
+         * @return false in case of the write error.
+         */
+        bool Finish()
+        {
+            m_output.put('E');
+            m_output.flush();
+            return m_output.good();
+        }
+
+    private:
+        template <typename TInteger>
+        void WriteInteger(TInteger value)
+        {
+            std::array<char, sizeof(TInteger)> bytes{};
+            for (auto& byte : bytes)
+            {
+                byte = static_cast<char>(value & 0xFFU); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                value >>= 8U; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+            m_output.write(bytes.data(), bytes.size());
+        }
+
+        void WriteString(const std::string& value)
+        {
+            WriteInteger(static_cast<uint32_t>(value.size()));
+            m_output.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+
+        std::ostream& m_output;
+        const FieldNames& m_field_names;
+        size_t m_number_of_written_names = 0;
+    };
+
+    /**
+     * @brief Reading of the snapshot. The field indices of the snapshot are translated to the indices of the field name table.
+     * @param input The stream of the snapshot.
+     * @param field_names The field name table.
+     * @param handler The handler of the digests of the nodes in the order of the snapshot.
+     * @return The number of the nodes read.
+     * @throw std::runtime_error The snapshot is malformed.
+     */
+    static size_t Read(std::istream& input, FieldNames& field_names, const NodeDigestHandler& handler)
+    {
+        std::array<char, magic.size()> header{};
+        input.read(header.data(), header.size());
+        if (input.gcount() != static_cast<std::streamsize>(header.size()) || std::string_view(header.data(), header.size()) != magic)
+        {
+            throw std::runtime_error("The stream is not the digest snapshot");
+        }
+        std::vector<uint32_t> indices; // Snapshot index -> table index
+        size_t number_of_nodes = 0;
+        for (;;)
+        {
+            const auto record = input.get();
+            if (record == 'E')
+            {
+                return number_of_nodes;
+            }
+            if (record == 'F')
+            {
+                indices.push_back(field_names.Index(ReadString(input)));
+            }
+            else if (record == 'N')
+            {
+                auto node_id = ReadString(input);
+                NodeDigest digest;
+                digest.fields.resize(ReadCount(input, sizeof(uint32_t) + sizeof(uint64_t)));
+                for (auto& [index, hash] : digest.fields)
+                {
+                    const auto snapshot_index = ReadInteger<uint32_t>(input);
+                    if (snapshot_index >= indices.size())
+                    {
+                        throw std::runtime_error("The digest snapshot is malformed: unknown field index");
+                    }
+                    index = indices[snapshot_index];
+                    hash = ReadInteger<uint64_t>(input);
+                }
+                digest.references.resize(ReadCount(input, sizeof(uint64_t)));
+                for (auto& hash : digest.references)
+                {
+                    hash = ReadInteger<uint64_t>(input);
+                }
+                // The indices of the table may differ from the indices of the snapshot, so the order is restored.
+                std::sort(digest.fields.begin(), digest.fields.end());
+                handler(std::move(node_id), std::move(digest));
+                ++number_of_nodes;
+            }
+            else
+            {
+                throw std::runtime_error("The digest snapshot is malformed or truncated");
+            }
+        }
+    }
+
+private:
+    // The limit of the sizes, so that the damaged snapshot does not lead to the huge allocations.
+    static constexpr uint32_t max_record_size = 1U << 24U;
+
+    template <typename TInteger>
+    static TInteger ReadInteger(std::istream& input)
+    {
+        std::array<char, sizeof(TInteger)> bytes{};
+        input.read(bytes.data(), bytes.size());
+        if (input.gcount() != static_cast<std::streamsize>(bytes.size()))
+        {
+            throw std::runtime_error("The digest snapshot is truncated");
+        }
+        TInteger value = 0;
+        for (auto byte = bytes.rbegin(); byte != bytes.rend(); ++byte)
+        {
+            value = static_cast<TInteger>((value << 8U) | static_cast<unsigned char>(*byte)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+        return value;
+    }
+
+    static size_t ReadCount(std::istream& input, size_t element_size)
+    {
+        const auto count = ReadInteger<uint32_t>(input);
+        if (count > max_record_size / element_size)
+        {
+            throw std::runtime_error("The digest snapshot is malformed: the record is too large");
+        }
+        return count;
+    }
+
+    static std::string ReadString(std::istream& input)
+    {
+        std::string value(ReadCount(input, 1), '\0');
+        input.read(value.data(), static_cast<std::streamsize>(value.size()));
+        if (input.gcount() != static_cast<std::streamsize>(value.size()))
+        {
+            throw std::runtime_error("The digest snapshot is truncated");
+        }
+        return value;
+    }
+};
+
+} // namespace apps::nodesetdiff
+
+#endif // APPS_NODESETDIFF_NODESETDIGEST_H
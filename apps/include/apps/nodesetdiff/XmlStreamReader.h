@@ -0,0 +1,480 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef APPS_NODESETDIFF_XMLSTREAMREADER_H
+#define APPS_NODESETDIFF_XMLSTREAMREADER_H
+
+#include <cstdint>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace apps::nodesetdiff
+{
+
+/**
+ * @brief Minimal streaming (pull) XML reader. The document is read from the stream by the blocks, only the current token is kept in memory,
+ *        so the memory does not depend on the size of the document.
+ *        The constructs used by the NodeSet2 documents are supported: the elements, the attributes, the text, CDATA, the predefined and the numeric
+ *        character references. The comments, the processing instructions and DOCTYPE are skipped, the DTD entities are not supported.
+ *        The empty element (<Element/>) gives the StartElement and EndElement events. The well-formedness is checked only for the nesting depth.
+ */
+class XmlStreamReader final
+{
+public:
+    enum class Event
+    {
+        StartElement,
+        EndElement,
+        Text,
+        EndOfDocument
+    };
+
+    using Attributes = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr size_t buffer_size = 1U << 16U;
+
+    explicit XmlStreamReader(std::istream& input)
+        : m_input(input)
+        , m_buffer(buffer_size)
+    {
+    }
+
+    /**
+     * @brief Reading of the next token.
+     * @return The event of the token. The name, the attributes and the text of the token are available until the next call.
+     * @throw std::runtime_error The document is malformed.
+     */
+    Event Next()
+    {
+        if (m_is_pending_end)
+        {
+            m_is_pending_end = false;
+            --m_depth;
+            return Event::EndElement;
+        }
+        m_text.clear();
+        for (;;)
+        {
+            auto symbol = Peek();
+            if (symbol == end_of_stream)
+            {
+                if (m_depth != 0)
+                {
+                    throw Error("unexpected end of the document");
+                }
+                return Event::EndOfDocument;
+            }
+            if (symbol != '<')
+            {
+                ReadText();
+                return Event::Text;
+            }
+            Get(); // '<'
+            symbol = Get();
+            if (symbol == '?')
+            {
+                SkipUntil("?>");
+                continue;
+            }
+            if (symbol == '!')
+            {
+                if (Peek() == '-')
+                {
+                    Expect("--");
+                    SkipUntil("-->");
+                    continue;
+                }
+                if (Peek() == '[')
+                {
+                    Expect("[CDATA[");
+                    ReadUntil("]]>", m_text);
+                    return Event::Text;
+                }
+                SkipDeclaration();
+                continue;
+            }
+            if (symbol == '/')
+            {
+                ReadName(Get(), m_name);
+                SkipSpaces();
+                Expect(">");
+                if (m_depth == 0)
+                {
+                    throw Error("unexpected end tag '" + m_name + "'");
+                }
+                --m_depth;
+                return Event::EndElement;
+            }
+            ReadStartTag(symbol);
+            return Event::StartElement;
+        }
+    }
+
+    /**
+     * @brief The qualified name of the element (StartElement, EndElement).
+     */
+    [[nodiscard]] const std::string& GetName() const noexcept
+    {
+        return m_name;
+    }
+
+    /**
+     * @brief The name of the element without the namespace prefix.
+     */
+    [[nodiscard]] std::string_view GetLocalName() const noexcept
+    {
+        return LocalName(m_name);
+    }
+
+    /**
+     * @brief The attributes of the element in the order of the document (StartElement).
+     */
+    [[nodiscard]] const Attributes& GetAttributes() const noexcept
+    {
+        return m_attributes;
+    }
+
+    /**
+     * @brief Searching of the attribute of the element by the qualified name.
+     * @return The value or nullptr if the attribute is missing.
+     */
+    [[nodiscard]] const std::string* FindAttribute(std::string_view name) const noexcept
+    {
+        for (const auto& [attribute_name, value] : m_attributes)
+        {
+            if (attribute_name == name)
+            {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief The text with the character references replaced (Text).
+     */
+    [[nodiscard]] const std::string& GetText() const noexcept
+    {
+        return m_text;
+    }
+
+    /**
+     * @brief The current line of the document, for the error messages.
+     */
+    [[nodiscard]] size_t GetLine() const noexcept
+    {
+        return m_line;
+    }
+
+    [[nodiscard]] static std::string_view LocalName(std::string_view name) noexcept
+    {
+        const auto prefix_end = name.find(':');
+        return prefix_end == std::string_view::npos ? name : name.substr(prefix_end + 1);
+    }
+
+private:
+    static constexpr int end_of_stream = -1;
+
+    [[nodiscard]] std::runtime_error Error(const std::string& message) const
+    {
+        return std::runtime_error("XML error at line " + std::to_string(m_line) + ": " + message);
+    }
+
+    int Peek()
+    {
+        if (m_position == m_size)
+        {
+            m_input.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_size = static_cast<size_t>(m_input.gcount());
+            m_position = 0;
+            if (m_size == 0)
+            {
+                return end_of_stream;
+            }
+        }
+        return static_cast<unsigned char>(m_buffer[m_position]);
+    }
+
+    int Get()
+    {
+        const auto symbol = Peek();
+        if (symbol != end_of_stream)
+        {
+            ++m_position;
+            m_line += static_cast<size_t>(symbol == '\n');
+        }
+        return symbol;
+    }
+
+    [[nodiscard]] static bool IsSpace(int symbol) noexcept
+    {
+        return symbol == ' ' || symbol == '\t' || symbol == '\n' || symbol == '\r';
+    }
+
+    void SkipSpaces()
+    {
+        while (IsSpace(Peek()))
+        {
+            Get();
+        }
+    }
+
+    void Expect(std::string_view expected)
+    {
+        for (const auto symbol : expected)
+        {
+            if (Get() != symbol)
+            {
+                throw Error(std::string{"expected '"} + std::string{expected} + "'");
+            }
+        }
+    }
+
+    // Skipping of the content up to and including the terminator.
+    void SkipUntil(std::string_view terminator)
+    {
+        size_t matched = 0;
+        while (matched < terminator.size())
+        {
+            const auto symbol = Get();
+            if (symbol == end_of_stream)
+            {
+                throw Error("unexpected end of the document, expected '" + std::string{terminator} + "'");
+            }
+            // The terminators do not repeat their first symbol inside, so the simple restart of the matching is enough.
+            matched = symbol == terminator[matched] ? matched + 1 : static_cast<size_t>(symbol == terminator[0]);
+        }
+    }
+
+    void ReadUntil(std::string_view terminator, std::string& out)
+    {
+        for (;;)
+        {
+            const auto symbol = Get();
+            if (symbol == end_of_stream)
+            {
+                throw Error("unexpected end of the document, expected '" + std::string{terminator} + "'");
+            }
+            out.push_back(static_cast<char>(symbol));
+            if (out.size() >= terminator.size() && std::string_view(out).substr(out.size() - terminator.size()) == terminator)
+            {
+                out.resize(out.size() - terminator.size());
+                return;
+            }
+        }
+    }
+
+    // <!DOCTYPE ...> with the possible internal subset in the square brackets.
+    void SkipDeclaration()
+    {
+        int brackets = 0;
+        for (;;)
+        {
+            const auto symbol = Get();
+            if (symbol == end_of_stream)
+            {
+                throw Error("unexpected end of the document in the declaration");
+            }
+            brackets += static_cast<int>(symbol == '[') - static_cast<int>(symbol == ']');
+            if (symbol == '>' && brackets <= 0)
+            {
+                return;
+            }
+        }
+    }
+
+    void ReadName(int first_symbol, std::string& name)
+    {
+        name.clear();
+        for (auto symbol = first_symbol;; symbol = Get())
+        {
+            if (symbol == end_of_stream)
+            {
+                throw Error("unexpected end of the document in the name");
+            }
+            name.push_back(static_cast<char>(symbol));
+            const auto next = Peek();
+            if (IsSpace(next) || next == '/' || next == '>' || next == '=' || next == end_of_stream)
+            {
+                break;
+            }
+        }
+        if (name.empty() || IsSpace(static_cast<unsigned char>(name.front())) || name.front() == '>' || name.front() == '/')
+        {
+            throw Error("invalid name");
+        }
+    }
+
+    void ReadStartTag(int first_symbol)
+    {
+        ReadName(first_symbol, m_name);
+        m_attributes.clear();
+        for (;;)
+        {
+            SkipSpaces();
+            const auto symbol = Get();
+            if (symbol == '>')
+            {
+                break;
+            }
+            if (symbol == '/')
+            {
+                Expect(">");
+                m_is_pending_end = true;
+                break;
+            }
+            if (symbol == end_of_stream)
+            {
+                throw Error("unexpected end of the document in the tag '" + m_name + "'");
+            }
+            auto& [attribute_name, value] = m_attributes.emplace_back();
+            ReadName(symbol, attribute_name);
+            SkipSpaces();
+            Expect("=");
+            SkipSpaces();
+            const auto quote = Get();
+            if (quote != '"' && quote != '\'')
+            {
+                throw Error("the value of the attribute '" + attribute_name + "' is not quoted");
+            }
+            for (auto value_symbol = Get(); value_symbol != quote; value_symbol = Get())
+            {
+                if (value_symbol == end_of_stream || value_symbol == '<')
+                {
+                    throw Error("unterminated value of the attribute '" + attribute_name + "'");
+                }
+                if (value_symbol == '&')
+                {
+                    AppendReference(value);
+                }
+                else
+                {
+                    // Normalization of the attribute value: the whitespace symbols are replaced by the space.
+                    value.push_back(IsSpace(value_symbol) ? ' ' : static_cast<char>(value_symbol));
+                }
+            }
+        }
+        ++m_depth;
+    }
+
+    void ReadText()
+    {
+        for (auto symbol = Peek(); symbol != '<' && symbol != end_of_stream; symbol = Peek())
+        {
+            Get();
+            if (symbol == '&')
+            {
+                AppendReference(m_text);
+            }
+            else
+            {
+                m_text.push_back(static_cast<char>(symbol));
+            }
+        }
+    }
+
+    // The character reference after '&': &lt; &gt; &amp; &quot; &apos; &#NN; &#xHH;
+    void AppendReference(std::string& out)
+    {
+        static constexpr size_t max_reference_size = 10;
+        std::string reference;
+        for (auto symbol = Get(); symbol != ';'; symbol = Get())
+        {
+            if (symbol == end_of_stream || reference.size() > max_reference_size)
+            {
+                throw Error("invalid character reference");
+            }
+            reference.push_back(static_cast<char>(symbol));
+        }
+        if (reference == "lt")
+        {
+            out.push_back('<');
+        }
+        else if (reference == "gt")
+        {
+            out.push_back('>');
+        }
+        else if (reference == "amp")
+        {
+            out.push_back('&');
+        }
+        else if (reference == "quot")
+        {
+            out.push_back('"');
+        }
+        else if (reference == "apos")
+        {
+            out.push_back('\'');
+        }
+        else if (reference.size() > 1 && reference.front() == '#')
+        {
+            const bool is_hex = reference[1] == 'x' || reference[1] == 'X';
+            uint32_t code_point = 0;
+            try
+            {
+                code_point = static_cast<uint32_t>(std::stoul(reference.substr(is_hex ? 2 : 1), nullptr, is_hex ? 16 : 10)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+            catch (const std::logic_error&)
+            {
+                throw Error("invalid character reference '&" + reference + ";'");
+            }
+            AppendUtf8(code_point, out);
+        }
+        else
+        {
+            throw Error("unknown entity '&" + reference + ";'");
+        }
+    }
+
+    static void AppendUtf8(uint32_t code_point, std::string& out)
+    {
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        if (code_point < 0x80U)
+        {
+            out.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800U)
+        {
+            out.push_back(static_cast<char>(0xC0U | (code_point >> 6U)));
+            out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+        }
+        else if (code_point < 0x10000U)
+        {
+            out.push_back(static_cast<char>(0xE0U | (code_point >> 12U)));
+            out.push_back(static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0U | (code_point >> 18U)));
+            out.push_back(static_cast<char>(0x80U | ((code_point >> 12U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (code_point & 0x3FU)));
+        }
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+
+    std::istream& m_input;
+    std::vector<char> m_buffer;
+    size_t m_position = 0;
+    size_t m_size = 0;
+    size_t m_line = 1;
+    size_t m_depth = 0;
+    bool m_is_pending_end = false;
+    std::string m_name;
+    Attributes m_attributes;
+    std::string m_text;
+};
+
+} // namespace apps::nodesetdiff
+
+#endif // APPS_NODESETDIFF_XMLSTREAMREADER_H
@@ -13,15 +13,24 @@
 #include "include/nodesetexporter/NodesetExporter.h"
 #include "include/nodesetexporter/logger/LogPlugin.h"
 #include "include/nodesetexporter/logger/StdLog.h"
+#include "include/nodesetexporter/open62541/DiscoveryRules.h"
+#include "include/nodesetexporter/open62541/NodesetFileWrappers.h"
+#include "include/nodesetexporter/open62541/SecurityProfile.h"
+#include "include/nodesetexporter/open62541/TransportProfile.h"
 #include "include/nodesetexporter/open62541/UATypesContainer.h"
 
 #include <open62541/client_config_default.h>
 
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/program_options.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
 #include <span>
+#include <stop_token>
 #include <thread>
 
 namespace apps::nodesetexporter
@@ -30,6 +39,7 @@ namespace apps::nodesetexporter
 using StatusResults = ::nodesetexporter::common::statuses::StatusResults<int64_t>;
 using ::nodesetexporter::open62541::UATypesContainer;
 using Open62541LogPlugin = ::nodesetexporter::logger::Open62541LogPlugin;
+using Open62541NodesetFileWrapper = ::nodesetexporter::open62541::Open62541NodesetFileWrapper;
 
 class InterruptException : public std::runtime_error
 {
@@ -52,6 +62,9 @@ class Application // NOLINT(cppcoreguidelines-special-member-functions)
     constexpr static int fail = 1;
 
     constexpr static uint32_t client_timeout_default_ms = 5000;
+    constexpr static auto client_iterate_interval = std::chrono::milliseconds(1);
+    // The seed of the sampling of the estimation, the repeated estimation of the same address space gives the same result.
+    constexpr static uint32_t estimate_seed = 62541;
 
     using Logger = ::nodesetexporter::logger::ConsoleLogger;
     using LogLevel = ::nodesetexporter::common::LogLevel;
@@ -63,6 +76,7 @@ public:
         : m_args(args)
         , m_logger_main("logger main")
         , m_signal_set(m_io_context)
+        , m_client_iterate_timer(m_io_context)
         , m_opc_nodesetexporter_logger("logger nodesetexporter")
         , m_opc_ua_client_logger("opc-ua-client")
 #ifdef OPEN62541_VER_1_4
@@ -104,6 +118,12 @@ public:
      */
     void SignalSet();
 
+    /**
+     * @brief Processing of the client in the event loop: sending of the requests, receiving of the responses and checking of the timeouts (UA_Client_run_iterate).
+     *        Repeats by timer while the client belongs to the event loop (asynchronous export mode).
+     */
+    void ClientIterate();
+
 #pragma endregion Helper_methods
 
 private:
@@ -121,6 +141,63 @@ private:
      */
     StatusResults CheckStartNodeCrossing(std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids);
 
+    /**
+     * @brief Round-trip verification of the produced file: the file is loaded back and compared with the data source node by node ("--roundtrip" parameter).
+     *        The mismatches and the timing of the phases are logged.
+     * @param node_ids Lists of the exported nodes.
+     * @param filename The produced file.
+     * @return The result of the operation. Fail only if the verification could not be performed, the mismatches do not change the result.
+     */
+    StatusResults VerifyRoundTrip(const std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids, const std::string& filename);
+
+    /**
+     * @brief Connecting of the client to the server by the endpoint and, if specified, by the user name and password.
+     *        Used for the first connection and for the reconnection after the loss of the session ("--reconnect" parameter).
+     * @return The status of the connection.
+     */
+    UA_StatusCode ConnectClient(UA_Client& client);
+
+    /**
+     * @brief Estimation of the export instead of the export ("--estimate" parameter): the subtrees of the start nodes are browsed completely or by the sampling,
+     *        the node counts and the forecast of the export are logged.
+     * @return The result of the operation. Fail if the browsing fails.
+     */
+    StatusResults EstimateExport();
+
+    /**
+     * @brief Reading of the limits of the requests of the connected client and, if "--maxnrd" is not set, derivation of the number of max nodes to request data from them.
+     */
+    void DeriveRequestLimits();
+
+    /**
+     * @brief Filling the security profile from the "--secmode" and "--secpolicy" parameters.
+     * @return The result of the operation. Fail if the mode or the policy is unknown.
+     */
+    StatusResults PrepareSecurityProfile();
+
+    /**
+     * @brief Measuring of the crypto overhead per chunk of the secured channel and output to the performance report ("--perftimer" parameter).
+     */
+    void LogCryptoOverhead();
+
+    /**
+     * @brief Filling the attribute projection of the export options from the "--attrprofile" and "--attributes" parameters.
+     * @return The result of the operation. Fail if the profile or the attribute name is unknown.
+     */
+    StatusResults PrepareAttributeProjection();
+
+    /**
+     * @brief Forming the include/exclude rules of the browsing of the node lists from the "--rule" and "--maxdepth" parameters.
+     * @return The result of the operation. Fail if the rule is invalid.
+     */
+    StatusResults PrepareDiscoveryFilter();
+
+    /**
+     * @brief Forming the View of the browsing from the "--view", "--viewtime" and "--viewversion" parameters.
+     * @return The result of the operation. Fail if the View node ID or the time is invalid.
+     */
+    StatusResults PrepareView();
+
 public:
     /**
      * @brief Initialization and startup process.
@@ -133,11 +210,18 @@ private:
 
     std::thread m_export_thread;
     std::future<int> m_future_thread_result;
+    // The first stop signal requests a cooperative stop of the export, so that the partial unloading is saved.
+    // The second one interrupts the client session.
+    std::stop_source m_stop_source;
+    std::atomic_bool m_export_started{false};
 
     // The context is needed to wait for the force shutdown signal in the main thread.
     // For this, the main export loop will be executed in a separate thread.
     boost::asio::io_context m_io_context;
     boost::asio::signal_set m_signal_set;
+    // In the asynchronous export mode, the client is iterated by this timer in the event loop thread, and the export thread only waits for the responses.
+    boost::asio::steady_timer m_client_iterate_timer;
+    bool m_client_in_event_loop{false}; // Used only in the event loop thread
 
     // Logging objects
     Logger m_logger_main;
@@ -148,16 +232,55 @@ private:
 #endif
 
     UA_Client* m_client = nullptr;
+    // The data source instead of the client, if the NodeSet2 XML file is specified.
+    std::unique_ptr<Open62541NodesetFileWrapper> m_nodeset_file;
 
     std::string m_client_endpointUrl{};
+    std::string m_nodeset_source{};
     std::vector<std::string> m_start_node_ids{};
     std::string m_user_name{};
     std::string m_password{};
     std::string m_export_filename{};
     std::string m_parent_start_node_replacer{};
+    std::string m_attribute_profile{};
+    std::string m_types_filename{};
+    std::string m_types_model_uri{};
+    std::string m_instances_model_uri{};
+    std::vector<std::string> m_custom_attributes{};
+    std::vector<std::string> m_locales{};
     u_int32_t m_number_of_max_nodes_to_request_data{0};
+    u_int32_t m_number_of_max_array_elements_to_request_data{0};
     u_int32_t m_client_timeout{client_timeout_default_ms};
+    ::nodesetexporter::open62541::transport::TransportProfile m_transport_profile{};
+    ::nodesetexporter::open62541::transport::RequestLimits m_request_limits{};
+    std::string m_security_mode{};
+    std::string m_security_policy{};
+    ::nodesetexporter::open62541::security::SecurityProfile m_security_profile{};
     bool m_perf_timer{false};
+    bool m_async_client{false};
+    bool m_type_closure{false};
+    std::vector<std::string> m_discovery_rules{};
+    u_int32_t m_max_browse_depth{0};
+    std::string m_view_id{};
+    std::string m_view_timestamp{};
+    u_int32_t m_view_version{0};
+    double m_estimate_fraction{0};
+    bool m_cross_list_deduplication{false};
+    bool m_canonical{false};
+    bool m_skip_unchanged{false};
+    bool m_self_check{false};
+    bool m_round_trip{false};
+    u_int32_t m_max_requests_in_flight{0};
+    u_int32_t m_reconnect_attempts{0};
+    u_int32_t m_reconnect_budget{0};
+    u_int32_t m_reconnect_backoff{0};
+    double m_max_requests_per_second{0};
+    double m_max_operations_per_second{0};
+    double m_max_bytes_per_second{0};
+    bool m_adaptive_rate{false};
+    std::vector<std::string> m_quirk_fixers{};
+    ::nodesetexporter::open62541::discovery::DiscoveryFilter m_discovery_filter{};
+    UATypesContainer<UA_ViewDescription> m_view{UA_TYPES_VIEWDESCRIPTION};
     ::nodesetexporter::Options m_opt{};
 };
 
@@ -0,0 +1,224 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "apps/nodesetdiff/Application.h"
+
+#include "include/nodesetexporter/Build.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace apps::nodesetdiff
+{
+namespace prog_opt = boost::program_options;
+namespace build = build;
+
+#pragma region Helper_methods
+
+void Application::PrintHelp(std::ostream& out, const boost::program_options::options_description& options_description) const
+{
+    out << "Usage: " << m_args[0] << " [options]" << std::endl;
+    out << options_description;
+}
+
+void Application::PrintVersion(std::ostream& out) const
+{
+    out << "Application version: " << build::version << std::endl;
+    out << "Git hash: " << build::git_revision << std::endl;
+    out << "Compiler: " << build::compiler << std::endl;
+    out << "Build type: " << build::build_type << std::endl;
+}
+
+int Application::OptionsCliPars()
+{
+    prog_opt::options_description cli_options("Options");
+    cli_options.add_options()("help,h", "Show hints");
+    cli_options.add_options()("version,v", "Show version");
+    cli_options.add_options()("base,b", boost::program_options::value<>(&m_base_filename)->required(), "The base unloading: NodeSet2 XML file or digest snapshot");
+    cli_options.add_options()("new,n", boost::program_options::value<>(&m_new_filename)->required(), "The new unloading: NodeSet2 XML file or digest snapshot");
+    cli_options.add_options()(
+        "snapshot,s",
+        boost::program_options::value<>(&m_snapshot_filename),
+        "Path with filename to save the digest snapshot of the new unloading, which can be used as the base next time");
+    cli_options.add_options()("summary", boost::program_options::value<>(&m_summary_only)->default_value(false), "Print only the summary without the list of the nodes (true/false)");
+
+    prog_opt::variables_map var_map;
+    try
+    {
+        prog_opt::store(prog_opt::command_line_parser(static_cast<int>(m_args.size()), m_args.data()).options(cli_options).run(), var_map);
+        prog_opt::notify(var_map);
+    }
+    catch (boost::program_options::unknown_option& e) // Error reading command line parameters.
+    {
+        std::cout << e.what() << std::endl;
+        PrintHelp(std::cerr, cli_options);
+        return info_print;
+    }
+    catch (boost::program_options::required_option& e) // If a required value is not entered
+    {
+        if (var_map.count("version") != 0U)
+        {
+            PrintVersion(std::cout);
+        }
+        else if (var_map.count("help") != 0U)
+        {
+            PrintHelp(std::cerr, cli_options);
+        }
+        else
+        {
+            std::cout << e.what() << std::endl;
+            PrintHelp(std::cerr, cli_options);
+        }
+        return info_print;
+    }
+    // Display the application version.
+    if (var_map.contains("version"))
+    {
+        PrintVersion(std::cout);
+        return info_print;
+    }
+
+    // Display information on setting the application mode.
+    if (var_map.contains("help"))
+    {
+        PrintHelp(std::cout, cli_options);
+        return info_print;
+    }
+    return input_param;
+}
+
+#pragma endregion Helper_methods
+
+size_t Application::ReadUnloading(const std::string& filename, const NodeDigestHandler& handler)
+{
+    std::ifstream input(filename, std::ios::binary);
+    if (!input.is_open())
+    {
+        throw std::runtime_error("Can't open the file: " + filename);
+    }
+    if (NodesetSnapshot::IsSnapshot(input))
+    {
+        m_logger_main.Debug("The file '{}' is the digest snapshot", filename);
+        return NodesetSnapshot::Read(input, m_field_names, handler);
+    }
+    NodesetDigestReader reader(m_field_names);
+    return reader.Read(input, handler);
+}
+
+void Application::PrintDifference(const NodesetDiff::Difference& difference)
+{
+    using Kind = NodesetDiff::Difference::Kind;
+    if (m_summary_only)
+    {
+        return;
+    }
+    switch (difference.kind)
+    {
+    case Kind::Added:
+        std::cout << "+ " << difference.node_id << '\n';
+        break;
+    case Kind::Removed:
+        std::cout << "- " << difference.node_id << '\n';
+        break;
+    case Kind::Changed:
+        std::cout << "~ " << difference.node_id << ':';
+        for (size_t index = 0; index < difference.changed_fields.size(); ++index)
+        {
+            std::cout << (index == 0 ? " " : ", ") << difference.changed_fields[index];
+        }
+        if (difference.added_references > 0 || difference.removed_references > 0)
+        {
+            std::cout << (difference.changed_fields.empty() ? " " : "; ") << "references +" << difference.added_references << " -" << difference.removed_references;
+        }
+        std::cout << '\n';
+        break;
+    }
+}
+
+int Application::Run()
+{
+    try
+    {
+        if (OptionsCliPars() == info_print)
+        {
+            return exit_no_differences;
+        }
+
+        NodesetDiff diff(m_field_names);
+
+        // The base unloading is kept in memory as the digests.
+        auto phase_start = std::chrono::steady_clock::now();
+        const auto number_of_base_nodes = ReadUnloading(
+            m_base_filename,
+            [&diff](std::string&& node_id, NodeDigest&& digest)
+            {
+                diff.AddBaseNode(std::move(node_id), std::move(digest));
+            });
+        const auto base_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - phase_start);
+
+        // The new unloading is compared node by node while it is read.
+        std::ofstream snapshot_file;
+        std::unique_ptr<NodesetSnapshot::Writer> snapshot_writer;
+        if (!m_snapshot_filename.empty())
+        {
+            snapshot_file.open(m_snapshot_filename, std::ios::binary | std::ios::trunc);
+            if (!snapshot_file.is_open())
+            {
+                m_logger_main.Error("Can't open the snapshot file: {}", m_snapshot_filename);
+                return exit_error;
+            }
+            snapshot_writer = std::make_unique<NodesetSnapshot::Writer>(snapshot_file, m_field_names);
+        }
+        phase_start = std::chrono::steady_clock::now();
+        const auto number_of_new_nodes = ReadUnloading(
+            m_new_filename,
+            [this, &diff, &snapshot_writer](std::string&& node_id, NodeDigest&& digest)
+            {
+                if (snapshot_writer != nullptr)
+                {
+                    snapshot_writer->Write(node_id, digest);
+                }
+                if (const auto difference = diff.CompareNode(std::move(node_id), digest))
+                {
+                    PrintDifference(*difference);
+                }
+            });
+        for (const auto& difference : diff.TakeRemovedNodes())
+        {
+            PrintDifference(difference);
+        }
+        std::cout.flush();
+        const auto new_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - phase_start);
+        if (snapshot_writer != nullptr && !snapshot_writer->Finish())
+        {
+            m_logger_main.Error("Error writing the snapshot file: {}", m_snapshot_filename);
+            return exit_error;
+        }
+
+        m_logger_main.Info(
+            "Base nodes: {}, new nodes: {}. Added: {}, removed: {}, changed: {}",
+            number_of_base_nodes,
+            number_of_new_nodes,
+            diff.GetNumberOfAddedNodes(),
+            diff.GetNumberOfRemovedNodes(),
+            diff.GetNumberOfChangedNodes());
+        m_logger_main.Info("Reading of the base unloading: {} ms, comparison with the new unloading: {} ms", base_duration.count(), new_duration.count());
+
+        const bool has_differences = diff.GetNumberOfAddedNodes() > 0 || diff.GetNumberOfRemovedNodes() > 0 || diff.GetNumberOfChangedNodes() > 0;
+        return has_differences ? exit_differences : exit_no_differences;
+    }
+    catch (std::exception& exc)
+    {
+        m_logger_main.Error("{}", exc.what());
+        return exit_error;
+    }
+}
+
+} // namespace apps::nodesetdiff
@@ -12,21 +12,43 @@
 #include "include/nodesetexporter/common/PerformanceTimer.h"
 #include "include/nodesetexporter/logger/LogPlugin.h"
 #include "include/nodesetexporter/open62541/BrowseOperations.h"
+#include "include/nodesetexporter/open62541/ClientWrappers.h"
+#include "include/nodesetexporter/open62541/ExportEstimator.h"
+#include "include/nodesetexporter/open62541/LocalizedTexts.h"
+#include "include/nodesetexporter/open62541/RoundTripVerifier.h"
+#include "include/nodesetexporter/open62541/SecurityProfile.h"
+#include "include/nodesetexporter/open62541/TransportProfile.h"
 
 #include <open62541/client.h>
 
+#include <boost/asio/post.hpp>
 #include <boost/bind/bind.hpp>
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <set>
+#include <sstream>
 
 namespace apps::nodesetexporter
 {
 namespace prog_opt = boost::program_options;
 namespace build = build;
 namespace browseoperations = ::nodesetexporter::open62541::browseoperations;
+namespace transport = ::nodesetexporter::open62541::transport;
+namespace security = ::nodesetexporter::open62541::security;
+namespace discovery = ::nodesetexporter::open62541::discovery;
+namespace estimation = ::nodesetexporter::open62541::estimation;
+namespace locales = ::nodesetexporter::open62541::locales;
 
 using ::nodesetexporter::ExportNodesetFromClient;
+using ::nodesetexporter::ExportNodesetFromNodesetFile;
+using ::nodesetexporter::common::AttributeProfiles;
 using ::nodesetexporter::common::PerformanceTimer;
+using ::nodesetexporter::interfaces::IOpen62541;
+using ::nodesetexporter::open62541::Open62541ClientWrapper;
+using ::nodesetexporter::open62541::RoundTripVerifier;
+using ::nodesetexporter::open62541::SessionRecoveryPolicy;
 
 #pragma region Helper_methods
 
@@ -51,6 +73,10 @@ int Application::OptionsCliPars()
     cli_options.add_options()("help,h", "Show hints");
     cli_options.add_options()("version,v", "Show version");
     cli_options.add_options()("endpoint,e", boost::program_options::value<>(&m_client_endpointUrl)->default_value("opc.tcp://localhost:4840"), "Endpoint to OPC UA Server");
+    cli_options.add_options()(
+        "source,s",
+        boost::program_options::value<>(&m_nodeset_source),
+        "Path to the NodeSet2 XML file that is used as the data source instead of the OPC UA Server. The namespace indices of the node IDs are the indices of the file");
     cli_options.add_options()(
         "nodeids,n",
         boost::program_options::value<>(&m_start_node_ids)->required()->multitoken(),
@@ -58,13 +84,170 @@ int Application::OptionsCliPars()
     cli_options.add_options()("file,f", boost::program_options::value<>(&m_export_filename)->default_value("nodeset_export.xml")->required(), "Path with filename to export");
     cli_options.add_options()("username,u", boost::program_options::value<>(&m_user_name), "Authentication username");
     cli_options.add_options()("password,p", boost::program_options::value<>(&m_password), "Authentication password");
+    cli_options.add_options()("secmode", boost::program_options::value<>(&m_security_mode)->default_value("None"), "Security mode of the channel: None, Sign, SignAndEncrypt");
+    cli_options.add_options()(
+        "secpolicy",
+        boost::program_options::value<>(&m_security_policy)->default_value("Basic256Sha256"),
+        "Security policy of the secured channel: Basic128Rsa15, Basic256, Basic256Sha256, Aes128_Sha256_RsaOaep, Aes256_Sha256_RsaPss");
+    cli_options.add_options()("cert", boost::program_options::value<>(&m_security_profile.certificate_file), "Path to the certificate of the client (DER) for the secured channel");
+    cli_options.add_options()("key", boost::program_options::value<>(&m_security_profile.private_key_file), "Path to the private key of the client for the secured channel");
+    cli_options.add_options()(
+        "trustlist",
+        boost::program_options::value<>(&m_security_profile.trust_list_files)->multitoken(),
+        "Paths to the trusted certificates of the servers (DER). default: the certificate of any server is accepted");
+    cli_options.add_options()(
+        "appuri",
+        boost::program_options::value<>(&m_security_profile.application_uri),
+        "Application URI of the client, must be equal to the URI of the certificate. default: the URI of Open62541");
     cli_options.add_options()("maxnrd,m", boost::program_options::value<>(&m_number_of_max_nodes_to_request_data)->default_value(0), "Number of max nodes to request data");
+    cli_options.add_options()(
+        "maxare",
+        boost::program_options::value<>(&m_number_of_max_array_elements_to_request_data)->default_value(0),
+        "Number of max array elements of the node value to request data, the larger arrays are read in parts. default: the value is read entirely");
     cli_options.add_options()("timeout,t", boost::program_options::value<>(&m_client_timeout)->default_value(client_timeout_default_ms), "Response timeout in ms");
+    cli_options.add_options()(
+        "recvbuf",
+        boost::program_options::value<>(&m_transport_profile.recv_buffer_size)->default_value(0),
+        "Size of the receive buffer of the connection (max size of the chunk) in bytes. default: the value of Open62541");
+    cli_options.add_options()(
+        "sendbuf",
+        boost::program_options::value<>(&m_transport_profile.send_buffer_size)->default_value(0),
+        "Size of the send buffer of the connection (max size of the chunk) in bytes. default: the value of Open62541");
+    cli_options.add_options()(
+        "maxmsgsize",
+        boost::program_options::value<>(&m_transport_profile.max_message_size)->default_value(0),
+        "Max size of the received message in bytes. default: no limit");
+    cli_options.add_options()(
+        "maxchunks",
+        boost::program_options::value<>(&m_transport_profile.max_chunk_count)->default_value(0),
+        "Max number of the chunks of the received message. default: no limit");
+    cli_options.add_options()(
+        "sorcvbuf",
+        boost::program_options::value<>(&m_transport_profile.socket_recv_buffer_size)->default_value(0),
+        "Size of the socket receive buffer (SO_RCVBUF) in bytes. default: the value of the system");
+    cli_options.add_options()(
+        "sosndbuf",
+        boost::program_options::value<>(&m_transport_profile.socket_send_buffer_size)->default_value(0),
+        "Size of the socket send buffer (SO_SNDBUF) in bytes. default: the value of the system");
+    cli_options.add_options()("nodelay", boost::program_options::value<>(&m_transport_profile.tcp_no_delay)->default_value(true), "Disable the Nagle algorithm, TCP_NODELAY (true/false)");
+    cli_options.add_options()(
+        "reconnect",
+        boost::program_options::value<>(&m_reconnect_attempts)->default_value(0),
+        "Number of max reconnections for one request, if the connection or the session is lost during the export. default: no reconnection");
+    cli_options.add_options()(
+        "retrybudget",
+        boost::program_options::value<>(&m_reconnect_budget)->default_value(0),
+        "Number of max reconnections during the whole export. default: 10");
+    cli_options.add_options()(
+        "backoff",
+        boost::program_options::value<>(&m_reconnect_backoff)->default_value(0),
+        "Pause before the first reconnection in ms, doubled on each next attempt up to 30 s. default: 1000");
+    cli_options.add_options()(
+        "maxrps",
+        boost::program_options::value<>(&m_max_requests_per_second)->default_value(0),
+        "Max number of the requests to the server per second. default: no limit");
+    cli_options.add_options()(
+        "maxops",
+        boost::program_options::value<>(&m_max_operations_per_second)->default_value(0),
+        "Max number of the operations (attributes, nodes, continuation points) per second. default: no limit");
+    cli_options.add_options()(
+        "maxbps",
+        boost::program_options::value<>(&m_max_bytes_per_second)->default_value(0),
+        "Max number of the bytes of the responses per second. default: no limit");
+    cli_options.add_options()(
+        "adaptive",
+        boost::program_options::value<>(&m_adaptive_rate)->default_value(false),
+        "Reduce the rate of the requests when the server is saturated (true/false)");
+    cli_options.add_options()(
+        "quirks",
+        boost::program_options::value<>(&m_quirk_fixers)->multitoken()->default_value({"auto"}, "auto"),
+        "Fixers of the deviations of the server: kepserver, auto (detected by BuildInfo of the server), none");
     cli_options.add_options()("perftimer", boost::program_options::value<>(&m_perf_timer)->default_value(false), "Enable the performance timer (true/false)");
+    cli_options.add_options()(
+        "async",
+        boost::program_options::value<>(&m_async_client)->default_value(false),
+        "Export with asynchronous requests driven by the application event loop (true/false)");
+    cli_options.add_options()(
+        "inflight",
+        boost::program_options::value<>(&m_max_requests_in_flight)->default_value(0),
+        "Number of max requests in flight in the asynchronous mode. default: 4");
     cli_options.add_options()(
         "parent",
         boost::program_options::value<>(&m_parent_start_node_replacer),
         "The parent node ID of all of the start nodes, which is replaced by the custom one for the binding. default: \"i=85\"");
+    cli_options.add_options()(
+        "attrprofile",
+        boost::program_options::value<>(&m_attribute_profile)->default_value("full"),
+        "Profile of the node attributes to read: full, nodeset-minimal, custom (the list is set by \"--attributes\")");
+    cli_options.add_options()(
+        "attributes",
+        boost::program_options::value<>(&m_custom_attributes)->multitoken(),
+        "The attributes to read in the custom profile. For example: \"DisplayName\" \"Value\"");
+    cli_options.add_options()(
+        "locales",
+        boost::program_options::value<>(&m_locales)->multitoken(),
+        "The locales of DisplayName and Description, all of them are exported in the order of the list. For example: \"en\" \"de-DE\". default: the locale of the server");
+    cli_options.add_options()(
+        "typesfile",
+        boost::program_options::value<>(&m_types_filename),
+        "Path with filename to export the types separately from the instances, the instances file requires the types model");
+    cli_options.add_options()(
+        "typesmodeluri",
+        boost::program_options::value<>(&m_types_model_uri),
+        "Works with \"--typesfile\". The model URI of the types file. default: the namespace URI of the first type node");
+    cli_options.add_options()(
+        "instancesmodeluri",
+        boost::program_options::value<>(&m_instances_model_uri),
+        "Works with \"--typesfile\". The model URI of the instances file. default: the namespace URI of the first instance node, "
+        "or the types model URI with the \"Instances\" path if it is the same");
+    cli_options.add_options()(
+        "typeclosure",
+        boost::program_options::value<>(&m_type_closure)->default_value(false),
+        "Export also the missing types from the non-zero namespaces that the exported nodes depend on (true/false)");
+    cli_options.add_options()(
+        "rule",
+        boost::program_options::value<>(&m_discovery_rules),
+        "Include/exclude rule of the browsing, the first matched rule decides, the excluded subtrees are not browsed. Can be repeated. For example: \"exclude name=Diagnostics*\"");
+    cli_options.add_options()(
+        "maxdepth",
+        boost::program_options::value<>(&m_max_browse_depth)->default_value(0),
+        "Max depth of the browsing from the start node, the children of the start node have the depth 1. default: no limit");
+    cli_options.add_options()(
+        "view",
+        boost::program_options::value<>(&m_view_id),
+        "The View node ID, the node lists and the references are browsed only within the View. default: the whole address space");
+    cli_options.add_options()(
+        "viewtime",
+        boost::program_options::value<>(&m_view_timestamp),
+        "The state of the View at the UTC time in the format YYYY-MM-DDTHH:MM:SS. default: the current state");
+    cli_options.add_options()(
+        "viewversion",
+        boost::program_options::value<>(&m_view_version)->default_value(0),
+        "The version of the View. default: the current version");
+    cli_options.add_options()(
+        "estimate",
+        boost::program_options::value<>(&m_estimate_fraction)->default_value(0),
+        "Only estimate the export by the discovery: 1 - all nodes are browsed, (0, 1) - the part of the children of each level is browsed and the counts are extrapolated. default: the export is performed");
+    cli_options.add_options()(
+        "dedup",
+        boost::program_options::value<>(&m_cross_list_deduplication)->default_value(false),
+        "Allow the overlapping subtrees of the start nodes, the shared nodes are exported once by the first list (true/false)");
+    cli_options.add_options()(
+        "canonical",
+        boost::program_options::value<>(&m_canonical)->default_value(false),
+        "Deterministic output: the nodes and the references are sorted (true/false)");
+    cli_options.add_options()(
+        "skipunchanged",
+        boost::program_options::value<>(&m_skip_unchanged)->default_value(false),
+        "Don't rewrite the file if the content hash of the canonical output has not changed (true/false)");
+    cli_options.add_options()(
+        "selfcheck",
+        boost::program_options::value<>(&m_self_check)->default_value(false),
+        "Check the structure of the unloading while it is formed and report the violations (true/false)");
+    cli_options.add_options()(
+        "roundtrip",
+        boost::program_options::value<>(&m_round_trip)->default_value(false),
+        "Load the produced file back and compare it with the data source node by node, report the mismatches and the timing (true/false)");
 
     prog_opt::variables_map var_map;
     try
@@ -135,11 +318,27 @@ void Application::SignalSet()
             {
             case SIGINT:
             case SIGTERM:
+                // Browsing is not stopped cooperatively, so before the export starts, as well as on a repeated signal, the session is interrupted.
+                if (!m_stop_source.stop_requested() && m_export_started)
+                {
+                    m_logger_main.Warning("Stop signal received. The export will be stopped after the current batch of nodes. Repeat the signal to interrupt immediately.");
+                    m_stop_source.request_stop();
+                    SignalSet(); // Waiting for a repeated signal
+                    break;
+                }
                 m_logger_main.Warning("Stop signal received.");
+                m_stop_source.request_stop();
                 if (m_client != nullptr)
                 {
                     UA_Client_disconnect(m_client);
                 }
+                if (m_client_in_event_loop)
+                {
+                    // The requests in flight have been completed with an error by the disconnection, the export thread will finish the work and stop the loop by itself.
+                    m_client_in_event_loop = false;
+                    m_client_iterate_timer.cancel();
+                    break;
+                }
                 m_io_context.stop();
                 break;
 
@@ -150,6 +349,33 @@ void Application::SignalSet()
         });
 }
 
+void Application::ClientIterate()
+{
+    if (!m_client_in_event_loop)
+    {
+        return;
+    }
+    auto status = UA_Client_run_iterate(m_client, 0); // Does not block, only what is ready is processed
+    if (UA_StatusCode_isBad(status))
+    {
+        // The client is no longer iterated, so the requests in flight are completed with an error by the disconnection, otherwise the export thread
+        // waits for them forever. The following requests of the export thread fail at once, since the client is not connected.
+        m_logger_main.Error("OPC UA Client error: {}", UA_StatusCode_name(status));
+        UA_Client_disconnect(m_client);
+        m_client_in_event_loop = false;
+        return;
+    }
+    m_client_iterate_timer.expires_after(client_iterate_interval);
+    m_client_iterate_timer.async_wait(
+        [this](boost::system::error_code const& error_code)
+        {
+            if (!error_code)
+            {
+                ClientIterate();
+            }
+        });
+}
+
 #pragma endregion Helper_methods
 
 void Application::StartExportInAnotherThread()
@@ -161,16 +387,66 @@ void Application::StartExportInAnotherThread()
         {
             try
             {
+                if (m_estimate_fraction > 0 && !m_nodeset_file)
+                {
+                    if (EstimateExport() != StatusResults::Good)
+                    {
+                        throw std::runtime_error("Estimation error");
+                    }
+                    m_io_context.stop();
+                    return_res.set_value(success);
+                    return;
+                }
+
                 // The first main operation is collecting units for export. Can take a long time.
                 m_logger_main.Info("Browse node lists for export");
                 std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>> node_ids_export;
+                auto* const discovery_filter = m_discovery_filter.IsEnabled() ? &m_discovery_filter : nullptr;
+                const auto* const view = m_opt.view.view_id ? &m_view.GetRef() : nullptr;
+                // The browsing of the nodes is recovered after the loss of the connection as the requests of the export, with its own budget of the reconnections.
+                std::unique_ptr<Open62541ClientWrapper> browse_client_wrapper;
+                browseoperations::SessionRecovery session_recovery;
+                if (m_opt.session_recovery.reconnect && !m_nodeset_file)
+                {
+                    SessionRecoveryPolicy session_recovery_policy;
+                    session_recovery_policy.reconnect = m_opt.session_recovery.reconnect;
+                    session_recovery_policy.max_attempts_per_request = m_reconnect_attempts;
+                    if (m_reconnect_budget != 0)
+                    {
+                        session_recovery_policy.retry_budget = m_reconnect_budget;
+                    }
+                    if (m_reconnect_backoff != 0)
+                    {
+                        session_recovery_policy.initial_backoff = std::chrono::milliseconds(m_reconnect_backoff);
+                    }
+                    browse_client_wrapper = std::make_unique<Open62541ClientWrapper>(*m_client, m_opc_nodesetexporter_logger, m_stop_source.get_token());
+                    browse_client_wrapper->SetSessionRecoveryPolicy(std::move(session_recovery_policy));
+                    session_recovery = [&browse_client_wrapper](const std::function<UA_StatusCode()>& request)
+                    {
+                        return browse_client_wrapper->CallWithSessionRecovery("Browse", request);
+                    };
+                }
 
                 for (const auto& start_node_id_s : m_start_node_ids)
                 {
                     std::vector<UATypesContainer<UA_ExpandedNodeId>> export_node_id_list;
                     UATypesContainer<UA_ExpandedNodeId> start_node_id(UA_EXPANDEDNODEID(start_node_id_s.data()), UA_TYPES_EXPANDEDNODEID);
                     auto perf_timer = PerformanceTimer();
-                    auto client_result = browseoperations::GrabChildNodeIdsFromStartNodeId(m_client, start_node_id, export_node_id_list);
+                    if (m_nodeset_file)
+                    {
+                        if (m_nodeset_file->GrabChildNodeIdsFromStartNodeId(start_node_id, export_node_id_list, discovery_filter) != StatusResults::Good)
+                        {
+                            throw std::runtime_error("Browsing error of the NodeSet file");
+                        }
+                        m_logger_main.Info("Browsing operation from starting NodeID '{}': {}", start_node_id_s, PerformanceTimer::TimeToString(perf_timer.GetTimeElapsed()));
+                        if (m_stop_source.stop_requested())
+                        {
+                            throw InterruptException("Interrupt detected.");
+                        }
+                        node_ids_export.emplace(start_node_id_s, std::move(export_node_id_list));
+                        continue;
+                    }
+                    auto client_result = browseoperations::GrabChildNodeIdsFromStartNodeId(m_client, start_node_id, export_node_id_list, discovery_filter, view, session_recovery);
                     m_logger_main.Info("Browsing operation from starting NodeID '{}': {}", start_node_id_s, PerformanceTimer::TimeToString(perf_timer.GetTimeElapsed()));
                     if (client_result == StatusResults::Fail)
                     {
@@ -180,16 +456,17 @@ void Application::StartExportInAnotherThread()
                     // If work is interrupted while browsing, I do not start the export and exit
                     UA_SessionState session_state = UA_SessionState::UA_SESSIONSTATE_CLOSED;
                     UA_Client_getState(m_client, nullptr, &session_state, nullptr);
-                    if (session_state == UA_SessionState::UA_SESSIONSTATE_CLOSED || session_state == UA_SessionState::UA_SESSIONSTATE_CLOSING)
+                    if (m_stop_source.stop_requested() || session_state == UA_SessionState::UA_SESSIONSTATE_CLOSED || session_state == UA_SessionState::UA_SESSIONSTATE_CLOSING)
                     {
                         throw InterruptException("Interrupt detected.");
                     }
                     node_ids_export.emplace(start_node_id_s, std::move(export_node_id_list));
                 }
+                m_discovery_filter.ReportHits(m_logger_main);
 
-                // Search for starting nodes in the list of nodes for export.
+                // Search for starting nodes in the list of nodes for export. With the deduplication the overlapping lists are allowed.
                 auto perf_timer = PerformanceTimer();
-                if (CheckStartNodeCrossing(node_ids_export) != StatusResults::Good)
+                if (!m_cross_list_deduplication && CheckStartNodeCrossing(node_ids_export) != StatusResults::Good)
                 {
                     throw std::runtime_error("Export error");
                 }
@@ -197,11 +474,40 @@ void Application::StartExportInAnotherThread()
 
                 // The second main operation is export. Nodesetexporter library function. Can take a long time.
                 m_logger_main.Info("Launch export");
-                auto nodeexporter_status = ExportNodesetFromClient(*m_client, node_ids_export, std::move(m_export_filename), std::nullopt, m_opt);
+                m_opt.stop_token = m_stop_source.get_token();
+                if (m_async_client && !m_nodeset_file)
+                {
+                    // From this moment the client belongs to the event loop, the export thread only passes the requests to it and waits for the responses.
+                    m_opt.async_client.dispatcher = [this](std::function<void()>&& task)
+                    {
+                        boost::asio::post(m_io_context, std::move(task));
+                    };
+                    m_opt.async_client.max_requests_in_flight = m_max_requests_in_flight;
+                    boost::asio::post(
+                        m_io_context,
+                        [this]
+                        {
+                            m_client_in_event_loop = true;
+                            ClientIterate();
+                        });
+                }
+                m_export_started = true;
+                const auto export_filename = m_export_filename;
+                auto nodeexporter_status = m_nodeset_file ? ExportNodesetFromNodesetFile(*m_nodeset_file, node_ids_export, std::move(m_export_filename), std::nullopt, m_opt)
+                                                          : ExportNodesetFromClient(*m_client, node_ids_export, std::move(m_export_filename), std::nullopt, m_opt);
+                if (nodeexporter_status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    throw InterruptException("Interrupt detected. The export was saved as partial.");
+                }
                 if (nodeexporter_status != StatusResults::Good)
                 {
                     throw std::runtime_error("Export error");
                 }
+
+                if (m_round_trip && VerifyRoundTrip(node_ids_export, export_filename) != StatusResults::Good)
+                {
+                    throw std::runtime_error("Round-trip verification error");
+                }
             }
             catch (InterruptException& e)
             {
@@ -222,6 +528,109 @@ void Application::StartExportInAnotherThread()
         std::move(promise));
 }
 
+StatusResults Application::VerifyRoundTrip(const std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids, const std::string& filename)
+{
+    // In the asynchronous mode the client belongs to the event loop, which is already stopped by the end of the export.
+    if (m_async_client && !m_nodeset_file)
+    {
+        m_logger_main.Warning("The round-trip verification is not supported with the asynchronous client, it is skipped.");
+        return StatusResults::Good;
+    }
+    if (m_opt.split_output.is_enable)
+    {
+        m_logger_main.Warning("The round-trip verification is not supported with the split output, it is skipped.");
+        return StatusResults::Good;
+    }
+    m_logger_main.Info("Launch round-trip verification");
+    // The lists may overlap with the deduplication, each node is verified once.
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> exported_node_ids;
+    std::set<UATypesContainer<UA_ExpandedNodeId>> unique_node_ids;
+    for (const auto& [start_node_id, node_id_list] : node_ids)
+    {
+        for (const auto& node_id : node_id_list)
+        {
+            if (unique_node_ids.insert(node_id).second)
+            {
+                exported_node_ids.push_back(node_id);
+            }
+        }
+    }
+    std::unique_ptr<Open62541ClientWrapper> client_wrapper;
+    IOpen62541* original = m_nodeset_file.get();
+    if (original == nullptr)
+    {
+        client_wrapper = std::make_unique<Open62541ClientWrapper>(*m_client, m_opc_nodesetexporter_logger);
+        original = client_wrapper.get();
+    }
+    RoundTripVerifier verifier(*original, m_logger_main, m_number_of_max_nodes_to_request_data);
+    verifier.SetLocales(m_locales);
+    return verifier.VerifyFile(filename, exported_node_ids);
+}
+
+UA_StatusCode Application::ConnectClient(UA_Client& client)
+{
+    if (m_user_name.empty())
+    {
+        return UA_Client_connect(&client, m_client_endpointUrl.data());
+    }
+    return UA_Client_connectUsername(&client, m_client_endpointUrl.data(), m_user_name.data(), m_password.data());
+}
+
+void Application::DeriveRequestLimits()
+{
+    auto& limits = m_request_limits;
+    if (transport::ReadRequestLimits(*m_client, limits) != StatusResults::Good)
+    {
+        m_logger_main.Warning("Can't read the limits of the requests, the number of max nodes to request data is not derived.");
+        return;
+    }
+    m_logger_main.Info(
+        "Transport limits: max message size: {}, max nodes per read of the server: {} (0 - no limit)",
+        limits.max_message_size,
+        limits.max_nodes_per_read);
+    if (m_number_of_max_nodes_to_request_data != 0) // Set explicitly by "--maxnrd"
+    {
+        return;
+    }
+    m_number_of_max_nodes_to_request_data = transport::DeriveNumberOfMaxNodesToRequestData(limits);
+    m_opt.number_of_max_nodes_to_request_data = m_number_of_max_nodes_to_request_data;
+    if (m_number_of_max_nodes_to_request_data != 0)
+    {
+        m_logger_main.Info("The number of max nodes to request data is derived from the transport limits: {}", m_number_of_max_nodes_to_request_data);
+    }
+}
+
+StatusResults Application::EstimateExport()
+{
+    m_logger_main.Info("Estimation of the export, fraction of the browsed nodes: {}", m_estimate_fraction);
+    auto* const discovery_filter = m_discovery_filter.IsEnabled() ? &m_discovery_filter : nullptr;
+    const auto* const view = m_opt.view.view_id ? &m_view.GetRef() : nullptr;
+    estimation::SubtreeCensus census;
+    for (const auto& start_node_id_s : m_start_node_ids)
+    {
+        const UATypesContainer<UA_ExpandedNodeId> start_node_id(UA_EXPANDEDNODEID(start_node_id_s.data()), UA_TYPES_EXPANDEDNODEID);
+        auto perf_timer = PerformanceTimer();
+        if (estimation::SampleSubtree(m_client, start_node_id, std::min(m_estimate_fraction, 1.0), estimate_seed, census, m_logger_main, discovery_filter, view) != StatusResults::Good)
+        {
+            return StatusResults::Fail;
+        }
+        m_logger_main.Info("Estimation browsing from starting NodeID '{}': {}", start_node_id_s, PerformanceTimer::TimeToString(perf_timer.GetTimeElapsed()));
+        if (m_stop_source.stop_requested())
+        {
+            throw InterruptException("Interrupt detected.");
+        }
+    }
+    m_discovery_filter.ReportHits(m_logger_main);
+
+    // The configured (or derived from the limits) number of the nodes per request is forecast, 0 - the number is picked by the estimation.
+    const auto estimate = estimation::Forecast(census, m_request_limits, m_number_of_max_nodes_to_request_data);
+    estimation::ReportEstimate(census, estimate, m_logger_main);
+    m_logger_main.Info(
+        "Recommended number of max nodes to request data (\"--maxnrd\"): {}",
+        estimation::PickBatchSize(estimate.number_of_exported_nodes, m_request_limits));
+    return StatusResults::Good;
+}
+
 StatusResults Application::CheckStartNodeCrossing(std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids)
 {
     for (const auto& start_nodeids : node_ids)
@@ -248,6 +657,168 @@ StatusResults Application::CheckStartNodeCrossing(std::map<std::string, std::vec
     return StatusResults::Good;
 }
 
+StatusResults Application::PrepareSecurityProfile()
+{
+    const auto security_mode = security::SecurityModeFromName(m_security_mode);
+    if (!security_mode.has_value())
+    {
+        m_logger_main.Error("Unknown security mode '{}' in the parameter \"--secmode\".", m_security_mode);
+        return StatusResults::Fail;
+    }
+    m_security_profile.security_mode = *security_mode;
+    if (m_security_profile.security_mode == UA_MESSAGESECURITYMODE_NONE)
+    {
+        return StatusResults::Good;
+    }
+    const auto security_policy_uri = security::SecurityPolicyUriFromName(m_security_policy);
+    if (!security_policy_uri.has_value() || m_security_policy == "None")
+    {
+        m_logger_main.Error("Unknown security policy '{}' in the parameter \"--secpolicy\".", m_security_policy);
+        return StatusResults::Fail;
+    }
+    m_security_profile.security_policy_uri = *security_policy_uri;
+    return StatusResults::Good;
+}
+
+void Application::LogCryptoOverhead()
+{
+    const auto* cli_config = UA_Client_getConfig(m_client);
+    security::CryptoOverhead overhead;
+    if (security::MeasureCryptoOverhead(*cli_config, cli_config->localConnectionConfig.recvBufferSize, overhead) != StatusResults::Good)
+    {
+        m_logger_main.Warning("Can't measure the crypto overhead of the secured channel.");
+        return;
+    }
+    const auto crypto_time = overhead.sign + overhead.encrypt;
+    const auto throughput = crypto_time.count() > 0 ? static_cast<double>(overhead.chunk_size) * 1000.0 / static_cast<double>(crypto_time.count()) : 0.0; // MB/s
+    m_logger_main.Info(
+        "Crypto overhead per chunk of {} bytes ({}, {}): sign {} us, encrypt {} us, throughput {:.1f} MB/s",
+        overhead.chunk_size,
+        m_security_policy,
+        m_security_mode,
+        std::chrono::duration_cast<std::chrono::microseconds>(overhead.sign).count(),
+        std::chrono::duration_cast<std::chrono::microseconds>(overhead.encrypt).count(),
+        throughput);
+}
+
+StatusResults Application::PrepareAttributeProjection()
+{
+    static const std::map<std::string, UA_AttributeId> attribute_names = {
+        {"NodeId", UA_ATTRIBUTEID_NODEID},
+        {"NodeClass", UA_ATTRIBUTEID_NODECLASS},
+        {"BrowseName", UA_ATTRIBUTEID_BROWSENAME},
+        {"DisplayName", UA_ATTRIBUTEID_DISPLAYNAME},
+        {"Description", UA_ATTRIBUTEID_DESCRIPTION},
+        {"WriteMask", UA_ATTRIBUTEID_WRITEMASK},
+        {"UserWriteMask", UA_ATTRIBUTEID_USERWRITEMASK},
+        {"IsAbstract", UA_ATTRIBUTEID_ISABSTRACT},
+        {"Symmetric", UA_ATTRIBUTEID_SYMMETRIC},
+        {"InverseName", UA_ATTRIBUTEID_INVERSENAME},
+        {"ContainsNoLoops", UA_ATTRIBUTEID_CONTAINSNOLOOPS},
+        {"EventNotifier", UA_ATTRIBUTEID_EVENTNOTIFIER},
+        {"Value", UA_ATTRIBUTEID_VALUE},
+        {"DataType", UA_ATTRIBUTEID_DATATYPE},
+        {"ValueRank", UA_ATTRIBUTEID_VALUERANK},
+        {"ArrayDimensions", UA_ATTRIBUTEID_ARRAYDIMENSIONS},
+        {"AccessLevel", UA_ATTRIBUTEID_ACCESSLEVEL},
+        {"UserAccessLevel", UA_ATTRIBUTEID_USERACCESSLEVEL},
+        {"MinimumSamplingInterval", UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL},
+        {"Historizing", UA_ATTRIBUTEID_HISTORIZING},
+        {"Executable", UA_ATTRIBUTEID_EXECUTABLE},
+        {"UserExecutable", UA_ATTRIBUTEID_USEREXECUTABLE},
+        {"DataTypeDefinition", UA_ATTRIBUTEID_DATATYPEDEFINITION}};
+
+    if (m_attribute_profile == "full")
+    {
+        m_opt.attribute_projection.profile = AttributeProfiles::Full;
+    }
+    else if (m_attribute_profile == "nodeset-minimal")
+    {
+        m_opt.attribute_projection.profile = AttributeProfiles::NodesetMinimal;
+    }
+    else if (m_attribute_profile == "custom")
+    {
+        m_opt.attribute_projection.profile = AttributeProfiles::Custom;
+    }
+    else
+    {
+        m_logger_main.Error("Invalid parameter \"--attrprofile\".  Check it and try again.");
+        return StatusResults::Fail;
+    }
+
+    if (!m_custom_attributes.empty() && m_opt.attribute_projection.profile != AttributeProfiles::Custom)
+    {
+        m_logger_main.Warning("The parameter \"--attributes\" is used only with the custom profile, ignored.");
+        return StatusResults::Good;
+    }
+    for (const auto& attribute_name : m_custom_attributes)
+    {
+        const auto attribute = attribute_names.find(attribute_name);
+        if (attribute == attribute_names.end())
+        {
+            m_logger_main.Error("Unknown attribute '{}' in the parameter \"--attributes\".  Check it and try again.", attribute_name);
+            return StatusResults::Fail;
+        }
+        m_opt.attribute_projection.custom_attributes.insert(attribute->second);
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Application::PrepareView()
+{
+    if (m_view_id.empty())
+    {
+        if (!m_view_timestamp.empty() || m_view_version != 0)
+        {
+            m_logger_main.Warning("The parameters \"--viewtime\" and \"--viewversion\" are used only with \"--view\", ignored.");
+        }
+        return StatusResults::Good;
+    }
+    m_opt.view.view_id = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID(m_view_id.c_str()), UA_TYPES_EXPANDEDNODEID);
+    if (UA_NodeId_isNull(&m_opt.view.view_id->GetRef().nodeId))
+    {
+        m_logger_main.Error("Invalid parameter \"--view\".  Check it and try again.");
+        return StatusResults::Fail;
+    }
+    if (!m_view_timestamp.empty())
+    {
+        std::tm time = {};
+        std::istringstream time_stream(m_view_timestamp);
+        time_stream >> std::get_time(&time, "%Y-%m-%dT%H:%M:%S");
+        if (time_stream.fail())
+        {
+            m_logger_main.Error("Invalid parameter \"--viewtime\".  Check it and try again.");
+            return StatusResults::Fail;
+        }
+        m_opt.view.timestamp = UA_DateTime_fromUnixTime(timegm(&time));
+    }
+    m_opt.view.view_version = m_view_version;
+    m_view = browseoperations::MakeViewDescription(m_opt.view.view_id->GetRef().nodeId, m_opt.view.timestamp, m_opt.view.view_version);
+    return StatusResults::Good;
+}
+
+StatusResults Application::PrepareDiscoveryFilter()
+{
+    std::vector<discovery::DiscoveryRule> rules;
+    // The depth limit is checked first, so that the include rules don't cancel it.
+    if (m_max_browse_depth != 0)
+    {
+        rules.push_back(discovery::MakeMaxDepthRule(m_max_browse_depth));
+    }
+    for (const auto& rule_text : m_discovery_rules)
+    {
+        discovery::DiscoveryRule rule;
+        if (discovery::ParseDiscoveryRule(rule_text, rule, m_logger_main) != StatusResults::Good)
+        {
+            m_logger_main.Error("Invalid parameter \"--rule\".  Check it and try again.");
+            return StatusResults::Fail;
+        }
+        rules.push_back(std::move(rule));
+    }
+    m_discovery_filter = discovery::DiscoveryFilter(std::move(rules));
+    return StatusResults::Good;
+}
+
 int Application::Run()
 {
     try
@@ -263,8 +834,38 @@ int Application::Run()
         // Preparing auxiliary export options
         m_opt.logger = m_opc_nodesetexporter_logger;
         m_opt.number_of_max_nodes_to_request_data = m_number_of_max_nodes_to_request_data;
+        m_opt.number_of_max_array_elements_to_request_data = m_number_of_max_array_elements_to_request_data;
         m_opt.internal_log_level = LogLevel::Off; // Internal logger is not used
         m_opt.is_perf_timer_enable = m_perf_timer;
+        m_opt.type_closure = m_type_closure;
+        m_opt.cross_list_deduplication = m_cross_list_deduplication;
+        m_opt.locales = m_locales;
+        m_opt.canonical_output.is_enable = m_canonical;
+        m_opt.canonical_output.skip_unchanged_write = m_skip_unchanged;
+        m_opt.self_validation.is_enable = m_self_check;
+        m_opt.rate_limit.requests_per_second = m_max_requests_per_second;
+        m_opt.rate_limit.operations_per_second = m_max_operations_per_second;
+        m_opt.rate_limit.bytes_per_second = m_max_bytes_per_second;
+        m_opt.rate_limit.is_adaptive = m_adaptive_rate;
+        for (const auto& quirk_fixer : m_quirk_fixers)
+        {
+            // The NodeSet file has no BuildInfo of the server, the fixers are enabled only by the name.
+            if (quirk_fixer == "auto")
+            {
+                m_opt.quirk_fixers.auto_detect = m_nodeset_source.empty();
+            }
+            else if (quirk_fixer != "none")
+            {
+                m_opt.quirk_fixers.names.push_back(quirk_fixer);
+            }
+        }
+        if (!m_types_filename.empty())
+        {
+            m_opt.split_output.is_enable = true;
+            m_opt.split_output.types_filename = m_types_filename;
+            m_opt.split_output.types_model_uri = m_types_model_uri;
+            m_opt.split_output.instances_model_uri = m_instances_model_uri;
+        }
         if (!m_parent_start_node_replacer.empty())
         {
             m_opt.parent_start_node_replacer = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID(m_parent_start_node_replacer.c_str()), UA_TYPES_EXPANDEDNODEID);
@@ -274,39 +875,100 @@ int Application::Run()
                 return EXIT_FAILURE;
             }
         }
+        if (PrepareAttributeProjection() != StatusResults::Good)
+        {
+            return EXIT_FAILURE;
+        }
+        if (PrepareDiscoveryFilter() != StatusResults::Good)
+        {
+            return EXIT_FAILURE;
+        }
+        if (PrepareView() != StatusResults::Good)
+        {
+            return EXIT_FAILURE;
+        }
+        if (m_estimate_fraction < 0 || m_estimate_fraction > 1)
+        {
+            m_logger_main.Error("Invalid parameter \"--estimate\", the fraction of the browsed nodes must be in the range [0, 1].  Check it and try again.");
+            return EXIT_FAILURE;
+        }
+        if (m_estimate_fraction > 0 && !m_nodeset_source.empty())
+        {
+            m_logger_main.Warning("The estimation of the export is supported only for the server, the parameter \"--estimate\" is ignored.");
+        }
+        if (!m_locales.empty() && !m_nodeset_source.empty())
+        {
+            m_logger_main.Warning("The locales are selected only by the server, the parameter \"--locales\" is ignored for the NodeSet file.");
+        }
 
         m_logger_main.Info("Installing a signal handler");
         SignalSet();
 
-        m_logger_main.Info("Configurating the Open62541 Client");
-        m_client = UA_Client_new();
-        if (m_client == nullptr)
+        if (!m_nodeset_source.empty())
         {
-            m_logger_main.Critical("Cannot create Open62541 client.");
-            return EXIT_FAILURE;
+            m_logger_main.Info("Loading the NodeSet file '{}'", m_nodeset_source);
+            m_nodeset_file = std::make_unique<Open62541NodesetFileWrapper>(m_opc_nodesetexporter_logger);
+            if (m_nodeset_file->LoadFromFile(m_nodeset_source) != StatusResults::Good)
+            {
+                m_logger_main.Error("Cannot load the NodeSet file. Check the parameter \"--source\" and try again.");
+                return EXIT_FAILURE;
+            }
         }
-        auto* cli_config = UA_Client_getConfig(m_client);
+        else
+        {
+            m_logger_main.Info("Configurating the Open62541 Client");
+            m_client = UA_Client_new();
+            if (m_client == nullptr)
+            {
+                m_logger_main.Critical("Cannot create Open62541 client.");
+                return EXIT_FAILURE;
+            }
+            auto* cli_config = UA_Client_getConfig(m_client);
 #ifdef OPEN62541_VER_1_4
-        cli_config->logging = &m_ua_logger;
+            cli_config->logging = &m_ua_logger;
 #elif defined(OPEN62541_VER_1_3)
-        cli_config->logger = ::nodesetexporter::logger::Open62541LogPlugin::Open62541LoggerCreator(m_opc_ua_client_logger);
+            cli_config->logger = ::nodesetexporter::logger::Open62541LogPlugin::Open62541LoggerCreator(m_opc_ua_client_logger);
 #endif
-        UA_ClientConfig_setDefault(cli_config);
-        cli_config->timeout = m_client_timeout;
+            if (PrepareSecurityProfile() != StatusResults::Good || security::ApplySecurityProfile(*cli_config, m_security_profile, m_logger_main) != StatusResults::Good)
+            {
+                m_logger_main.Error("Cannot configure the security of the client. Check the parameters \"--secmode\", \"--secpolicy\", \"--cert\", \"--key\" and try again.");
+                return EXIT_FAILURE;
+            }
+            cli_config->timeout = m_client_timeout;
+            if (transport::ApplyTransportProfile(*cli_config, m_transport_profile) != StatusResults::Good)
+            {
+                m_logger_main.Error("Invalid parameters \"--recvbuf\" or \"--sendbuf\", the minimum size is 8192 bytes.  Check it and try again.");
+                return EXIT_FAILURE;
+            }
+            if (locales::ApplySessionLocales(*cli_config, m_locales) != StatusResults::Good)
+            {
+                m_logger_main.Error("Invalid parameter \"--locales\", the locale can't be empty.  Check it and try again.");
+                return EXIT_FAILURE;
+            }
 
-        m_logger_main.Info("Connecting a Client to a Server");
-        if (m_user_name.empty())
-        {
-            client_result = UA_Client_connect(m_client, m_client_endpointUrl.data());
-        }
-        else
-        {
-            client_result = UA_Client_connectUsername(m_client, m_client_endpointUrl.data(), m_user_name.data(), m_password.data());
-        }
-        if (!UA_StatusCode_isGood(client_result))
-        {
-            m_logger_main.Error("OPC UA Client error: {}", UA_StatusCode_name(client_result));
-            return EXIT_FAILURE;
+            m_logger_main.Info("Connecting a Client to a Server");
+            client_result = ConnectClient(*m_client);
+            if (!UA_StatusCode_isGood(client_result))
+            {
+                m_logger_main.Error("OPC UA Client error: {}", UA_StatusCode_name(client_result));
+                return EXIT_FAILURE;
+            }
+            DeriveRequestLimits();
+            if (m_reconnect_attempts != 0)
+            {
+                m_opt.session_recovery.reconnect = [this](UA_Client& client)
+                {
+                    m_logger_main.Info("Reconnecting a Client to a Server");
+                    return ConnectClient(client);
+                };
+                m_opt.session_recovery.max_attempts_per_request = m_reconnect_attempts;
+                m_opt.session_recovery.retry_budget = m_reconnect_budget;
+                m_opt.session_recovery.initial_backoff = std::chrono::milliseconds(m_reconnect_backoff);
+            }
+            if (m_perf_timer && m_security_profile.security_mode != UA_MESSAGESECURITYMODE_NONE)
+            {
+                LogCryptoOverhead();
+            }
         }
 
         // Sending a task for execution to the thread queue context
@@ -0,0 +1,169 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "apps/nodesetdiff/NodesetDiff.h"
+#include "apps/nodesetdiff/NodesetDigest.h"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using FieldNames = apps::nodesetdiff::FieldNames;
+using NodeDigest = apps::nodesetdiff::NodeDigest;
+using NodesetDigestReader = apps::nodesetdiff::NodesetDigestReader;
+using NodesetSnapshot = apps::nodesetdiff::NodesetSnapshot;
+using NodesetDiff = apps::nodesetdiff::NodesetDiff;
+using Kind = NodesetDiff::Difference::Kind;
+
+const std::string base_document = R"(<UANodeSet>
+    <NamespaceUris><Uri>urn:plant</Uri></NamespaceUris>
+    <UAObject NodeId="ns=1;i=1" BrowseName="1:Unchanged">
+        <DisplayName>Unchanged</DisplayName>
+        <References><Reference ReferenceType="i=47" IsForward="false">i=85</Reference></References>
+    </UAObject>
+    <UAObject NodeId="ns=1;i=2" BrowseName="1:Changed" EventNotifier="1">
+        <DisplayName>Changed</DisplayName>
+        <Description>Before</Description>
+        <References>
+            <Reference ReferenceType="i=47" IsForward="false">i=85</Reference>
+            <Reference ReferenceType="i=40">i=58</Reference>
+        </References>
+    </UAObject>
+    <UAObject NodeId="ns=1;i=3" BrowseName="1:Removed">
+        <DisplayName>Removed</DisplayName>
+    </UAObject>
+</UANodeSet>)";
+
+// ns=1;i=2: Description is changed, EventNotifier is removed, WriteMask is added, HasTypeDefinition is replaced by two references.
+// ns=1;i=3 is removed, ns=1;i=4 is added.
+const std::string new_document = R"(<UANodeSet>
+    <NamespaceUris><Uri>urn:plant</Uri></NamespaceUris>
+    <UAObject NodeId="ns=1;i=4" BrowseName="1:Added">
+        <DisplayName>Added</DisplayName>
+    </UAObject>
+    <UAObject NodeId="ns=1;i=2" BrowseName="1:Changed" WriteMask="0">
+        <DisplayName>Changed</DisplayName>
+        <Description>After</Description>
+        <References>
+            <Reference ReferenceType="i=47" IsForward="false">i=85</Reference>
+            <Reference ReferenceType="i=40">i=61</Reference>
+            <Reference ReferenceType="i=47">ns=1;i=4</Reference>
+        </References>
+    </UAObject>
+    <UAObject NodeId="ns=1;i=1" BrowseName="1:Unchanged">
+        <DisplayName>Unchanged</DisplayName>
+        <References><Reference ReferenceType="i=47" IsForward="false">i=85</Reference></References>
+    </UAObject>
+</UANodeSet>)";
+
+std::vector<NodesetDiff::Difference> Compare(NodesetDiff& diff, FieldNames& field_names, const std::string& document)
+{
+    std::vector<NodesetDiff::Difference> differences;
+    std::istringstream input(document);
+    NodesetDigestReader(field_names)
+        .Read(input,
+              [&diff, &differences](std::string&& node_id, NodeDigest&& digest)
+              {
+                  if (auto difference = diff.CompareNode(std::move(node_id), digest); difference.has_value())
+                  {
+                      differences.push_back(std::move(*difference));
+                  }
+              });
+    for (auto& removed : diff.TakeRemovedNodes())
+    {
+        differences.push_back(std::move(removed));
+    }
+    return differences;
+}
+} // namespace
+
+TEST_SUITE("apps::nodesetdiff")
+{
+    TEST_CASE("apps::nodesetdiff::NodesetDiff")
+    {
+        FieldNames field_names;
+        NodesetDiff diff(field_names);
+
+        SUBCASE("The added, the removed and the changed nodes")
+        {
+            std::istringstream base_input(base_document);
+            CHECK_EQ(NodesetDigestReader(field_names).Read(base_input, [&diff](std::string&& node_id, NodeDigest&& digest) { diff.AddBaseNode(std::move(node_id), std::move(digest)); }), 3);
+            CHECK_EQ(diff.GetNumberOfBaseNodes(), 3);
+
+            const auto differences = Compare(diff, field_names, new_document);
+            REQUIRE_EQ(differences.size(), 3);
+
+            CHECK_EQ(differences[0].kind, Kind::Added);
+            CHECK_EQ(differences[0].node_id, "nsu=urn:plant;i=4");
+
+            CHECK_EQ(differences[1].kind, Kind::Changed);
+            CHECK_EQ(differences[1].node_id, "nsu=urn:plant;i=2");
+            auto changed_fields = differences[1].changed_fields;
+            std::sort(changed_fields.begin(), changed_fields.end());
+            const std::vector<std::string> expected_changed_fields{"Description", "EventNotifier", "WriteMask"};
+            CHECK_EQ(changed_fields, expected_changed_fields);
+            CHECK_EQ(differences[1].added_references, 2);
+            CHECK_EQ(differences[1].removed_references, 1);
+
+            CHECK_EQ(differences[2].kind, Kind::Removed);
+            CHECK_EQ(differences[2].node_id, "nsu=urn:plant;i=3");
+
+            CHECK_EQ(diff.GetNumberOfComparedNodes(), 3);
+            CHECK_EQ(diff.GetNumberOfAddedNodes(), 1);
+            CHECK_EQ(diff.GetNumberOfChangedNodes(), 1);
+            CHECK_EQ(diff.GetNumberOfRemovedNodes(), 1);
+            CHECK_EQ(diff.GetNumberOfBaseNodes(), 0);
+        }
+
+        SUBCASE("The same unloading through the snapshot has no differences")
+        {
+            std::stringstream snapshot;
+            {
+                FieldNames snapshot_field_names;
+                NodesetSnapshot::Writer writer(snapshot, snapshot_field_names);
+                std::istringstream input(new_document);
+                NodesetDigestReader(snapshot_field_names).Read(input, [&writer](std::string&& node_id, NodeDigest&& digest) { writer.Write(node_id, digest); });
+                REQUIRE(writer.Finish());
+            }
+            REQUIRE(NodesetSnapshot::IsSnapshot(snapshot));
+            CHECK_EQ(NodesetSnapshot::Read(snapshot, field_names, [&diff](std::string&& node_id, NodeDigest&& digest) { diff.AddBaseNode(std::move(node_id), std::move(digest)); }), 3);
+
+            CHECK(Compare(diff, field_names, new_document).empty());
+            CHECK_EQ(diff.GetNumberOfComparedNodes(), 3);
+            CHECK_EQ(diff.GetNumberOfChangedNodes(), 0);
+        }
+
+        SUBCASE("The repeated references are compared as the multiset")
+        {
+            const auto reference = R"(<Reference ReferenceType="i=47">i=1</Reference>)";
+            const auto document = [reference](size_t number_of_references)
+            {
+                std::string references;
+                for (size_t index = 0; index < number_of_references; ++index)
+                {
+                    references += reference;
+                }
+                return R"(<UANodeSet><UAObject NodeId="i=5001" BrowseName="A"><References>)" + references + "</References></UAObject></UANodeSet>";
+            };
+            std::istringstream base_input(document(1));
+            NodesetDigestReader(field_names).Read(base_input, [&diff](std::string&& node_id, NodeDigest&& digest) { diff.AddBaseNode(std::move(node_id), std::move(digest)); });
+
+            const auto differences = Compare(diff, field_names, document(3));
+            REQUIRE_EQ(differences.size(), 1);
+            CHECK_EQ(differences[0].kind, Kind::Changed);
+            CHECK(differences[0].changed_fields.empty());
+            CHECK_EQ(differences[0].added_references, 2);
+            CHECK_EQ(differences[0].removed_references, 0);
+        }
+    }
+}
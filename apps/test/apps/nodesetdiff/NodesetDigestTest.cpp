@@ -0,0 +1,231 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "apps/nodesetdiff/NodesetDigest.h"
+
+#include <doctest/doctest.h>
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+using FieldNames = apps::nodesetdiff::FieldNames;
+using NodeDigest = apps::nodesetdiff::NodeDigest;
+using NodesetDigestReader = apps::nodesetdiff::NodesetDigestReader;
+using NodesetSnapshot = apps::nodesetdiff::NodesetSnapshot;
+
+using Digests = std::map<std::string, NodeDigest>;
+
+bool IsSameDigest(const NodeDigest& left, const NodeDigest& right)
+{
+    return left.fields == right.fields && left.references == right.references;
+}
+
+Digests ReadDigests(const std::string& document, FieldNames& field_names)
+{
+    std::istringstream input(document);
+    Digests digests;
+    NodesetDigestReader(field_names).Read(input, [&digests](std::string&& node_id, NodeDigest&& digest) { digests.emplace(std::move(node_id), std::move(digest)); });
+    return digests;
+}
+
+// The namespaces are in the order urn:a, urn:b, the types are referenced by the aliases.
+const std::string document_with_aliases = R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+    <NamespaceUris>
+        <Uri>urn:a</Uri>
+        <Uri>urn:b</Uri>
+    </NamespaceUris>
+    <Aliases>
+        <Alias Alias="HasComponent">i=47</Alias>
+        <Alias Alias="HasTypeDefinition">i=40</Alias>
+        <Alias Alias="Double">i=11</Alias>
+        <Alias Alias="PumpType">ns=2;i=1000</Alias>
+    </Aliases>
+    <Models>
+        <Model ModelUri="urn:b"/>
+    </Models>
+    <UAObject NodeId="ns=2;i=1" BrowseName="2:Pump" ParentNodeId="i=85">
+        <DisplayName>Pump</DisplayName>
+        <References>
+            <Reference ReferenceType="HasComponent" IsForward="false">i=85</Reference>
+            <Reference ReferenceType="HasTypeDefinition">PumpType</Reference>
+            <Reference ReferenceType="HasComponent">ns=2;i=2</Reference>
+        </References>
+    </UAObject>
+    <UAVariable NodeId="ns=2;i=2" BrowseName="2:Speed" DataType="Double" ParentNodeId="ns=2;i=1">
+        <DisplayName>Speed</DisplayName>
+        <References>
+            <Reference ReferenceType="HasComponent" IsForward="false">ns=2;i=1</Reference>
+        </References>
+        <Value>
+            <Double xmlns="http://opcfoundation.org/UA/2008/02/Types.xsd">1.5</Double>
+        </Value>
+    </UAVariable>
+</UANodeSet>)";
+
+// The same nodes: the namespaces are in the other order, the aliases are not used, the attributes and the references are in the other order,
+// the formatting and the namespace prefixes differ.
+const std::string document_without_aliases = R"(<ua:UANodeSet xmlns:ua="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd"><ua:NamespaceUris><ua:Uri> urn:b </ua:Uri><ua:Uri>urn:a</ua:Uri></ua:NamespaceUris>
+<ua:UAVariable DataType="i=11" ParentNodeId="ns=1;i=1" BrowseName="1:Speed" NodeId="ns=1;i=2"><ua:Value><uax:Double xmlns:uax="http://opcfoundation.org/UA/2008/02/Types.xsd">
+  1.5
+</uax:Double></ua:Value><ua:DisplayName>Speed</ua:DisplayName>
+<ua:References><ua:Reference IsForward="false" ReferenceType="i=47">ns=1;i=1</ua:Reference></ua:References></ua:UAVariable>
+<ua:UAObject ParentNodeId="i=85" BrowseName="1:Pump" NodeId="ns=1;i=1"><ua:References>
+<ua:Reference ReferenceType="i=47">ns=1;i=2</ua:Reference><ua:Reference ReferenceType="i=40">ns=1;i=1000</ua:Reference>
+<ua:Reference ReferenceType="i=47" IsForward="false">i=85</ua:Reference></ua:References><ua:DisplayName>Pump</ua:DisplayName></ua:UAObject></ua:UANodeSet>)";
+} // namespace
+
+TEST_SUITE("apps::nodesetdiff")
+{
+    TEST_CASE("apps::nodesetdiff::NodesetDigestReader")
+    {
+        FieldNames field_names;
+
+        SUBCASE("The namespace indices are replaced by the URIs")
+        {
+            const auto digests = ReadDigests(document_with_aliases, field_names);
+            REQUIRE_EQ(digests.size(), 2);
+            CHECK(digests.contains("nsu=urn:b;i=1"));
+            CHECK(digests.contains("nsu=urn:b;i=2"));
+        }
+
+        SUBCASE("The documents that differ only by the aliases, the namespace order and the formatting have the same digests")
+        {
+            const auto with_aliases = ReadDigests(document_with_aliases, field_names);
+            const auto without_aliases = ReadDigests(document_without_aliases, field_names);
+            REQUIRE_EQ(with_aliases.size(), 2);
+            REQUIRE_EQ(without_aliases.size(), 2);
+            for (const auto& [node_id, digest] : with_aliases)
+            {
+                INFO(node_id);
+                REQUIRE(without_aliases.contains(node_id));
+                CHECK(IsSameDigest(digest, without_aliases.at(node_id)));
+            }
+        }
+
+        SUBCASE("The change of the field or of the reference changes the digest")
+        {
+            const auto base = ReadDigests(document_with_aliases, field_names);
+
+            auto changed_value = document_with_aliases;
+            changed_value.replace(changed_value.find(">1.5<"), 5, ">2.5<");
+            auto digests = ReadDigests(changed_value, field_names);
+            CHECK(IsSameDigest(digests.at("nsu=urn:b;i=1"), base.at("nsu=urn:b;i=1")));
+            CHECK_FALSE(digests.at("nsu=urn:b;i=2").fields == base.at("nsu=urn:b;i=2").fields);
+            CHECK_EQ(digests.at("nsu=urn:b;i=2").references, base.at("nsu=urn:b;i=2").references);
+
+            // The alias of the other namespace: ns=1 is urn:a, so the type definition is the other node.
+            auto changed_reference = document_with_aliases;
+            changed_reference.replace(changed_reference.find("ns=2;i=1000"), 11, "ns=1;i=1000");
+            digests = ReadDigests(changed_reference, field_names);
+            CHECK_EQ(digests.at("nsu=urn:b;i=1").fields, base.at("nsu=urn:b;i=1").fields);
+            CHECK_FALSE(digests.at("nsu=urn:b;i=1").references == base.at("nsu=urn:b;i=1").references);
+
+            auto changed_browse_name = document_with_aliases;
+            changed_browse_name.replace(changed_browse_name.find("2:Speed"), 7, "1:Speed");
+            digests = ReadDigests(changed_browse_name, field_names);
+            CHECK_FALSE(IsSameDigest(digests.at("nsu=urn:b;i=2"), base.at("nsu=urn:b;i=2")));
+        }
+
+        SUBCASE("The unknown namespace index and ns=0 are left as is")
+        {
+            const auto digests = ReadDigests(R"(<UANodeSet><NamespaceUris><Uri>urn:a</Uri></NamespaceUris>
+<UAObject NodeId="ns=3;i=1" BrowseName="3:A"/><UAObject NodeId="i=2" BrowseName="B"/><UAObject NodeId="ns=1;s=x;y" BrowseName="1:C"/></UANodeSet>)",
+                                             field_names);
+            CHECK(digests.contains("ns=3;i=1"));
+            CHECK(digests.contains("i=2"));
+            CHECK(digests.contains("nsu=urn:a;s=x;y"));
+        }
+
+        SUBCASE("The document is not the NodeSet2 document")
+        {
+            CHECK_THROWS_AS(ReadDigests("<Other/>", field_names), std::runtime_error);
+            CHECK_THROWS_AS(ReadDigests("<UANodeSet><UAObject NodeId=\"i=1\">", field_names), std::runtime_error);
+        }
+    }
+
+    TEST_CASE("apps::nodesetdiff::NodesetSnapshot")
+    {
+        FieldNames field_names;
+        const auto digests = ReadDigests(document_with_aliases, field_names);
+
+        std::stringstream snapshot;
+        NodesetSnapshot::Writer writer(snapshot, field_names);
+        for (const auto& [node_id, digest] : digests)
+        {
+            writer.Write(node_id, digest);
+        }
+        REQUIRE(writer.Finish());
+
+        SUBCASE("The snapshot is recognized by the magic")
+        {
+            CHECK(NodesetSnapshot::IsSnapshot(snapshot));
+            CHECK_EQ(snapshot.tellg(), std::streampos{0});
+            std::istringstream document(document_with_aliases);
+            CHECK_FALSE(NodesetSnapshot::IsSnapshot(document));
+            std::istringstream empty;
+            CHECK_FALSE(NodesetSnapshot::IsSnapshot(empty));
+        }
+
+        SUBCASE("The reloaded snapshot has the same digests")
+        {
+            Digests reloaded;
+            const auto number_of_nodes = NodesetSnapshot::Read(snapshot, field_names, [&reloaded](std::string&& node_id, NodeDigest&& digest)
+                                                               { reloaded.emplace(std::move(node_id), std::move(digest)); });
+            CHECK_EQ(number_of_nodes, digests.size());
+            REQUIRE_EQ(reloaded.size(), digests.size());
+            for (const auto& [node_id, digest] : digests)
+            {
+                INFO(node_id);
+                REQUIRE(reloaded.contains(node_id));
+                CHECK(IsSameDigest(reloaded.at(node_id), digest));
+            }
+        }
+
+        SUBCASE("The snapshot is reloaded into the table with the other indices of the field names")
+        {
+            FieldNames other_field_names;
+            other_field_names.Index("Value");
+            other_field_names.Index("Unrelated");
+            other_field_names.Index("DisplayName");
+            Digests reloaded;
+            NodesetSnapshot::Read(snapshot, other_field_names, [&reloaded](std::string&& node_id, NodeDigest&& digest) { reloaded.emplace(std::move(node_id), std::move(digest)); });
+
+            // The digests of the document read with the other table are the same as the reloaded ones.
+            const auto expected = ReadDigests(document_without_aliases, other_field_names);
+            REQUIRE_EQ(reloaded.size(), expected.size());
+            for (const auto& [node_id, digest] : expected)
+            {
+                INFO(node_id);
+                REQUIRE(reloaded.contains(node_id));
+                CHECK(IsSameDigest(reloaded.at(node_id), digest));
+            }
+        }
+
+        SUBCASE("The truncated and the damaged snapshots")
+        {
+            const auto content = snapshot.str();
+            const auto read = [&field_names](const std::string& data)
+            {
+                std::istringstream input(data);
+                return NodesetSnapshot::Read(input, field_names, [](std::string&&, NodeDigest&&) {});
+            };
+            CHECK_EQ(read(content), digests.size());
+            CHECK_THROWS_AS(read(content.substr(0, content.size() - 1)), std::runtime_error); // Without 'E'
+            CHECK_THROWS_AS(read(content.substr(0, content.size() / 2)), std::runtime_error);
+            CHECK_THROWS_AS(read("NSDIGST0"), std::runtime_error);
+            auto damaged = content;
+            damaged[NodesetSnapshot::magic.size()] = 'X';
+            CHECK_THROWS_AS(read(damaged), std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,170 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "apps/nodesetdiff/XmlStreamReader.h"
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+using XmlStreamReader = apps::nodesetdiff::XmlStreamReader;
+using Event = XmlStreamReader::Event;
+
+/**
+ * @brief Reading of the whole document into the list of the tokens: "<Name a=v>", "</Name>", "\"text\"", the whitespace text is skipped.
+ */
+std::vector<std::string> ReadTokens(const std::string& document)
+{
+    std::istringstream input(document);
+    XmlStreamReader reader(input);
+    std::vector<std::string> tokens;
+    for (auto event = reader.Next(); event != Event::EndOfDocument; event = reader.Next())
+    {
+        switch (event)
+        {
+        case Event::StartElement:
+        {
+            auto token = "<" + reader.GetName();
+            for (const auto& [name, value] : reader.GetAttributes())
+            {
+                token += " " + name + "=" + value;
+            }
+            tokens.push_back(token + ">");
+            break;
+        }
+        case Event::EndElement:
+            tokens.push_back("</" + reader.GetName() + ">");
+            break;
+        case Event::Text:
+            if (reader.GetText().find_first_not_of(" \t\r\n") != std::string::npos)
+            {
+                tokens.push_back("\"" + reader.GetText() + "\"");
+            }
+            break;
+        case Event::EndOfDocument:
+            break;
+        }
+    }
+    return tokens;
+}
+} // namespace
+
+TEST_SUITE("apps::nodesetdiff")
+{
+    TEST_CASE("apps::nodesetdiff::XmlStreamReader")
+    {
+        SUBCASE("The elements, the attributes and the text")
+        {
+            const auto tokens = ReadTokens(R"(<?xml version="1.0" encoding="utf-8"?>
+<ua:UANodeSet xmlns:ua="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+    <UAObject NodeId='ns=1;i=5' BrowseName = "1:Pump"
+              ParentNodeId="i=85">
+        <DisplayName Locale="en">Pump</DisplayName>
+        <References/>
+    </UAObject>
+</ua:UANodeSet>)");
+            const std::vector<std::string> expected{
+                "<ua:UANodeSet xmlns:ua=http://opcfoundation.org/UA/2011/03/UANodeSet.xsd>",
+                "<UAObject NodeId=ns=1;i=5 BrowseName=1:Pump ParentNodeId=i=85>",
+                "<DisplayName Locale=en>",
+                "\"Pump\"",
+                "</DisplayName>",
+                "<References>",
+                "</References>", // The empty element gives the end event with the name of the start one.
+                "</UAObject>",
+                "</ua:UANodeSet>"};
+            CHECK_EQ(tokens, expected);
+        }
+
+        SUBCASE("The name without the prefix and the search of the attribute")
+        {
+            std::istringstream input(R"(<ua:Value ua:Type="Int32" Empty=""/>)");
+            XmlStreamReader reader(input);
+            REQUIRE_EQ(reader.Next(), Event::StartElement);
+            CHECK_EQ(reader.GetName(), "ua:Value");
+            CHECK_EQ(reader.GetLocalName(), "Value");
+            REQUIRE_NE(reader.FindAttribute("ua:Type"), nullptr);
+            CHECK_EQ(*reader.FindAttribute("ua:Type"), "Int32");
+            REQUIRE_NE(reader.FindAttribute("Empty"), nullptr);
+            CHECK(reader.FindAttribute("Empty")->empty());
+            CHECK_EQ(reader.FindAttribute("Type"), nullptr);
+            CHECK_EQ(reader.Next(), Event::EndElement);
+            CHECK_EQ(reader.Next(), Event::EndOfDocument);
+        }
+
+        SUBCASE("The predefined and the numeric character references")
+        {
+            const auto tokens = ReadTokens(R"(<a title="&quot;x&quot; &amp; &apos;y&apos;">&lt;b&gt; &#65;&#x42;&#X43; &#x20AC; &#128512;</a>)");
+            const std::vector<std::string> expected{
+                R"(<a title="x" & 'y'>)", "\"<b> ABC \xE2\x82\xAC \xF0\x9F\x98\x80\"", "</a>"};
+            CHECK_EQ(tokens, expected);
+        }
+
+        SUBCASE("The whitespace symbols of the attribute value are replaced by the space")
+        {
+            const auto tokens = ReadTokens("<a b=\"1\t2\n3\r4\"/>");
+            REQUIRE_FALSE(tokens.empty());
+            CHECK_EQ(tokens.front(), "<a b=1 2 3 4>");
+        }
+
+        SUBCASE("CDATA is the text as is")
+        {
+            const auto tokens = ReadTokens("<a><![CDATA[<b>&amp;]]</b>]]></a>");
+            const std::vector<std::string> expected{"<a>", "\"<b>&amp;]]</b>\"", "</a>"};
+            CHECK_EQ(tokens, expected);
+        }
+
+        SUBCASE("The comments, the processing instructions and DOCTYPE are skipped")
+        {
+            const auto tokens = ReadTokens(R"(<!DOCTYPE a [<!ELEMENT a ANY>]>
+<!-- the comment with <a> and - inside -->
+<a><!--x--><?pi data?>text<!---->more</a>
+<!-- the trailing comment -->)");
+            const std::vector<std::string> expected{"<a>", "\"text\"", "\"more\"", "</a>"};
+            CHECK_EQ(tokens, expected);
+        }
+
+        SUBCASE("The token crossing the boundary of the read block")
+        {
+            const std::string long_value(XmlStreamReader::buffer_size + 10, 'v'); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            const auto tokens = ReadTokens("<a b=\"" + long_value + "\">" + long_value + "</a>");
+            const std::vector<std::string> expected{"<a b=" + long_value + ">", "\"" + long_value + "\"", "</a>"};
+            CHECK_EQ(tokens, expected);
+        }
+
+        SUBCASE("The line of the document is counted")
+        {
+            std::istringstream input("<a>\n\n<b/>\n</a>");
+            XmlStreamReader reader(input);
+            CHECK_EQ(reader.Next(), Event::StartElement);
+            CHECK_EQ(reader.GetLine(), 1);
+            CHECK_EQ(reader.Next(), Event::Text);
+            CHECK_EQ(reader.Next(), Event::StartElement);
+            CHECK_EQ(reader.GetName(), "b");
+            CHECK_EQ(reader.GetLine(), 3);
+        }
+
+        SUBCASE("The malformed documents")
+        {
+            CHECK_THROWS_AS(ReadTokens("<a>&unknown;</a>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a>&#xZZ;</a>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a>&amp</a>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a b=c/>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a b=\"c/>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a><b></b>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a></a></b>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a><!-- not closed </a>"), std::runtime_error);
+            CHECK_THROWS_AS(ReadTokens("<a><![CDATA[not closed</a>"), std::runtime_error);
+        }
+    }
+}
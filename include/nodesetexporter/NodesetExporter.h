@@ -36,6 +36,7 @@
 #endif
 #endif
 
+#include "Attribute_profiles.h"
 #include "Encoder_types.h"
 #include "LoggerBase.h"
 #include "Statuses.h"
@@ -44,14 +45,24 @@
 #include <open62541/client.h>
 #include <open62541/server.h>
 
+#include <chrono>
+#include <functional>
 #include <map>
 #include <optional>
+#include <set>
+#include <stop_token>
 #include <vector>
 
 namespace nodesetexporter
 {
+namespace open62541
+{
+class Open62541NodesetFileWrapper;
+} // namespace open62541
+
 using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
 using EncoderTypes = nodesetexporter::common::EncoderTypes;
+using AttributeProfiles = nodesetexporter::common::AttributeProfiles;
 using ExpandedNodeId = nodesetexporter::open62541::UATypesContainer<UA_ExpandedNodeId>;
 using LogLevel = nodesetexporter::common::LogLevel;
 using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
@@ -79,6 +90,87 @@ using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
  * @param flat_list_of_nodes__allow_abstract_variable Works in conjunction with "flat_list_of_nodes__create_missing_start_node" and "flat_list_of_nodes__is_enable".
  *                                                    When enabled, adding two backlinks of type "HasComponent" to nodes 'i=63" and "i=58" thus allows using nodes of class
  *                                                    "Variable" of abstract type. [optionally] [experimental]
+ * @param stop_token Token for the cooperative stop of the export, for example from std::stop_source or std::jthread. After the stop request, the current batch of nodes
+ *                   is finished, the unloading is marked as partial and closed, and the function returns the Cancelled sub-status. [optional]
+ * @param async_client__dispatcher Works only with the UA_Client data source. If set, the requests are sent asynchronously (UA_Client_sendAsyncRequest) and several of them are in flight
+ *                                 at the same time. The function transfers tasks to the event loop thread that owns the client and regularly calls UA_Client_run_iterate.
+ *                                 The export must be called from another thread, and the client must not be used by other threads during the export. [optional]
+ * @param async_client__max_requests_in_flight Works in conjunction with "async_client__dispatcher". The maximum number of requests awaiting a response. 0 - the default value (4). [optional]
+ * @param async_client__max_operations_per_request Works in conjunction with "async_client__dispatcher". The maximum number of operations (attributes, nodes, continuation points)
+ *                                                 in one request. 0 - the operations of one batch are divided equally between the requests in flight. [optional]
+ * @param session_recovery__reconnect Works only with the UA_Client data source and the synchronous client (without "async_client__dispatcher"). If set, the request
+ *                                    that has failed because of the lost connection or session (BadConnectionClosed, BadSessionIdInvalid, etc.) is issued again after
+ *                                    the reconnection by this function (for example, UA_Client_connect with the endpoint and the credentials). The interrupted Browse
+ *                                    is issued again from the beginning, the continuation points of the lost session are dropped. [optional]
+ * @param session_recovery__max_attempts_per_request Works in conjunction with "session_recovery__reconnect". The maximum number of the reconnections for one request.
+ *                                                   0 - the default value (3). [optional]
+ * @param session_recovery__retry_budget Works in conjunction with "session_recovery__reconnect". The maximum number of the reconnections during the whole export.
+ *                                       0 - the default value (10). [optional]
+ * @param session_recovery__initial_backoff, session_recovery__max_backoff Work in conjunction with "session_recovery__reconnect". The pause before the reconnection
+ *                                                                        is doubled on each attempt of the request up to the maximum.
+ *                                                                        0 - the default values (1 s and 30 s). [optional]
+ * @param rate_limit__requests_per_second, rate_limit__operations_per_second, rate_limit__bytes_per_second Work only with the UA_Client data source and the synchronous
+ *                                    client (without "async_client__dispatcher"). The limits of the rate of the requests, of the operations (the attributes of Read,
+ *                                    the nodes of Browse, the continuation points) and of the bytes of the responses per second. 0 - no limit. [optional]
+ * @param rate_limit__is_adaptive Works with the same data source. Reduce the rate when the server is saturated: the latency of the responses grows,
+ *                                the server rejects the requests (BadTooManyOperations, RejectedRequestsCount of ServerDiagnosticsSummary) or is not running.
+ *                                The rate is restored gradually. [optional]
+ * @param coroutine_engine__is_enable Use the coroutine export engine instead of the synchronous one. The requests of several batches of nodes
+ *                                    (see "number_of_max_nodes_to_request_data") are executed simultaneously with the processing and export of the previous batches.
+ *                                    The unloading is the same as with the synchronous engine. [optional] [experimental]
+ * @param coroutine_engine__max_batches_in_flight Works in conjunction with "coroutine_engine__is_enable". The maximum number of batches whose requests are executed
+ *                                                at the same time. 0 - the default value (2). [optional]
+ * @param attribute_projection__profile The set of node attributes requested from the data source. The attributes that are not requested are exported as default values,
+ *                                      which reduces the number of read operations. Default - all the attributes (AttributeProfiles::Full). [optional]
+ * @param attribute_projection__custom_attributes Works in conjunction with "attribute_projection__profile" equal to AttributeProfiles::Custom. The list of the requested attributes,
+ *                                                the attributes not applicable to the node class are ignored. [optional]
+ * @param number_of_max_array_elements_to_request_data The maximum number of elements of the array value of the Variable and VariableType nodes received from the data source
+ *                                                     in one request. The one-dimensional arrays of a larger size are read by parts with IndexRange while the document is written,
+ *                                                     so the memory for the value does not depend on the size of the array. Works with both engines.
+ *                                                     Default - 0, the value is read entirely. [optional]
+ * @param type_closure Export also the types from the namespaces other than ns=0 that the nodes depend on and that are missing in the lists: the types of HasTypeDefinition,
+ *                     the supertypes, the data types, the reference types and the instance declarations of these types, transitively.
+ *                     The missing types are requested by rounds (one batched request for each depth of the dependencies) and are exported ahead of the lists.
+ *                     Can't be used with "flat_list_of_nodes__is_enable". [optional] [experimental]
+ * @param cross_list_deduplication The lists of the start nodes may overlap (a start node is in the subtree of another one). The node present in several lists
+ *                                 is requested and exported only once, by the first list in the order of the export, instead of the duplicate in the unloading.
+ *                                 The references of the nodes to the nodes of the other lists are kept. The number of the skipped nodes of each list is logged.
+ *                                 Can't be used with "flat_list_of_nodes__is_enable". [optional]
+ * @param split_output__is_enable Export the types (ObjectType, VariableType, ReferenceType, DataType) and the instances (Object, Variable) to two separate documents
+ *                                with the same namespaces and aliases. The Objects and Variables of the types (instance declarations) are exported with the types. The instances are exported to "filename" or "out_buffer". The document of the instances declares
+ *                                the model of the types as RequiredModel in the Models element, so the document of the types can be cached and reused. [optional]
+ * @param split_output__types_filename Works in conjunction with "split_output__is_enable". The file of the types. Default - "filename" with the ".types" suffix
+ *                                     before the extension. [optional]
+ * @param split_output__types_out_buffer Works in conjunction with "split_output__is_enable". The output buffer of the types instead of the file,
+ *                                       required when "out_buffer" is specified. [optional]
+ * @param split_output__types_model_uri, split_output__instances_model_uri Work in conjunction with "split_output__is_enable". The URIs of the models of the documents.
+ *                                                                        Default - the namespace URI of the first node of the document. If the types and
+ *                                                                        the instances are in one namespace, the model of the instances gets the "Instances"
+ *                                                                        path added to the URI of the types. [optional]
+ * @param canonical_output__is_enable Deterministic unloading: the nodes are sorted by NodeId, the references by the reference type, the direction and the target,
+ *                                   so the same node space gives the byte-identical document regardless of the order of the browse results of the server. [optional]
+ * @param canonical_output__skip_unchanged_write Works in conjunction with "canonical_output__is_enable" and the output to the file. The content hash of the document
+ *                                               is calculated while it is formed and stored next to the file ("filename" with the ".hash" suffix).
+ *                                               If the hash has not changed since the previous export, the file is not rewritten. [optional]
+ * @param self_validation__is_enable Check the structural invariants of the NodeSet on the stream of the exported nodes: unique NodeIds, the namespace indexes in the range,
+ *                                   the reference targets exported or in ns=0, the aliases defined, ParentNodeId with the inverse hierarchical reference.
+ *                                   The violations are logged as warnings. The check is done in one pass without parsing the unloading. [optional]
+ * @param self_validation__is_strict Works in conjunction with "self_validation__is_enable". The export returns the SelfValidationFail sub-status
+ *                                   if there are violations. The unloading is written anyway. [optional]
+ * @param quirk_fixers__names The fixers of the deviations of the server from the specification enabled for the endpoint (see quirks::MakeQuirkFixer),
+ *                            for example "kepserver": the HasTypeDefinition = BaseVariableType(62) of the variables is replaced by BaseDataVariableType(63),
+ *                            the missing inverse references are built from the string identifiers. The fixers correct the references of each batch of nodes.
+ *                            Default - the references are not corrected. [optional]
+ * @param quirk_fixers__auto_detect Enable also the fixers needed by the server according to its BuildInfo (Server/ServerStatus/BuildInfo). [optional]
+ * @param view__view_id Works only with the UA_Client data source. The View node (the ViewDescription of the Browse requests): the references of the nodes
+ *                      are browsed only within the View, the server returns only the nodes and the references of the View. The node lists should be
+ *                      collected in the same View (see browseoperations::GrabChildNodeIdsFromStartNodeId). Default - the whole address space. [optional]
+ * @param view__timestamp, view__view_version Work in conjunction with "view__view_id". The state of the View at the time or the version of the View.
+ *                                            0 - the current state. [optional]
+ * @param locales The locales of the localized attributes (DisplayName, Description) in the order of the output. The texts received with the locale "mul"
+ *                are split by the locales and all of them are exported (see locales::SplitMultiLocaleText), the first one is the main text.
+ *                The locales must also be set to the session of the UA_Client before the connection (see locales::ApplySessionLocales),
+ *                the texts are received by the same requests of the attributes. Default - only the locale of the session is exported. [optional]
  */
 struct Options
 {
@@ -95,6 +187,71 @@ struct Options
         bool create_missing_start_node;
         bool allow_abstract_variable;
     } flat_list_of_nodes{};
+    std::stop_token stop_token{};
+    struct
+    {
+        std::function<void(std::function<void()>&&)> dispatcher;
+        u_int32_t max_requests_in_flight;
+        u_int32_t max_operations_per_request;
+    } async_client{};
+    struct
+    {
+        std::function<UA_StatusCode(UA_Client&)> reconnect;
+        u_int32_t max_attempts_per_request;
+        u_int32_t retry_budget;
+        std::chrono::milliseconds initial_backoff;
+        std::chrono::milliseconds max_backoff;
+    } session_recovery{};
+    struct
+    {
+        double requests_per_second;
+        double operations_per_second;
+        double bytes_per_second;
+        bool is_adaptive;
+    } rate_limit{};
+    struct
+    {
+        bool is_enable;
+        u_int32_t max_batches_in_flight;
+    } coroutine_engine{};
+    struct
+    {
+        AttributeProfiles profile;
+        std::set<UA_AttributeId> custom_attributes;
+    } attribute_projection{};
+    u_int32_t number_of_max_array_elements_to_request_data = 0;
+    bool type_closure = false;
+    bool cross_list_deduplication = false;
+    struct
+    {
+        bool is_enable;
+        std::string types_filename;
+        std::optional<std::reference_wrapper<std::iostream>> types_out_buffer;
+        std::string types_model_uri;
+        std::string instances_model_uri;
+    } split_output{};
+    struct
+    {
+        bool is_enable;
+        bool skip_unchanged_write;
+    } canonical_output{};
+    struct
+    {
+        bool is_enable;
+        bool is_strict;
+    } self_validation{};
+    struct
+    {
+        std::vector<std::string> names;
+        bool auto_detect;
+    } quirk_fixers{};
+    struct
+    {
+        std::optional<ExpandedNodeId> view_id;
+        UA_DateTime timestamp;
+        u_int32_t view_version;
+    } view{};
+    std::vector<std::string> locales{};
 };
 
 /**
@@ -155,6 +312,23 @@ static StatusResults DLL_PUBLIC ExportNodesetFromClient( // NOLINT(misc-definiti
     return ExportNodeset<UA_Client>(open62541_object, node_ids, std::move(filename), out_buffer, opt);
 }
 
+/**
+ * @brief Function for exporting a list of nodes with the required environment to a file or buffer with the specified encoding type where the data source is
+ *        a NodeSet2 XML file loaded in advance. The namespace indices of the node IDs are the indices of the file.
+ * @param nodeset_file The loaded and indexed NodeSet2 XML file.
+ * @param node_ids List of nodes to export.
+ * @param filename Full path and name of the file where the upload will be generated.
+ * @param out_buffer Output buffer where the upload will be generated instead of the file. When this parameter is specified, the file will not be generated. [optional]
+ * @param opt Additional export mode options. The "async_client" options are not used. [optional]
+ * @return Function execution status.
+ */
+StatusResults DLL_PUBLIC ExportNodesetFromNodesetFile(
+    open62541::Open62541NodesetFileWrapper& nodeset_file,
+    const std::map<std::string, std::vector<ExpandedNodeId>>& node_ids,
+    std::string&& filename,
+    std::optional<std::reference_wrapper<std::iostream>> out_buffer = std::nullopt,
+    const Options& opt = Options()) noexcept;
+
 } // namespace nodesetexporter
 
 #endif // NODESETEXPORTER_NODESETEXPORTER_H
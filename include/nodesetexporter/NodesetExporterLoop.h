@@ -9,11 +9,17 @@
 #ifndef NODESETEXPORTER_NODESETEXPORTERLOOP_H
 #define NODESETEXPORTER_NODESETEXPORTERLOOP_H
 
+#include "nodesetexporter/common/Attribute_profiles.h"
+#include "nodesetexporter/common/Coroutines.h"
 #include "nodesetexporter/common/LoggerBase.h"
 #include "nodesetexporter/common/Open62541CompatibilityCheck.h"
 #include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/interfaces/IAsyncOpen62541.h"
 #include "nodesetexporter/interfaces/IEncoder.h"
 #include "nodesetexporter/interfaces/IOpen62541.h"
+#include "nodesetexporter/interfaces/IQuirkFixer.h"
+#include "nodesetexporter/open62541/DataTypeDefinitionCache.h"
+#include "nodesetexporter/open62541/LocalizedTexts.h"
 #include "nodesetexporter/open62541/NodeIntermediateModel.h"
 #include "nodesetexporter/open62541/TypeAliases.h"
 #include "nodesetexporter/open62541/UATypesContainer.h"
@@ -22,10 +28,16 @@
 #include <open62541/types.h>
 #include <open62541/types_generated_handling.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <stop_token>
+#include <string>
 #include <variant>
+#include <vector>
 
 namespace nodesetexporter
 {
@@ -34,9 +46,17 @@ namespace nodesetexporter
 
 using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
 using LogLevel = nodesetexporter::common::LogLevel;
+using AttributeProfiles = nodesetexporter::common::AttributeProfiles;
 using IEncoder = ::nodesetexporter::interfaces::IEncoder;
 using IOpen62541 = ::nodesetexporter::interfaces::IOpen62541;
+using IAsyncOpen62541 = ::nodesetexporter::interfaces::IAsyncOpen62541;
+using IQuirkFixer = ::nodesetexporter::interfaces::IQuirkFixer;
+using ::nodesetexporter::common::coroutines::OrderedTurns;
+using ::nodesetexporter::common::coroutines::SyncWait;
+using ::nodesetexporter::common::coroutines::Task;
+using ::nodesetexporter::common::coroutines::WhenAllBounded;
 using NodeIntermediateModel = ::nodesetexporter::open62541::NodeIntermediateModel;
+using DataTypeDefinitionCache = ::nodesetexporter::open62541::DataTypeDefinitionCache;
 using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
 using ::nodesetexporter::open62541::UATypesContainer;
 using ::nodesetexporter::open62541::typealiases::VariantsOfAttr;
@@ -70,6 +90,13 @@ public:
      * @param ignored_nodeclasses User list of ignored classes of export units. In the case of an indication of any class of the node, all nodes of this class are ignored
      * from lists of nodes. Behind the nodes of ignored classes, all subsidiaries of other classes will be removed, as a chain of connections will be destroyed.
      * By default, Method classes are always considered ignored, View - regardless of the content of this list.
+     * @param stop_token Token for the cooperative stop of the export. The stop is checked between the batches of nodes (and lists of nodes), the current batch is always
+     * finished. After the stop, the unloading is marked as partial, closed and the StartExport returns the Cancelled sub-status.
+     * @param attribute_projection__profile The profile of the requested attributes. The attributes excluded by the profile are not requested and are exported as default values.
+     * @param attribute_projection__custom_attributes List of the requested attributes for the AttributeProfiles::Custom profile.
+     * @param cross_list_deduplication The node that is present in several lists is requested and exported only once, by the first list in the order of the export.
+     * The references of the nodes of all lists to the nodes of the other lists are kept. The number of the skipped nodes of each list is logged
+     * (see GetNumberOfDeduplicatedNodes). Can't be used with flat_list_of_nodes__is_enable.
      */
     struct Options
     {
@@ -83,6 +110,15 @@ public:
         } flat_list_of_nodes{};
         UATypesContainer<UA_ExpandedNodeId> parent_start_node_replacer;
         //        std::vector<UA_NodeClass> ignored_nodeclasses;
+        std::stop_token stop_token{};
+        struct
+        {
+            AttributeProfiles profile;
+            std::set<UA_AttributeId> custom_attributes;
+        } attribute_projection{};
+        bool type_closure = false;
+        bool cross_list_deduplication = false;
+        std::vector<std::string> locales{}; // The locales of DisplayName and Description in the order of the output, see SplitLocalizedAttributes.
     };
 
 #pragma region Default parameter constants
@@ -94,19 +130,114 @@ private:
 #pragma region Methods for obtaining and generating data
 
 #pragma region Getting ID attribute
+    /**
+     * @brief Prepare a request for all the necessary node attributes depending on the node classes.
+     * @param range_for_nodes The range of operation within the list of nodes node_ids and node_classes_req_res. Used for batch requests.
+     * @param node_classes_req_res List of structures containing the node class.
+     * @param nodes_attr_req_res [out] List of attributes bound to their NodeID, the values are empty.
+     */
+    void PrepareNodeAttributesRequest(
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        const std::pair<size_t, size_t>& node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res);
+
     /**
      * @brief Prepare a request and get all the necessary node attributes.
      * @param range_for_nodes The range of operation within the list of nodes node_ids and node_classes_req_res. Used for batch requests.
      * @param node_classes_req_res List of structures containing the node class.
      * @param nodes_attr_req_res [out] List of attributes bound to their NodeID.
+     * @param chunked_value_nodes [out] The nodes of the batch whose values are read in parts, see GetNodeValues.
      * @return Request execution status.
      */
     [[nodiscard]] StatusResults GetNodeAttributes(
         const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        const std::pair<size_t, size_t>& node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes);
+
+    /**
+     * @brief Removing the Value attribute from the request of the attributes when the reading of the large arrays in parts is enabled
+     *        (see SetNumberOfMaxArrayElementsToRequestData). The values are requested after ValueRank and ArrayDimensions are known, see GetNodeValues.
+     * @param nodes_attr_req_res [in,out] The prepared request of the attributes.
+     * @return The indexes of the nodes in nodes_attr_req_res whose Value attribute was removed from the request.
+     */
+    [[nodiscard]] std::vector<size_t> TakeValuesOutOfRequest(std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res) const;
+
+    /**
+     * @brief Getting the Value attribute of the nodes after the other attributes, when the reading of the large arrays in parts is enabled
+     *        (see SetNumberOfMaxArrayElementsToRequestData). The values of the large one-dimensional arrays are not requested, such nodes are added to
+     *        chunked_value_nodes and their values are read in parts while the encoder writes the document (see MakeValueChunkReader).
+     *        The rest of the values are requested by one batch request.
+     * @param value_indexes The indexes of the nodes in nodes_attr_req_res whose Value attribute was removed from the request.
+     * @param nodes_attr_req_res [in,out] List of attributes bound to their NodeID, the Value attribute is added to the nodes whose value was requested.
+     * @param chunked_value_nodes [out] The nodes whose values are read in parts.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults GetNodeValues(
+        const std::vector<size_t>& value_indexes,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes);
+
+    /**
+     * @brief Preparing the request of the values of GetNodeValues. The part of GetNodeValues without requests, shared with the coroutine engine.
+     * @param value_indexes The indexes of the nodes in nodes_attr_req_res whose Value attribute was removed from the request.
+     * @param nodes_attr_req_res List of the received attributes of the nodes.
+     * @param chunked_value_nodes [out] The nodes whose values are read in parts.
+     * @param values_req_res [out] The request of the Value attribute of the rest of the nodes.
+     * @param requested_indexes [out] The indexes of the nodes of values_req_res in nodes_attr_req_res.
+     */
+    void PrepareNodeValuesRequest(
+        const std::vector<size_t>& value_indexes,
+        const std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& values_req_res,
+        std::vector<size_t>& requested_indexes) const;
+
+    /**
+     * @brief Moving the received values to the attributes of their nodes, see PrepareNodeValuesRequest.
+     * @param requested_indexes The indexes of the nodes of values_req_res in nodes_attr_req_res.
+     * @param values_req_res The received values, they are moved.
+     * @param nodes_attr_req_res [in,out] List of attributes bound to their NodeID.
+     */
+    void SetNodeValues(
+        const std::vector<size_t>& requested_indexes,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& values_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res) const;
+
+    /**
+     * @brief Getting the DataTypeDefinition of the DataType nodes from the legacy DataTypeDictionary, if the server did not return the attribute
+     *        (for example, the servers on the Open62541 1.3 library). The abstract data types and the nodes filtered out as the standard ones are skipped.
+     *        The dictionaries are requested once per export session (see DataTypeDefinitionCache). The coroutine engine calls it through
+     *        IAsyncOpen62541::ExecuteBlockingCall, since the cache makes its requests through the synchronous IOpen62541.
+     * @param node_range The range of operation within the list of nodes node_classes_req_res. Used for batch requests.
+     * @param node_classes_req_res List of structures containing the node class.
+     * @param nodes_attr_req_res [in,out] List of attributes bound to their NodeID, the resolved definitions are added to the DataType nodes.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults GetMissingDataTypeDefinitions(
         const std::pair<size_t, size_t>& node_range,
         const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
         std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res);
 
+    /**
+     * @brief Checking by the ValueRank and ArrayDimensions attributes whether the value of the node is a one-dimensional array that can exceed the number of
+     *        elements of a single request. The array without the known length is considered large.
+     * @param attrs The received attributes of the node.
+     * @return true - the value is read in parts.
+     */
+    [[nodiscard]] bool IsValueReadInChunks(const std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const;
+
+    /**
+     * @brief Creating the reading of the value of the node in parts of m_number_of_max_array_elements_to_request_data elements by IndexRange.
+     *        If the data source does not support the reading by IndexRange, the value is read entirely by one request.
+     *        The reader is called by the encoder in End(), when the requests of the batches are completed, so the coroutine engine also uses it.
+     * @param node_id NodeID of the node.
+     * @return The function of reading the parts of the value for NodeIntermediateModel.
+     */
+    [[nodiscard]] NodeIntermediateModel::ValueChunkReader MakeValueChunkReader(const UATypesContainer<UA_ExpandedNodeId>& node_id);
+
     /**
      * @brief Get the underlying node attribute IDs
      * @return A dictionary with key-filled identifiers. Values are empty.
@@ -195,6 +326,20 @@ private:
         return std::map<UA_AttributeId, std::optional<VariantsOfAttr>>{{UA_ATTRIBUTEID_DATATYPEDEFINITION, std::nullopt}, {UA_ATTRIBUTEID_ISABSTRACT, std::nullopt}};
     }
 
+    /**
+     * @brief Removing the attributes not included in the selected attribute profile from the request. The removed attributes are exported as default values.
+     * @param attrs [in,out] The attributes of the node class.
+     */
+    void ApplyAttributeProfile(std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const;
+
+    /**
+     * @brief Removing the attributes that the encoder does not write for the node class from the request (see IEncoder::GetConsumedAttributes).
+     *        BrowseName and DataType are always kept, they are used by the export core itself.
+     * @param node_class The class of the node.
+     * @param attrs [in,out] The attributes of the node class.
+     */
+    void ApplyEncoderConsumedAttributes(UA_NodeClass node_class, std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const;
+
     // todo Do I need to add support for View attribute query?
 #pragma endregion Retrieving the ID attribute
 
@@ -213,11 +358,27 @@ private:
         std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res);
 
     /**
-     * @brief Method for processing references for working with the KepServer server (and similar ones with similar features)
+     * @brief Checking the received references: each node must have at least one reference (except the created start node in the flat list mode).
+     * @param range_for_nodes The range of operation within the list of nodes. Used for batch requests.
+     * @param node_references_req_res List of references associated with NodeID.
+     * @return Verification status.
+     */
+    [[nodiscard]] StatusResults CheckNodeReferences(const std::pair<size_t, size_t>& node_range, const std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res);
+
+    /**
+     * @brief Correction of the references of the batch by the enabled fixers of the deviations of the server (see AddQuirkFixer).
      * @param node_references_req_res List of references associated with NodeID.
      * @return Request execution status.
      */
-    [[nodiscard]] StatusResults KepServerRefFix(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res);
+    [[nodiscard]] StatusResults FixQuirks(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res);
+
+    /**
+     * @brief Splitting of the localized attributes (DisplayName, Description) received with the locale "mul" by the locales of the export (see Options::locales).
+     *        The attribute gets the text of the first locale, all texts are moved to the model. The text that can't be split is left as is.
+     * @param attrs The attributes of the node.
+     * @param nim The model of the node.
+     */
+    void SplitLocalizedAttributes(std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs, NodeIntermediateModel& nim);
 
     /**
      * @brief Remove references to ignored, known nodes.
@@ -294,7 +455,7 @@ private:
     /**
      * @brief Returns the NodeID of the underlying node types.
      * @param node_class The node class.
-     * @return NodeID of the node's base type depending on the node class passed in.
+     * @return NodeID of the node's base type depending on the node class passed in, nullptr if the node class is not the type class.
      */
     std::unique_ptr<UATypesContainer<UA_ExpandedNodeId>> GetBaseObjectType(UA_NodeClass node_class);
 
@@ -328,6 +489,13 @@ private:
         const std::pair<size_t, size_t>& node_range,
         std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res);
 
+    /**
+     * @brief In the flat list mode with the creation of the missing start node, the start node is given the Object class and a good result code.
+     * @param range_for_nodes The range of operation within the list of nodes. Only the batch with the start node is processed.
+     * @param node_classes_req_res [in/out] List of structures containing the node class.
+     */
+    void CorrectStartNodeClass(const std::pair<size_t, size_t>& node_range, std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res);
+
     /**
      * @brief The main method for obtaining the necessary data to generate a list of intermediate structures describing the main parameters of a node and its attributes.
      * @remark node_ids is a synchronizer for all arrays of structures based on NodeID as a sequence of elements.
@@ -349,6 +517,26 @@ private:
         const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
         std::vector<NodeIntermediateModel>& node_models);
 
+    /**
+     * @brief Filtering and packing the received attributes and references of the nodes into intermediate structures. The part of GetNodesData without requests.
+     * @param node_ids List of NodeIds of nodes that participate in the export.
+     * @param range_for_nodes The range of operation within the list of nodes node_ids and node_classes_req_res. Used for batch requests.
+     * @param node_classes_req_res List of structures containing the node class.
+     * @param nodes_attr_req_res List of attributes of the batch, the values are moved to node_models.
+     * @param node_references_req_res List of references of the batch, the values are moved to node_models.
+     * @param chunked_value_nodes The nodes of the batch whose values are read in parts, they receive the reader of the value (see MakeValueChunkReader).
+     * @param node_models [out] List of intermediate structures describing the main parameters of nodes and their attributes.
+     * @return Processing status.
+     */
+    [[nodiscard]] StatusResults ProcessNodesData(
+        const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+        const std::pair<size_t, size_t>& node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+        const std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+        std::vector<NodeIntermediateModel>& node_models);
+
     /**
      * @brief The method removes duplicate nodes from the list.
      * @param node_ids The list of components that need to remove Nodeid duplicates.
@@ -368,6 +556,67 @@ private:
      */
     [[nodiscard]] StatusResults CheckStartNodesOnNS0();
 
+#pragma region Type closure
+    // The dependency found by the type closure: the NodeID and the node class known from the reference or the attribute.
+    using TypeDependency = std::pair<UATypesContainer<UA_ExpandedNodeId>, UA_NodeClass>;
+
+    /**
+     * @brief Collecting the transitive closure of the types that the nodes of all lists depend on (see Options::type_closure): the targets of HasTypeDefinition,
+     *        the supertypes (inverse HasSubtype), the DataType attribute, the types of the references and the data types of the fields of the DataTypeDefinition.
+     *        The instance declarations (forward hierarchical references) of the types found are added too.
+     *        The nodes are requested in rounds: each depth of the closure is one batched Browse and Read of all its new nodes, each node is requested once.
+     *        Only the local nodes outside ns=0 that are missing in the lists are added. They are placed in the list type_closure_list_name, which is exported first,
+     *        the deeper rounds (the supertypes) ahead of the shallower ones.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults CollectTypeClosure();
+
+    /**
+     * @brief Getting the dependencies of one batch of one round of the type closure.
+     * @param node_ids NodeIDs of the nodes of the round.
+     * @param node_classes Node classes in the size and order of node_ids.
+     * @param node_range The range of the batch within node_ids.
+     * @param is_closure_round The nodes of the round were found by the closure. Their instance declarations are also dependencies.
+     * @param dependencies [out] The found dependencies are added, not unique.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults GetTypeDependencies(
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        const std::vector<UA_NodeClass>& node_classes,
+        const std::pair<size_t, size_t>& node_range,
+        bool is_closure_round,
+        std::vector<TypeDependency>& dependencies);
+
+    /**
+     * @brief The lists of nodes in the order of the export: the list of the type closure first, then the lists of the start nodes.
+     */
+    [[nodiscard]] std::vector<std::reference_wrapper<std::pair<const std::string, std::vector<ExpandedNodeId>>>> GetListsInExportOrder();
+#pragma endregion Type closure
+
+#pragma region Cross-list deduplication
+    /**
+     * @brief Mapping of each node of all lists to the first list in the order of the export that contains it (see Options::cross_list_deduplication).
+     *        Called after the type closure is collected, so the list of the type closure is taken into account too.
+     */
+    void MapNodesToFirstLists();
+
+    /**
+     * @brief Removing the nodes that are exported by the previous lists from the list, the order of the rest of the nodes is kept.
+     *        The number of the removed nodes is stored for the list. If the start node of the list is removed, the list has no start node anymore.
+     * @param list_of_nodes The list of nodes in the turn of the export.
+     */
+    void DeduplicateAcrossLists(std::pair<const std::string, std::vector<ExpandedNodeId>>& list_of_nodes);
+
+    /**
+     * @brief Checking whether the node by the index of the list is the start node of the list. The list of the type closure and the list
+     *        whose start node was exported by a previous list have no start node.
+     */
+    [[nodiscard]] bool IsStartNode(const std::pair<std::string, std::vector<ExpandedNodeId>>& list_of_nodes, size_t index) const
+    {
+        return index == 0 && list_of_nodes.first != type_closure_list_name && !m_is_start_node_deduplicated;
+    }
+#pragma endregion Cross-list deduplication
+
 #pragma endregion Methods for obtaining and generating data
 
 #pragma region Data Export Methods
@@ -433,6 +682,26 @@ private:
         return m_export_encoder.AddAliases(aliases);
     }
 
+    /**
+     * @brief A method that closes the export stopped on request: marks the unloading as partial, exports the aliases of already exported nodes and calls End().
+     * @param aliases Unique NodeID objects that represent type aliases of the already exported nodes.
+     * @return StatusResults{Fail, Cancelled} if the partial unloading was closed successfully, otherwise the status of the failed operation.
+     */
+    [[nodiscard]] StatusResults EndPartialExport(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases);
+
+    /**
+     * @brief Actions before the export of the nodes: checking the start nodes, Begin(), getting and exporting the namespaces.
+     * @return The execution status of the method.
+     */
+    [[nodiscard]] StatusResults PrepareExport();
+
+    /**
+     * @brief Actions after the export of the nodes: exporting the aliases, End() and the statistic output.
+     * @param aliases Unique NodeID objects that represent type aliases of the exported nodes.
+     * @return The execution status of the method.
+     */
+    [[nodiscard]] StatusResults FinishExport(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases);
+
     /**
      * @brief Method that exports the data of each node depending on its class.
      * @param list_of_nodes_data A list of intermediate structures describing the main parameters of nodes and their attributes.
@@ -442,6 +711,90 @@ private:
     [[nodiscard]] StatusResults ExportNodes(const std::vector<NodeIntermediateModel>& list_of_nodes_data);
 
 #pragma endregion Data Export Methods
+
+#pragma region Coroutine export engine
+
+    /**
+     * @brief The common state of the batches of one list of nodes in the coroutine engine.
+     * aliases - aliases of the exported nodes, changed only in the ordered section.
+     * turns - the order of the export of the batches.
+     * is_aborted - one of the batches has failed, the following batches are not requested and not exported.
+     */
+    struct BatchesContext
+    {
+        std::map<std::string, UATypesContainer<UA_NodeId>>& aliases;
+        OrderedTurns turns;
+        std::atomic_bool is_aborted = false;
+    };
+
+    /**
+     * @brief Dividing the list of nodes into batches by m_number_of_max_nodes_to_request_data, the same as in the synchronous engine.
+     * @param number_of_nodes Number of nodes in the list.
+     * @return Ranges of the batches.
+     */
+    [[nodiscard]] std::vector<std::pair<size_t, size_t>> SplitIntoBatches(size_t number_of_nodes) const;
+
+    /**
+     * @brief Awaitable analog of GetNodeClasses. Before the request, the stop is checked.
+     * @param node_range The range of the batch. Passed by value, since the task lives longer than the calling expression.
+     */
+    [[nodiscard]] Task<StatusResults> GetNodeClassesAsync(
+        IAsyncOpen62541& async_open62541_lib,
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        std::pair<size_t, size_t> node_range,
+        std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res);
+
+    /**
+     * @brief Awaitable requests of the attributes and references of the batch (the requesting part of GetNodesData).
+     *        The values of the large arrays are separated in the same way as in GetNodeAttributes, the missing definitions of the data types are taken
+     *        from the dictionaries in the same way as in GetNodesData.
+     * @param nodes_attr_req_res [out] List of attributes of the batch.
+     * @param node_references_req_res [out] List of references of the batch.
+     * @param chunked_value_nodes [out] The nodes of the batch whose values are read in parts.
+     * @return Task with the request execution status. The Cancelled sub-status of the references request is kept.
+     */
+    [[nodiscard]] Task<StatusResults> GetNodesDataAsync(
+        IAsyncOpen62541& async_open62541_lib,
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        std::pair<size_t, size_t> node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+        std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes);
+
+    /**
+     * @brief Processing of the received data of the batch, collecting the aliases and exporting the nodes.
+     * @return The execution status with the same sub-statuses as in the synchronous engine.
+     */
+    [[nodiscard]] StatusResults ExportNodesData(
+        const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+        const std::pair<size_t, size_t>& node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+        std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+        const std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+        std::map<std::string, UATypesContainer<UA_NodeId>>& aliases);
+
+    /**
+     * @brief Task of one batch: the requests are executed simultaneously with the other batches, then the processing and export are executed in the turn of the batch.
+     * @param context The common state of the batches of the list.
+     * @param turn The index of the batch in the list.
+     * @return Task with the execution status of the batch.
+     */
+    [[nodiscard]] Task<StatusResults> ExportNodesBatchAsync(
+        IAsyncOpen62541& async_open62541_lib,
+        const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+        std::pair<size_t, size_t> node_range,
+        const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+        BatchesContext& context,
+        size_t turn);
+
+    /**
+     * @brief The coroutine analog of StartExport.
+     */
+    [[nodiscard]] Task<StatusResults> ExportAsync(IAsyncOpen62541& async_open62541_lib, size_t max_batches_in_flight);
+
+#pragma endregion Coroutine export engine
 public:
     /**
      * @brief Constructor for the node export object.
@@ -457,6 +810,7 @@ public:
         , m_open62541_lib(open62541_lib)
         , m_export_encoder(export_encoder)
         , m_external_options(std::move(options))
+        , m_data_type_definitions(open62541_lib, logger)
     {
         m_logger.Trace("Constructor called: NodesetExporterLoop()");
 
@@ -472,6 +826,28 @@ public:
             throw std::runtime_error("The 'allow_abstract_variable' parameter was enabled without 'create_missing_start_node'.");
         }
 
+        // The types are not exported in flat mode, so the type closure is meaningless.
+        if (m_external_options.type_closure && m_external_options.flat_list_of_nodes.is_enable)
+        {
+            throw std::runtime_error("The 'type_closure' parameter can't be enabled together with 'flat_list_of_nodes'.");
+        }
+
+        // In flat mode, the nodes of each list are bound to the start node of the list, so a node can't be shared by the lists.
+        if (m_external_options.cross_list_deduplication && m_external_options.flat_list_of_nodes.is_enable)
+        {
+            throw std::runtime_error("The 'cross_list_deduplication' parameter can't be enabled together with 'flat_list_of_nodes'.");
+        }
+
+        // The attributes consumed by the encoder are requested once, they do not change during the export.
+        for (const auto node_class :
+             {UA_NODECLASS_OBJECT, UA_NODECLASS_OBJECTTYPE, UA_NODECLASS_VARIABLE, UA_NODECLASS_VARIABLETYPE, UA_NODECLASS_REFERENCETYPE, UA_NODECLASS_DATATYPE})
+        {
+            if (auto consumed_attributes = m_export_encoder.GetConsumedAttributes(node_class))
+            {
+                m_encoder_consumed_attributes.emplace(node_class, std::move(consumed_attributes.value()));
+            }
+        }
+
         // In flat mode, we work only with Object and Variable Node Class.
         if (m_external_options.flat_list_of_nodes.is_enable)
         {
@@ -493,6 +869,28 @@ public:
         m_number_of_max_nodes_to_request_data = number;
     }
 
+    /**
+     * @brief Sets the maximum number of elements of the array value (UA_ATTRIBUTEID_VALUE) received from the server for one request.
+     *        The one-dimensional arrays of a larger size are read by the successive requests with IndexRange while the encoder writes the document,
+     *        so that the memory used for the value is limited by the size of the part. The same for both engines.
+     * @param number 0 - the value is received entirely together with the other attributes (default).
+     */
+    void SetNumberOfMaxArrayElementsToRequestData(u_int32_t number)
+    {
+        m_logger.Trace("Method called: SetNumberOfMaxArrayElementsToRequestData()");
+        m_number_of_max_array_elements_to_request_data = number;
+    }
+
+    /**
+     * @brief Adds the fixer of the deviations of the server. The fixers correct the references of each batch of nodes in the order of the adding,
+     *        before the references are processed. By default, the references are not corrected.
+     */
+    void AddQuirkFixer(std::unique_ptr<IQuirkFixer> quirk_fixer)
+    {
+        m_logger.Trace("Method called: AddQuirkFixer()");
+        m_quirk_fixers.push_back(std::move(quirk_fixer));
+    }
+
     /**
      * @brief Method to start a chain by exporting nodes of their accompanying data.
      * The export scheme is based on the description of the node structure of the 1.04 standard
@@ -501,19 +899,46 @@ public:
      */
     [[nodiscard]] StatusResults StartExport();
 
+    /**
+     * @brief Starting the export by the coroutine engine. The result (unloading and statuses) is the same as StartExport, which remains the reference implementation.
+     * The node classes and then the data of the batches are requested through the awaitable interface, no more than max_batches_in_flight batches at the same time,
+     * so the requests of the next batches overlap with the processing and export of the current one. The export of the nodes is performed strictly in the order of the batches.
+     * The namespaces are requested through the synchronous IOpen62541 of the constructor before the start of the batches.
+     * The stop on request is checked before each batch, the batches already started are finished.
+     * @param async_open62541_lib Implementation of the IAsyncOpen62541 interface.
+     * @param max_batches_in_flight The maximum number of batches whose requests are executed at the same time. 0 - the default value (2).
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults StartCoroutineExport(IAsyncOpen62541& async_open62541_lib, size_t max_batches_in_flight);
+
+    /**
+     * @brief The number of the nodes of each list that were skipped because they were exported by the previous lists (see Options::cross_list_deduplication).
+     *        Only the lists processed by the export are present.
+     */
+    [[nodiscard]] const std::map<std::string, size_t>& GetNumberOfDeduplicatedNodes() const noexcept
+    {
+        return m_number_of_deduplicated_nodes;
+    }
+
+    // The default number of batches whose requests are executed at the same time in the coroutine engine.
+    static constexpr size_t default_max_batches_in_flight = 2;
+
+    // The name of the list of the nodes collected by the type closure (see Options::type_closure).
+    static constexpr auto type_closure_list_name = "[type closure]";
+
 private:
     std::map<std::string, std::vector<ExpandedNodeId>> m_node_ids;
     LoggerBase& m_logger;
     IOpen62541& m_open62541_lib;
     IEncoder& m_export_encoder;
     Options m_external_options;
+    // The attributes written by the encoder for the node classes. The attributes of the missing classes are requested in full.
+    std::map<UA_NodeClass, std::set<UA_AttributeId>> m_encoder_consumed_attributes;
 
 #pragma region Nodes from the namespace of the OPC UA standard
 
     const UA_NodeId m_ns0id_objectfolder = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
-    const UA_NodeId m_ns0id_hascomponent_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
     const UA_NodeId m_ns0id_hastypedefenition_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION);
-    const UA_NodeId m_ns0id_basevariabletype_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEVARIABLETYPE);
     const UA_NodeId m_ns0id_hassubtype_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE);
     const UATypesContainer<UA_ExpandedNodeId> m_ns0id_baseobjecttype_node_id = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE), UA_TYPES_EXPANDEDNODEID);
     const UATypesContainer<UA_ExpandedNodeId>
@@ -522,6 +947,13 @@ private:
 #pragma endregion Nodes from the namespace of the OPC UA standard
 
     u_int32_t m_number_of_max_nodes_to_request_data = default_number_of_max_nodes_to_request_data;
+    u_int32_t m_number_of_max_array_elements_to_request_data = 0;
+    // The fixers of the deviations of the server, applied to the references of each batch.
+    std::vector<std::unique_ptr<IQuirkFixer>> m_quirk_fixers;
+    // The definitions of the data types resolved from the DataTypeDictionary, shared by all batches of the export (see GetMissingDataTypeDefinitions).
+    DataTypeDefinitionCache m_data_type_definitions;
+    // The cache is not thread-safe, and the batches of the coroutine engine use it from different threads.
+    std::mutex m_data_type_definitions_mutex;
     // A list of basic hierarchical types of links in the form of an associative container, consisting of "nodeid type of link: string name type of link".
     static const std::map<UATypesContainer<UA_NodeId>, std::string> m_hierarhical_references;
     // Список классов узлов представляющий ТИПЫ. Представляет собой ассоциативный контейнер из - "значение типа: строковое название типа".
@@ -532,6 +964,15 @@ private:
     static std::map<UA_NodeClass, std::string> m_ignored_nodeclasses; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
     // A list of ignored nodes according to ignored classes that should not be added to export unloading.
     std::set<UATypesContainer<UA_ExpandedNodeId>> m_ignored_node_ids_by_classes;
+    // The nodes of the type closure. The references of the nodes of all lists to them are kept.
+    std::set<UATypesContainer<UA_ExpandedNodeId>> m_type_closure_node_ids;
+    // The nodes of all lists and the first list in the order of the export that contains the node, the name is the key of m_node_ids.
+    // Filled only with the cross-list deduplication. The references of the nodes of all lists to them are kept.
+    std::map<UATypesContainer<UA_ExpandedNodeId>, std::reference_wrapper<const std::string>> m_first_list_of_nodes;
+    // The number of the nodes of each list that were exported by the previous lists.
+    std::map<std::string, size_t> m_number_of_deduplicated_nodes;
+    // The start node of the current list was exported by a previous list.
+    bool m_is_start_node_deduplicated = false;
     // Copies of all nodeid in SET to quickly search for the desired node, for filter of link correction.
     // In the global version, it is especially needed when the processing of the nodes goes "packs"
     // if m_number_of_max_nodes_to_request_data > 0.
@@ -0,0 +1,32 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_COMMON_ATTRIBUTE_PROFILES_H
+#define NODESETEXPORTER_COMMON_ATTRIBUTE_PROFILES_H
+
+namespace nodesetexporter::common
+{
+
+/**
+ * @brief Profiles of the set of node attributes requested from the server. The attributes that are not requested are exported as default values.
+ *        Full - all the attributes of the node class that are supported by the export.
+ *        NodesetMinimal - without the attributes that usually have default values or depend on the session user: Description, WriteMask, UserWriteMask,
+ *                         UserAccessLevel, UserExecutable, MinimumSamplingInterval, Historizing.
+ *        Custom - only the attributes from the user list. BrowseName, DisplayName and DataType are always requested, they are necessary to form
+ *                 the node (both names are mandatory in NodeSet2) and the aliases.
+ */
+enum class AttributeProfiles
+{
+    Full,
+    NodesetMinimal,
+    Custom
+};
+
+} // namespace nodesetexporter::common
+
+#endif // NODESETEXPORTER_COMMON_ATTRIBUTE_PROFILES_H
@@ -0,0 +1,186 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_COMMON_CONTENTHASH_H
+#define NODESETEXPORTER_COMMON_CONTENTHASH_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace nodesetexporter::common
+{
+
+/**
+ * @brief Streaming 64-bit hash of the content (XXH64 algorithm, https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md).
+ *        The data is added by parts of any size while the content is formed, the result does not depend on the division into the parts.
+ *        It is not a cryptographic hash, it is used only to detect the change of the content.
+ */
+class ContentHash final
+{
+public:
+    explicit ContentHash(uint64_t seed = 0) noexcept
+        : m_seed(seed)
+        , m_accumulators{seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1}
+    {
+    }
+
+    /**
+     * @brief Adding the next part of the content.
+     */
+    void Update(const char* data, size_t size) noexcept
+    {
+        m_total_size += size;
+        // Completing the stripe that was started by the previous parts.
+        if (m_buffer_size > 0)
+        {
+            const auto fill = std::min(size, stripe_size - m_buffer_size);
+            std::memcpy(m_buffer.data() + m_buffer_size, data, fill);
+            m_buffer_size += fill;
+            data += fill; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            size -= fill;
+            if (m_buffer_size < stripe_size)
+            {
+                return;
+            }
+            ConsumeStripe(m_buffer.data());
+            m_buffer_size = 0;
+        }
+        for (; size >= stripe_size; size -= stripe_size, data += stripe_size) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        {
+            ConsumeStripe(data);
+        }
+        if (size > 0)
+        {
+            std::memcpy(m_buffer.data(), data, size);
+            m_buffer_size = size;
+        }
+    }
+
+    void Update(char symbol) noexcept
+    {
+        Update(&symbol, 1);
+    }
+
+    /**
+     * @brief The hash of the content added so far. The state is not changed, the content can be continued.
+     */
+    [[nodiscard]] uint64_t Digest() const noexcept
+    {
+        uint64_t hash = 0;
+        if (m_total_size >= stripe_size)
+        {
+            hash = RotateLeft(m_accumulators[0], 1) + RotateLeft(m_accumulators[1], 7) + RotateLeft(m_accumulators[2], 12) + RotateLeft(m_accumulators[3], 18); // NOLINT
+            for (const auto accumulator : m_accumulators)
+            {
+                hash = (hash ^ Round(0, accumulator)) * prime_1 + prime_4;
+            }
+        }
+        else
+        {
+            hash = m_seed + prime_5;
+        }
+        hash += m_total_size;
+
+        // The tail of the content that does not fill the whole stripe.
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= m_buffer_size; offset += sizeof(uint64_t))
+        {
+            hash ^= Round(0, Read<uint64_t>(m_buffer.data() + offset)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            hash = RotateLeft(hash, 27) * prime_1 + prime_4; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+        if (offset + sizeof(uint32_t) <= m_buffer_size)
+        {
+            hash ^= static_cast<uint64_t>(Read<uint32_t>(m_buffer.data() + offset)) * prime_1; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            hash = RotateLeft(hash, 23) * prime_2 + prime_3; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            offset += sizeof(uint32_t);
+        }
+        for (; offset < m_buffer_size; ++offset)
+        {
+            hash ^= static_cast<uint64_t>(static_cast<uint8_t>(m_buffer.at(offset))) * prime_5;
+            hash = RotateLeft(hash, 11) * prime_1; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+
+        // Avalanche
+        hash ^= hash >> 33U; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        hash *= prime_2;
+        hash ^= hash >> 29U; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        hash *= prime_3;
+        hash ^= hash >> 32U; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        return hash;
+    }
+
+    /**
+     * @brief The hash of the content as 16 hexadecimal digits.
+     */
+    [[nodiscard]] std::string HexDigest() const
+    {
+        return ToHex(Digest());
+    }
+
+    [[nodiscard]] static std::string ToHex(uint64_t hash)
+    {
+        static constexpr auto digits = "0123456789abcdef";
+        std::string result(sizeof(uint64_t) * 2, '0');
+        for (auto pos = result.rbegin(); pos != result.rend(); ++pos, hash >>= 4U)
+        {
+            *pos = digits[hash & 0xFU]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t stripe_size = 32;
+    static constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ULL;
+
+    [[nodiscard]] static constexpr uint64_t RotateLeft(uint64_t value, unsigned int bits) noexcept
+    {
+        return (value << bits) | (value >> (64U - bits)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+
+    [[nodiscard]] static constexpr uint64_t Round(uint64_t accumulator, uint64_t lane) noexcept
+    {
+        return RotateLeft(accumulator + lane * prime_2, 31) * prime_1; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+
+    // Little-endian reading of the lane, the result does not depend on the alignment of the data.
+    template <typename TLane>
+    [[nodiscard]] static TLane Read(const char* data) noexcept
+    {
+        TLane result = 0;
+        for (size_t byte = 0; byte < sizeof(TLane); ++byte)
+        {
+            result |= static_cast<TLane>(static_cast<uint8_t>(data[byte])) << (byte * 8U); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+        return result;
+    }
+
+    void ConsumeStripe(const char* data) noexcept
+    {
+        for (size_t lane = 0; lane < m_accumulators.size(); ++lane)
+        {
+            m_accumulators.at(lane) = Round(m_accumulators.at(lane), Read<uint64_t>(data + lane * sizeof(uint64_t))); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    }
+
+    uint64_t m_seed;
+    std::array<uint64_t, 4> m_accumulators;
+    std::array<char, stripe_size> m_buffer{};
+    size_t m_buffer_size = 0;
+    uint64_t m_total_size = 0;
+};
+
+} // namespace nodesetexporter::common
+
+#endif // NODESETEXPORTER_COMMON_CONTENTHASH_H
@@ -0,0 +1,458 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+// Minimal set of C++20 coroutine primitives for the export pipeline: a lazy task, waiting for a task from a regular function,
+// running a group of tasks with a limit on the number of simultaneously running ones, and passing through a section in the order of turns.
+
+#ifndef NODESETEXPORTER_COMMON_COROUTINES_H
+#define NODESETEXPORTER_COMMON_COROUTINES_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace nodesetexporter::common::coroutines
+{
+
+/**
+ * @brief A lazy coroutine task with a result of type T. The task starts only when it is awaited (co_await) or passed to SyncWait/WhenAllBounded.
+ *        Upon completion, control is transferred to the awaiting coroutine (symmetric transfer), in the thread in which the task was completed.
+ * @tparam T Type of the result. Exceptions from the body of the task are rethrown to the awaiting side.
+ */
+template <typename T>
+class Task final
+{
+public:
+    class promise_type
+    {
+        struct FinalAwaiter
+        {
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept
+            {
+                auto continuation = handle.promise().m_continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+    public:
+        Task get_return_object() noexcept
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        [[nodiscard]] FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_value(T value)
+        {
+            m_value.emplace(std::move(value));
+        }
+
+        void unhandled_exception() noexcept
+        {
+            m_exception = std::current_exception();
+        }
+
+        void SetContinuation(std::coroutine_handle<> continuation) noexcept
+        {
+            m_continuation = continuation;
+        }
+
+        T TakeResult()
+        {
+            if (m_exception)
+            {
+                std::rethrow_exception(m_exception);
+            }
+            return std::move(m_value.value());
+        }
+
+    private:
+        std::coroutine_handle<> m_continuation;
+        std::optional<T> m_value;
+        std::exception_ptr m_exception;
+    };
+
+    Task() = default;
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& obj) noexcept
+        : m_handle(std::exchange(obj.m_handle, nullptr))
+    {
+    }
+    Task& operator=(Task&& obj) noexcept
+    {
+        if (this != &obj)
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(obj.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Awaiting the task: starting it and resuming the awaiting coroutine upon its completion.
+     */
+    auto operator co_await() noexcept
+    {
+        struct TaskAwaiter
+        {
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return !m_handle || m_handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_handle.promise().SetContinuation(awaiting);
+                return m_handle;
+            }
+
+            T await_resume()
+            {
+                return m_handle.promise().TakeResult();
+            }
+
+            std::coroutine_handle<promise_type> m_handle;
+        };
+        return TaskAwaiter{m_handle};
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Event for waiting for the completion of a coroutine in a regular thread. The notification is made under the lock,
+ *        so the waiting side can destroy the event immediately after the waiting.
+ */
+class CompletionEvent final
+{
+public:
+    void Set()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_set = true;
+        m_cv.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(
+            lock,
+            [this]
+            {
+                return m_is_set;
+            });
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_is_set = false;
+};
+
+/**
+ * @brief A coroutine without a result that is started immediately and destroys itself upon completion.
+ *        Used only inside the primitives of this file, the exceptions are intercepted by its body.
+ */
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        [[nodiscard]] std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        [[nodiscard]] std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+template <typename T>
+DetachedTask RunAndNotify(Task<T>& task, std::optional<T>& result, std::exception_ptr& exception, CompletionEvent& event)
+{
+    try
+    {
+        result.emplace(co_await task);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    event.Set(); // The last access to the data of the waiting side.
+}
+
+} // namespace detail
+
+/**
+ * @brief Starting the task and blocking the current thread until it is completed. The task can be completed in any thread.
+ * @warning Must not be called from a thread that the task needs to complete (for example, from the only worker thread of the data source).
+ * @return The result of the task. The exception of the task is rethrown.
+ */
+template <typename T>
+T SyncWait(Task<T>&& task)
+{
+    std::optional<T> result;
+    std::exception_ptr exception;
+    detail::CompletionEvent event;
+    detail::RunAndNotify(task, result, exception, event);
+    event.Wait();
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+    return std::move(result.value());
+}
+
+/**
+ * @brief Awaitable group of tasks, of which no more than max_running are running at the same time. The next task is started when one of the running
+ *        ones is completed, in the order of the list. The results are returned in the order of the list of tasks.
+ *        If any task has completed with an exception, the first such exception in the order of the list is rethrown after the completion of all tasks.
+ */
+template <typename T>
+class WhenAllBounded final
+{
+public:
+    WhenAllBounded(std::vector<Task<T>>&& tasks, size_t max_running)
+        : m_tasks(std::move(tasks))
+        , m_results(m_tasks.size())
+        , m_exceptions(m_tasks.size())
+        , m_max_running(max_running == 0 ? 1 : max_running)
+        , m_pending(m_tasks.size() + 1) // +1 - the reference of await_suspend itself, see await_suspend
+    {
+    }
+    ~WhenAllBounded() = default;
+    WhenAllBounded(const WhenAllBounded&) = delete;
+    WhenAllBounded(WhenAllBounded&&) = delete;
+    WhenAllBounded& operator=(const WhenAllBounded&) = delete;
+    WhenAllBounded& operator=(WhenAllBounded&&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return m_tasks.empty();
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_continuation = awaiting;
+        for (size_t started = 0; started < m_max_running; started++)
+        {
+            auto index = TakeNextIndex();
+            if (!index.has_value())
+            {
+                break;
+            }
+            Run(index.value());
+        }
+        // Until the initial tasks are started, the last completed task must not resume the awaiting coroutine,
+        // since it has not yet been suspended. Therefore, await_suspend holds its own reference and releases it last.
+        return !Release();
+    }
+
+    std::vector<T> await_resume()
+    {
+        std::vector<T> results;
+        results.reserve(m_results.size());
+        for (size_t index = 0; index < m_results.size(); index++)
+        {
+            if (m_exceptions.at(index))
+            {
+                std::rethrow_exception(m_exceptions.at(index));
+            }
+            results.push_back(std::move(m_results.at(index).value()));
+        }
+        return results;
+    }
+
+private:
+    std::optional<size_t> TakeNextIndex()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_next_to_start == m_tasks.size())
+        {
+            return std::nullopt;
+        }
+        return m_next_to_start++;
+    }
+
+    /**
+     * @brief Releasing one reference to the group.
+     * @return true if it was the last one.
+     */
+    bool Release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return --m_pending == 0;
+    }
+
+    detail::DetachedTask Run(size_t index)
+    {
+        try
+        {
+            m_results.at(index).emplace(co_await m_tasks.at(index));
+        }
+        catch (...)
+        {
+            m_exceptions.at(index) = std::current_exception();
+        }
+        auto next_index = TakeNextIndex();
+        if (next_index.has_value())
+        {
+            Run(next_index.value());
+        }
+        if (Release())
+        {
+            m_continuation.resume(); // After the resumption, the group can be destroyed.
+        }
+    }
+
+    std::vector<Task<T>> m_tasks;
+    std::vector<std::optional<T>> m_results;
+    std::vector<std::exception_ptr> m_exceptions;
+    size_t m_max_running;
+    std::mutex m_mutex;
+    size_t m_next_to_start = 0;
+    size_t m_pending;
+    std::coroutine_handle<> m_continuation;
+};
+
+/**
+ * @brief Passing coroutines through a section strictly in the order of turns 0, 1, 2, ... regardless of the order in which they reached it.
+ *        The coroutine waits for its turn (co_await WaitTurn(turn)) and, at the end of the section, passes the turn to the next one (NextTurn()).
+ *        The next coroutine is resumed in the thread that called NextTurn().
+ * @warning Each turn must be passed, including on errors, otherwise the coroutines of the following turns will never be resumed.
+ */
+class OrderedTurns final
+{
+    class TurnAwaiter
+    {
+    public:
+        TurnAwaiter(OrderedTurns& turns, size_t turn)
+            : m_turns(turns)
+            , m_turn(turn)
+        {
+        }
+
+        [[nodiscard]] bool await_ready() const
+        {
+            std::lock_guard<std::mutex> lock(m_turns.m_mutex);
+            return m_turns.m_current == m_turn;
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            std::lock_guard<std::mutex> lock(m_turns.m_mutex);
+            if (m_turns.m_current == m_turn)
+            {
+                return false;
+            }
+            m_turns.m_waiting.emplace(m_turn, awaiting);
+            return true;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        OrderedTurns& m_turns;
+        size_t m_turn;
+    };
+
+public:
+    [[nodiscard]] TurnAwaiter WaitTurn(size_t turn)
+    {
+        return {*this, turn};
+    }
+
+    void NextTurn()
+    {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current++;
+            auto waiting = m_waiting.find(m_current);
+            if (waiting != m_waiting.end())
+            {
+                next = waiting->second;
+                m_waiting.erase(waiting);
+            }
+        }
+        if (next)
+        {
+            next.resume();
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    size_t m_current = 0;
+    std::map<size_t, std::coroutine_handle<>> m_waiting;
+};
+
+} // namespace nodesetexporter::common::coroutines
+
+#endif // NODESETEXPORTER_COMMON_COROUTINES_H
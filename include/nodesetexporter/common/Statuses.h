@@ -41,7 +41,10 @@ public:
         EndFail, // Error in completing the formation of export unloading
         BeginFail, // Error forming an unloading title
         GetNamespacesFail, // Error in obtaining nodes spaces
-        ExportNamespacesFail // Error for the formation of export unloading of nodes spaces
+        ExportNamespacesFail, // Error for the formation of export unloading of nodes spaces
+        Cancelled, // The export was stopped on request, the unloading was closed as partial
+        TypeClosureFail, // Error in collecting the type closure of the nodes
+        SelfValidationFail // The unloading violates the structural invariants of the NodeSet (the strict self-validation)
     };
 
     StatusResults(Status status) // NOLINT(google-explicit-constructor)
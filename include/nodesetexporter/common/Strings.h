@@ -29,6 +29,20 @@ namespace nodesetexporter::common
  */
 [[nodiscard]] std::string UaGuidIdentifierToStdString(const UA_NodeId& node_id);
 
+/**
+ * @brief Forming the text IndexRange (NumericRange) of the one-dimensional array: "first:last" or "first" for a single element.
+ * @param first_index Index of the first element.
+ * @param number_of_elements Number of the elements, at least 1.
+ */
+[[nodiscard]] static inline std::string IndexRangeToStdString(size_t first_index, size_t number_of_elements)
+{
+    if (number_of_elements <= 1)
+    {
+        return std::to_string(first_index);
+    }
+    return std::to_string(first_index) + ":" + std::to_string(first_index + number_of_elements - 1);
+}
+
 } // namespace nodesetexporter::common
 
 #endif // NODESETEXPORTER_COMMON_STRINGS_H
@@ -14,8 +14,15 @@
 #include "nodesetexporter/common/Strings.h"
 #include "nodesetexporter/open62541/TypeAliases.h"
 
+#include <fmt/format.h>
 #include <tinyxml2.h>
 
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <system_error>
+
 /**
  * @brief A set of functions for converting the contents of Open62541 library objects into text suitable for placement in an XML document.
  */
@@ -27,6 +34,8 @@ using nodesetexporter::open62541::UATypesContainer;
 using nodesetexporter::open62541::typealiases::VariantsOfAttr;
 using tinyxml2::XMLUtil;
 
+// Enough for the shortest representation of any double, for example "-2.2250738585072014e-308".
+constexpr static size_t float_chrs = 32;
 
 /**
  * @brief Convert UA_NodeID to text variant for XML.
@@ -150,6 +159,30 @@ static LocalizedTextXML UALocalizedTextToXMLString(const VariantsOfAttr& var)
     return result;
 }
 
+/**
+ * @brief Convert the floating point value to a string for XML (xs:double, xs:float), including NaN and the infinities.
+ *        The shortest representation that is read back into the same value, it does not depend on the locale, so the same value always gives the same text.
+ */
+template <typename TFloat>
+static std::string UAFloatingToXMLString(TFloat value)
+{
+    if (std::isnan(value))
+    {
+        return "NaN";
+    }
+    if (std::isinf(value))
+    {
+        return value > 0 ? "INF" : "-INF";
+    }
+    std::array<char, float_chrs> result{};
+    const auto [end, error] = std::to_chars(result.data(), result.data() + result.size(), value); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (error != std::errc())
+    {
+        return "";
+    }
+    return std::string(result.data(), end);
+}
+
 /**
  * @brief Convert Open62541 primitives to a string for XML output. To convert features, tinyxml2 functions are used.
  * @param var An object of type std::variant containing the types: UA_Boolean, UA_Byte, UA_UInt32, UA_Int32, UA_Double, UA_NodeClass(UA_Int32).
@@ -164,7 +197,6 @@ static std::string UAPrimitivesToXMLString(const VariantsOfAttr& var)
     constexpr static size_t byte_chrs = 4;
     constexpr static size_t uint32_chrs = 11;
     constexpr static size_t int32_chrs = 12;
-    constexpr static size_t double_chrs = 2000;
 
     if (const auto* pval = std::get_if<UA_Boolean>(&var))
     {
@@ -188,8 +220,7 @@ static std::string UAPrimitivesToXMLString(const VariantsOfAttr& var)
     }
     if (const auto* pval = std::get_if<UA_Double>(&var))
     {
-        result.resize(double_chrs);
-        XMLUtil::ToStr(*pval, result.data(), static_cast<int>(result.size()));
+        result = UAFloatingToXMLString(*pval);
     }
     if (const auto* pval = std::get_if<UA_NodeClass>(&var)) // UA_Int32
     {
@@ -200,6 +231,125 @@ static std::string UAPrimitivesToXMLString(const VariantsOfAttr& var)
     return result;
 }
 
+/**
+ * @brief Getting the name of the element of the built-in type for the value (UANodeSet.xsd Value, http://opcfoundation.org/UA/2008/02/Types.xsd).
+ * @param type The data type of the value.
+ * @return The name of the element without the prefix, for example "Double".
+ *         If the type is not supported in the export of the values, an empty string is returned.
+ */
+static std::string UABuiltinTypeToXMLElementName(const UA_DataType* type)
+{
+    if (type == nullptr)
+    {
+        return "";
+    }
+    switch (type->typeKind)
+    {
+    case UA_DATATYPEKIND_BOOLEAN:
+        return "Boolean";
+    case UA_DATATYPEKIND_SBYTE:
+        return "SByte";
+    case UA_DATATYPEKIND_BYTE:
+        return "Byte";
+    case UA_DATATYPEKIND_INT16:
+        return "Int16";
+    case UA_DATATYPEKIND_UINT16:
+        return "UInt16";
+    case UA_DATATYPEKIND_INT32:
+        return "Int32";
+    case UA_DATATYPEKIND_UINT32:
+        return "UInt32";
+    case UA_DATATYPEKIND_INT64:
+        return "Int64";
+    case UA_DATATYPEKIND_UINT64:
+        return "UInt64";
+    case UA_DATATYPEKIND_FLOAT:
+        return "Float";
+    case UA_DATATYPEKIND_DOUBLE:
+        return "Double";
+    case UA_DATATYPEKIND_STRING:
+        return "String";
+    case UA_DATATYPEKIND_DATETIME:
+        return "DateTime";
+    case UA_DATATYPEKIND_BYTESTRING:
+        return "ByteString";
+    case UA_DATATYPEKIND_NODEID:
+        return "NodeId";
+    case UA_DATATYPEKIND_QUALIFIEDNAME:
+        return "QualifiedName";
+    case UA_DATATYPEKIND_LOCALIZEDTEXT:
+        return "LocalizedText";
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief Convert UA_DateTime to a string for XML (xs:dateTime in UTC), for example "2024-01-31T12:00:00.000Z".
+ */
+static std::string UADateTimeToXMLString(UA_DateTime date_time)
+{
+    const auto dts = UA_DateTime_toStruct(date_time);
+    return fmt::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.{:03}Z", dts.year, dts.month, dts.day, dts.hour, dts.min, dts.sec, dts.milliSec);
+}
+
+/**
+ * @brief Convert the value of the built-in type that is written as the text of the element (Boolean, integers, Float, Double, String, DateTime, ByteString) to a string for XML.
+ * @param data Pointer to the value of the type.
+ * @param type The data type of the value.
+ * @return A string to place in the XML document.
+ *         If the type is not written as the text of the element, std::nullopt is returned.
+ */
+static std::optional<std::string> UABuiltinValueToXMLString(const void* data, const UA_DataType* type)
+{
+    if (data == nullptr || type == nullptr)
+    {
+        return std::nullopt;
+    }
+    switch (type->typeKind)
+    {
+    case UA_DATATYPEKIND_BOOLEAN:
+        return *static_cast<const UA_Boolean*>(data) ? "true" : "false";
+    case UA_DATATYPEKIND_SBYTE:
+        return std::to_string(*static_cast<const UA_SByte*>(data));
+    case UA_DATATYPEKIND_BYTE:
+        return std::to_string(*static_cast<const UA_Byte*>(data));
+    case UA_DATATYPEKIND_INT16:
+        return std::to_string(*static_cast<const UA_Int16*>(data));
+    case UA_DATATYPEKIND_UINT16:
+        return std::to_string(*static_cast<const UA_UInt16*>(data));
+    case UA_DATATYPEKIND_INT32:
+        return std::to_string(*static_cast<const UA_Int32*>(data));
+    case UA_DATATYPEKIND_UINT32:
+        return std::to_string(*static_cast<const UA_UInt32*>(data));
+    case UA_DATATYPEKIND_INT64:
+        return std::to_string(*static_cast<const UA_Int64*>(data));
+    case UA_DATATYPEKIND_UINT64:
+        return std::to_string(*static_cast<const UA_UInt64*>(data));
+    case UA_DATATYPEKIND_FLOAT:
+        return UAFloatingToXMLString(*static_cast<const UA_Float*>(data));
+    case UA_DATATYPEKIND_DOUBLE:
+        return UAFloatingToXMLString(*static_cast<const UA_Double*>(data));
+    case UA_DATATYPEKIND_STRING:
+        return UaStringToStdString(*static_cast<const UA_String*>(data));
+    case UA_DATATYPEKIND_DATETIME:
+        return UADateTimeToXMLString(*static_cast<const UA_DateTime*>(data));
+    case UA_DATATYPEKIND_BYTESTRING:
+    {
+        UA_String base64 = UA_STRING_NULL;
+        if (UA_ByteString_toBase64(static_cast<const UA_ByteString*>(data), &base64) != UA_STATUSCODE_GOOD)
+        {
+            return std::nullopt;
+        }
+        auto result = UaStringToStdString(base64);
+        UA_String_clear(&base64);
+        return result;
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
 } // namespace nodesetexporter::encoders::getattributetoxmltext
 
 #endif // NODESETEXPORTER_ENCODERS_GETATTRIBUTETOXMLTEXT_H
@@ -0,0 +1,302 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_ENCODERS_SPLITENCODER_H
+#define NODESETEXPORTER_ENCODERS_SPLITENCODER_H
+
+#include "nodesetexporter/interfaces/IEncoder.h"
+
+#include <open62541/nodeids.h>
+
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nodesetexporter::encoders
+{
+using nodesetexporter::interfaces::IEncoder;
+using nodesetexporter::interfaces::LoggerBase;
+using nodesetexporter::interfaces::NodeIntermediateModel;
+using nodesetexporter::interfaces::StatusResults;
+using nodesetexporter::interfaces::UATypesContainer;
+
+/**
+ * @brief The encoder that divides the unloading into two documents: the type model (ObjectType, VariableType, ReferenceType, DataType) and the instances (Object, Variable).
+ *        The nodes are routed to the two encoders by the node class, the namespaces and the aliases are written to both documents.
+ *        The Objects and Variables of the type model (the instance declarations: the children of the type nodes, the nodes with a modelling rule and their children)
+ *        are written to the document of the types, so that it is complete without the document of the instances.
+ *        At the end, each document receives the Models element: the model of the types requires the OPC UA model, the model of the instances requires also
+ *        the model of the types, so the document of the types can be loaded once and reused by many documents of the instances.
+ * @warning The encoders of the documents must live longer than the SplitEncoder.
+ */
+class SplitEncoder final : public IEncoder
+{
+public:
+    /**
+     * @param logger The logging class object.
+     * @param types_encoder The encoder of the document of the types.
+     * @param instances_encoder The encoder of the document of the instances.
+     * @param types_model_uri The URI of the model of the types. Empty - the namespace URI of the first exported type node.
+     * @param instances_model_uri The URI of the model of the instances. Empty - the namespace URI of the first exported instance node. If it is the same as
+     *                            the URI of the model of the types (the types and the instances in one namespace), the "Instances" path is added to the URI of the types.
+     */
+    SplitEncoder(LoggerBase& logger, IEncoder& types_encoder, IEncoder& instances_encoder, std::string types_model_uri = "", std::string instances_model_uri = "")
+        : IEncoder(logger, "")
+        , m_types_encoder(types_encoder)
+        , m_instances_encoder(instances_encoder)
+        , m_types_model_uri(std::move(types_model_uri))
+        , m_instances_model_uri(std::move(instances_model_uri))
+    {
+    }
+    ~SplitEncoder() override = default;
+    SplitEncoder(SplitEncoder&) = delete;
+    SplitEncoder(SplitEncoder&&) = delete;
+    SplitEncoder& operator=(const SplitEncoder& obj) = delete;
+    SplitEncoder& operator=(SplitEncoder&& obj) = delete;
+
+    StatusResults Begin() override
+    {
+        m_logger.Trace("Method called: Begin()");
+        m_namespaces.clear();
+        m_type_node_ids.clear();
+        m_types_namespace_index.reset();
+        m_instances_namespace_index.reset();
+        return Both([](IEncoder& encoder) { return encoder.Begin(); });
+    }
+
+    /**
+     * @brief Adding the Models to both documents and completing them.
+     */
+    StatusResults End() override
+    {
+        m_logger.Trace("Method called: End()");
+        const auto types_model_uri = GetModelUri(m_types_model_uri, m_types_namespace_index);
+        auto instances_model_uri = GetModelUri(m_instances_model_uri, m_instances_namespace_index);
+        if (m_instances_model_uri.empty() && !types_model_uri.empty() && instances_model_uri == types_model_uri)
+        {
+            instances_model_uri = types_model_uri + (types_model_uri.ends_with('/') ? "Instances/" : "/Instances");
+            m_logger.Info("SplitEncoder::End(). The types and the instances are in one namespace, the model URI of the instances is '{}'.", instances_model_uri);
+        }
+
+        std::vector<ModelTableEntry> types_models;
+        if (!types_model_uri.empty())
+        {
+            types_models.push_back({types_model_uri, {ua_model_uri}});
+        }
+        std::vector<ModelTableEntry> instances_models;
+        if (!instances_model_uri.empty())
+        {
+            instances_models.push_back({instances_model_uri, {ua_model_uri}});
+            if (!types_model_uri.empty() && types_model_uri != instances_model_uri)
+            {
+                instances_models.back().required_model_uris.push_back(types_model_uri);
+            }
+            else if (!types_model_uri.empty())
+            {
+                m_logger.Warning(
+                    "SplitEncoder::End(). The types and the instances have the same model URI '{}', the instances can't require the types. Set the model URI of the instances.",
+                    types_model_uri);
+            }
+        }
+
+        if ((!types_models.empty() && m_types_encoder.AddModels(types_models) == StatusResults::Fail)
+            || (!instances_models.empty() && m_instances_encoder.AddModels(instances_models) == StatusResults::Fail))
+        {
+            return StatusResults::Fail;
+        }
+        return Both([](IEncoder& encoder) { return encoder.End(); });
+    }
+
+    /**
+     * @brief The namespace table is shared by both documents, so the indexes of the NodeIDs are the same in them.
+     */
+    StatusResults AddNamespaces(const std::vector<std::string>& namespaces) override
+    {
+        m_logger.Trace("Method called: AddNamespaces()");
+        m_namespaces = namespaces;
+        return Both([&namespaces](IEncoder& encoder) { return encoder.AddNamespaces(namespaces); });
+    }
+
+    /**
+     * @brief The alias set is shared by both documents.
+     */
+    [[nodiscard]] StatusResults AddAliases(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases) override
+    {
+        m_logger.Trace("Method called: AddAliases()");
+        return Both([&aliases](IEncoder& encoder) { return encoder.AddAliases(aliases); });
+    }
+
+    [[nodiscard]] StatusResults MarkAsPartial() override
+    {
+        m_logger.Trace("Method called: MarkAsPartial()");
+        return Both([](IEncoder& encoder) { return encoder.MarkAsPartial(); });
+    }
+
+    [[nodiscard]] std::optional<std::set<UA_AttributeId>> GetConsumedAttributes(UA_NodeClass node_class) const override
+    {
+        m_logger.Trace("Method called: GetConsumedAttributes()");
+        return IsTypeNodeClass(node_class) ? m_types_encoder.GetConsumedAttributes(node_class) : m_instances_encoder.GetConsumedAttributes(node_class);
+    }
+
+    /**
+     * @brief The instance declaration is written to the document of the types, the other Objects to the document of the instances.
+     */
+    [[nodiscard]] StatusResults AddNodeObject(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeObject()");
+        if (IsInstanceDeclaration(node_model))
+        {
+            RememberTypeNode(node_model);
+            return m_types_encoder.AddNodeObject(node_model);
+        }
+        RememberNamespace(node_model, m_instances_namespace_index);
+        return m_instances_encoder.AddNodeObject(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeObjectType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeObjectType()");
+        RememberTypeNode(node_model);
+        return m_types_encoder.AddNodeObjectType(node_model);
+    }
+
+    /**
+     * @brief The instance declaration is written to the document of the types, the other Variables to the document of the instances.
+     */
+    [[nodiscard]] StatusResults AddNodeVariable(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeVariable()");
+        if (IsInstanceDeclaration(node_model))
+        {
+            RememberTypeNode(node_model);
+            return m_types_encoder.AddNodeVariable(node_model);
+        }
+        RememberNamespace(node_model, m_instances_namespace_index);
+        return m_instances_encoder.AddNodeVariable(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeVariableType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeVariableType()");
+        RememberTypeNode(node_model);
+        return m_types_encoder.AddNodeVariableType(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeReferenceType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeReferenceType()");
+        RememberTypeNode(node_model);
+        return m_types_encoder.AddNodeReferenceType(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeDataType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeDataType()");
+        RememberTypeNode(node_model);
+        return m_types_encoder.AddNodeDataType(node_model);
+    }
+
+private:
+    /**
+     * @brief Calling the method of both encoders. The second encoder is not called if the first one failed.
+     */
+    template <typename TFunc>
+    [[nodiscard]] StatusResults Both(TFunc&& func)
+    {
+        if (func(m_types_encoder) == StatusResults::Fail)
+        {
+            return StatusResults::Fail;
+        }
+        return func(m_instances_encoder);
+    }
+
+    [[nodiscard]] static bool IsTypeNodeClass(UA_NodeClass node_class)
+    {
+        return node_class == UA_NODECLASS_OBJECTTYPE || node_class == UA_NODECLASS_VARIABLETYPE || node_class == UA_NODECLASS_REFERENCETYPE || node_class == UA_NODECLASS_DATATYPE;
+    }
+
+    /**
+     * @brief Checking whether the Object or Variable belongs to the type model: it has a modelling rule, its parent is a type node
+     *        (by the class of the target of the inverse reference to the parent) or its parent is already written to the document of the types.
+     *        The nodes of the type closure are exported before their types, so the class of the parent is checked by the references.
+     */
+    [[nodiscard]] bool IsInstanceDeclaration(const NodeIntermediateModel& node_model) const
+    {
+        const auto& parent_node_id = node_model.GetParentNodeId().GetRef().nodeId;
+        if (m_type_node_ids.contains(UATypesContainer<UA_NodeId>(parent_node_id, UA_TYPES_NODEID)))
+        {
+            return true;
+        }
+        for (const auto& reference : node_model.GetNodeReferences())
+        {
+            const auto& ua_reference = reference.GetRef();
+            if (ua_reference.isForward && ua_reference.referenceTypeId.namespaceIndex == 0 && ua_reference.referenceTypeId.identifierType == UA_NODEIDTYPE_NUMERIC
+                && ua_reference.referenceTypeId.identifier.numeric == UA_NS0ID_HASMODELLINGRULE) // NOLINT(cppcoreguidelines-pro-type-union-access)
+            {
+                return true;
+            }
+            if (!ua_reference.isForward && IsTypeNodeClass(ua_reference.nodeClass) && UA_NodeId_equal(&ua_reference.nodeId.nodeId, &parent_node_id))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Remembering the node written to the document of the types, so that its children are also written there.
+     */
+    void RememberTypeNode(const NodeIntermediateModel& node_model)
+    {
+        RememberNamespace(node_model, m_types_namespace_index);
+        m_type_node_ids.emplace(node_model.GetExpNodeId().GetRef().nodeId, UA_TYPES_NODEID);
+    }
+
+    static void RememberNamespace(const NodeIntermediateModel& node_model, std::optional<UA_UInt16>& namespace_index)
+    {
+        // The nodes of the OPC UA namespace (custom ns=0 nodes) do not define the model of the document.
+        if (!namespace_index.has_value() && node_model.GetExpNodeId().GetRef().nodeId.namespaceIndex != 0)
+        {
+            namespace_index = node_model.GetExpNodeId().GetRef().nodeId.namespaceIndex;
+        }
+    }
+
+    /**
+     * @brief The URI of the model: set explicitly or the URI of the namespace of the first node of the document. Empty if the document has no nodes.
+     */
+    [[nodiscard]] std::string GetModelUri(const std::string& model_uri, const std::optional<UA_UInt16>& namespace_index) const
+    {
+        if (!model_uri.empty())
+        {
+            return model_uri;
+        }
+        // The namespaces of the unloading start from ns=1, the OPC UA namespace is not included.
+        if (!namespace_index.has_value() || namespace_index.value() == 0 || namespace_index.value() > m_namespaces.size())
+        {
+            return "";
+        }
+        return m_namespaces.at(namespace_index.value() - 1);
+    }
+
+    static constexpr auto ua_model_uri = "http://opcfoundation.org/UA/";
+
+    IEncoder& m_types_encoder;
+    IEncoder& m_instances_encoder;
+    std::string m_types_model_uri;
+    std::string m_instances_model_uri;
+    std::vector<std::string> m_namespaces;
+    std::set<UATypesContainer<UA_NodeId>> m_type_node_ids; // The nodes of the document of the types
+    std::optional<UA_UInt16> m_types_namespace_index;
+    std::optional<UA_UInt16> m_instances_namespace_index;
+};
+
+} // namespace nodesetexporter::encoders
+
+#endif // NODESETEXPORTER_ENCODERS_SPLITENCODER_H
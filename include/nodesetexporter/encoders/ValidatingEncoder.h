@@ -0,0 +1,345 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_ENCODERS_VALIDATINGENCODER_H
+#define NODESETEXPORTER_ENCODERS_VALIDATINGENCODER_H
+
+#include "nodesetexporter/interfaces/IEncoder.h"
+
+#include <open62541/types.h>
+
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nodesetexporter::encoders
+{
+using nodesetexporter::interfaces::IEncoder;
+using nodesetexporter::interfaces::LoggerBase;
+using nodesetexporter::interfaces::NodeIntermediateModel;
+using nodesetexporter::interfaces::StatusResults;
+using nodesetexporter::interfaces::UATypesContainer;
+
+/**
+ * @brief The encoder that checks the structural invariants of the NodeSet on the stream of the nodes passed to the wrapped encoder, in a single pass without parsing the result:
+ *        - the NodeIds are unique and not empty;
+ *        - the namespace indexes of the NodeIds, the BrowseNames, the ParentNodeIds and the reference targets are in the range of the exported namespaces;
+ *        - each reference target is exported or belongs to the OPC UA namespace (ns=0) or to another server;
+ *        - each alias used by the references and the DataType attributes is defined in the Aliases;
+ *        - ParentNodeId has the inverse hierarchical reference (HasComponent, HasProperty, HasOrderedComponent, Organizes, HasNotifier, HasEventSource) to it.
+ *        The reference targets and the aliases can be exported after the nodes that use them, so these checks are completed in End().
+ *        The violations are logged as warnings and are available in GetViolations(), the result of the wrapped encoder is not changed.
+ * @warning The wrapped encoder must live longer than the ValidatingEncoder.
+ */
+class ValidatingEncoder final : public IEncoder
+{
+public:
+    struct Violation
+    {
+        std::string node_id;
+        std::string description;
+    };
+
+    /**
+     * @param logger The logging class object.
+     * @param encoder The encoder that receives the nodes.
+     */
+    ValidatingEncoder(LoggerBase& logger, IEncoder& encoder)
+        : IEncoder(logger, "")
+        , m_encoder(encoder)
+    {
+    }
+    ~ValidatingEncoder() override = default;
+    ValidatingEncoder(ValidatingEncoder&) = delete;
+    ValidatingEncoder(ValidatingEncoder&&) = delete;
+    ValidatingEncoder& operator=(const ValidatingEncoder& obj) = delete;
+    ValidatingEncoder& operator=(ValidatingEncoder&& obj) = delete;
+
+    StatusResults Begin() override
+    {
+        m_logger.Trace("Method called: Begin()");
+        m_number_of_namespaces.reset();
+        m_alias_names.clear();
+        m_node_ids.clear();
+        m_missing_targets.clear();
+        m_used_aliases.clear();
+        m_violations.clear();
+        m_number_of_violations = 0;
+        m_is_partial = false;
+        return m_encoder.Begin();
+    }
+
+    /**
+     * @brief Completing the checks that depend on the whole stream of the nodes and completing the wrapped encoder.
+     */
+    StatusResults End() override
+    {
+        m_logger.Trace("Method called: End()");
+        // The partial unloading does not contain all the requested nodes, the missing targets are expected.
+        if (!m_is_partial)
+        {
+            for (const auto& [target, source] : m_missing_targets)
+            {
+                AddViolation(source, "The reference target " + target.ToString() + " is not exported and is not in the OPC UA namespace.");
+            }
+        }
+        for (const auto& [alias, node_id] : m_used_aliases)
+        {
+            if (!m_alias_names.contains(alias) && !IsNodeIdText(alias))
+            {
+                AddViolation(node_id, "The alias '" + alias + "' is not defined in the Aliases.");
+            }
+        }
+
+        if (m_number_of_violations == 0)
+        {
+            m_logger.Info("Self-validation: no violations in {} nodes.", m_node_ids.size());
+        }
+        else
+        {
+            m_logger.Warning("Self-validation: {} violations in {} nodes.", m_number_of_violations, m_node_ids.size());
+        }
+        return m_encoder.End();
+    }
+
+    StatusResults AddNamespaces(const std::vector<std::string>& namespaces) override
+    {
+        m_logger.Trace("Method called: AddNamespaces()");
+        m_number_of_namespaces = namespaces.size();
+        return m_encoder.AddNamespaces(namespaces);
+    }
+
+    [[nodiscard]] StatusResults AddAliases(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases) override
+    {
+        m_logger.Trace("Method called: AddAliases()");
+        for (const auto& alias : aliases)
+        {
+            m_alias_names.insert(alias.first);
+        }
+        return m_encoder.AddAliases(aliases);
+    }
+
+    [[nodiscard]] StatusResults AddModels(const std::vector<ModelTableEntry>& models) override
+    {
+        m_logger.Trace("Method called: AddModels()");
+        return m_encoder.AddModels(models);
+    }
+
+    [[nodiscard]] StatusResults MarkAsPartial() override
+    {
+        m_logger.Trace("Method called: MarkAsPartial()");
+        m_is_partial = true;
+        return m_encoder.MarkAsPartial();
+    }
+
+    [[nodiscard]] std::optional<std::set<UA_AttributeId>> GetConsumedAttributes(UA_NodeClass node_class) const override
+    {
+        return m_encoder.GetConsumedAttributes(node_class);
+    }
+
+    [[nodiscard]] StatusResults AddNodeObject(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeObject()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeObject(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeObjectType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeObjectType()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeObjectType(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeVariable(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeVariable()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeVariable(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeVariableType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeVariableType()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeVariableType(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeReferenceType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeReferenceType()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeReferenceType(node_model);
+    }
+
+    [[nodiscard]] StatusResults AddNodeDataType(const NodeIntermediateModel& node_model) override
+    {
+        m_logger.Trace("Method called: AddNodeDataType()");
+        CheckNode(node_model);
+        return m_encoder.AddNodeDataType(node_model);
+    }
+
+    /**
+     * @brief The violations found since the last Begin(). No more than max_stored_violations are stored, see GetNumberOfViolations().
+     */
+    [[nodiscard]] const std::vector<Violation>& GetViolations() const noexcept
+    {
+        return m_violations;
+    }
+
+    /**
+     * @brief The number of all the violations found since the last Begin().
+     */
+    [[nodiscard]] size_t GetNumberOfViolations() const noexcept
+    {
+        return m_number_of_violations;
+    }
+
+    static constexpr size_t max_stored_violations = 1000;
+
+private:
+    void CheckNode(const NodeIntermediateModel& node_model)
+    {
+        const auto& node_id = node_model.GetExpNodeId();
+        const auto node_id_text = node_id.ToString();
+        if (UA_NodeId_isNull(&node_id.GetRef().nodeId))
+        {
+            AddViolation(node_id_text, "The NodeId is empty.");
+            return;
+        }
+        const UATypesContainer<UA_NodeId> local_node_id(node_id.GetRef().nodeId, UA_TYPES_NODEID);
+        if (!m_node_ids.insert(local_node_id).second)
+        {
+            AddViolation(node_id_text, "The NodeId is not unique.");
+        }
+        m_missing_targets.erase(local_node_id);
+        CheckNamespaceIndex(node_id_text, node_id.GetRef().nodeId.namespaceIndex, "NodeId");
+
+        const auto browse_name = node_model.GetAttributes().find(UA_ATTRIBUTEID_BROWSENAME);
+        if (browse_name != node_model.GetAttributes().end() && browse_name->second.has_value())
+        {
+            if (const auto* const qualified_name = std::get_if<UATypesContainer<UA_QualifiedName>>(&browse_name->second.value()))
+            {
+                CheckNamespaceIndex(node_id_text, qualified_name->GetRef().namespaceIndex, "BrowseName");
+            }
+        }
+
+        const auto data_type = node_model.GetAttributes().find(UA_ATTRIBUTEID_DATATYPE);
+        if ((node_model.GetNodeClass() == UA_NODECLASS_VARIABLE || node_model.GetNodeClass() == UA_NODECLASS_VARIABLETYPE) && data_type != node_model.GetAttributes().end()
+            && data_type->second.has_value())
+        {
+            if (const auto* const data_type_id = std::get_if<UATypesContainer<UA_NodeId>>(&data_type->second.value()))
+            {
+                m_used_aliases.try_emplace(NodeIntermediateModel::GetDataTypeAlias(data_type_id->GetRef()), node_id_text);
+            }
+        }
+
+        const auto& parent_node_id = node_model.GetParentNodeId().GetRef().nodeId;
+        bool is_parent_referenced = UA_NodeId_isNull(&parent_node_id);
+        for (const auto& [reference, reference_type_alias] : node_model.GetNodeReferenceTypeAliases())
+        {
+            m_used_aliases.try_emplace(reference_type_alias, node_id_text);
+            const auto& target = reference.GetRef().nodeId;
+            if (target.serverIndex != 0 || target.namespaceUri.length > 0)
+            {
+                continue; // The node of another server or namespace table.
+            }
+            CheckNamespaceIndex(node_id_text, target.nodeId.namespaceIndex, "Reference target");
+            if (!is_parent_referenced && !reference.GetRef().isForward && UA_NodeId_equal(&target.nodeId, &parent_node_id) && IsHierarchicalReferenceType(reference.GetRef().referenceTypeId))
+            {
+                is_parent_referenced = true;
+            }
+            if (target.nodeId.namespaceIndex != 0)
+            {
+                UATypesContainer<UA_NodeId> target_node_id(target.nodeId, UA_TYPES_NODEID);
+                if (!m_node_ids.contains(target_node_id))
+                {
+                    m_missing_targets.try_emplace(std::move(target_node_id), node_id_text);
+                }
+            }
+        }
+
+        if (!UA_NodeId_isNull(&parent_node_id))
+        {
+            CheckNamespaceIndex(node_id_text, parent_node_id.namespaceIndex, "ParentNodeId");
+            if (!is_parent_referenced)
+            {
+                AddViolation(node_id_text, "The ParentNodeId " + node_model.GetParentNodeId().ToString() + " has no inverse hierarchical reference from the node.");
+            }
+        }
+    }
+
+    void CheckNamespaceIndex(const std::string& node_id_text, UA_UInt16 namespace_index, const char* what)
+    {
+        // The namespaces of the unloading start from ns=1, the OPC UA namespace is not included.
+        if (m_number_of_namespaces.has_value() && namespace_index > m_number_of_namespaces.value())
+        {
+            AddViolation(node_id_text, std::string(what) + " namespace index " + std::to_string(namespace_index) + " is out of the range of the NamespaceUris.");
+        }
+    }
+
+    void AddViolation(const std::string& node_id_text, std::string&& description)
+    {
+        ++m_number_of_violations;
+        if (m_violations.size() < max_stored_violations)
+        {
+            m_logger.Warning("Self-validation. NodeId: {}: {}", node_id_text, description);
+            m_violations.push_back({node_id_text, std::move(description)});
+        }
+    }
+
+    [[nodiscard]] static bool IsHierarchicalReferenceType(const UA_NodeId& reference_type_id)
+    {
+        if (reference_type_id.namespaceIndex != 0 || reference_type_id.identifierType != UA_NODEIDTYPE_NUMERIC)
+        {
+            return false;
+        }
+        switch (reference_type_id.identifier.numeric) // NOLINT(cppcoreguidelines-pro-type-union-access)
+        {
+        case UA_NS0ID_ORGANIZES:
+        case UA_NS0ID_HASEVENTSOURCE:
+        case UA_NS0ID_HASNOTIFIER:
+        case UA_NS0ID_HASCOMPONENT:
+        case UA_NS0ID_HASPROPERTY:
+        case UA_NS0ID_HASORDEREDCOMPONENT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // The encoder writes the NodeId in the text form instead of the alias for the types without the alias.
+    [[nodiscard]] static bool IsNodeIdText(const std::string& text)
+    {
+        UA_NodeId node_id;
+        UA_NodeId_init(&node_id);
+        const auto status = UA_NodeId_parse(&node_id, UA_STRING(const_cast<char*>(text.c_str()))); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        UA_NodeId_clear(&node_id);
+        return status == UA_STATUSCODE_GOOD;
+    }
+
+    IEncoder& m_encoder;
+    std::optional<size_t> m_number_of_namespaces;
+    std::set<std::string> m_alias_names;
+    std::unordered_set<UATypesContainer<UA_NodeId>> m_node_ids;
+    // The reference targets that were not exported yet, with the first node that references them.
+    std::unordered_map<UATypesContainer<UA_NodeId>, std::string> m_missing_targets;
+    // The aliases used by the nodes, with the first node that uses them.
+    std::map<std::string, std::string> m_used_aliases;
+    std::vector<Violation> m_violations;
+    size_t m_number_of_violations = 0;
+    bool m_is_partial = false;
+};
+
+} // namespace nodesetexporter::encoders
+
+#endif // NODESETEXPORTER_ENCODERS_VALIDATINGENCODER_H
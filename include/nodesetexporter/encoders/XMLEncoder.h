@@ -11,18 +11,29 @@
 #ifndef NODESETEXPORTER_ENCODERS_XMLENCODER_H
 #define NODESETEXPORTER_ENCODERS_XMLENCODER_H
 
+#include "nodesetexporter/common/ContentHash.h"
 #include "nodesetexporter/common/Strings.h"
 #include "nodesetexporter/encoders/GetAttributeToXMLText.h"
 #include "nodesetexporter/interfaces/IEncoder.h"
 
 #include <tinyxml2.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <tuple>
 #include <variant>
 
 namespace nodesetexporter::encoders
 {
 namespace ua_to_text = getattributetoxmltext;
 using LogLevel = nodesetexporter::common::LogLevel;
+using nodesetexporter::common::ContentHash;
 using nodesetexporter::common::UaStringToStdString;
 using nodesetexporter::interfaces::IEncoder;
 using nodesetexporter::interfaces::LoggerBase;
@@ -33,7 +44,6 @@ using nodesetexporter::open62541::VariantsOfAttr;
 using nodesetexporter::open62541::typealiases::UAVariantToStdVariant;
 using tinyxml2::XMLDocument;
 using tinyxml2::XMLElement;
-using tinyxml2::XMLError;
 using tinyxml2::XMLPrinter;
 using tinyxml2::XMLUtil;
 
@@ -68,41 +78,52 @@ private:
          * @brief Method for checking the default value of a particular attribute.
          * @param var The object being tested, stored in the std::variant container
          * @param attr Attribute associated with the check object
-         * @warning If the attribute is of an incorrect type, a std::bad_variant_access exception may occur.
          * @return True - the value stored in the attr attribute var is the default value.
          *         False - if the value is not the default or the attribute being checked is missing.
+         *         std::nullopt - if the value has an incorrect type for the attribute.
          */
-        static bool IsDefault(const VariantsOfAttr& var, UA_AttributeId attr)
+        static std::optional<bool> IsDefault(const VariantsOfAttr& var, UA_AttributeId attr)
         {
             switch (attr)
             {
             case UA_AttributeId::UA_ATTRIBUTEID_WRITEMASK:
-                return std::get<UA_UInt32>(var) == write_mask;
+                return IsEqual<UA_UInt32>(var, write_mask);
             case UA_AttributeId::UA_ATTRIBUTEID_USERWRITEMASK:
-                return std::get<UA_UInt32>(var) == user_write_mask;
+                return IsEqual<UA_UInt32>(var, user_write_mask);
             case UA_AttributeId::UA_ATTRIBUTEID_EVENTNOTIFIER:
-                return std::get<UA_Byte>(var) == event_notifier;
+                return IsEqual<UA_Byte>(var, event_notifier);
             case UA_AttributeId::UA_ATTRIBUTEID_DATATYPE:
             {
-                auto pval = std::get<UATypesContainer<UA_NodeId>>(var);
-                return UA_NodeId_equal(&pval.GetRef(), &data_type);
+                const auto* const pval = std::get_if<UATypesContainer<UA_NodeId>>(&var);
+                if (pval == nullptr)
+                {
+                    return std::nullopt;
+                }
+                return UA_NodeId_equal(&pval->GetRef(), &data_type);
             }
             case UA_AttributeId::UA_ATTRIBUTEID_VALUERANK:
-                return std::get<UA_Int32>(var) == value_rank;
+                return IsEqual<UA_Int32>(var, value_rank);
             case UA_AttributeId::UA_ATTRIBUTEID_ACCESSLEVEL:
-                return std::get<UA_Byte>(var) == access_level;
+                return IsEqual<UA_Byte>(var, access_level);
             case UA_AttributeId::UA_ATTRIBUTEID_USERACCESSLEVEL:
-                return std::get<UA_Byte>(var) == user_access_level;
+                return IsEqual<UA_Byte>(var, user_access_level);
             case UA_AttributeId::UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL:
-                return std::get<UA_Double>(var) == minimum_sampling_interval;
+                return IsEqual<UA_Double>(var, minimum_sampling_interval);
             case UA_AttributeId::UA_ATTRIBUTEID_HISTORIZING:
-                return std::get<UA_Boolean>(var) == historizing;
+                return IsEqual<UA_Boolean>(var, historizing);
             case UA_AttributeId::UA_ATTRIBUTEID_ARRAYDIMENSIONS:
-                return std::get<std::vector<UA_UInt32>>(var).size() == array_dimension;
+            {
+                const auto* const pval = std::get_if<std::vector<UA_UInt32>>(&var);
+                if (pval == nullptr)
+                {
+                    return std::nullopt;
+                }
+                return pval->size() == array_dimension;
+            }
             case UA_AttributeId::UA_ATTRIBUTEID_SYMMETRIC:
-                return std::get<UA_Boolean>(var) == symmetric;
+                return IsEqual<UA_Boolean>(var, symmetric);
             case UA_AttributeId::UA_ATTRIBUTEID_ISABSTRACT:
-                return std::get<UA_Boolean>(var) == is_abstract;
+                return IsEqual<UA_Boolean>(var, is_abstract);
             default:
                 break;
             }
@@ -110,6 +131,21 @@ private:
         }
 
     private:
+        /**
+         * @brief Comparison of the value with the default value without the exception on the incorrect type.
+         * @return std::nullopt if the value is not of the type T.
+         */
+        template <typename T>
+        static std::optional<bool> IsEqual(const VariantsOfAttr& var, const T& default_value)
+        {
+            const auto* const pval = std::get_if<T>(&var);
+            if (pval == nullptr)
+            {
+                return std::nullopt;
+            }
+            return *pval == default_value;
+        }
+
         static constexpr UA_UInt32 write_mask = 0;
         static constexpr UA_UInt32 user_write_mask = 0;
         static constexpr UA_Byte event_notifier = 0;
@@ -140,6 +176,47 @@ public:
     XMLEncoder& operator=(const XMLEncoder& obj) = delete;
     XMLEncoder& operator=(XMLEncoder&& obj) = delete;
 
+    /**
+     * @brief Enabling the canonical output: the same set of nodes always gives the same document regardless of the order of receiving the nodes from the server.
+     *        The nodes are sorted by NodeId, the references of each node by the reference type, the direction and the target.
+     *        The aliases are always sorted by name and the numbers are always written in the shortest round-trip form.
+     *        The content hash of the document is calculated during the output, see GetContentHash().
+     * @warning The method is called before Begin().
+     */
+    void SetCanonicalOutput(bool is_enable) noexcept
+    {
+        m_is_canonical = is_enable;
+    }
+
+    /**
+     * @brief Skipping the rewrite of the file if its content has not changed. Works only with the canonical output to the file.
+     *        The content hash of the document is stored next to the file (the file name with the ".hash" suffix). The document is first printed only
+     *        to the hash, nothing is written to the disk. Only if the hash differs from the stored one or the file does not exist, the document is written
+     *        to the temporary file (the ".tmp" suffix) that replaces the file. The values read in parts are read in both passes.
+     * @warning The method is called before Begin().
+     */
+    void SetSkipUnchangedWrite(bool is_enable) noexcept
+    {
+        m_is_skip_unchanged_write = is_enable;
+    }
+
+    /**
+     * @brief The content hash (XXH64) of the last document completed by End() in the canonical output mode.
+     * @return The hash or std::nullopt if the canonical output is disabled or the document has not been completed yet.
+     */
+    [[nodiscard]] std::optional<uint64_t> GetContentHash() const noexcept
+    {
+        return m_content_hash;
+    }
+
+    /**
+     * @brief Checking whether the last End() skipped the rewrite of the unchanged file.
+     */
+    [[nodiscard]] bool IsWriteSkipped() const noexcept
+    {
+        return m_is_write_skipped;
+    }
+
     /**
      * @brief Method to initialize the XML tree assembly UANODESET. Adds a UANodeSet root node with static defining nodes that relate only to the underlying information model.
      * @warning Any initial unloading construct must begin with a global declaration - UANodeSet.
@@ -178,8 +255,7 @@ public:
             return StatusResults::Fail;
         }
 
-        element->InsertNewComment("Value elements are currently not supported in Variable and VariableType nodes.");
-        element->InsertNewComment("Definition elements are currently not supported in UADataType.");
+        element->InsertNewComment("Value elements are supported only for the built-in types: scalars and one-dimensional arrays.");
 
         m_xml_ua_nodeset = element;
         m_begin_first = true;
@@ -199,22 +275,30 @@ public:
             return StatusResults::Fail;
         }
 
-        if (m_out_buffer.has_value())
+        m_content_hash.reset();
+        m_is_write_skipped = false;
+        if (m_is_canonical)
         {
-            XMLPrinter printer;
-            m_xml_tree.Print(&printer);
-            m_out_buffer.value().get() << std::string(printer.CStr(), printer.CStrSize());
+            Canonicalize();
         }
-        else
+
+        if (m_out_buffer.has_value())
         {
-            auto save_result = m_xml_tree.SaveFile(m_filename.c_str());
-            if (save_result != XMLError::XML_SUCCESS)
+            HashingXMLPrinter printer(*this);
+            m_xml_tree.Print(&printer);
+            if (!printer.IsValuesComplete())
             {
-                const auto* error_name = XMLDocument::ErrorIDToName(save_result);
-                const auto* error_descr = m_xml_tree.ErrorStr();
-                m_logger.Error("XMLEncoder::End(). Save to file error. {}: {}", error_name, error_descr);
                 return StatusResults::Fail;
             }
+            m_out_buffer.value().get() << std::string(printer.CStr(), printer.CStrSize());
+            if (m_is_canonical)
+            {
+                m_content_hash = printer.GetHash().Digest();
+            }
+        }
+        else if (!SaveToFile())
+        {
+            return StatusResults::Fail;
         }
 
         m_begin_first = false;
@@ -312,7 +396,11 @@ public:
             xml_alias->SetAttribute("Alias", alias.first.c_str());
         }
 
-        if (m_xml_ua_namespace_uris != nullptr)
+        if (m_xml_ua_models != nullptr)
+        {
+            m_xml_ua_nodeset->InsertAfterChild(m_xml_ua_models, xml_alieses);
+        }
+        else if (m_xml_ua_namespace_uris != nullptr)
         {
             m_xml_ua_nodeset->InsertAfterChild(m_xml_ua_namespace_uris, xml_alieses);
         }
@@ -324,6 +412,138 @@ public:
         return StatusResults::Good;
     }
 
+    /**
+     * @brief Method for adding a Models node to the XML tree. The node is placed after NamespaceUris and before Aliases regardless of the order of the calls.
+     * @warning The method is called only once before the tree is built (before End() is called).
+     * @param models The models defined by the unloading with the URIs of the required models.
+     * @return Function execution status.
+     */
+    [[nodiscard]] StatusResults AddModels(const std::vector<ModelTableEntry>& models) override
+    {
+        m_logger.Trace("Method called: AddModels()");
+        if (m_xml_ua_models != nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddModels(). The method has been called before. Call End() to zero out the execution of the method.");
+            return StatusResults::Fail;
+        }
+
+        if (!BasicCheck("AddModels()"))
+        {
+            return StatusResults::Fail;
+        }
+
+        auto* const xml_models = m_xml_tree.NewElement("Models");
+        if (xml_models == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddModels(). Error setting Models.");
+            return StatusResults::Fail;
+        }
+        for (const auto& model : models)
+        {
+            auto* const xml_model = xml_models->InsertNewChildElement("Model");
+            if (xml_model == nullptr)
+            {
+                m_logger.Error("XMLEncoder::AddModels(). Model: {} insert error.", model.model_uri);
+                return StatusResults::Fail;
+            }
+            xml_model->SetAttribute("ModelUri", model.model_uri.c_str());
+            for (const auto& required_model_uri : model.required_model_uris)
+            {
+                auto* const xml_required_model = xml_model->InsertNewChildElement("RequiredModel");
+                if (xml_required_model == nullptr)
+                {
+                    m_logger.Error("XMLEncoder::AddModels(). RequiredModel: {} insert error.", required_model_uri);
+                    return StatusResults::Fail;
+                }
+                xml_required_model->SetAttribute("ModelUri", required_model_uri.c_str());
+            }
+        }
+
+        if (m_xml_ua_namespace_uris != nullptr)
+        {
+            m_xml_ua_nodeset->InsertAfterChild(m_xml_ua_namespace_uris, xml_models);
+        }
+        else
+        {
+            m_xml_ua_nodeset->InsertFirstChild(xml_models);
+        }
+        m_xml_ua_models = xml_models;
+        return StatusResults::Good;
+    }
+
+    /**
+     * @brief Method for marking the XML tree as a partial unloading.
+     *        The mark is an XML comment placed at the top of UANodeSet, so the document still passes the UANodeSet.xsd schema.
+     * @warning The method is called only once before the tree is built (before End() is called).
+     * @return Function execution status.
+     */
+    [[nodiscard]] StatusResults MarkAsPartial() override
+    {
+        m_logger.Trace("Method called: MarkAsPartial()");
+        if (m_is_partial)
+        {
+            m_logger.Error("XMLEncoder::MarkAsPartial(). The method has been called before. Call End() to zero out the execution of the method.");
+            return StatusResults::Fail;
+        }
+
+        if (!BasicCheck("MarkAsPartial()"))
+        {
+            return StatusResults::Fail;
+        }
+
+        auto* const xml_comment = m_xml_tree.NewComment(m_partial_export_comment);
+        if (xml_comment == nullptr || m_xml_ua_nodeset->InsertFirstChild(xml_comment) == nullptr)
+        {
+            m_logger.Error("XMLEncoder::MarkAsPartial(). Comment insert error.");
+            return StatusResults::Fail;
+        }
+        m_is_partial = true;
+        return StatusResults::Good;
+    }
+
+    /**
+     * @brief The attributes of the node class that are written to the XML.
+     * @param node_class The class of the node.
+     * @return The set of the consumed attributes or std::nullopt for the unsupported node class.
+     */
+    [[nodiscard]] std::optional<std::set<UA_AttributeId>> GetConsumedAttributes(UA_NodeClass node_class) const override
+    {
+        m_logger.Trace("Method called: GetConsumedAttributes()");
+        std::set<UA_AttributeId> attrs{UA_ATTRIBUTEID_BROWSENAME, UA_ATTRIBUTEID_DISPLAYNAME, UA_ATTRIBUTEID_DESCRIPTION, UA_ATTRIBUTEID_WRITEMASK, UA_ATTRIBUTEID_USERWRITEMASK};
+        switch (node_class)
+        {
+        case UA_NODECLASS_OBJECT:
+            attrs.insert(UA_ATTRIBUTEID_EVENTNOTIFIER);
+            break;
+        case UA_NODECLASS_OBJECTTYPE:
+            attrs.insert(UA_ATTRIBUTEID_ISABSTRACT);
+            break;
+        case UA_NODECLASS_VARIABLE:
+            attrs.insert(
+                {UA_ATTRIBUTEID_DATATYPE,
+                 UA_ATTRIBUTEID_VALUERANK,
+                 UA_ATTRIBUTEID_ARRAYDIMENSIONS,
+                 UA_ATTRIBUTEID_VALUE,
+                 UA_ATTRIBUTEID_ACCESSLEVEL,
+                 UA_ATTRIBUTEID_USERACCESSLEVEL,
+                 UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
+                 UA_ATTRIBUTEID_HISTORIZING});
+            break;
+        case UA_NODECLASS_VARIABLETYPE:
+            attrs.insert({UA_ATTRIBUTEID_ISABSTRACT, UA_ATTRIBUTEID_DATATYPE, UA_ATTRIBUTEID_VALUERANK, UA_ATTRIBUTEID_ARRAYDIMENSIONS, UA_ATTRIBUTEID_VALUE});
+            break;
+        case UA_NODECLASS_REFERENCETYPE:
+            attrs.insert({UA_ATTRIBUTEID_ISABSTRACT, UA_ATTRIBUTEID_SYMMETRIC, UA_ATTRIBUTEID_INVERSENAME});
+            break;
+        case UA_NODECLASS_DATATYPE:
+            attrs.insert({UA_ATTRIBUTEID_ISABSTRACT, UA_ATTRIBUTEID_DATATYPEDEFINITION});
+            break;
+        default:
+            return std::nullopt;
+        }
+        return attrs;
+    }
+
     /**
      * @brief Method for adding a UAObject node to the XML tree.
      * @param node_model An intermediate data model representing the necessary information to describe a node.
@@ -361,16 +581,14 @@ public:
         const auto event_not = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_EVENTNOTIFIER, "EventNotifier", Required::NotRequired);
         if (event_not.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(event_not.value(), UA_ATTRIBUTEID_EVENTNOTIFIER);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(event_not.value(), UA_ATTRIBUTEID_EVENTNOTIFIER))
-                {
-                    xml_object->SetAttribute("EventNotifier", ua_to_text::UAPrimitivesToXMLString(event_not.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming EventNotifier wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming EventNotifier wrong data type. Exception message: {}", exc.what());
+                xml_object->SetAttribute("EventNotifier", ua_to_text::UAPrimitivesToXMLString(event_not.value()).c_str());
             }
         }
 
@@ -448,16 +666,14 @@ public:
         const auto data_type = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_DATATYPE, "DataType", Required::NotRequired);
         if (data_type.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(data_type.value(), UA_ATTRIBUTEID_DATATYPE);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(data_type.value(), UA_ATTRIBUTEID_DATATYPE))
-                {
-                    xml_variable->SetAttribute("DataType", node_model.GetDataTypeAlias().c_str());
-                }
+                m_logger.Warning("Detected incoming DataType wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming DataType wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("DataType", node_model.GetDataTypeAlias().c_str());
             }
         }
 
@@ -465,16 +681,14 @@ public:
         const auto value_rank = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_VALUERANK, "ValueRank", Required::NotRequired);
         if (value_rank.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(value_rank.value(), UA_ATTRIBUTEID_VALUERANK);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(value_rank.value(), UA_ATTRIBUTEID_VALUERANK))
-                {
-                    xml_variable->SetAttribute("ValueRank", ua_to_text::UAPrimitivesToXMLString(value_rank.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming ValueRank wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming ValueRank wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("ValueRank", ua_to_text::UAPrimitivesToXMLString(value_rank.value()).c_str());
             }
         }
 
@@ -482,16 +696,14 @@ public:
         const auto array_dimensions = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_ARRAYDIMENSIONS, "ArrayDimensions", Required::NotRequired);
         if (array_dimensions.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(array_dimensions.value(), UA_ATTRIBUTEID_ARRAYDIMENSIONS);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(array_dimensions.value(), UA_ATTRIBUTEID_ARRAYDIMENSIONS))
-                {
-                    xml_variable->SetAttribute("ArrayDimensions", ua_to_text::UAArrayDimensionToXMLString(array_dimensions.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming ArrayDimensions wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming ArrayDimensions wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("ArrayDimensions", ua_to_text::UAArrayDimensionToXMLString(array_dimensions.value()).c_str());
             }
         }
 
@@ -499,16 +711,14 @@ public:
         const auto access_level = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_ACCESSLEVEL, "AccessLevel", Required::NotRequired);
         if (access_level.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(access_level.value(), UA_ATTRIBUTEID_ACCESSLEVEL);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(access_level.value(), UA_ATTRIBUTEID_ACCESSLEVEL))
-                {
-                    xml_variable->SetAttribute("AccessLevel", ua_to_text::UAPrimitivesToXMLString(access_level.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming AccessLevel wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming AccessLevel wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("AccessLevel", ua_to_text::UAPrimitivesToXMLString(access_level.value()).c_str());
             }
         }
 
@@ -516,16 +726,14 @@ public:
         const auto user_access_level = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_USERACCESSLEVEL, "UserAccessLevel", Required::NotRequired);
         if (user_access_level.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(user_access_level.value(), UA_ATTRIBUTEID_USERACCESSLEVEL);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(user_access_level.value(), UA_ATTRIBUTEID_USERACCESSLEVEL))
-                {
-                    xml_variable->SetAttribute("UserAccessLevel", ua_to_text::UAPrimitivesToXMLString(user_access_level.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming UserAccessLevel wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming UserAccessLevel wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("UserAccessLevel", ua_to_text::UAPrimitivesToXMLString(user_access_level.value()).c_str());
             }
         }
 
@@ -533,16 +741,14 @@ public:
         const auto minimum_sampling_interval = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL, "MinimumSamplingInterval", Required::NotRequired);
         if (minimum_sampling_interval.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(minimum_sampling_interval.value(), UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(minimum_sampling_interval.value(), UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL))
-                {
-                    xml_variable->SetAttribute("MinimumSamplingInterval", ua_to_text::UAPrimitivesToXMLString(minimum_sampling_interval.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming MinimumSamplingInterval wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming MinimumSamplingInterval wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("MinimumSamplingInterval", ua_to_text::UAPrimitivesToXMLString(minimum_sampling_interval.value()).c_str());
             }
         }
 
@@ -550,28 +756,24 @@ public:
         const auto historizing = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_HISTORIZING, "Historizing", Required::NotRequired);
         if (historizing.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(historizing.value(), UA_ATTRIBUTEID_HISTORIZING);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(historizing.value(), UA_ATTRIBUTEID_HISTORIZING))
-                {
-                    xml_variable->SetAttribute("Historizing", ua_to_text::UAPrimitivesToXMLString(historizing.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming Historizing wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming Historizing wrong data type. Exception message: {}", exc.what());
+                xml_variable->SetAttribute("Historizing", ua_to_text::UAPrimitivesToXMLString(historizing.value()).c_str());
             }
         }
 
         // XML ELEMENTS
         // Optional
-        // todo Value Complete the implementation.
-        //        auto* const xml_value = xml_variable->InsertNewChildElement("Value");
-        //        if (xml_value == nullptr)
-        //        {
-        //            m_logger.Error("XMLEncoder::AddNodeVariable(). Error setting Value.");
-        //            return StatusResults::Fail;
-        //        }
+        // Value
+        if (!AddValue(xml_variable, node_model))
+        {
+            return StatusResults::Fail;
+        }
 
         return StatusResults::Good;
     }
@@ -613,16 +815,14 @@ public:
         const auto data_type = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_DATATYPE, "DataType", Required::NotRequired);
         if (data_type.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(data_type.value(), UA_ATTRIBUTEID_DATATYPE);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(data_type.value(), UA_ATTRIBUTEID_DATATYPE))
-                {
-                    xml_variable_type->SetAttribute("DataType", node_model.GetDataTypeAlias().c_str());
-                }
+                m_logger.Warning("Detected incoming DataType wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming DataType wrong data type. Exception message: {}", exc.what());
+                xml_variable_type->SetAttribute("DataType", node_model.GetDataTypeAlias().c_str());
             }
         }
 
@@ -630,16 +830,14 @@ public:
         const auto value_rank = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_VALUERANK, "ValueRank", Required::NotRequired);
         if (value_rank.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(value_rank.value(), UA_ATTRIBUTEID_VALUERANK);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(value_rank.value(), UA_ATTRIBUTEID_VALUERANK))
-                {
-                    xml_variable_type->SetAttribute("ValueRank", ua_to_text::UAPrimitivesToXMLString(value_rank.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming ValueRank wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming ValueRank wrong data type. Exception message: {}", exc.what());
+                xml_variable_type->SetAttribute("ValueRank", ua_to_text::UAPrimitivesToXMLString(value_rank.value()).c_str());
             }
         }
 
@@ -647,28 +845,24 @@ public:
         const auto array_dimensions = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_ARRAYDIMENSIONS, "ArrayDimensions", Required::NotRequired);
         if (array_dimensions.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(array_dimensions.value(), UA_ATTRIBUTEID_ARRAYDIMENSIONS);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(array_dimensions.value(), UA_ATTRIBUTEID_ARRAYDIMENSIONS))
-                {
-                    xml_variable_type->SetAttribute("ArrayDimensions", ua_to_text::UAArrayDimensionToXMLString(array_dimensions.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming ArrayDimensions wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming ArrayDimensions wrong data type. Exception message: {}", exc.what());
+                xml_variable_type->SetAttribute("ArrayDimensions", ua_to_text::UAArrayDimensionToXMLString(array_dimensions.value()).c_str());
             }
         }
 
         // XML ELEMENTS
         // Optional
-        // todo Value Complete the implementation.
-        //        auto* const xml_value = xml_variable_type->InsertNewChildElement("Value");
-        //        if (xml_value == nullptr)
-        //        {
-        //            m_logger.Error("XMLEncoder::AddNodeVariableType(). Error setting Value.");
-        //            return StatusResults::Fail;
-        //        }
+        // Value
+        if (!AddValue(xml_variable_type, node_model))
+        {
+            return StatusResults::Fail;
+        }
 
         return StatusResults::Good;
     }
@@ -710,16 +904,14 @@ public:
         const auto symmetric = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_SYMMETRIC, "Symmetric", Required::NotRequired);
         if (symmetric.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(symmetric.value(), UA_ATTRIBUTEID_SYMMETRIC);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(symmetric.value(), UA_ATTRIBUTEID_SYMMETRIC))
-                {
-                    xml_reference_type->SetAttribute("Symmetric", ua_to_text::UAPrimitivesToXMLString(symmetric.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming Symmetric wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming Symmetric wrong data type. Exception message: {}", exc.what());
+                xml_reference_type->SetAttribute("Symmetric", ua_to_text::UAPrimitivesToXMLString(symmetric.value()).c_str());
             }
         }
 
@@ -784,13 +976,12 @@ public:
 
         // XML ELEMENTS
         // Optional
-        // todo Definition - Complete the implementation
-        //        auto* const xml_definition = xml_data_type->InsertNewChildElement("Definition");
-        //        if (xml_definition == nullptr)
-        //        {
-        //            m_logger.Error("XMLEncoder::AddNodeDataType(). Error setting Definition.");
-        //            return StatusResults::Fail;
-        //        }
+        // Definition
+        const auto definition = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_DATATYPEDEFINITION, "DataTypeDefinition", Required::NotRequired);
+        if (definition.has_value() && !AddDefinition(xml_data_type, node_model, definition.value()))
+        {
+            return StatusResults::Fail;
+        }
 
         return StatusResults::Good;
     }
@@ -804,10 +995,276 @@ public:
         m_xml_tree.ClearError();
         m_xml_ua_nodeset = nullptr;
         m_xml_ua_namespace_uris = nullptr;
+        m_xml_ua_models = nullptr;
         m_xml_ua_aliases = nullptr;
+        m_deferred_values.clear();
+        m_is_partial = false;
     }
 
 private:
+    /**
+     * @brief The value of the node that is read in parts when the document is printed, see AddValueByChunks.
+     */
+    struct DeferredValue
+    {
+        NodeIntermediateModel::ValueChunkReader reader;
+        std::string node_id; // For the log.
+    };
+
+    /**
+     * @brief The printer that calculates the content hash while the document is printed. Instead of the empty Value elements added by AddValueByChunks
+     *        it writes the values read in parts.
+     */
+    class HashingXMLPrinter final : public XMLPrinter
+    {
+    public:
+        /**
+         * @param encoder The encoder whose document is printed.
+         * @param file The file where the document is written. If nullptr, the text of the document is stored in the buffer of the printer.
+         * @param is_hash_only The text of the document is only hashed, neither written to the file nor stored in the buffer.
+         */
+        explicit HashingXMLPrinter(const XMLEncoder& encoder, FILE* file = nullptr, bool is_hash_only = false)
+            : XMLPrinter(file),
+              m_encoder(encoder),
+              m_is_hash_only(is_hash_only)
+        {
+        }
+
+        [[nodiscard]] const ContentHash& GetHash() const noexcept
+        {
+            return m_hash;
+        }
+
+        /**
+         * @brief Checking that all the values read in parts are written completely.
+         */
+        [[nodiscard]] bool IsValuesComplete() const noexcept
+        {
+            return m_is_values_complete;
+        }
+
+        using XMLPrinter::VisitEnter;
+        using XMLPrinter::VisitExit;
+
+        bool VisitEnter(const XMLElement& element, const tinyxml2::XMLAttribute* attribute) override
+        {
+            const auto deferred_value = m_encoder.m_deferred_values.find(&element);
+            if (deferred_value == m_encoder.m_deferred_values.end())
+            {
+                return XMLPrinter::VisitEnter(element, attribute);
+            }
+            if (!m_encoder.PrintValueByChunks(*this, element, deferred_value->second))
+            {
+                m_is_values_complete = false;
+            }
+            return false;
+        }
+
+        bool VisitExit(const XMLElement& element) override
+        {
+            if (m_encoder.m_deferred_values.contains(&element))
+            {
+                return true; // The element is already written by PrintValueByChunks.
+            }
+            return XMLPrinter::VisitExit(element);
+        }
+
+    protected:
+        using XMLPrinter::Write;
+
+        void Write(const char* data, size_t size) override
+        {
+            m_hash.Update(data, size);
+            if (!m_is_hash_only)
+            {
+                XMLPrinter::Write(data, size);
+            }
+        }
+
+        void Putc(char symbol) override
+        {
+            m_hash.Update(symbol);
+            if (!m_is_hash_only)
+            {
+                XMLPrinter::Putc(symbol);
+            }
+        }
+
+    private:
+        const XMLEncoder& m_encoder;
+        bool m_is_hash_only;
+        ContentHash m_hash;
+        bool m_is_values_complete = true;
+    };
+
+    /**
+     * @brief Bringing the tree to the canonical form: the nodes are sorted by NodeId, the references of each node by the reference type, the direction and the target.
+     *        The elements that are not nodes (NamespaceUris, Models, Aliases, comments) keep their places at the beginning of the document.
+     */
+    void Canonicalize()
+    {
+        m_logger.Trace("Method called: Canonicalize()");
+        std::vector<std::pair<UATypesContainer<UA_NodeId>, XMLElement*>> nodes;
+        for (auto* xml_node = m_xml_ua_nodeset->FirstChildElement(); xml_node != nullptr; xml_node = xml_node->NextSiblingElement())
+        {
+            const auto* const node_id = xml_node->Attribute("NodeId");
+            if (node_id == nullptr)
+            {
+                continue;
+            }
+            UATypesContainer<UA_NodeId> parsed_node_id(UA_TYPES_NODEID);
+            parsed_node_id.SetParamFromString(std::string(node_id));
+            nodes.emplace_back(std::move(parsed_node_id), xml_node);
+            SortReferences(xml_node);
+        }
+
+        std::stable_sort(
+            nodes.begin(),
+            nodes.end(),
+            [](const auto& first, const auto& second) { return std::less<UATypesContainer<UA_NodeId>>()(first.first, second.first); });
+        for (const auto& node : nodes)
+        {
+            m_xml_ua_nodeset->InsertEndChild(node.second);
+        }
+    }
+
+    /**
+     * @brief Sorting the Reference elements of the node by the reference type, the direction (inverse first) and the target NodeId text.
+     */
+    static void SortReferences(XMLElement* const xml_node)
+    {
+        auto* const xml_references = xml_node->FirstChildElement("References");
+        if (xml_references == nullptr)
+        {
+            return;
+        }
+        std::vector<XMLElement*> references;
+        for (auto* xml_reference = xml_references->FirstChildElement("Reference"); xml_reference != nullptr; xml_reference = xml_reference->NextSiblingElement("Reference"))
+        {
+            references.push_back(xml_reference);
+        }
+        const auto key = [](const XMLElement* const xml_reference)
+        {
+            const auto* const reference_type = xml_reference->Attribute("ReferenceType");
+            const auto* const text = xml_reference->GetText();
+            return std::make_tuple(
+                std::string_view(reference_type == nullptr ? "" : reference_type), xml_reference->BoolAttribute("IsForward", true), std::string_view(text == nullptr ? "" : text));
+        };
+        std::stable_sort(references.begin(), references.end(), [&key](const auto* const first, const auto* const second) { return key(first) < key(second); });
+        for (auto* const xml_reference : references)
+        {
+            xml_references->InsertEndChild(xml_reference);
+        }
+    }
+
+    /**
+     * @brief The name of the file where the content hash of the unloading is stored.
+     */
+    [[nodiscard]] std::string GetHashFilename() const
+    {
+        return m_filename + ".hash";
+    }
+
+    /**
+     * @brief The name of the temporary file where the document is written before it replaces the file of the unloading.
+     */
+    [[nodiscard]] std::string GetTempFilename() const
+    {
+        return m_filename + ".tmp";
+    }
+
+    /**
+     * @brief Writing the document to the file. If the rewrite of the unchanged file is skipped (see SetSkipUnchangedWrite), the document is first
+     *        only hashed and nothing is written if the hash is the same as the stored one. Otherwise the document is printed once to the temporary file,
+     *        the content hash is calculated in the same pass, and the temporary file replaces the file of the unloading.
+     *        If an error occurs, the file of the unloading is left untouched.
+     * @return True - if successful, otherwise false.
+     */
+    [[nodiscard]] bool SaveToFile()
+    {
+        if (m_is_canonical && m_is_skip_unchanged_write)
+        {
+            HashingXMLPrinter hash_printer(*this, nullptr, true);
+            m_xml_tree.Print(&hash_printer);
+            if (!hash_printer.IsValuesComplete())
+            {
+                m_logger.Error("XMLEncoder::End(). The content hash of the file '{}' can't be calculated.", m_filename);
+                return false;
+            }
+            if (IsFileUnchanged(hash_printer.GetHash().Digest()))
+            {
+                m_content_hash = hash_printer.GetHash().Digest();
+                m_is_write_skipped = true;
+                m_logger.Info("XMLEncoder::End(). The content of the file '{}' has not changed, the rewrite is skipped.", m_filename);
+                return true;
+            }
+        }
+
+        const auto temp_filename = GetTempFilename();
+        std::error_code error;
+        FILE* file = std::fopen(temp_filename.c_str(), "w");
+        if (file == nullptr)
+        {
+            m_logger.Error("XMLEncoder::End(). Can't open the file '{}' for writing.", temp_filename);
+            return false;
+        }
+        HashingXMLPrinter printer(*this, file);
+        m_xml_tree.Print(&printer);
+        const bool is_write_error = std::ferror(file) != 0;
+        if (std::fclose(file) != 0 || is_write_error || !printer.IsValuesComplete())
+        {
+            m_logger.Error("XMLEncoder::End(). Save to file '{}' error.", temp_filename);
+            std::filesystem::remove(temp_filename, error);
+            return false;
+        }
+
+        // The hash of the written text, in case the values read in parts have changed since the first pass.
+        if (m_is_canonical)
+        {
+            m_content_hash = printer.GetHash().Digest();
+        }
+
+        std::filesystem::rename(temp_filename, m_filename, error);
+        if (error)
+        {
+            m_logger.Error("XMLEncoder::End(). Can't replace the file '{}': {}", m_filename, error.message());
+            std::filesystem::remove(temp_filename, error);
+            return false;
+        }
+        if (m_is_canonical && m_is_skip_unchanged_write)
+        {
+            StoreContentHash(m_content_hash.value());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checking that the file exists and its stored content hash is equal to the hash of the new document.
+     */
+    [[nodiscard]] bool IsFileUnchanged(uint64_t content_hash) const
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(m_filename, error))
+        {
+            return false;
+        }
+        std::ifstream hash_file(GetHashFilename());
+        std::string stored_hash;
+        return hash_file >> stored_hash && stored_hash == ContentHash::ToHex(content_hash);
+    }
+
+    /**
+     * @brief Storing the content hash of the written file. The error is not critical, the file will be rewritten next time.
+     */
+    void StoreContentHash(uint64_t content_hash) const
+    {
+        std::ofstream hash_file(GetHashFilename(), std::ios::trunc);
+        if (!(hash_file << ContentHash::ToHex(content_hash) << '\n'))
+        {
+            m_logger.Warning("XMLEncoder::End(). The content hash can't be stored to the file '{}'.", GetHashFilename());
+        }
+    }
+
     /**
      * @brief Basic checks for main actions performed or internal variables populated
      * @param method_name The name of the method that will appear in the error in case of a validation error
@@ -859,26 +1316,72 @@ private:
     [[nodiscard]] std::optional<VariantsOfAttr> GetAndCheckUaAttribute(const NodeIntermediateModel& node_model, UA_AttributeId attr_id, const std::string& attr_name, Required is_required) const
     {
         m_logger.Trace("Method called: GetAndCheckUaAttribute()");
-        try
+        const auto br_name_opt = node_model.GetAttributes().find(attr_id);
+        if (br_name_opt == node_model.GetAttributes().end())
         {
-            auto br_name_opt = node_model.GetAttributes().at(attr_id);
-            if (br_name_opt.has_value())
+            // The optional attribute may not be requested by the attribute profile, in this case its default value is used.
+            if (is_required == Required::Required)
+            {
+                m_logger.Error("XMLEncoder::GetAndCheckUaAttribute. NodeID:{} has {} {} attribute not supported ", node_model.GetExpNodeId().ToString(), m_required_attr, attr_name);
+            }
+            else
             {
-                return br_name_opt;
+                m_logger.Debug("XMLEncoder::GetAndCheckUaAttribute. NodeID:{} has no {} attribute, the default value is used.", node_model.GetExpNodeId().ToString(), attr_name);
             }
-            MessageEmptyAttribute("GetAndCheckUaAttribute", node_model.GetExpNodeId().ToString(), attr_name, is_required);
+            return std::nullopt;
         }
-        catch (const std::out_of_range& exc)
+        if (br_name_opt->second.has_value())
         {
-            m_logger.Error(
-                "XMLEncoder::GetAndCheckUaAttribute. NodeID:{} has {} {} attribute not supported ",
-                node_model.GetExpNodeId().ToString(),
-                is_required == Required::Required ? m_required_attr : "",
-                attr_name);
+            return br_name_opt->second;
         }
+        MessageEmptyAttribute("GetAndCheckUaAttribute", node_model.GetExpNodeId().ToString(), attr_name, is_required);
         return std::nullopt;
     }
 
+    /**
+     * @brief Adds the elements of the localized attribute: one element per locale of the model (see NodeIntermediateModel::GetLocalizedTexts)
+     *        or one element of the main text. The empty text is not written.
+     * @param xml_node The XML element of the node.
+     * @param node_model A node model object containing the necessary information for description in XML format.
+     * @param attr_id The localized attribute.
+     * @param element_name The name of the element.
+     * @return True - if successful, otherwise false.
+     */
+    [[nodiscard]] bool AddLocalizedTextElements(XMLElement* const xml_node, const NodeIntermediateModel& node_model, UA_AttributeId attr_id, const char* const element_name) const
+    {
+        std::vector<VariantsOfAttr> texts;
+        const auto& localized_texts = node_model.GetLocalizedTexts(attr_id);
+        if (!localized_texts.empty())
+        {
+            texts.assign(localized_texts.begin(), localized_texts.end());
+        }
+        else if (auto text = GetAndCheckUaAttribute(node_model, attr_id, element_name, Required::NotRequired))
+        {
+            texts.push_back(std::move(text.value()));
+        }
+
+        for (const auto& text : texts)
+        {
+            const auto text_struct = ua_to_text::UALocalizedTextToXMLString(text);
+            if (text_struct.text.empty())
+            {
+                continue;
+            }
+            auto* const xml_text = xml_node->InsertNewChildElement(element_name);
+            if (xml_text == nullptr)
+            {
+                m_logger.Error("XMLEncoder::AddNodeUAInstance(). Error setting {}.", element_name);
+                return false;
+            }
+            if (!text_struct.locale.empty())
+            {
+                xml_text->SetAttribute("Locale", text_struct.locale.c_str());
+            }
+            xml_text->SetText(text_struct.text.c_str());
+        }
+        return true;
+    }
+
     /**
      * @brief Adds an object describing UAINstance (UANode + parentNodeId) to the XML tree. If the ParentNodeID output is not required, then the object describes the UANode.
      * @param xml_node An XML element that is based on a UAINstance or UANode (in case the ParentNodeId attribute is set to an empty object).
@@ -915,16 +1418,14 @@ private:
         const auto wr_mask = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_WRITEMASK, "WriteMask", Required::NotRequired);
         if (wr_mask.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(wr_mask.value(), UA_ATTRIBUTEID_WRITEMASK);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(wr_mask.value(), UA_ATTRIBUTEID_WRITEMASK))
-                {
-                    xml_node->SetAttribute("WriteMask", ua_to_text::UAPrimitivesToXMLString(wr_mask.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming WriteMask wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming WriteMask wrong data type. Exception message: {}", exc.what());
+                xml_node->SetAttribute("WriteMask", ua_to_text::UAPrimitivesToXMLString(wr_mask.value()).c_str());
             }
         }
 
@@ -932,16 +1433,14 @@ private:
         const auto user_wr_mask = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_USERWRITEMASK, "UserWriteMask", Required::NotRequired);
         if (user_wr_mask.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(user_wr_mask.value(), UA_ATTRIBUTEID_USERWRITEMASK);
+            if (!is_default.has_value())
             {
-                if (!DefaultValueAttributes::IsDefault(user_wr_mask.value(), UA_ATTRIBUTEID_USERWRITEMASK))
-                {
-                    xml_node->SetAttribute("UserWriteMask", ua_to_text::UAPrimitivesToXMLString(user_wr_mask.value()).c_str());
-                }
+                m_logger.Warning("Detected incoming UserWriteMask wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
             }
-            catch (std::bad_variant_access& exc)
+            else if (!is_default.value())
             {
-                m_logger.Warning("Detected incoming UserWriteMask wrong data type. Exception message: {}", exc.what());
+                xml_node->SetAttribute("UserWriteMask", ua_to_text::UAPrimitivesToXMLString(user_wr_mask.value()).c_str());
             }
         }
 
@@ -962,50 +1461,10 @@ private:
 
         // XML ELEMENTS
         // Optional - if there is no parameter, we do not display the parameter
-        // DisplayName
-        const auto disp_name = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_DISPLAYNAME, "DisplayName", Required::NotRequired);
-        if (disp_name.has_value())
-        {
-            const auto disp_name_struct = ua_to_text::UALocalizedTextToXMLString(disp_name.value());
-            if (!disp_name_struct.text.empty())
-            {
-                auto* const xml_disp_name = xml_node->InsertNewChildElement("DisplayName");
-                if (xml_disp_name == nullptr)
-                {
-                    m_logger.Error("XMLEncoder::AddNodeUAInstance(). Error setting DisplayName.");
-                    return false;
-                }
-
-                if (!disp_name_struct.locale.empty())
-                {
-                    xml_disp_name->SetAttribute("Locale", disp_name_struct.locale.c_str());
-                }
-
-                xml_disp_name->SetText(disp_name_struct.text.c_str());
-            }
-        }
-
-        // Description
-        const auto description = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_DESCRIPTION, "Description", Required::NotRequired);
-        if (description.has_value())
+        // DisplayName, Description. The element is repeated for each locale.
+        if (!AddLocalizedTextElements(xml_node, node_model, UA_ATTRIBUTEID_DISPLAYNAME, "DisplayName") || !AddLocalizedTextElements(xml_node, node_model, UA_ATTRIBUTEID_DESCRIPTION, "Description"))
         {
-            const auto description_struct = ua_to_text::UALocalizedTextToXMLString(description.value());
-            if (!description_struct.text.empty())
-            {
-                auto* const xml_description = xml_node->InsertNewChildElement("Description");
-                if (xml_description == nullptr)
-                {
-                    m_logger.Error("XMLEncoder::AddNodeUAInstance(). Error setting Description.");
-                    return false;
-                }
-
-                if (!description_struct.locale.empty())
-                {
-                    xml_description->SetAttribute("Locale", description_struct.locale.c_str());
-                }
-
-                xml_description->SetText(description_struct.text.c_str());
-            }
+            return false;
         }
 
         // References
@@ -1081,19 +1540,407 @@ private:
         const auto is_abstract = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_ISABSTRACT, "IsAbstract", Required::NotRequired);
         if (is_abstract.has_value())
         {
-            try
+            const auto is_default = DefaultValueAttributes::IsDefault(is_abstract.value(), UA_ATTRIBUTEID_ISABSTRACT);
+            if (!is_default.has_value())
+            {
+                m_logger.Warning("Detected incoming IsAbstract wrong data type. NodeId: {}", node_model.GetExpNodeId().ToString());
+            }
+            else if (!is_default.value())
             {
-                if (!DefaultValueAttributes::IsDefault(is_abstract.value(), UA_ATTRIBUTEID_ISABSTRACT))
+                xml_node->SetAttribute("IsAbstract", ua_to_text::UAPrimitivesToXMLString(is_abstract.value()).c_str());
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Adds the Value element of the Variable or VariableType node to the XML tree. Only the values of the built-in types are written: the scalars and
+     *        the one-dimensional arrays (see getattributetoxmltext::UABuiltinTypeToXMLElementName), the other values are skipped.
+     *        If the node model has the reader of the value in parts, the value is not stored in the tree, it is read and written to the output
+     *        part by part when the document is printed (see AddValueByChunks).
+     * @param xml_node An XML element of the UAVariable or UAVariableType node.
+     * @param node_model A node model object containing the necessary information for description in XML format.
+     * @return True - if successful, otherwise false (an error of the XML tree).
+     */
+    [[nodiscard]] bool AddValue(XMLElement* const xml_node, const NodeIntermediateModel& node_model)
+    {
+        m_logger.Trace("Method called: AddValue()");
+
+        if (const auto& value_chunk_reader = node_model.GetValueChunkReader())
+        {
+            return AddValueByChunks(xml_node, node_model, value_chunk_reader);
+        }
+
+        const auto value = GetAndCheckUaAttribute(node_model, UA_ATTRIBUTEID_VALUE, "Value", Required::NotRequired);
+        if (!value.has_value())
+        {
+            return true;
+        }
+        const auto* const variant = std::get_if<UATypesContainer<UA_Variant>>(&value.value());
+        if (variant == nullptr)
+        {
+            m_logger.Warning("Detected incoming Value wrong data type. NodeID: {}", node_model.GetExpNodeId().ToString());
+            return true;
+        }
+        if (UA_Variant_isEmpty(&variant->GetRef()))
+        {
+            return true;
+        }
+        const auto type_name = ua_to_text::UABuiltinTypeToXMLElementName(variant->GetRef().type);
+        if (type_name.empty() || variant->GetRef().arrayDimensionsSize > 1)
+        {
+            m_logger.Debug("XMLEncoder::AddValue(). NodeID: {}. The value of the type is not supported, the Value element is skipped.", node_model.GetExpNodeId().ToString());
+            return true;
+        }
+
+        auto* const xml_value = xml_node->InsertNewChildElement("Value");
+        if (xml_value == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddValue(). Error setting Value.");
+            return false;
+        }
+        if (UA_Variant_isScalar(&variant->GetRef()))
+        {
+            return AddValueElement(xml_value, variant->GetRef().data, variant->GetRef().type);
+        }
+        auto* const xml_list = xml_value->InsertNewChildElement(("uax:ListOf" + type_name).c_str());
+        if (xml_list == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddValue(). Error setting ListOf{}.", type_name);
+            return false;
+        }
+        return AddValueArrayElements(xml_list, variant->GetRef());
+    }
+
+    /**
+     * @brief Adds the empty Value element that is filled with the parts of the array read by the reader of the node model when the document is printed,
+     *        see PrintValueByChunks. Thus, neither the whole UA_Variant nor the whole XML text of the value is held in memory.
+     * @param xml_node An XML element of the UAVariable or UAVariableType node.
+     * @param node_model A node model object containing the necessary information for description in XML format.
+     * @param value_chunk_reader The reader of the value in parts.
+     * @return True - if successful, otherwise false (an error of the XML tree).
+     */
+    [[nodiscard]] bool AddValueByChunks(XMLElement* const xml_node, const NodeIntermediateModel& node_model, const NodeIntermediateModel::ValueChunkReader& value_chunk_reader)
+    {
+        m_logger.Trace("Method called: AddValueByChunks()");
+
+        auto* const xml_value = xml_node->InsertNewChildElement("Value");
+        if (xml_value == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddValueByChunks(). Error setting Value.");
+            return false;
+        }
+        m_deferred_values.emplace(xml_value, DeferredValue{value_chunk_reader, node_model.GetExpNodeId().ToString()});
+        return true;
+    }
+
+    /**
+     * @brief Writes the Value element added by AddValueByChunks to the output while the document is printed. Each part of the array is converted
+     *        to the XML elements in a separate tree and printed before the next part is read, so only one part of the value is held in memory.
+     *        If the value is not supported or the first part could not be read, the Value element is not written. If the reading fails after
+     *        a part has been written, the output can't be corrected anymore and the document is considered failed.
+     * @param printer The printer of the document.
+     * @param xml_value The empty Value element in the XML tree.
+     * @param deferred_value The reader of the value in parts.
+     * @return True - if successful or the Value element is skipped, false - the Value element is written incompletely.
+     */
+    [[nodiscard]] bool PrintValueByChunks(XMLPrinter& printer, const XMLElement& xml_value, const DeferredValue& deferred_value) const
+    {
+        m_logger.Trace("Method called: PrintValueByChunks()");
+
+        XMLDocument chunk_tree;
+        std::string list_name; // The printer keeps the pointer to the name of the open element until it is closed.
+        const UA_DataType* value_type = nullptr;
+        bool is_xml_error = false;
+        bool is_unsupported = false;
+        const bool is_read = deferred_value.reader(
+            [&](const UA_Variant& chunk) -> bool
+            {
+                if (UA_Variant_isEmpty(&chunk))
+                {
+                    return true;
+                }
+                if (value_type == nullptr)
+                {
+                    const auto type_name = ua_to_text::UABuiltinTypeToXMLElementName(chunk.type);
+                    if (type_name.empty() || chunk.arrayDimensionsSize > 1)
+                    {
+                        is_unsupported = true;
+                        return false;
+                    }
+                    value_type = chunk.type;
+                    printer.OpenElement(xml_value.Name());
+                    // The data source can return the value entirely if it does not support the reading in parts, it can be a scalar.
+                    if (!UA_Variant_isScalar(&chunk))
+                    {
+                        list_name = "uax:ListOf" + type_name;
+                        printer.OpenElement(list_name.c_str());
+                    }
+                }
+                else if (list_name.empty() || chunk.type != value_type || UA_Variant_isScalar(&chunk))
+                {
+                    m_logger.Warning("XMLEncoder::PrintValueByChunks(). NodeID: {}. The parts of the value have different types.", deferred_value.node_id);
+                    return false;
+                }
+
+                auto* const xml_chunk = chunk_tree.NewElement("Chunk");
+                if (chunk_tree.InsertEndChild(xml_chunk) == nullptr)
+                {
+                    m_logger.Error("XMLEncoder::PrintValueByChunks(). Error setting the part of the value.");
+                    is_xml_error = true;
+                    return false;
+                }
+                is_xml_error = list_name.empty() ? !AddValueElement(xml_chunk, chunk.data, chunk.type) : !AddValueArrayElements(xml_chunk, chunk);
+                for (const auto* xml_element = xml_chunk->FirstChild(); xml_element != nullptr && !is_xml_error; xml_element = xml_element->NextSibling())
                 {
-                    xml_node->SetAttribute("IsAbstract", ua_to_text::UAPrimitivesToXMLString(is_abstract.value()).c_str());
+                    xml_element->Accept(&printer);
                 }
+                chunk_tree.Clear();
+                return !is_xml_error;
+            });
+
+        if (is_unsupported)
+        {
+            m_logger.Debug("XMLEncoder::PrintValueByChunks(). NodeID: {}. The value of the type is not supported, the Value element is skipped.", deferred_value.node_id);
+            return true;
+        }
+        if (value_type == nullptr)
+        {
+            if (!is_read)
+            {
+                m_logger.Warning("XMLEncoder::PrintValueByChunks(). NodeID: {}. The value was not read, the Value element is skipped.", deferred_value.node_id);
             }
-            catch (std::bad_variant_access& exc)
+            return true;
+        }
+        // The elements are closed in any case to keep the rest of the document well-formed.
+        if (!list_name.empty())
+        {
+            printer.CloseElement();
+        }
+        printer.CloseElement();
+        if (!is_read || is_xml_error)
+        {
+            m_logger.Error("XMLEncoder::PrintValueByChunks(). NodeID: {}. The value was not read completely, the Value element is written incompletely.", deferred_value.node_id);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds the elements of the array to the ListOf element of the value.
+     * @param xml_list The ListOf element, for example "uax:ListOfDouble".
+     * @param array The one-dimensional array of the built-in type.
+     * @return True - if successful, otherwise false.
+     */
+    [[nodiscard]] bool AddValueArrayElements(XMLElement* const xml_list, const UA_Variant& array) const
+    {
+        const auto* const data = static_cast<const std::byte*>(array.data);
+        for (size_t index = 0; index < array.arrayLength; ++index)
+        {
+            if (!AddValueElement(xml_list, data + index * array.type->memSize, array.type)) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds the element of the value of the built-in type, for example "<uax:Double>1.5</uax:Double>".
+     * @param xml_parent The Value or ListOf element.
+     * @param data Pointer to the value of the type.
+     * @param type The data type of the value, one of the supported by getattributetoxmltext::UABuiltinTypeToXMLElementName.
+     * @return True - if successful, otherwise false.
+     */
+    [[nodiscard]] bool AddValueElement(XMLElement* const xml_parent, const void* const data, const UA_DataType* const type) const
+    {
+        auto* const xml_element = xml_parent->InsertNewChildElement(("uax:" + ua_to_text::UABuiltinTypeToXMLElementName(type)).c_str());
+        if (xml_element == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddValueElement(). Error setting the element of the value.");
+            return false;
+        }
+        switch (type->typeKind)
+        {
+        case UA_DATATYPEKIND_LOCALIZEDTEXT:
+        {
+            const auto* const localized_text = static_cast<const UA_LocalizedText*>(data);
+            if (localized_text->locale.length > 0)
+            {
+                xml_element->InsertNewChildElement("uax:Locale")->SetText(UaStringToStdString(localized_text->locale).c_str());
+            }
+            xml_element->InsertNewChildElement("uax:Text")->SetText(UaStringToStdString(localized_text->text).c_str());
+            break;
+        }
+        case UA_DATATYPEKIND_QUALIFIEDNAME:
+        {
+            const auto* const qualified_name = static_cast<const UA_QualifiedName*>(data);
+            if (qualified_name->namespaceIndex != 0)
             {
-                m_logger.Warning("Detected incoming IsAbstract wrong data type. Exception message: {}", exc.what());
+                xml_element->InsertNewChildElement("uax:NamespaceIndex")->SetText(qualified_name->namespaceIndex);
             }
+            xml_element->InsertNewChildElement("uax:Name")->SetText(UaStringToStdString(qualified_name->name).c_str());
+            break;
+        }
+        case UA_DATATYPEKIND_NODEID:
+        {
+            UA_String node_id_txt = UA_STRING_NULL;
+            UA_NodeId_print(static_cast<const UA_NodeId*>(data), &node_id_txt);
+            xml_element->InsertNewChildElement("uax:Identifier")->SetText(UaStringToStdString(node_id_txt).c_str());
+            UA_String_clear(&node_id_txt);
+            break;
         }
+        default:
+        {
+            const auto text = ua_to_text::UABuiltinValueToXMLString(data, type);
+            if (!text.has_value())
+            {
+                m_logger.Error("XMLEncoder::AddValueElement(). The value of the type cannot be converted to the text.");
+                return false;
+            }
+            xml_element->SetText(text.value().c_str());
+        }
+        }
+        return true;
+    }
 
+    /**
+     * @brief Adds the Definition element of UADataType from the DataTypeDefinition attribute (UA_StructureDefinition or UA_EnumDefinition).
+     *        The Name of the definition is the BrowseName of the data type, the DataType of the fields is written as an alias for the standard types.
+     * @param xml_data_type The UADataType element with the BrowseName attribute already set.
+     * @param node_model A node model object containing the necessary information for description in XML format.
+     * @param definition The value of the DataTypeDefinition attribute.
+     * @return True - if successful or the definition of the unsupported type is skipped, otherwise false.
+     */
+    [[nodiscard]] bool AddDefinition(XMLElement* const xml_data_type, const NodeIntermediateModel& node_model, const VariantsOfAttr& definition) const
+    {
+        m_logger.Trace("Method called: AddDefinition()");
+        const auto* const structure_definition = std::get_if<UATypesContainer<UA_StructureDefinition>>(&definition);
+        const auto* const enum_definition = std::get_if<UATypesContainer<UA_EnumDefinition>>(&definition);
+        if (structure_definition == nullptr && enum_definition == nullptr)
+        {
+            m_logger.Warning("Detected incoming DataTypeDefinition wrong data type. NodeID: {}", node_model.GetExpNodeId().ToString());
+            return true;
+        }
+
+        auto* const xml_definition = xml_data_type->InsertNewChildElement("Definition");
+        if (xml_definition == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddDefinition(). Error setting Definition.");
+            return false;
+        }
+        const auto* const browse_name = xml_data_type->Attribute("BrowseName");
+        xml_definition->SetAttribute("Name", browse_name != nullptr ? browse_name : "");
+
+        if (structure_definition != nullptr)
+        {
+            const auto& ua_definition = structure_definition->GetRef();
+            bool allow_subtypes = false;
+            switch (ua_definition.structureType)
+            {
+            case UA_STRUCTURETYPE_UNION:
+                xml_definition->SetAttribute("IsUnion", "true");
+                break;
+#ifdef OPEN62541_VER_1_4
+            case UA_STRUCTURETYPE_STRUCTUREWITHSUBTYPEDVALUES:
+                allow_subtypes = true;
+                break;
+            case UA_STRUCTURETYPE_UNIONWITHSUBTYPEDVALUES:
+                xml_definition->SetAttribute("IsUnion", "true");
+                allow_subtypes = true;
+                break;
+#endif
+            default:
+                break;
+            }
+
+            for (size_t index = 0; index < ua_definition.fieldsSize; ++index)
+            {
+                const auto& field = ua_definition.fields[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                auto* const xml_field = xml_definition->InsertNewChildElement("Field");
+                if (xml_field == nullptr)
+                {
+                    m_logger.Error("XMLEncoder::AddDefinition(). Error setting Field.");
+                    return false;
+                }
+                xml_field->SetAttribute("Name", UaStringToStdString(field.name).c_str());
+                // BaseDataType (i=24) is the default value of the DataType attribute.
+                if (!UA_NodeId_isNull(&field.dataType) && !(field.dataType.namespaceIndex == 0 && field.dataType.identifierType == UA_NODEIDTYPE_NUMERIC
+                                                            && field.dataType.identifier.numeric == UA_NS0ID_BASEDATATYPE)) // NOLINT(cppcoreguidelines-pro-type-union-access)
+                {
+                    xml_field->SetAttribute("DataType", NodeIntermediateModel::GetDataTypeAlias(field.dataType).c_str());
+                }
+                if (field.valueRank != UA_VALUERANK_SCALAR)
+                {
+                    xml_field->SetAttribute("ValueRank", field.valueRank);
+                }
+                if (field.arrayDimensionsSize > 0)
+                {
+                    const auto array_dimensions = std::vector<UA_UInt32>(field.arrayDimensions, field.arrayDimensions + field.arrayDimensionsSize); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    xml_field->SetAttribute("ArrayDimensions", ua_to_text::UAArrayDimensionToXMLString(VariantsOfAttr(array_dimensions)).c_str());
+                }
+                if (field.maxStringLength != 0)
+                {
+                    xml_field->SetAttribute("MaxStringLength", field.maxStringLength);
+                }
+                if (field.isOptional)
+                {
+                    // For the structures with the subtyped values the flag means that the field allows the subtypes of its DataType.
+                    xml_field->SetAttribute(allow_subtypes ? "AllowSubTypes" : "IsOptional", "true");
+                }
+                if (!AddDefinitionFieldText(xml_field, "Description", field.description))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const auto& ua_definition = enum_definition->GetRef();
+        for (size_t index = 0; index < ua_definition.fieldsSize; ++index)
+        {
+            const auto& field = ua_definition.fields[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            auto* const xml_field = xml_definition->InsertNewChildElement("Field");
+            if (xml_field == nullptr)
+            {
+                m_logger.Error("XMLEncoder::AddDefinition(). Error setting Field.");
+                return false;
+            }
+            xml_field->SetAttribute("Name", UaStringToStdString(field.name).c_str());
+            xml_field->SetAttribute("Value", field.value);
+            if (!AddDefinitionFieldText(xml_field, "DisplayName", field.displayName) || !AddDefinitionFieldText(xml_field, "Description", field.description))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds the DisplayName or Description element of the definition field. The empty text is not written.
+     * @param xml_field The Field element.
+     * @param element_name The name of the element.
+     * @param text The localized text of the field.
+     * @return True - if successful, otherwise false.
+     */
+    [[nodiscard]] bool AddDefinitionFieldText(XMLElement* const xml_field, const char* const element_name, const UA_LocalizedText& text) const
+    {
+        if (text.text.length == 0)
+        {
+            return true;
+        }
+        auto* const xml_text = xml_field->InsertNewChildElement(element_name);
+        if (xml_text == nullptr)
+        {
+            m_logger.Error("XMLEncoder::AddDefinitionFieldText(). Error setting {}.", element_name);
+            return false;
+        }
+        if (text.locale.length > 0)
+        {
+            xml_text->SetAttribute("Locale", UaStringToStdString(text.locale).c_str());
+        }
+        xml_text->SetText(UaStringToStdString(text.text).c_str());
         return true;
     }
 
@@ -1101,11 +1948,19 @@ private:
     XMLDocument m_xml_tree; // Main XML tree
     XMLElement* m_xml_ua_nodeset = nullptr; // The main parent node of the structure within which the upload will be formed
     XMLElement* m_xml_ua_namespace_uris = nullptr; // Must always go first in the sequence inside m_ua_nodeset
-    XMLElement* m_xml_ua_aliases = nullptr; // Must always come after m_ua_namespace_uris in sequence.
+    XMLElement* m_xml_ua_models = nullptr; // Must always come after m_ua_namespace_uris in sequence.
+    XMLElement* m_xml_ua_aliases = nullptr; // Must always come after m_ua_namespace_uris and m_xml_ua_models in sequence.
 
     static constexpr auto m_required_attr = "[Required]"; // Attributes that, according to the UANodeSet.xsd scheme, are marked as mandatory and do not have default values.
     static constexpr auto m_n_required_attr = "[Optional]";
+    static constexpr auto m_partial_export_comment = "PARTIAL EXPORT. The export was stopped before completion, the document contains only part of the requested nodes.";
     bool m_begin_first = false;
+    bool m_is_partial = false;
+    bool m_is_canonical = false;
+    bool m_is_skip_unchanged_write = false;
+    bool m_is_write_skipped = false;
+    std::optional<uint64_t> m_content_hash;
+    std::map<const XMLElement*, DeferredValue> m_deferred_values; // The empty Value elements that are filled when the document is printed.
 };
 
 } // namespace nodesetexporter::encoders
@@ -0,0 +1,81 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_INTERFACES_IASYNCOPEN62541_H
+#define NODESETEXPORTER_INTERFACES_IASYNCOPEN62541_H
+
+#include "nodesetexporter/common/Coroutines.h"
+#include "nodesetexporter/interfaces/IOpen62541.h"
+
+#include <functional>
+#include <vector>
+
+namespace nodesetexporter::interfaces
+{
+using ::nodesetexporter::common::coroutines::Task;
+
+/**
+ * @brief An asynchronous variant of IOpen62541: the methods return awaitable tasks (co_await) instead of blocking the calling thread.
+ *        The request-response structures and the rules for filling them are the same as in IOpen62541.
+ * @warning Several tasks can be in progress at the same time (for different batches of nodes), and the awaiting coroutine can be resumed in any thread,
+ *          so the implementation must either allow simultaneous requests or serialize them itself.
+ *          The structures passed by reference must live until the task is completed.
+ */
+class IAsyncOpen62541
+{
+public:
+    using NodeClassesRequestResponse = IOpen62541::NodeClassesRequestResponse;
+    using NodeReferencesRequestResponse = IOpen62541::NodeReferencesRequestResponse;
+    using NodeAttributesRequestResponse = IOpen62541::NodeAttributesRequestResponse;
+
+    explicit IAsyncOpen62541(LoggerBase& logger)
+        : m_logger(logger)
+    {
+    }
+    virtual ~IAsyncOpen62541() = default;
+    IAsyncOpen62541(IAsyncOpen62541&) = delete;
+    IAsyncOpen62541(IAsyncOpen62541&&) = delete;
+    IAsyncOpen62541& operator=(const IAsyncOpen62541& obj) = delete;
+    IAsyncOpen62541& operator=(IAsyncOpen62541&& obj) = delete;
+
+    /**
+     * @brief Awaitable query of class attributes of a set of nodes.
+     * @param node_class_structure_lists List of node class request-response structures.
+     * @remark Attribute Service Set.
+     * @return Task with the request execution status.
+     */
+    [[nodiscard]] virtual Task<StatusResults> ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists) = 0;
+    /**
+     * @brief Awaitable query of references of multiple nodes.
+     * @param node_references_structure_lists List of node reference request-response structures.
+     * @remark View Service Set - Browse.
+     * @return Task with the request execution status.
+     */
+    [[nodiscard]] virtual Task<StatusResults> ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists) = 0;
+    /**
+     * @brief Awaitable query of multiple attributes of multiple nodes.
+     * @param node_attr_structure_lists List of node attribute request-response structures.
+     * @remark Attribute Service Set
+     * @return Task with the request execution status.
+     */
+    [[nodiscard]] virtual Task<StatusResults> ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists) = 0;
+    /**
+     * @brief Awaitable execution of a call that makes the requests through the blocking IOpen62541 behind this object (for example, DataTypeDefinitionCache).
+     *        The call is serialized with the other requests in the same way as the methods above.
+     * @param call The call executing the blocking requests.
+     * @return Task with the status returned by the call.
+     */
+    [[nodiscard]] virtual Task<StatusResults> ExecuteBlockingCall(std::function<StatusResults()> call) = 0;
+
+protected:
+    LoggerBase& m_logger; // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+} // namespace nodesetexporter::interfaces
+
+#endif // NODESETEXPORTER_INTERFACES_IASYNCOPEN62541_H
@@ -17,6 +17,7 @@
 #include <open62541/types_generated_handling.h>
 
 #include <optional>
+#include <string>
 #include <set>
 #include <vector>
 
@@ -38,6 +39,17 @@ using ::nodesetexporter::open62541::UATypesContainer;
 class IEncoder
 {
 public:
+    /**
+     * @brief The description of the information model defined by the unloading (the Model element of UANodeSet.xsd).
+     * model_uri - the namespace URI of the model.
+     * required_model_uris - the namespace URIs of the models that must be loaded before this model.
+     */
+    struct ModelTableEntry
+    {
+        std::string model_uri;
+        std::vector<std::string> required_model_uris;
+    };
+
     /**
      * Building an exporter encoder where export is done to a file.
      * @param logger The logging class object.
@@ -94,6 +106,38 @@ public:
      */
     [[nodiscard]] virtual StatusResults AddAliases(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases) = 0;
 
+    /**
+     * @brief Method for adding the descriptions of the information models defined by the unloading and their dependencies.
+     *        By default, the encoder does not write the models.
+     * @warning The method is called after Begin() and before End().
+     * @param models The models of the unloading.
+     * @return Return the error status.
+     */
+    [[nodiscard]] virtual StatusResults AddModels([[maybe_unused]] const std::vector<ModelTableEntry>& models)
+    {
+        m_logger.Debug("The models are not supported by the encoder, skipped.");
+        return StatusResults::Good;
+    }
+
+    /**
+     * @brief Method for marking the export as incomplete. Called when the export was stopped before all nodes were processed.
+     *        The unloading must remain valid for its format, but it must be clearly distinguishable from a complete one.
+     * @warning The method is called after Begin() and before End().
+     * @return Return the error status.
+     */
+    [[nodiscard]] virtual StatusResults MarkAsPartial() = 0;
+
+    /**
+     * @brief Method for declaring the set of node attributes that the encoder writes to the export for the node class.
+     *        The attributes that are not in the set are not requested from the server. By default, the encoder consumes all the attributes.
+     * @param node_class The class of the node.
+     * @return The set of the consumed attributes or std::nullopt if all the attributes of the node class are consumed.
+     */
+    [[nodiscard]] virtual std::optional<std::set<UA_AttributeId>> GetConsumedAttributes([[maybe_unused]] UA_NodeClass node_class) const
+    {
+        return std::nullopt;
+    }
+
     /**
      * @brief Method for adding a node of type Object to the export.
      * @param node_model model of the required data for node export
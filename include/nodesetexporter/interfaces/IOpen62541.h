@@ -136,6 +136,24 @@ public:
      * @return Request execution status.
      */
     [[nodiscard]] virtual StatusResults ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value) = 0;
+    /**
+     * @brief Method for querying a part of the one-dimensional array value of a single node (IndexRange).
+     *        Allows to read the large arrays in parts that fit into the response message and do not hold the whole array in memory.
+     * @param node_id The node for which the value is requested.
+     * @param first_index Index of the first requested element of the array.
+     * @param number_of_elements Number of the requested elements. The response contains fewer elements if the array ends earlier.
+     * @param data_value [out] The part of the array. If the array has no elements starting from first_index, the value is empty.
+     * @return Request execution status. The default implementation does not support reading in parts and returns Fail, in this case the value should be read entirely.
+     */
+    [[nodiscard]] virtual StatusResults ReadNodeDataValueRange(
+        const UATypesContainer<UA_ExpandedNodeId>& node_id,
+        [[maybe_unused]] size_t first_index,
+        [[maybe_unused]] size_t number_of_elements,
+        [[maybe_unused]] UATypesContainer<UA_Variant>& data_value)
+    {
+        m_logger.Debug("ReadNodeDataValueRange is not supported by the implementation. NodeID: {}", node_id.ToString());
+        return StatusResults::Fail;
+    }
 
 protected:
     LoggerBase& m_logger; // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
@@ -0,0 +1,62 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_INTERFACES_IQUIRKFIXER_H
+#define NODESETEXPORTER_INTERFACES_IQUIRKFIXER_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/interfaces/IOpen62541.h"
+
+#include <string_view>
+#include <vector>
+
+namespace nodesetexporter::interfaces
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = ::nodesetexporter::common::statuses::StatusResults<int64_t>;
+
+/**
+ * @brief An abstract class of the fixers of the vendor-specific deviations of the servers from the OPC UA specification (the quirks).
+ *        The fixer corrects the references of the whole batch of nodes received from the data source, before they are processed by the export.
+ * @warning The error status is displayed as a result of the fixing, but the error description must be logged in interface implementations.
+ *          If the deviation is corrected, the fact itself should be displayed in the log.
+ */
+class IQuirkFixer
+{
+public:
+    explicit IQuirkFixer(LoggerBase& logger)
+        : m_logger(logger)
+    {
+    }
+    virtual ~IQuirkFixer() = default;
+    IQuirkFixer(IQuirkFixer&) = delete;
+    IQuirkFixer(IQuirkFixer&&) = delete;
+    IQuirkFixer& operator=(const IQuirkFixer& obj) = delete;
+    IQuirkFixer& operator=(IQuirkFixer&& obj) = delete;
+
+    /**
+     * @brief The name of the fixer, by which it is enabled (see quirks::MakeQuirkFixer).
+     */
+    [[nodiscard]] virtual std::string_view GetName() const noexcept = 0;
+
+    /**
+     * @brief Correction of the references of the batch of nodes.
+     * @param node_references_req_res List of references associated with NodeID, the references are changed and added in place.
+     * @return Fail if the references can't be corrected and the export must be stopped.
+     */
+    [[nodiscard]] virtual StatusResults FixReferences(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res) = 0;
+
+protected:
+    LoggerBase& m_logger; // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+};
+
+} // namespace nodesetexporter::interfaces
+
+#endif // NODESETEXPORTER_INTERFACES_IQUIRKFIXER_H
@@ -0,0 +1,241 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_ASYNCCLIENTWRAPPERS_H
+#define NODESETEXPORTER_OPEN62541_ASYNCCLIENTWRAPPERS_H
+
+#include "nodesetexporter/interfaces/IOpen62541.h"
+
+#include <open62541/client.h>
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace nodesetexporter::open62541
+{
+
+using nodesetexporter::common::LogLevel;
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using nodesetexporter::interfaces::IOpen62541;
+using ::nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::typealiases::UAVariantToStdVariant;
+using nodesetexporter::open62541::typealiases::VariantsOfAttr;
+
+/**
+ * @brief Function for transferring a task to the event loop thread that owns the Open62541 client.
+ *        The task must be performed in the same thread where UA_Client_run_iterate is called for this client.
+ */
+using ClientEventLoopDispatcher = std::function<void(std::function<void()>&&)>;
+
+/**
+ * @brief Implementation of the client wrapper on top of asynchronous requests (UA_Client_sendAsyncRequest).
+ *        The operations of one method call are divided into several requests, which are in flight at the same time, the number of such requests is limited.
+ *        The wrapper does not iterate the client by itself: sending is transferred to the event loop through the dispatcher,
+ *        and the responses are received inside UA_Client_run_iterate, which the owner of the event loop must call regularly (timer or socket readiness).
+ * @warning The interface methods block the calling thread until all responses are received, so they must not be called from the event loop thread.
+ *          While the wrapper is in use, the client must not be used by synchronous calls from other threads.
+ *          The requests in flight are completed only inside the event loop: by the response, by the timeout of the request (UA_ClientConfig::timeout)
+ *          or with an error by the disconnection. So if the owner stops iterating the client (UA_Client_run_iterate has returned a bad status, the export
+ *          is aborted), it must disconnect the client in the event loop thread, then all requests in flight are failed and the following ones fail
+ *          at once. Otherwise the calling thread waits forever.
+ */
+class Open62541AsyncClientWrapper final : public IOpen62541
+{
+    constexpr static std::uint32_t max_requests_in_flight_default = 4;
+
+public:
+    /**
+     * @brief Constructor of the asynchronous client wrapper.
+     * @param ua_client The connected Open62541 client.
+     * @param logger Logging methods.
+     * @param dispatcher Function for transferring tasks to the event loop thread of the client.
+     */
+    explicit Open62541AsyncClientWrapper(UA_Client& ua_client, LoggerBase& logger, ClientEventLoopDispatcher dispatcher)
+        : IOpen62541(logger)
+        , m_ua_client(ua_client)
+        , m_dispatcher(std::move(dispatcher))
+    {
+        if (!m_dispatcher)
+        {
+            throw std::invalid_argument("The dispatcher of the client event loop is not set");
+        }
+    }
+    ~Open62541AsyncClientWrapper() override = default;
+    Open62541AsyncClientWrapper(Open62541AsyncClientWrapper&) = delete;
+    Open62541AsyncClientWrapper(Open62541AsyncClientWrapper&&) = delete;
+    Open62541AsyncClientWrapper& operator=(const Open62541AsyncClientWrapper& obj) = delete;
+    Open62541AsyncClientWrapper& operator=(Open62541AsyncClientWrapper&& obj) = delete;
+
+private:
+    /**
+     * @brief Sending a set of requests of the same service, no more than GetMaxRequestsInFlight() at the same time, and waiting for all responses.
+     * @param requests Requests to send. The requests do not own the data passed by the pointers.
+     * @param responses [out] Responses in the order of the requests. Must be initialized, the size must be equal to the number of requests.
+     *                  If the request could not be sent, only the serviceResult of the response header is filled in.
+     * @param request_type Open62541 request type.
+     * @param response_type Open62541 response type.
+     * @return Request execution status. Errors of the service are returned in the response headers.
+     */
+    template <typename TRequest, typename TResponse>
+    [[nodiscard]] StatusResults SendRequestsAndWait(std::vector<TRequest>& requests, std::vector<TResponse>& responses, const UA_DataType& request_type, const UA_DataType& response_type);
+
+    /**
+     * @brief Number of operations (attributes to read, nodes to browse, continuation points) in one request.
+     * @param operations Total number of operations of the method call.
+     */
+    [[nodiscard]] size_t GetOperationsPerRequest(size_t operations) const;
+
+    /**
+     * @brief Selection of the remaining references of the nodes by continuation points. The points of one round are read simultaneously, the rounds are repeated while the server
+     *        returns new continuation points.
+     * @param continuation_points List of pairs <index of the node in node_references_structure_lists, continuation point>.
+     * @param node_references_structure_lists List of node reference request-response structures, where the received references are added.
+     * @return Request execution status. The stop request does not interrupt the selection, the references of the nodes are always complete.
+     */
+    [[nodiscard]] StatusResults BrowseNext(
+        std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>>& continuation_points,
+        std::vector<NodeReferencesRequestResponse>& node_references_structure_lists);
+
+    /**
+     * @brief Release the continuation points on the server without reading the remaining references.
+     * @param continuation_points List of pairs <index of the node, continuation point>.
+     */
+    void ReleaseContinuationPoints(const std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>>& continuation_points);
+
+    /**
+     * @brief A method for querying multiple attributes from multiple nodes.
+     * @param read_value_ids An array of node value structures to the requested attribute.
+     * @param set_data Callback function to return the finished result.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodesAttributes(std::vector<UA_ReadValueId>& read_value_ids, const std::function<void(size_t, UA_DataValue&, UA_NodeId&, UA_UInt32)>& set_data);
+
+public:
+    /**
+     * @brief Method for querying class attributes of a set of nodes.
+     * @remark Attribute Service Set, Async - UA_Client_sendAsyncRequest(UA_ReadRequest)
+     * @param node_class_structure_lists List of node class request-response structures.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists) override;
+
+    /**
+     * @brief Method for querying references of multiple nodes.
+     * @remark View Service Set - Browsing-BrowseNext, Async - UA_Client_sendAsyncRequest(UA_BrowseRequest, UA_BrowseNextRequest)
+     * @param node_references_structure_lists List of node reference request-response structures.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists) override;
+
+    /**
+     * @brief Method for querying multiple attributes of multiple nodes.
+     * @warning The value of the UA_ATTRIBUTEID_VALUE attribute is returned as a UA_Variant wrapped in std::optional<VariantsOfAttr>>,
+     *          the same as in Open62541ClientWrapper.
+     * @remark Attribute Service Set, Async - UA_Client_sendAsyncRequest(UA_ReadRequest)
+     * @param node_attr_structure_lists List of node attribute request-response structures.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists) override;
+
+    /**
+     * @brief Method for querying the value of a single node.
+     * @remark Attribute Service Set, Async - UA_Client_sendAsyncRequest(UA_ReadRequest)
+     * @param node_id The node for which the value is requested.
+     * @param data_value [out] The value of the node.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value) override;
+
+    /**
+     * @brief Method for querying a part of the one-dimensional array value of a single node.
+     * @remark Attribute Service Set, Async - UA_Client_sendAsyncRequest(UA_ReadRequest) with the IndexRange of the ReadValueId.
+     * @param node_id The node for which the value is requested.
+     * @param first_index Index of the first requested element of the array.
+     * @param number_of_elements Number of the requested elements.
+     * @param data_value [out] The part of the array. Empty if the array has no elements starting from first_index (Bad_IndexRangeNoData).
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodeDataValueRange(
+        const UATypesContainer<UA_ExpandedNodeId>& node_id,
+        size_t first_index,
+        size_t number_of_elements,
+        UATypesContainer<UA_Variant>& data_value) override;
+
+    /**
+     * @brief The method specifies the maximum number of references to return for each starting node specified in the request.
+     *        The use of the parameter is described in Open62541ClientWrapper::SetRequestedMaxReferencesPerNode.
+     */
+    [[maybe_unused]] void SetRequestedMaxReferencesPerNode(std::uint32_t requested_max_references_per_node)
+    {
+        m_requested_max_references_per_node = requested_max_references_per_node;
+    }
+
+    /**
+     * @brief The method returns the maximum number of references returned for each starting node specified in the request.
+     */
+    [[nodiscard]] std::uint32_t GetRequestedMaxReferencesPerNode() const
+    {
+        return m_requested_max_references_per_node;
+    }
+
+    /**
+     * @brief Sets the View that limits the browsing of the references in the ReadNodeReferences request.
+     *        The use of the parameter is described in Open62541ClientWrapper::SetView.
+     */
+    void SetView(const UATypesContainer<UA_ViewDescription>& view)
+    {
+        m_view = view;
+    }
+
+    /**
+     * @brief The method specifies the maximum number of requests that are sent and have not yet received a response. 0 is replaced by 1.
+     */
+    void SetMaxRequestsInFlight(std::uint32_t max_requests_in_flight)
+    {
+        m_max_requests_in_flight = max_requests_in_flight == 0 ? 1 : max_requests_in_flight;
+    }
+
+    /**
+     * @brief The method returns the maximum number of requests that are sent and have not yet received a response.
+     */
+    [[nodiscard]] std::uint32_t GetMaxRequestsInFlight() const
+    {
+        return m_max_requests_in_flight;
+    }
+
+    /**
+     * @brief The method specifies the maximum number of operations in one request.
+     *        By default (0), the operations of one method call are divided equally between GetMaxRequestsInFlight() requests.
+     */
+    void SetMaxOperationsPerRequest(std::uint32_t max_operations_per_request)
+    {
+        m_max_operations_per_request = max_operations_per_request;
+    }
+
+    /**
+     * @brief The method returns the maximum number of operations in one request. 0 - division between requests in flight.
+     */
+    [[nodiscard]] std::uint32_t GetMaxOperationsPerRequest() const
+    {
+        return m_max_operations_per_request;
+    }
+
+private:
+    UA_Client& m_ua_client;
+    ClientEventLoopDispatcher m_dispatcher;
+    std::uint32_t m_requested_max_references_per_node = 0;
+    UATypesContainer<UA_ViewDescription> m_view{UA_TYPES_VIEWDESCRIPTION};
+    std::uint32_t m_max_requests_in_flight = max_requests_in_flight_default;
+    std::uint32_t m_max_operations_per_request = 0;
+};
+
+} // namespace nodesetexporter::open62541
+
+#endif // NODESETEXPORTER_OPEN62541_ASYNCCLIENTWRAPPERS_H
@@ -0,0 +1,131 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_AWAITABLEWRAPPERS_H
+#define NODESETEXPORTER_OPEN62541_AWAITABLEWRAPPERS_H
+
+#include "nodesetexporter/interfaces/IAsyncOpen62541.h"
+#include "nodesetexporter/interfaces/IOpen62541.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace nodesetexporter::open62541
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using nodesetexporter::interfaces::IAsyncOpen62541;
+using nodesetexporter::interfaces::IOpen62541;
+using nodesetexporter::interfaces::Task;
+
+/**
+ * @brief Implementation of IAsyncOpen62541 on top of any blocking IOpen62541 (client, server or asynchronous client wrapper).
+ *        Each call is executed in one of the worker threads of the wrapper, after which the awaiting coroutine is resumed in the same worker thread.
+ *        While the request of one batch is executed, the coroutine engine processes and exports the data of another batch.
+ * @warning The Open62541ClientWrapper and Open62541ServerWrapper do not allow simultaneous calls, so by default the calls are serialized by the wrapper.
+ *          Simultaneous calls can be allowed only for implementations that support them (Open62541AsyncClientWrapper).
+ *          The wrapped object must not be used directly while the tasks of the wrapper are in progress, except inside ExecuteBlockingCall.
+ */
+class Open62541AwaitableWrapper final : public IAsyncOpen62541
+{
+    /**
+     * @brief Awaitable call of the wrapped object in the worker thread.
+     */
+    class CallAwaiter
+    {
+    public:
+        CallAwaiter(Open62541AwaitableWrapper& wrapper, std::function<StatusResults()>&& call)
+            : m_wrapper(wrapper)
+            , m_call(std::move(call))
+        {
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting);
+
+        StatusResults await_resume();
+
+        /**
+         * @brief Performing the call and resuming the awaiting coroutine. Called in the worker thread.
+         */
+        void Execute();
+
+    private:
+        Open62541AwaitableWrapper& m_wrapper;
+        std::function<StatusResults()> m_call;
+        std::coroutine_handle<> m_awaiting;
+        std::optional<StatusResults> m_result;
+        std::exception_ptr m_exception;
+    };
+
+public:
+    /**
+     * @brief Constructor of the awaitable wrapper.
+     * @param open62541_lib The wrapped blocking implementation of IOpen62541.
+     * @param logger Logging methods.
+     * @param number_of_workers Number of worker threads, usually equal to the number of batches in flight. 0 is replaced by 1.
+     * @param is_simultaneous_calls_allowed The wrapped implementation allows simultaneous calls from different threads. [optional]
+     */
+    Open62541AwaitableWrapper(IOpen62541& open62541_lib, LoggerBase& logger, size_t number_of_workers, bool is_simultaneous_calls_allowed = false);
+    ~Open62541AwaitableWrapper() override;
+    Open62541AwaitableWrapper(Open62541AwaitableWrapper&) = delete;
+    Open62541AwaitableWrapper(Open62541AwaitableWrapper&&) = delete;
+    Open62541AwaitableWrapper& operator=(const Open62541AwaitableWrapper& obj) = delete;
+    Open62541AwaitableWrapper& operator=(Open62541AwaitableWrapper&& obj) = delete;
+
+    /**
+     * @brief Awaitable query of class attributes of a set of nodes, see IOpen62541::ReadNodeClasses.
+     */
+    [[nodiscard]] Task<StatusResults> ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists) override;
+
+    /**
+     * @brief Awaitable query of references of multiple nodes, see IOpen62541::ReadNodeReferences.
+     */
+    [[nodiscard]] Task<StatusResults> ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists) override;
+
+    /**
+     * @brief Awaitable query of multiple attributes of multiple nodes, see IOpen62541::ReadNodesAttributes.
+     */
+    [[nodiscard]] Task<StatusResults> ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists) override;
+
+    /**
+     * @brief Awaitable execution of a call that uses the wrapped object directly, see IAsyncOpen62541::ExecuteBlockingCall.
+     */
+    [[nodiscard]] Task<StatusResults> ExecuteBlockingCall(std::function<StatusResults()> call) override;
+
+private:
+    /**
+     * @brief The cycle of the worker thread: taking the calls from the queue until the stop.
+     */
+    void WorkerLoop(const std::stop_token& stop_token);
+
+    IOpen62541& m_open62541_lib;
+    bool m_is_simultaneous_calls_allowed;
+    std::mutex m_call_mutex; // Serialization of the calls of the wrapped object
+    std::mutex m_queue_mutex;
+    std::condition_variable_any m_queue_cv;
+    std::deque<CallAwaiter*> m_queue;
+    std::vector<std::jthread> m_workers; // The last one, so that the threads are stopped before the queue is destroyed
+};
+
+} // namespace nodesetexporter::open62541
+
+#endif // NODESETEXPORTER_OPEN62541_AWAITABLEWRAPPERS_H
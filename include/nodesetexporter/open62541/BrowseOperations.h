@@ -9,10 +9,12 @@
 #define NODESETEXPORTER_OPEN62541_BROWSEOPERATIONS_H
 
 #include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/DiscoveryRules.h"
 #include "nodesetexporter/open62541/UATypesContainer.h"
 
 #include <open62541/client_highlevel.h>
 
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -55,15 +57,50 @@ UA_StatusCode UA_Client_forEachChildNodeCall_Ex(UA_Client* client, UA_NodeId par
 // NOLINTEND
 
 
+/**
+ * @brief Browsing of the forward hierarchical references of the node. Unlike UA_Client_forEachChildNodeCall_Ex the callback receives the whole description
+ *        of the reference (BrowseName and the class of the child node are needed by the include/exclude rules and by the estimation of the export).
+ * @param view The View that limits the browsing, nullptr - the whole address space.
+ * @return The status of the service.
+ */
+UA_StatusCode ForEachChildReference(
+    UA_Client* client,
+    const UA_NodeId& parent_node_id,
+    const UA_ViewDescription* view,
+    const std::function<void(const UA_ReferenceDescription&)>& callback);
+
+/**
+ * @brief Executing of the request with the recovery of the lost session (for example, Open62541ClientWrapper::CallWithSessionRecovery).
+ *        The request is repeatable and returns the status code of the service, the result is the status code of its last execution.
+ */
+using SessionRecovery = std::function<UA_StatusCode(const std::function<UA_StatusCode()>& request)>;
+
+/**
+ * @brief The View of the Browse requests.
+ * @param view_id The node of the View class.
+ * @param timestamp, view_version The state of the View at the time or the version of the View, 0 - the current state.
+ */
+[[nodiscard]] UATypesContainer<UA_ViewDescription> MakeViewDescription(const UA_NodeId& view_id, UA_DateTime timestamp = 0, UA_UInt32 view_version = 0);
+
 /**
  * @brief Function of iterative passage through all nodes starting from the starting one and collecting a list of nodes for export.
  * @warning The function does not ignore nodes with namespace=0 included in hierarchical reference.
  * @param client - Pointer to the Open62541 client object.
  * @param start_node_id - Link to the starting node from which the list of nodes for export will be built.
  * @param out - Link to the list where the list of nodes for export will be built.
+ * @param filter - The include/exclude rules evaluated for each child node before it is added to the list, the excluded subtrees are not browsed. nullptr - all nodes are collected.
+ * @param view - The View that limits the browsing: only the nodes and the references of the View are collected. nullptr - the whole address space.
+ * @param session_recovery - The recovery of the session, through which each Browse request is executed: the children of the node browsed on the lost
+ *                           connection are requested again after the reconnection, the nodes collected before are kept. Empty - no recovery.
  * @return Request execution status.
  */
-[[maybe_unused]] StatusResults GrabChildNodeIdsFromStartNodeId(UA_Client* client, const UATypesContainer<UA_ExpandedNodeId>& start_node_id, std::vector<UATypesContainer<UA_ExpandedNodeId>>& out);
+[[maybe_unused]] StatusResults GrabChildNodeIdsFromStartNodeId(
+    UA_Client* client,
+    const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+    std::vector<UATypesContainer<UA_ExpandedNodeId>>& out,
+    discovery::DiscoveryFilter* filter = nullptr,
+    const UA_ViewDescription* view = nullptr,
+    const SessionRecovery& session_recovery = {});
 
 } // namespace nodesetexporter::open62541::browseoperations
 
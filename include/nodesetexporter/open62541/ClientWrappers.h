@@ -10,10 +10,15 @@
 #define NODESETEXPORTER_OPEN62541_CLIENTWRAPPERS_H
 
 #include "nodesetexporter/interfaces/IOpen62541.h"
+#include "nodesetexporter/open62541/RateLimiter.h"
 
 #include <open62541/client_highlevel.h>
 
+#include <chrono>
 #include <functional>
+#include <optional>
+#include <stop_token>
+#include <string_view>
 
 namespace nodesetexporter::open62541
 {
@@ -27,12 +32,40 @@ using nodesetexporter::open62541::typealiases::UAVariantToStdVariant;
 using nodesetexporter::open62541::typealiases::VariantsOfAttr;
 
 
+/**
+ * @brief The policy of the recovery of the session when the connection is lost during the request (BadConnectionClosed, BadSessionIdInvalid, etc.).
+ *        The session is re-established by the "reconnect" function and the interrupted request is re-issued. The references of the interrupted Browse
+ *        are requested again from the beginning, since the continuation points of the lost session are not valid in the new one.
+ * @param reconnect The function that connects the client to the server again (for example, UA_Client_connect with the endpoint and the credentials).
+ *                  Empty - the recovery is disabled.
+ * @param max_attempts_per_request The maximum number of the reconnections for one request.
+ * @param retry_budget The maximum number of the reconnections during the life of the wrapper (the whole export).
+ * @param initial_backoff The pause before the first reconnection, doubled on each next attempt of the request.
+ * @param max_backoff The maximum pause before the reconnection.
+ */
+struct SessionRecoveryPolicy
+{
+    std::function<UA_StatusCode(UA_Client&)> reconnect;
+    std::uint32_t max_attempts_per_request = 3;
+    std::uint32_t retry_budget = 10; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::chrono::milliseconds initial_backoff{1000}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::chrono::milliseconds max_backoff{30000}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+};
+
 class Open62541ClientWrapper final : public IOpen62541
 {
 public:
-    explicit Open62541ClientWrapper(UA_Client& ua_client, LoggerBase& logger)
+    /**
+     * @brief Constructor of the client wrapper.
+     * @param ua_client The connected Open62541 client.
+     * @param logger Logging methods.
+     * @param stop_token Token for the interruption of the pause between the reconnection attempts (see SetSessionRecoveryPolicy). The requests themselves
+     *                   are not interrupted, the export stops between the batches. By default, the stop is never requested. [optional]
+     */
+    explicit Open62541ClientWrapper(UA_Client& ua_client, LoggerBase& logger, std::stop_token stop_token = {})
         : IOpen62541(logger)
         , m_ua_client(ua_client)
+        , m_stop_token(std::move(stop_token))
     {
     }
     ~Open62541ClientWrapper() override = default;
@@ -47,7 +80,7 @@ private:
      * @warning It has a limitation; in one call it performs a complete selection of only one continuation_point (or one parent node).
      * @param continuation_point An object representing the description of the possibility of further reading data in portions.
      * @param result_nodes Array where the references of the node being retrieved will be written.
-     * @return Request execution status.
+     * @return Request execution status. The stop request does not interrupt the selection, the references of the node are always complete.
      */
     [[nodiscard]] StatusResults BrowseNext(UA_ByteString* continuation_point, std::vector<UATypesContainer<UA_ReferenceDescription>>& result_nodes);
 
@@ -59,6 +92,67 @@ private:
      */
     [[nodiscard]] StatusResults ReadNodesAttributes(std::vector<UA_ReadValueId>& read_value_ids, const std::function<void(size_t, UA_DataValue&, UA_NodeId&, UA_UInt32)>& set_data);
 
+    /**
+     * @brief Browsing of the references of the batch of nodes with BrowseNext of the continuation points (one attempt, see ReadNodeReferences).
+     */
+    [[nodiscard]] StatusResults BrowseReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists);
+
+    /**
+     * @brief Executing of the request with the recovery of the session (see SessionRecoveryPolicy). The request must be repeatable: it is executed again as a whole
+     *        after the reconnection, if the connection or the session was lost (the status code of the service is kept in m_last_service_result).
+     * @param operation The name of the operation for the log.
+     * @param request The request.
+     * @return The result of the last execution of the request.
+     */
+    [[nodiscard]] StatusResults WithSessionRecovery(std::string_view operation, const std::function<StatusResults()>& request);
+
+    /**
+     * @brief The pause (the backoff, interrupted by the stop request) and the reconnection of the client.
+     * @param attempt The number of the attempt of the request, from 0.
+     * @return Good if the session is re-established.
+     */
+    [[nodiscard]] StatusResults RecoverSession(std::uint32_t attempt);
+
+    /**
+     * @brief Whether the status code of the service means the loss of the connection, of the secure channel or of the session.
+     */
+    [[nodiscard]] static bool IsSessionLost(UA_StatusCode status_code);
+
+    /**
+     * @brief The pause, interrupted by the stop request.
+     * @return False if the stop was requested.
+     */
+    bool WaitFor(ratelimit::Clock::duration duration);
+
+    /**
+     * @brief Waiting for the permission of the rate limiter before the request (see SetRateLimits).
+     * @param number_of_operations The number of the operations of the request.
+     * @return The time of the sending of the request, used by AccountResponse.
+     */
+    ratelimit::Clock::time_point ThrottleRequest(size_t number_of_operations);
+
+    /**
+     * @brief Waiting for the permission of the rate limiter only, without the sampling of the load of the server.
+     * @return The time of the sending of the request.
+     */
+    ratelimit::Clock::time_point AcquireRequest(size_t number_of_operations);
+
+    /**
+     * @brief Accounting of the response by the rate limiter: the latency, the size (if the bytes are limited) and the overload of the server
+     *        (BadTooManyOperations, BadResourceUnavailable, BadTimeout).
+     * @param request_time The result of ThrottleRequest.
+     * @param number_of_operations The number of the operations of the request.
+     * @param response The response of the service, the service is determined by its type (UA_ResponseHeader - the reading of the value).
+     * @param response_type The type of the response.
+     */
+    void AccountResponse(ratelimit::Clock::time_point request_time, size_t number_of_operations, const void* response, const UA_DataType& response_type);
+
+    /**
+     * @brief Reading of the state of the server in the adaptive mode of the rate limiter: the state of ServerStatus and RejectedRequestsCount
+     *        of ServerDiagnosticsSummary (if the diagnostics of the server is enabled). The reading goes through the rate limiter as the other requests.
+     */
+    void SampleServerLoad();
+
 public:
     /**
      * @brief Method for querying class attributes of a set of nodes.
@@ -99,6 +193,21 @@ public:
      */
     [[nodiscard]] StatusResults ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value) override;
 
+    /**
+     * @brief Method for querying a part of the one-dimensional array value of a single node.
+     * @remark Attribute Service Set, Sync - UA_Client_Service_read with the IndexRange of the ReadValueId.
+     * @param node_id The node for which the value is requested.
+     * @param first_index Index of the first requested element of the array.
+     * @param number_of_elements Number of the requested elements.
+     * @param data_value [out] The part of the array. Empty if the array has no elements starting from first_index (Bad_IndexRangeNoData).
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodeDataValueRange(
+        const UATypesContainer<UA_ExpandedNodeId>& node_id,
+        size_t first_index,
+        size_t number_of_elements,
+        UATypesContainer<UA_Variant>& data_value) override;
+
     /**
      * @brief The method specifies the maximum number of references to return for each starting node specified in the request.
      *        If specified during the Browsing request, no more than the specified number of links is returned.
@@ -119,9 +228,72 @@ public:
         return m_requested_max_references_per_node;
     }
 
+    /**
+     * @brief Sets the View that limits the browsing of the references in the ReadNodeReferences request: only the references and the nodes of the View
+     *        are returned by the server. By default (the null ViewId), the whole address space is browsed.
+     *        The ViewId must be the node of the View class, the timestamp and the version select the state of the View (0 - the current one).
+     */
+    void SetView(const UATypesContainer<UA_ViewDescription>& view)
+    {
+        m_view = view;
+    }
+
+    /**
+     * @brief Sets the policy of the recovery of the session when the connection is lost during the request. By default, the recovery is disabled.
+     */
+    void SetSessionRecoveryPolicy(SessionRecoveryPolicy session_recovery_policy)
+    {
+        m_session_recovery_policy = std::move(session_recovery_policy);
+    }
+
+    /**
+     * @brief Executing of the request made directly with the client (for example, the browsing of the nodes for the export,
+     *        see browseoperations::GrabChildNodeIdsFromStartNodeId) with the recovery of the session of the wrapper (see SetSessionRecoveryPolicy).
+     *        The reconnections are counted in the same budget as the ones of the requests of the wrapper.
+     * @param operation The name of the operation for the log.
+     * @param request The repeatable request, returns the status code of the service.
+     * @return The status code of the last execution of the request.
+     */
+    [[nodiscard]] UA_StatusCode CallWithSessionRecovery(std::string_view operation, const std::function<UA_StatusCode()>& request);
+
+    /**
+     * @brief The number of the successful recoveries of the session.
+     */
+    [[nodiscard]] std::uint32_t GetNumberOfRecoveredSessions() const noexcept
+    {
+        return m_number_of_recovered_sessions;
+    }
+
+    /**
+     * @brief Sets the limits of the rate of the requests. By default, the rate is not limited.
+     */
+    void SetRateLimits(const ratelimit::RateLimits& rate_limits)
+    {
+        m_rate_limiter = ratelimit::RateLimiter(rate_limits);
+        m_server_load_sample_time = {};
+        m_rejected_requests_count.reset();
+    }
+
+    /**
+     * @brief The current share of the rate of the adaptive rate limiter, 1 - the full rate.
+     */
+    [[nodiscard]] double GetThrottleFactor() const noexcept
+    {
+        return m_rate_limiter.GetThrottleFactor();
+    }
+
 private:
     UA_Client& m_ua_client;
+    std::stop_token m_stop_token;
     std::uint32_t m_requested_max_references_per_node = 0;
+    UATypesContainer<UA_ViewDescription> m_view{UA_TYPES_VIEWDESCRIPTION};
+    SessionRecoveryPolicy m_session_recovery_policy{};
+    UA_StatusCode m_last_service_result = UA_STATUSCODE_GOOD; // The status code of the last failed service call.
+    std::uint32_t m_number_of_reconnections = 0; // Spent from the retry budget.
+    std::uint32_t m_number_of_recovered_sessions = 0;
+    ratelimit::RateLimiter m_rate_limiter{};
+    ratelimit::Clock::time_point m_server_load_sample_time{};
+    std::optional<UA_UInt32> m_rejected_requests_count{};
 };
 
 } // namespace nodesetexporter::open62541
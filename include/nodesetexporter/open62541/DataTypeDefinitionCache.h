@@ -0,0 +1,162 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_DATATYPEDEFINITIONCACHE_H
+#define NODESETEXPORTER_OPEN62541_DATATYPEDEFINITIONCACHE_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/interfaces/IOpen62541.h"
+#include "nodesetexporter/open62541/TypeAliases.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tinyxml2
+{
+class XMLElement;
+} // namespace tinyxml2
+
+namespace nodesetexporter::open62541
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using nodesetexporter::interfaces::IOpen62541;
+using ::nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::typealiases::VariantsOfAttr;
+
+/**
+ * @brief Cache of the DataTypeDefinition of the data types for one export session.
+ *        The servers that do not support the DataTypeDefinition attribute (for example, on the Open62541 1.3 library) describe the structures and enumerations
+ *        in the legacy DataTypeDictionary (OPC Binary, Part 5 Annex D): DataType --HasEncoding--> "Default Binary" --HasDescription--> DataTypeDescription,
+ *        which is a component of the DataTypeDictionary variable with the dictionary XML in the value.
+ *        The dictionary is requested and parsed once, the definitions of all its types are stored, so the following data types (and the deep hierarchies
+ *        of the structures referencing each other) are resolved without the requests.
+ *        The cache also keeps the aliases of the standard data types of the definition fields for each DataType node.
+ * @warning Not thread-safe. The requests are executed through the synchronous IOpen62541.
+ */
+class DataTypeDefinitionCache final
+{
+public:
+    using FieldDataTypeAliases = std::vector<std::pair<std::string, UATypesContainer<UA_NodeId>>>;
+
+    DataTypeDefinitionCache(IOpen62541& open62541_lib, LoggerBase& logger)
+        : m_open62541_lib(open62541_lib)
+        , m_logger(logger)
+    {
+    }
+    ~DataTypeDefinitionCache() = default;
+    DataTypeDefinitionCache(DataTypeDefinitionCache&) = delete;
+    DataTypeDefinitionCache(DataTypeDefinitionCache&&) = delete;
+    DataTypeDefinitionCache& operator=(const DataTypeDefinitionCache& obj) = delete;
+    DataTypeDefinitionCache& operator=(DataTypeDefinitionCache&& obj) = delete;
+
+    /**
+     * @brief Getting the definitions of the data types from the DataTypeDictionary. The dictionaries that are not in the cache are requested and parsed.
+     *        The data types without the binary encoding or the description in the dictionary receive std::nullopt, they are not requested again.
+     * @param data_type_ids NodeIDs of the DataType nodes.
+     * @param definitions [out] The definitions (UA_StructureDefinition) in the size and order of data_type_ids.
+     * @return Request execution status. Fail only in case of the request error, the errors of the dictionary content are logged as warnings.
+     */
+    [[nodiscard]] StatusResults ResolveFromDictionaries(const std::vector<UATypesContainer<UA_ExpandedNodeId>>& data_type_ids, std::vector<std::optional<VariantsOfAttr>>& definitions);
+
+    /**
+     * @brief Aliases of the standard (ns=0) data types of the definition fields. They are calculated once for each DataType node.
+     * @param data_type_id NodeID of the DataType node.
+     * @param definition The DataTypeDefinition of the node.
+     * @return Pairs of the alias and the NodeID of the data type, each alias once.
+     */
+    [[nodiscard]] const FieldDataTypeAliases& GetFieldDataTypeAliases(const UATypesContainer<UA_ExpandedNodeId>& data_type_id, const VariantsOfAttr& definition);
+
+    /**
+     * @brief Number of the data types with the resolved definition in the cache.
+     */
+    [[nodiscard]] size_t GetNumberOfDefinitions() const noexcept
+    {
+        return m_number_of_definitions;
+    }
+
+private:
+    // Resolving of the name of the type of the dictionary (without the prefix) into the NodeID of the DataType.
+    using TypeNameResolver = std::function<std::optional<UATypesContainer<UA_NodeId>>(std::string_view type_name)>;
+
+    /**
+     * @brief Browsing of the single target of the reference for each node.
+     * @param node_ids The source nodes.
+     * @param reference_type_id The numeric NodeID of the reference type (ns=0).
+     * @param is_forward The direction of the reference.
+     * @param browse_name The BrowseName of the target, empty - any.
+     * @param targets [out] The targets in the size and order of node_ids, std::nullopt if the reference is missing.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults BrowseTargets(
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+        UA_UInt32 reference_type_id,
+        bool is_forward,
+        std::string_view browse_name,
+        std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>>& targets);
+
+    /**
+     * @brief Finding the DataTypeDictionary nodes that describe the data types.
+     * @param data_type_ids NodeIDs of the DataType nodes.
+     * @param dictionary_ids [out] Unique NodeIDs of the dictionaries.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults FindDictionaries(const std::vector<UATypesContainer<UA_ExpandedNodeId>>& data_type_ids, std::vector<UATypesContainer<UA_ExpandedNodeId>>& dictionary_ids);
+
+    /**
+     * @brief Requesting and parsing of the dictionary, the definitions of all its data types are added to the cache.
+     * @param dictionary_id NodeID of the DataTypeDictionary node.
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults LoadDictionary(const UATypesContainer<UA_ExpandedNodeId>& dictionary_id);
+
+    /**
+     * @brief Parsing of the structures of the OPC Binary type dictionary (opc:TypeDictionary). The enumerations have no binary encoding and are not linked
+     *        to their DataType nodes through the dictionary, the fields of such types receive the Enumeration data type.
+     * @param xml Text of the dictionary.
+     * @param resolve_type_name Resolving of the names of the types of the target namespace of the dictionary.
+     * @param definitions [out] The definitions by the names of the types.
+     * @return Parsing status.
+     */
+    [[nodiscard]] StatusResults ParseTypeDictionary(const std::string& xml, const TypeNameResolver& resolve_type_name, std::map<std::string, VariantsOfAttr>& definitions) const;
+
+    /**
+     * @brief Converting opc:StructuredType into UA_StructureDefinition. The length fields of the arrays and the encoding mask bits are not the fields of the definition.
+     */
+    [[nodiscard]] std::optional<VariantsOfAttr> ParseStructuredType(
+        const tinyxml2::XMLElement& xml_type,
+        const std::function<std::optional<UATypesContainer<UA_NodeId>>(const char*)>& resolve_qualified_name) const;
+
+    /**
+     * @brief NodeID of the standard data type by the name of the type of the OPC Binary or OPC UA namespace, for example "Int32", "CharArray", "ExtensionObject".
+     */
+    [[nodiscard]] static std::optional<UATypesContainer<UA_NodeId>> GetStandardDataTypeNodeId(std::string_view type_name);
+
+    IOpen62541& m_open62541_lib;
+    LoggerBase& m_logger;
+    // Definitions of the data types, std::nullopt - the data type has no definition in the dictionaries.
+    std::unordered_map<UATypesContainer<UA_NodeId>, std::optional<VariantsOfAttr>> m_definitions;
+    // The dictionaries already requested (including unsuccessfully).
+    std::unordered_set<UATypesContainer<UA_NodeId>> m_loaded_dictionaries;
+    std::unordered_map<UATypesContainer<UA_NodeId>, FieldDataTypeAliases> m_field_data_type_aliases;
+    size_t m_number_of_definitions = 0;
+};
+
+} // namespace nodesetexporter::open62541
+
+#endif // NODESETEXPORTER_OPEN62541_DATATYPEDEFINITIONCACHE_H
@@ -0,0 +1,154 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_DISCOVERYRULES_H
+#define NODESETEXPORTER_OPEN62541_DISCOVERYRULES_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <open62541/types.h>
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The include/exclude rules of the collecting of the nodes for the export (see browseoperations::GrabChildNodeIdsFromStartNodeId). The rules are evaluated
+ * for each child node before it is added to the list, so the excluded node and its whole subtree are never browsed, read and encoded.
+ * The rules are checked in the order of the declaration, the first matched rule decides. The node that does not match any rule is included.
+ *
+ * The text form of the rule: "<include|exclude> <criterion>=<value> ...", all criteria of the rule must match:
+ *   name=<glob>           - the name of BrowseName, '*' - any sequence of the symbols, '?' - any symbol;
+ *   nameregex=<regex>     - the name of BrowseName matches the regular expression (ECMAScript) completely;
+ *   ns=<index>            - the namespace index of the NodeId;
+ *   nodeid=<regex>        - the text form of the NodeId matches the regular expression completely, for example "ns=2;s=Debug\..*";
+ *   class=<class>[|...]   - the node class: Object, Variable, Method, ObjectType, VariableType, ReferenceType, DataType, View;
+ *   reftype=<type>        - the type of the reference from the parent: the name of the standard hierarchical type (Organizes, HasComponent...) or the NodeId;
+ *   maxdepth=<depth>      - the node is deeper than the depth (the children of the start node have the depth 1).
+ * For example: "exclude name=Diagnostics*", "exclude ns=3 class=Variable", "exclude maxdepth=5".
+ */
+namespace nodesetexporter::open62541::discovery
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+
+enum class RuleAction
+{
+    Include,
+    Exclude
+};
+
+/**
+ * @brief The rule of the collecting of the nodes. Not set criteria match any node.
+ * @param text The text form of the rule, used in the report.
+ * @param action The action for the matched node.
+ * @param browse_name_glob The glob of the name of BrowseName.
+ * @param browse_name_regex The regular expression of the name of BrowseName.
+ * @param namespace_index The namespace index of the NodeId.
+ * @param node_id_regex The regular expression of the text form of the NodeId.
+ * @param node_class_mask The mask of the node classes (the values of UA_NodeClass), 0 - any class.
+ * @param reference_type_id The type of the reference from the parent node, the subtypes are not matched.
+ * @param max_depth The rule matches the nodes deeper than the depth.
+ */
+struct DiscoveryRule
+{
+    std::string text{};
+    RuleAction action = RuleAction::Exclude;
+    std::optional<std::string> browse_name_glob{};
+    std::optional<std::regex> browse_name_regex{};
+    std::optional<UA_UInt16> namespace_index{};
+    std::optional<std::regex> node_id_regex{};
+    UA_UInt32 node_class_mask = 0;
+    std::optional<UATypesContainer<UA_NodeId>> reference_type_id{};
+    std::optional<size_t> max_depth{};
+};
+
+/**
+ * @brief The child node found by the browsing, the subject of the rules.
+ * @param node_id The NodeId of the child node.
+ * @param browse_name BrowseName of the child node.
+ * @param node_class The class of the child node.
+ * @param reference_type_id The type of the reference from the parent node to the child node.
+ * @param depth The depth of the child node from the start node, the children of the start node have the depth 1.
+ */
+struct DiscoveryCandidate
+{
+    const UA_NodeId& node_id;
+    const UA_QualifiedName& browse_name;
+    UA_NodeClass node_class;
+    const UA_NodeId& reference_type_id;
+    size_t depth;
+};
+
+/**
+ * @brief The set of the rules with the counters of the matched nodes. Not thread-safe, used by the one collecting of the nodes at a time.
+ */
+class DiscoveryFilter
+{
+public:
+    DiscoveryFilter() = default;
+    explicit DiscoveryFilter(std::vector<DiscoveryRule> rules);
+
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return !m_rules.empty();
+    }
+
+    /**
+     * @brief Evaluation of the rules for the child node. The counter of the matched rule is increased.
+     * @return True - the node is added to the list, False - the node and its subtree are pruned.
+     */
+    [[nodiscard]] bool Accept(const DiscoveryCandidate& candidate);
+
+    /**
+     * @brief The number of the nodes matched by each rule, in the order of the rules.
+     */
+    [[nodiscard]] const std::vector<size_t>& GetHits() const noexcept
+    {
+        return m_hits;
+    }
+
+    /**
+     * @brief Output of the counters of the rules to the log.
+     */
+    void ReportHits(LoggerBase& logger) const;
+
+private:
+    [[nodiscard]] static bool IsMatched(const DiscoveryRule& rule, const DiscoveryCandidate& candidate);
+
+    std::vector<DiscoveryRule> m_rules;
+    std::vector<size_t> m_hits;
+};
+
+/**
+ * @brief Matching of the text with the glob: '*' - any sequence of the symbols (also empty), '?' - any symbol, the other symbols match themselves.
+ */
+[[nodiscard]] bool GlobMatch(std::string_view pattern, std::string_view text) noexcept;
+
+/**
+ * @brief Parsing of the text form of the rule (see the description of the namespace).
+ * @param text The text of the rule.
+ * @param rule [out] The rule.
+ * @param logger Logging methods, the errors of the parsing are reported.
+ * @return Fail if the action or the criterion is unknown, the value is invalid or the rule has no criteria.
+ */
+StatusResults ParseDiscoveryRule(std::string_view text, DiscoveryRule& rule, LoggerBase& logger);
+
+/**
+ * @brief The rule that excludes the nodes deeper than the depth.
+ */
+[[nodiscard]] DiscoveryRule MakeMaxDepthRule(size_t max_depth);
+
+} // namespace nodesetexporter::open62541::discovery
+
+#endif // NODESETEXPORTER_OPEN62541_DISCOVERYRULES_H
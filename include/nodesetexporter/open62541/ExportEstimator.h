@@ -0,0 +1,125 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_EXPORTESTIMATOR_H
+#define NODESETEXPORTER_OPEN62541_EXPORTESTIMATOR_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/DiscoveryRules.h"
+#include "nodesetexporter/open62541/TransportProfile.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <open62541/client.h>
+
+#include <chrono>
+#include <map>
+#include <sys/types.h>
+
+/**
+ * The estimation of the export before it is started (the dry run). Only the discovery of the subtrees is performed: all children of each level are browsed,
+ * or only the random part of them, and then the number of the nodes is extrapolated. By the number of the nodes and by the measured cost of the browsing
+ * the number of the requests, the size of the responses and of the output, the duration of the export and the number of the nodes per request are forecast.
+ */
+namespace nodesetexporter::open62541::estimation
+{
+
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+
+// The requests of the export for one batch of the nodes: NodeClass, the attributes, the values of the variables and the references.
+constexpr u_int32_t requests_per_batch = 4;
+// The memory budget of one batch: the intermediate models of the nodes of the batch are kept in memory until they are encoded.
+constexpr u_int64_t batch_memory_budget = 256ULL * 1024 * 1024;
+// The estimation of the memory of the intermediate model of one node (the attributes, the references and the value).
+constexpr u_int64_t estimated_model_bytes_per_node = 4096;
+// The estimation of the encoding time of one node by XMLEncoder.
+constexpr std::chrono::microseconds estimated_encode_time_per_node{20};
+// The estimation of the throughput of the connection if the browsing was not measured.
+constexpr double default_bytes_per_second = 10.0 * 1024 * 1024;
+
+/**
+ * @brief The census of the subtrees of the start nodes. The numbers of the nodes are extrapolated by the sampling, so they are fractional.
+ * @param number_of_nodes The estimated number of the nodes, including the start nodes.
+ * @param nodes_per_class, nodes_per_namespace The estimated number of the nodes by the node class and by the namespace index.
+ * @param number_of_browsed_nodes The number of the nodes that were actually browsed.
+ * @param number_of_browse_requests, browse_response_bytes, browse_time The measured cost of the browsing: the number of the Browse requests,
+ *        the encoded size of the received references and the total time of the requests.
+ */
+struct SubtreeCensus
+{
+    double number_of_nodes = 0;
+    std::map<UA_NodeClass, double> nodes_per_class;
+    std::map<UA_UInt16, double> nodes_per_namespace;
+    size_t number_of_browsed_nodes = 0;
+    size_t number_of_browse_requests = 0;
+    size_t browse_response_bytes = 0;
+    std::chrono::steady_clock::duration browse_time{};
+};
+
+/**
+ * @brief The forecast of the export.
+ * @param number_of_exported_nodes The nodes that get to the output (the Method and the View nodes are not exported).
+ * @param batch_size The number of the nodes per request of the data (configured or picked, see PickBatchSize).
+ * @param number_of_requests, response_bytes The requests of the export and the size of their responses.
+ * @param output_bytes The size of the NodeSet file.
+ * @param runtime The duration of the export.
+ */
+struct ExportEstimate
+{
+    double number_of_exported_nodes = 0;
+    u_int32_t batch_size = 0;
+    double number_of_requests = 0;
+    double response_bytes = 0;
+    double output_bytes = 0;
+    std::chrono::steady_clock::duration runtime{};
+};
+
+/**
+ * @brief The census of the subtree of the start node by the level-by-level browsing. On each level only the random part of the nodes is browsed
+ *        (at least one node of the level), each browsed node represents level_size / sample_size nodes of its level, so the counts of the children
+ *        are extrapolated by the weights of their parents. With the fraction 1 the subtree is browsed completely and the counts are exact.
+ * @param client The connected Open62541 client.
+ * @param start_node_id The start node, it is counted with the weight 1.
+ * @param fraction The part of the nodes of the level that is browsed, (0, 1].
+ * @param seed The seed of the random selection, the same seed gives the same estimation of the same address space.
+ * @param census The census, the counts of the subtree are added to it.
+ * @param filter, view The include/exclude rules and the View of the discovery (see browseoperations::GrabChildNodeIdsFromStartNodeId).
+ * @return Fail if the Browse service fails.
+ */
+StatusResults SampleSubtree(
+    UA_Client* client,
+    const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+    double fraction,
+    u_int32_t seed,
+    SubtreeCensus& census,
+    LoggerBase& logger,
+    discovery::DiscoveryFilter* filter = nullptr,
+    const UA_ViewDescription* view = nullptr);
+
+/**
+ * @brief The number of the nodes per request of the data for the subtree: the limits of the server (see transport::DeriveNumberOfMaxNodesToRequestData),
+ *        the memory budget of the batch and the number of the nodes, so that the small export is made in one batch.
+ * @return The number of the nodes, at least 1.
+ */
+[[nodiscard]] u_int32_t PickBatchSize(double number_of_nodes, const transport::RequestLimits& limits);
+
+/**
+ * @brief The forecast of the export of the subtrees.
+ * @param batch_size The configured number of the nodes per request, 0 - picked by PickBatchSize.
+ */
+[[nodiscard]] ExportEstimate Forecast(const SubtreeCensus& census, const transport::RequestLimits& limits, u_int32_t batch_size);
+
+/**
+ * @brief Logging of the census and of the forecast.
+ */
+void ReportEstimate(const SubtreeCensus& census, const ExportEstimate& estimate, LoggerBase& logger);
+
+} // namespace nodesetexporter::open62541::estimation
+
+#endif // NODESETEXPORTER_OPEN62541_EXPORTESTIMATOR_H
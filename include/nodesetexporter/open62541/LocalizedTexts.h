@@ -0,0 +1,56 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_LOCALIZEDTEXTS_H
+#define NODESETEXPORTER_OPEN62541_LOCALIZEDTEXTS_H
+
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <open62541/client.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The export of the localized attributes (DisplayName, Description) in several locales. The Read service has no locales of its own, the server selects the locale
+ * of LocalizedText by the locales of the session (ActivateSession). With the locale "mul" (OPC UA 1.05, Part 3, LocalizedText) the server returns all translations
+ * of the text in one value: the locale "mul" and the text in the form {"t":[["en","Text"],["de","Text"]]}. So all locales are received by the same Read requests
+ * of the attributes and the number of the requests does not grow. The server that does not support "mul" selects the next locale of the session,
+ * i.e. the first of the requested locales that it has.
+ */
+namespace nodesetexporter::open62541::locales
+{
+
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+
+constexpr std::string_view multi_locale_id = "mul";
+
+/**
+ * @brief Setting the locales of the session of the client: "mul" and then the requested locales in the order of the preference.
+ *        Must be called before the connection, the locales are passed to the server by ActivateSession (also on the reconnection).
+ * @param config The configuration of the client.
+ * @param locales The requested locales, for example "en", "de-DE". Empty list - the configuration is not changed.
+ * @return Fail if the locale is empty or the memory is not allocated.
+ */
+StatusResults ApplySessionLocales(UA_ClientConfig& config, const std::vector<std::string>& locales);
+
+/**
+ * @brief Splitting of the text received with the locale "mul" into the texts of the separate locales.
+ * @param text The value of the localized attribute. The text of the other locale is returned as is.
+ * @param locales The requested locales. The translations are returned in the order of the requested locales, the other translations are dropped.
+ *                If none of the requested locales is present (or the list is empty), all translations are returned in the order of the server.
+ * @param out [out] The texts of the locales, the first one is the main text of the attribute.
+ * @return Fail if the text with the locale "mul" is not in the expected form.
+ */
+StatusResults SplitMultiLocaleText(const UA_LocalizedText& text, const std::vector<std::string>& locales, std::vector<UATypesContainer<UA_LocalizedText>>& out);
+
+} // namespace nodesetexporter::open62541::locales
+
+#endif // NODESETEXPORTER_OPEN62541_LOCALIZEDTEXTS_H
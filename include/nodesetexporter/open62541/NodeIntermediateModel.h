@@ -15,6 +15,7 @@
 
 #include <open62541/types_generated_handling.h>
 
+#include <functional>
 #include <map>
 #include <optional>
 #include <vector>
@@ -43,6 +44,11 @@ using ::nodesetexporter::open62541::typealiases::VariantsOfAttrToString;
 class NodeIntermediateModel
 {
 public:
+    // Handler of the next part of the array value. Returns false to stop the reading.
+    using ValueChunkHandler = std::function<bool(const UA_Variant& chunk)>;
+    // Reading of the array value in parts: each part is passed to the handler in the order of the elements. Returns false if the reading or the handler failed.
+    using ValueChunkReader = std::function<bool(const ValueChunkHandler& handler)>;
+
     NodeIntermediateModel()
         : m_node_id(UATypesContainer<UA_ExpandedNodeId>(UA_TYPES_EXPANDEDNODEID))
         , m_parent_node_id(UATypesContainer<UA_ExpandedNodeId>(UA_TYPES_EXPANDEDNODEID))
@@ -173,6 +179,28 @@ public:
         m_attributes = attributes;
     }
 
+    /**
+     * @brief Moves the texts of the localized attribute (DisplayName, Description) in the several locales. The attribute itself keeps the main text,
+     *        the encoder writes all texts instead of it.
+     * @param attr_id The localized attribute.
+     * @param texts The texts in the order of the output, one per locale.
+     */
+    void SetLocalizedTexts(UA_AttributeId attr_id, std::vector<UATypesContainer<UA_LocalizedText>>&& texts)
+    {
+        m_localized_texts.insert_or_assign(attr_id, std::move(texts));
+    }
+
+    /**
+     * @brief Sets the reading of the array value in parts. Used instead of the UA_ATTRIBUTEID_VALUE attribute for the large arrays,
+     *        so that the value is read from the server by the encoder when it writes the document and is not held in memory entirely.
+     *        The encoder keeps a copy of the reader until the end of the document, so the reader must not refer to the node model.
+     * @param reader The function of reading the parts of the value.
+     */
+    void SetValueChunkReader(ValueChunkReader&& reader)
+    {
+        m_value_chunk_reader = std::move(reader);
+    }
+
     /**
      * @brief Returns the model's NodeID reference.
      */
@@ -214,11 +242,31 @@ public:
         return m_attributes;
     }
 
+    /**
+     * @brief Returns the texts of the localized attribute in the several locales.
+     * @return An empty list if the attribute has only the main text (see GetAttributes).
+     */
+    [[nodiscard]] const std::vector<UATypesContainer<UA_LocalizedText>>& GetLocalizedTexts(UA_AttributeId attr_id) const
+    {
+        static const std::vector<UATypesContainer<UA_LocalizedText>> no_texts;
+        const auto texts = m_localized_texts.find(attr_id);
+        return texts != m_localized_texts.end() ? texts->second : no_texts;
+    }
+
+    /**
+     * @brief Returns the reading of the array value in parts.
+     * @return An empty function object if the value is passed in the UA_ATTRIBUTEID_VALUE attribute.
+     */
+    [[nodiscard]] const ValueChunkReader& GetValueChunkReader() const
+    {
+        return m_value_chunk_reader;
+    }
+
     /**
      * @brief Returns a text description of the data type being stored. Valid only for Variable and VariableType nodes.
      * @return Alias for the data types that the node stores. If the data type is not found, an empty string object will be returned. Currently only standard data types are supported.
      * Custom types will be returned as a text description of the NodeID, for example: ns=1;i=2.
-     * @warning When the function is called, the NodeIntermediateModel class object must have the UA_ATTRIBUTEID_DATATYPE attribute value set, otherwise an empty string will be returned.
+     * @warning When the function is called, the NodeIntermediateModel class object must have the UA_ATTRIBUTEID_DATATYPE attribute value of the NodeId type set, otherwise an empty string will be returned.
      */
     [[nodiscard]] std::string GetDataTypeAlias() const
     {
@@ -227,29 +275,40 @@ public:
             return "";
         }
 
-        if (!m_attributes.contains(UA_AttributeId::UA_ATTRIBUTEID_DATATYPE))
+        const auto data_type_optional_variant = m_attributes.find(UA_AttributeId::UA_ATTRIBUTEID_DATATYPE);
+        if (data_type_optional_variant == m_attributes.end() || !data_type_optional_variant->second.has_value())
         {
             return "";
         }
-        auto data_type_optional_variant = m_attributes.at(UA_AttributeId::UA_ATTRIBUTEID_DATATYPE);
-        if (!data_type_optional_variant.has_value())
+        const auto* const data_type_node_id = std::get_if<UATypesContainer<UA_NodeId>>(&data_type_optional_variant->second.value());
+        if (data_type_node_id == nullptr)
         {
             return "";
         }
 
-        auto data_type_node_id = std::get<UATypesContainer<UA_NodeId>>(data_type_optional_variant.value());
+        return GetDataTypeAlias(data_type_node_id->GetRef());
+    }
+
+    /**
+     * @brief Returns a text description of the data type by its NodeID. Used for the DataType attribute of the nodes and for the fields of DataTypeDefinition.
+     * @param data_type_node_id NodeID of the data type.
+     * @return Alias of the standard data type or the text description of the NodeID for the other types, for example: ns=1;i=2.
+     */
+    [[nodiscard]] static std::string GetDataTypeAlias(const UA_NodeId& data_type_node_id)
+    {
         // Option using a library function. But as practice has shown, its array contains fewer types.
         // Trying to get a text alias of a standard type
         //        const UA_DataType* const data_type_alias = UA_findDataType( // todo Perhaps it needs to be cached, since UA_findDataType uses linear search (O(n) worst case) + comparison of NodeId
         //        structures
         //            &data_type_node_id.GetRef());
 
-        if (data_type_node_id.GetRef().namespaceIndex == 0 && data_type_aliases.contains(data_type_node_id.GetRef().identifier.numeric)) // NOLINT(cppcoreguidelines-pro-type-union-access)
+        if (data_type_node_id.namespaceIndex == 0 && data_type_node_id.identifierType == UA_NODEIDTYPE_NUMERIC
+            && data_type_aliases.contains(data_type_node_id.identifier.numeric)) // NOLINT(cppcoreguidelines-pro-type-union-access)
         {
             // Standard type
-            return data_type_aliases.at(data_type_node_id.GetRef().identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
+            return data_type_aliases.at(data_type_node_id.identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
         }
-        return data_type_node_id.ToString(); // Type not found, returning NodeID in text form.
+        return UATypesContainer<UA_NodeId>(data_type_node_id, UA_TYPES_NODEID).ToString(); // Type not found, returning NodeID in text form.
     }
 
     /**
@@ -304,6 +363,14 @@ public:
         {
             output.append("\nAttributeID: " + std::to_string(attributes.first) + " : " + (attributes.second.has_value() ? VariantsOfAttrToString(attributes.second.value()) : "none"));
         }
+        for (const auto& [attr_id, texts] : m_localized_texts)
+        {
+            output.append("\nLocalized texts of AttributeID: " + std::to_string(attr_id) + " :");
+            for (const auto& text : texts)
+            {
+                output.append(" " + text.ToString());
+            }
+        }
         return output;
     }
 
@@ -313,6 +380,8 @@ private:
     UA_NodeClass m_node_class = UA_NodeClass::UA_NODECLASS_UNSPECIFIED;
     std::vector<UATypesContainer<UA_ReferenceDescription>> m_references;
     std::map<UA_AttributeId, std::optional<VariantsOfAttr>> m_attributes;
+    std::map<UA_AttributeId, std::vector<UATypesContainer<UA_LocalizedText>>> m_localized_texts;
+    ValueChunkReader m_value_chunk_reader;
 };
 } // namespace nodesetexporter::open62541
 
@@ -0,0 +1,201 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_NODESETFILEWRAPPERS_H
+#define NODESETEXPORTER_OPEN62541_NODESETFILEWRAPPERS_H
+
+#include "nodesetexporter/interfaces/IOpen62541.h"
+#include "nodesetexporter/open62541/DiscoveryRules.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tinyxml2
+{
+class XMLElement;
+} // namespace tinyxml2
+
+namespace nodesetexporter::open62541
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using nodesetexporter::interfaces::IOpen62541;
+using ::nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::typealiases::VariantsOfAttr;
+
+/**
+ * @brief Implementation of IOpen62541 on top of a NodeSet2 XML file (UANodeSet.xsd) instead of the OPC UA server.
+ *        The file is parsed once into an indexed in-memory graph of the nodes, after which all the requests are answered from memory.
+ *        The references are returned in both directions, as by the Browse service: the reference declared only on one side
+ *        is synthesized as the inverse one on the other side (if both nodes are present in the file).
+ *        Allows to extract subtrees, re-filter or re-encode the ready-made nodesets without a server, and serves as a fast deterministic data source.
+ * @warning The namespace indices of the nodes are the indices of the NodeSet file: 0 - http://opcfoundation.org/UA/, 1 - the first Uri of NamespaceUris, etc.
+ *          The nodes of the OPC UA standard (ns=0) are available only if they are described in the file.
+ *          Only the values of the built-in scalar types and their ListOf arrays are supported (Boolean, integers, Float, Double, String, LocalizedText),
+ *          other values and the DataTypeDefinition attribute are returned as empty.
+ */
+class Open62541NodesetFileWrapper final : public IOpen62541
+{
+    /**
+     * @brief A reference of the node as it is stored in the index. The full UA_ReferenceDescription is formed upon request.
+     */
+    struct NodeReference
+    {
+        UATypesContainer<UA_NodeId> reference_type_id;
+        UATypesContainer<UA_NodeId> target_node_id;
+        bool is_forward;
+    };
+
+    /**
+     * @brief A node of the index: the class, the attributes available for the class (taking into account the default values of UANodeSet.xsd) and the references.
+     */
+    struct NodeRecord
+    {
+        UA_NodeClass node_class = UA_NODECLASS_UNSPECIFIED;
+        std::map<UA_AttributeId, VariantsOfAttr> attrs;
+        std::vector<NodeReference> references;
+    };
+
+public:
+    explicit Open62541NodesetFileWrapper(LoggerBase& logger)
+        : IOpen62541(logger)
+    {
+    }
+    ~Open62541NodesetFileWrapper() override = default;
+    Open62541NodesetFileWrapper(Open62541NodesetFileWrapper&) = delete;
+    Open62541NodesetFileWrapper(Open62541NodesetFileWrapper&&) = delete;
+    Open62541NodesetFileWrapper& operator=(const Open62541NodesetFileWrapper& obj) = delete;
+    Open62541NodesetFileWrapper& operator=(Open62541NodesetFileWrapper&& obj) = delete;
+
+    /**
+     * @brief Loading and indexing of the NodeSet2 XML file. The previously loaded data is replaced.
+     * @param filename Full path and name of the NodeSet2 XML file.
+     * @return Loading status. In case of an error, the index is empty.
+     */
+    [[nodiscard]] StatusResults LoadFromFile(const std::string& filename);
+
+    /**
+     * @brief Loading and indexing of the NodeSet2 XML document from memory. The previously loaded data is replaced.
+     * @param xml Text of the NodeSet2 XML document.
+     * @return Loading status. In case of an error, the index is empty.
+     */
+    [[nodiscard]] StatusResults LoadFromMemory(const std::string& xml);
+
+    /**
+     * @brief Namespace array in the form of the Server_NamespaceArray [i=2255] node: http://opcfoundation.org/UA/ and the NamespaceUris of the file.
+     */
+    [[nodiscard]] const std::vector<std::string>& GetNamespaceArray() const noexcept
+    {
+        return m_namespace_array;
+    }
+
+    /**
+     * @brief Number of the indexed nodes.
+     */
+    [[nodiscard]] size_t GetNumberOfNodes() const noexcept
+    {
+        return m_nodes.size();
+    }
+
+    /**
+     * @brief Collecting of the NodeId chain from the starting node in depth by the forward hierarchical references, similar to
+     *        browseoperations::GrabChildNodeIdsFromStartNodeId. Each node is added to the list once.
+     * @param start_node_id The starting node from which the list of nodes for export will be built. It is the first in the list.
+     * @param out [out] The list where the list of nodes for export will be built.
+     * @param filter The include/exclude rules evaluated for each child node before it is added to the list. nullptr - all nodes are collected.
+     * @return Execution status. Fail if the starting node is missing in the file.
+     */
+    [[nodiscard]] StatusResults GrabChildNodeIdsFromStartNodeId(
+        const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+        std::vector<UATypesContainer<UA_ExpandedNodeId>>& out,
+        discovery::DiscoveryFilter* filter = nullptr) const;
+
+    /**
+     * @brief Query of class attributes of a set of nodes. The missing nodes receive UA_NODECLASS_UNSPECIFIED and the result code BadNodeIdUnknown.
+     */
+    [[nodiscard]] StatusResults ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists) override;
+
+    /**
+     * @brief Query of references of multiple nodes in both directions (as Browse with UA_BROWSEDIRECTION_BOTH). The missing nodes receive an empty list.
+     */
+    [[nodiscard]] StatusResults ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists) override;
+
+    /**
+     * @brief Query of multiple attributes of multiple nodes. The attributes that are missing or not applicable to the node class receive an empty value.
+     */
+    [[nodiscard]] StatusResults ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists) override;
+
+    /**
+     * @brief Query of the value of a single node. Server_NamespaceArray [i=2255] is answered by the namespace array of the file.
+     */
+    [[nodiscard]] StatusResults ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value) override;
+
+    /**
+     * @brief Query of a part of the one-dimensional array value of a single node. Fail for the scalar values.
+     */
+    [[nodiscard]] StatusResults ReadNodeDataValueRange(
+        const UATypesContainer<UA_ExpandedNodeId>& node_id,
+        size_t first_index,
+        size_t number_of_elements,
+        UATypesContainer<UA_Variant>& data_value) override;
+
+private:
+    /**
+     * @brief Clearing of the index.
+     */
+    void Reset();
+
+    /**
+     * @brief Indexing of the loaded document.
+     */
+    StatusResults Load(const tinyxml2::XMLElement* ua_nodeset);
+
+    /**
+     * @brief Parsing of a node element (UAObject, UAVariable, etc.) into the index.
+     */
+    StatusResults LoadNode(const tinyxml2::XMLElement& xml_node, UA_NodeClass node_class);
+
+    /**
+     * @brief Adding the inverse references for the references declared only on one side.
+     */
+    void SynthesizeInverseReferences();
+
+    /**
+     * @brief Forming the list of the hierarchical reference types: the standard ones and their subtypes described in the file.
+     */
+    void CollectHierarchicalReferenceTypes();
+
+    /**
+     * @brief Converting the text NodeId or alias of the file into the NodeId.
+     * @return Empty (null) NodeId in case of a parsing error.
+     */
+    [[nodiscard]] UATypesContainer<UA_NodeId> ResolveNodeId(const char* text) const;
+
+    /**
+     * @brief Forming the reference description with the data of the target node, as it is returned by the Browse service.
+     */
+    [[nodiscard]] UATypesContainer<UA_ReferenceDescription> MakeReferenceDescription(const NodeReference& reference) const;
+
+    /**
+     * @brief Evaluation of the include/exclude rules for the target node of the hierarchical reference.
+     */
+    [[nodiscard]] static bool IsAcceptedByFilter(discovery::DiscoveryFilter& filter, const NodeReference& reference, const NodeRecord& target, size_t depth);
+
+    std::vector<std::string> m_namespace_array;
+    std::map<std::string, UATypesContainer<UA_NodeId>> m_aliases;
+    std::unordered_map<UATypesContainer<UA_NodeId>, NodeRecord> m_nodes;
+    std::unordered_set<UATypesContainer<UA_NodeId>> m_hierarchical_reference_types;
+};
+
+} // namespace nodesetexporter::open62541
+
+#endif // NODESETEXPORTER_OPEN62541_NODESETFILEWRAPPERS_H
@@ -0,0 +1,78 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_QUIRKFIXERS_H
+#define NODESETEXPORTER_OPEN62541_QUIRKFIXERS_H
+
+#include "nodesetexporter/interfaces/IQuirkFixer.h"
+
+#include <open62541/types.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The fixers of the deviations of the specific servers (see interfaces::IQuirkFixer). The fixers are enabled by the name for the endpoint
+ * or are selected by BuildInfo of the server (Server/ServerStatus/BuildInfo).
+ */
+namespace nodesetexporter::open62541::quirks
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using IQuirkFixer = ::nodesetexporter::interfaces::IQuirkFixer;
+using IOpen62541 = ::nodesetexporter::interfaces::IOpen62541;
+
+constexpr std::string_view kepserver_quirk_fixer_name = "kepserver";
+
+/**
+ * @brief The fixer of KEPServerEX (and the similar servers):
+ *        - the Variable nodes have HasTypeDefinition = BaseVariableType(62). The abstract type can't be used directly by the nodes of this class,
+ *          the import by nodesetloader fails. The type is replaced by the more specific, although still generic, but not abstract BaseDataVariableType(63);
+ *        - the nodes have no inverse references. The reference HasComponent to the parent is added, the parent is taken from the string identifier
+ *          of the node by removing the part after the last dot ("Channel.Device.Tag" -> "Channel.Device"). The identifier without the dots gets the Objects folder.
+ *          The reference types are not analyzed, the parent is in the same namespace as the child.
+ */
+class KepServerQuirkFixer final : public IQuirkFixer
+{
+public:
+    explicit KepServerQuirkFixer(LoggerBase& logger)
+        : IQuirkFixer(logger)
+    {
+    }
+
+    [[nodiscard]] std::string_view GetName() const noexcept override
+    {
+        return kepserver_quirk_fixer_name;
+    }
+
+    [[nodiscard]] StatusResults FixReferences(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res) override;
+
+private:
+    /**
+     * @brief The inverse reference HasComponent to the parent from the string identifier of the node. The identifier is split without the conversion to the text form.
+     */
+    [[nodiscard]] static UATypesContainer<UA_ReferenceDescription> MakeParentReference(const UA_ExpandedNodeId& exp_node_id);
+};
+
+/**
+ * @brief Creating the fixer by the name.
+ * @return The fixer or nullptr if the name is unknown.
+ */
+[[nodiscard]] std::unique_ptr<IQuirkFixer> MakeQuirkFixer(std::string_view name, LoggerBase& logger);
+
+/**
+ * @brief The names of the fixers needed by the server with the build information.
+ */
+[[nodiscard]] std::vector<std::string> DetectQuirkFixers(const UA_BuildInfo& build_info);
+
+} // namespace nodesetexporter::open62541::quirks
+
+#endif // NODESETEXPORTER_OPEN62541_QUIRKFIXERS_H
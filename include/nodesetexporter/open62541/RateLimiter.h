@@ -0,0 +1,186 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_RATELIMITER_H
+#define NODESETEXPORTER_OPEN62541_RATELIMITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+/**
+ * Limiting of the rate of the requests of the client, so that the export does not overload the small servers (for example, the embedded PLC servers
+ * with the watchdogs of the cycle). The limits are the token buckets of the requests, of the operations (the nodes of Read and Browse, the continuation points)
+ * and of the bytes of the responses. In the adaptive mode the rate is additionally reduced when the server is saturated: the latency of the responses
+ * grows, the server rejects the requests or is not in the Running state.
+ */
+namespace nodesetexporter::open62541::ratelimit
+{
+
+using Clock = std::chrono::steady_clock;
+
+// The minimum share of the rate in the adaptive mode.
+constexpr double min_throttle_factor = 1.0 / 32;
+// The latency of the response greater than the minimum one of the same requests in so many times means the saturation of the server.
+constexpr double saturation_latency_ratio = 3.0;
+// The smaller growth of the latency is not considered, the latency of the fast responses is not stable.
+constexpr std::chrono::milliseconds saturation_latency_margin{10};
+// The share of the rate is halved on the saturation not more often than once in this interval and is increased by this step per second
+// while the server is not saturated, so the halved rate is restored in 8 seconds regardless of the number of the responses.
+constexpr std::chrono::seconds throttle_decrease_interval{1};
+constexpr double throttle_factor_increase_per_second = 1.0 / 16;
+// The interval of the reading of the state of the server in the adaptive mode.
+constexpr std::chrono::seconds server_load_sampling_interval{1};
+
+/**
+ * @brief The service of the request. The latencies of the different services and of the different numbers of the operations are not comparable,
+ *        so the saturation is detected by the latency relative to the requests of the same service and of the same order of the number of the operations.
+ */
+enum class Service : std::uint8_t
+{
+    Read,
+    Browse,
+    BrowseNext
+};
+
+/**
+ * @brief The limits of the rate. Zero values - no limit.
+ * @param requests_per_second The maximum number of the requests per second.
+ * @param operations_per_second The maximum number of the operations per second (the attributes of Read, the nodes of Browse, the continuation points of BrowseNext).
+ * @param bytes_per_second The maximum number of the bytes of the responses per second.
+ * @param is_adaptive Reduce the rate when the server is saturated and restore it gradually when the server is not saturated (AIMD). The reduced share of the rate
+ *                    also sets the pause after the response proportional to its latency, so the limit works without the limits of the rate too.
+ */
+struct RateLimits
+{
+    double requests_per_second = 0;
+    double operations_per_second = 0;
+    double bytes_per_second = 0;
+    bool is_adaptive = false;
+};
+
+/**
+ * @brief The token bucket. The capacity is one second of the rate. The request larger than the capacity is allowed, the debt is paid by the next requests.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket() = default;
+    TokenBucket(double rate, Clock::time_point now);
+
+    /**
+     * @brief Taking of the tokens.
+     * @param tokens The number of the tokens.
+     * @param rate_factor The share of the rate (the adaptive mode).
+     * @param now The current time.
+     * @return The time to wait before the tokens are available.
+     */
+    [[nodiscard]] Clock::duration Take(double tokens, double rate_factor, Clock::time_point now);
+
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return m_rate > 0;
+    }
+
+private:
+    void Refill(double rate_factor, Clock::time_point now);
+
+    double m_rate = 0;
+    double m_capacity = 0;
+    double m_tokens = 0;
+    Clock::time_point m_last_refill{};
+};
+
+/**
+ * @brief The limiter of the rate of the requests. Not thread-safe, used by the one client wrapper.
+ */
+class RateLimiter
+{
+public:
+    RateLimiter() = default;
+    explicit RateLimiter(const RateLimits& limits, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Reservation of the request. Must be called before the request is sent.
+     * @param number_of_operations The number of the operations of the request.
+     * @param now The current time.
+     * @return The time to wait before the request is sent.
+     */
+    [[nodiscard]] Clock::duration Acquire(size_t number_of_operations, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Accounting of the response.
+     * @param service The service of the request.
+     * @param number_of_operations The number of the operations of the request (as for Acquire).
+     * @param latency The time from the sending of the request to the response.
+     * @param response_bytes The size of the response (used only if IsBytesLimited()).
+     * @param now The current time.
+     */
+    void OnResponse(Service service, size_t number_of_operations, Clock::duration latency, size_t response_bytes, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Accounting of the state of the server in the adaptive mode: the server rejects the requests (BadTooManyOperations, BadResourceUnavailable,
+     *        the growth of RejectedRequestsCount of ServerDiagnosticsSummary), does not answer in time (BadTimeout) or is not in the Running state.
+     */
+    void OnServerOverload(Clock::time_point now = Clock::now());
+
+    [[nodiscard]] bool IsEnabled() const noexcept
+    {
+        return m_requests.IsEnabled() || m_operations.IsEnabled() || m_bytes.IsEnabled() || m_is_adaptive;
+    }
+
+    [[nodiscard]] bool IsAdaptive() const noexcept
+    {
+        return m_is_adaptive;
+    }
+
+    [[nodiscard]] bool IsBytesLimited() const noexcept
+    {
+        return m_bytes.IsEnabled();
+    }
+
+    /**
+     * @brief The current share of the rate, 1 - the full rate. Less than 1 only in the adaptive mode.
+     */
+    [[nodiscard]] double GetThrottleFactor() const noexcept
+    {
+        return m_throttle_factor;
+    }
+
+private:
+    void Decrease(Clock::time_point now);
+
+    /**
+     * @brief The smoothed and the minimum latency of the requests of the same service and of the same order of the number of the operations.
+     */
+    struct LatencyBaseline
+    {
+        double latency_seconds = 0;
+        double min_latency_seconds = 0;
+    };
+    // The service and the number of the significant bits of the number of the operations.
+    using LatencyBaselineKey = std::pair<Service, int>;
+
+    TokenBucket m_requests;
+    TokenBucket m_operations;
+    TokenBucket m_bytes;
+    bool m_is_adaptive = false;
+    double m_throttle_factor = 1.0;
+    Clock::time_point m_last_decrease{};
+    // The time from which the share of the rate is increased: the last not saturated response.
+    Clock::time_point m_last_increase{};
+    std::map<LatencyBaselineKey, LatencyBaseline> m_latency_baselines;
+    // The end of the pause after the last response in the adaptive mode.
+    Clock::time_point m_pause_until{};
+};
+
+} // namespace nodesetexporter::open62541::ratelimit
+
+#endif // NODESETEXPORTER_OPEN62541_RATELIMITER_H
@@ -0,0 +1,222 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_ROUNDTRIPVERIFIER_H
+#define NODESETEXPORTER_OPEN62541_ROUNDTRIPVERIFIER_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/interfaces/IOpen62541.h"
+#include "nodesetexporter/open62541/NodesetFileWrappers.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nodesetexporter::open62541
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+using nodesetexporter::interfaces::IOpen62541;
+using ::nodesetexporter::open62541::UATypesContainer;
+
+/**
+ * @brief Round-trip verification of the unloading: the produced NodeSet2 XML document is loaded back (re-imported) and the nodes of the export list
+ *        are read from both the original data source and the re-imported document, after which the node classes, the attributes and the references
+ *        are compared node by node. Serves as a correctness oracle for the changes of the export loop, the encoders and the filters, and measures
+ *        the time of each phase (including the import of the produced document).
+ *        The namespace indices of the document are matched with the indices of the data source by the namespace URIs.
+ *        Only the attributes that are carried by the NodeSet2 format are compared (the user-dependent attributes are not). The Value attribute is compared
+ *        only if the document loader supports its type. The references of the data source to the non-standard (ns!=0) nodes outside the export list
+ *        are filtered out by the export and are not counted as the mismatches.
+ * @warning The transformations performed by the export on purpose (the replacement of the parent of the start node, the filtering of the inverse references
+ *          of the type nodes, the fixes of the KEPServer references) are reported as the mismatches.
+ */
+class RoundTripVerifier final
+{
+public:
+    /**
+     * @brief The difference found between the original and the re-imported node.
+     */
+    struct Mismatch
+    {
+        std::string node_id; // NodeID in the namespace indices of the data source.
+        std::string description;
+    };
+
+    /**
+     * @brief The duration of the phase of the verification.
+     */
+    struct PhaseTiming
+    {
+        std::string phase;
+        std::chrono::milliseconds duration;
+    };
+
+    static constexpr size_t max_stored_mismatches = 1000;
+    static constexpr size_t default_number_of_nodes_in_batch = 1000;
+
+    RoundTripVerifier(IOpen62541& original, LoggerBase& logger, size_t number_of_nodes_in_batch = default_number_of_nodes_in_batch)
+        : m_original(original)
+        , m_logger(logger)
+        , m_reimported(logger)
+        , m_number_of_nodes_in_batch(number_of_nodes_in_batch > 0 ? number_of_nodes_in_batch : default_number_of_nodes_in_batch)
+    {
+    }
+    ~RoundTripVerifier() = default;
+    RoundTripVerifier(RoundTripVerifier&) = delete;
+    RoundTripVerifier(RoundTripVerifier&&) = delete;
+    RoundTripVerifier& operator=(const RoundTripVerifier& obj) = delete;
+    RoundTripVerifier& operator=(RoundTripVerifier&& obj) = delete;
+
+    /**
+     * @brief Verification of the unloading formed in memory. The mismatches of the previous verification are replaced, the phase timings are accumulated.
+     * @param nodeset_xml Text of the produced NodeSet2 XML document.
+     * @param node_ids The list of the exported nodes in the namespace indices of the data source.
+     * @return Verification status. Fail in case of the load or the request error. The mismatches do not change the status, see GetNumberOfMismatches().
+     */
+    [[nodiscard]] StatusResults VerifyDocument(const std::string& nodeset_xml, const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids);
+
+    /**
+     * @brief Verification of the unloading formed in the file. Same as VerifyDocument.
+     * @param filename Full path and name of the produced NodeSet2 XML file.
+     * @param node_ids The list of the exported nodes in the namespace indices of the data source.
+     */
+    [[nodiscard]] StatusResults VerifyFile(const std::string& filename, const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids);
+
+    /**
+     * @brief Adding the timing of an external phase (for example, of the export itself) to the report.
+     */
+    void AddPhaseTiming(std::string phase, std::chrono::milliseconds duration)
+    {
+        m_phase_timings.push_back({std::move(phase), duration});
+    }
+
+    /**
+     * @brief The mismatches found (no more than max_stored_mismatches are stored).
+     */
+    [[nodiscard]] const std::vector<Mismatch>& GetMismatches() const noexcept
+    {
+        return m_mismatches;
+    }
+
+    /**
+     * @brief The total number of the mismatches found, including those that were not stored.
+     */
+    [[nodiscard]] size_t GetNumberOfMismatches() const noexcept
+    {
+        return m_number_of_mismatches;
+    }
+
+    /**
+     * @brief The number of the nodes compared.
+     */
+    [[nodiscard]] size_t GetNumberOfComparedNodes() const noexcept
+    {
+        return m_number_of_compared_nodes;
+    }
+
+    /**
+     * @brief The number of the references of the data source to the nodes outside the export list, which are not expected in the document.
+     */
+    [[nodiscard]] size_t GetNumberOfFilteredReferences() const noexcept
+    {
+        return m_number_of_filtered_references;
+    }
+
+    [[nodiscard]] const std::vector<PhaseTiming>& GetPhaseTimings() const noexcept
+    {
+        return m_phase_timings;
+    }
+
+    /**
+     * @brief The locales of the export (see Options::locales), by them the texts of the locale "mul" of the data source are compared with the main text of the document.
+     */
+    void SetLocales(std::vector<std::string> locales)
+    {
+        m_locales = std::move(locales);
+    }
+
+private:
+    // NodeIDs and node data of one side in the order of the export list.
+    struct NodesData
+    {
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids;
+        std::vector<IOpen62541::NodeClassesRequestResponse> classes;
+        std::vector<IOpen62541::NodeReferencesRequestResponse> references;
+        std::vector<IOpen62541::NodeAttributesRequestResponse> attributes;
+    };
+
+    /**
+     * @brief Verification of the loaded document: the matching of the namespaces, the reading of both sides and the comparison.
+     */
+    [[nodiscard]] StatusResults Verify(const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids);
+
+    /**
+     * @brief Reading of the namespace arrays of both sides and matching of the namespace indices.
+     * @return Status. Fail if the namespace array of the data source can't be read.
+     */
+    [[nodiscard]] StatusResults MatchNamespaces();
+
+    /**
+     * @brief Reading of the classes, the references and the attributes of the nodes by the batches.
+     * @param source The data source.
+     * @param node_classes The classes of the nodes by which the attributes are requested (the classes of the original nodes). If empty, the classes read from the source are used.
+     * @param data [in/out] The NodeIDs of the nodes [in] and their data [out].
+     * @return Request execution status.
+     */
+    [[nodiscard]] StatusResults ReadNodes(IOpen62541& source, const std::vector<UA_NodeClass>& node_classes, NodesData& data) const;
+
+    /**
+     * @brief Comparison of the nodes of both sides.
+     * @param original The data of the original nodes.
+     * @param reimported The data of the re-imported nodes in the same order.
+     * @param export_scope The exported nodes in the namespace indices of the data source.
+     */
+    void CompareNodes(const NodesData& original, const NodesData& reimported, const std::unordered_set<UATypesContainer<UA_NodeId>>& export_scope);
+
+    /**
+     * @brief Text representation of the reference for the comparison, the namespace indices of the target are translated to the indices of the data source.
+     */
+    [[nodiscard]] std::string ReferenceToString(const UA_ReferenceDescription& reference, bool is_reimported) const;
+
+    /**
+     * @brief Text representation of the attribute value for the comparison, the namespace indices of the re-imported values are translated to the indices of the data source.
+     */
+    [[nodiscard]] std::string AttributeToString(const VariantsOfAttr& value, bool is_reimported) const;
+
+    /**
+     * @brief Translation of the namespace index of the re-imported document to the index of the data source. Unknown indices are returned as is.
+     */
+    [[nodiscard]] UA_UInt16 ToOriginalNamespace(UA_UInt16 index) const;
+
+    void AddMismatch(const std::string& node_id, std::string&& description);
+
+    IOpen62541& m_original;
+    LoggerBase& m_logger;
+    Open62541NodesetFileWrapper m_reimported;
+    size_t m_number_of_nodes_in_batch;
+    // Namespace indices: data source -> document, document -> data source.
+    std::unordered_map<UA_UInt16, UA_UInt16> m_original_to_reimported_ns;
+    std::unordered_map<UA_UInt16, UA_UInt16> m_reimported_to_original_ns;
+    std::vector<Mismatch> m_mismatches;
+    std::vector<PhaseTiming> m_phase_timings;
+    size_t m_number_of_mismatches = 0;
+    size_t m_number_of_compared_nodes = 0;
+    size_t m_number_of_filtered_references = 0;
+    std::vector<std::string> m_locales;
+};
+
+} // namespace nodesetexporter::open62541
+
+#endif // NODESETEXPORTER_OPEN62541_ROUNDTRIPVERIFIER_H
@@ -0,0 +1,100 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_SECURITYPROFILE_H
+#define NODESETEXPORTER_OPEN62541_SECURITYPROFILE_H
+
+#include "nodesetexporter/common/LoggerBase.h"
+#include "nodesetexporter/common/Statuses.h"
+
+#include <open62541/client.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The secured connection of the Open62541 client (the security modes Sign and SignAndEncrypt). Requires the Open62541 library built with the encryption
+ * (UA_ENABLE_ENCRYPTION), otherwise only the security mode None is available.
+ */
+namespace nodesetexporter::open62541::security
+{
+
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+
+/**
+ * @brief The security profile of the client.
+ * @param security_policy_uri The URI of the security policy of the channel. Empty - the policy is selected by the client from the endpoints of the server.
+ * @param security_mode The security mode of the channel.
+ * @param certificate_file The certificate of the client (DER).
+ * @param private_key_file The private key of the client (DER or PEM).
+ * @param trust_list_files The certificates of the trusted servers (DER). Empty - the certificate of any server is accepted.
+ * @param application_uri The application URI of the client, must be equal to the URI of the certificate. Empty - the default URI of Open62541.
+ */
+struct SecurityProfile
+{
+    std::string security_policy_uri{};
+    UA_MessageSecurityMode security_mode = UA_MESSAGESECURITYMODE_NONE;
+    std::string certificate_file{};
+    std::string private_key_file{};
+    std::vector<std::string> trust_list_files{};
+    std::string application_uri{};
+};
+
+/**
+ * @brief The cost of the symmetric cryptography of one chunk of the message of the secured channel.
+ * @param chunk_size The size of the measured chunk.
+ * @param sign The time of the signing of the chunk.
+ * @param encrypt The time of the encryption of the chunk (0 in the Sign mode).
+ */
+struct CryptoOverhead
+{
+    size_t chunk_size = 0;
+    std::chrono::nanoseconds sign{0};
+    std::chrono::nanoseconds encrypt{0};
+};
+
+/**
+ * @brief Getting the URI of the security policy by the short name: None, Basic128Rsa15, Basic256, Basic256Sha256, Aes128_Sha256_RsaOaep, Aes256_Sha256_RsaPss.
+ * @return The URI or nullopt if the name is unknown.
+ */
+std::optional<std::string> SecurityPolicyUriFromName(std::string_view name);
+
+/**
+ * @brief Getting the security mode by the name: None, Sign, SignAndEncrypt.
+ * @return The mode or nullopt if the name is unknown.
+ */
+std::optional<UA_MessageSecurityMode> SecurityModeFromName(std::string_view name);
+
+/**
+ * @brief Applying the profile to the configuration of the client. The default configuration with the encryption is formed (UA_ClientConfig_setDefaultEncryption),
+ *        so the function replaces UA_ClientConfig_setDefault and must be called before the other settings of the configuration and before the connection.
+ *        With the security mode None the configuration is only set by default.
+ * @param config The configuration of the client.
+ * @param profile The security profile.
+ * @param logger Logging methods.
+ * @return Fail if the files can't be read, the policy is not supported or the library is built without the encryption.
+ */
+StatusResults ApplySecurityProfile(UA_ClientConfig& config, const SecurityProfile& profile, LoggerBase& logger);
+
+/**
+ * @brief Measuring of the cost of the symmetric cryptography of the chunk by the security policy of the configuration (the policy of the connected channel).
+ *        The keys are generated for the measuring only, the channel is not used.
+ * @param config The configuration of the client with the secured channel.
+ * @param chunk_size The size of the chunk, as a rule the size of the buffer of the connection.
+ * @param overhead The result.
+ * @return Fail if the channel is not secured or the policy is not found.
+ */
+StatusResults MeasureCryptoOverhead(const UA_ClientConfig& config, size_t chunk_size, CryptoOverhead& overhead);
+
+} // namespace nodesetexporter::open62541::security
+
+#endif // NODESETEXPORTER_OPEN62541_SECURITYPROFILE_H
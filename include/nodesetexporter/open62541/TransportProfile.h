@@ -0,0 +1,120 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#ifndef NODESETEXPORTER_OPEN62541_TRANSPORTPROFILE_H
+#define NODESETEXPORTER_OPEN62541_TRANSPORTPROFILE_H
+
+#include "nodesetexporter/common/Statuses.h"
+
+#include <open62541/client.h>
+
+#include <sys/types.h>
+
+/**
+ * Tuning of the transport of the Open62541 client for the export. The default configuration of the client (UA_ClientConfig_setDefault) has the buffers of 64 KB
+ * and does not limit the size of the message, so the large responses of Read and Browse are split into many small chunks, and if the limits are set,
+ * the too large responses are rejected by the client (BadResponseTooLarge). The profile sets the limits of the connection before the client is connected,
+ * and after the connection the number of the nodes per one request is derived from these limits and from the operation limits of the server.
+ */
+namespace nodesetexporter::open62541::transport
+{
+
+using StatusResults = nodesetexporter::common::statuses::StatusResults<int64_t>;
+
+// The estimation of the response of the Read service for one node, used only for the derivation of the number of the nodes per request from the limits.
+// The node with the most requested attributes is the Variable in the Full profile: the common attributes (BrowseName, DisplayName, Description, WriteMask,
+// UserWriteMask, see NodesetExporterLoop::GetCommonNodeAttributes) and the attributes of the Variable (DataType, ValueRank, ArrayDimensions, Value, AccessLevel,
+// UserAccessLevel, MinimumSamplingInterval, Historizing, see NodesetExporterLoop::GetVariableNodeAttributes).
+constexpr u_int32_t number_of_common_attributes = 5;
+constexpr u_int32_t number_of_variable_attributes = 8;
+constexpr u_int32_t estimated_attributes_per_node = number_of_common_attributes + number_of_variable_attributes;
+// Each attribute is returned as DataValue: the encoding mask, the type of the Variant and the StatusCode of the attribute that can't be read.
+constexpr u_int32_t estimated_data_value_overhead_bytes = 1 + 1 + 4;
+// BrowseName, DisplayName and Description: the length prefixes, the locale and about 64 bytes of the text each.
+constexpr u_int32_t estimated_texts_bytes = 3 * (64 + 16);
+// The scalar attributes of the Variable: DataType (NodeId), ValueRank, ArrayDimensions, the masks, the access levels, MinimumSamplingInterval, Historizing.
+constexpr u_int32_t estimated_scalar_attributes_bytes = 64;
+// The Value: the scalar or the short array. The large arrays are read separately in parts (see Options::number_of_max_array_elements_to_request_data).
+constexpr u_int32_t estimated_value_bytes = 512;
+constexpr u_int32_t estimated_response_bytes_per_node =
+    estimated_attributes_per_node * estimated_data_value_overhead_bytes + estimated_texts_bytes + estimated_scalar_attributes_bytes + estimated_value_bytes;
+
+// The secured channel signs (and encrypts) each chunk, the fixed part of the cost (the signature, the padding, the headers) is paid per chunk,
+// so with the Sign and SignAndEncrypt modes the larger chunks are requested by default.
+constexpr u_int32_t secured_channel_recv_buffer_size = 1U << 20U;
+// The security overhead of the chunk: the headers of the message, of the security and of the sequence, the signature (up to SHA-256) and the padding (up to AES block).
+constexpr u_int32_t secured_chunk_overhead = 12 + 4 + 8 + 32 + 17;
+
+/**
+ * @brief The transport profile of the client. Zero values leave the default of the Open62541 library.
+ * @param recv_buffer_size The size of the receive buffer of the connection, i.e. the maximum size of the received chunk (UA_ConnectionConfig::recvBufferSize).
+ *                         With the secured channel the default is secured_channel_recv_buffer_size (the server can negotiate it down).
+ * @param send_buffer_size The size of the send buffer of the connection, i.e. the maximum size of the sent chunk (UA_ConnectionConfig::sendBufferSize).
+ * @param max_message_size The maximum size of the received message (UA_ConnectionConfig::localMaxMessageSize).
+ * @param max_chunk_count The maximum number of the chunks of the received message (UA_ConnectionConfig::localMaxChunkCount).
+ * @param socket_recv_buffer_size The size of the socket receive buffer of the kernel (SO_RCVBUF).
+ * @param socket_send_buffer_size The size of the socket send buffer of the kernel (SO_SNDBUF).
+ * @param tcp_no_delay Disable the Nagle algorithm (TCP_NODELAY). In Open62541 v1.4 it is always set by the event loop.
+ */
+struct TransportProfile
+{
+    u_int32_t recv_buffer_size = 0;
+    u_int32_t send_buffer_size = 0;
+    u_int32_t max_message_size = 0;
+    u_int32_t max_chunk_count = 0;
+    u_int32_t socket_recv_buffer_size = 0;
+    u_int32_t socket_send_buffer_size = 0;
+    bool tcp_no_delay = true;
+};
+
+/**
+ * @brief The limits of the requests after the connection.
+ * @param max_message_size The maximum size of the response accepted by the client: the minimum of the message size and of the chunk size (without the security
+ *                         overhead of the secured channel) multiplied by the number of the chunks. The chunk size is the send buffer of the server
+ *                         negotiated by the Acknowledge message of the connection. 0 - no limit.
+ * @param max_nodes_per_read The operation limit of the server MaxNodesPerRead (the number of ReadValueId in one request). 0 - no limit.
+ */
+struct RequestLimits
+{
+    u_int32_t max_message_size = 0;
+    u_int32_t max_nodes_per_read = 0;
+};
+
+/**
+ * @brief Applying the profile to the configuration of the client. Must be called after UA_ClientConfig_setDefault (or security::ApplySecurityProfile)
+ *        and before the connection. The profile is kept for this client only: the socket options are set on each new socket of the client
+ *        before it is connected (so SO_RCVBUF takes part in the negotiation of the TCP window scaling), including the reconnections,
+ *        and the Acknowledge message of the server is kept for ReadRequestLimits.
+ * @warning In Open62541 v1.3 the socket options are applied only with the TCP connection of the library (UA_ClientConnectionTCP_init),
+ *          the replaced connection function of the configuration is left as is.
+ * @param config The configuration of the client.
+ * @param profile The transport profile, it is copied.
+ * @return Fail if the profile is inconsistent (the buffers are smaller than the minimum of the OPC UA TCP protocol - 8192 bytes).
+ */
+StatusResults ApplyTransportProfile(UA_ClientConfig& config, const TransportProfile& profile);
+
+/**
+ * @brief Getting the limits of the requests of the connected client: the limits of the connection negotiated with the server
+ *        and the operation limits of the server (Server/ServerCapabilities/OperationLimits).
+ * @param client The connected client.
+ * @param limits The result. The limits that the server does not provide are left as no limit. If the profile was not applied to the client
+ *               (see ApplyTransportProfile), the negotiated chunk size is unknown and the local limits of the client are used.
+ * @return Fail if the client is not connected.
+ */
+StatusResults ReadRequestLimits(UA_Client& client, RequestLimits& limits);
+
+/**
+ * @brief Derivation of the maximum number of the nodes per one request of the data (see Options::number_of_max_nodes_to_request_data) from the limits,
+ *        so that the request of the attributes does not exceed MaxNodesPerRead and the response fits into the maximum message size.
+ * @return The number of the nodes, at least 1, or 0 if there are no limits.
+ */
+u_int32_t DeriveNumberOfMaxNodesToRequestData(const RequestLimits& limits);
+
+} // namespace nodesetexporter::open62541::transport
+
+#endif // NODESETEXPORTER_OPEN62541_TRANSPORTPROFILE_H
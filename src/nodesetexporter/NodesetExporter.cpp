@@ -7,35 +7,129 @@
 //
 
 #include "NodesetExporter.h"
+#include "AsyncClientWrappers.h"
+#include "AwaitableWrappers.h"
+#include "BrowseOperations.h"
 #include "ClientWrappers.h"
 #include "NodesetExporterLoop.h"
+#include "NodesetFileWrappers.h"
 #include "PerformanceTimer.h"
+#include "QuirkFixers.h"
 #include "ServerWrappers.h"
+#include "encoders/SplitEncoder.h"
+#include "encoders/ValidatingEncoder.h"
 #include "encoders/XMLEncoder.h"
 #include "logger/StdLog.h"
 
+#include <algorithm>
+
 
 namespace nodesetexporter
 {
 using Open62541ServerWrapper = nodesetexporter::open62541::Open62541ServerWrapper;
 using Open62541ClientWrapper = nodesetexporter::open62541::Open62541ClientWrapper;
+using SessionRecoveryPolicy = nodesetexporter::open62541::SessionRecoveryPolicy;
+using RateLimits = nodesetexporter::open62541::ratelimit::RateLimits;
+using RateLimiter = nodesetexporter::open62541::ratelimit::RateLimiter;
+using Open62541AsyncClientWrapper = nodesetexporter::open62541::Open62541AsyncClientWrapper;
+using Open62541AwaitableWrapper = nodesetexporter::open62541::Open62541AwaitableWrapper;
+using Open62541NodesetFileWrapper = nodesetexporter::open62541::Open62541NodesetFileWrapper;
 using XMLEncoder = nodesetexporter::encoders::XMLEncoder;
+using SplitEncoder = nodesetexporter::encoders::SplitEncoder;
+using ValidatingEncoder = nodesetexporter::encoders::ValidatingEncoder;
 using ConsoleLogger = nodesetexporter::logger::ConsoleLogger;
 using PerformanceTimer = nodesetexporter::common::PerformanceTimer;
+namespace quirks = nodesetexporter::open62541::quirks;
+namespace browseoperations = nodesetexporter::open62541::browseoperations;
 
-template <typename TOpen62541ServerOrClient>
-StatusResults ExportNodeset(
-    TOpen62541ServerOrClient& open62541_object,
-    const std::map<std::string, std::vector<ExpandedNodeId>>& node_ids,
-    std::string&& filename,
-    std::optional<std::reference_wrapper<std::iostream>> out_buffer,
-    const Options& opt) noexcept
+namespace
+{
+/**
+ * @brief The default name of the file of the types in the split output mode: the ".types" suffix before the extension of the file of the instances.
+ */
+std::string GetDefaultTypesFilename(const std::string& filename)
+{
+    const auto extension_pos = filename.rfind('.');
+    const auto directory_pos = filename.find_last_of("/\\");
+    if (extension_pos == std::string::npos || (directory_pos != std::string::npos && extension_pos < directory_pos))
+    {
+        return filename + ".types";
+    }
+    return filename.substr(0, extension_pos) + ".types" + filename.substr(extension_pos);
+}
+
+/**
+ * @brief The limits of the rate of the requests of the client from the export options.
+ */
+RateLimits ToRateLimits(const Options& opt)
+{
+    return {opt.rate_limit.requests_per_second, opt.rate_limit.operations_per_second, opt.rate_limit.bytes_per_second, opt.rate_limit.is_adaptive};
+}
+
+/**
+ * @brief The View of the Browse requests of the client from the export options. The null ViewId - the whole address space.
+ */
+UATypesContainer<UA_ViewDescription> ToViewDescription(const Options& opt)
+{
+    if (!opt.view.view_id)
+    {
+        return UATypesContainer<UA_ViewDescription>(UA_TYPES_VIEWDESCRIPTION);
+    }
+    return browseoperations::MakeViewDescription(opt.view.view_id->GetRef().nodeId, opt.view.timestamp, opt.view.view_version);
+}
+
+/**
+ * @brief Enabling the fixers of the deviations of the server: the fixers from the options and, with the auto-detection, the fixers needed by the server
+ *        according to its BuildInfo. The BuildInfo that can't be read disables only the auto-detection.
+ * @return Fail if the name of the fixer is unknown.
+ */
+StatusResults AddQuirkFixers(IOpen62541& open62541_obj, LoggerBase& logger, const Options& opt, NodesetExporterLoop& export_core)
+{
+    auto names = opt.quirk_fixers.names;
+    if (opt.quirk_fixers.auto_detect)
+    {
+        const ExpandedNodeId build_info_node_id(UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO), UA_TYPES_EXPANDEDNODEID);
+        UATypesContainer<UA_Variant> build_info(UA_TYPES_VARIANT);
+        if (open62541_obj.ReadNodeDataValue(build_info_node_id, build_info) == StatusResults::Good && UA_Variant_hasScalarType(&build_info.GetRef(), &UA_TYPES[UA_TYPES_BUILDINFO]))
+        {
+            for (auto& name : quirks::DetectQuirkFixers(*static_cast<const UA_BuildInfo*>(build_info.GetRef().data)))
+            {
+                if (std::find(names.begin(), names.end(), name) == names.end())
+                {
+                    logger.Info("The quirk fixer '{}' is detected by BuildInfo of the server.", name);
+                    names.push_back(std::move(name));
+                }
+            }
+        }
+        else
+        {
+            logger.Warning("BuildInfo of the server is not available, the quirk fixers are not detected.");
+        }
+    }
+    for (const auto& name : names)
+    {
+        auto quirk_fixer = quirks::MakeQuirkFixer(name, logger);
+        if (!quirk_fixer)
+        {
+            logger.Error("Unknown quirk fixer '{}'.", name);
+            return StatusResults::Fail;
+        }
+        logger.Info("The quirk fixer '{}' is enabled.", name);
+        export_core.AddQuirkFixer(std::move(quirk_fixer));
+    }
+    return StatusResults::Good;
+}
+
+/**
+ * @brief Selecting the logging method. If an external object is not provided, the internal implementation will be used.
+ * @param default_logger [out] Storage of the internal implementation, if it was created.
+ * @return The logger or std::nullopt in case of an error.
+ */
+std::optional<std::reference_wrapper<LoggerBase>> SelectLogger(const Options& opt, std::unique_ptr<LoggerBase>& default_logger) noexcept
 {
     auto logger = opt.logger;
-    std::unique_ptr<LoggerBase> default_logger;
     try
     {
-        // Select the logging method. If an external object is not provided, the internal implementation will be used.
         if (!logger)
         {
             default_logger = std::make_unique<ConsoleLogger>("nodesetexporter");
@@ -50,6 +144,137 @@ StatusResults ExportNodeset(
         }
     }
     catch (...)
+    {
+        return std::nullopt;
+    }
+    return logger;
+}
+
+/**
+ * @brief Creating the encoder and the export core over the prepared data source and starting the export by the engine selected in the options.
+ * @param open62541_obj The data source.
+ * @param is_simultaneous_calls_allowed The data source allows simultaneous requests from the coroutine engine.
+ */
+StatusResults RunExport(
+    IOpen62541& open62541_obj,
+    LoggerBase& logger,
+    const std::map<std::string, std::vector<ExpandedNodeId>>& node_ids,
+    std::string&& filename,
+    std::optional<std::reference_wrapper<std::iostream>> out_buffer,
+    const Options& opt,
+    bool is_simultaneous_calls_allowed)
+{
+    // Selects the exporter encoder implementation.
+    std::unique_ptr<IEncoder> uniq_encoder;
+    std::unique_ptr<IEncoder> uniq_types_encoder;
+    switch (opt.encoder_types)
+    {
+    // So far only one implementation in XML.
+    default:
+        const auto setup_xml_encoder = [&opt](std::unique_ptr<XMLEncoder> xml_encoder)
+        {
+            xml_encoder->SetCanonicalOutput(opt.canonical_output.is_enable);
+            xml_encoder->SetSkipUnchangedWrite(opt.canonical_output.skip_unchanged_write);
+            return xml_encoder;
+        };
+        if (opt.split_output.is_enable)
+        {
+            if (opt.split_output.types_out_buffer)
+            {
+                uniq_types_encoder = setup_xml_encoder(std::make_unique<XMLEncoder>(logger, *opt.split_output.types_out_buffer));
+            }
+            else if (out_buffer)
+            {
+                logger.Error("The output buffer of the types is required in the split output mode when the output buffer is specified.");
+                return StatusResults::Fail;
+            }
+            else
+            {
+                uniq_types_encoder = setup_xml_encoder(std::make_unique<XMLEncoder>(
+                    logger, opt.split_output.types_filename.empty() ? GetDefaultTypesFilename(filename) : opt.split_output.types_filename));
+            }
+        }
+        if (out_buffer)
+        {
+            uniq_encoder = setup_xml_encoder(std::make_unique<XMLEncoder>(logger, *out_buffer));
+        }
+        else
+        {
+            uniq_encoder = setup_xml_encoder(std::make_unique<XMLEncoder>(logger, std::move(filename)));
+        }
+    }
+    // The nodes are routed to the two documents by the node class.
+    std::unique_ptr<IEncoder> uniq_split_encoder;
+    if (uniq_types_encoder)
+    {
+        uniq_split_encoder = std::make_unique<SplitEncoder>(
+            logger, *uniq_types_encoder, *uniq_encoder, opt.split_output.types_model_uri, opt.split_output.instances_model_uri);
+    }
+    IEncoder* encoder = uniq_split_encoder ? uniq_split_encoder.get() : uniq_encoder.get();
+    // The self-validation checks the stream of the nodes before it is divided into the documents.
+    std::unique_ptr<ValidatingEncoder> uniq_validating_encoder;
+    if (opt.self_validation.is_enable)
+    {
+        uniq_validating_encoder = std::make_unique<ValidatingEncoder>(logger, *encoder);
+        encoder = uniq_validating_encoder.get();
+    }
+
+    NodesetExporterLoop export_core(
+        node_ids,
+        open62541_obj,
+        *encoder,
+        logger,
+        {opt.is_perf_timer_enable,
+         opt.ns0_custom_nodes_ready_to_work,
+         {opt.flat_list_of_nodes.is_enable, opt.flat_list_of_nodes.create_missing_start_node, opt.flat_list_of_nodes.allow_abstract_variable},
+         opt.parent_start_node_replacer,
+         opt.stop_token,
+         {opt.attribute_projection.profile, opt.attribute_projection.custom_attributes},
+         opt.type_closure,
+         opt.cross_list_deduplication,
+         opt.locales});
+    export_core.SetNumberOfMaxNodesToRequestData(opt.number_of_max_nodes_to_request_data);
+    export_core.SetNumberOfMaxArrayElementsToRequestData(opt.number_of_max_array_elements_to_request_data);
+    if (AddQuirkFixers(open62541_obj, logger, opt, export_core) != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    auto timer = PREPARE_TIMER(opt.is_perf_timer_enable);
+    auto status = StatusResults(StatusResults::Fail);
+    if (opt.coroutine_engine.is_enable)
+    {
+        const size_t max_batches_in_flight
+            = opt.coroutine_engine.max_batches_in_flight == 0 ? NodesetExporterLoop::default_max_batches_in_flight : opt.coroutine_engine.max_batches_in_flight;
+        Open62541AwaitableWrapper awaitable_open62541_obj(open62541_obj, logger, max_batches_in_flight, is_simultaneous_calls_allowed);
+        status = export_core.StartCoroutineExport(awaitable_open62541_obj, max_batches_in_flight);
+    }
+    else
+    {
+        status = export_core.StartExport();
+    }
+    GET_TIME_ELAPSED_FMT_FORMAT(timer, logger.Info, "Total time to export: ", "");
+
+    if (status == StatusResults::Good && uniq_validating_encoder && opt.self_validation.is_strict && uniq_validating_encoder->GetNumberOfViolations() > 0)
+    {
+        logger.Error("The unloading has {} violations of the structure of the NodeSet.", uniq_validating_encoder->GetNumberOfViolations());
+        return {StatusResults::Fail, StatusResults::SelfValidationFail};
+    }
+    return status;
+}
+} // namespace
+
+template <typename TOpen62541ServerOrClient>
+StatusResults ExportNodeset(
+    TOpen62541ServerOrClient& open62541_object,
+    const std::map<std::string, std::vector<ExpandedNodeId>>& node_ids,
+    std::string&& filename,
+    std::optional<std::reference_wrapper<std::iostream>> out_buffer,
+    const Options& opt) noexcept
+{
+    std::unique_ptr<LoggerBase> default_logger;
+    auto logger = SelectLogger(opt, default_logger);
+    if (!logger)
     {
         return StatusResults::Fail;
     }
@@ -68,49 +293,108 @@ StatusResults ExportNodeset(
         std::unique_ptr<IOpen62541> uniq_open625411_obj = nullptr;
         if constexpr (std::is_same_v<TOpen62541ServerOrClient, UA_Server>)
         {
+            if (opt.view.view_id)
+            {
+                logger.value().get().Warning("The view works only with the client, it is not used with the server.");
+            }
             uniq_open625411_obj = std::make_unique<Open62541ServerWrapper>(open62541_object, logger.value().get());
         }
         else if constexpr (std::is_same_v<TOpen62541ServerOrClient, UA_Client>)
         {
-            uniq_open625411_obj = std::make_unique<Open62541ClientWrapper>(open62541_object, logger.value().get());
-        }
-        else
-        {
-            static_assert("You need to choose between UA_Server or UA_Client....");
-        }
-
-        // Selects the exporter encoder implementation.
-        std::unique_ptr<IEncoder> uniq_encoder;
-        switch (opt.encoder_types)
-        {
-        // So far only one implementation in XML.
-        default:
-            if (out_buffer)
+            if (opt.async_client.dispatcher && opt.session_recovery.reconnect)
+            {
+                logger.value().get().Warning("The session recovery works only with the synchronous client, it is not used with the asynchronous one.");
+            }
+            if (opt.async_client.dispatcher && RateLimiter(ToRateLimits(opt)).IsEnabled())
+            {
+                logger.value().get().Warning("The rate limit works only with the synchronous client, it is not used with the asynchronous one.");
+            }
+            if (opt.async_client.dispatcher)
             {
-                uniq_encoder = std::make_unique<XMLEncoder>(logger.value().get(), *out_buffer);
+                auto async_client_wrapper = std::make_unique<Open62541AsyncClientWrapper>(open62541_object, logger.value().get(), opt.async_client.dispatcher);
+                if (opt.async_client.max_requests_in_flight != 0)
+                {
+                    async_client_wrapper->SetMaxRequestsInFlight(opt.async_client.max_requests_in_flight);
+                }
+                async_client_wrapper->SetMaxOperationsPerRequest(opt.async_client.max_operations_per_request);
+                async_client_wrapper->SetView(ToViewDescription(opt));
+                uniq_open625411_obj = std::move(async_client_wrapper);
             }
             else
             {
-                uniq_encoder = std::make_unique<XMLEncoder>(logger.value().get(), std::move(filename));
+                auto client_wrapper = std::make_unique<Open62541ClientWrapper>(open62541_object, logger.value().get(), opt.stop_token);
+                if (opt.session_recovery.reconnect)
+                {
+                    SessionRecoveryPolicy session_recovery_policy;
+                    session_recovery_policy.reconnect = opt.session_recovery.reconnect;
+                    if (opt.session_recovery.max_attempts_per_request != 0)
+                    {
+                        session_recovery_policy.max_attempts_per_request = opt.session_recovery.max_attempts_per_request;
+                    }
+                    if (opt.session_recovery.retry_budget != 0)
+                    {
+                        session_recovery_policy.retry_budget = opt.session_recovery.retry_budget;
+                    }
+                    if (opt.session_recovery.initial_backoff.count() != 0)
+                    {
+                        session_recovery_policy.initial_backoff = opt.session_recovery.initial_backoff;
+                    }
+                    if (opt.session_recovery.max_backoff.count() != 0)
+                    {
+                        session_recovery_policy.max_backoff = opt.session_recovery.max_backoff;
+                    }
+                    client_wrapper->SetSessionRecoveryPolicy(std::move(session_recovery_policy));
+                }
+                client_wrapper->SetRateLimits(ToRateLimits(opt));
+                client_wrapper->SetView(ToViewDescription(opt));
+                uniq_open625411_obj = std::move(client_wrapper);
             }
         }
+        else
+        {
+            static_assert("You need to choose between UA_Server or UA_Client....");
+        }
+
+        // Only the asynchronous client wrapper allows simultaneous requests, the other implementations are serialized by the awaitable wrapper.
+        const bool is_simultaneous_calls_allowed = std::is_same_v<TOpen62541ServerOrClient, UA_Client> && static_cast<bool>(opt.async_client.dispatcher);
+        return RunExport(*uniq_open625411_obj, logger.value().get(), node_ids, std::move(filename), out_buffer, opt, is_simultaneous_calls_allowed);
+    }
+    catch (std::exception& exc)
+    {
+        logger.value().get().Error("An exception was caught. {}", exc.what());
+        return StatusResults::Fail;
+    }
+}
+
+StatusResults ExportNodesetFromNodesetFile(
+    Open62541NodesetFileWrapper& nodeset_file,
+    const std::map<std::string, std::vector<ExpandedNodeId>>& node_ids,
+    std::string&& filename,
+    std::optional<std::reference_wrapper<std::iostream>> out_buffer,
+    const Options& opt) noexcept
+{
+    std::unique_ptr<LoggerBase> default_logger;
+    auto logger = SelectLogger(opt, default_logger);
+    if (!logger)
+    {
+        return StatusResults::Fail;
+    }
 
-        NodesetExporterLoop export_core(
-            node_ids,
-            *uniq_open625411_obj,
-            *uniq_encoder,
-            logger.value().get(),
-            {opt.is_perf_timer_enable,
-             opt.ns0_custom_nodes_ready_to_work,
-             {opt.flat_list_of_nodes.is_enable, opt.flat_list_of_nodes.create_missing_start_node, opt.flat_list_of_nodes.allow_abstract_variable},
-             opt.parent_start_node_replacer});
-        export_core.SetNumberOfMaxNodesToRequestData(opt.number_of_max_nodes_to_request_data);
-
-        auto timer = PREPARE_TIMER(opt.is_perf_timer_enable);
-        auto status = export_core.StartExport();
-        GET_TIME_ELAPSED_FMT_FORMAT(timer, logger.value().get().Info, "Total time to export: ", "");
-
-        return status;
+    if (node_ids.empty())
+    {
+        logger.value().get().Error("The list of node IDs is empty.");
+        return {StatusResults::Fail, StatusResults::SubStatus::EmptyNodeIdList};
+    }
+
+    if (opt.view.view_id)
+    {
+        logger.value().get().Warning("The view works only with the client, it is not used with the NodeSet file.");
+    }
+
+    try
+    {
+        // The file index is answered from memory and is not thread-safe for simultaneous requests, they are serialized by the awaitable wrapper.
+        return RunExport(nodeset_file, logger.value().get(), node_ids, std::move(filename), out_buffer, opt, false);
     }
     catch (std::exception& exc)
     {
@@ -12,7 +12,9 @@
 
 #include <open62541/types.h>
 
+#include <algorithm>
 #include <functional>
+#include <string_view>
 
 // NOLINTBEGIN
 #define CONSTRUCT_MAP_ITEM(key)                                                                                                                                                                        \
@@ -41,12 +43,13 @@ using PerformanceTimer = nodesetexporter::common::PerformanceTimer;
 
 #pragma region Getting ID attribute
 
-StatusResults NodesetExporterLoop::GetNodeAttributes(
+void NodesetExporterLoop::PrepareNodeAttributesRequest(
     const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
     const std::pair<size_t, size_t>& node_range,
     const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
     std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res)
 {
+    m_logger.Trace("Method called: PrepareNodeAttributesRequest()");
 
     // todo It is necessary to introduce tracking the Maxarraylength server parameter, how many elements the server will maintain in its array at a time, and in the case of attributes
     //  For each node you need to request a lot of parameters, where, from the point of view of the exchange of data, each request of the attribute corresponds to one occupied element of an array of
@@ -81,8 +84,79 @@ StatusResults NodesetExporterLoop::GetNodeAttributes(
                 node_classes_req_res.at(index).exp_node_id.ToString());
             attr.clear();
         }
+        ApplyEncoderConsumedAttributes(node_classes_req_res.at(index).node_class, attr);
+        ApplyAttributeProfile(attr);
         nodes_attr_req_res.push_back(IOpen62541::NodeAttributesRequestResponse{node_ids.at(index), attr});
     }
+}
+
+void NodesetExporterLoop::ApplyAttributeProfile(std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const
+{
+    switch (m_external_options.attribute_projection.profile)
+    {
+    case AttributeProfiles::NodesetMinimal:
+    {
+        // These attributes usually have default values or depend on the user of the session, the loaded nodeset does not need them.
+        static const std::set<UA_AttributeId> nodeset_minimal_excluded{
+            UA_ATTRIBUTEID_DESCRIPTION,
+            UA_ATTRIBUTEID_WRITEMASK,
+            UA_ATTRIBUTEID_USERWRITEMASK,
+            UA_ATTRIBUTEID_USERACCESSLEVEL,
+            UA_ATTRIBUTEID_USEREXECUTABLE,
+            UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
+            UA_ATTRIBUTEID_HISTORIZING};
+        std::erase_if(
+            attrs,
+            [](const auto& attr)
+            {
+                return nodeset_minimal_excluded.contains(attr.first);
+            });
+        break;
+    }
+    case AttributeProfiles::Custom:
+    {
+        // BrowseName and DisplayName are mandatory for each node of NodeSet2, DataType is needed for the aliases and the type of the variables.
+        // NodeClass is read separately and is not in the list.
+        static const std::set<UA_AttributeId> custom_always_requested{UA_ATTRIBUTEID_BROWSENAME, UA_ATTRIBUTEID_DISPLAYNAME, UA_ATTRIBUTEID_DATATYPE};
+        std::erase_if(
+            attrs,
+            [&custom_attributes = m_external_options.attribute_projection.custom_attributes](const auto& attr)
+            {
+                return !custom_always_requested.contains(attr.first) && !custom_attributes.contains(attr.first);
+            });
+        break;
+    }
+    case AttributeProfiles::Full:
+    default:
+        break;
+    }
+}
+
+void NodesetExporterLoop::ApplyEncoderConsumedAttributes(UA_NodeClass node_class, std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const
+{
+    const auto consumed_attributes = m_encoder_consumed_attributes.find(node_class);
+    if (consumed_attributes == m_encoder_consumed_attributes.end())
+    {
+        return;
+    }
+    std::erase_if(
+        attrs,
+        [&consumed_attributes = consumed_attributes->second](const auto& attr)
+        {
+            return attr.first != UA_ATTRIBUTEID_BROWSENAME && attr.first != UA_ATTRIBUTEID_DATATYPE && !consumed_attributes.contains(attr.first);
+        });
+}
+
+StatusResults NodesetExporterLoop::GetNodeAttributes(
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+    const std::pair<size_t, size_t>& node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes)
+{
+    PrepareNodeAttributesRequest(node_ids, node_range, node_classes_req_res, nodes_attr_req_res);
+    const auto value_indexes = TakeValuesOutOfRequest(nodes_attr_req_res);
+
     // The OPC UA standard for receiving attributes guarantees - The size and order of this list matches the size and order of the nodesToReadrequest
     // parameter. https://reference.opcfoundation.org/Core/Part4/v104/docs/5.10.2 I extend this rule to the library as well.
     if (!nodes_attr_req_res.at(0).attrs.empty()) // There should always be at least one node with an unnecessary number of attributes to fulfill the request.
@@ -96,9 +170,222 @@ StatusResults NodesetExporterLoop::GetNodeAttributes(
     {
         throw std::runtime_error("range_for_nodes.second - range_for_nodes.first != nodes_attr_req_res.size()");
     }
+    if (!value_indexes.empty())
+    {
+        return GetNodeValues(value_indexes, nodes_attr_req_res, chunked_value_nodes);
+    }
+    return StatusResults::Good;
+}
+
+std::vector<size_t> NodesetExporterLoop::TakeValuesOutOfRequest(std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res) const
+{
+    // When the reading of the large arrays in parts is enabled, the values are requested separately after ValueRank and ArrayDimensions are known.
+    std::vector<size_t> value_indexes;
+    if (m_number_of_max_array_elements_to_request_data == 0)
+    {
+        return value_indexes;
+    }
+    for (size_t index = 0; index < nodes_attr_req_res.size(); ++index)
+    {
+        if (nodes_attr_req_res.at(index).attrs.erase(UA_ATTRIBUTEID_VALUE) > 0)
+        {
+            value_indexes.push_back(index);
+        }
+    }
+    return value_indexes;
+}
+
+StatusResults NodesetExporterLoop::GetNodeValues(
+    const std::vector<size_t>& value_indexes,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes)
+{
+    m_logger.Trace("Method called: GetNodeValues()");
+
+    std::vector<IOpen62541::NodeAttributesRequestResponse> values_req_res;
+    std::vector<size_t> requested_indexes;
+    PrepareNodeValuesRequest(value_indexes, nodes_attr_req_res, chunked_value_nodes, values_req_res, requested_indexes);
+    if (values_req_res.empty())
+    {
+        return StatusResults::Good;
+    }
+
+    if (m_open62541_lib.ReadNodesAttributes(values_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        return StatusResults::Fail;
+    }
+    SetNodeValues(requested_indexes, values_req_res, nodes_attr_req_res);
+    return StatusResults::Good;
+}
+
+void NodesetExporterLoop::PrepareNodeValuesRequest(
+    const std::vector<size_t>& value_indexes,
+    const std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& values_req_res,
+    std::vector<size_t>& requested_indexes) const
+{
+    for (const auto index : value_indexes)
+    {
+        const auto& node_attrs = nodes_attr_req_res.at(index);
+        if (IsValueReadInChunks(node_attrs.attrs))
+        {
+            m_logger.Debug("The value of the node {} is read in parts while the document is written.", node_attrs.exp_node_id.ToString());
+            chunked_value_nodes.insert(node_attrs.exp_node_id);
+            continue;
+        }
+        values_req_res.push_back(IOpen62541::NodeAttributesRequestResponse{node_attrs.exp_node_id, {{UA_ATTRIBUTEID_VALUE, std::nullopt}}});
+        requested_indexes.push_back(index);
+    }
+}
+
+void NodesetExporterLoop::SetNodeValues(
+    const std::vector<size_t>& requested_indexes,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& values_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res) const
+{
+    if (values_req_res.size() != requested_indexes.size())
+    {
+        throw std::runtime_error("values_req_res.size() != requested_indexes.size()");
+    }
+    for (size_t index = 0; index < values_req_res.size(); ++index)
+    {
+        auto value = values_req_res.at(index).attrs.find(UA_ATTRIBUTEID_VALUE);
+        if (value != values_req_res.at(index).attrs.end())
+        {
+            nodes_attr_req_res.at(requested_indexes.at(index)).attrs.insert_or_assign(UA_ATTRIBUTEID_VALUE, std::move(value->second));
+        }
+    }
+}
+
+StatusResults NodesetExporterLoop::GetMissingDataTypeDefinitions(
+    const std::pair<size_t, size_t>& node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res)
+{
+    m_logger.Trace("Method called: GetMissingDataTypeDefinitions()");
+
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> data_type_ids;
+    std::vector<size_t> data_type_indexes;
+    for (size_t index = 0; index < nodes_attr_req_res.size(); ++index)
+    {
+        if (node_classes_req_res.at(node_range.first + index).node_class != UA_NODECLASS_DATATYPE)
+        {
+            continue;
+        }
+        const auto& node_attrs = nodes_attr_req_res.at(index);
+        const auto& node_id = node_attrs.exp_node_id;
+        // Only the requested but not received definition. Abstract types have no encoding and no description in the dictionary.
+        const auto definition = node_attrs.attrs.find(UA_ATTRIBUTEID_DATATYPEDEFINITION);
+        if (definition == node_attrs.attrs.end() || definition->second.has_value())
+        {
+            continue;
+        }
+        const auto is_abstract = node_attrs.attrs.find(UA_ATTRIBUTEID_ISABSTRACT);
+        if (is_abstract != node_attrs.attrs.end() && is_abstract->second.has_value())
+        {
+            const auto* const is_abstract_value = std::get_if<UA_Boolean>(&is_abstract->second.value());
+            if (is_abstract_value != nullptr && *is_abstract_value)
+            {
+                continue;
+            }
+        }
+        // The standard data types are not exported.
+        if (node_id.GetRef().nodeId.namespaceIndex == 0 && (!m_external_options.ns0_custom_nodes_ready_to_work || m_ns0_opcua_standard_node_ids.contains(node_id)))
+        {
+            continue;
+        }
+        data_type_ids.push_back(node_id);
+        data_type_indexes.push_back(index);
+    }
+    if (data_type_ids.empty())
+    {
+        return StatusResults::Good;
+    }
+
+    std::vector<std::optional<VariantsOfAttr>> definitions;
+    {
+        std::lock_guard<std::mutex> lock(m_data_type_definitions_mutex);
+        if (m_data_type_definitions.ResolveFromDictionaries(data_type_ids, definitions) == StatusResults::Fail)
+        {
+            return StatusResults::Fail;
+        }
+    }
+    for (size_t index = 0; index < definitions.size(); ++index)
+    {
+        if (definitions.at(index).has_value())
+        {
+            nodes_attr_req_res.at(data_type_indexes.at(index)).attrs.insert_or_assign(UA_ATTRIBUTEID_DATATYPEDEFINITION, std::move(definitions.at(index)));
+        }
+    }
     return StatusResults::Good;
 }
 
+bool NodesetExporterLoop::IsValueReadInChunks(const std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs) const
+{
+    const auto value_rank = attrs.find(UA_ATTRIBUTEID_VALUERANK);
+    if (value_rank == attrs.end() || !value_rank->second.has_value())
+    {
+        return false;
+    }
+    const auto* const value_rank_value = std::get_if<UA_Int32>(&value_rank->second.value());
+    if (value_rank_value == nullptr || *value_rank_value != UA_VALUERANK_ONE_DIMENSION)
+    {
+        return false;
+    }
+    // The length of the array is unknown, the value can be of any size.
+    const auto array_dimensions = attrs.find(UA_ATTRIBUTEID_ARRAYDIMENSIONS);
+    if (array_dimensions == attrs.end() || !array_dimensions->second.has_value())
+    {
+        return true;
+    }
+    const auto* const dimensions = std::get_if<std::vector<UA_UInt32>>(&array_dimensions->second.value());
+    if (dimensions == nullptr || dimensions->empty() || dimensions->front() == 0)
+    {
+        return true;
+    }
+    return dimensions->front() > m_number_of_max_array_elements_to_request_data;
+}
+
+NodeIntermediateModel::ValueChunkReader NodesetExporterLoop::MakeValueChunkReader(const UATypesContainer<UA_ExpandedNodeId>& node_id)
+{
+    return [this, node_id](const NodeIntermediateModel::ValueChunkHandler& handler) -> bool
+    {
+        const size_t chunk_size = m_number_of_max_array_elements_to_request_data;
+        for (size_t first_index = 0;; first_index += chunk_size)
+        {
+            UATypesContainer<UA_Variant> chunk(UA_TYPES_VARIANT);
+            if (m_open62541_lib.ReadNodeDataValueRange(node_id, first_index, chunk_size, chunk) == StatusResults::Fail) // REQUEST<-->RESPONSE
+            {
+                if (first_index != 0)
+                {
+                    return false;
+                }
+                // The data source does not support IndexRange, the value is read entirely.
+                m_logger.Warning("The value of the node {} cannot be read in parts, it is read entirely.", node_id.ToString());
+                UATypesContainer<UA_Variant> value(UA_TYPES_VARIANT);
+                if (m_open62541_lib.ReadNodeDataValue(node_id, value) == StatusResults::Fail) // REQUEST<-->RESPONSE
+                {
+                    return false;
+                }
+                return UA_Variant_isEmpty(&value.GetRef()) || handler(value.GetRef());
+            }
+            if (UA_Variant_isEmpty(&chunk.GetRef()))
+            {
+                return true;
+            }
+            if (!handler(chunk.GetRef()))
+            {
+                return false;
+            }
+            if (UA_Variant_isScalar(&chunk.GetRef()) || chunk.GetRef().arrayLength < chunk_size)
+            {
+                return true;
+            }
+        }
+    };
+}
+
 #pragma endregion Getting ID attribute
 
 
@@ -113,10 +400,17 @@ StatusResults NodesetExporterLoop::GetNodeReferences(
 
     // Request for obtaining links of all types for each node. According to indexation of links as with attributes.
     std::copy(node_ids.begin() + static_cast<int64_t>(node_range.first), node_ids.begin() + static_cast<int64_t>(node_range.second), std::back_inserter(node_references_req_res));
-    if (m_open62541_lib.ReadNodeReferences(node_references_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    auto status = m_open62541_lib.ReadNodeReferences(node_references_req_res); // REQUEST<-->RESPONSE
+    if (status == StatusResults::Fail)
     {
-        return StatusResults::Fail;
+        return status; // The sub-status is kept, since it can report a stop on request.
     }
+    return CheckNodeReferences(node_range, node_references_req_res);
+}
+
+StatusResults NodesetExporterLoop::CheckNodeReferences(const std::pair<size_t, size_t>& node_range, const std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res)
+{
+    m_logger.Trace("Method called: CheckNodeReferences()");
     // Check the statuses of each individual NodeId request
 
     for (size_t index = 0; index < node_references_req_res.size(); ++index)
@@ -140,84 +434,55 @@ StatusResults NodesetExporterLoop::GetNodeReferences(
     return StatusResults::Good;
 }
 
-StatusResults NodesetExporterLoop::KepServerRefFix(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res)
+StatusResults NodesetExporterLoop::FixQuirks(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res)
 {
-    // Checking for the presence of back references and generating them from text identifiers, as well as replacing the type HasTypeDefinition = BaseVariableType(62).
-    // We need to know in principle that there are no back references, even if we can't add them.
-    for (auto& node_ref : node_references_req_res) // Node
+    for (const auto& quirk_fixer : m_quirk_fixers)
     {
-        // If the node does not have a list of links, we miss the processing of such a node
-        if (node_ref.references.empty())
+        if (quirk_fixer->FixReferences(node_references_req_res) == StatusResults::Fail)
         {
-            continue;
+            m_logger.Error("The quirk fixer '{}' failed to fix the references.", quirk_fixer->GetName());
+            return StatusResults::Fail;
         }
+    }
+    return StatusResults::Good;
+}
 
-        bool are_we_have_inverse_ref = false;
-        bool are_we_found_base_variable_type = false;
-        for (auto& ref : node_ref.references) // References
+void NodesetExporterLoop::SplitLocalizedAttributes(std::map<UA_AttributeId, std::optional<VariantsOfAttr>>& attrs, NodeIntermediateModel& nim)
+{
+    for (const auto attr_id : {UA_ATTRIBUTEID_DISPLAYNAME, UA_ATTRIBUTEID_DESCRIPTION})
+    {
+        const auto attr = attrs.find(attr_id);
+        if (attr == attrs.end() || !attr->second.has_value())
         {
-            // For unknown reasons, in KepServer, nodes of the Variable class are set to HasTypeDefinition = BaseVariableType(62).
-            // This abstract type cannot be used directly on nodes of this class. When importing nodesetloader we get an error.
-            // In this case, the easiest option is to change HasTypeDefinition to a more specific, although still generic, but not abstract type BaseDataVariableType(63).
-            if (UA_NodeId_equal(&ref.GetRef().referenceTypeId, &m_ns0id_hastypedefenition_node_id) && UA_NodeId_equal(&ref.GetRef().nodeId.nodeId, &m_ns0id_basevariabletype_node_id))
-            {
-                m_logger.Warning("For node {} we find reference with HasTypeDefinition = BaseVariableType(62). Change to BaseDataVariableType(63).", node_ref.exp_node_id.ToString());
-                ref.GetRef().nodeId.nodeId.identifier.numeric = UA_NS0ID_BASEDATAVARIABLETYPE; // NOLINT(cppcoreguidelines-pro-type-union-access)
-                are_we_found_base_variable_type = true;
-            }
-
-            // Only interested in back references
-            if (!ref.GetRef().isForward)
-            {
-                are_we_have_inverse_ref = true;
-            }
-
-            // If both search criteria found what they were looking for, we can end the loop early, ensuring O(n) in the worst case.
-            if (are_we_found_base_variable_type && are_we_have_inverse_ref)
-            {
-                break;
-            }
+            continue;
         }
-
-        if (are_we_have_inverse_ref)
+        const auto* const text = std::get_if<UATypesContainer<UA_LocalizedText>>(&attr->second.value());
+        if (text == nullptr)
         {
             continue;
         }
-
-        m_logger.Warning("For node {} we didn't find a inverse reference. Let's just add one.", node_ref.exp_node_id.ToString());
-        // Algorithm for adding back references from text node identifiers.
-        // The algorithm does not use deep analysis to identify reference types. All ReferenceTypes will be of type HasComponent.
-        // There is also no solution for analyzing the namespace in case the parent and child may have different namespaces.
-        if (node_ref.exp_node_id.GetRef().nodeId.identifierType == UA_NodeIdType::UA_NODEIDTYPE_STRING)
-        {
-            // Create one back reference that will point to the parent
-            UATypesContainer<UA_ReferenceDescription> new_ref(UA_TYPES_REFERENCEDESCRIPTION);
-            UA_NodeId_copy(&m_ns0id_hascomponent_node_id, &new_ref.GetRef().referenceTypeId);
-            new_ref.GetRef().isForward = false;
-            auto child_str = node_ref.exp_node_id.ToString();
-            auto found_child_dot_index = child_str.find_last_of('.');
-            // If a separator dot is found, remove the identifier after the last separator dot in the identifier, including the dot itself.
-            if (found_child_dot_index != std::string::npos)
-            {
-                child_str = child_str.substr(0, found_child_dot_index);
-            }
-            else // All nodes for which the parent cannot be determined further, I substitute the most basic node of the object.
-            {
-                child_str = "i=" + std::to_string(UA_NS0ID_OBJECTSFOLDER);
-            }
-            auto parent_node_id = UA_EXPANDEDNODEID(child_str.c_str());
-            UA_ExpandedNodeId_copy(&parent_node_id, &new_ref.GetRef().nodeId);
-            UA_ExpandedNodeId_clear(&parent_node_id); // Since we don’t know whether the object will be a string object (with a pointer) or a numeric one, so we’ll clean it up.
-            m_logger.Debug("For node {} adding reference:\n {}", node_ref.exp_node_id.ToString(), new_ref.ToString());
-            node_ref.references.push_back(new_ref);
+        const std::string_view locale(reinterpret_cast<const char*>(text->GetRef().locale.data), text->GetRef().locale.length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (locale != open62541::locales::multi_locale_id)
+        {
+            continue;
         }
-        else
+        std::vector<UATypesContainer<UA_LocalizedText>> texts;
+        if (open62541::locales::SplitMultiLocaleText(text->GetRef(), m_external_options.locales, texts) == StatusResults::Fail)
         {
-            m_logger.Error("Node {} didn't have a string ID, so we can't build a inverse reference.", node_ref.exp_node_id.ToString());
-            return StatusResults::Fail;
+            m_logger.Warning("The localized text of the node {} with the locale \"mul\" can't be split: {}", nim.GetExpNodeId().ToString(), text->ToString());
+            continue;
+        }
+        if (texts.empty())
+        {
+            attr->second = std::nullopt; // The text has no translations.
+            continue;
+        }
+        attr->second = VariantsOfAttr(texts.front());
+        if (texts.size() > 1)
+        {
+            nim.SetLocalizedTexts(attr_id, std::move(texts));
         }
     }
-    return StatusResults::Good;
 }
 
 inline void NodesetExporterLoop::DeleteFailedReferences(size_t node_index, std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res)
@@ -243,8 +508,9 @@ inline void NodesetExporterLoop::DeleteFailedReferences(size_t node_index, std::
                     node_in_container.ToString());
                 continue; // Don't add a reference
             }
-            // Check for a reference to a missing node filtered in the external environment
-            if (!m_node_ids_set_copy.contains(node_in_container))
+            // Check for a reference to a missing node filtered in the external environment. The nodes of the type closure are exported in their own list,
+            // with the cross-list deduplication the nodes of the other lists are exported by their lists.
+            if (!m_node_ids_set_copy.contains(node_in_container) && !m_type_closure_node_ids.contains(node_in_container) && !m_first_list_of_nodes.contains(node_in_container))
             {
                 m_logger.Warning(
                     "The {} reference {} ==> {} is IGNORED because this node is missing",
@@ -390,14 +656,15 @@ inline void NodesetExporterLoop::CreateAttributesForStartNode(
     // Add attributes of the start node
     auto start_node_id_name = common::UaGuidIdentifierToStdString(node_attr_res_req.at(start_node_index).exp_node_id.GetRef().nodeId);
     const auto start_node_id_namepspace = node_attr_res_req.at(start_node_index).exp_node_id.GetRef().nodeId.namespaceIndex;
+    // The attributes are added regardless of the attribute profile, the node is created from scratch.
     node_attr_res_req.at(start_node_index)
-        .attrs.at(UA_ATTRIBUTEID_BROWSENAME)
+        .attrs[UA_ATTRIBUTEID_BROWSENAME]
         .emplace(UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(start_node_id_namepspace, start_node_id_name.data()), UA_TYPES_QUALIFIEDNAME));
     node_attr_res_req.at(start_node_index)
-        .attrs.at(UA_ATTRIBUTEID_DISPLAYNAME)
+        .attrs[UA_ATTRIBUTEID_DISPLAYNAME]
         .emplace(UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT(std::string().data(), start_node_id_name.data()), UA_TYPES_LOCALIZEDTEXT));
     node_attr_res_req.at(start_node_index)
-        .attrs.at(UA_ATTRIBUTEID_DESCRIPTION)
+        .attrs[UA_ATTRIBUTEID_DESCRIPTION]
         .emplace(UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT(std::string().data(), std::string("This is autogenerated start node.").data()), UA_TYPES_LOCALIZEDTEXT));
 
     // Adding reference to the type of node
@@ -484,7 +751,8 @@ inline std::unique_ptr<UATypesContainer<UA_ExpandedNodeId>> NodesetExporterLoop:
     case UA_NODECLASS_DATATYPE:
         return std::make_unique<UATypesContainer<UA_ExpandedNodeId>>(UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE), UA_TYPES_EXPANDEDNODEID));
     default:
-        throw(std::out_of_range("node_classes_req_res[index].node.class"));
+        m_logger.Error("GetBaseObjectType: the node class {} has no base type.", static_cast<int>(node_class));
+        return nullptr;
     }
 }
 
@@ -527,39 +795,54 @@ StatusResults NodesetExporterLoop::GetAliases(const std::vector<NodeIntermediate
     {
         if (node_intermediate_obj.GetNodeClass() == UA_NodeClass::UA_NODECLASS_VARIABLE || node_intermediate_obj.GetNodeClass() == UA_NodeClass::UA_NODECLASS_VARIABLETYPE)
         {
-            try
+            // todo I came up with the idea of producing not a string in the GetDataTypeAlias method, but a pair of values std::pair<std::string, UATypesContainer<UA_NodeId>>,
+            //  then there will be no need to separately request UA_ATTRIBUTEID_DATATYPE.
+            // Checking that the option is filled with the required type.
+            const auto datatype_attr = node_intermediate_obj.GetAttributes().find(UA_AttributeId::UA_ATTRIBUTEID_DATATYPE);
+            if (datatype_attr == node_intermediate_obj.GetAttributes().end())
             {
-                // todo I came up with the idea of producing not a string in the GetDataTypeAlias method, but a pair of values std::pair<std::string, UATypesContainer<UA_NodeId>>,
-                //  then there will be no need to separately request UA_ATTRIBUTEID_DATATYPE.
-                // Checking that the option is filled with the required type.
-                const auto datatype_attr = node_intermediate_obj.GetAttributes().at(UA_AttributeId::UA_ATTRIBUTEID_DATATYPE);
-                if (!datatype_attr.has_value())
-                {
-                    m_logger.Warning("DATATYPE has an empty value in NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
-                    continue;
-                }
-                if (const auto* const data_type_node_id = std::get_if<UATypesContainer<UA_NodeId>>(&datatype_attr.value()))
+                m_logger.Warning("DATATYPE attribute is missing from NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
+            }
+            else if (!datatype_attr->second.has_value())
+            {
+                m_logger.Warning("DATATYPE has an empty value in NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
+                continue;
+            }
+            else if (const auto* const data_type_node_id = std::get_if<UATypesContainer<UA_NodeId>>(&datatype_attr->second.value()))
+            {
+                // Save only if the datatype belongs to the OPC UA base space.
+                if (data_type_node_id->GetRef().namespaceIndex == 0)
                 {
-                    // Save only if the datatype belongs to the OPC UA base space.
-                    if (data_type_node_id->GetRef().namespaceIndex == 0)
+                    auto alias_str = node_intermediate_obj.GetDataTypeAlias();
+                    // Alias must be in only one instance
+                    if (!aliases.contains(alias_str))
                     {
-                        auto alias_str = node_intermediate_obj.GetDataTypeAlias();
-                        // Alias must be in only one instance
-                        if (!aliases.contains(alias_str))
-                        {
-                            aliases.insert({alias_str, *data_type_node_id});
-                        }
+                        aliases.insert({alias_str, *data_type_node_id});
                     }
                 }
-                else
-                {
-                    m_logger.Critical("DATATYPE has wrong type in NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
-                    return StatusResults::Fail;
-                }
             }
-            catch (std::out_of_range&)
+            else
             {
-                m_logger.Warning("DATATYPE attribute is missing from NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
+                m_logger.Critical("DATATYPE has wrong type in NodeID: {}", node_intermediate_obj.GetExpNodeId().ToString());
+                return StatusResults::Fail;
+            }
+        }
+
+        // Add the standard data types of the definition fields as aliases
+        if (node_intermediate_obj.GetNodeClass() == UA_NodeClass::UA_NODECLASS_DATATYPE)
+        {
+            const auto definition = node_intermediate_obj.GetAttributes().find(UA_AttributeId::UA_ATTRIBUTEID_DATATYPEDEFINITION);
+            if (definition != node_intermediate_obj.GetAttributes().end() && definition->second.has_value())
+            {
+                std::lock_guard<std::mutex> lock(m_data_type_definitions_mutex);
+                for (const auto& [alias_str, data_type_node_id] : m_data_type_definitions.GetFieldDataTypeAliases(node_intermediate_obj.GetExpNodeId(), definition->second.value()))
+                {
+                    // Alias must be in only one instance
+                    if (!aliases.contains(alias_str))
+                    {
+                        aliases.insert({alias_str, data_type_node_id});
+                    }
+                }
             }
         }
 
@@ -597,6 +880,12 @@ inline StatusResults NodesetExporterLoop::GetNodeClasses(
         return status;
     }
 
+    CorrectStartNodeClass(node_range, node_classes_req_res);
+    return status;
+}
+
+void NodesetExporterLoop::CorrectStartNodeClass(const std::pair<size_t, size_t>& node_range, std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res)
+{
     // In the case of operation in flat components, as well as the mode of creating the starting nodes, I denote the class of the created start node. Only the start node is processed and
     // just not part of the standard, in fact, the main search goes by the node not i=85.
     if (m_external_options.flat_list_of_nodes.is_enable && m_external_options.flat_list_of_nodes.create_missing_start_node && node_range.first == 0
@@ -606,8 +895,6 @@ inline StatusResults NodesetExporterLoop::GetNodeClasses(
         node_classes_req_res.at(0).node_class = UA_NodeClass::UA_NODECLASS_OBJECT;
         node_classes_req_res.at(0).result_code = UA_STATUSCODE_GOOD; // Так-как узла не существует в случае режима плоских узлов, то нужно игнорировать эту ошибку, а значит выставить хорошее значение.
     }
-
-    return status;
 }
 
 // todo The method below is very huge and smeared, refactoring to break the method into individual entities, which are more clearly
@@ -635,7 +922,12 @@ StatusResults NodesetExporterLoop::GetNodesData(
 
     // Preparing the request and getting node attributes
     std::vector<IOpen62541::NodeAttributesRequestResponse> nodes_attr_req_res; // NODE ATTRIBUTES  (Attribute Service Set)
-    if (GetNodeAttributes(node_ids.second, node_range, node_classes_req_res, nodes_attr_req_res) == StatusResults::Fail)
+    std::set<UATypesContainer<UA_ExpandedNodeId>> chunked_value_nodes;
+    if (GetNodeAttributes(node_ids.second, node_range, node_classes_req_res, nodes_attr_req_res, chunked_value_nodes) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+    if (GetMissingDataTypeDefinitions(node_range, node_classes_req_res, nodes_attr_req_res) == StatusResults::Fail)
     {
         return StatusResults::Fail;
     }
@@ -643,13 +935,28 @@ StatusResults NodesetExporterLoop::GetNodesData(
     // Prepare a request and get a list of references for each node
     // todo Is it worth getting references of absolutely all nodes from the selection, or should those that are not currently being processed not be included in the list?
     std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res; // NODE REFERENCES (View Service Set)
-    if (GetNodeReferences(node_ids.second, node_range, node_references_req_res) == StatusResults::Fail)
+    auto ref_status = GetNodeReferences(node_ids.second, node_range, node_references_req_res);
+    if (ref_status == StatusResults::Fail)
     {
-        return StatusResults::Fail;
+        return ref_status;
     }
 
-    // Processing references for working with the KepServer server (and similar ones with similar features)
-    if (KepServerRefFix(node_references_req_res) == StatusResults::Fail)
+    return ProcessNodesData(node_ids, node_range, node_classes_req_res, nodes_attr_req_res, node_references_req_res, chunked_value_nodes, node_models);
+}
+
+StatusResults NodesetExporterLoop::ProcessNodesData(
+    const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+    const std::pair<size_t, size_t>& node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+    const std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+    std::vector<NodeIntermediateModel>& node_models)
+{
+    m_logger.Trace("Method called: ProcessNodesData()");
+
+    // Processing references for working with the servers that deviate from the specification (KepServer and similar ones with similar features)
+    if (FixQuirks(node_references_req_res) == StatusResults::Fail)
     {
         return StatusResults::Fail;
     }
@@ -727,7 +1034,8 @@ StatusResults NodesetExporterLoop::GetNodesData(
 
         // The function of processing references of starting nodes.
         // If the starting node does not have a binding to i=85, then such a node creates a reference to the one indicated in the variable parent_start_node_replacer.
-        if (index == 0)
+        // The list of the type closure has no start node, its nodes keep their own parents.
+        if (IsStartNode(node_ids, index))
         {
             AddStartNodeIfNotFound(index_from_zero, node_classes_req_res.at(index).node_class, node_references_req_res, has_start_node_subtype_detected, start_node_reverse_reference_counter);
         }
@@ -743,13 +1051,15 @@ StatusResults NodesetExporterLoop::GetNodesData(
         if (has_start_node_subtype_detected && start_node_reverse_reference_counter == 0)
         {
             t_parent_node_id = GetBaseObjectType(node_classes_req_res.at(index).node_class);
-
-            m_logger.Warning("The start Node has a node TYPE class without any HasSubtype reverse reference. Adding a new HasSubtype parent reference {}.", t_parent_node_id->ToString());
-            UATypesContainer<UA_ReferenceDescription> insertion_ref_desc_main(UA_TYPES_REFERENCEDESCRIPTION);
-            insertion_ref_desc_main.GetRef().isForward = false;
-            UA_NodeId_copy(&m_ns0id_hassubtype_node_id, &insertion_ref_desc_main.GetRef().referenceTypeId);
-            UA_NodeId_copy(&t_parent_node_id->GetRef().nodeId, &insertion_ref_desc_main.GetRef().nodeId.nodeId);
-            node_references_req_res.at(index_from_zero).references.emplace(node_references_req_res.at(index_from_zero).references.end(), std::move(insertion_ref_desc_main));
+            if (t_parent_node_id)
+            {
+                m_logger.Warning("The start Node has a node TYPE class without any HasSubtype reverse reference. Adding a new HasSubtype parent reference {}.", t_parent_node_id->ToString());
+                UATypesContainer<UA_ReferenceDescription> insertion_ref_desc_main(UA_TYPES_REFERENCEDESCRIPTION);
+                insertion_ref_desc_main.GetRef().isForward = false;
+                UA_NodeId_copy(&m_ns0id_hassubtype_node_id, &insertion_ref_desc_main.GetRef().referenceTypeId);
+                UA_NodeId_copy(&t_parent_node_id->GetRef().nodeId, &insertion_ref_desc_main.GetRef().nodeId.nodeId);
+                node_references_req_res.at(index_from_zero).references.emplace(node_references_req_res.at(index_from_zero).references.end(), std::move(insertion_ref_desc_main));
+            }
         }
 
         // Filter: Analyze the node to determine if it belongs to the parent of the ignored type. If the parent was not found, then we should not add this node, because according to the hierarchy,
@@ -785,8 +1095,15 @@ StatusResults NodesetExporterLoop::GetNodesData(
         nim.SetNodeReferences(std::move(node_references_req_res.at(index_from_zero).references)); // Перемещение
 
         // NodeAttributes
+        SplitLocalizedAttributes(nodes_attr_req_res.at(index_from_zero).attrs, nim);
         nim.SetAttributes(std::move(nodes_attr_req_res.at(index_from_zero).attrs)); // Перемещение
 
+        // The value of the large array is read in parts while the encoder writes the document
+        if (chunked_value_nodes.contains(node_ids.second.at(index)))
+        {
+            nim.SetValueChunkReader(MakeValueChunkReader(node_ids.second.at(index)));
+        }
+
         if (m_logger.IsEnable(LogLevel::Debug))
         {
             // To avoid constantly executing ToString before sending it to Debug, I check the logging level in advance.
@@ -877,46 +1194,352 @@ StatusResults NodesetExporterLoop::CheckStartNodesOnNS0()
     return StatusResults::Good;
 }
 
-#pragma endregion Методы получения и формирования данных
+#pragma region Type closure
 
-StatusResults NodesetExporterLoop::ExportNodes(const std::vector<NodeIntermediateModel>& list_of_nodes_data)
+StatusResults NodesetExporterLoop::CollectTypeClosure()
 {
-    m_logger.Trace("Method called: ExportNodes()");
-    m_logger.Info("Export nodes...");
-    m_logger.Debug("List of added nodes:");
-    StatusResults status_result = StatusResults::Good;
+    m_logger.Trace("Method called: CollectTypeClosure()");
 
-    for (const auto& node_model : list_of_nodes_data)
+    if (!m_external_options.type_closure)
     {
-        if (m_logger.IsEnable(common::LogLevel::Debug))
+        return StatusResults::Good;
+    }
+    m_logger.Info("Collecting the type closure...");
+
+    // Each node is requested once: the nodes of the lists and all the nodes found are known.
+    std::set<UATypesContainer<UA_ExpandedNodeId>> known_node_ids;
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> round_node_ids;
+    for (const auto& list_of_nodes_from_one_start_node : m_node_ids)
+    {
+        for (const auto& node_id : list_of_nodes_from_one_start_node.second)
         {
-            m_logger.Debug("Node: {}, node class: {}", node_model.GetExpNodeId().ToString(), static_cast<int>(node_model.GetNodeClass()));
+            if (known_node_ids.insert(node_id).second)
+            {
+                round_node_ids.push_back(node_id);
+            }
         }
+    }
 
-        switch (node_model.GetNodeClass())
+    // The classes of the nodes of the lists are unknown yet, the classes of the nodes found are taken from the references.
+    std::vector<UA_NodeClass> round_node_classes;
+    round_node_classes.reserve(round_node_ids.size());
+    for (const auto& node_range : SplitIntoBatches(round_node_ids.size()))
+    {
+        std::vector<IOpen62541::NodeClassesRequestResponse> node_classes_req_res;
+        node_classes_req_res.reserve(node_range.second - node_range.first);
+        std::copy(
+            round_node_ids.begin() + static_cast<int64_t>(node_range.first),
+            round_node_ids.begin() + static_cast<int64_t>(node_range.second),
+            std::back_inserter(node_classes_req_res));
+        if (m_open62541_lib.ReadNodeClasses(node_classes_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
         {
-        case UA_NODECLASS_OBJECT:
-            status_result = m_export_encoder.AddNodeObject(node_model);
-            ++m_exported_nodes.object_nodes;
-            break;
-        case UA_NODECLASS_VARIABLE:
-            status_result = m_export_encoder.AddNodeVariable(node_model);
-            ++m_exported_nodes.variable_nodes;
-            break;
-        case UA_NODECLASS_OBJECTTYPE:
-            status_result = m_export_encoder.AddNodeObjectType(node_model);
-            ++m_exported_nodes.objecttype_nodes;
-            break;
-        case UA_NODECLASS_VARIABLETYPE:
-            status_result = m_export_encoder.AddNodeVariableType(node_model);
-            ++m_exported_nodes.variabletype_nodes;
-            break;
-        case UA_NODECLASS_REFERENCETYPE:
-            status_result = m_export_encoder.AddNodeReferenceType(node_model);
-            ++m_exported_nodes.referencetype_nodes;
-            break;
-        case UA_NODECLASS_DATATYPE:
-            status_result = m_export_encoder.AddNodeDataType(node_model);
+            m_logger.Error("Unable to get node classes for the type closure.");
+            return StatusResults::Fail;
+        }
+        for (const auto& node_class : node_classes_req_res)
+        {
+            round_node_classes.push_back(node_class.node_class);
+        }
+    }
+
+    std::vector<std::vector<UATypesContainer<UA_ExpandedNodeId>>> closure_rounds;
+    bool is_closure_round = false;
+    while (!round_node_ids.empty())
+    {
+        if (m_external_options.stop_token.stop_requested())
+        {
+            return StatusResults::Good; // The stop is processed by the export loop.
+        }
+
+        std::vector<TypeDependency> dependencies;
+        for (const auto& node_range : SplitIntoBatches(round_node_ids.size()))
+        {
+            if (GetTypeDependencies(round_node_ids, round_node_classes, node_range, is_closure_round, dependencies) == StatusResults::Fail)
+            {
+                return StatusResults::Fail;
+            }
+        }
+
+        round_node_ids.clear();
+        round_node_classes.clear();
+        for (auto& dependency : dependencies)
+        {
+            const auto& node_id = dependency.first.GetRef();
+            // Only the local nodes outside the namespace of the OPC UA standard. The custom ns=0 types are not collected, they can't be told apart from the standard ones.
+            if (node_id.serverIndex != 0 || node_id.nodeId.namespaceIndex == 0 || m_ignored_nodeclasses.contains(dependency.second))
+            {
+                continue;
+            }
+            if (known_node_ids.insert(dependency.first).second)
+            {
+                round_node_ids.push_back(std::move(dependency.first));
+                round_node_classes.push_back(dependency.second);
+            }
+        }
+        if (!round_node_ids.empty())
+        {
+            m_logger.Debug("Type closure round {}: {} new nodes", closure_rounds.size() + 1, round_node_ids.size());
+            closure_rounds.push_back(round_node_ids);
+        }
+        is_closure_round = true;
+    }
+
+    if (closure_rounds.empty())
+    {
+        m_logger.Info("The type closure has no missing nodes.");
+        return StatusResults::Good;
+    }
+
+    // The supertypes are found in the deeper rounds, they are exported ahead of their subtypes and instances.
+    std::vector<ExpandedNodeId> closure_node_ids;
+    for (auto round = closure_rounds.rbegin(); round != closure_rounds.rend(); ++round)
+    {
+        for (auto& node_id : *round)
+        {
+            m_type_closure_node_ids.insert(node_id);
+            closure_node_ids.push_back(std::move(node_id));
+        }
+    }
+    m_logger.Info("The type closure adds {} nodes in {} rounds.", closure_node_ids.size(), closure_rounds.size());
+    m_node_ids.insert_or_assign(type_closure_list_name, std::move(closure_node_ids));
+    return StatusResults::Good;
+}
+
+StatusResults NodesetExporterLoop::GetTypeDependencies(
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+    const std::vector<UA_NodeClass>& node_classes,
+    const std::pair<size_t, size_t>& node_range,
+    bool is_closure_round,
+    std::vector<TypeDependency>& dependencies)
+{
+    m_logger.Trace("Method called: GetTypeDependencies()");
+
+    std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res;
+    node_references_req_res.reserve(node_range.second - node_range.first);
+    std::copy(node_ids.begin() + static_cast<int64_t>(node_range.first), node_ids.begin() + static_cast<int64_t>(node_range.second), std::back_inserter(node_references_req_res));
+    if (m_open62541_lib.ReadNodeReferences(node_references_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        m_logger.Error("Unable to get node references for the type closure.");
+        return StatusResults::Fail;
+    }
+
+    // Only the attributes that refer to the types: DataType of the variables and DataTypeDefinition of the data types.
+    std::vector<IOpen62541::NodeAttributesRequestResponse> nodes_attr_req_res;
+    for (size_t index = node_range.first; index < node_range.second; ++index)
+    {
+        switch (node_classes.at(index))
+        {
+        case UA_NODECLASS_VARIABLE:
+        case UA_NODECLASS_VARIABLETYPE:
+            nodes_attr_req_res.push_back(IOpen62541::NodeAttributesRequestResponse{node_ids.at(index), {{UA_ATTRIBUTEID_DATATYPE, std::nullopt}}});
+            break;
+        case UA_NODECLASS_DATATYPE:
+            nodes_attr_req_res.push_back(IOpen62541::NodeAttributesRequestResponse{node_ids.at(index), {{UA_ATTRIBUTEID_DATATYPEDEFINITION, std::nullopt}}});
+            break;
+        default:
+            break;
+        }
+    }
+    if (!nodes_attr_req_res.empty() && m_open62541_lib.ReadNodesAttributes(nodes_attr_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        m_logger.Error("Unable to get node attributes for the type closure.");
+        return StatusResults::Fail;
+    }
+
+    // The types are referenced by NodeId, the ExpandedNodeId of the dependency is local.
+    const auto add_dependency = [&dependencies](const UA_NodeId& node_id, UA_NodeClass node_class)
+    {
+        UATypesContainer<UA_ExpandedNodeId> exp_node_id(UA_TYPES_EXPANDEDNODEID);
+        UA_NodeId_copy(&node_id, &exp_node_id.GetRef().nodeId);
+        dependencies.emplace_back(std::move(exp_node_id), node_class);
+    };
+    for (size_t index = 0; index < node_references_req_res.size(); ++index)
+    {
+        const bool is_type_class_node = m_types_nodeclasses.contains(node_classes.at(node_range.first + index));
+        for (const auto& ref : node_references_req_res.at(index).references)
+        {
+            const auto& ref_desc = ref.GetRef();
+            add_dependency(ref_desc.referenceTypeId, UA_NODECLASS_REFERENCETYPE);
+
+            const bool is_has_subtype = UA_NodeId_equal(&ref_desc.referenceTypeId, &m_ns0id_hassubtype_node_id);
+            const bool is_dependency =
+                (ref_desc.isForward && UA_NodeId_equal(&ref_desc.referenceTypeId, &m_ns0id_hastypedefenition_node_id)) // Type definition
+                || (!ref_desc.isForward && is_has_subtype && is_type_class_node) // Supertype
+                // Instance declarations of the types and their children, only for the nodes of the closure - the lists contain their own children.
+                || (is_closure_round && ref_desc.isForward && !is_has_subtype && m_hierarhical_references.contains(UATypesContainer(ref_desc.referenceTypeId, UA_TYPES_NODEID)));
+            if (is_dependency)
+            {
+                dependencies.emplace_back(UATypesContainer<UA_ExpandedNodeId>(ref_desc.nodeId, UA_TYPES_EXPANDEDNODEID), ref_desc.nodeClass);
+            }
+        }
+    }
+
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> data_type_ids; // Data types without DataTypeDefinition, resolved from the dictionaries.
+    const auto add_definition_dependencies = [&add_dependency](const VariantsOfAttr& definition)
+    {
+        const auto* const structure = std::get_if<UATypesContainer<UA_StructureDefinition>>(&definition);
+        if (structure == nullptr)
+        {
+            return;
+        }
+        for (size_t field_index = 0; field_index < structure->GetRef().fieldsSize; ++field_index)
+        {
+            add_dependency(structure->GetRef().fields[field_index].dataType, UA_NODECLASS_DATATYPE); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    };
+    for (const auto& node_attrs : nodes_attr_req_res)
+    {
+        for (const auto& attr : node_attrs.attrs)
+        {
+            if (!attr.second.has_value())
+            {
+                if (attr.first == UA_ATTRIBUTEID_DATATYPEDEFINITION && node_attrs.exp_node_id.GetRef().nodeId.namespaceIndex != 0)
+                {
+                    data_type_ids.push_back(node_attrs.exp_node_id);
+                }
+                continue;
+            }
+            if (attr.first == UA_ATTRIBUTEID_DATATYPE)
+            {
+                if (const auto* const data_type = std::get_if<UATypesContainer<UA_NodeId>>(&attr.second.value()))
+                {
+                    add_dependency(data_type->GetRef(), UA_NODECLASS_DATATYPE);
+                }
+            }
+            else
+            {
+                add_definition_dependencies(attr.second.value());
+            }
+        }
+    }
+
+    // The definitions are stored in the cache and are not requested again during the export.
+    if (!data_type_ids.empty())
+    {
+        std::vector<std::optional<VariantsOfAttr>> definitions;
+        if (m_data_type_definitions.ResolveFromDictionaries(data_type_ids, definitions) == StatusResults::Fail)
+        {
+            return StatusResults::Fail;
+        }
+        for (const auto& definition : definitions)
+        {
+            if (definition.has_value())
+            {
+                add_definition_dependencies(definition.value());
+            }
+        }
+    }
+    return StatusResults::Good;
+}
+
+std::vector<std::reference_wrapper<std::pair<const std::string, std::vector<ExpandedNodeId>>>> NodesetExporterLoop::GetListsInExportOrder()
+{
+    m_logger.Trace("Method called: GetListsInExportOrder()");
+
+    std::vector<std::reference_wrapper<std::pair<const std::string, std::vector<ExpandedNodeId>>>> lists;
+    lists.reserve(m_node_ids.size());
+    const auto type_closure_list = m_node_ids.find(type_closure_list_name);
+    if (type_closure_list != m_node_ids.end())
+    {
+        lists.emplace_back(*type_closure_list);
+    }
+    for (auto& list_of_nodes_from_one_start_node : m_node_ids)
+    {
+        if (list_of_nodes_from_one_start_node.first != type_closure_list_name)
+        {
+            lists.emplace_back(list_of_nodes_from_one_start_node);
+        }
+    }
+    return lists;
+}
+
+#pragma endregion Type closure
+
+#pragma region Cross-list deduplication
+
+void NodesetExporterLoop::MapNodesToFirstLists()
+{
+    m_logger.Trace("Method called: MapNodesToFirstLists()");
+
+    m_first_list_of_nodes.clear();
+    for (auto list_in_export_order : GetListsInExportOrder())
+    {
+        const auto& list_of_nodes = list_in_export_order.get();
+        for (const auto& node_id : list_of_nodes.second)
+        {
+            m_first_list_of_nodes.emplace(node_id, std::cref(list_of_nodes.first)); // The node of the previous list is not replaced.
+        }
+    }
+}
+
+void NodesetExporterLoop::DeduplicateAcrossLists(std::pair<const std::string, std::vector<ExpandedNodeId>>& list_of_nodes)
+{
+    m_logger.Trace("Method called: DeduplicateAcrossLists()");
+
+    const auto is_exported_by_previous_list = [this, &list_of_nodes](const ExpandedNodeId& node_id)
+    {
+        const auto first_list = m_first_list_of_nodes.find(node_id);
+        return first_list != m_first_list_of_nodes.end() && &first_list->second.get() != &list_of_nodes.first;
+    };
+    m_is_start_node_deduplicated
+        = list_of_nodes.first != type_closure_list_name && !list_of_nodes.second.empty() && is_exported_by_previous_list(list_of_nodes.second.front());
+    const auto number_of_nodes = list_of_nodes.second.size();
+    std::erase_if(list_of_nodes.second, is_exported_by_previous_list);
+    const auto number_of_deduplicated_nodes = number_of_nodes - list_of_nodes.second.size();
+    m_number_of_deduplicated_nodes[list_of_nodes.first] = number_of_deduplicated_nodes;
+    if (number_of_deduplicated_nodes > 0)
+    {
+        m_logger.Info(
+            "List '{}': {} of {} nodes have already been exported by the previous lists and are skipped{}",
+            list_of_nodes.first,
+            number_of_deduplicated_nodes,
+            number_of_nodes,
+            m_is_start_node_deduplicated ? ", including the start node" : "");
+    }
+}
+
+#pragma endregion Cross-list deduplication
+
+#pragma endregion Методы получения и формирования данных
+
+StatusResults NodesetExporterLoop::ExportNodes(const std::vector<NodeIntermediateModel>& list_of_nodes_data)
+{
+    m_logger.Trace("Method called: ExportNodes()");
+    m_logger.Info("Export nodes...");
+    m_logger.Debug("List of added nodes:");
+    StatusResults status_result = StatusResults::Good;
+
+    for (const auto& node_model : list_of_nodes_data)
+    {
+        if (m_logger.IsEnable(common::LogLevel::Debug))
+        {
+            m_logger.Debug("Node: {}, node class: {}", node_model.GetExpNodeId().ToString(), static_cast<int>(node_model.GetNodeClass()));
+        }
+
+        switch (node_model.GetNodeClass())
+        {
+        case UA_NODECLASS_OBJECT:
+            status_result = m_export_encoder.AddNodeObject(node_model);
+            ++m_exported_nodes.object_nodes;
+            break;
+        case UA_NODECLASS_VARIABLE:
+            status_result = m_export_encoder.AddNodeVariable(node_model);
+            ++m_exported_nodes.variable_nodes;
+            break;
+        case UA_NODECLASS_OBJECTTYPE:
+            status_result = m_export_encoder.AddNodeObjectType(node_model);
+            ++m_exported_nodes.objecttype_nodes;
+            break;
+        case UA_NODECLASS_VARIABLETYPE:
+            status_result = m_export_encoder.AddNodeVariableType(node_model);
+            ++m_exported_nodes.variabletype_nodes;
+            break;
+        case UA_NODECLASS_REFERENCETYPE:
+            status_result = m_export_encoder.AddNodeReferenceType(node_model);
+            ++m_exported_nodes.referencetype_nodes;
+            break;
+        case UA_NODECLASS_DATATYPE:
+            status_result = m_export_encoder.AddNodeDataType(node_model);
             ++m_exported_nodes.datatype_nodes;
             break;
         default:
@@ -930,11 +1553,32 @@ StatusResults NodesetExporterLoop::ExportNodes(const std::vector<NodeIntermediat
     return status_result;
 }
 
+StatusResults NodesetExporterLoop::EndPartialExport(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases)
+{
+    m_logger.Trace("Method called: EndPartialExport()");
+    m_logger.Warning("The export was stopped on request. The unloading will be closed as partial.");
+    if (m_export_encoder.MarkAsPartial() == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::EndFail};
+    }
+    if (!aliases.empty() && ExportAliases(aliases) == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::ExportAliasesFail};
+    }
+    if (End() == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::EndFail};
+    }
+    m_logger.Info("Exported statistic:\n{}", m_exported_nodes.ToString());
+    m_logger.Info("Total exported nodes: {}", m_exported_nodes.GetSumm());
+    return StatusResults{StatusResults::Fail, StatusResults::Cancelled};
+}
+
 #pragma endregion Data export methods
 
-StatusResults NodesetExporterLoop::StartExport()
+StatusResults NodesetExporterLoop::PrepareExport()
 {
-    m_logger.Trace("Method called: StartExport()");
+    m_logger.Trace("Method called: PrepareExport()");
 
     // Check for ns=0 in starting nodes. It is better to do this in a separate cycle before starting longer processing.
     // https://reference.opcfoundation.org/DI/v102/docs/11.2#_Ref252866620
@@ -946,6 +1590,20 @@ StatusResults NodesetExporterLoop::StartExport()
     }
 
     auto timer = PREPARE_TIMER(m_external_options.is_perf_timer_enable);
+    if (CollectTypeClosure() == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::TypeClosureFail};
+    }
+    GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "CollectTypeClosure operation: ", "");
+
+    if (m_external_options.cross_list_deduplication)
+    {
+        RESET_TIMER(timer);
+        MapNodesToFirstLists();
+        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "MapNodesToFirstLists operation: ", "");
+    }
+
+    RESET_TIMER(timer);
     // Actions before starting export
     if (Begin() == StatusResults::Fail)
     {
@@ -968,13 +1626,73 @@ StatusResults NodesetExporterLoop::StartExport()
         return StatusResults{StatusResults::Fail, StatusResults::ExportNamespacesFail};
     }
     GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "ExportNamespaces operation: ", "");
+    return StatusResults::Good;
+}
 
+StatusResults NodesetExporterLoop::FinishExport(const std::map<std::string, UATypesContainer<UA_NodeId>>& aliases)
+{
+    m_logger.Trace("Method called: FinishExport()");
+
+    auto timer = PREPARE_TIMER(m_external_options.is_perf_timer_enable);
+    if (!aliases.empty())
+    {
+        RESET_TIMER(timer);
+        // Exporting host type name aliases
+        if (ExportAliases(aliases) == StatusResults::Fail)
+        {
+            return StatusResults{StatusResults::Fail, StatusResults::ExportAliasesFail};
+        }
+        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "ExportAliases operation: ", "");
+    }
+    else
+    {
+        m_logger.Warning("aliases is empty.");
+    }
+
+    RESET_TIMER(timer);
+    // Actions at the end of the export - uploading to a buffer or to a file
+    if (End() == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::EndFail};
+    }
+    GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "End operation: ", "");
+    m_logger.Info("Exported statistic:\n{}", m_exported_nodes.ToString());
+    m_logger.Info("Total exported nodes: {}", m_exported_nodes.GetSumm());
+    return StatusResults::Good;
+}
+
+StatusResults NodesetExporterLoop::StartExport()
+{
+    m_logger.Trace("Method called: StartExport()");
+
+    auto prepare_status = PrepareExport();
+    if (prepare_status == StatusResults::Fail)
+    {
+        return prepare_status;
+    }
+
+    auto timer = PREPARE_TIMER(m_external_options.is_perf_timer_enable);
     std::map<std::string, UATypesContainer<UA_NodeId>> aliases;
-    for (auto& list_of_nodes_from_one_start_node : m_node_ids)
+    for (auto list_in_export_order : GetListsInExportOrder())
     {
+        auto& list_of_nodes_from_one_start_node = list_in_export_order.get();
+        // The stop is checked before each list of nodes, the lists already processed remain in the unloading.
+        if (m_external_options.stop_token.stop_requested())
+        {
+            return EndPartialExport(aliases);
+        }
 
 #pragma region Node Filtering - Remove duplicates(all NodeIds are unique) and remove nodes from ns0
         RESET_TIMER(timer);
+        // The nodes exported by the previous lists are neither requested nor exported again.
+        if (m_external_options.cross_list_deduplication)
+        {
+            DeduplicateAcrossLists(list_of_nodes_from_one_start_node);
+            if (list_of_nodes_from_one_start_node.second.empty())
+            {
+                continue;
+            }
+        }
         // I move the finished copy of the set of nodes for quick search in the field for further actions.
         // For each iteration of the start node - its own set.
         m_node_ids_set_copy = Distinct(list_of_nodes_from_one_start_node.second);
@@ -1043,8 +1761,13 @@ StatusResults NodesetExporterLoop::StartExport()
 
             RESET_TIMER(timer);
             // Получение необходимых данных по узлам
-            if (GetNodesData(list_of_nodes_from_one_start_node, range, node_classes_req_res, node_intermediate_obj) == StatusResults::Fail)
+            auto nodes_data_status = GetNodesData(list_of_nodes_from_one_start_node, range, node_classes_req_res, node_intermediate_obj);
+            if (nodes_data_status == StatusResults::Fail)
             {
+                if (nodes_data_status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    return EndPartialExport(aliases);
+                }
                 return StatusResults{StatusResults::Fail, StatusResults::GetNodesDataFail};
             }
             GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "GetNodesData operation: ", "");
@@ -1081,13 +1804,19 @@ StatusResults NodesetExporterLoop::StartExport()
 
             // A local function that allows you to provide an algorithm for batch processing of data by working with ranges.
             // This function is used to run various routines where you need to work with NodeID, but with a certain number in one cycle.
-            const auto func_in_nodes_loop =
-                [&list_of_nodes_from_one_start_node, number_of_max_nodes_to_request_data = m_number_of_max_nodes_to_request_data](const std::function<StatusResults(std::pair<size_t, size_t>&)>& func)
+            // The stop is checked before each batch, so the batch already started is always finished.
+            const auto func_in_nodes_loop = [&list_of_nodes_from_one_start_node,
+                                             number_of_max_nodes_to_request_data = m_number_of_max_nodes_to_request_data,
+                                             &stop_token = m_external_options.stop_token](const std::function<StatusResults(std::pair<size_t, size_t>&)>& func)
             {
                 std::pair<size_t, size_t> node_range;
                 size_t number_of_nodes_per_request = 0;
                 for (size_t index = 0; index < list_of_nodes_from_one_start_node.second.size(); index += number_of_nodes_per_request)
                 {
+                    if (stop_token.stop_requested())
+                    {
+                        return StatusResults{StatusResults::Fail, StatusResults::Cancelled};
+                    }
                     number_of_nodes_per_request = list_of_nodes_from_one_start_node.second.size() - index >= number_of_max_nodes_to_request_data
                                                       ? number_of_max_nodes_to_request_data
                                                       : list_of_nodes_from_one_start_node.second.size() - index;
@@ -1135,8 +1864,13 @@ StatusResults NodesetExporterLoop::StartExport()
                 RESET_TIMER(timer);
                 std::vector<NodeIntermediateModel> node_intermediate_obj;
                 // Getting the data you need on the nodes
-                if (GetNodesData(list_of_nodes_from_one_start_node, node_range, node_classes_req_res, node_intermediate_obj) == StatusResults::Fail)
+                auto nodes_data_status = GetNodesData(list_of_nodes_from_one_start_node, node_range, node_classes_req_res, node_intermediate_obj);
+                if (nodes_data_status == StatusResults::Fail)
                 {
+                    if (nodes_data_status.GetSubStatus() == StatusResults::Cancelled)
+                    {
+                        return nodes_data_status;
+                    }
                     return StatusResults{StatusResults::Fail, StatusResults::GetNodesDataFail};
                 }
                 GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "GetNodesData operation: ", "");
@@ -1174,8 +1908,13 @@ StatusResults NodesetExporterLoop::StartExport()
 
             RESET_TIMER(timer);
             // You need to get all the classes before you start processing the rest of the data, because you filter nodes and references by node classes in the same way.
-            if (func_in_nodes_loop(get_node_classes) == StatusResults::Fail)
+            auto node_classes_status = func_in_nodes_loop(get_node_classes);
+            if (node_classes_status == StatusResults::Fail)
             {
+                if (node_classes_status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    return EndPartialExport(aliases);
+                }
                 return StatusResults{StatusResults::Fail, StatusResults::GetNodeClassesFail};
             }
             GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "get_node_classes operation: ", "");
@@ -1189,9 +1928,13 @@ StatusResults NodesetExporterLoop::StartExport()
             // it is necessary to synchronize the indexes of the classes and other structures of index-dependent nodes!
             // Batch retrieval of all other data and export.
             RESET_TIMER(timer);
-            const auto status = func_in_nodes_loop(get_node_data_and_export);
+            auto status = func_in_nodes_loop(get_node_data_and_export);
             if (status == StatusResults::Fail)
             {
+                if (status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    return EndPartialExport(aliases);
+                }
                 return status;
             }
             GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "get_node_data_and_export operations: ", "");
@@ -1199,33 +1942,336 @@ StatusResults NodesetExporterLoop::StartExport()
         }
     }
 
-    if (!aliases.empty())
+    return FinishExport(aliases);
+}
+
+#pragma region Coroutine export engine
+
+std::vector<std::pair<size_t, size_t>> NodesetExporterLoop::SplitIntoBatches(size_t number_of_nodes) const
+{
+    m_logger.Trace("Method called: SplitIntoBatches()");
+    std::vector<std::pair<size_t, size_t>> node_ranges;
+    if (number_of_nodes <= m_number_of_max_nodes_to_request_data || m_number_of_max_nodes_to_request_data == 0)
     {
-        RESET_TIMER(timer);
-        // Exporting host type name aliases
-        if (ExportAliases(aliases) == StatusResults::Fail)
+        node_ranges.emplace_back(0, number_of_nodes);
+        return node_ranges;
+    }
+    for (size_t index = 0; index < number_of_nodes; index += m_number_of_max_nodes_to_request_data)
+    {
+        node_ranges.emplace_back(index, std::min<size_t>(index + m_number_of_max_nodes_to_request_data, number_of_nodes));
+    }
+    return node_ranges;
+}
+
+Task<StatusResults> NodesetExporterLoop::GetNodeClassesAsync(
+    IAsyncOpen62541& async_open62541_lib,
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+    std::pair<size_t, size_t> node_range,
+    std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res)
+{
+    m_logger.Trace("Method called: GetNodeClassesAsync()");
+    // As in the synchronous engine, the stop is checked before each batch, the batch already started is always finished.
+    if (m_external_options.stop_token.stop_requested())
+    {
+        co_return StatusResults{StatusResults::Fail, StatusResults::Cancelled};
+    }
+
+    std::copy(node_ids.begin() + static_cast<int64_t>(node_range.first), node_ids.begin() + static_cast<int64_t>(node_range.second), std::back_inserter(node_classes_req_res));
+    const auto status = co_await async_open62541_lib.ReadNodeClasses(node_classes_req_res); // REQUEST<-->RESPONSE
+    if (node_classes_req_res.empty())
+    {
+        m_logger.Error("Unable to get node classes from server.");
+        co_return status;
+    }
+    CorrectStartNodeClass(node_range, node_classes_req_res);
+    co_return status;
+}
+
+Task<StatusResults> NodesetExporterLoop::GetNodesDataAsync(
+    IAsyncOpen62541& async_open62541_lib,
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+    std::pair<size_t, size_t> node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+    std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes)
+{
+    m_logger.Trace("Method called: GetNodesDataAsync()");
+
+    // Preparing the request and getting node attributes, see GetNodeAttributes.
+    PrepareNodeAttributesRequest(node_ids, node_range, node_classes_req_res, nodes_attr_req_res);
+    const auto value_indexes = TakeValuesOutOfRequest(nodes_attr_req_res);
+    if (!nodes_attr_req_res.at(0).attrs.empty())
+    {
+        auto attr_status = co_await async_open62541_lib.ReadNodesAttributes(nodes_attr_req_res); // REQUEST<-->RESPONSE
+        if (attr_status == StatusResults::Fail)
         {
-            return StatusResults{StatusResults::Fail, StatusResults::ExportAliasesFail};
+            co_return StatusResults::Fail;
         }
-        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "ExportAliases operation: ", "");
     }
-    else
+
+    // The values are requested after the other attributes, see GetNodeValues.
+    std::vector<IOpen62541::NodeAttributesRequestResponse> values_req_res;
+    std::vector<size_t> requested_indexes;
+    PrepareNodeValuesRequest(value_indexes, nodes_attr_req_res, chunked_value_nodes, values_req_res, requested_indexes);
+    if (!values_req_res.empty())
     {
-        m_logger.Warning("aliases is empty.");
+        auto value_status = co_await async_open62541_lib.ReadNodesAttributes(values_req_res); // REQUEST<-->RESPONSE
+        if (value_status == StatusResults::Fail)
+        {
+            co_return StatusResults::Fail;
+        }
+        SetNodeValues(requested_indexes, values_req_res, nodes_attr_req_res);
     }
 
-    RESET_TIMER(timer);
-    // Actions at the end of the export - uploading to a buffer or to a file
-    if (End() == StatusResults::Fail)
+    // The definitions not returned by the server are taken from the dictionaries, see GetMissingDataTypeDefinitions.
+    // The cache makes its requests through the synchronous IOpen62541, so the call is serialized with the requests of the other batches.
+    const auto is_data_type = [](const IOpen62541::NodeClassesRequestResponse& node_class)
     {
-        return StatusResults{StatusResults::Fail, StatusResults::EndFail};
+        return node_class.node_class == UA_NODECLASS_DATATYPE;
+    };
+    if (std::any_of(
+            node_classes_req_res.begin() + static_cast<int64_t>(node_range.first), node_classes_req_res.begin() + static_cast<int64_t>(node_range.second), is_data_type))
+    {
+        auto definition_status = co_await async_open62541_lib.ExecuteBlockingCall(
+            [this, &node_range, &node_classes_req_res, &nodes_attr_req_res]
+            {
+                return GetMissingDataTypeDefinitions(node_range, node_classes_req_res, nodes_attr_req_res);
+            });
+        if (definition_status == StatusResults::Fail)
+        {
+            co_return StatusResults::Fail;
+        }
     }
-    GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "End operation: ", "");
-    m_logger.Info("Exported statistic:\n{}", m_exported_nodes.ToString());
-    m_logger.Info("Total exported nodes: {}", m_exported_nodes.GetSumm());
+
+    // Prepare a request and get a list of references for each node, see GetNodeReferences.
+    std::copy(node_ids.begin() + static_cast<int64_t>(node_range.first), node_ids.begin() + static_cast<int64_t>(node_range.second), std::back_inserter(node_references_req_res));
+    auto ref_status = co_await async_open62541_lib.ReadNodeReferences(node_references_req_res); // REQUEST<-->RESPONSE
+    if (ref_status == StatusResults::Fail)
+    {
+        co_return ref_status; // The sub-status is kept, since it can report a stop on request.
+    }
+    co_return CheckNodeReferences(node_range, node_references_req_res);
+}
+
+StatusResults NodesetExporterLoop::ExportNodesData(
+    const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+    const std::pair<size_t, size_t>& node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    std::vector<IOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res,
+    std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res,
+    const std::set<UATypesContainer<UA_ExpandedNodeId>>& chunked_value_nodes,
+    std::map<std::string, UATypesContainer<UA_NodeId>>& aliases)
+{
+    m_logger.Trace("Method called: ExportNodesData()");
+    std::vector<NodeIntermediateModel> node_intermediate_obj;
+    if (ProcessNodesData(node_ids, node_range, node_classes_req_res, nodes_attr_req_res, node_references_req_res, chunked_value_nodes, node_intermediate_obj)
+        == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::GetNodesDataFail};
+    }
+
+    // It may be that in the batch there will be one node, which is eliminated, for example, a method, it will not be a mistake.
+    if (node_intermediate_obj.empty())
+    {
+        m_logger.Warning("node_intermediate_obj is empty.");
+        return StatusResults::Good;
+    }
+    if (GetAliases(node_intermediate_obj, aliases) == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::GetAliasesFail};
+    }
+    if (ExportNodes(node_intermediate_obj) == StatusResults::Fail)
+    {
+        return StatusResults{StatusResults::Fail, StatusResults::ExportNodesFail};
+    }
+    m_logger.Info("Part of exported nodes: {}", node_intermediate_obj.size());
     return StatusResults::Good;
 }
 
+Task<StatusResults> NodesetExporterLoop::ExportNodesBatchAsync(
+    IAsyncOpen62541& async_open62541_lib,
+    const std::pair<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>& node_ids,
+    std::pair<size_t, size_t> node_range,
+    const std::vector<IOpen62541::NodeClassesRequestResponse>& node_classes_req_res,
+    BatchesContext& context,
+    size_t turn)
+{
+    m_logger.Trace("Method called: ExportNodesBatchAsync()");
+    StatusResults status = StatusResults::Good;
+    std::exception_ptr exception;
+    std::vector<IOpen62541::NodeAttributesRequestResponse> nodes_attr_req_res; // NODE ATTRIBUTES  (Attribute Service Set)
+    std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res; // NODE REFERENCES (View Service Set)
+    std::set<UATypesContainer<UA_ExpandedNodeId>> chunked_value_nodes;
+
+    // Stage 1 - requests. Runs simultaneously with the other batches.
+    if (m_external_options.stop_token.stop_requested())
+    {
+        status = StatusResults{StatusResults::Fail, StatusResults::Cancelled};
+    }
+    else if (!context.is_aborted)
+    {
+        try
+        {
+            status = co_await GetNodesDataAsync(async_open62541_lib, node_ids.second, node_range, node_classes_req_res, nodes_attr_req_res, node_references_req_res, chunked_value_nodes);
+            if (status == StatusResults::Fail && status.GetSubStatus() != StatusResults::Cancelled)
+            {
+                status = StatusResults{StatusResults::Fail, StatusResults::GetNodesDataFail};
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+    }
+
+    // Stage 2 - processing and export. Strictly in the order of the batches, so the unloading is the same as in the synchronous engine.
+    // The turn is passed on any result, otherwise the following batches will never be resumed.
+    co_await context.turns.WaitTurn(turn);
+    if (!exception && status == StatusResults::Good && !context.is_aborted)
+    {
+        try
+        {
+            status = ExportNodesData(node_ids, node_range, node_classes_req_res, nodes_attr_req_res, node_references_req_res, chunked_value_nodes, context.aliases);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+    }
+    if (exception || status == StatusResults::Fail)
+    {
+        context.is_aborted = true;
+    }
+    context.turns.NextTurn();
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+    co_return status;
+}
+
+Task<StatusResults> NodesetExporterLoop::ExportAsync(IAsyncOpen62541& async_open62541_lib, size_t max_batches_in_flight)
+{
+    m_logger.Trace("Method called: ExportAsync()");
+
+    auto prepare_status = PrepareExport();
+    if (prepare_status == StatusResults::Fail)
+    {
+        co_return prepare_status;
+    }
+
+    auto timer = PREPARE_TIMER(m_external_options.is_perf_timer_enable);
+    std::map<std::string, UATypesContainer<UA_NodeId>> aliases;
+    for (auto list_in_export_order : GetListsInExportOrder())
+    {
+        auto& list_of_nodes_from_one_start_node = list_in_export_order.get();
+        if (m_external_options.stop_token.stop_requested())
+        {
+            co_return EndPartialExport(aliases);
+        }
+
+        RESET_TIMER(timer);
+        if (m_external_options.cross_list_deduplication)
+        {
+            DeduplicateAcrossLists(list_of_nodes_from_one_start_node);
+            if (list_of_nodes_from_one_start_node.second.empty())
+            {
+                continue;
+            }
+        }
+        m_node_ids_set_copy = Distinct(list_of_nodes_from_one_start_node.second);
+        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "Distinct operation: ", "");
+        const auto node_ranges = SplitIntoBatches(list_of_nodes_from_one_start_node.second.size());
+        m_logger.Debug("ExportAsync(), batches: {}, no more than {} at the same time", node_ranges.size(), max_batches_in_flight);
+
+        // You need to get all the classes before you start processing the rest of the data, because you filter nodes and references by node classes in the same way.
+        RESET_TIMER(timer);
+        std::vector<std::vector<IOpen62541::NodeClassesRequestResponse>> parts_of_node_classes_req_res(node_ranges.size());
+        std::vector<Task<StatusResults>> node_classes_tasks;
+        node_classes_tasks.reserve(node_ranges.size());
+        for (size_t index = 0; index < node_ranges.size(); index++)
+        {
+            node_classes_tasks.push_back(GetNodeClassesAsync(async_open62541_lib, list_of_nodes_from_one_start_node.second, node_ranges.at(index), parts_of_node_classes_req_res.at(index)));
+        }
+        auto node_classes_statuses = co_await WhenAllBounded<StatusResults>(std::move(node_classes_tasks), max_batches_in_flight);
+
+        std::vector<IOpen62541::NodeClassesRequestResponse> node_classes_req_res; // NODE CLASSES (Attribute Service Set)
+        for (size_t index = 0; index < node_ranges.size(); index++)
+        {
+            auto& node_classes_status = node_classes_statuses.at(index);
+            if (node_classes_status == StatusResults::Fail)
+            {
+                if (node_classes_status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    co_return EndPartialExport(aliases);
+                }
+                co_return StatusResults{StatusResults::Fail, StatusResults::GetNodeClassesFail};
+            }
+            auto& part_of_node_classes_req_res = parts_of_node_classes_req_res.at(index);
+            std::move(part_of_node_classes_req_res.begin(), part_of_node_classes_req_res.end(), std::back_inserter(node_classes_req_res));
+        }
+        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "GetNodeClassesAsync operations: ", "");
+
+        if (list_of_nodes_from_one_start_node.second.size() != node_classes_req_res.size())
+        {
+            throw std::runtime_error("list_of_nodes_from_one_start_node.second.size() != node_classes_req_res.size()");
+        }
+
+        // Create a list of ignored nodes
+        for (const auto& nodes : node_classes_req_res)
+        {
+            // As in the synchronous engine, the bad result of the node class query is an error only when the nodes are requested in one batch,
+            // otherwise such a node is ignored by the unspecified class.
+            if (node_ranges.size() == 1 && UA_StatusCode_isBad(nodes.result_code))
+            {
+                m_logger.Error("Node '{}' returned a bad result in the node class query: {}", nodes.exp_node_id.ToString(), UA_StatusCode_name(nodes.result_code));
+                co_return StatusResults::Fail;
+            }
+            if (m_ignored_nodeclasses.contains(nodes.node_class))
+            {
+                m_ignored_node_ids_by_classes.insert(nodes.exp_node_id);
+            }
+        }
+
+        // Batch retrieval of all other data and export. The requests of the batches are executed simultaneously, the export is in the order of the batches.
+        RESET_TIMER(timer);
+        BatchesContext context{.aliases = aliases};
+        std::vector<Task<StatusResults>> batch_tasks;
+        batch_tasks.reserve(node_ranges.size());
+        for (size_t index = 0; index < node_ranges.size(); index++)
+        {
+            batch_tasks.push_back(ExportNodesBatchAsync(async_open62541_lib, list_of_nodes_from_one_start_node, node_ranges.at(index), node_classes_req_res, context, index));
+        }
+        auto batch_statuses = co_await WhenAllBounded<StatusResults>(std::move(batch_tasks), max_batches_in_flight);
+        GET_TIME_ELAPSED_FMT_FORMAT(timer, m_logger.Info, "ExportNodesBatchAsync operations: ", "");
+
+        // The first error in the order of the batches is the cause, the following batches were not exported.
+        for (auto& batch_status : batch_statuses)
+        {
+            if (batch_status == StatusResults::Fail)
+            {
+                if (batch_status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    co_return EndPartialExport(aliases);
+                }
+                co_return batch_status;
+            }
+        }
+    }
+
+    co_return FinishExport(aliases);
+}
+
+StatusResults NodesetExporterLoop::StartCoroutineExport(IAsyncOpen62541& async_open62541_lib, size_t max_batches_in_flight)
+{
+    m_logger.Trace("Method called: StartCoroutineExport()");
+    return SyncWait(ExportAsync(async_open62541_lib, max_batches_in_flight == 0 ? default_max_batches_in_flight : max_batches_in_flight));
+}
+
+#pragma endregion Coroutine export engine
+
 // todo To form in Realtime through the Browse operation is so it is not clear how to isolate only hierarchical ReferenceType in statics,
 //  and will also need to add custom-made RefereneType there.
 const std::map<UATypesContainer<UA_NodeId>, std::string> NodesetExporterLoop::m_hierarhical_references{
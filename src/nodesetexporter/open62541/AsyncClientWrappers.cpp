@@ -0,0 +1,684 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/AsyncClientWrappers.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace nodesetexporter::open62541
+{
+
+namespace
+{
+/**
+ * @brief The state of a set of requests sent at the same time. Lives on the stack of the waiting thread until all responses are received.
+ *        The sending counters are used only in the event loop thread, the completion counter is protected by a mutex.
+ */
+struct AsyncRequestsSet
+{
+    struct Slot
+    {
+        AsyncRequestsSet* owner = nullptr;
+        const void* request = nullptr;
+        void* response = nullptr;
+    };
+
+    UA_Client* client = nullptr;
+    const UA_DataType* request_type = nullptr;
+    const UA_DataType* response_type = nullptr;
+    std::vector<Slot> slots;
+    size_t max_in_flight = 1;
+    size_t next_to_send = 0;
+    size_t in_flight = 0;
+
+    std::mutex mutex;
+    std::condition_variable completed_cv;
+    size_t completed = 0;
+};
+
+/**
+ * @brief Marking the completion of requests. It must be the last access to the set in the event loop thread,
+ *        since after the last completion the waiting thread destroys the set.
+ */
+void MarkCompleted(AsyncRequestsSet& set, size_t count)
+{
+    std::lock_guard<std::mutex> lock(set.mutex);
+    set.completed += count;
+    set.completed_cv.notify_all(); // Under the lock, otherwise the set can be destroyed before the notification.
+}
+
+void OnAsyncResponse(UA_Client* client, void* userdata, UA_UInt32 request_id, void* response);
+
+/**
+ * @brief Sending the next requests of the set within the limit of requests in flight.
+ * @return Number of requests that could not be sent. The callback is not called for them, the error is written to the response header.
+ */
+size_t SendNextRequests(AsyncRequestsSet& set)
+{
+    size_t failed = 0;
+    while (set.in_flight < set.max_in_flight && set.next_to_send < set.slots.size())
+    {
+        auto& slot = set.slots.at(set.next_to_send);
+        set.next_to_send++;
+        auto status = UA_Client_sendAsyncRequest(set.client, slot.request, set.request_type, OnAsyncResponse, set.response_type, &slot, nullptr); //<-- ASYNC REQUEST
+        if (UA_StatusCode_isBad(status))
+        {
+            // Each response structure of the services begins with the response header.
+            static_cast<UA_ResponseHeader*>(slot.response)->serviceResult = status;
+            failed++;
+            continue;
+        }
+        set.in_flight++;
+    }
+    return failed;
+}
+
+void OnAsyncResponse(UA_Client* /*client*/, void* userdata, UA_UInt32 /*request_id*/, void* response)
+{
+    auto& slot = *static_cast<AsyncRequestsSet::Slot*>(userdata);
+    auto& set = *slot.owner;
+    // The library clears the response after the callback, so the content is moved to the slot, and the original is left empty.
+    std::memcpy(slot.response, response, set.response_type->memSize);
+    UA_init(response, set.response_type);
+    set.in_flight--;
+    auto failed = SendNextRequests(set);
+    MarkCompleted(set, failed + 1);
+}
+
+// Structures to ensure that the responses are cleared when exiting the processing function.
+template <typename TResponse, void (*Clear)(TResponse*)>
+struct ResponsesWithAutoClear // NOLINT(cppcoreguidelines-special-member-functions)
+{
+    explicit ResponsesWithAutoClear(size_t size)
+        : values(size)
+    {
+    }
+    ~ResponsesWithAutoClear()
+    {
+        for (auto& value : values)
+        {
+            Clear(&value);
+        }
+    }
+    std::vector<TResponse> values;
+};
+
+using ReadResponsesWithAutoClear = ResponsesWithAutoClear<UA_ReadResponse, UA_ReadResponse_clear>;
+using BrowseResponsesWithAutoClear = ResponsesWithAutoClear<UA_BrowseResponse, UA_BrowseResponse_clear>;
+using BrowseNextResponsesWithAutoClear = ResponsesWithAutoClear<UA_BrowseNextResponse, UA_BrowseNextResponse_clear>;
+
+} // namespace
+
+template <typename TRequest, typename TResponse>
+StatusResults Open62541AsyncClientWrapper::SendRequestsAndWait(
+    std::vector<TRequest>& requests,
+    std::vector<TResponse>& responses,
+    const UA_DataType& request_type,
+    const UA_DataType& response_type)
+{
+    m_logger.Trace("Method called: SendRequestsAndWait()");
+    if (requests.size() != responses.size())
+    {
+        throw std::runtime_error("requests.size() != responses.size()");
+    }
+    if (requests.empty())
+    {
+        return StatusResults::Good;
+    }
+
+    AsyncRequestsSet set;
+    set.client = &m_ua_client;
+    set.request_type = &request_type;
+    set.response_type = &response_type;
+    set.max_in_flight = m_max_requests_in_flight;
+    set.slots.reserve(requests.size());
+    for (size_t index = 0; index < requests.size(); index++)
+    {
+        set.slots.push_back({&set, &requests.at(index), &responses.at(index)});
+    }
+    m_logger.Debug("Sending {} requests, no more than {} at the same time", requests.size(), set.max_in_flight);
+
+    m_dispatcher(
+        [&set]
+        {
+            auto failed = SendNextRequests(set);
+            if (failed != 0)
+            {
+                MarkCompleted(set, failed);
+            }
+        });
+
+    std::unique_lock<std::mutex> lock(set.mutex);
+    set.completed_cv.wait(
+        lock,
+        [&set]
+        {
+            return set.completed == set.slots.size();
+        });
+    return StatusResults::Good;
+}
+
+size_t Open62541AsyncClientWrapper::GetOperationsPerRequest(size_t operations) const
+{
+    if (m_max_operations_per_request != 0)
+    {
+        return m_max_operations_per_request;
+    }
+    return std::max<size_t>(1, (operations + m_max_requests_in_flight - 1) / m_max_requests_in_flight);
+}
+
+StatusResults Open62541AsyncClientWrapper::BrowseNext(
+    std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>>& continuation_points,
+    std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+{
+    m_logger.Trace("Method called: BrowseNext()");
+    while (!continuation_points.empty())
+    {
+        // A view of the continuation points as a continuous array, the data is owned by continuation_points.
+        std::vector<UA_ByteString> continuation_points_view;
+        continuation_points_view.reserve(continuation_points.size());
+        for (const auto& continuation_point : continuation_points)
+        {
+            continuation_points_view.push_back(continuation_point.second.GetRef());
+        }
+
+        const auto per_request = GetOperationsPerRequest(continuation_points_view.size());
+        std::vector<UA_BrowseNextRequest> requests;
+        for (size_t offset = 0; offset < continuation_points_view.size(); offset += per_request)
+        {
+            UA_BrowseNextRequest request;
+            UA_BrowseNextRequest_init(&request);
+            request.releaseContinuationPoints = UA_FALSE;
+            request.continuationPoints = &continuation_points_view.at(offset);
+            request.continuationPointsSize = std::min(per_request, continuation_points_view.size() - offset);
+            requests.push_back(request);
+        }
+        BrowseNextResponsesWithAutoClear responses(requests.size());
+        if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_BROWSENEXTREQUEST], UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE]) != StatusResults::Good)
+        {
+            return StatusResults::Fail;
+        }
+
+        std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>> next_continuation_points;
+        size_t point_index = 0;
+        for (size_t request_index = 0; request_index < requests.size(); request_index++)
+        {
+            const auto& response = responses.values.at(request_index);
+            if (UA_StatusCode_isBad(response.responseHeader.serviceResult))
+            {
+                m_logger.Error("Browse Next has bad status '{}' in response.", UA_StatusCode_name(response.responseHeader.serviceResult));
+                return StatusResults::Fail;
+            }
+            if (UA_StatusCode_isUncertain(response.responseHeader.serviceResult))
+            {
+                m_logger.Warning("Browse Next has uncertain status '{}' in response.", UA_StatusCode_name(response.responseHeader.serviceResult));
+            }
+            if (response.results == nullptr)
+            {
+                throw std::runtime_error("response.results == nullptr");
+            }
+            if (response.resultsSize != requests.at(request_index).continuationPointsSize)
+            {
+                throw std::runtime_error("response.resultsSize != continuationPointsSize");
+            }
+
+            for (size_t result_index = 0; result_index < response.resultsSize; result_index++, point_index++)
+            {
+                const auto& result = response.results[result_index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                const auto node_index = continuation_points.at(point_index).first;
+                if (UA_StatusCode_isBad(result.statusCode))
+                {
+                    m_logger.Warning(
+                        "UA_BrowseResult has bad status '{}' of node {} in response.",
+                        UA_StatusCode_name(result.statusCode),
+                        node_references_structure_lists.at(node_index).exp_node_id.ToString());
+                }
+                if (UA_StatusCode_isUncertain(result.statusCode))
+                {
+                    m_logger.Warning(
+                        "UA_BrowseResult has uncertain status '{}' of node {} in response.",
+                        UA_StatusCode_name(result.statusCode),
+                        node_references_structure_lists.at(node_index).exp_node_id.ToString());
+                }
+                m_logger.Debug("{} references received", result.referencesSize);
+                for (size_t ref_index = 0; ref_index < result.referencesSize; ref_index++)
+                {
+                    node_references_structure_lists.at(node_index)
+                        .references.emplace_back(result.references[ref_index], UA_TYPES_REFERENCEDESCRIPTION); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                }
+                if (result.continuationPoint.length != 0)
+                {
+                    next_continuation_points.emplace_back(node_index, UATypesContainer<UA_ByteString>(result.continuationPoint, UA_TYPES_BYTESTRING));
+                }
+            }
+        }
+        continuation_points = std::move(next_continuation_points);
+    }
+    return StatusResults::Good;
+}
+
+void Open62541AsyncClientWrapper::ReleaseContinuationPoints(const std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>>& continuation_points)
+{
+    m_logger.Trace("Method called: ReleaseContinuationPoints()");
+    std::vector<UA_ByteString> continuation_points_view;
+    continuation_points_view.reserve(continuation_points.size());
+    for (const auto& continuation_point : continuation_points)
+    {
+        continuation_points_view.push_back(continuation_point.second.GetRef());
+    }
+
+    std::vector<UA_BrowseNextRequest> requests(1);
+    UA_BrowseNextRequest_init(&requests.at(0));
+    requests.at(0).releaseContinuationPoints = UA_TRUE;
+    requests.at(0).continuationPoints = continuation_points_view.data();
+    requests.at(0).continuationPointsSize = continuation_points_view.size();
+    BrowseNextResponsesWithAutoClear responses(requests.size());
+    if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_BROWSENEXTREQUEST], UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE]) != StatusResults::Good
+        || UA_StatusCode_isBad(responses.values.at(0).responseHeader.serviceResult))
+    {
+        m_logger.Warning("Release of the continuation points has bad status '{}' in response.", UA_StatusCode_name(responses.values.at(0).responseHeader.serviceResult));
+    }
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodesAttributes(std::vector<UA_ReadValueId>& read_value_ids, const std::function<void(size_t, UA_DataValue&, UA_NodeId&, UA_UInt32)>& set_data)
+{
+    m_logger.Trace("Method called: ReadNodesAttributes()");
+    // The requests are created on the stack without a class wrapper, they refer to the parts of read_value_ids by pointer and do not own them.
+    const auto per_request = GetOperationsPerRequest(read_value_ids.size());
+    std::vector<UA_ReadRequest> requests;
+    for (size_t offset = 0; offset < read_value_ids.size(); offset += per_request)
+    {
+        UA_ReadRequest request;
+        UA_ReadRequest_init(&request);
+        request.nodesToRead = &read_value_ids.at(offset);
+        request.nodesToReadSize = std::min(per_request, read_value_ids.size() - offset);
+        requests.push_back(request);
+    }
+
+    ReadResponsesWithAutoClear responses(requests.size());
+    if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_READREQUEST], UA_TYPES[UA_TYPES_READRESPONSE]) != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    size_t offset = 0;
+    for (size_t request_index = 0; request_index < requests.size(); request_index++)
+    {
+        auto& response = responses.values.at(request_index);
+        if (UA_StatusCode_isBad(response.responseHeader.serviceResult))
+        {
+            m_logger.Error("ReadNodesAttributes has error from Open62541: {}", UA_StatusCode_name(response.responseHeader.serviceResult));
+            return StatusResults::Fail;
+        }
+        if (UA_StatusCode_isUncertain(response.responseHeader.serviceResult))
+        {
+            m_logger.Warning("ReadNodesAttributes has uncertain value from Open62541: {}", UA_StatusCode_name(response.responseHeader.serviceResult));
+        }
+        if (response.resultsSize != requests.at(request_index).nodesToReadSize)
+        {
+            m_logger.Error("ReadNodesAttributes has error: response results size not equal to requested. {} != {}", response.resultsSize, requests.at(request_index).nodesToReadSize);
+            return StatusResults::Fail;
+        }
+
+        // Cycle of issuing requested data by attributes. The responses come in the order of the requests, so the index of the operation is restored by the offset.
+        for (size_t index = 0; index < response.resultsSize; index++)
+        {
+            auto& read_value_id = read_value_ids.at(offset + index);
+            auto& result = response.results[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (read_value_id.attributeId == UA_ATTRIBUTEID_NODECLASS)
+            {
+                // Correction. When querying the NodeClass attribute, the type returned is Int32. See Open62541ClientWrapper::ReadNodesAttributes.
+                result.value.type = &UA_TYPES[UA_TYPES_NODECLASS];
+            }
+            set_data(offset + index, result, read_value_id.nodeId, read_value_id.attributeId);
+        }
+        offset += response.resultsSize;
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeClasses()");
+    std::unique_ptr<std::vector<UA_ReadValueId>, void (*)(std::vector<UA_ReadValueId>* const)> read_value_ids(
+        new std::vector<UA_ReadValueId>(node_class_structure_lists.size()),
+        [](std::vector<UA_ReadValueId>* const vec)
+        {
+            // Remove all the contents of UA_READVALUEID structures according to signs
+            for (auto& read_value_id : *vec)
+            {
+                UA_ReadValueId_clear(&read_value_id);
+            }
+            delete vec; // NOLINT(cppcoreguidelines-owning-memory)
+        });
+    for (size_t index = 0; index < node_class_structure_lists.size(); index++)
+    {
+        UA_NodeId_copy(&node_class_structure_lists.at(index).exp_node_id.GetRef().nodeId, &read_value_ids->at(index).nodeId);
+        read_value_ids->at(index).attributeId = UA_ATTRIBUTEID_NODECLASS;
+    }
+
+    return ReadNodesAttributes(
+        *read_value_ids,
+        [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& /*not_need*/, UA_UInt32 attr_id)
+        {
+            if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue)
+            {
+                node_class_structure_lists.at(array_index).node_class = *static_cast<UA_NodeClass*>(data_value.value.data);
+            }
+            else
+            {
+                node_class_structure_lists.at(array_index).node_class = UA_NodeClass::UA_NODECLASS_UNSPECIFIED;
+                m_logger.Warning(
+                    "ReadNodeClasses (atrId={}) has bad status '{}' of node {} in response",
+                    attr_id,
+                    UA_StatusCode_name(data_value.status),
+                    node_class_structure_lists.at(array_index).exp_node_id.ToString());
+                node_class_structure_lists.at(array_index).result_code = data_value.status;
+            }
+        });
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeReferences()");
+    std::unique_ptr<std::vector<UA_BrowseDescription>, void (*)(std::vector<UA_BrowseDescription>* const)> b_req_vector(
+        new std::vector<UA_BrowseDescription>(node_references_structure_lists.size()),
+        [](std::vector<UA_BrowseDescription>* const vec)
+        {
+            for (auto& browse_description : *vec)
+            {
+                UA_BrowseDescription_clear(&browse_description);
+            }
+            delete vec; // NOLINT(cppcoreguidelines-owning-memory)
+        });
+    m_logger.Debug("--------------------------------------");
+    m_logger.Debug("Prepare query parent NodeID[{}] --> references NodeIDs. Name of sent nodes:", node_references_structure_lists.size());
+    for (size_t index = 0; index < node_references_structure_lists.size(); index++)
+    {
+        if (m_logger.GetLevel() <= LogLevel::Debug) // To avoid running ToString() once again
+        {
+            m_logger.Debug("NodeID: '{}'", node_references_structure_lists.at(index).exp_node_id.ToString());
+        }
+        auto& browse_description = b_req_vector->at(index);
+        browse_description.includeSubtypes = UA_TRUE;
+        browse_description.browseDirection = UA_BROWSEDIRECTION_BOTH;
+        browse_description.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_REFERENCES);
+        UA_NodeId_copy(&node_references_structure_lists.at(index).exp_node_id.GetRef().nodeId, &browse_description.nodeId);
+        browse_description.resultMask = UA_BROWSERESULTMASK_ALL;
+    }
+    m_logger.Debug("--------------------------------------");
+
+    const auto per_request = GetOperationsPerRequest(b_req_vector->size());
+    std::vector<UA_BrowseRequest> requests;
+    for (size_t offset = 0; offset < b_req_vector->size(); offset += per_request)
+    {
+        UA_BrowseRequest request;
+        UA_BrowseRequest_init(&request);
+        request.nodesToBrowse = &b_req_vector->at(offset);
+        request.nodesToBrowseSize = std::min(per_request, b_req_vector->size() - offset);
+        request.requestedMaxReferencesPerNode = m_requested_max_references_per_node;
+        request.view = m_view.GetRef(); // The requests are not cleared, the View is owned by the wrapper.
+        requests.push_back(request);
+    }
+
+    BrowseResponsesWithAutoClear responses(requests.size());
+    if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_BROWSEREQUEST], UA_TYPES[UA_TYPES_BROWSERESPONSE]) != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    std::vector<std::pair<size_t, UATypesContainer<UA_ByteString>>> continuation_points;
+    size_t node_index = 0;
+    for (size_t request_index = 0; request_index < requests.size(); request_index++)
+    {
+        const auto& response = responses.values.at(request_index);
+        if (UA_StatusCode_isBad(response.responseHeader.serviceResult))
+        {
+            m_logger.Error("Browse has error from Open62541: {}", UA_StatusCode_name(response.responseHeader.serviceResult));
+            if (!continuation_points.empty())
+            {
+                ReleaseContinuationPoints(continuation_points);
+            }
+            return StatusResults::Fail;
+        }
+        if (UA_StatusCode_isUncertain(response.responseHeader.serviceResult))
+        {
+            m_logger.Warning("Browse has uncertain value from Open62541: {}", UA_StatusCode_name(response.responseHeader.serviceResult));
+        }
+        if (response.results == nullptr)
+        {
+            throw std::runtime_error("response.results == nullptr");
+        }
+        if (response.resultsSize != requests.at(request_index).nodesToBrowseSize)
+        {
+            throw std::runtime_error("response.resultsSize != nodesToBrowseSize");
+        }
+
+        for (size_t result_index = 0; result_index < response.resultsSize; result_index++, node_index++)
+        {
+            const auto& result = response.results[result_index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (UA_StatusCode_isBad(result.statusCode))
+            {
+                m_logger.Warning(
+                    "UA_BrowseResult has bad status '{}' of node {} in response.",
+                    UA_StatusCode_name(result.statusCode),
+                    node_references_structure_lists.at(node_index).exp_node_id.ToString());
+            }
+            if (UA_StatusCode_isUncertain(result.statusCode))
+            {
+                m_logger.Warning(
+                    "UA_BrowseResult has uncertain status '{}' of node {} in response.",
+                    UA_StatusCode_name(result.statusCode),
+                    node_references_structure_lists.at(node_index).exp_node_id.ToString());
+            }
+            for (size_t ref_index = 0; ref_index < result.referencesSize; ref_index++)
+            {
+                node_references_structure_lists.at(node_index)
+                    .references.emplace_back(result.references[ref_index], UA_TYPES_REFERENCEDESCRIPTION); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            if (result.continuationPoint.length != 0)
+            {
+                continuation_points.emplace_back(node_index, UATypesContainer<UA_ByteString>(result.continuationPoint, UA_TYPES_BYTESTRING));
+            }
+        }
+    }
+
+    // Reading the remaining references of all nodes with continuation points at the same time.
+    auto status = BrowseNext(continuation_points, node_references_structure_lists);
+    if (status == StatusResults::Fail && status.GetSubStatus() != StatusResults::Cancelled)
+    {
+        m_logger.Error("BrowseNext error");
+    }
+    return status;
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodesAtrrubutes()");
+    std::unique_ptr<std::vector<UA_ReadValueId>, void (*)(std::vector<UA_ReadValueId>* const)> read_value_ids(
+        new std::vector<UA_ReadValueId>,
+        [](std::vector<UA_ReadValueId>* const vec)
+        {
+            for (auto& read_value_id : *vec)
+            {
+                UA_ReadValueId_clear(&read_value_id);
+            }
+            delete vec; // NOLINT(cppcoreguidelines-owning-memory)
+        });
+    read_value_ids->reserve(node_attr_structure_lists.size());
+    for (const auto& node_attr_structure_list : node_attr_structure_lists)
+    {
+        for (const auto& attr : node_attr_structure_list.attrs)
+        {
+            auto& read_value_id = read_value_ids->emplace_back();
+            UA_ReadValueId_init(&read_value_id);
+            UA_NodeId_copy(&node_attr_structure_list.exp_node_id.GetRef().nodeId, &read_value_id.nodeId);
+            read_value_id.attributeId = attr.first;
+        }
+    }
+
+    std::vector<std::optional<VariantsOfAttr>> variants(read_value_ids->size());
+    StatusResults result = ReadNodesAttributes(
+        *read_value_ids,
+        [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& node_id, UA_UInt32 attr_id)
+        {
+            if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue)
+            {
+                if (attr_id == UA_ATTRIBUTEID_VALUE)
+                {
+                    variants.at(array_index) = std::optional<VariantsOfAttr>{VariantsOfAttr(UATypesContainer<UA_Variant>(data_value.value, UA_TYPES_VARIANT))};
+                }
+                else
+                {
+                    variants.at(array_index) = UAVariantToStdVariant(data_value.value);
+                }
+            }
+            else
+            {
+                variants.at(array_index) = std::nullopt;
+                m_logger.Warning(
+                    "ReadNodesAtrrubutes (atrID={}) has bad status '{}' of node {} in response",
+                    attr_id,
+                    UA_StatusCode_name(data_value.status),
+                    UATypesContainer<UA_NodeId>(node_id, UA_TYPES_NODEID).ToString());
+            }
+        });
+
+    if (result != StatusResults::Good)
+    {
+        return result;
+    }
+
+    // The responses are linked to the requests in the order of their composition, see Open62541ClientWrapper::ReadNodesAttributes.
+    size_t attr_index = 0;
+    for (auto& node_attr_structure_list : node_attr_structure_lists)
+    {
+        for (auto& attr : node_attr_structure_list.attrs)
+        {
+            attr.second = variants.at(attr_index);
+            attr_index++;
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value)
+{
+    m_logger.Trace("Method called: ReadNodeDataValue()");
+    // The operation refers to the NodeId of the argument and does not own it.
+    UA_ReadValueId read_value_id;
+    UA_ReadValueId_init(&read_value_id);
+    read_value_id.nodeId = node_id.GetRef().nodeId;
+    read_value_id.attributeId = UA_ATTRIBUTEID_VALUE;
+
+    std::vector<UA_ReadRequest> requests(1);
+    UA_ReadRequest_init(&requests.at(0));
+    requests.at(0).nodesToRead = &read_value_id;
+    requests.at(0).nodesToReadSize = 1;
+    ReadResponsesWithAutoClear responses(requests.size());
+    if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_READREQUEST], UA_TYPES[UA_TYPES_READRESPONSE]) != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    // The same checks as in UA_Client_readValueAttribute.
+    auto& response = responses.values.at(0);
+    UA_StatusCode status = response.responseHeader.serviceResult;
+    if (UA_StatusCode_isGood(status) || UA_StatusCode_isUncertain(status))
+    {
+        if (response.resultsSize != 1 || response.results == nullptr)
+        {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        else if (UA_StatusCode_isBad(response.results[0].status))
+        {
+            status = response.results[0].status;
+        }
+        else if (!response.results[0].hasValue)
+        {
+            status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+    }
+    if (UA_StatusCode_isBad(status))
+    {
+        m_logger.Error("ReadNodeDataValue has error from Open62541: {}", UA_StatusCode_name(status));
+        return StatusResults::Fail;
+    }
+    if (UA_StatusCode_isUncertain(status))
+    {
+        m_logger.Warning("ReadNodeDataValue has uncertain value from Open62541: {}", UA_StatusCode_name(status));
+    }
+    // Moving the value from the response, so as not to copy it.
+    UA_Variant_clear(&data_value.GetRef());
+    data_value.GetRef() = response.results[0].value;
+    UA_Variant_init(&response.results[0].value);
+    return StatusResults::Good;
+}
+
+StatusResults Open62541AsyncClientWrapper::ReadNodeDataValueRange(
+    const UATypesContainer<UA_ExpandedNodeId>& node_id,
+    size_t first_index,
+    size_t number_of_elements,
+    UATypesContainer<UA_Variant>& data_value)
+{
+    m_logger.Trace("Method called: ReadNodeDataValueRange()");
+    if (number_of_elements == 0)
+    {
+        m_logger.Error("ReadNodeDataValueRange. The number of elements is zero. NodeID: {}", node_id.ToString());
+        return StatusResults::Fail;
+    }
+    // The operation refers to the NodeId and the IndexRange text and does not own them.
+    auto index_range = nodesetexporter::common::IndexRangeToStdString(first_index, number_of_elements);
+    UA_ReadValueId read_value_id;
+    UA_ReadValueId_init(&read_value_id);
+    read_value_id.nodeId = node_id.GetRef().nodeId;
+    read_value_id.attributeId = UA_ATTRIBUTEID_VALUE;
+    read_value_id.indexRange = UA_STRING(index_range.data());
+
+    std::vector<UA_ReadRequest> requests(1);
+    UA_ReadRequest_init(&requests.at(0));
+    requests.at(0).nodesToRead = &read_value_id;
+    requests.at(0).nodesToReadSize = 1;
+    ReadResponsesWithAutoClear responses(requests.size());
+    if (SendRequestsAndWait(requests, responses.values, UA_TYPES[UA_TYPES_READREQUEST], UA_TYPES[UA_TYPES_READRESPONSE]) != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    auto& response = responses.values.at(0);
+    UA_StatusCode status = response.responseHeader.serviceResult;
+    if (UA_StatusCode_isGood(status) || UA_StatusCode_isUncertain(status))
+    {
+        status = response.resultsSize == 1 && response.results != nullptr ? response.results[0].status : UA_STATUSCODE_BADUNEXPECTEDERROR;
+    }
+    UA_Variant_clear(&data_value.GetRef());
+    if (status == UA_STATUSCODE_BADINDEXRANGENODATA)
+    {
+        // The array ends before first_index.
+        return StatusResults::Good;
+    }
+    if (UA_StatusCode_isBad(status))
+    {
+        m_logger.Warning("ReadNodeDataValueRange ({}) has error from Open62541: {}. NodeID: {}", index_range, UA_StatusCode_name(status), node_id.ToString());
+        return StatusResults::Fail;
+    }
+    if (UA_StatusCode_isUncertain(status))
+    {
+        m_logger.Warning("ReadNodeDataValueRange has uncertain value from Open62541: {}", UA_StatusCode_name(status));
+    }
+    // Moving the value from the response, so as not to copy the part of the array.
+    data_value.GetRef() = response.results[0].value;
+    UA_Variant_init(&response.results[0].value);
+    return StatusResults::Good;
+}
+
+} // namespace nodesetexporter::open62541
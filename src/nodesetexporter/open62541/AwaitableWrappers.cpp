@@ -0,0 +1,144 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/AwaitableWrappers.h"
+
+namespace nodesetexporter::open62541
+{
+
+void Open62541AwaitableWrapper::CallAwaiter::await_suspend(std::coroutine_handle<> awaiting)
+{
+    m_awaiting = awaiting;
+    // After the call is queued, the coroutine can be resumed and the awaiter destroyed before the exit from this method, so only the wrapper is used further.
+    auto& wrapper = m_wrapper;
+    {
+        std::lock_guard<std::mutex> lock(wrapper.m_queue_mutex);
+        wrapper.m_queue.push_back(this);
+    }
+    wrapper.m_queue_cv.notify_one();
+}
+
+StatusResults Open62541AwaitableWrapper::CallAwaiter::await_resume()
+{
+    if (m_exception)
+    {
+        std::rethrow_exception(m_exception);
+    }
+    return m_result.value();
+}
+
+void Open62541AwaitableWrapper::CallAwaiter::Execute()
+{
+    try
+    {
+        if (m_wrapper.m_is_simultaneous_calls_allowed)
+        {
+            m_result.emplace(m_call());
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_wrapper.m_call_mutex);
+            m_result.emplace(m_call());
+        }
+    }
+    catch (...)
+    {
+        m_exception = std::current_exception();
+    }
+    // The lock is released before the resumption, since the resumed coroutine can make the next call.
+    m_awaiting.resume();
+}
+
+Open62541AwaitableWrapper::Open62541AwaitableWrapper(IOpen62541& open62541_lib, LoggerBase& logger, size_t number_of_workers, bool is_simultaneous_calls_allowed)
+    : IAsyncOpen62541(logger)
+    , m_open62541_lib(open62541_lib)
+    , m_is_simultaneous_calls_allowed(is_simultaneous_calls_allowed)
+{
+    m_logger.Trace("Constructor called: Open62541AwaitableWrapper()");
+    number_of_workers = number_of_workers == 0 ? 1 : number_of_workers;
+    m_workers.reserve(number_of_workers);
+    for (size_t index = 0; index < number_of_workers; index++)
+    {
+        m_workers.emplace_back(
+            [this](const std::stop_token& stop_token)
+            {
+                WorkerLoop(stop_token);
+            });
+    }
+}
+
+Open62541AwaitableWrapper::~Open62541AwaitableWrapper()
+{
+    // The threads are stopped and joined before the other fields are destroyed.
+    m_workers.clear();
+}
+
+void Open62541AwaitableWrapper::WorkerLoop(const std::stop_token& stop_token)
+{
+    while (true)
+    {
+        CallAwaiter* call = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            if (!m_queue_cv.wait(
+                    lock,
+                    stop_token,
+                    [this]
+                    {
+                        return !m_queue.empty();
+                    }))
+            {
+                return; // Stop requested
+            }
+            call = m_queue.front();
+            m_queue.pop_front();
+        }
+        call->Execute();
+    }
+}
+
+Task<StatusResults> Open62541AwaitableWrapper::ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeClasses()");
+    co_return co_await CallAwaiter(
+        *this,
+        [this, &node_class_structure_lists]
+        {
+            return m_open62541_lib.ReadNodeClasses(node_class_structure_lists);
+        });
+}
+
+Task<StatusResults> Open62541AwaitableWrapper::ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeReferences()");
+    co_return co_await CallAwaiter(
+        *this,
+        [this, &node_references_structure_lists]
+        {
+            return m_open62541_lib.ReadNodeReferences(node_references_structure_lists);
+        });
+}
+
+Task<StatusResults> Open62541AwaitableWrapper::ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodesAttributes()");
+    co_return co_await CallAwaiter(
+        *this,
+        [this, &node_attr_structure_lists]
+        {
+            return m_open62541_lib.ReadNodesAttributes(node_attr_structure_lists);
+        });
+}
+
+Task<StatusResults> Open62541AwaitableWrapper::ExecuteBlockingCall(std::function<StatusResults()> call)
+{
+    m_logger.Trace("Method called: ExecuteBlockingCall()");
+    co_return co_await CallAwaiter(*this, std::move(call));
+}
+
+} // namespace nodesetexporter::open62541
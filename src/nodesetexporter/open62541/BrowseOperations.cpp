@@ -9,6 +9,8 @@
 #include "nodesetexporter/open62541/BrowseOperations.h"
 #include "nodesetexporter/common/Strings.h"
 
+#include <functional>
+
 namespace nodesetexporter::open62541::browseoperations
 {
 
@@ -63,33 +65,102 @@ UA_StatusCode UA_Client_forEachChildNodeCall_Ex(UA_Client* client, UA_NodeId par
 }
 // NOLINTEND
 
-StatusResults GrabChildNodeIdsFromStartNodeId(UA_Client* client, const UATypesContainer<UA_ExpandedNodeId>& start_node_id, std::vector<UATypesContainer<UA_ExpandedNodeId>>& out)
+UA_StatusCode ForEachChildReference(
+    UA_Client* client,
+    const UA_NodeId& parent_node_id,
+    const UA_ViewDescription* view,
+    const std::function<void(const UA_ReferenceDescription&)>& callback)
+{
+    UATypesContainer<UA_BrowseDescription> browse_description(UA_TYPES_BROWSEDESCRIPTION);
+    UA_NodeId_copy(&parent_node_id, &browse_description.GetRef().nodeId);
+    browse_description.GetRef().browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    browse_description.GetRef().referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    browse_description.GetRef().includeSubtypes = true;
+    browse_description.GetRef().resultMask = UA_BROWSERESULTMASK_ALL;
+
+    UA_BrowseRequest request;
+    UA_BrowseRequest_init(&request);
+    request.requestedMaxReferencesPerNode = 0;
+    request.nodesToBrowse = &browse_description.GetRef();
+    request.nodesToBrowseSize = 1;
+    if (view != nullptr)
+    {
+        request.view = *view; // The request is not cleared, the View is owned by the caller.
+    }
+
+    UA_BrowseResponse response = UA_Client_Service_browse(client, request);
+    const auto status = response.responseHeader.serviceResult;
+    if (status == UA_STATUSCODE_GOOD)
+    {
+        for (size_t result_index = 0; result_index < response.resultsSize; ++result_index)
+        {
+            const auto& result = response.results[result_index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            for (size_t ref_index = 0; ref_index < result.referencesSize; ++ref_index)
+            {
+                callback(result.references[ref_index]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+        }
+    }
+    UA_BrowseResponse_clear(&response);
+    return status;
+}
+
+UATypesContainer<UA_ViewDescription> MakeViewDescription(const UA_NodeId& view_id, UA_DateTime timestamp, UA_UInt32 view_version)
+{
+    UATypesContainer<UA_ViewDescription> view(UA_TYPES_VIEWDESCRIPTION);
+    UA_NodeId_copy(&view_id, &view.GetRef().viewId);
+    view.GetRef().timestamp = timestamp;
+    view.GetRef().viewVersion = view_version;
+    return view;
+}
+
+StatusResults GrabChildNodeIdsFromStartNodeId(
+    UA_Client* client,
+    const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+    std::vector<UATypesContainer<UA_ExpandedNodeId>>& out,
+    discovery::DiscoveryFilter* const filter,
+    const UA_ViewDescription* const view,
+    const SessionRecovery& session_recovery)
 {
     out.push_back(start_node_id); // Start node in test
-    int counter = 0;
-    auto ref_type = UATypesContainer<UA_NodeId>(UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES), UA_TYPES_NODEID);
-    UA_BrowseOptions browse_opt;
-    browse_opt.includeSubtypes = true;
-    browse_opt.direction = UA_BROWSEDIRECTION_FORWARD;
-    browse_opt.refType = &ref_type.GetRef();
+    size_t counter = out.size() - 1;
+    size_t depth = 0;
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> level_nodes; // The children of the nodes of one level of the hierarchy
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> node_children; // The children of one node, added to the level after the successful browsing
     // Perform a more primitive analogue of the Browsing operation of the entire structure of nodes starting from the starting one
     do
     {
-        one_iteration_nodes.clear();
-        for (size_t index = counter; index < out.size(); index++)
+        ++depth;
+        level_nodes.clear();
+        for (; counter < out.size(); counter++)
         {
-            // Using the ready-made browsing function. The disadvantage is that only one node accepts input, but for small volumes you can get by with this.
-            if (UA_StatusCode_isBad(UA_Client_forEachChildNodeCall_Ex(client, out[index].GetRef().nodeId, &NodeIteratorCallback, nullptr, &browse_opt)))
+            // Only one node is browsed per request, but for small volumes you can get by with this.
+            const auto browse = [&]
+            {
+                node_children.clear();
+                return ForEachChildReference(
+                    client,
+                    out[counter].GetRef().nodeId,
+                    view,
+                    [&node_children, filter, depth](const UA_ReferenceDescription& ref)
+                    {
+                        // The excluded child is not added, so its subtree is not browsed.
+                        if (filter != nullptr && !filter->Accept({ref.nodeId.nodeId, ref.browseName, ref.nodeClass, ref.referenceTypeId, depth}))
+                        {
+                            return;
+                        }
+                        node_children.emplace_back(UA_EXPANDEDNODEID_NODEID(ref.nodeId.nodeId), UA_TYPES_EXPANDEDNODEID);
+                    });
+            };
+            const auto status = session_recovery ? session_recovery(browse) : browse();
+            if (UA_StatusCode_isBad(status))
             {
                 return StatusResults::Fail;
             }
-            counter++;
-        }
-        if (!one_iteration_nodes.empty())
-        {
-            std::copy(one_iteration_nodes.begin(), one_iteration_nodes.end(), back_inserter(out));
+            std::move(node_children.begin(), node_children.end(), back_inserter(level_nodes));
         }
-    } while (!one_iteration_nodes.empty());
+        std::move(level_nodes.begin(), level_nodes.end(), back_inserter(out));
+    } while (!level_nodes.empty());
 
     return StatusResults::Good;
 }
@@ -7,10 +7,220 @@
 //
 
 #include "nodesetexporter/open62541/ClientWrappers.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <tuple>
 
 namespace nodesetexporter::open62541
 {
 
+bool Open62541ClientWrapper::IsSessionLost(UA_StatusCode status_code)
+{
+    switch (status_code)
+    {
+    case UA_STATUSCODE_BADCONNECTIONCLOSED:
+    case UA_STATUSCODE_BADCONNECTIONREJECTED:
+    case UA_STATUSCODE_BADSESSIONIDINVALID:
+    case UA_STATUSCODE_BADSESSIONCLOSED:
+    case UA_STATUSCODE_BADSESSIONNOTACTIVATED:
+    case UA_STATUSCODE_BADSECURECHANNELCLOSED:
+    case UA_STATUSCODE_BADSECURECHANNELIDINVALID:
+    case UA_STATUSCODE_BADSERVERNOTCONNECTED:
+    case UA_STATUSCODE_BADNOTCONNECTED:
+    case UA_STATUSCODE_BADDISCONNECT:
+    case UA_STATUSCODE_BADCOMMUNICATIONERROR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+StatusResults Open62541ClientWrapper::RecoverSession(std::uint32_t attempt)
+{
+    m_logger.Trace("Method called: RecoverSession()");
+    // The exponential backoff, the pause is interrupted by the stop request.
+    auto backoff = m_session_recovery_policy.initial_backoff;
+    for (std::uint32_t step = 0; step < attempt && backoff < m_session_recovery_policy.max_backoff; ++step)
+    {
+        backoff *= 2;
+    }
+    backoff = std::min(backoff, m_session_recovery_policy.max_backoff);
+    if (!WaitFor(backoff))
+    {
+        m_logger.Warning("The reconnection to the server was stopped on request.");
+        return {StatusResults::Fail, StatusResults::Cancelled};
+    }
+    // The old session and the secure channel are closed, their continuation points are released by the server.
+    UA_Client_disconnect(&m_ua_client);
+    const auto status = m_session_recovery_policy.reconnect(m_ua_client);
+    if (UA_StatusCode_isBad(status))
+    {
+        m_logger.Warning("The reconnection to the server has failed: {}", UA_StatusCode_name(status));
+        return StatusResults::Fail;
+    }
+    return StatusResults::Good;
+}
+
+bool Open62541ClientWrapper::WaitFor(ratelimit::Clock::duration duration)
+{
+    if (duration > ratelimit::Clock::duration::zero())
+    {
+        std::mutex mutex;
+        std::condition_variable_any stop_waiting;
+        std::unique_lock lock(mutex);
+        std::ignore = stop_waiting.wait_for(lock, m_stop_token, duration, [] { return false; });
+    }
+    return !m_stop_token.stop_requested();
+}
+
+ratelimit::Clock::time_point Open62541ClientWrapper::ThrottleRequest(size_t number_of_operations)
+{
+    if (m_rate_limiter.IsAdaptive() && ratelimit::Clock::now() - m_server_load_sample_time >= ratelimit::server_load_sampling_interval)
+    {
+        m_server_load_sample_time = ratelimit::Clock::now();
+        SampleServerLoad();
+    }
+    return AcquireRequest(number_of_operations);
+}
+
+ratelimit::Clock::time_point Open62541ClientWrapper::AcquireRequest(size_t number_of_operations)
+{
+    if (m_rate_limiter.IsEnabled())
+    {
+        // After the stop request the request is sent without the pause, the export finishes the current batch.
+        std::ignore = WaitFor(m_rate_limiter.Acquire(number_of_operations));
+    }
+    return ratelimit::Clock::now();
+}
+
+void Open62541ClientWrapper::AccountResponse(ratelimit::Clock::time_point request_time, size_t number_of_operations, const void* response, const UA_DataType& response_type)
+{
+    if (!m_rate_limiter.IsEnabled())
+    {
+        return;
+    }
+    const auto now = ratelimit::Clock::now();
+    const auto response_bytes = m_rate_limiter.IsBytesLimited() ? UA_calcSizeBinary(response, &response_type) : 0;
+    // The header only is the response of the high-level reading of the value.
+    auto service = ratelimit::Service::Read;
+    if (&response_type == &UA_TYPES[UA_TYPES_BROWSERESPONSE])
+    {
+        service = ratelimit::Service::Browse;
+    }
+    else if (&response_type == &UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE])
+    {
+        service = ratelimit::Service::BrowseNext;
+    }
+    m_rate_limiter.OnResponse(service, number_of_operations, now - request_time, response_bytes, now);
+    // All the responses begin with the header. BadTimeout is also the overload: the server has not processed the request in time.
+    const auto service_result = static_cast<const UA_ResponseHeader*>(response)->serviceResult;
+    if (service_result == UA_STATUSCODE_BADTOOMANYOPERATIONS || service_result == UA_STATUSCODE_BADRESOURCEUNAVAILABLE || service_result == UA_STATUSCODE_BADTIMEOUT)
+    {
+        m_logger.Warning("The server is overloaded ({}), the rate of the requests is reduced", UA_StatusCode_name(service_result));
+        m_rate_limiter.OnServerOverload(now);
+    }
+}
+
+void Open62541ClientWrapper::SampleServerLoad()
+{
+    m_logger.Trace("Method called: SampleServerLoad()");
+    std::array<UA_ReadValueId, 2> read_value_ids{};
+    UA_ReadValueId_init(&read_value_ids.at(0));
+    read_value_ids.at(0).nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE);
+    read_value_ids.at(0).attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadValueId_init(&read_value_ids.at(1));
+    read_value_ids.at(1).nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_REJECTEDREQUESTSCOUNT);
+    read_value_ids.at(1).attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = read_value_ids.data();
+    request.nodesToReadSize = read_value_ids.size();
+    // The sampling is the request to the server too, it waits for the limiter and its latency is accounted.
+    const auto request_time = AcquireRequest(read_value_ids.size());
+    auto response = UA_Client_Service_read(&m_ua_client, request);
+    AccountResponse(request_time, read_value_ids.size(), &response, UA_TYPES[UA_TYPES_READRESPONSE]);
+    if (UA_StatusCode_isGood(response.responseHeader.serviceResult) && response.resultsSize == read_value_ids.size())
+    {
+        const auto& state = response.results[0]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        // The enumeration is received as Int32 (see the correction of NodeClass in ReadNodesAttributes).
+        const bool is_running = !state.hasValue || !UA_Variant_hasScalarType(&state.value, &UA_TYPES[UA_TYPES_INT32]) ||
+                                *static_cast<UA_Int32*>(state.value.data) == UA_SERVERSTATE_RUNNING;
+        // The diagnostics of the server may be disabled, then only the state is used.
+        const auto& rejected_requests = response.results[1]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::optional<UA_UInt32> rejected_requests_count;
+        if (rejected_requests.hasValue && UA_Variant_hasScalarType(&rejected_requests.value, &UA_TYPES[UA_TYPES_UINT32]))
+        {
+            rejected_requests_count = *static_cast<UA_UInt32*>(rejected_requests.value.data);
+        }
+        const bool is_rejecting = rejected_requests_count.has_value() && m_rejected_requests_count.has_value() && *rejected_requests_count > *m_rejected_requests_count;
+        m_rejected_requests_count = rejected_requests_count;
+        if (!is_running || is_rejecting)
+        {
+            m_logger.Warning("The server is overloaded (the server is not running or rejects the requests), the rate of the requests is reduced");
+            m_rate_limiter.OnServerOverload();
+        }
+    }
+    UA_ReadResponse_clear(&response);
+}
+
+StatusResults Open62541ClientWrapper::WithSessionRecovery(std::string_view operation, const std::function<StatusResults()>& request)
+{
+    std::uint32_t attempt = 0;
+    while (true)
+    {
+        m_last_service_result = UA_STATUSCODE_GOOD;
+        auto result = request();
+        if (result == StatusResults::Good || !m_session_recovery_policy.reconnect || !IsSessionLost(m_last_service_result))
+        {
+            return result;
+        }
+        if (attempt >= m_session_recovery_policy.max_attempts_per_request || m_number_of_reconnections >= m_session_recovery_policy.retry_budget)
+        {
+            m_logger.Error(
+                "{}: the connection to the server is lost ({}), the reconnection attempts are exhausted ({} of the request, {} of the budget {})",
+                operation,
+                UA_StatusCode_name(m_last_service_result),
+                attempt,
+                m_number_of_reconnections,
+                m_session_recovery_policy.retry_budget);
+            return result;
+        }
+        m_logger.Warning("{}: the connection to the server is lost ({}), reconnection attempt {}", operation, UA_StatusCode_name(m_last_service_result), attempt + 1);
+        ++m_number_of_reconnections;
+        auto recovery = RecoverSession(attempt);
+        ++attempt;
+        if (recovery == StatusResults::Good)
+        {
+            ++m_number_of_recovered_sessions;
+            m_logger.Info("{}: the session is re-established, the request is issued again", operation);
+        }
+        else if (recovery.GetSubStatus() == StatusResults::Cancelled)
+        {
+            return recovery;
+        }
+        // If the reconnection has failed, the request fails on the lost connection again and the next attempt is made.
+    }
+}
+
+UA_StatusCode Open62541ClientWrapper::CallWithSessionRecovery(std::string_view operation, const std::function<UA_StatusCode()>& request)
+{
+    m_logger.Trace("Method called: CallWithSessionRecovery()");
+    UA_StatusCode status = UA_STATUSCODE_GOOD;
+    std::ignore = WithSessionRecovery(
+        operation,
+        [&]
+        {
+            status = request();
+            m_last_service_result = status;
+            return UA_StatusCode_isBad(status) ? StatusResults::Fail : StatusResults::Good;
+        });
+    return status;
+}
+
 StatusResults Open62541ClientWrapper::BrowseNext(UA_ByteString* const continuation_point, std::vector<UATypesContainer<UA_ReferenceDescription>>& result_nodes)
 {
     m_logger.Trace("Method called: BrowseNext()");
@@ -39,12 +249,15 @@ StatusResults Open62541ClientWrapper::BrowseNext(UA_ByteString* const continuati
             UA_BrowseNextResponse value;
         };
 
+        const auto request_time = ThrottleRequest(1);
         UaBrowseNextResponseWithAutoClear response{UA_Client_Service_browseNext(&m_ua_client, b_next_req.GetRef())}; //<-- BROWSE NEXT
+        AccountResponse(request_time, 1, &response.value, UA_TYPES[UA_TYPES_BROWSENEXTRESPONSE]);
         UA_BrowseNextRequest_init(&b_next_req.GetRef()); // cleaning the structure before filling it again
 
         if (UA_StatusCode_isBad(response.value.responseHeader.serviceResult))
         {
             m_logger.Error("Browse Next has bad status '{}' in response.", UA_StatusCode_name(response.value.responseHeader.serviceResult));
+            m_last_service_result = response.value.responseHeader.serviceResult;
             return StatusResults::Fail;
         }
         if (UA_StatusCode_isUncertain(response.value.responseHeader.serviceResult))
@@ -104,10 +317,13 @@ StatusResults Open62541ClientWrapper::ReadNodesAttributes(std::vector<UA_ReadVal
     };
 
     // To automatically fire the structure destructor whenever the function exits, I create a structure on the stack.
+    const auto request_time = ThrottleRequest(read_value_ids.size());
     ReadResponseWithAutoClear response_wrap{UA_Client_Service_read(&m_ua_client, read_request)}; // <-- REQUEST DATA VIA Open62541
+    AccountResponse(request_time, read_value_ids.size(), &response_wrap.value, UA_TYPES[UA_TYPES_READRESPONSE]);
     if (UA_StatusCode_isBad(response_wrap.value.responseHeader.serviceResult))
     {
         m_logger.Error("ReadNodesAttributes has error from Open62541: {}", UA_StatusCode_name(response_wrap.value.responseHeader.serviceResult));
+        m_last_service_result = response_wrap.value.responseHeader.serviceResult;
         // Will UA_ReadRequest also delete vector objects by pointer?
         return StatusResults::Fail;
     }
@@ -159,29 +375,35 @@ StatusResults Open62541ClientWrapper::ReadNodeClasses(std::vector<NodeClassesReq
         read_value_ids->at(index).attributeId = UA_ATTRIBUTEID_NODECLASS;
     }
 
-    return ReadNodesAttributes(
-        *read_value_ids,
-        [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& /*not_need*/, UA_UInt32 attr_id)
+    const auto set_node_class = [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& /*not_need*/, UA_UInt32 attr_id)
+    {
+        if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         {
-            if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-            {
-                // The basic rule of a request-response using the OPC UA protocol is that you can be sure that the response will arrive in the same order in which the request was made.
-                // Based on this and knowing the sequence of composing the request, you can also sequentially link the response to the request, for example, the requested data in a certain order
-                // by NodeID will be returned as a response in the same order and they can be linked in the same order to the constructed NodeId sequence in the request.
-                // https://reference.opcfoundation.org/Core/Part4/v104/docs/5.10.2.2
-                // memcpy(&node_class_structure_lists[array_index].node_class, static_cast<UA_NodeClass*>(data_value.value.data), sizeof(UA_NodeClass));
-                node_class_structure_lists.at(array_index).node_class = *static_cast<UA_NodeClass*>(data_value.value.data); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-            }
-            else
-            {
-                node_class_structure_lists.at(array_index).node_class = UA_NodeClass::UA_NODECLASS_UNSPECIFIED;
-                m_logger.Warning(
-                    "ReadNodeClasses (atrId={}) has bad status '{}' of node {} in response",
-                    attr_id,
-                    UA_StatusCode_name(data_value.status), // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-                    node_class_structure_lists.at(array_index).exp_node_id.ToString());
-                node_class_structure_lists.at(array_index).result_code = data_value.status;
-            }
+            // The basic rule of a request-response using the OPC UA protocol is that you can be sure that the response will arrive in the same order in which the request was made.
+            // Based on this and knowing the sequence of composing the request, you can also sequentially link the response to the request, for example, the requested data in a certain order
+            // by NodeID will be returned as a response in the same order and they can be linked in the same order to the constructed NodeId sequence in the request.
+            // https://reference.opcfoundation.org/Core/Part4/v104/docs/5.10.2.2
+            // memcpy(&node_class_structure_lists[array_index].node_class, static_cast<UA_NodeClass*>(data_value.value.data), sizeof(UA_NodeClass));
+            node_class_structure_lists.at(array_index).node_class = *static_cast<UA_NodeClass*>(data_value.value.data); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+        else
+        {
+            node_class_structure_lists.at(array_index).node_class = UA_NodeClass::UA_NODECLASS_UNSPECIFIED;
+            m_logger.Warning(
+                "ReadNodeClasses (atrId={}) has bad status '{}' of node {} in response",
+                attr_id,
+                UA_StatusCode_name(data_value.status), // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                node_class_structure_lists.at(array_index).exp_node_id.ToString());
+            node_class_structure_lists.at(array_index).result_code = data_value.status;
+        }
+    };
+
+    // The results are set only after the successful response, so the request can be issued again after the recovery of the session.
+    return WithSessionRecovery(
+        "ReadNodeClasses",
+        [&]
+        {
+            return ReadNodesAttributes(*read_value_ids, set_node_class);
         });
 }
 
@@ -190,6 +412,30 @@ StatusResults Open62541ClientWrapper::ReadNodeClasses(std::vector<NodeClassesReq
 StatusResults Open62541ClientWrapper::ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
 {
     m_logger.Trace("Method called: ReadNodeReferences()");
+    std::vector<size_t> number_of_references;
+    number_of_references.reserve(node_references_structure_lists.size());
+    for (const auto& node_ref_request_response_struct : node_references_structure_lists)
+    {
+        number_of_references.push_back(node_ref_request_response_struct.references.size());
+    }
+    return WithSessionRecovery(
+        "ReadNodeReferences",
+        [&]
+        {
+            // The continuation points of the lost session are not valid in the new one, so the references received before the loss are dropped
+            // and the whole batch is browsed again.
+            for (size_t index = 0; index < node_references_structure_lists.size(); ++index)
+            {
+                auto& references = node_references_structure_lists.at(index).references;
+                references.erase(references.begin() + static_cast<std::ptrdiff_t>(number_of_references.at(index)), references.end());
+            }
+            return BrowseReferences(node_references_structure_lists);
+        });
+}
+
+StatusResults Open62541ClientWrapper::BrowseReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+{
+    m_logger.Trace("Method called: BrowseReferences()");
 
     UA_BrowseRequest b_req; // The structure on the stack will be deleted upon exit, except for the structures at the pointer "UA_BrowseDescription *nodesToBrowse".
     UA_BrowseRequest_init(&b_req);
@@ -229,6 +475,7 @@ StatusResults Open62541ClientWrapper::ReadNodeReferences(std::vector<NodeReferen
     b_req.nodesToBrowse = b_req_vector->data();
     b_req.nodesToBrowseSize = b_req_vector->size();
     b_req.requestedMaxReferencesPerNode = m_requested_max_references_per_node;
+    b_req.view = m_view.GetRef(); // The request is not cleared, the View is owned by the wrapper.
 
     // Create a structure to ensure that UA_BrowseResponse is removed when exiting the processing function.
     struct UaBrowseResponseWithAutoClear // NOLINT(cppcoreguidelines-special-member-functions)
@@ -242,10 +489,13 @@ StatusResults Open62541ClientWrapper::ReadNodeReferences(std::vector<NodeReferen
         UA_BrowseResponse& value;
     };
 
+    const auto request_time = ThrottleRequest(b_req.nodesToBrowseSize);
     UaBrowseResponseWithAutoClear response(UA_Client_Service_browse(&m_ua_client, b_req)); //<-- BROWSE
+    AccountResponse(request_time, b_req.nodesToBrowseSize, &response.value, UA_TYPES[UA_TYPES_BROWSERESPONSE]);
     if (UA_StatusCode_isBad(response.value.responseHeader.serviceResult))
     {
         m_logger.Error("Browse has error from Open62541: {}", UA_StatusCode_name(response.value.responseHeader.serviceResult));
+        m_last_service_result = response.value.responseHeader.serviceResult;
         return StatusResults::Fail;
     }
     if (UA_StatusCode_isUncertain(response.value.responseHeader.serviceResult))
@@ -292,11 +542,25 @@ StatusResults Open62541ClientWrapper::ReadNodeReferences(std::vector<NodeReferen
         // Call BrowseNext. The condition prevents an unnecessary function call when everything has been read
         if (response.value.results[node_index].continuationPoint.length != 0) // NOLINT
         {
-            if (BrowseNext(&response.value.results[node_index].continuationPoint, node_references_structure_lists.at(node_index).references) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-                == StatusResults::Fail)
+            auto status = BrowseNext(
+                &response.value.results[node_index].continuationPoint, // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                node_references_structure_lists.at(node_index).references);
+            if (status == StatusResults::Fail)
             {
+                if (status.GetSubStatus() == StatusResults::Cancelled)
+                {
+                    // The remaining continuation points of this response are no longer needed, I release them so as not to keep the server resources.
+                    for (size_t rest_index = node_index + 1; rest_index < response.value.resultsSize; ++rest_index)
+                    {
+                        if (response.value.results[rest_index].continuationPoint.length != 0) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                        {
+                            ReleaseContinuationPoint(response.value.results[rest_index].continuationPoint); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                        }
+                    }
+                    return status;
+                }
                 m_logger.Error("BrowseNext error with NodeID: {}", node_references_structure_lists.at(node_index).exp_node_id.ToString());
-                return StatusResults::Fail;
+                return status;
             }
         }
     }
@@ -337,30 +601,35 @@ StatusResults Open62541ClientWrapper::ReadNodesAttributes(std::vector<NodeAttrib
     }
 
     std::vector<std::optional<VariantsOfAttr>> variants(flat_attr_numbers);
-    StatusResults result = ReadNodesAttributes(
-        *read_value_ids,
-        [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& node_id, UA_UInt32 attr_id) // attr_index == array_index
+    const auto set_variant = [&](size_t array_index, UA_DataValue& data_value, UA_NodeId& node_id, UA_UInt32 attr_id) // attr_index == array_index
+    {
+        if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         {
-            if (!UA_StatusCode_isBad(data_value.status) && data_value.hasValue) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (attr_id == UA_ATTRIBUTEID_VALUE)
             {
-                if (attr_id == UA_ATTRIBUTEID_VALUE)
-                {
-                    variants.at(array_index) = std::optional<VariantsOfAttr>{VariantsOfAttr(UATypesContainer<UA_Variant>(data_value.value, UA_TYPES_VARIANT))};
-                }
-                else
-                {
-                    variants.at(array_index) = UAVariantToStdVariant(data_value.value);
-                }
+                variants.at(array_index) = std::optional<VariantsOfAttr>{VariantsOfAttr(UATypesContainer<UA_Variant>(data_value.value, UA_TYPES_VARIANT))};
             }
             else
             {
-                variants.at(array_index) = std::nullopt;
-                m_logger.Warning(
-                    "ReadNodesAtrrubutes (atrID={}) has bad status '{}' of node {} in response",
-                    attr_id,
-                    UA_StatusCode_name(data_value.status), // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-                    UATypesContainer<UA_NodeId>(node_id, UA_TYPES_NODEID).ToString());
+                variants.at(array_index) = UAVariantToStdVariant(data_value.value);
             }
+        }
+        else
+        {
+            variants.at(array_index) = std::nullopt;
+            m_logger.Warning(
+                "ReadNodesAtrrubutes (atrID={}) has bad status '{}' of node {} in response",
+                attr_id,
+                UA_StatusCode_name(data_value.status), // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                UATypesContainer<UA_NodeId>(node_id, UA_TYPES_NODEID).ToString());
+        }
+    };
+
+    StatusResults result = WithSessionRecovery(
+        "ReadNodesAttributes",
+        [&]
+        {
+            return ReadNodesAttributes(*read_value_ids, set_variant);
         });
 
     if (result != StatusResults::Good)
@@ -387,16 +656,102 @@ StatusResults Open62541ClientWrapper::ReadNodesAttributes(std::vector<NodeAttrib
 StatusResults Open62541ClientWrapper::ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value)
 {
     m_logger.Trace("Method called: ReadNodeDataValue()");
-    auto status = UA_Client_readValueAttribute(&m_ua_client, node_id.GetRef().nodeId, &data_value.GetRef());
+    return WithSessionRecovery(
+        "ReadNodeDataValue",
+        [&]
+        {
+            // The high-level function does not give the response, the size of the value is not accounted.
+            const auto request_time = ThrottleRequest(1);
+            auto status = UA_Client_readValueAttribute(&m_ua_client, node_id.GetRef().nodeId, &data_value.GetRef());
+            UA_ResponseHeader response_header;
+            UA_ResponseHeader_init(&response_header);
+            response_header.serviceResult = status;
+            AccountResponse(request_time, 1, &response_header, UA_TYPES[UA_TYPES_RESPONSEHEADER]);
+            if (UA_StatusCode_isBad(status))
+            {
+                m_logger.Error("ReadNodeDataValue has error from Open62541: {}", UA_StatusCode_name(status));
+                m_last_service_result = status;
+                return StatusResults::Fail;
+            }
+            if (UA_StatusCode_isUncertain(status))
+            {
+                m_logger.Warning("ReadNodeDataValue has uncertain value from Open62541: {}", UA_StatusCode_name(status));
+            }
+            return StatusResults::Good;
+        });
+}
+
+StatusResults Open62541ClientWrapper::ReadNodeDataValueRange(
+    const UATypesContainer<UA_ExpandedNodeId>& node_id,
+    size_t first_index,
+    size_t number_of_elements,
+    UATypesContainer<UA_Variant>& data_value)
+{
+    m_logger.Trace("Method called: ReadNodeDataValueRange()");
+    if (number_of_elements == 0)
+    {
+        m_logger.Error("ReadNodeDataValueRange. The number of elements is zero. NodeID: {}", node_id.ToString());
+        return StatusResults::Fail;
+    }
+    // The operation refers to the NodeId and the IndexRange text and does not own them.
+    auto index_range = nodesetexporter::common::IndexRangeToStdString(first_index, number_of_elements);
+    UA_ReadValueId read_value_id;
+    UA_ReadValueId_init(&read_value_id);
+    read_value_id.nodeId = node_id.GetRef().nodeId;
+    read_value_id.attributeId = UA_ATTRIBUTEID_VALUE;
+    read_value_id.indexRange = UA_STRING(index_range.data());
+
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = &read_value_id;
+    request.nodesToReadSize = 1;
+    // The same automatic clearing of the response as in ReadNodesAttributes.
+    struct ReadResponseWithAutoClear // NOLINT(cppcoreguidelines-special-member-functions)
+    {
+        ~ReadResponseWithAutoClear()
+        {
+            UA_ReadResponse_clear(&value);
+        }
+        UA_ReadResponse value;
+    };
+    ReadResponseWithAutoClear response_wrap{};
+    // The lost connection is recovered, the other errors of the service are processed below.
+    std::ignore = WithSessionRecovery(
+        "ReadNodeDataValueRange",
+        [&]
+        {
+            UA_ReadResponse_clear(&response_wrap.value);
+            const auto request_time = ThrottleRequest(1);
+            response_wrap.value = UA_Client_Service_read(&m_ua_client, request); // <-- REQUEST DATA VIA Open62541
+            AccountResponse(request_time, 1, &response_wrap.value, UA_TYPES[UA_TYPES_READRESPONSE]);
+            m_last_service_result = response_wrap.value.responseHeader.serviceResult;
+            return UA_StatusCode_isBad(m_last_service_result) ? StatusResults::Fail : StatusResults::Good;
+        });
+    auto& response = response_wrap.value;
+
+    UA_StatusCode status = response.responseHeader.serviceResult;
+    if (UA_StatusCode_isGood(status) || UA_StatusCode_isUncertain(status))
+    {
+        status = response.resultsSize == 1 && response.results != nullptr ? response.results[0].status : UA_STATUSCODE_BADUNEXPECTEDERROR; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    UA_Variant_clear(&data_value.GetRef());
+    if (status == UA_STATUSCODE_BADINDEXRANGENODATA)
+    {
+        // The array ends before first_index.
+        return StatusResults::Good;
+    }
     if (UA_StatusCode_isBad(status))
     {
-        m_logger.Error("ReadNodeDataValue has error from Open62541: {}", UA_StatusCode_name(status));
+        m_logger.Warning("ReadNodeDataValueRange ({}) has error from Open62541: {}. NodeID: {}", index_range, UA_StatusCode_name(status), node_id.ToString());
         return StatusResults::Fail;
     }
     if (UA_StatusCode_isUncertain(status))
     {
-        m_logger.Warning("ReadNodeDataValue has uncertain value from Open62541: {}", UA_StatusCode_name(status));
+        m_logger.Warning("ReadNodeDataValueRange has uncertain value from Open62541: {}", UA_StatusCode_name(status));
     }
+    // Moving the value from the response, so as not to copy the part of the array.
+    data_value.GetRef() = response.results[0].value; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    UA_Variant_init(&response.results[0].value); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     return StatusResults::Good;
 }
 
@@ -0,0 +1,585 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/DataTypeDefinitionCache.h"
+#include "nodesetexporter/common/DatatypeAliases.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <open62541/nodeids.h>
+#include <tinyxml2.h>
+
+#include <set>
+
+namespace nodesetexporter::open62541
+{
+
+using nodesetexporter::common::UaStringToStdString;
+using nodesetexporter::datatypealiases::data_type_aliases;
+using tinyxml2::XMLDocument;
+using tinyxml2::XMLElement;
+
+namespace
+{
+
+constexpr std::string_view default_binary_encoding_name = "Default Binary";
+constexpr std::string_view opc_binary_namespace = "http://opcfoundation.org/BinarySchema/";
+constexpr std::string_view opc_ua_namespace = "http://opcfoundation.org/UA/";
+
+/**
+ * @brief Name without the namespace prefix, for example "opc:Int32" -> "Int32".
+ */
+std::string_view LocalName(const char* name)
+{
+    std::string_view local_name(name != nullptr ? name : "");
+    const auto prefix_end = local_name.find(':');
+    if (prefix_end != std::string_view::npos)
+    {
+        local_name.remove_prefix(prefix_end + 1);
+    }
+    return local_name;
+}
+
+/**
+ * @brief Namespace prefix of the name, for example "opc:Int32" -> "opc". Empty if there is no prefix.
+ */
+std::string_view Prefix(const char* name)
+{
+    std::string_view prefix(name != nullptr ? name : "");
+    const auto prefix_end = prefix.find(':');
+    return prefix_end != std::string_view::npos ? prefix.substr(0, prefix_end) : std::string_view{};
+}
+
+UATypesContainer<UA_NodeId> NodeIdOf(const UATypesContainer<UA_ExpandedNodeId>& exp_node_id)
+{
+    return UATypesContainer<UA_NodeId>(exp_node_id.GetRef().nodeId, UA_TYPES_NODEID);
+}
+
+} // namespace
+
+StatusResults DataTypeDefinitionCache::ResolveFromDictionaries(
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& data_type_ids,
+    std::vector<std::optional<VariantsOfAttr>>& definitions)
+{
+    m_logger.Trace("Method called: ResolveFromDictionaries()");
+    definitions.assign(data_type_ids.size(), std::nullopt);
+
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> unresolved_ids;
+    for (const auto& data_type_id : data_type_ids)
+    {
+        if (!m_definitions.contains(NodeIdOf(data_type_id)))
+        {
+            unresolved_ids.push_back(data_type_id);
+        }
+    }
+
+    if (!unresolved_ids.empty())
+    {
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> dictionary_ids;
+        if (FindDictionaries(unresolved_ids, dictionary_ids) == StatusResults::Fail)
+        {
+            return StatusResults::Fail;
+        }
+        for (const auto& dictionary_id : dictionary_ids)
+        {
+            if (m_loaded_dictionaries.insert(NodeIdOf(dictionary_id)).second && LoadDictionary(dictionary_id) == StatusResults::Fail)
+            {
+                return StatusResults::Fail;
+            }
+        }
+        // The data types missing in the dictionaries are not requested again.
+        for (const auto& data_type_id : unresolved_ids)
+        {
+            if (m_definitions.try_emplace(NodeIdOf(data_type_id), std::nullopt).second)
+            {
+                m_logger.Debug("The definition of the data type {} is not found in the DataTypeDictionary.", data_type_id.ToString());
+            }
+        }
+    }
+
+    for (size_t index = 0; index < data_type_ids.size(); ++index)
+    {
+        definitions.at(index) = m_definitions.at(NodeIdOf(data_type_ids.at(index)));
+    }
+    return StatusResults::Good;
+}
+
+const DataTypeDefinitionCache::FieldDataTypeAliases& DataTypeDefinitionCache::GetFieldDataTypeAliases(
+    const UATypesContainer<UA_ExpandedNodeId>& data_type_id,
+    const VariantsOfAttr& definition)
+{
+    auto [cached, is_inserted] = m_field_data_type_aliases.try_emplace(NodeIdOf(data_type_id));
+    if (!is_inserted)
+    {
+        return cached->second;
+    }
+
+    const auto* const structure_definition = std::get_if<UATypesContainer<UA_StructureDefinition>>(&definition);
+    if (structure_definition == nullptr)
+    {
+        return cached->second;
+    }
+    std::set<std::string> unique_aliases;
+    const auto& ua_definition = structure_definition->GetRef();
+    for (size_t index = 0; index < ua_definition.fieldsSize; ++index)
+    {
+        const auto& field_data_type = ua_definition.fields[index].dataType; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (field_data_type.namespaceIndex != 0 || field_data_type.identifierType != UA_NODEIDTYPE_NUMERIC)
+        {
+            continue;
+        }
+        const auto alias = data_type_aliases.find(field_data_type.identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
+        if (alias != data_type_aliases.end() && unique_aliases.insert(alias->second).second)
+        {
+            cached->second.emplace_back(alias->second, UATypesContainer<UA_NodeId>(field_data_type, UA_TYPES_NODEID));
+        }
+    }
+    return cached->second;
+}
+
+StatusResults DataTypeDefinitionCache::BrowseTargets(
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids,
+    UA_UInt32 reference_type_id,
+    bool is_forward,
+    std::string_view browse_name,
+    std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>>& targets)
+{
+    m_logger.Trace("Method called: BrowseTargets()");
+    targets.assign(node_ids.size(), std::nullopt);
+    if (node_ids.empty())
+    {
+        return StatusResults::Good;
+    }
+
+    std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res;
+    node_references_req_res.reserve(node_ids.size());
+    for (const auto& node_id : node_ids)
+    {
+        node_references_req_res.emplace_back(node_id);
+    }
+    if (m_open62541_lib.ReadNodeReferences(node_references_req_res) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        return StatusResults::Fail;
+    }
+    if (node_references_req_res.size() != node_ids.size())
+    {
+        m_logger.Error("DataTypeDefinitionCache::BrowseTargets(). The number of the responses does not match the number of the nodes.");
+        return StatusResults::Fail;
+    }
+
+    for (size_t index = 0; index < node_ids.size(); ++index)
+    {
+        for (const auto& reference : node_references_req_res.at(index).references)
+        {
+            const auto& ref = reference.GetRef();
+            if (ref.isForward != is_forward || ref.referenceTypeId.namespaceIndex != 0 || ref.referenceTypeId.identifierType != UA_NODEIDTYPE_NUMERIC
+                || ref.referenceTypeId.identifier.numeric != reference_type_id) // NOLINT(cppcoreguidelines-pro-type-union-access)
+            {
+                continue;
+            }
+            if (!browse_name.empty() && UaStringToStdString(ref.browseName.name) != browse_name)
+            {
+                continue;
+            }
+            targets.at(index).emplace(ref.nodeId, UA_TYPES_EXPANDEDNODEID);
+            break;
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults DataTypeDefinitionCache::FindDictionaries(
+    const std::vector<UATypesContainer<UA_ExpandedNodeId>>& data_type_ids,
+    std::vector<UATypesContainer<UA_ExpandedNodeId>>& dictionary_ids)
+{
+    m_logger.Trace("Method called: FindDictionaries()");
+
+    // Takes the found targets for the next step of the chain.
+    const auto found = [](std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>>& targets)
+    {
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> result;
+        for (auto& target : targets)
+        {
+            if (target.has_value())
+            {
+                result.push_back(std::move(target.value()));
+            }
+        }
+        return result;
+    };
+
+    // DataType --HasEncoding--> "Default Binary"
+    std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>> targets;
+    if (BrowseTargets(data_type_ids, UA_NS0ID_HASENCODING, true, default_binary_encoding_name, targets) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+    const auto encoding_ids = found(targets);
+
+    // "Default Binary" --HasDescription--> DataTypeDescription
+    if (BrowseTargets(encoding_ids, UA_NS0ID_HASDESCRIPTION, true, "", targets) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+    const auto description_ids = found(targets);
+
+    // DataTypeDescription <--HasComponent-- DataTypeDictionary
+    if (BrowseTargets(description_ids, UA_NS0ID_HASCOMPONENT, false, "", targets) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+    std::unordered_set<UATypesContainer<UA_NodeId>> unique_dictionaries;
+    for (auto& dictionary_id : found(targets))
+    {
+        if (unique_dictionaries.insert(NodeIdOf(dictionary_id)).second)
+        {
+            dictionary_ids.push_back(std::move(dictionary_id));
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults DataTypeDefinitionCache::LoadDictionary(const UATypesContainer<UA_ExpandedNodeId>& dictionary_id)
+{
+    m_logger.Trace("Method called: LoadDictionary()");
+    m_logger.Debug("Loading of the DataTypeDictionary {}", dictionary_id.ToString());
+
+    // The descriptions of the data types are the components of the dictionary.
+    std::vector<IOpen62541::NodeReferencesRequestResponse> dictionary_references{dictionary_id};
+    if (m_open62541_lib.ReadNodeReferences(dictionary_references) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        return StatusResults::Fail;
+    }
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> description_ids;
+    for (const auto& reference : dictionary_references.at(0).references)
+    {
+        const auto& ref = reference.GetRef();
+        if (ref.isForward && ref.nodeClass == UA_NODECLASS_VARIABLE && ref.referenceTypeId.namespaceIndex == 0 && ref.referenceTypeId.identifierType == UA_NODEIDTYPE_NUMERIC
+            && ref.referenceTypeId.identifier.numeric == UA_NS0ID_HASCOMPONENT) // NOLINT(cppcoreguidelines-pro-type-union-access)
+        {
+            description_ids.emplace_back(ref.nodeId, UA_TYPES_EXPANDEDNODEID);
+        }
+    }
+    if (description_ids.empty())
+    {
+        m_logger.Warning("The DataTypeDictionary {} has no descriptions of the data types.", dictionary_id.ToString());
+        return StatusResults::Good;
+    }
+
+    // The value of the description is the name of the type in the dictionary, the BrowseName is used if the value is missing.
+    std::vector<IOpen62541::NodeAttributesRequestResponse> description_attrs;
+    description_attrs.reserve(description_ids.size());
+    for (const auto& description_id : description_ids)
+    {
+        description_attrs.push_back(IOpen62541::NodeAttributesRequestResponse{description_id, {{UA_ATTRIBUTEID_BROWSENAME, std::nullopt}, {UA_ATTRIBUTEID_VALUE, std::nullopt}}});
+    }
+    if (m_open62541_lib.ReadNodesAttributes(description_attrs) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        return StatusResults::Fail;
+    }
+
+    // DataTypeDescription <--HasDescription-- Encoding <--HasEncoding-- DataType
+    std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>> encoding_ids;
+    if (BrowseTargets(description_ids, UA_NS0ID_HASDESCRIPTION, false, "", encoding_ids) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+    std::vector<size_t> encoded_indexes;
+    std::vector<UATypesContainer<UA_ExpandedNodeId>> found_encoding_ids;
+    for (size_t index = 0; index < encoding_ids.size(); ++index)
+    {
+        if (encoding_ids.at(index).has_value())
+        {
+            encoded_indexes.push_back(index);
+            found_encoding_ids.push_back(encoding_ids.at(index).value());
+        }
+    }
+    std::vector<std::optional<UATypesContainer<UA_ExpandedNodeId>>> data_type_ids;
+    if (BrowseTargets(found_encoding_ids, UA_NS0ID_HASENCODING, false, "", data_type_ids) == StatusResults::Fail)
+    {
+        return StatusResults::Fail;
+    }
+
+    // The name of the type in the dictionary --> {DataType, Encoding}
+    std::map<std::string, std::pair<UATypesContainer<UA_NodeId>, UATypesContainer<UA_NodeId>>, std::less<>> dictionary_types;
+    for (size_t index = 0; index < encoded_indexes.size(); ++index)
+    {
+        if (!data_type_ids.at(index).has_value())
+        {
+            continue;
+        }
+        const auto& attrs = description_attrs.at(encoded_indexes.at(index)).attrs;
+        std::string type_name;
+        const auto value = attrs.find(UA_ATTRIBUTEID_VALUE);
+        if (value != attrs.end() && value->second.has_value())
+        {
+            if (const auto* const variant = std::get_if<UATypesContainer<UA_Variant>>(&value->second.value());
+                variant != nullptr && UA_Variant_hasScalarType(&variant->GetRef(), &UA_TYPES[UA_TYPES_STRING]))
+            {
+                type_name = UaStringToStdString(*static_cast<const UA_String*>(variant->GetRef().data));
+            }
+        }
+        const auto browse_name = attrs.find(UA_ATTRIBUTEID_BROWSENAME);
+        if (type_name.empty() && browse_name != attrs.end() && browse_name->second.has_value())
+        {
+            if (const auto* const name = std::get_if<UATypesContainer<UA_QualifiedName>>(&browse_name->second.value()))
+            {
+                type_name = UaStringToStdString(name->GetRef().name);
+            }
+        }
+        if (!type_name.empty())
+        {
+            dictionary_types.try_emplace(type_name, NodeIdOf(data_type_ids.at(index).value()), NodeIdOf(found_encoding_ids.at(index)));
+        }
+    }
+
+    // The dictionary itself
+    UATypesContainer<UA_Variant> dictionary_value(UA_TYPES_VARIANT);
+    if (m_open62541_lib.ReadNodeDataValue(dictionary_id, dictionary_value) == StatusResults::Fail) // REQUEST<-->RESPONSE
+    {
+        return StatusResults::Fail;
+    }
+    if (!UA_Variant_hasScalarType(&dictionary_value.GetRef(), &UA_TYPES[UA_TYPES_BYTESTRING]))
+    {
+        m_logger.Warning("The value of the DataTypeDictionary {} is not a ByteString.", dictionary_id.ToString());
+        return StatusResults::Good;
+    }
+
+    std::map<std::string, VariantsOfAttr> definitions;
+    const auto resolve_type_name = [&dictionary_types](std::string_view type_name) -> std::optional<UATypesContainer<UA_NodeId>>
+    {
+        const auto dictionary_type = dictionary_types.find(type_name);
+        if (dictionary_type == dictionary_types.end())
+        {
+            return std::nullopt;
+        }
+        return dictionary_type->second.first;
+    };
+    if (ParseTypeDictionary(UaStringToStdString(*static_cast<const UA_ByteString*>(dictionary_value.GetRef().data)), resolve_type_name, definitions) == StatusResults::Fail)
+    {
+        m_logger.Warning("The DataTypeDictionary {} cannot be parsed.", dictionary_id.ToString());
+        return StatusResults::Good;
+    }
+
+    for (auto& [type_name, definition] : definitions)
+    {
+        const auto dictionary_type = dictionary_types.find(type_name);
+        if (dictionary_type == dictionary_types.end())
+        {
+            continue;
+        }
+        if (auto* const structure_definition = std::get_if<UATypesContainer<UA_StructureDefinition>>(&definition))
+        {
+            UA_NodeId_clear(&structure_definition->GetRef().defaultEncodingId);
+            UA_NodeId_copy(&dictionary_type->second.second.GetRef(), &structure_definition->GetRef().defaultEncodingId);
+        }
+        m_definitions.insert_or_assign(dictionary_type->second.first, std::move(definition));
+        ++m_number_of_definitions;
+    }
+    m_logger.Debug("The DataTypeDictionary {} is loaded, the number of the definitions: {}", dictionary_id.ToString(), definitions.size());
+    return StatusResults::Good;
+}
+
+StatusResults DataTypeDefinitionCache::ParseTypeDictionary(const std::string& xml, const TypeNameResolver& resolve_type_name, std::map<std::string, VariantsOfAttr>& definitions) const
+{
+    m_logger.Trace("Method called: ParseTypeDictionary()");
+    XMLDocument document;
+    if (document.Parse(xml.data(), xml.size()) != tinyxml2::XML_SUCCESS)
+    {
+        m_logger.Error("DataTypeDefinitionCache::ParseTypeDictionary(). XML parsing error: {}", document.ErrorStr());
+        return StatusResults::Fail;
+    }
+    const auto* const xml_dictionary = document.RootElement();
+    if (xml_dictionary == nullptr || LocalName(xml_dictionary->Name()) != "TypeDictionary")
+    {
+        m_logger.Error("DataTypeDefinitionCache::ParseTypeDictionary(). The TypeDictionary element is missing.");
+        return StatusResults::Fail;
+    }
+
+    // Namespace prefixes of the document
+    std::map<std::string, std::string, std::less<>> namespaces;
+    for (const auto* attr = xml_dictionary->FirstAttribute(); attr != nullptr; attr = attr->Next())
+    {
+        const std::string_view name(attr->Name());
+        if (name == "xmlns")
+        {
+            namespaces.insert_or_assign("", attr->Value());
+        }
+        else if (name.starts_with("xmlns:"))
+        {
+            namespaces.insert_or_assign(std::string(name.substr(std::string_view("xmlns:").size())), attr->Value());
+        }
+    }
+    const auto* const target_namespace = xml_dictionary->Attribute("TargetNamespace");
+    std::set<std::string, std::less<>> enumerated_types;
+    for (const auto* xml_type = xml_dictionary->FirstChildElement(); xml_type != nullptr; xml_type = xml_type->NextSiblingElement())
+    {
+        if (LocalName(xml_type->Name()) == "EnumeratedType" && xml_type->Attribute("Name") != nullptr)
+        {
+            enumerated_types.insert(xml_type->Attribute("Name"));
+        }
+    }
+
+    const std::function<std::optional<UATypesContainer<UA_NodeId>>(const char*)> resolve_qualified_name = [&](const char* qualified_name) -> std::optional<UATypesContainer<UA_NodeId>>
+    {
+        const auto uri = namespaces.find(Prefix(qualified_name));
+        if (uri == namespaces.end())
+        {
+            return std::nullopt;
+        }
+        if (uri->second == opc_binary_namespace || uri->second == opc_ua_namespace)
+        {
+            return GetStandardDataTypeNodeId(LocalName(qualified_name));
+        }
+        if (target_namespace == nullptr || uri->second != target_namespace)
+        {
+            return std::nullopt;
+        }
+        if (auto data_type = resolve_type_name(LocalName(qualified_name)))
+        {
+            return data_type;
+        }
+        if (enumerated_types.contains(LocalName(qualified_name)))
+        {
+            return UATypesContainer<UA_NodeId>(UA_NODEID_NUMERIC(0, UA_NS0ID_ENUMERATION), UA_TYPES_NODEID);
+        }
+        return std::nullopt;
+    };
+
+    for (const auto* xml_type = xml_dictionary->FirstChildElement(); xml_type != nullptr; xml_type = xml_type->NextSiblingElement())
+    {
+        const auto* const type_name = xml_type->Attribute("Name");
+        if (type_name == nullptr || LocalName(xml_type->Name()) != "StructuredType")
+        {
+            continue;
+        }
+        auto definition = ParseStructuredType(*xml_type, resolve_qualified_name);
+        if (definition.has_value())
+        {
+            definitions.insert_or_assign(type_name, std::move(definition.value()));
+        }
+    }
+    return StatusResults::Good;
+}
+
+std::optional<VariantsOfAttr> DataTypeDefinitionCache::ParseStructuredType(
+    const XMLElement& xml_type,
+    const std::function<std::optional<UATypesContainer<UA_NodeId>>(const char*)>& resolve_qualified_name) const
+{
+    // The fields that are only the part of the binary encoding: the lengths of the arrays, the switch of the union and the mask of the optional fields.
+    std::set<std::string, std::less<>> encoding_fields;
+    bool is_union = false;
+    bool has_optional_fields = false;
+    for (const auto* xml_field = xml_type.FirstChildElement(); xml_field != nullptr; xml_field = xml_field->NextSiblingElement())
+    {
+        if (LocalName(xml_field->Name()) != "Field")
+        {
+            continue;
+        }
+        if (const auto* const length_field = xml_field->Attribute("LengthField"))
+        {
+            encoding_fields.insert(length_field);
+        }
+        if (const auto* const switch_field = xml_field->Attribute("SwitchField"))
+        {
+            encoding_fields.insert(switch_field);
+            if (xml_field->Attribute("SwitchValue") != nullptr)
+            {
+                is_union = true;
+            }
+            else
+            {
+                has_optional_fields = true;
+            }
+        }
+    }
+
+    std::vector<const XMLElement*> xml_fields;
+    for (const auto* xml_field = xml_type.FirstChildElement(); xml_field != nullptr; xml_field = xml_field->NextSiblingElement())
+    {
+        const auto* const name = xml_field->Attribute("Name");
+        if (LocalName(xml_field->Name()) != "Field" || name == nullptr || encoding_fields.contains(std::string_view(name)) || LocalName(xml_field->Attribute("TypeName")) == "Bit")
+        {
+            continue;
+        }
+        xml_fields.push_back(xml_field);
+    }
+
+    UATypesContainer<UA_StructureDefinition> definition(UA_TYPES_STRUCTUREDEFINITION);
+    auto& ua_definition = definition.GetRef();
+    ua_definition.structureType = is_union ? UA_STRUCTURETYPE_UNION : (has_optional_fields ? UA_STRUCTURETYPE_STRUCTUREWITHOPTIONALFIELDS : UA_STRUCTURETYPE_STRUCTURE);
+
+    // The structures of the dictionary are inherited from ExtensionObject, that is Structure.
+    ua_definition.baseDataType = UA_NODEID_NUMERIC(0, UA_NS0ID_STRUCTURE);
+    if (const auto* const base_type = xml_type.Attribute("BaseType"))
+    {
+        if (auto base_data_type = resolve_qualified_name(base_type))
+        {
+            UA_NodeId_copy(&base_data_type->GetRef(), &ua_definition.baseDataType);
+        }
+    }
+
+    ua_definition.fields = static_cast<UA_StructureField*>(UA_Array_new(xml_fields.size(), &UA_TYPES[UA_TYPES_STRUCTUREFIELD]));
+    if (!xml_fields.empty() && ua_definition.fields == nullptr)
+    {
+        m_logger.Error("DataTypeDefinitionCache::ParseStructuredType(). Memory allocation error.");
+        return std::nullopt;
+    }
+    ua_definition.fieldsSize = xml_fields.size();
+    for (size_t index = 0; index < xml_fields.size(); ++index)
+    {
+        const auto& xml_field = *xml_fields.at(index);
+        auto& field = ua_definition.fields[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        field.name = UA_String_fromChars(xml_field.Attribute("Name"));
+        field.valueRank = xml_field.Attribute("LengthField") != nullptr ? UA_VALUERANK_ONE_DIMENSION : UA_VALUERANK_SCALAR;
+        field.isOptional = xml_field.Attribute("SwitchField") != nullptr && xml_field.Attribute("SwitchValue") == nullptr;
+
+        const auto* const type_name = xml_field.Attribute("TypeName");
+        if (auto data_type = resolve_qualified_name(type_name))
+        {
+            UA_NodeId_copy(&data_type->GetRef(), &field.dataType);
+        }
+        else
+        {
+            m_logger.Warning(
+                "The type {} of the field {}.{} is not resolved, BaseDataType is used.",
+                type_name != nullptr ? type_name : "",
+                xml_type.Attribute("Name"),
+                xml_field.Attribute("Name"));
+            field.dataType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE);
+        }
+    }
+    return VariantsOfAttr(std::move(definition));
+}
+
+std::optional<UATypesContainer<UA_NodeId>> DataTypeDefinitionCache::GetStandardDataTypeNodeId(std::string_view type_name)
+{
+    // The names of the data types of the standard and the OPC Binary types that differ from them.
+    static const auto standard_data_types = []()
+    {
+        std::map<std::string, UA_UInt32, std::less<>> names{
+            {"CharArray", UA_NS0ID_STRING},
+            {"WideString", UA_NS0ID_STRING},
+            {"WideCharArray", UA_NS0ID_STRING},
+            {"ExtensionObject", UA_NS0ID_STRUCTURE},
+            {"Variant", UA_NS0ID_BASEDATATYPE}};
+        for (const auto& [numeric_id, alias] : data_type_aliases)
+        {
+            names.try_emplace(alias, numeric_id);
+        }
+        return names;
+    }();
+
+    const auto data_type = standard_data_types.find(type_name);
+    if (data_type == standard_data_types.end())
+    {
+        return std::nullopt;
+    }
+    return UATypesContainer<UA_NodeId>(UA_NODEID_NUMERIC(0, data_type->second), UA_TYPES_NODEID);
+}
+
+} // namespace nodesetexporter::open62541
@@ -0,0 +1,295 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/DiscoveryRules.h"
+
+#include <charconv>
+#include <map>
+
+namespace nodesetexporter::open62541::discovery
+{
+
+namespace
+{
+const std::map<std::string_view, UA_NodeClass> node_class_names{
+    {"Object", UA_NODECLASS_OBJECT},
+    {"Variable", UA_NODECLASS_VARIABLE},
+    {"Method", UA_NODECLASS_METHOD},
+    {"ObjectType", UA_NODECLASS_OBJECTTYPE},
+    {"VariableType", UA_NODECLASS_VARIABLETYPE},
+    {"ReferenceType", UA_NODECLASS_REFERENCETYPE},
+    {"DataType", UA_NODECLASS_DATATYPE},
+    {"View", UA_NODECLASS_VIEW}};
+
+const std::map<std::string_view, UA_UInt32> reference_type_names{
+    {"HierarchicalReferences", UA_NS0ID_HIERARCHICALREFERENCES},
+    {"HasChild", UA_NS0ID_HASCHILD},
+    {"Organizes", UA_NS0ID_ORGANIZES},
+    {"HasEventSource", UA_NS0ID_HASEVENTSOURCE},
+    {"Aggregates", UA_NS0ID_AGGREGATES},
+    {"HasSubtype", UA_NS0ID_HASSUBTYPE},
+    {"HasProperty", UA_NS0ID_HASPROPERTY},
+    {"HasComponent", UA_NS0ID_HASCOMPONENT},
+    {"HasNotifier", UA_NS0ID_HASNOTIFIER},
+    {"HasOrderedComponent", UA_NS0ID_HASORDEREDCOMPONENT}};
+
+template <typename TNumber>
+bool ParseNumber(std::string_view text, TNumber& number)
+{
+    const auto* const end = text.data() + text.size(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const auto result = std::from_chars(text.data(), end, number);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool ParseRegex(std::string_view text, std::optional<std::regex>& regex)
+{
+    try
+    {
+        regex.emplace(text.begin(), text.end(), std::regex::ECMAScript | std::regex::optimize);
+    }
+    catch (const std::regex_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool ParseNodeClasses(std::string_view text, UA_UInt32& node_class_mask)
+{
+    while (!text.empty())
+    {
+        const auto separator = text.find('|');
+        const auto name = text.substr(0, separator);
+        const auto node_class = node_class_names.find(name);
+        if (node_class == node_class_names.end())
+        {
+            return false;
+        }
+        node_class_mask |= static_cast<UA_UInt32>(node_class->second);
+        text = separator == std::string_view::npos ? std::string_view{} : text.substr(separator + 1);
+    }
+    return node_class_mask != 0;
+}
+
+bool ParseReferenceType(std::string_view text, std::optional<UATypesContainer<UA_NodeId>>& reference_type_id)
+{
+    const auto reference_type = reference_type_names.find(text);
+    if (reference_type != reference_type_names.end())
+    {
+        reference_type_id.emplace(UA_NODEID_NUMERIC(0, reference_type->second), UA_TYPES_NODEID);
+        return true;
+    }
+    UATypesContainer<UA_NodeId> node_id(UA_TYPES_NODEID);
+    const UA_String ua_text{text.size(), reinterpret_cast<UA_Byte*>(const_cast<char*>(text.data()))}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-type-const-cast)
+    if (UA_NodeId_parse(&node_id.GetRef(), ua_text) != UA_STATUSCODE_GOOD)
+    {
+        return false;
+    }
+    reference_type_id.emplace(std::move(node_id));
+    return true;
+}
+} // namespace
+
+DiscoveryFilter::DiscoveryFilter(std::vector<DiscoveryRule> rules)
+    : m_rules(std::move(rules)),
+      m_hits(m_rules.size(), 0)
+{
+}
+
+bool DiscoveryFilter::Accept(const DiscoveryCandidate& candidate)
+{
+    for (size_t index = 0; index < m_rules.size(); ++index)
+    {
+        if (IsMatched(m_rules[index], candidate))
+        {
+            ++m_hits[index];
+            return m_rules[index].action == RuleAction::Include;
+        }
+    }
+    return true;
+}
+
+bool DiscoveryFilter::IsMatched(const DiscoveryRule& rule, const DiscoveryCandidate& candidate)
+{
+    // The cheap criteria are checked first.
+    if (rule.max_depth.has_value() && candidate.depth <= rule.max_depth.value())
+    {
+        return false;
+    }
+    if (rule.namespace_index.has_value() && candidate.node_id.namespaceIndex != rule.namespace_index.value())
+    {
+        return false;
+    }
+    if (rule.node_class_mask != 0 && (rule.node_class_mask & static_cast<UA_UInt32>(candidate.node_class)) == 0)
+    {
+        return false;
+    }
+    if (rule.reference_type_id.has_value() && !UA_NodeId_equal(&rule.reference_type_id->GetRef(), &candidate.reference_type_id))
+    {
+        return false;
+    }
+    const std::string_view browse_name(reinterpret_cast<const char*>(candidate.browse_name.name.data), candidate.browse_name.name.length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (rule.browse_name_glob.has_value() && !GlobMatch(rule.browse_name_glob.value(), browse_name))
+    {
+        return false;
+    }
+    if (rule.browse_name_regex.has_value() && !std::regex_match(browse_name.begin(), browse_name.end(), rule.browse_name_regex.value()))
+    {
+        return false;
+    }
+    if (rule.node_id_regex.has_value() && !std::regex_match(UATypesContainer<UA_NodeId>(candidate.node_id, UA_TYPES_NODEID).ToString(), rule.node_id_regex.value()))
+    {
+        return false;
+    }
+    return true;
+}
+
+void DiscoveryFilter::ReportHits(LoggerBase& logger) const
+{
+    for (size_t index = 0; index < m_rules.size(); ++index)
+    {
+        logger.Info("The rule '{}' matched {} nodes.", m_rules[index].text, m_hits[index]);
+    }
+}
+
+bool GlobMatch(std::string_view pattern, std::string_view text) noexcept
+{
+    size_t pattern_index = 0;
+    size_t text_index = 0;
+    // The position after the last '*' and the position of the text matched by it, for the return when the rest does not match.
+    auto star_index = std::string_view::npos;
+    size_t star_text_index = 0;
+    while (text_index < text.size())
+    {
+        if (pattern_index < pattern.size() && (pattern[pattern_index] == '?' || pattern[pattern_index] == text[text_index]))
+        {
+            ++pattern_index;
+            ++text_index;
+        }
+        else if (pattern_index < pattern.size() && pattern[pattern_index] == '*')
+        {
+            star_index = ++pattern_index;
+            star_text_index = text_index;
+        }
+        else if (star_index != std::string_view::npos)
+        {
+            pattern_index = star_index;
+            text_index = ++star_text_index;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (pattern_index < pattern.size() && pattern[pattern_index] == '*')
+    {
+        ++pattern_index;
+    }
+    return pattern_index == pattern.size();
+}
+
+StatusResults ParseDiscoveryRule(std::string_view text, DiscoveryRule& rule, LoggerBase& logger)
+{
+    rule = DiscoveryRule{};
+    rule.text = text;
+    bool is_action_parsed = false;
+    bool has_criteria = false;
+    while (!text.empty())
+    {
+        const auto token_begin = text.find_first_not_of(' ');
+        if (token_begin == std::string_view::npos)
+        {
+            break;
+        }
+        text.remove_prefix(token_begin);
+        const auto token = text.substr(0, text.find(' '));
+        text.remove_prefix(token.size());
+
+        if (!is_action_parsed)
+        {
+            if (token != "include" && token != "exclude")
+            {
+                logger.Error("The rule '{}' must begin with the action 'include' or 'exclude'.", rule.text);
+                return StatusResults::Fail;
+            }
+            rule.action = token == "include" ? RuleAction::Include : RuleAction::Exclude;
+            is_action_parsed = true;
+            continue;
+        }
+
+        const auto separator = token.find('=');
+        const auto key = token.substr(0, separator);
+        const auto value = separator == std::string_view::npos ? std::string_view{} : token.substr(separator + 1);
+        if (value.empty())
+        {
+            logger.Error("The criterion '{}' has no value in the rule '{}'.", key, rule.text);
+            return StatusResults::Fail;
+        }
+        bool is_valid = true;
+        if (key == "name")
+        {
+            rule.browse_name_glob.emplace(value);
+        }
+        else if (key == "nameregex")
+        {
+            is_valid = ParseRegex(value, rule.browse_name_regex);
+        }
+        else if (key == "ns")
+        {
+            UA_UInt16 namespace_index = 0;
+            is_valid = ParseNumber(value, namespace_index);
+            rule.namespace_index = namespace_index;
+        }
+        else if (key == "nodeid")
+        {
+            is_valid = ParseRegex(value, rule.node_id_regex);
+        }
+        else if (key == "class")
+        {
+            is_valid = ParseNodeClasses(value, rule.node_class_mask);
+        }
+        else if (key == "reftype")
+        {
+            is_valid = ParseReferenceType(value, rule.reference_type_id);
+        }
+        else if (key == "maxdepth")
+        {
+            size_t max_depth = 0;
+            is_valid = ParseNumber(value, max_depth);
+            rule.max_depth = max_depth;
+        }
+        else
+        {
+            logger.Error("Unknown criterion '{}' in the rule '{}'.", key, rule.text);
+            return StatusResults::Fail;
+        }
+        if (!is_valid)
+        {
+            logger.Error("Invalid value of the criterion '{}' in the rule '{}'.", key, rule.text);
+            return StatusResults::Fail;
+        }
+        has_criteria = true;
+    }
+    if (!has_criteria)
+    {
+        logger.Error("The rule '{}' has no criteria.", rule.text);
+        return StatusResults::Fail;
+    }
+    return StatusResults::Good;
+}
+
+DiscoveryRule MakeMaxDepthRule(size_t max_depth)
+{
+    DiscoveryRule rule;
+    rule.text = "exclude maxdepth=" + std::to_string(max_depth);
+    rule.action = RuleAction::Exclude;
+    rule.max_depth = max_depth;
+    return rule;
+}
+
+} // namespace nodesetexporter::open62541::discovery
@@ -0,0 +1,219 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/ExportEstimator.h"
+#include "nodesetexporter/open62541/BrowseOperations.h"
+
+#include <open62541/client_highlevel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace nodesetexporter::open62541::estimation
+{
+
+using ::nodesetexporter::open62541::browseoperations::ForEachChildReference;
+
+namespace
+{
+// The estimation of the size of the node in the NodeSet file by the node class: the element with the attributes, the references and the short value.
+// The Method and the View nodes are not exported.
+const std::map<UA_NodeClass, double> output_bytes_per_class{
+    {UA_NODECLASS_OBJECT, 600},
+    {UA_NODECLASS_VARIABLE, 1200},
+    {UA_NODECLASS_METHOD, 0},
+    {UA_NODECLASS_OBJECTTYPE, 700},
+    {UA_NODECLASS_VARIABLETYPE, 1000},
+    {UA_NODECLASS_REFERENCETYPE, 700},
+    {UA_NODECLASS_DATATYPE, 900},
+    {UA_NODECLASS_VIEW, 0}};
+
+const std::map<UA_NodeClass, std::string_view> node_class_names{
+    {UA_NODECLASS_UNSPECIFIED, "Unspecified"},
+    {UA_NODECLASS_OBJECT, "Object"},
+    {UA_NODECLASS_VARIABLE, "Variable"},
+    {UA_NODECLASS_METHOD, "Method"},
+    {UA_NODECLASS_OBJECTTYPE, "ObjectType"},
+    {UA_NODECLASS_VARIABLETYPE, "VariableType"},
+    {UA_NODECLASS_REFERENCETYPE, "ReferenceType"},
+    {UA_NODECLASS_DATATYPE, "DataType"},
+    {UA_NODECLASS_VIEW, "View"}};
+
+void CountNode(SubtreeCensus& census, const UA_NodeId& node_id, UA_NodeClass node_class, double weight)
+{
+    census.number_of_nodes += weight;
+    census.nodes_per_class[node_class] += weight;
+    census.nodes_per_namespace[node_id.namespaceIndex] += weight;
+}
+
+double NodesOfClass(const SubtreeCensus& census, UA_NodeClass node_class)
+{
+    const auto found = census.nodes_per_class.find(node_class);
+    return found != census.nodes_per_class.end() ? found->second : 0;
+}
+} // namespace
+
+StatusResults SampleSubtree(
+    UA_Client* client,
+    const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+    double fraction,
+    u_int32_t seed,
+    SubtreeCensus& census,
+    LoggerBase& logger,
+    discovery::DiscoveryFilter* const filter,
+    const UA_ViewDescription* const view)
+{
+    logger.Trace("Method called: SampleSubtree()");
+    if (fraction <= 0 || fraction > 1)
+    {
+        logger.Error("The fraction of the sampled nodes must be in the range (0, 1], {} is given.", fraction);
+        return StatusResults::Fail;
+    }
+
+    UA_NodeClass start_node_class = UA_NODECLASS_UNSPECIFIED;
+    const auto class_status = UA_Client_readNodeClassAttribute(client, start_node_id.GetRef().nodeId, &start_node_class);
+    if (UA_StatusCode_isBad(class_status))
+    {
+        logger.Warning("The node class of the start node {} is not read: {}", start_node_id.ToString(), UA_StatusCode_name(class_status));
+    }
+    CountNode(census, start_node_id.GetRef().nodeId, start_node_class, 1);
+
+    std::mt19937 random_engine(seed);
+    std::bernoulli_distribution is_sampled(fraction);
+    // The nodes of the level and the numbers of the nodes of the address space they represent.
+    std::vector<UATypesContainer<UA_NodeId>> level_node_ids;
+    std::vector<double> level_weights{1};
+    level_node_ids.emplace_back(start_node_id.GetRef().nodeId, UA_TYPES_NODEID);
+    std::vector<UATypesContainer<UA_NodeId>> next_level_node_ids;
+    std::vector<double> next_level_weights;
+    std::vector<size_t> sample;
+    size_t depth = 0;
+    while (!level_node_ids.empty())
+    {
+        ++depth;
+        sample.clear();
+        for (size_t index = 0; index < level_node_ids.size(); ++index)
+        {
+            if (fraction >= 1 || is_sampled(random_engine))
+            {
+                sample.push_back(index);
+            }
+        }
+        // At least one node of the level is browsed, otherwise the deeper levels are lost.
+        if (sample.empty())
+        {
+            sample.push_back(std::uniform_int_distribution<size_t>(0, level_node_ids.size() - 1)(random_engine));
+        }
+        const auto scale = static_cast<double>(level_node_ids.size()) / static_cast<double>(sample.size());
+
+        next_level_node_ids.clear();
+        next_level_weights.clear();
+        for (const auto index : sample)
+        {
+            const auto child_weight = level_weights[index] * scale;
+            const auto begin = std::chrono::steady_clock::now();
+            const auto status = ForEachChildReference(
+                client,
+                level_node_ids[index].GetRef(),
+                view,
+                [&](const UA_ReferenceDescription& ref)
+                {
+                    census.browse_response_bytes += UA_calcSizeBinary(&ref, &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION]);
+                    if (filter != nullptr && !filter->Accept({ref.nodeId.nodeId, ref.browseName, ref.nodeClass, ref.referenceTypeId, depth}))
+                    {
+                        return;
+                    }
+                    CountNode(census, ref.nodeId.nodeId, ref.nodeClass, child_weight);
+                    next_level_node_ids.emplace_back(ref.nodeId.nodeId, UA_TYPES_NODEID);
+                    next_level_weights.push_back(child_weight);
+                });
+            census.browse_time += std::chrono::steady_clock::now() - begin;
+            ++census.number_of_browse_requests;
+            ++census.number_of_browsed_nodes;
+            if (UA_StatusCode_isBad(status))
+            {
+                logger.Error("Browsing of the node {} failed: {}", level_node_ids[index].ToString(), UA_StatusCode_name(status));
+                return StatusResults::Fail;
+            }
+        }
+        std::swap(level_node_ids, next_level_node_ids);
+        std::swap(level_weights, next_level_weights);
+    }
+    return StatusResults::Good;
+}
+
+u_int32_t PickBatchSize(double number_of_nodes, const transport::RequestLimits& limits)
+{
+    auto batch_size = static_cast<u_int32_t>(std::min<u_int64_t>(batch_memory_budget / estimated_model_bytes_per_node, UINT32_MAX));
+    const auto limited_by_server = transport::DeriveNumberOfMaxNodesToRequestData(limits);
+    if (limited_by_server != 0)
+    {
+        batch_size = std::min(batch_size, limited_by_server);
+    }
+    if (number_of_nodes >= 1 && number_of_nodes < static_cast<double>(batch_size))
+    {
+        batch_size = static_cast<u_int32_t>(std::ceil(number_of_nodes));
+    }
+    return std::max<u_int32_t>(1, batch_size);
+}
+
+ExportEstimate Forecast(const SubtreeCensus& census, const transport::RequestLimits& limits, u_int32_t batch_size)
+{
+    ExportEstimate estimate;
+    estimate.number_of_exported_nodes = std::max(0.0, census.number_of_nodes - NodesOfClass(census, UA_NODECLASS_METHOD) - NodesOfClass(census, UA_NODECLASS_VIEW));
+    estimate.batch_size = batch_size != 0 ? batch_size : PickBatchSize(estimate.number_of_exported_nodes, limits);
+    estimate.number_of_requests = std::ceil(estimate.number_of_exported_nodes / estimate.batch_size) * requests_per_batch;
+
+    // The references of the node are read by the export too, their size is taken from the browsing.
+    const auto reference_bytes_per_node
+        = census.number_of_browsed_nodes != 0 ? static_cast<double>(census.browse_response_bytes) / static_cast<double>(census.number_of_browsed_nodes) : 0.0;
+    estimate.response_bytes = estimate.number_of_exported_nodes * (transport::estimated_response_bytes_per_node + reference_bytes_per_node);
+
+    for (const auto& [node_class, number_of_nodes] : census.nodes_per_class)
+    {
+        const auto found = output_bytes_per_class.find(node_class);
+        estimate.output_bytes += number_of_nodes * (found != output_bytes_per_class.end() ? found->second : 0.0);
+    }
+
+    // The time of the requests is scaled from the browsing by the number of the requests (the latency) and by the volume of the responses (the throughput),
+    // the larger one is taken.
+    const std::chrono::duration<double> browse_time = census.browse_time;
+    double transfer_seconds = estimate.response_bytes / default_bytes_per_second;
+    if (census.number_of_browse_requests != 0 && browse_time.count() > 0)
+    {
+        const auto latency_seconds = browse_time.count() / static_cast<double>(census.number_of_browse_requests) * estimate.number_of_requests;
+        const auto volume_seconds = census.browse_response_bytes != 0 ? browse_time.count() * estimate.response_bytes / static_cast<double>(census.browse_response_bytes) : 0.0;
+        transfer_seconds = std::max(latency_seconds, volume_seconds);
+    }
+    const std::chrono::duration<double> encode_time = estimated_encode_time_per_node * estimate.number_of_exported_nodes;
+    estimate.runtime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(transfer_seconds) + encode_time);
+    return estimate;
+}
+
+void ReportEstimate(const SubtreeCensus& census, const ExportEstimate& estimate, LoggerBase& logger)
+{
+    logger.Info("Estimated number of nodes: {:.0f} ({} nodes browsed by {} requests).", census.number_of_nodes, census.number_of_browsed_nodes, census.number_of_browse_requests);
+    for (const auto& [node_class, number_of_nodes] : census.nodes_per_class)
+    {
+        const auto found = node_class_names.find(node_class);
+        logger.Info("  class {}: {:.0f}", found != node_class_names.end() ? found->second : "Unknown", number_of_nodes);
+    }
+    for (const auto& [namespace_index, number_of_nodes] : census.nodes_per_namespace)
+    {
+        logger.Info("  ns={}: {:.0f}", namespace_index, number_of_nodes);
+    }
+    logger.Info("Estimated export: {:.0f} nodes, {} nodes per request, {:.0f} requests.", estimate.number_of_exported_nodes, estimate.batch_size, estimate.number_of_requests);
+    logger.Info("Estimated size of responses: {:.1f} MB, of the output: {:.1f} MB.", estimate.response_bytes / (1024 * 1024), estimate.output_bytes / (1024 * 1024)); // NOLINT(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+    logger.Info("Estimated runtime: {} s.", std::chrono::duration_cast<std::chrono::seconds>(estimate.runtime).count());
+}
+
+} // namespace nodesetexporter::open62541::estimation
@@ -0,0 +1,322 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/LocalizedTexts.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <algorithm>
+#include <optional>
+#include <sys/types.h>
+#include <utility>
+
+namespace nodesetexporter::open62541::locales
+{
+
+using ::nodesetexporter::common::UaStringToStdString;
+
+namespace
+{
+/**
+ * @brief The reader of the text of the locale "mul": {"t":[["locale","text"],...]}. Only this form of JSON is accepted.
+ */
+class MultiLocaleTextReader
+{
+public:
+    explicit MultiLocaleTextReader(std::string_view text)
+        : m_text(text)
+    {
+    }
+
+    /**
+     * @return The pairs locale-text in the order of the text or std::nullopt if the text is not in the expected form.
+     */
+    [[nodiscard]] std::optional<std::vector<std::pair<std::string, std::string>>> Read()
+    {
+        std::vector<std::pair<std::string, std::string>> translations;
+        std::string key;
+        if (!Skip('{') || !ReadString(key) || key != "t" || !Skip(':') || !Skip('['))
+        {
+            return std::nullopt;
+        }
+        if (!Skip(']'))
+        {
+            do
+            {
+                std::pair<std::string, std::string> translation;
+                if (!Skip('[') || !ReadString(translation.first) || !Skip(',') || !ReadString(translation.second) || !Skip(']'))
+                {
+                    return std::nullopt;
+                }
+                translations.push_back(std::move(translation));
+            } while (Skip(','));
+            if (!Skip(']'))
+            {
+                return std::nullopt;
+            }
+        }
+        if (!Skip('}'))
+        {
+            return std::nullopt;
+        }
+        SkipSpaces();
+        if (m_position != m_text.size())
+        {
+            return std::nullopt;
+        }
+        return translations;
+    }
+
+private:
+    void SkipSpaces()
+    {
+        while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t' || m_text[m_position] == '\r' || m_text[m_position] == '\n'))
+        {
+            ++m_position;
+        }
+    }
+
+    /**
+     * @brief Skipping of the symbol if it is the next one.
+     */
+    bool Skip(char symbol)
+    {
+        SkipSpaces();
+        if (m_position < m_text.size() && m_text[m_position] == symbol)
+        {
+            ++m_position;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reading of the JSON string with the escape sequences, \\uXXXX is written in UTF-8.
+     */
+    bool ReadString(std::string& out)
+    {
+        if (!Skip('"'))
+        {
+            return false;
+        }
+        out.clear();
+        while (m_position < m_text.size())
+        {
+            const auto symbol = m_text[m_position++];
+            if (symbol == '"')
+            {
+                return true;
+            }
+            if (symbol != '\\')
+            {
+                out.push_back(symbol);
+                continue;
+            }
+            if (m_position >= m_text.size())
+            {
+                return false;
+            }
+            const auto escaped = m_text[m_position++];
+            switch (escaped)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(escaped);
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u':
+                if (!ReadCodePoint(out))
+                {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool ReadHex(u_int32_t& out)
+    {
+        constexpr size_t hex_digits = 4;
+        if (m_position + hex_digits > m_text.size())
+        {
+            return false;
+        }
+        out = 0;
+        for (size_t index = 0; index < hex_digits; ++index)
+        {
+            const auto symbol = m_text[m_position++];
+            out <<= 4U; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            if (symbol >= '0' && symbol <= '9')
+            {
+                out |= static_cast<u_int32_t>(symbol - '0');
+            }
+            else if (symbol >= 'a' && symbol <= 'f')
+            {
+                out |= static_cast<u_int32_t>(symbol - 'a' + 10); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+            else if (symbol >= 'A' && symbol <= 'F')
+            {
+                out |= static_cast<u_int32_t>(symbol - 'A' + 10); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    bool ReadCodePoint(std::string& out)
+    {
+        u_int32_t code_point = 0;
+        if (!ReadHex(code_point))
+        {
+            return false;
+        }
+        // The characters outside the Basic Multilingual Plane are written by the surrogate pair.
+        if (code_point >= 0xD800 && code_point <= 0xDBFF)
+        {
+            u_int32_t low_surrogate = 0;
+            if (m_text.substr(m_position, 2) != "\\u")
+            {
+                return false;
+            }
+            m_position += 2;
+            if (!ReadHex(low_surrogate) || low_surrogate < 0xDC00 || low_surrogate > 0xDFFF)
+            {
+                return false;
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10U) + (low_surrogate - 0xDC00);
+        }
+        if (code_point < 0x80)
+        {
+            out.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (code_point >> 6U)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3FU)));
+        }
+        else if (code_point < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (code_point >> 12U)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3FU)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (code_point >> 18U)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 12U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3FU)));
+        }
+        return true;
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    std::string_view m_text;
+    size_t m_position = 0;
+};
+
+UATypesContainer<UA_LocalizedText> MakeLocalizedText(const std::string& locale, const std::string& text)
+{
+    UATypesContainer<UA_LocalizedText> localized_text(UA_TYPES_LOCALIZEDTEXT);
+    localized_text.GetRef() = UA_LOCALIZEDTEXT_ALLOC(locale.c_str(), text.c_str());
+    return localized_text;
+}
+} // namespace
+
+StatusResults ApplySessionLocales(UA_ClientConfig& config, const std::vector<std::string>& locales)
+{
+    if (locales.empty())
+    {
+        return StatusResults::Good;
+    }
+    if (std::any_of(
+            locales.begin(),
+            locales.end(),
+            [](const auto& locale)
+            {
+                return locale.empty();
+            }))
+    {
+        return StatusResults::Fail;
+    }
+    auto* const locale_ids = static_cast<UA_LocaleId*>(UA_Array_new(locales.size() + 1, &UA_TYPES[UA_TYPES_LOCALEID]));
+    if (locale_ids == nullptr)
+    {
+        return StatusResults::Fail;
+    }
+    locale_ids[0] = UA_STRING_ALLOC(std::string(multi_locale_id).c_str()); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (size_t index = 0; index < locales.size(); ++index)
+    {
+        locale_ids[index + 1] = UA_STRING_ALLOC(locales[index].c_str()); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    UA_Array_delete(config.sessionLocaleIds, config.sessionLocaleIdsSize, &UA_TYPES[UA_TYPES_LOCALEID]);
+    config.sessionLocaleIds = locale_ids;
+    config.sessionLocaleIdsSize = locales.size() + 1;
+    return StatusResults::Good;
+}
+
+StatusResults SplitMultiLocaleText(const UA_LocalizedText& text, const std::vector<std::string>& locales, std::vector<UATypesContainer<UA_LocalizedText>>& out)
+{
+    out.clear();
+    if (UaStringToStdString(text.locale) != multi_locale_id)
+    {
+        out.emplace_back(text, UA_TYPES_LOCALIZEDTEXT);
+        return StatusResults::Good;
+    }
+    const auto json_text = UaStringToStdString(text.text);
+    auto translations = MultiLocaleTextReader(json_text).Read();
+    if (!translations.has_value())
+    {
+        return StatusResults::Fail;
+    }
+    for (const auto& locale : locales)
+    {
+        const auto translation = std::find_if(
+            translations->begin(),
+            translations->end(),
+            [&locale](const auto& item)
+            {
+                return item.first == locale;
+            });
+        if (translation != translations->end())
+        {
+            out.push_back(MakeLocalizedText(translation->first, translation->second));
+        }
+    }
+    if (out.empty())
+    {
+        for (const auto& [locale, translated_text] : *translations)
+        {
+            out.push_back(MakeLocalizedText(locale, translated_text));
+        }
+    }
+    return StatusResults::Good;
+}
+
+} // namespace nodesetexporter::open62541::locales
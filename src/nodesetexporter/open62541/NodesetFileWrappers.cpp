@@ -0,0 +1,974 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/NodesetFileWrappers.h"
+
+#include <open62541/nodeids.h>
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <unordered_set>
+
+namespace nodesetexporter::open62541
+{
+
+using tinyxml2::XMLDocument;
+using tinyxml2::XMLElement;
+
+namespace
+{
+
+#pragma region Parsing of the XML text
+
+/**
+ * @brief Name of the element without the namespace prefix, for example "uax:Double" -> "Double".
+ */
+std::string_view LocalName(const char* name)
+{
+    std::string_view local_name(name != nullptr ? name : "");
+    const auto prefix_end = local_name.find(':');
+    if (prefix_end != std::string_view::npos)
+    {
+        local_name.remove_prefix(prefix_end + 1);
+    }
+    return local_name;
+}
+
+const XMLElement* FirstChildByLocalName(const XMLElement& element, std::string_view name)
+{
+    for (const auto* child = element.FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+    {
+        if (LocalName(child->Name()) == name)
+        {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view Trim(std::string_view trimmed)
+{
+    const auto begin = trimmed.find_first_not_of(" \t\r\n");
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+    const auto end = trimmed.find_last_not_of(" \t\r\n");
+    return trimmed.substr(begin, end - begin + 1);
+}
+
+std::string_view Trim(const char* text)
+{
+    return Trim(std::string_view(text != nullptr ? text : ""));
+}
+
+std::optional<bool> ParseBoolean(std::string_view text)
+{
+    if (text == "true" || text == "1")
+    {
+        return true;
+    }
+    if (text == "false" || text == "0")
+    {
+        return false;
+    }
+    return std::nullopt;
+}
+
+template <typename TNumber>
+std::optional<TNumber> ParseNumber(std::string_view text)
+{
+    TNumber number{};
+    const auto* const end = text.data() + text.size(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const auto [ptr, error] = std::from_chars(text.data(), end, number);
+    if (error != std::errc() || ptr != end || text.empty())
+    {
+        return std::nullopt;
+    }
+    return number;
+}
+
+/**
+ * @brief Parsing of the ArrayDimensions attribute, for example "2,3".
+ */
+std::optional<std::vector<UA_UInt32>> ParseArrayDimensions(std::string_view text)
+{
+    std::vector<UA_UInt32> dimensions;
+    while (!text.empty())
+    {
+        const auto separator = text.find(',');
+        const auto dimension = ParseNumber<UA_UInt32>(Trim(text.substr(0, separator)));
+        if (!dimension.has_value())
+        {
+            return std::nullopt;
+        }
+        dimensions.push_back(dimension.value());
+        text.remove_prefix(separator == std::string_view::npos ? text.size() : separator + 1);
+    }
+    return dimensions;
+}
+
+/**
+ * @brief Parsing of the BrowseName, for example "1:vPLC1". Without the prefix, the name belongs to the namespace 0.
+ */
+UATypesContainer<UA_QualifiedName> ParseQualifiedName(std::string_view text)
+{
+    UA_UInt16 namespace_index = 0;
+    const auto separator = text.find(':');
+    if (separator != std::string_view::npos)
+    {
+        const auto index = ParseNumber<UA_UInt16>(text.substr(0, separator));
+        if (index.has_value())
+        {
+            namespace_index = index.value();
+            text.remove_prefix(separator + 1);
+        }
+    }
+    UATypesContainer<UA_QualifiedName> qualified_name(UA_TYPES_QUALIFIEDNAME);
+    qualified_name.GetRef() = UA_QUALIFIEDNAME_ALLOC(namespace_index, std::string(text).c_str());
+    return qualified_name;
+}
+
+/**
+ * @brief Parsing of the DisplayName, Description or InverseName element.
+ */
+UATypesContainer<UA_LocalizedText> ParseLocalizedText(const XMLElement& element)
+{
+    const auto* const locale = element.Attribute("Locale");
+    const auto* const text = element.GetText();
+    UATypesContainer<UA_LocalizedText> localized_text(UA_TYPES_LOCALIZEDTEXT);
+    localized_text.GetRef() = UA_LOCALIZEDTEXT_ALLOC(locale != nullptr ? locale : "", text != nullptr ? text : "");
+    return localized_text;
+}
+
+#pragma endregion Parsing of the XML text
+
+#pragma region Parsing of the values
+
+using ValueElementParser = bool (*)(const XMLElement& element, void* ua_value);
+
+bool ParseBooleanElement(const XMLElement& element, void* ua_value)
+{
+    const auto boolean = ParseBoolean(Trim(element.GetText()));
+    if (!boolean.has_value())
+    {
+        return false;
+    }
+    *static_cast<UA_Boolean*>(ua_value) = boolean.value();
+    return true;
+}
+
+template <typename TNumber>
+bool ParseNumberElement(const XMLElement& element, void* ua_value)
+{
+    const auto number = ParseNumber<TNumber>(Trim(element.GetText()));
+    if (!number.has_value())
+    {
+        return false;
+    }
+    *static_cast<TNumber*>(ua_value) = number.value();
+    return true;
+}
+
+bool ParseStringElement(const XMLElement& element, void* ua_value)
+{
+    const auto* const text = element.GetText();
+    *static_cast<UA_String*>(ua_value) = UA_String_fromChars(text != nullptr ? text : "");
+    return true;
+}
+
+bool ParseLocalizedTextElement(const XMLElement& element, void* ua_value)
+{
+    const auto* const locale = FirstChildByLocalName(element, "Locale");
+    const auto* const text = FirstChildByLocalName(element, "Text");
+    const auto* const locale_text = locale != nullptr ? locale->GetText() : nullptr;
+    const auto* const text_text = text != nullptr ? text->GetText() : nullptr;
+    *static_cast<UA_LocalizedText*>(ua_value) = UA_LOCALIZEDTEXT_ALLOC(locale_text != nullptr ? locale_text : "", text_text != nullptr ? text_text : "");
+    return true;
+}
+
+struct BuiltInValueType
+{
+    u_int32_t ua_type;
+    ValueElementParser parse;
+};
+
+const std::map<std::string_view, BuiltInValueType> built_in_value_types{
+    {"Boolean", {UA_TYPES_BOOLEAN, &ParseBooleanElement}},
+    {"SByte", {UA_TYPES_SBYTE, &ParseNumberElement<UA_SByte>}},
+    {"Byte", {UA_TYPES_BYTE, &ParseNumberElement<UA_Byte>}},
+    {"Int16", {UA_TYPES_INT16, &ParseNumberElement<UA_Int16>}},
+    {"UInt16", {UA_TYPES_UINT16, &ParseNumberElement<UA_UInt16>}},
+    {"Int32", {UA_TYPES_INT32, &ParseNumberElement<UA_Int32>}},
+    {"UInt32", {UA_TYPES_UINT32, &ParseNumberElement<UA_UInt32>}},
+    {"Int64", {UA_TYPES_INT64, &ParseNumberElement<UA_Int64>}},
+    {"UInt64", {UA_TYPES_UINT64, &ParseNumberElement<UA_UInt64>}},
+    {"Float", {UA_TYPES_FLOAT, &ParseNumberElement<UA_Float>}},
+    {"Double", {UA_TYPES_DOUBLE, &ParseNumberElement<UA_Double>}},
+    {"String", {UA_TYPES_STRING, &ParseStringElement}},
+    {"LocalizedText", {UA_TYPES_LOCALIZEDTEXT, &ParseLocalizedTextElement}}};
+
+/**
+ * @brief Parsing of the Value element of a variable or a variable type. Supports the scalars of the built-in types from built_in_value_types and their ListOf arrays.
+ * @return Value or nullopt if the type is not supported or the value is not parsed.
+ */
+std::optional<UATypesContainer<UA_Variant>> ParseValue(const XMLElement& xml_value)
+{
+    const auto* const content = xml_value.FirstChildElement();
+    if (content == nullptr)
+    {
+        return std::nullopt;
+    }
+    auto type_name = LocalName(content->Name());
+    const bool is_array = type_name.starts_with("ListOf");
+    if (is_array)
+    {
+        type_name.remove_prefix(std::string_view("ListOf").size());
+    }
+    const auto value_type = built_in_value_types.find(type_name);
+    if (value_type == built_in_value_types.end())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<const XMLElement*> elements;
+    if (is_array)
+    {
+        for (const auto* element = content->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+        {
+            if (LocalName(element->Name()) == type_name)
+            {
+                elements.push_back(element);
+            }
+        }
+    }
+    else
+    {
+        elements.push_back(content);
+    }
+
+    const auto* const data_type = &UA_TYPES[value_type->second.ua_type]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    auto* const data = UA_Array_new(elements.size(), data_type);
+    if (data == nullptr)
+    {
+        return std::nullopt;
+    }
+    for (size_t index = 0; index < elements.size(); index++)
+    {
+        if (!value_type->second.parse(*elements.at(index), static_cast<char*>(data) + index * data_type->memSize)) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        {
+            UA_Array_delete(data, elements.size(), data_type);
+            return std::nullopt;
+        }
+    }
+
+    UATypesContainer<UA_Variant> value(UA_TYPES_VARIANT);
+    if (is_array)
+    {
+        UA_Variant_setArray(&value.GetRef(), data, elements.size(), data_type); // The variant takes over the data
+    }
+    else
+    {
+        UA_Variant_setScalar(&value.GetRef(), data, data_type);
+    }
+    return value;
+}
+
+#pragma endregion Parsing of the values
+
+/**
+ * @brief Key of the reference for checking duplicates while synthesizing the inverse references.
+ *        Points to the NodeId objects of the index, which do not change their address when the containers are moved.
+ */
+struct ReferenceKey
+{
+    const UA_NodeId* reference_type_id;
+    const UA_NodeId* target_node_id;
+    bool is_forward;
+
+    bool operator==(const ReferenceKey& key) const
+    {
+        return is_forward == key.is_forward && UA_NodeId_equal(reference_type_id, key.reference_type_id) && UA_NodeId_equal(target_node_id, key.target_node_id);
+    }
+};
+
+struct ReferenceKeyHash
+{
+    std::size_t operator()(const ReferenceKey& key) const
+    {
+        return (UA_NodeId_hash(key.reference_type_id) * 31U + UA_NodeId_hash(key.target_node_id)) * 2U + static_cast<std::size_t>(key.is_forward);
+    }
+};
+
+const std::map<std::string_view, UA_NodeClass> node_class_elements{
+    {"UAObject", UA_NODECLASS_OBJECT},
+    {"UAVariable", UA_NODECLASS_VARIABLE},
+    {"UAMethod", UA_NODECLASS_METHOD},
+    {"UAView", UA_NODECLASS_VIEW},
+    {"UAObjectType", UA_NODECLASS_OBJECTTYPE},
+    {"UAVariableType", UA_NODECLASS_VARIABLETYPE},
+    {"UAReferenceType", UA_NODECLASS_REFERENCETYPE},
+    {"UADataType", UA_NODECLASS_DATATYPE}};
+
+// The hierarchical reference types of the OPC UA standard, the subtypes described in the file are added to them when loading.
+const std::vector<UA_UInt32> standard_hierarchical_reference_types{
+    UA_NS0ID_HIERARCHICALREFERENCES,
+    UA_NS0ID_HASCHILD,
+    UA_NS0ID_ORGANIZES,
+    UA_NS0ID_HASEVENTSOURCE,
+    UA_NS0ID_AGGREGATES,
+    UA_NS0ID_HASSUBTYPE,
+    UA_NS0ID_HASPROPERTY,
+    UA_NS0ID_HASCOMPONENT,
+    UA_NS0ID_HASNOTIFIER,
+    UA_NS0ID_HASORDEREDCOMPONENT,
+    UA_NS0ID_ALARMGROUPMEMBER,
+    UA_NS0ID_DATASETTOWRITER};
+
+constexpr auto opcua_namespace_uri = "http://opcfoundation.org/UA/";
+
+} // namespace
+
+#pragma region Loading
+
+StatusResults Open62541NodesetFileWrapper::LoadFromFile(const std::string& filename)
+{
+    m_logger.Trace("Method called: LoadFromFile()");
+    XMLDocument xml_document;
+    if (xml_document.LoadFile(filename.c_str()) != tinyxml2::XML_SUCCESS)
+    {
+        m_logger.Error("Nodeset file '{}' loading error: {}", filename, xml_document.ErrorStr());
+        Reset();
+        return StatusResults::Fail;
+    }
+    return Load(xml_document.RootElement());
+}
+
+StatusResults Open62541NodesetFileWrapper::LoadFromMemory(const std::string& xml)
+{
+    m_logger.Trace("Method called: LoadFromMemory()");
+    XMLDocument xml_document;
+    if (xml_document.Parse(xml.c_str(), xml.size()) != tinyxml2::XML_SUCCESS)
+    {
+        m_logger.Error("Nodeset document parsing error: {}", xml_document.ErrorStr());
+        Reset();
+        return StatusResults::Fail;
+    }
+    return Load(xml_document.RootElement());
+}
+
+void Open62541NodesetFileWrapper::Reset()
+{
+    m_namespace_array = {opcua_namespace_uri};
+    m_aliases.clear();
+    m_nodes.clear();
+    m_hierarchical_reference_types.clear();
+}
+
+StatusResults Open62541NodesetFileWrapper::Load(const XMLElement* const ua_nodeset)
+{
+    m_logger.Trace("Method called: Load()");
+    Reset();
+
+    if (ua_nodeset == nullptr || LocalName(ua_nodeset->Name()) != "UANodeSet")
+    {
+        m_logger.Error("The document is not a NodeSet, the UANodeSet root element is missing.");
+        return StatusResults::Fail;
+    }
+
+    if (const auto* const namespace_uris = FirstChildByLocalName(*ua_nodeset, "NamespaceUris"))
+    {
+        for (const auto* uri = namespace_uris->FirstChildElement(); uri != nullptr; uri = uri->NextSiblingElement())
+        {
+            m_namespace_array.emplace_back(Trim(uri->GetText()));
+        }
+    }
+
+    if (const auto* const aliases = FirstChildByLocalName(*ua_nodeset, "Aliases"))
+    {
+        for (const auto* alias = aliases->FirstChildElement(); alias != nullptr; alias = alias->NextSiblingElement())
+        {
+            const auto* const alias_name = alias->Attribute("Alias");
+            auto alias_node_id = ResolveNodeId(alias->GetText());
+            if (alias_name == nullptr || UA_NodeId_isNull(&alias_node_id.GetRef()))
+            {
+                m_logger.Warning("Invalid alias '{}' is skipped.", alias_name != nullptr ? alias_name : "");
+                continue;
+            }
+            m_aliases.insert_or_assign(alias_name, std::move(alias_node_id));
+        }
+    }
+
+    for (const auto* xml_node = ua_nodeset->FirstChildElement(); xml_node != nullptr; xml_node = xml_node->NextSiblingElement())
+    {
+        const auto node_class = node_class_elements.find(LocalName(xml_node->Name()));
+        if (node_class == node_class_elements.end())
+        {
+            continue; // NamespaceUris, Aliases, Models, Extensions, etc.
+        }
+        if (LoadNode(*xml_node, node_class->second) == StatusResults::Fail)
+        {
+            Reset();
+            return StatusResults::Fail;
+        }
+    }
+
+    SynthesizeInverseReferences();
+    CollectHierarchicalReferenceTypes();
+    m_logger.Info("The nodeset is loaded: {} nodes, {} namespaces.", m_nodes.size(), m_namespace_array.size());
+    return StatusResults::Good;
+}
+
+StatusResults Open62541NodesetFileWrapper::LoadNode(const XMLElement& xml_node, UA_NodeClass node_class)
+{
+    auto node_id = ResolveNodeId(xml_node.Attribute("NodeId"));
+    if (UA_NodeId_isNull(&node_id.GetRef()))
+    {
+        m_logger.Error("Invalid or missing NodeId '{}' of the {} element.", xml_node.Attribute("NodeId") != nullptr ? xml_node.Attribute("NodeId") : "", xml_node.Name());
+        return StatusResults::Fail;
+    }
+    const auto* const browse_name = xml_node.Attribute("BrowseName");
+    if (browse_name == nullptr)
+    {
+        m_logger.Error("The BrowseName of the node {} is missing.", node_id.ToString());
+        return StatusResults::Fail;
+    }
+    if (m_nodes.contains(node_id))
+    {
+        m_logger.Warning("The node {} is described more than once, only the first description is used.", node_id.ToString());
+        return StatusResults::Good;
+    }
+
+    NodeRecord record;
+    record.node_class = node_class;
+    auto& attrs = record.attrs;
+
+    // Attributes of the XML element with the default values of UANodeSet.xsd
+    const auto set_number = [&]<typename TNumber>(UA_AttributeId attr_id, const char* attr_name, TNumber default_value)
+    {
+        TNumber value = default_value;
+        if (const auto* const text = xml_node.Attribute(attr_name))
+        {
+            const auto number = ParseNumber<TNumber>(Trim(text));
+            if (number.has_value())
+            {
+                value = number.value();
+            }
+            else
+            {
+                m_logger.Warning("Invalid value '{}' of the {} attribute of the node {}, the default value is used.", text, attr_name, node_id.ToString());
+            }
+        }
+        attrs.insert_or_assign(attr_id, VariantsOfAttr(std::in_place_type<TNumber>, value));
+    };
+    const auto set_boolean = [&](UA_AttributeId attr_id, const char* attr_name, bool default_value)
+    {
+        UA_Boolean value = default_value;
+        if (const auto* const text = xml_node.Attribute(attr_name))
+        {
+            const auto boolean = ParseBoolean(Trim(text));
+            if (boolean.has_value())
+            {
+                value = boolean.value();
+            }
+            else
+            {
+                m_logger.Warning("Invalid value '{}' of the {} attribute of the node {}, the default value is used.", text, attr_name, node_id.ToString());
+            }
+        }
+        attrs.insert_or_assign(attr_id, VariantsOfAttr(std::in_place_type<UA_Boolean>, value));
+    };
+    const auto set_variable_attrs = [&]
+    {
+        auto data_type = UATypesContainer<UA_NodeId>(UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATATYPE), UA_TYPES_NODEID);
+        if (const auto* const text = xml_node.Attribute("DataType"))
+        {
+            auto resolved_data_type = ResolveNodeId(text);
+            if (!UA_NodeId_isNull(&resolved_data_type.GetRef()))
+            {
+                data_type = std::move(resolved_data_type);
+            }
+            else
+            {
+                m_logger.Warning("Invalid DataType '{}' of the node {}, BaseDataType is used.", text, node_id.ToString());
+            }
+        }
+        attrs.insert_or_assign(UA_ATTRIBUTEID_DATATYPE, VariantsOfAttr(std::move(data_type)));
+        set_number(UA_ATTRIBUTEID_VALUERANK, "ValueRank", UA_Int32{UA_VALUERANK_SCALAR});
+
+        std::vector<UA_UInt32> array_dimensions;
+        if (const auto* const text = xml_node.Attribute("ArrayDimensions"))
+        {
+            auto dimensions = ParseArrayDimensions(Trim(text));
+            if (dimensions.has_value())
+            {
+                array_dimensions = std::move(dimensions.value());
+            }
+            else
+            {
+                m_logger.Warning("Invalid ArrayDimensions '{}' of the node {}, the attribute is ignored.", text, node_id.ToString());
+            }
+        }
+        attrs.insert_or_assign(UA_ATTRIBUTEID_ARRAYDIMENSIONS, VariantsOfAttr(std::move(array_dimensions)));
+
+        if (const auto* const xml_value = FirstChildByLocalName(xml_node, "Value"))
+        {
+            auto value = ParseValue(*xml_value);
+            if (value.has_value())
+            {
+                attrs.insert_or_assign(UA_ATTRIBUTEID_VALUE, VariantsOfAttr(std::move(value.value())));
+            }
+            else
+            {
+                m_logger.Debug("The value of the node {} has an unsupported type and is skipped.", node_id.ToString());
+            }
+        }
+    };
+
+    // UANode
+    attrs.insert_or_assign(UA_ATTRIBUTEID_NODECLASS, VariantsOfAttr(std::in_place_type<UA_NodeClass>, node_class));
+    auto qualified_name = ParseQualifiedName(Trim(browse_name));
+    const auto* const xml_display_name = FirstChildByLocalName(xml_node, "DisplayName");
+    if (xml_display_name != nullptr)
+    {
+        attrs.insert_or_assign(UA_ATTRIBUTEID_DISPLAYNAME, VariantsOfAttr(ParseLocalizedText(*xml_display_name)));
+    }
+    else
+    {
+        // According to the standard, the DisplayName defaults to the name part of the BrowseName.
+        UATypesContainer<UA_LocalizedText> display_name(UA_TYPES_LOCALIZEDTEXT);
+        display_name.GetRef().locale = UA_STRING_NULL;
+        UA_String_copy(&qualified_name.GetRef().name, &display_name.GetRef().text);
+        attrs.insert_or_assign(UA_ATTRIBUTEID_DISPLAYNAME, VariantsOfAttr(std::move(display_name)));
+    }
+    attrs.insert_or_assign(UA_ATTRIBUTEID_BROWSENAME, VariantsOfAttr(std::move(qualified_name)));
+    const auto* const xml_description = FirstChildByLocalName(xml_node, "Description");
+    attrs.insert_or_assign(
+        UA_ATTRIBUTEID_DESCRIPTION,
+        VariantsOfAttr(xml_description != nullptr ? ParseLocalizedText(*xml_description) : UATypesContainer<UA_LocalizedText>(UA_TYPES_LOCALIZEDTEXT)));
+    set_number(UA_ATTRIBUTEID_WRITEMASK, "WriteMask", UA_UInt32{0});
+    set_number(UA_ATTRIBUTEID_USERWRITEMASK, "UserWriteMask", UA_UInt32{0});
+
+    switch (node_class)
+    {
+    case UA_NODECLASS_OBJECT:
+        set_number(UA_ATTRIBUTEID_EVENTNOTIFIER, "EventNotifier", UA_Byte{0});
+        break;
+    case UA_NODECLASS_VARIABLE:
+        set_variable_attrs();
+        set_number(UA_ATTRIBUTEID_ACCESSLEVEL, "AccessLevel", UA_Byte{UA_ACCESSLEVELMASK_READ});
+        set_number(UA_ATTRIBUTEID_USERACCESSLEVEL, "UserAccessLevel", UA_Byte{UA_ACCESSLEVELMASK_READ});
+        set_number(UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL, "MinimumSamplingInterval", UA_Double{0});
+        set_boolean(UA_ATTRIBUTEID_HISTORIZING, "Historizing", false);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        set_boolean(UA_ATTRIBUTEID_ISABSTRACT, "IsAbstract", false);
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        set_variable_attrs();
+        set_boolean(UA_ATTRIBUTEID_ISABSTRACT, "IsAbstract", false);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        set_boolean(UA_ATTRIBUTEID_ISABSTRACT, "IsAbstract", false);
+        set_boolean(UA_ATTRIBUTEID_SYMMETRIC, "Symmetric", false);
+        if (const auto* const xml_inverse_name = FirstChildByLocalName(xml_node, "InverseName"))
+        {
+            attrs.insert_or_assign(UA_ATTRIBUTEID_INVERSENAME, VariantsOfAttr(ParseLocalizedText(*xml_inverse_name)));
+        }
+        break;
+    case UA_NODECLASS_DATATYPE:
+        set_boolean(UA_ATTRIBUTEID_ISABSTRACT, "IsAbstract", false);
+        break;
+    case UA_NODECLASS_METHOD:
+        set_boolean(UA_ATTRIBUTEID_EXECUTABLE, "Executable", true);
+        set_boolean(UA_ATTRIBUTEID_USEREXECUTABLE, "UserExecutable", true);
+        break;
+    case UA_NODECLASS_VIEW:
+        set_boolean(UA_ATTRIBUTEID_CONTAINSNOLOOPS, "ContainsNoLoops", false);
+        set_number(UA_ATTRIBUTEID_EVENTNOTIFIER, "EventNotifier", UA_Byte{0});
+        break;
+    default:
+        break;
+    }
+
+    // References
+    if (const auto* const xml_references = FirstChildByLocalName(xml_node, "References"))
+    {
+        for (const auto* xml_reference = xml_references->FirstChildElement(); xml_reference != nullptr; xml_reference = xml_reference->NextSiblingElement())
+        {
+            auto reference_type_id = ResolveNodeId(xml_reference->Attribute("ReferenceType"));
+            auto target_node_id = ResolveNodeId(xml_reference->GetText());
+            const auto is_forward = ParseBoolean(Trim(xml_reference->Attribute("IsForward") != nullptr ? xml_reference->Attribute("IsForward") : "true"));
+            if (UA_NodeId_isNull(&reference_type_id.GetRef()) || UA_NodeId_isNull(&target_node_id.GetRef()) || !is_forward.has_value())
+            {
+                m_logger.Warning("Invalid reference of the node {} is skipped.", node_id.ToString());
+                continue;
+            }
+            record.references.push_back({std::move(reference_type_id), std::move(target_node_id), is_forward.value()});
+        }
+    }
+
+    m_nodes.emplace(std::move(node_id), std::move(record));
+    return StatusResults::Good;
+}
+
+void Open62541NodesetFileWrapper::SynthesizeInverseReferences()
+{
+    m_logger.Trace("Method called: SynthesizeInverseReferences()");
+    // The keys of the references of each node, the duplicates declared in the file are removed.
+    std::unordered_map<const NodeRecord*, std::unordered_set<ReferenceKey, ReferenceKeyHash>> node_reference_keys;
+    node_reference_keys.reserve(m_nodes.size());
+    for (auto& [node_id, record] : m_nodes)
+    {
+        auto& keys = node_reference_keys[&record];
+        std::vector<NodeReference> unique_references;
+        unique_references.reserve(record.references.size());
+        for (auto& reference : record.references)
+        {
+            if (keys.insert({&reference.reference_type_id.GetRef(), &reference.target_node_id.GetRef(), reference.is_forward}).second)
+            {
+                unique_references.push_back(std::move(reference));
+            }
+        }
+        record.references.swap(unique_references);
+    }
+
+    size_t synthesized = 0;
+    for (auto& [node_id, record] : m_nodes)
+    {
+        // Only the references declared in the file are processed, the inverse ones added to this node earlier already have a pair.
+        for (size_t index = 0; index < record.references.size(); index++)
+        {
+            const auto& reference = record.references.at(index);
+            auto target = m_nodes.find(reference.target_node_id);
+            if (target == m_nodes.end())
+            {
+                continue;
+            }
+            auto& target_keys = node_reference_keys.at(&target->second);
+            if (target_keys.contains({&reference.reference_type_id.GetRef(), &node_id.GetRef(), !reference.is_forward}))
+            {
+                continue;
+            }
+            auto& target_references = target->second.references;
+            target_references.push_back({reference.reference_type_id, node_id, !reference.is_forward}); // Can invalidate "reference" if the node refers to itself
+            const auto& inverse_reference = target_references.back();
+            target_keys.insert({&inverse_reference.reference_type_id.GetRef(), &inverse_reference.target_node_id.GetRef(), inverse_reference.is_forward});
+            synthesized++;
+        }
+    }
+    m_logger.Debug("{} inverse references were synthesized.", synthesized);
+}
+
+void Open62541NodesetFileWrapper::CollectHierarchicalReferenceTypes()
+{
+    m_logger.Trace("Method called: CollectHierarchicalReferenceTypes()");
+    for (const auto reference_type : standard_hierarchical_reference_types)
+    {
+        m_hierarchical_reference_types.emplace(UA_NODEID_NUMERIC(0, reference_type), UA_TYPES_NODEID);
+    }
+    const UA_NodeId has_subtype = UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE);
+    // Subtypes can be described in the file in any order, so the pass is repeated until new ones stop appearing.
+    bool is_added = true;
+    while (is_added)
+    {
+        is_added = false;
+        for (const auto& [node_id, record] : m_nodes)
+        {
+            if (record.node_class != UA_NODECLASS_REFERENCETYPE || m_hierarchical_reference_types.contains(node_id))
+            {
+                continue;
+            }
+            for (const auto& reference : record.references)
+            {
+                if (!reference.is_forward && UA_NodeId_equal(&reference.reference_type_id.GetRef(), &has_subtype) && m_hierarchical_reference_types.contains(reference.target_node_id))
+                {
+                    m_hierarchical_reference_types.insert(node_id);
+                    is_added = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+UATypesContainer<UA_NodeId> Open62541NodesetFileWrapper::ResolveNodeId(const char* const text) const
+{
+    UATypesContainer<UA_NodeId> node_id(UA_TYPES_NODEID);
+    const auto trimmed = Trim(text);
+    if (trimmed.empty())
+    {
+        return node_id;
+    }
+    const auto alias = m_aliases.find(std::string(trimmed));
+    if (alias != m_aliases.end())
+    {
+        return alias->second;
+    }
+    const UA_String ua_text{trimmed.size(), reinterpret_cast<UA_Byte*>(const_cast<char*>(trimmed.data()))}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-type-const-cast)
+    if (UA_NodeId_parse(&node_id.GetRef(), ua_text) != UA_STATUSCODE_GOOD)
+    {
+        UA_NodeId_clear(&node_id.GetRef());
+    }
+    return node_id;
+}
+
+#pragma endregion Loading
+
+StatusResults Open62541NodesetFileWrapper::GrabChildNodeIdsFromStartNodeId(
+    const UATypesContainer<UA_ExpandedNodeId>& start_node_id,
+    std::vector<UATypesContainer<UA_ExpandedNodeId>>& out,
+    discovery::DiscoveryFilter* const filter) const
+{
+    m_logger.Trace("Method called: GrabChildNodeIdsFromStartNodeId()");
+    const UATypesContainer<UA_NodeId> start(start_node_id.GetRef().nodeId, UA_TYPES_NODEID);
+    if (!m_nodes.contains(start))
+    {
+        m_logger.Error("The start node {} is missing in the nodeset.", start_node_id.ToString());
+        return StatusResults::Fail;
+    }
+    std::unordered_set<UATypesContainer<UA_NodeId>> visited{start};
+    const auto first_index = out.size();
+    out.push_back(start_node_id);
+    // The end of the current level of the hierarchy in the list and its depth, for the rules.
+    auto level_end = out.size();
+    size_t depth = 1;
+    for (size_t index = first_index; index < out.size(); index++)
+    {
+        if (index == level_end)
+        {
+            level_end = out.size();
+            ++depth;
+        }
+        const auto& record = m_nodes.at(UATypesContainer<UA_NodeId>(out.at(index).GetRef().nodeId, UA_TYPES_NODEID));
+        for (const auto& reference : record.references)
+        {
+            if (!reference.is_forward || !m_hierarchical_reference_types.contains(reference.reference_type_id))
+            {
+                continue;
+            }
+            const auto target = m_nodes.find(reference.target_node_id);
+            if (target == m_nodes.end() || visited.contains(reference.target_node_id))
+            {
+                continue;
+            }
+            if (filter != nullptr && !IsAcceptedByFilter(*filter, reference, target->second, depth))
+            {
+                continue;
+            }
+            visited.insert(reference.target_node_id);
+            UATypesContainer<UA_ExpandedNodeId> child_node_id(UA_TYPES_EXPANDEDNODEID);
+            UA_NodeId_copy(&reference.target_node_id.GetRef(), &child_node_id.GetRef().nodeId);
+            out.push_back(std::move(child_node_id));
+        }
+    }
+    return StatusResults::Good;
+}
+
+bool Open62541NodesetFileWrapper::IsAcceptedByFilter(discovery::DiscoveryFilter& filter, const NodeReference& reference, const NodeRecord& target, size_t depth)
+{
+    static const UA_QualifiedName empty_browse_name{};
+    const auto browse_name_attr = target.attrs.find(UA_ATTRIBUTEID_BROWSENAME);
+    const auto* const browse_name = browse_name_attr != target.attrs.end() ? std::get_if<UATypesContainer<UA_QualifiedName>>(&browse_name_attr->second) : nullptr;
+    return filter.Accept(
+        {reference.target_node_id.GetRef(), browse_name != nullptr ? browse_name->GetRef() : empty_browse_name, target.node_class, reference.reference_type_id.GetRef(), depth});
+}
+
+UATypesContainer<UA_ReferenceDescription> Open62541NodesetFileWrapper::MakeReferenceDescription(const NodeReference& reference) const
+{
+    UATypesContainer<UA_ReferenceDescription> description(UA_TYPES_REFERENCEDESCRIPTION);
+    auto& ref_desc = description.GetRef();
+    UA_NodeId_copy(&reference.reference_type_id.GetRef(), &ref_desc.referenceTypeId);
+    ref_desc.isForward = reference.is_forward;
+    UA_NodeId_copy(&reference.target_node_id.GetRef(), &ref_desc.nodeId.nodeId);
+
+    const auto target = m_nodes.find(reference.target_node_id);
+    if (target == m_nodes.end())
+    {
+        return description; // Only the NodeId is known about the target node outside the file.
+    }
+    ref_desc.nodeClass = target->second.node_class;
+    if (const auto* const browse_name = std::get_if<UATypesContainer<UA_QualifiedName>>(&target->second.attrs.at(UA_ATTRIBUTEID_BROWSENAME)))
+    {
+        UA_QualifiedName_copy(&browse_name->GetRef(), &ref_desc.browseName);
+    }
+    if (const auto* const display_name = std::get_if<UATypesContainer<UA_LocalizedText>>(&target->second.attrs.at(UA_ATTRIBUTEID_DISPLAYNAME)))
+    {
+        UA_LocalizedText_copy(&display_name->GetRef(), &ref_desc.displayName);
+    }
+    const UA_NodeId has_type_definition = UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION);
+    for (const auto& target_reference : target->second.references)
+    {
+        if (target_reference.is_forward && UA_NodeId_equal(&target_reference.reference_type_id.GetRef(), &has_type_definition))
+        {
+            UA_NodeId_copy(&target_reference.target_node_id.GetRef(), &ref_desc.typeDefinition.nodeId);
+            break;
+        }
+    }
+    return description;
+}
+
+StatusResults Open62541NodesetFileWrapper::ReadNodeClasses(std::vector<NodeClassesRequestResponse>& node_class_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeClasses()");
+    for (auto& node_class_structure : node_class_structure_lists)
+    {
+        const auto node = m_nodes.find(UATypesContainer<UA_NodeId>(node_class_structure.exp_node_id.GetRef().nodeId, UA_TYPES_NODEID));
+        if (node != m_nodes.end())
+        {
+            node_class_structure.node_class = node->second.node_class;
+        }
+        else
+        {
+            node_class_structure.node_class = UA_NodeClass::UA_NODECLASS_UNSPECIFIED;
+            node_class_structure.result_code = UA_STATUSCODE_BADNODEIDUNKNOWN;
+            m_logger.Warning(
+                "ReadNodeClasses has bad status '{}' of node {} in response",
+                UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN),
+                node_class_structure.exp_node_id.ToString());
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Open62541NodesetFileWrapper::ReadNodeReferences(std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodeReferences()");
+    for (auto& node_references_structure : node_references_structure_lists)
+    {
+        const auto node = m_nodes.find(UATypesContainer<UA_NodeId>(node_references_structure.exp_node_id.GetRef().nodeId, UA_TYPES_NODEID));
+        if (node == m_nodes.end())
+        {
+            m_logger.Warning(
+                "ReadNodeReferences has bad status '{}' of node {} in response.",
+                UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN),
+                node_references_structure.exp_node_id.ToString());
+            continue;
+        }
+        node_references_structure.references.reserve(node_references_structure.references.size() + node->second.references.size());
+        for (const auto& reference : node->second.references)
+        {
+            node_references_structure.references.push_back(MakeReferenceDescription(reference));
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Open62541NodesetFileWrapper::ReadNodesAttributes(std::vector<NodeAttributesRequestResponse>& node_attr_structure_lists)
+{
+    m_logger.Trace("Method called: ReadNodesAttributes()");
+    for (auto& node_attr_structure : node_attr_structure_lists)
+    {
+        const auto node = m_nodes.find(UATypesContainer<UA_NodeId>(node_attr_structure.exp_node_id.GetRef().nodeId, UA_TYPES_NODEID));
+        if (node == m_nodes.end())
+        {
+            m_logger.Warning(
+                "ReadNodesAttributes has bad status '{}' of node {} in response",
+                UA_StatusCode_name(UA_STATUSCODE_BADNODEIDUNKNOWN),
+                node_attr_structure.exp_node_id.ToString());
+            for (auto& attr : node_attr_structure.attrs)
+            {
+                attr.second = std::nullopt;
+            }
+            continue;
+        }
+        for (auto& attr : node_attr_structure.attrs)
+        {
+            const auto value = node->second.attrs.find(attr.first);
+            if (value != node->second.attrs.end())
+            {
+                attr.second = value->second;
+            }
+            else
+            {
+                attr.second = std::nullopt;
+                m_logger.Debug("ReadNodesAttributes (atrID={}) has no value of node {} in the nodeset", static_cast<int>(attr.first), node_attr_structure.exp_node_id.ToString());
+            }
+        }
+    }
+    return StatusResults::Good;
+}
+
+StatusResults Open62541NodesetFileWrapper::ReadNodeDataValue(const UATypesContainer<UA_ExpandedNodeId>& node_id, UATypesContainer<UA_Variant>& data_value)
+{
+    m_logger.Trace("Method called: ReadNodeDataValue()");
+    UA_Variant_clear(&data_value.GetRef());
+    const UA_NodeId namespace_array_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY);
+    if (UA_NodeId_equal(&node_id.GetRef().nodeId, &namespace_array_node_id))
+    {
+        std::vector<UA_String> namespaces;
+        namespaces.reserve(m_namespace_array.size());
+        for (const auto& namespace_uri : m_namespace_array)
+        {
+            namespaces.push_back({namespace_uri.size(), reinterpret_cast<UA_Byte*>(const_cast<char*>(namespace_uri.data()))}); // NOLINT
+        }
+        if (UA_Variant_setArrayCopy(&data_value.GetRef(), namespaces.data(), namespaces.size(), &UA_TYPES[UA_TYPES_STRING]) != UA_STATUSCODE_GOOD)
+        {
+            m_logger.Error("ReadNodeDataValue: the namespace array cannot be copied.");
+            return StatusResults::Fail;
+        }
+        return StatusResults::Good;
+    }
+
+    const auto node = m_nodes.find(UATypesContainer<UA_NodeId>(node_id.GetRef().nodeId, UA_TYPES_NODEID));
+    if (node != m_nodes.end())
+    {
+        const auto value = node->second.attrs.find(UA_ATTRIBUTEID_VALUE);
+        if (value != node->second.attrs.end())
+        {
+            if (const auto* const variant = std::get_if<UATypesContainer<UA_Variant>>(&value->second))
+            {
+                UA_Variant_copy(&variant->GetRef(), &data_value.GetRef());
+                return StatusResults::Good;
+            }
+        }
+    }
+    m_logger.Error("ReadNodeDataValue: the node {} is missing in the nodeset or has no value.", node_id.ToString());
+    return StatusResults::Fail;
+}
+
+StatusResults Open62541NodesetFileWrapper::ReadNodeDataValueRange(
+    const UATypesContainer<UA_ExpandedNodeId>& node_id,
+    size_t first_index,
+    size_t number_of_elements,
+    UATypesContainer<UA_Variant>& data_value)
+{
+    m_logger.Trace("Method called: ReadNodeDataValueRange()");
+    UA_Variant_clear(&data_value.GetRef());
+    const auto node = m_nodes.find(UATypesContainer<UA_NodeId>(node_id.GetRef().nodeId, UA_TYPES_NODEID));
+    if (node == m_nodes.end() || number_of_elements == 0)
+    {
+        m_logger.Error("ReadNodeDataValueRange: the node {} is missing in the nodeset or the number of elements is zero.", node_id.ToString());
+        return StatusResults::Fail;
+    }
+    const auto value = node->second.attrs.find(UA_ATTRIBUTEID_VALUE);
+    const auto* const variant = value != node->second.attrs.end() ? std::get_if<UATypesContainer<UA_Variant>>(&value->second) : nullptr;
+    if (variant == nullptr || UA_Variant_isEmpty(&variant->GetRef()) || UA_Variant_isScalar(&variant->GetRef()))
+    {
+        m_logger.Warning("ReadNodeDataValueRange: the node {} has no array value.", node_id.ToString());
+        return StatusResults::Fail;
+    }
+
+    const auto& array = variant->GetRef();
+    if (first_index >= array.arrayLength)
+    {
+        return StatusResults::Good; // The array ends before first_index.
+    }
+    const auto number_of_copied = std::min(number_of_elements, array.arrayLength - first_index);
+    const auto* const first_element = static_cast<const char*>(array.data) + first_index * array.type->memSize; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (UA_Variant_setArrayCopy(&data_value.GetRef(), first_element, number_of_copied, array.type) != UA_STATUSCODE_GOOD)
+    {
+        m_logger.Error("ReadNodeDataValueRange: the part of the value of the node {} cannot be copied.", node_id.ToString());
+        return StatusResults::Fail;
+    }
+    return StatusResults::Good;
+}
+
+} // namespace nodesetexporter::open62541
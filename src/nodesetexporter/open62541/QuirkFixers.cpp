@@ -0,0 +1,138 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/QuirkFixers.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace nodesetexporter::open62541::quirks
+{
+
+using ::nodesetexporter::common::UaStringToStdString;
+
+namespace
+{
+const UA_NodeId ns0id_hastypedefinition_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION);
+const UA_NodeId ns0id_basevariabletype_node_id = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEVARIABLETYPE);
+
+/**
+ * @brief Case-insensitive search of the ASCII substring.
+ */
+bool ContainsNoCase(std::string_view text, std::string_view substring)
+{
+    return std::search(
+               text.begin(),
+               text.end(),
+               substring.begin(),
+               substring.end(),
+               [](char left, char right)
+               {
+                   return std::tolower(static_cast<unsigned char>(left)) == std::tolower(static_cast<unsigned char>(right));
+               })
+           != text.end();
+}
+} // namespace
+
+StatusResults KepServerQuirkFixer::FixReferences(std::vector<IOpen62541::NodeReferencesRequestResponse>& node_references_req_res)
+{
+    m_logger.Trace("Method called: FixReferences()");
+
+    // Checking for the presence of back references and generating them from text identifiers, as well as replacing the type HasTypeDefinition = BaseVariableType(62).
+    // We need to know in principle that there are no back references, even if we can't add them.
+    for (auto& node_ref : node_references_req_res) // Node
+    {
+        // If the node does not have a list of links, we miss the processing of such a node
+        if (node_ref.references.empty())
+        {
+            continue;
+        }
+
+        bool are_we_have_inverse_ref = false;
+        for (auto& ref : node_ref.references) // References
+        {
+            // The type definition is checked in all references, the search is not stopped on the first inverse reference.
+            if (UA_NodeId_equal(&ref.GetRef().referenceTypeId, &ns0id_hastypedefinition_node_id) && UA_NodeId_equal(&ref.GetRef().nodeId.nodeId, &ns0id_basevariabletype_node_id))
+            {
+                m_logger.Warning("For node {} we find reference with HasTypeDefinition = BaseVariableType(62). Change to BaseDataVariableType(63).", node_ref.exp_node_id.ToString());
+                ref.GetRef().nodeId.nodeId.identifier.numeric = UA_NS0ID_BASEDATAVARIABLETYPE; // NOLINT(cppcoreguidelines-pro-type-union-access)
+            }
+            are_we_have_inverse_ref = are_we_have_inverse_ref || !ref.GetRef().isForward;
+        }
+
+        if (are_we_have_inverse_ref)
+        {
+            continue;
+        }
+
+        m_logger.Warning("For node {} we didn't find a inverse reference. Let's just add one.", node_ref.exp_node_id.ToString());
+        if (node_ref.exp_node_id.GetRef().nodeId.identifierType != UA_NodeIdType::UA_NODEIDTYPE_STRING)
+        {
+            m_logger.Error("Node {} didn't have a string ID, so we can't build a inverse reference.", node_ref.exp_node_id.ToString());
+            return StatusResults::Fail;
+        }
+        auto new_ref = MakeParentReference(node_ref.exp_node_id.GetRef());
+        m_logger.Debug("For node {} adding reference:\n {}", node_ref.exp_node_id.ToString(), new_ref.ToString());
+        node_ref.references.push_back(std::move(new_ref));
+    }
+    return StatusResults::Good;
+}
+
+UATypesContainer<UA_ReferenceDescription> KepServerQuirkFixer::MakeParentReference(const UA_ExpandedNodeId& exp_node_id)
+{
+    UATypesContainer<UA_ReferenceDescription> new_ref(UA_TYPES_REFERENCEDESCRIPTION);
+    new_ref.GetRef().referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+    new_ref.GetRef().isForward = false;
+
+    const auto& identifier = exp_node_id.nodeId.identifier.string; // NOLINT(cppcoreguidelines-pro-type-union-access)
+    const std::string_view child_id(reinterpret_cast<const char*>(identifier.data), identifier.length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto found_child_dot_index = child_id.find_last_of('.');
+    // All nodes for which the parent cannot be determined further, I substitute the most basic node of the object.
+    if (found_child_dot_index == std::string_view::npos)
+    {
+        new_ref.GetRef().nodeId = UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+        return new_ref;
+    }
+    // The parent keeps the namespace of the child, only the identifier after the last separator dot (including the dot itself) is removed.
+    auto& parent_node_id = new_ref.GetRef().nodeId;
+    parent_node_id.nodeId.namespaceIndex = exp_node_id.nodeId.namespaceIndex;
+    parent_node_id.nodeId.identifierType = UA_NODEIDTYPE_STRING;
+    parent_node_id.serverIndex = exp_node_id.serverIndex;
+    UA_String_copy(&exp_node_id.namespaceUri, &parent_node_id.namespaceUri);
+    const UA_String parent_id{found_child_dot_index, identifier.data};
+    UA_String_copy(&parent_id, &parent_node_id.nodeId.identifier.string); // NOLINT(cppcoreguidelines-pro-type-union-access)
+    return new_ref;
+}
+
+std::unique_ptr<IQuirkFixer> MakeQuirkFixer(std::string_view name, LoggerBase& logger)
+{
+    if (name == kepserver_quirk_fixer_name)
+    {
+        return std::make_unique<KepServerQuirkFixer>(logger);
+    }
+    return nullptr;
+}
+
+std::vector<std::string> DetectQuirkFixers(const UA_BuildInfo& build_info)
+{
+    std::vector<std::string> names;
+    // KEPServerEX, ThingWorx Kepware Server and the OEM versions keep the name of the manufacturer or of the product in one of the fields.
+    for (const auto* const field : {&build_info.productName, &build_info.manufacturerName, &build_info.productUri})
+    {
+        const auto text = UaStringToStdString(*field);
+        if (ContainsNoCase(text, "kepware") || ContainsNoCase(text, "kepserver"))
+        {
+            names.emplace_back(kepserver_quirk_fixer_name);
+            break;
+        }
+    }
+    return names;
+}
+
+} // namespace nodesetexporter::open62541::quirks
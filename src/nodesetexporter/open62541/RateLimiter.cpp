@@ -0,0 +1,139 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/RateLimiter.h"
+
+#include <algorithm>
+#include <bit>
+#include <tuple>
+
+namespace nodesetexporter::open62541::ratelimit
+{
+
+namespace
+{
+
+// The smoothing of the latency of the responses.
+constexpr double latency_smoothing = 0.2;
+
+Clock::duration ToDuration(double seconds)
+{
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+} // namespace
+
+TokenBucket::TokenBucket(double rate, Clock::time_point now)
+    : m_rate(std::max(0.0, rate)),
+      m_capacity(std::max(1.0, rate)),
+      m_tokens(m_capacity),
+      m_last_refill(now)
+{
+}
+
+void TokenBucket::Refill(double rate_factor, Clock::time_point now)
+{
+    if (now > m_last_refill)
+    {
+        const auto elapsed = std::chrono::duration<double>(now - m_last_refill).count();
+        m_tokens = std::min(m_capacity, m_tokens + elapsed * m_rate * rate_factor);
+        m_last_refill = now;
+    }
+}
+
+Clock::duration TokenBucket::Take(double tokens, double rate_factor, Clock::time_point now)
+{
+    if (!IsEnabled())
+    {
+        return Clock::duration::zero();
+    }
+    Refill(rate_factor, now);
+    // The tokens are taken at once, the negative balance is the debt that is paid by the waiting.
+    m_tokens -= tokens;
+    if (m_tokens >= 0)
+    {
+        return Clock::duration::zero();
+    }
+    return ToDuration(-m_tokens / (m_rate * rate_factor));
+}
+
+RateLimiter::RateLimiter(const RateLimits& limits, Clock::time_point now)
+    : m_requests(limits.requests_per_second, now),
+      m_operations(limits.operations_per_second, now),
+      m_bytes(limits.bytes_per_second, now),
+      m_is_adaptive(limits.is_adaptive),
+      m_last_decrease(now - throttle_decrease_interval),
+      m_last_increase(now)
+{
+}
+
+Clock::duration RateLimiter::Acquire(size_t number_of_operations, Clock::time_point now)
+{
+    auto delay = m_requests.Take(1, m_throttle_factor, now);
+    delay = std::max(delay, m_operations.Take(static_cast<double>(number_of_operations), m_throttle_factor, now));
+    // The bytes are taken by the responses, the request waits for the debt only.
+    delay = std::max(delay, m_bytes.Take(0, m_throttle_factor, now));
+    if (m_is_adaptive && m_pause_until > now)
+    {
+        delay = std::max(delay, m_pause_until - now);
+    }
+    return delay;
+}
+
+void RateLimiter::OnResponse(Service service, size_t number_of_operations, Clock::duration latency, size_t response_bytes, Clock::time_point now)
+{
+    std::ignore = m_bytes.Take(static_cast<double>(response_bytes), m_throttle_factor, now);
+    if (!m_is_adaptive)
+    {
+        return;
+    }
+    // The single value and the batch of the hundreds of the attributes are compared each with the latency of its own kind of the requests.
+    auto& baseline = m_latency_baselines[{service, std::bit_width(number_of_operations)}];
+    const auto latency_seconds = std::chrono::duration<double>(latency).count();
+    baseline.latency_seconds = baseline.latency_seconds == 0 ? latency_seconds : baseline.latency_seconds + latency_smoothing * (latency_seconds - baseline.latency_seconds);
+    baseline.min_latency_seconds = baseline.min_latency_seconds == 0 ? baseline.latency_seconds : std::min(baseline.min_latency_seconds, baseline.latency_seconds);
+    const auto latency_margin = std::chrono::duration<double>(saturation_latency_margin).count();
+    if (baseline.latency_seconds > baseline.min_latency_seconds * saturation_latency_ratio && baseline.latency_seconds - baseline.min_latency_seconds > latency_margin)
+    {
+        Decrease(now);
+    }
+    else
+    {
+        // The rate is restored by the time without the saturation, not by the number of the responses, otherwise the fast responses cancel the decrease at once.
+        const auto increase_from = std::max(m_last_increase, m_last_decrease);
+        if (now > increase_from)
+        {
+            const auto elapsed_seconds = std::chrono::duration<double>(now - increase_from).count();
+            m_throttle_factor = std::min(1.0, m_throttle_factor + throttle_factor_increase_per_second * elapsed_seconds);
+        }
+        m_last_increase = now;
+    }
+    // With the share of the rate F the server is busy with the export not more than F of the time.
+    m_pause_until = now + ToDuration(latency_seconds * (1.0 / m_throttle_factor - 1.0));
+}
+
+void RateLimiter::OnServerOverload(Clock::time_point now)
+{
+    if (m_is_adaptive)
+    {
+        Decrease(now);
+    }
+}
+
+void RateLimiter::Decrease(Clock::time_point now)
+{
+    // The time of the saturation is not counted for the increase.
+    m_last_increase = std::max(m_last_increase, now);
+    if (now - m_last_decrease >= throttle_decrease_interval)
+    {
+        m_throttle_factor = std::max(min_throttle_factor, m_throttle_factor / 2);
+        m_last_decrease = now;
+    }
+}
+
+} // namespace nodesetexporter::open62541::ratelimit
@@ -0,0 +1,472 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/RoundTripVerifier.h"
+#include "nodesetexporter/common/PerformanceTimer.h"
+#include "nodesetexporter/common/Strings.h"
+#include "nodesetexporter/open62541/LocalizedTexts.h"
+
+#include <open62541/nodeids.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string_view>
+
+namespace nodesetexporter::open62541
+{
+
+using nodesetexporter::common::PerformanceTimer;
+using nodesetexporter::common::UaStringToStdString;
+using nodesetexporter::open62541::typealiases::VariantsOfAttrToString;
+
+namespace
+{
+
+/**
+ * @brief The attributes of the node class that are carried by the NodeSet2 format (UANodeSet.xsd). The attributes that depend on the session user are not included.
+ */
+std::vector<UA_AttributeId> GetNodesetAttributes(UA_NodeClass node_class)
+{
+    std::vector<UA_AttributeId> attributes{UA_ATTRIBUTEID_BROWSENAME, UA_ATTRIBUTEID_DISPLAYNAME, UA_ATTRIBUTEID_DESCRIPTION, UA_ATTRIBUTEID_WRITEMASK};
+    switch (node_class)
+    {
+    case UA_NODECLASS_OBJECT:
+        attributes.push_back(UA_ATTRIBUTEID_EVENTNOTIFIER);
+        break;
+    case UA_NODECLASS_VARIABLE:
+        attributes.insert(
+            attributes.end(),
+            {UA_ATTRIBUTEID_DATATYPE,
+             UA_ATTRIBUTEID_VALUERANK,
+             UA_ATTRIBUTEID_ARRAYDIMENSIONS,
+             UA_ATTRIBUTEID_ACCESSLEVEL,
+             UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
+             UA_ATTRIBUTEID_HISTORIZING,
+             UA_ATTRIBUTEID_VALUE});
+        break;
+    case UA_NODECLASS_VARIABLETYPE:
+        attributes.insert(attributes.end(), {UA_ATTRIBUTEID_DATATYPE, UA_ATTRIBUTEID_VALUERANK, UA_ATTRIBUTEID_ARRAYDIMENSIONS, UA_ATTRIBUTEID_ISABSTRACT, UA_ATTRIBUTEID_VALUE});
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+    case UA_NODECLASS_DATATYPE:
+        attributes.push_back(UA_ATTRIBUTEID_ISABSTRACT);
+        break;
+    case UA_NODECLASS_REFERENCETYPE:
+        attributes.insert(attributes.end(), {UA_ATTRIBUTEID_ISABSTRACT, UA_ATTRIBUTEID_SYMMETRIC, UA_ATTRIBUTEID_INVERSENAME});
+        break;
+    case UA_NODECLASS_METHOD:
+        attributes.push_back(UA_ATTRIBUTEID_EXECUTABLE);
+        break;
+    case UA_NODECLASS_VIEW:
+        attributes.insert(attributes.end(), {UA_ATTRIBUTEID_CONTAINSNOLOOPS, UA_ATTRIBUTEID_EVENTNOTIFIER});
+        break;
+    default:
+        break;
+    }
+    return attributes;
+}
+
+std::string_view GetAttributeName(UA_AttributeId attribute_id)
+{
+    switch (attribute_id)
+    {
+    case UA_ATTRIBUTEID_BROWSENAME:
+        return "BrowseName";
+    case UA_ATTRIBUTEID_DISPLAYNAME:
+        return "DisplayName";
+    case UA_ATTRIBUTEID_DESCRIPTION:
+        return "Description";
+    case UA_ATTRIBUTEID_WRITEMASK:
+        return "WriteMask";
+    case UA_ATTRIBUTEID_EVENTNOTIFIER:
+        return "EventNotifier";
+    case UA_ATTRIBUTEID_DATATYPE:
+        return "DataType";
+    case UA_ATTRIBUTEID_VALUERANK:
+        return "ValueRank";
+    case UA_ATTRIBUTEID_ARRAYDIMENSIONS:
+        return "ArrayDimensions";
+    case UA_ATTRIBUTEID_ACCESSLEVEL:
+        return "AccessLevel";
+    case UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL:
+        return "MinimumSamplingInterval";
+    case UA_ATTRIBUTEID_HISTORIZING:
+        return "Historizing";
+    case UA_ATTRIBUTEID_VALUE:
+        return "Value";
+    case UA_ATTRIBUTEID_ISABSTRACT:
+        return "IsAbstract";
+    case UA_ATTRIBUTEID_SYMMETRIC:
+        return "Symmetric";
+    case UA_ATTRIBUTEID_INVERSENAME:
+        return "InverseName";
+    case UA_ATTRIBUTEID_EXECUTABLE:
+        return "Executable";
+    case UA_ATTRIBUTEID_CONTAINSNOLOOPS:
+        return "ContainsNoLoops";
+    default:
+        return "Unknown attribute";
+    }
+}
+
+/**
+ * @brief The empty LocalizedText is not written to the document, so its absence in the document is not a mismatch.
+ */
+bool IsEmptyLocalizedText(const VariantsOfAttr& value)
+{
+    const auto* const text = std::get_if<UATypesContainer<UA_LocalizedText>>(&value);
+    return text != nullptr && text->GetRef().text.length == 0;
+}
+
+} // namespace
+
+StatusResults RoundTripVerifier::VerifyDocument(const std::string& nodeset_xml, const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids)
+{
+    m_logger.Trace("Method called: VerifyDocument()");
+    auto perf_timer = PerformanceTimer();
+    if (m_reimported.LoadFromMemory(nodeset_xml) != StatusResults::Good)
+    {
+        m_logger.Error("Round-trip verification. The produced document can't be loaded.");
+        return StatusResults::Fail;
+    }
+    AddPhaseTiming("load", perf_timer.GetTimeElapsed());
+    return Verify(node_ids);
+}
+
+StatusResults RoundTripVerifier::VerifyFile(const std::string& filename, const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids)
+{
+    m_logger.Trace("Method called: VerifyFile()");
+    auto perf_timer = PerformanceTimer();
+    if (m_reimported.LoadFromFile(filename) != StatusResults::Good)
+    {
+        m_logger.Error("Round-trip verification. The produced file '{}' can't be loaded.", filename);
+        return StatusResults::Fail;
+    }
+    AddPhaseTiming("load", perf_timer.GetTimeElapsed());
+    return Verify(node_ids);
+}
+
+StatusResults RoundTripVerifier::Verify(const std::vector<UATypesContainer<UA_ExpandedNodeId>>& node_ids)
+{
+    m_logger.Trace("Method called: Verify()");
+    m_mismatches.clear();
+    m_number_of_mismatches = 0;
+    m_number_of_compared_nodes = 0;
+    m_number_of_filtered_references = 0;
+    if (MatchNamespaces() != StatusResults::Good)
+    {
+        return StatusResults::Fail;
+    }
+
+    // The same nodes in the namespace indices of both sides. The request structures refer to the NodeIDs, so the lists are formed completely in advance.
+    NodesData original;
+    NodesData reimported;
+    std::unordered_set<UATypesContainer<UA_NodeId>> export_scope;
+    original.node_ids.reserve(node_ids.size());
+    reimported.node_ids.reserve(node_ids.size());
+    for (const auto& node_id : node_ids)
+    {
+        const auto reimported_ns = m_original_to_reimported_ns.find(node_id.GetRef().nodeId.namespaceIndex);
+        if (reimported_ns == m_original_to_reimported_ns.end())
+        {
+            AddMismatch(node_id.ToString(), "The namespace of the node is missing in the NamespaceUris of the document.");
+            continue;
+        }
+        if (!export_scope.emplace(node_id.GetRef().nodeId, UA_TYPES_NODEID).second)
+        {
+            continue; // The node is already in the list.
+        }
+        original.node_ids.push_back(node_id);
+        reimported.node_ids.push_back(node_id);
+        reimported.node_ids.back().GetRef().nodeId.namespaceIndex = reimported_ns->second;
+    }
+
+    auto perf_timer = PerformanceTimer();
+    if (ReadNodes(m_original, {}, original) != StatusResults::Good)
+    {
+        m_logger.Error("Round-trip verification. The nodes can't be read from the data source.");
+        return StatusResults::Fail;
+    }
+    AddPhaseTiming("read original", perf_timer.GetTimeElapsed());
+
+    // The attributes of the re-imported nodes are requested by the original classes, so that the changed class does not hide the attributes.
+    std::vector<UA_NodeClass> node_classes;
+    node_classes.reserve(original.classes.size());
+    std::transform(
+        original.classes.begin(),
+        original.classes.end(),
+        std::back_inserter(node_classes),
+        [](const auto& node_class)
+        {
+            return node_class.node_class;
+        });
+    perf_timer.Reset();
+    if (ReadNodes(m_reimported, node_classes, reimported) != StatusResults::Good)
+    {
+        m_logger.Error("Round-trip verification. The nodes can't be read from the re-imported document.");
+        return StatusResults::Fail;
+    }
+    AddPhaseTiming("read re-imported", perf_timer.GetTimeElapsed());
+
+    perf_timer.Reset();
+    CompareNodes(original, reimported, export_scope);
+    AddPhaseTiming("diff", perf_timer.GetTimeElapsed());
+
+    for (const auto& timing : m_phase_timings)
+    {
+        m_logger.Info("Round-trip verification, {}: {}", timing.phase, PerformanceTimer::TimeToString(timing.duration));
+    }
+    const auto summary = [this]
+    {
+        return std::string{"Round-trip verification: "} + std::to_string(m_number_of_mismatches) + " mismatches in " + std::to_string(m_number_of_compared_nodes) + " nodes, "
+               + std::to_string(m_number_of_filtered_references) + " references to the nodes outside the export list.";
+    };
+    if (m_number_of_mismatches == 0)
+    {
+        m_logger.Info("{}", summary());
+    }
+    else
+    {
+        m_logger.Warning("{}", summary());
+    }
+    return StatusResults::Good;
+}
+
+StatusResults RoundTripVerifier::MatchNamespaces()
+{
+    m_logger.Trace("Method called: MatchNamespaces()");
+    m_original_to_reimported_ns.clear();
+    m_reimported_to_original_ns.clear();
+
+    const UATypesContainer<UA_ExpandedNodeId> namespace_array_id(UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY), UA_TYPES_EXPANDEDNODEID);
+    UATypesContainer<UA_Variant> namespace_array(UA_TYPES_VARIANT);
+    if (m_original.ReadNodeDataValue(namespace_array_id, namespace_array) != StatusResults::Good) // REQUEST<-->RESPONSE
+    {
+        m_logger.Error("Round-trip verification. The namespace array can't be read from the data source.");
+        return StatusResults::Fail;
+    }
+    if (!UA_Variant_hasArrayType(&namespace_array.GetRef(), &UA_TYPES[UA_TYPES_STRING])) // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    {
+        m_logger.Error("Round-trip verification. Wrong type of the namespace array of the data source.");
+        return StatusResults::Fail;
+    }
+
+    // ns=0 is the OPC UA namespace on both sides.
+    m_original_to_reimported_ns.emplace(0, 0);
+    m_reimported_to_original_ns.emplace(0, 0);
+    const auto& reimported_namespaces = m_reimported.GetNamespaceArray();
+    const auto* const uris = static_cast<const UA_String*>(namespace_array.GetRef().data);
+    for (size_t index = 1; index < namespace_array.GetRef().arrayLength; ++index)
+    {
+        const auto uri = UaStringToStdString(uris[index]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto reimported_uri = std::find(reimported_namespaces.begin(), reimported_namespaces.end(), uri);
+        if (reimported_uri == reimported_namespaces.end())
+        {
+            continue; // The namespace is not used by the unloading.
+        }
+        const auto original_index = static_cast<UA_UInt16>(index);
+        const auto reimported_index = static_cast<UA_UInt16>(std::distance(reimported_namespaces.begin(), reimported_uri));
+        m_original_to_reimported_ns.emplace(original_index, reimported_index);
+        m_reimported_to_original_ns.emplace(reimported_index, original_index);
+    }
+    return StatusResults::Good;
+}
+
+StatusResults RoundTripVerifier::ReadNodes(IOpen62541& source, const std::vector<UA_NodeClass>& node_classes, NodesData& data) const
+{
+    m_logger.Trace("Method called: ReadNodes()");
+    const auto number_of_nodes = data.node_ids.size();
+    data.classes.reserve(number_of_nodes);
+    data.references.reserve(number_of_nodes);
+    data.attributes.reserve(number_of_nodes);
+    for (size_t first = 0; first < number_of_nodes; first += m_number_of_nodes_in_batch)
+    {
+        const auto last = std::min(first + m_number_of_nodes_in_batch, number_of_nodes);
+        std::vector<IOpen62541::NodeClassesRequestResponse> classes;
+        std::vector<IOpen62541::NodeReferencesRequestResponse> references;
+        std::vector<IOpen62541::NodeAttributesRequestResponse> attributes;
+        for (auto index = first; index < last; ++index)
+        {
+            classes.emplace_back(data.node_ids.at(index));
+            references.emplace_back(data.node_ids.at(index));
+        }
+        if (source.ReadNodeClasses(classes) != StatusResults::Good || source.ReadNodeReferences(references) != StatusResults::Good) // REQUEST<-->RESPONSE
+        {
+            return StatusResults::Fail;
+        }
+        for (auto index = first; index < last; ++index)
+        {
+            const auto node_class = node_classes.empty() ? classes.at(index - first).node_class : node_classes.at(index);
+            std::map<UA_AttributeId, std::optional<VariantsOfAttr>> attrs;
+            for (const auto attribute_id : GetNodesetAttributes(node_class))
+            {
+                attrs.emplace(attribute_id, std::nullopt);
+            }
+            attributes.push_back({data.node_ids.at(index), std::move(attrs)});
+        }
+        if (source.ReadNodesAttributes(attributes) != StatusResults::Good) // REQUEST<-->RESPONSE
+        {
+            return StatusResults::Fail;
+        }
+        std::move(classes.begin(), classes.end(), std::back_inserter(data.classes));
+        std::move(references.begin(), references.end(), std::back_inserter(data.references));
+        std::move(attributes.begin(), attributes.end(), std::back_inserter(data.attributes));
+    }
+    return StatusResults::Good;
+}
+
+void RoundTripVerifier::CompareNodes(const NodesData& original, const NodesData& reimported, const std::unordered_set<UATypesContainer<UA_NodeId>>& export_scope)
+{
+    m_logger.Trace("Method called: CompareNodes()");
+    for (size_t index = 0; index < original.node_ids.size(); ++index)
+    {
+        ++m_number_of_compared_nodes;
+        const auto node_id = original.node_ids.at(index).ToString();
+        const auto& original_class = original.classes.at(index);
+        const auto& reimported_class = reimported.classes.at(index);
+        if (UA_StatusCode_isBad(original_class.result_code))
+        {
+            AddMismatch(node_id, std::string{"The node can't be read from the data source: "} + UA_StatusCode_name(original_class.result_code));
+            continue;
+        }
+        if (UA_StatusCode_isBad(reimported_class.result_code) || reimported_class.node_class == UA_NODECLASS_UNSPECIFIED)
+        {
+            AddMismatch(node_id, "The node is missing in the document.");
+            continue;
+        }
+        if (original_class.node_class != reimported_class.node_class)
+        {
+            AddMismatch(node_id, "NodeClass: " + std::to_string(original_class.node_class) + " != " + std::to_string(reimported_class.node_class));
+            continue;
+        }
+
+        // Attributes
+        const auto& reimported_attrs = reimported.attributes.at(index).attrs;
+        for (const auto& [attribute_id, original_value] : original.attributes.at(index).attrs)
+        {
+            if (!original_value.has_value())
+            {
+                continue; // The attribute is not provided by the data source.
+            }
+            const auto reimported_value = reimported_attrs.find(attribute_id);
+            if (reimported_value == reimported_attrs.end() || !reimported_value->second.has_value())
+            {
+                // The values of the types not supported by the document loader are skipped.
+                if (attribute_id != UA_ATTRIBUTEID_VALUE && !IsEmptyLocalizedText(original_value.value()))
+                {
+                    AddMismatch(node_id, std::string{GetAttributeName(attribute_id)} + " is lost: '" + AttributeToString(original_value.value(), false) + "'");
+                }
+                continue;
+            }
+            const auto original_text = AttributeToString(original_value.value(), false);
+            const auto reimported_text = AttributeToString(reimported_value->second.value(), true);
+            if (original_text != reimported_text)
+            {
+                AddMismatch(node_id, std::string{GetAttributeName(attribute_id)} + ": '" + original_text + "' != '" + reimported_text + "'");
+            }
+        }
+
+        // References. The references to the non-standard nodes outside the export list are not written to the document.
+        std::vector<std::string> original_references;
+        for (const auto& reference : original.references.at(index).references)
+        {
+            const auto& target = reference.GetRef().nodeId.nodeId;
+            if (target.namespaceIndex != 0 && !export_scope.contains(UATypesContainer<UA_NodeId>(target, UA_TYPES_NODEID)))
+            {
+                ++m_number_of_filtered_references;
+                continue;
+            }
+            original_references.push_back(ReferenceToString(reference.GetRef(), false));
+        }
+        std::vector<std::string> reimported_references;
+        for (const auto& reference : reimported.references.at(index).references)
+        {
+            reimported_references.push_back(ReferenceToString(reference.GetRef(), true));
+        }
+        // The NodeSet format does not keep the duplicates of the references.
+        for (auto* references : {&original_references, &reimported_references})
+        {
+            std::sort(references->begin(), references->end());
+            references->erase(std::unique(references->begin(), references->end()), references->end());
+        }
+        std::vector<std::string> differences;
+        std::set_difference(original_references.begin(), original_references.end(), reimported_references.begin(), reimported_references.end(), std::back_inserter(differences));
+        for (const auto& reference : differences)
+        {
+            AddMismatch(node_id, "The reference is lost: " + reference);
+        }
+        differences.clear();
+        std::set_difference(reimported_references.begin(), reimported_references.end(), original_references.begin(), original_references.end(), std::back_inserter(differences));
+        for (const auto& reference : differences)
+        {
+            AddMismatch(node_id, "The reference is added: " + reference);
+        }
+    }
+}
+
+std::string RoundTripVerifier::ReferenceToString(const UA_ReferenceDescription& reference, bool is_reimported) const
+{
+    UATypesContainer<UA_NodeId> reference_type(reference.referenceTypeId, UA_TYPES_NODEID);
+    UATypesContainer<UA_NodeId> target(reference.nodeId.nodeId, UA_TYPES_NODEID);
+    if (is_reimported)
+    {
+        reference_type.GetRef().namespaceIndex = ToOriginalNamespace(reference_type.GetRef().namespaceIndex);
+        target.GetRef().namespaceIndex = ToOriginalNamespace(target.GetRef().namespaceIndex);
+    }
+    return (reference.isForward ? std::string{} : std::string{"inverse "}) + reference_type.ToString() + " ==> " + target.ToString();
+}
+
+std::string RoundTripVerifier::AttributeToString(const VariantsOfAttr& value, bool is_reimported) const
+{
+    if (is_reimported)
+    {
+        if (const auto* const node_id = std::get_if<UATypesContainer<UA_NodeId>>(&value))
+        {
+            auto translated = *node_id;
+            translated.GetRef().namespaceIndex = ToOriginalNamespace(translated.GetRef().namespaceIndex);
+            return translated.ToString();
+        }
+        if (const auto* const qualified_name = std::get_if<UATypesContainer<UA_QualifiedName>>(&value))
+        {
+            auto translated = *qualified_name;
+            translated.GetRef().namespaceIndex = ToOriginalNamespace(translated.GetRef().namespaceIndex);
+            return translated.ToString();
+        }
+    }
+    else if (const auto* const text = std::get_if<UATypesContainer<UA_LocalizedText>>(&value))
+    {
+        // The text of the locale "mul" is exported as the separate locales, the document keeps the first one as the main text.
+        std::vector<UATypesContainer<UA_LocalizedText>> texts;
+        if (UaStringToStdString(text->GetRef().locale) == locales::multi_locale_id && locales::SplitMultiLocaleText(text->GetRef(), m_locales, texts) == StatusResults::Good
+            && !texts.empty())
+        {
+            return VariantsOfAttrToString(VariantsOfAttr(texts.front()));
+        }
+    }
+    return VariantsOfAttrToString(value);
+}
+
+UA_UInt16 RoundTripVerifier::ToOriginalNamespace(UA_UInt16 index) const
+{
+    const auto original_index = m_reimported_to_original_ns.find(index);
+    return original_index != m_reimported_to_original_ns.end() ? original_index->second : index;
+}
+
+void RoundTripVerifier::AddMismatch(const std::string& node_id, std::string&& description)
+{
+    ++m_number_of_mismatches;
+    if (m_mismatches.size() < max_stored_mismatches)
+    {
+        m_logger.Warning("Round-trip verification. NodeId: {}: {}", node_id, description);
+        m_mismatches.push_back({node_id, std::move(description)});
+    }
+}
+
+} // namespace nodesetexporter::open62541
@@ -0,0 +1,232 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/SecurityProfile.h"
+
+#include <open62541/client_config_default.h>
+#include <open62541/plugin/pki_default.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace nodesetexporter::open62541::security
+{
+
+namespace
+{
+
+constexpr size_t number_of_measured_chunks = 64;
+
+/**
+ * @brief Reading of the file into the string, which is used as the buffer of the UA_ByteString.
+ */
+std::optional<std::string> ReadFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief The UA_ByteString that refers to the string without the copying.
+ */
+UA_ByteString ToByteString(std::string& buffer)
+{
+    return {buffer.size(), reinterpret_cast<UA_Byte*>(buffer.data())}; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+} // namespace
+
+std::optional<std::string> SecurityPolicyUriFromName(std::string_view name)
+{
+    static const std::map<std::string_view, std::string> security_policies = {
+        {"None", "http://opcfoundation.org/UA/SecurityPolicy#None"},
+        {"Basic128Rsa15", "http://opcfoundation.org/UA/SecurityPolicy#Basic128Rsa15"},
+        {"Basic256", "http://opcfoundation.org/UA/SecurityPolicy#Basic256"},
+        {"Basic256Sha256", "http://opcfoundation.org/UA/SecurityPolicy#Basic256Sha256"},
+        {"Aes128_Sha256_RsaOaep", "http://opcfoundation.org/UA/SecurityPolicy#Aes128_Sha256_RsaOaep"},
+        {"Aes256_Sha256_RsaPss", "http://opcfoundation.org/UA/SecurityPolicy#Aes256_Sha256_RsaPss"}};
+    const auto security_policy = security_policies.find(name);
+    if (security_policy == security_policies.end())
+    {
+        return std::nullopt;
+    }
+    return security_policy->second;
+}
+
+std::optional<UA_MessageSecurityMode> SecurityModeFromName(std::string_view name)
+{
+    if (name == "None")
+    {
+        return UA_MESSAGESECURITYMODE_NONE;
+    }
+    if (name == "Sign")
+    {
+        return UA_MESSAGESECURITYMODE_SIGN;
+    }
+    if (name == "SignAndEncrypt")
+    {
+        return UA_MESSAGESECURITYMODE_SIGNANDENCRYPT;
+    }
+    return std::nullopt;
+}
+
+StatusResults ApplySecurityProfile(UA_ClientConfig& config, const SecurityProfile& profile, LoggerBase& logger)
+{
+    logger.Trace("Method called: ApplySecurityProfile()");
+    if (profile.security_mode == UA_MESSAGESECURITYMODE_NONE)
+    {
+        return UA_ClientConfig_setDefault(&config) == UA_STATUSCODE_GOOD ? StatusResults::Good : StatusResults::Fail;
+    }
+#ifdef UA_ENABLE_ENCRYPTION
+    auto certificate = ReadFile(profile.certificate_file);
+    auto private_key = ReadFile(profile.private_key_file);
+    if (!certificate.has_value() || !private_key.has_value())
+    {
+        logger.Error("Can't read the certificate '{}' or the private key '{}' of the client", profile.certificate_file, profile.private_key_file);
+        return StatusResults::Fail;
+    }
+    std::vector<std::string> trust_list_buffers;
+    trust_list_buffers.reserve(profile.trust_list_files.size());
+    for (const auto& trust_list_file : profile.trust_list_files)
+    {
+        auto trusted_certificate = ReadFile(trust_list_file);
+        if (!trusted_certificate.has_value())
+        {
+            logger.Error("Can't read the trusted certificate '{}'", trust_list_file);
+            return StatusResults::Fail;
+        }
+        trust_list_buffers.push_back(std::move(*trusted_certificate));
+    }
+    std::vector<UA_ByteString> trust_list;
+    trust_list.reserve(trust_list_buffers.size());
+    for (auto& trust_list_buffer : trust_list_buffers)
+    {
+        trust_list.push_back(ToByteString(trust_list_buffer));
+    }
+
+    // The data are copied into the configuration.
+    auto status = UA_ClientConfig_setDefaultEncryption(&config, ToByteString(*certificate), ToByteString(*private_key), trust_list.data(), trust_list.size(), nullptr, 0);
+    if (status != UA_STATUSCODE_GOOD)
+    {
+        logger.Error("Can't configure the encryption of the client: {}", UA_StatusCode_name(status));
+        return StatusResults::Fail;
+    }
+    if (trust_list.empty())
+    {
+        logger.Warning("The trust list is empty, the certificate of any server is accepted");
+        if (config.certificateVerification.clear != nullptr)
+        {
+            config.certificateVerification.clear(&config.certificateVerification);
+        }
+        UA_CertificateVerification_AcceptAll(&config.certificateVerification);
+    }
+
+    config.securityMode = profile.security_mode;
+    if (!profile.security_policy_uri.empty())
+    {
+        bool is_supported = false;
+        for (size_t index = 0; index < config.securityPoliciesSize; ++index)
+        {
+            const auto& policy_uri = config.securityPolicies[index].policyUri; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            is_supported = is_supported || std::string_view(reinterpret_cast<const char*>(policy_uri.data), policy_uri.length) == profile.security_policy_uri; // NOLINT
+        }
+        if (!is_supported)
+        {
+            logger.Error("The security policy '{}' is not supported by the Open62541 library", profile.security_policy_uri);
+            return StatusResults::Fail;
+        }
+        UA_String_clear(&config.securityPolicyUri);
+        config.securityPolicyUri = UA_STRING_ALLOC(profile.security_policy_uri.c_str());
+    }
+    if (!profile.application_uri.empty())
+    {
+        UA_String_clear(&config.clientDescription.applicationUri);
+        config.clientDescription.applicationUri = UA_STRING_ALLOC(profile.application_uri.c_str());
+    }
+    return StatusResults::Good;
+#else
+    logger.Error("The Open62541 library is built without the encryption (UA_ENABLE_ENCRYPTION), only the security mode None is available");
+    return StatusResults::Fail;
+#endif
+}
+
+StatusResults MeasureCryptoOverhead(const UA_ClientConfig& config, size_t chunk_size, CryptoOverhead& overhead)
+{
+    if (config.securityMode != UA_MESSAGESECURITYMODE_SIGN && config.securityMode != UA_MESSAGESECURITYMODE_SIGNANDENCRYPT)
+    {
+        return StatusResults::Fail;
+    }
+    const UA_SecurityPolicy* policy = nullptr;
+    for (size_t index = 0; index < config.securityPoliciesSize; ++index)
+    {
+        if (UA_String_equal(&config.securityPolicies[index].policyUri, &config.securityPolicyUri)) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        {
+            policy = &config.securityPolicies[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            break;
+        }
+    }
+    if (policy == nullptr || policy->localCertificate.length == 0)
+    {
+        return StatusResults::Fail;
+    }
+
+    // The own certificate stands for the certificate of the server, only the symmetric keys are used.
+    void* channel_context = nullptr;
+    if (policy->channelModule.newContext(policy, &policy->localCertificate, &channel_context) != UA_STATUSCODE_GOOD)
+    {
+        return StatusResults::Fail;
+    }
+    const auto& crypto_module = policy->symmetricModule.cryptoModule;
+    const auto block_size = std::max<size_t>(1, crypto_module.encryptionAlgorithm.getRemoteBlockSize(channel_context));
+    std::vector<UA_Byte> encrypting_key(crypto_module.encryptionAlgorithm.getLocalKeyLength(channel_context), 0x5a); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::vector<UA_Byte> signing_key(crypto_module.signatureAlgorithm.getLocalKeyLength(channel_context), 0xa5); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    std::vector<UA_Byte> initialization_vector(block_size, 0x3c); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const UA_ByteString encrypting_key_string{encrypting_key.size(), encrypting_key.data()};
+    const UA_ByteString signing_key_string{signing_key.size(), signing_key.data()};
+    const UA_ByteString initialization_vector_string{initialization_vector.size(), initialization_vector.data()};
+    auto status = policy->channelModule.setLocalSymEncryptingKey(channel_context, &encrypting_key_string);
+    status |= policy->channelModule.setLocalSymSigningKey(channel_context, &signing_key_string);
+    status |= policy->channelModule.setLocalSymIv(channel_context, &initialization_vector_string);
+
+    // The encrypted data must be aligned to the block.
+    overhead.chunk_size = std::max(block_size, chunk_size - chunk_size % block_size);
+    std::vector<UA_Byte> chunk(overhead.chunk_size, 0);
+    std::vector<UA_Byte> signature(crypto_module.signatureAlgorithm.getLocalSignatureSize(channel_context), 0);
+    UA_ByteString chunk_string{chunk.size(), chunk.data()};
+    UA_ByteString signature_string{signature.size(), signature.data()};
+    overhead.sign = std::chrono::nanoseconds{0};
+    overhead.encrypt = std::chrono::nanoseconds{0};
+    for (size_t index = 0; index < number_of_measured_chunks && status == UA_STATUSCODE_GOOD; ++index)
+    {
+        auto start = std::chrono::steady_clock::now();
+        status |= crypto_module.signatureAlgorithm.sign(channel_context, &chunk_string, &signature_string);
+        overhead.sign += std::chrono::steady_clock::now() - start;
+        if (config.securityMode == UA_MESSAGESECURITYMODE_SIGNANDENCRYPT)
+        {
+            start = std::chrono::steady_clock::now();
+            status |= crypto_module.encryptionAlgorithm.encrypt(channel_context, &chunk_string);
+            overhead.encrypt += std::chrono::steady_clock::now() - start;
+        }
+    }
+    policy->channelModule.deleteContext(channel_context);
+    if (status != UA_STATUSCODE_GOOD)
+    {
+        return StatusResults::Fail;
+    }
+    overhead.sign /= number_of_measured_chunks;
+    overhead.encrypt /= number_of_measured_chunks;
+    return StatusResults::Good;
+}
+
+} // namespace nodesetexporter::open62541::security
@@ -0,0 +1,490 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/TransportProfile.h"
+
+#include <open62541/client_highlevel.h>
+#include <open62541/nodeids.h>
+#ifdef OPEN62541_VER_1_3
+#include <open62541/network_tcp.h>
+#endif
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace nodesetexporter::open62541::transport
+{
+
+namespace
+{
+
+constexpr u_int32_t min_buffer_size = 8192; // The minimum size of the chunk by the OPC UA TCP protocol (Part 6, 7.1.2.3)
+
+// The Acknowledge message of the OPC UA TCP protocol (Part 6, 7.1.2.4): the header of the message (the type "ACKF" and the size)
+// and ProtocolVersion, ReceiveBufferSize, SendBufferSize, MaxMessageSize, MaxChunkCount.
+constexpr std::string_view acknowledge_message_type = "ACKF";
+constexpr size_t acknowledge_send_buffer_size_offset = 8 + 4 + 4;
+constexpr size_t acknowledge_message_size = 8 + 5 * 4;
+
+/**
+ * @brief The transport state of one client: the profile and the send buffer of the server from the Acknowledge message of the current connection.
+ */
+struct ClientTransport
+{
+    TransportProfile profile;
+    u_int32_t negotiated_send_buffer_size = 0; // The maximum size of the chunk sent by the server. 0 - the connection is not acknowledged yet.
+#ifdef OPEN62541_VER_1_3
+    UA_SOCKET socket = UA_INVALID_SOCKET; // The socket of the current connection of the client.
+#elif defined(OPEN62541_VER_1_4)
+    decltype(UA_ConnectionManager::openConnection) original_open_connection = nullptr;
+    void* application = nullptr; // The application and the callback of the client, to which the events of the connection are passed.
+    UA_ConnectionManager_connectionCallback connection_callback = nullptr;
+#endif
+};
+
+/**
+ * @brief The transport states of the clients. The connection functions of Open62541 have no context of the client, so the state is found by the key
+ *        that they receive: the logger of the configuration of the client (v1.3) or the TCP connection manager of the event loop of the client (v1.4).
+ *        The state is created once for the key and is updated when the profile is applied to the same configuration again.
+ */
+class ClientTransports final
+{
+public:
+    static ClientTransports& Instance()
+    {
+        static ClientTransports transports;
+        return transports;
+    }
+
+    /**
+     * @brief Setting of the profile of the client. The address of the state does not change while the process runs.
+     */
+    ClientTransport& Set(const void* key, const TransportProfile& profile)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& transport = m_transports[key];
+        if (transport == nullptr)
+        {
+            transport = std::make_unique<ClientTransport>();
+        }
+        transport->profile = profile;
+        transport->negotiated_send_buffer_size = 0;
+        return *transport;
+    }
+
+    /**
+     * @brief Calling the function with the state of the client under the lock.
+     * @return False if the profile was not applied to the client.
+     */
+    template <typename TFunction>
+    bool Access(const void* key, TFunction&& function)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto transport = m_transports.find(key);
+        if (transport == m_transports.end())
+        {
+            return false;
+        }
+        function(*transport->second);
+        return true;
+    }
+
+    /**
+     * @brief Calling the function with the state of the client under the lock.
+     */
+    template <typename TFunction>
+    void Access(ClientTransport& transport, TFunction&& function)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        function(transport);
+    }
+
+#ifdef OPEN62541_VER_1_3
+    /**
+     * @brief Binding of the new socket of the client to its state. The socket number is released by the closed connections, so it is unbound
+     *        from the other states.
+     * @param profile [out] The profile of the client.
+     * @return False if the profile was not applied to the client.
+     */
+    bool AttachSocket(const void* key, UA_SOCKET socket, TransportProfile& profile)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto found = m_transports.find(key);
+        if (found == m_transports.end())
+        {
+            return false;
+        }
+        for (auto& [other_key, transport] : m_transports)
+        {
+            if (transport->socket == socket)
+            {
+                transport->socket = UA_INVALID_SOCKET;
+            }
+        }
+        found->second->socket = socket;
+        found->second->negotiated_send_buffer_size = 0;
+        profile = found->second->profile;
+        return true;
+    }
+
+    /**
+     * @brief Calling the function with the state of the client, whose current connection has the socket, under the lock.
+     */
+    template <typename TFunction>
+    void AccessBySocket(UA_SOCKET socket, TFunction&& function)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& [key, transport] : m_transports)
+        {
+            if (transport->socket == socket)
+            {
+                function(*transport);
+                return;
+            }
+        }
+    }
+#endif
+
+private:
+    ClientTransports() = default;
+
+    std::mutex m_mutex;
+    std::map<const void*, std::unique_ptr<ClientTransport>> m_transports;
+};
+
+/**
+ * @brief Getting SendBufferSize from the Acknowledge message at the beginning of the received data.
+ * @return 0 if the data is not the Acknowledge message.
+ */
+u_int32_t ParseAcknowledgeSendBufferSize(const UA_Byte* data, size_t size)
+{
+    if (data == nullptr || size < acknowledge_message_size || std::string_view(reinterpret_cast<const char*>(data), acknowledge_message_type.size()) != acknowledge_message_type) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    {
+        return 0;
+    }
+    u_int32_t send_buffer_size = 0;
+    for (size_t index = 0; index < sizeof(send_buffer_size); ++index) // Little-endian
+    {
+        send_buffer_size |= static_cast<u_int32_t>(data[acknowledge_send_buffer_size_offset + index]) << (8U * index); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return send_buffer_size;
+}
+
+#ifdef OPEN62541_VER_1_3
+using ReceiveFunction = UA_StatusCode (*)(UA_Connection*, UA_ByteString*, UA_UInt32);
+
+// The receive function of the TCP connections of Open62541. It is the same for all the connections and is replaced by ReceiveWithAcknowledge.
+std::atomic<ReceiveFunction> tcp_receive{nullptr}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * @brief Setting of the options of the socket of the client. The errors are not critical, the socket keeps the options of the system.
+ */
+void SetSocketOptions(UA_SOCKET socket, const TransportProfile& profile)
+{
+    if (profile.socket_recv_buffer_size != 0)
+    {
+        const int size = static_cast<int>(profile.socket_recv_buffer_size);
+        setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+    if (profile.socket_send_buffer_size != 0)
+    {
+        const int size = static_cast<int>(profile.socket_send_buffer_size);
+        setsockopt(socket, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    }
+    const int no_delay = profile.tcp_no_delay ? 1 : 0;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+}
+
+/**
+ * @brief Receiving of the data of the connection. The first Acknowledge message of the connection is kept in the state of the client.
+ */
+UA_StatusCode ReceiveWithAcknowledge(UA_Connection* connection, UA_ByteString* response, UA_UInt32 timeout)
+{
+    const auto status = tcp_receive.load()(connection, response, timeout);
+    if (status == UA_STATUSCODE_GOOD)
+    {
+        ClientTransports::Instance().AccessBySocket(
+            connection->sockfd,
+            [response](ClientTransport& transport)
+            {
+                if (transport.negotiated_send_buffer_size == 0)
+                {
+                    transport.negotiated_send_buffer_size = ParseAcknowledgeSendBufferSize(response->data, response->length);
+                }
+            });
+    }
+    return status;
+}
+
+/**
+ * @brief Creation of the TCP connection of the client. UA_ClientConnectionTCP_init creates the socket and the connection is started by the first poll
+ *        (UA_ClientConnectionTCP_poll), so the options are set before the connect. The client passes the logger of its configuration, it is the key of the state.
+ */
+UA_Connection InitConnectionWithTransportProfile(UA_ConnectionConfig config, UA_String endpoint_url, UA_UInt32 timeout, const UA_Logger* logger)
+{
+    auto connection = UA_ClientConnectionTCP_init(config, endpoint_url, timeout, logger);
+    if (connection.sockfd == UA_INVALID_SOCKET)
+    {
+        return connection;
+    }
+    TransportProfile profile;
+    const bool is_found = ClientTransports::Instance().AttachSocket(logger, connection.sockfd, profile);
+    if (is_found)
+    {
+        SetSocketOptions(connection.sockfd, profile);
+        tcp_receive = connection.recv;
+        connection.recv = ReceiveWithAcknowledge;
+    }
+    return connection;
+}
+
+const void* ClientTransportKey(const UA_ClientConfig& config)
+{
+    return &config.logger;
+}
+#elif defined(OPEN62541_VER_1_4)
+/**
+ * @brief Getting of the TCP connection manager of the event loop of the client.
+ */
+UA_ConnectionManager* FindTcpConnectionManager(UA_EventLoop* event_loop)
+{
+    if (event_loop == nullptr)
+    {
+        return nullptr;
+    }
+    const UA_String tcp_protocol = UA_STRING_STATIC("tcp");
+    for (UA_EventSource* event_source = event_loop->eventSources; event_source != nullptr; event_source = event_source->next)
+    {
+        if (event_source->eventSourceType != UA_EVENTSOURCETYPE_CONNECTIONMANAGER)
+        {
+            continue;
+        }
+        auto* connection_manager = reinterpret_cast<UA_ConnectionManager*>(event_source); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (UA_String_equal(&connection_manager->protocol, &tcp_protocol))
+        {
+            return connection_manager;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Setting of the parameters of the TCP connection manager of the event loop of the client.
+ */
+void SetConnectionManagerParameters(UA_ConnectionManager& connection_manager, const TransportProfile& profile)
+{
+    auto recv_buffer_size = profile.socket_recv_buffer_size;
+    auto send_buffer_size = profile.socket_send_buffer_size;
+    if (recv_buffer_size != 0)
+    {
+        UA_KeyValueMap_setScalar(&connection_manager.eventSource.params, UA_QUALIFIEDNAME(0, const_cast<char*>("recv-bufsize")), &recv_buffer_size, &UA_TYPES[UA_TYPES_UINT32]); // NOLINT
+    }
+    if (send_buffer_size != 0)
+    {
+        UA_KeyValueMap_setScalar(&connection_manager.eventSource.params, UA_QUALIFIEDNAME(0, const_cast<char*>("send-bufsize")), &send_buffer_size, &UA_TYPES[UA_TYPES_UINT32]); // NOLINT
+    }
+}
+
+/**
+ * @brief The events of the connection of the client. The first Acknowledge message of the connection is kept in the state of the client,
+ *        the event is passed to the client.
+ */
+void ConnectionCallbackWithAcknowledge(
+    UA_ConnectionManager* connection_manager,
+    uintptr_t connection_id,
+    void* application,
+    void** connection_context,
+    UA_ConnectionState state,
+    const UA_KeyValueMap* params,
+    UA_ByteString msg)
+{
+    auto& transport = *static_cast<ClientTransport*>(application);
+    void* client_application = nullptr;
+    UA_ConnectionManager_connectionCallback client_callback = nullptr;
+    ClientTransports::Instance().Access(
+        transport,
+        [&](ClientTransport& locked_transport)
+        {
+            if (state == UA_CONNECTIONSTATE_ESTABLISHED && locked_transport.negotiated_send_buffer_size == 0)
+            {
+                locked_transport.negotiated_send_buffer_size = ParseAcknowledgeSendBufferSize(msg.data, msg.length);
+            }
+            client_application = locked_transport.application;
+            client_callback = locked_transport.connection_callback;
+        });
+    client_callback(connection_manager, connection_id, client_application, connection_context, state, params, msg);
+}
+
+/**
+ * @brief Opening of the connection of the client. The events of the connection go through ConnectionCallbackWithAcknowledge.
+ */
+UA_StatusCode OpenConnectionWithAcknowledge(
+    UA_ConnectionManager* connection_manager,
+    const UA_KeyValueMap* params,
+    void* application,
+    void* context,
+    UA_ConnectionManager_connectionCallback connection_callback)
+{
+    ClientTransport* client_transport = nullptr;
+    decltype(UA_ConnectionManager::openConnection) original_open_connection = nullptr;
+    ClientTransports::Instance().Access(
+        connection_manager,
+        [&](ClientTransport& transport)
+        {
+            transport.application = application;
+            transport.connection_callback = connection_callback;
+            transport.negotiated_send_buffer_size = 0;
+            client_transport = &transport;
+            original_open_connection = transport.original_open_connection;
+        });
+    return original_open_connection(connection_manager, params, client_transport, context, ConnectionCallbackWithAcknowledge);
+}
+
+const void* ClientTransportKey(const UA_ClientConfig& config)
+{
+    return FindTcpConnectionManager(config.eventLoop);
+}
+#endif
+
+/**
+ * @brief Reading of the operation limit of the server. The limit that can't be read is no limit.
+ */
+u_int32_t ReadOperationLimit(UA_Client& client, UA_UInt32 limit_node_id)
+{
+    UA_Variant value;
+    UA_Variant_init(&value);
+    u_int32_t limit = 0;
+    if (UA_Client_readValueAttribute(&client, UA_NODEID_NUMERIC(0, limit_node_id), &value) == UA_STATUSCODE_GOOD && UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_UINT32]))
+    {
+        limit = *static_cast<UA_UInt32*>(value.data);
+    }
+    UA_Variant_clear(&value);
+    return limit;
+}
+
+/**
+ * @brief The minimum of the limits, where 0 is no limit.
+ */
+u_int32_t MinLimit(u_int32_t left, u_int32_t right)
+{
+    if (left == 0)
+    {
+        return right;
+    }
+    if (right == 0)
+    {
+        return left;
+    }
+    return std::min(left, right);
+}
+
+} // namespace
+
+StatusResults ApplyTransportProfile(UA_ClientConfig& config, const TransportProfile& profile)
+{
+    if ((profile.recv_buffer_size != 0 && profile.recv_buffer_size < min_buffer_size) || (profile.send_buffer_size != 0 && profile.send_buffer_size < min_buffer_size))
+    {
+        return StatusResults::Fail;
+    }
+    if (profile.recv_buffer_size != 0)
+    {
+        config.localConnectionConfig.recvBufferSize = profile.recv_buffer_size;
+    }
+    else if (config.securityMode == UA_MESSAGESECURITYMODE_SIGN || config.securityMode == UA_MESSAGESECURITYMODE_SIGNANDENCRYPT)
+    {
+        config.localConnectionConfig.recvBufferSize = std::max(config.localConnectionConfig.recvBufferSize, secured_channel_recv_buffer_size);
+    }
+    if (profile.send_buffer_size != 0)
+    {
+        config.localConnectionConfig.sendBufferSize = profile.send_buffer_size;
+    }
+    if (profile.max_message_size != 0)
+    {
+        config.localConnectionConfig.localMaxMessageSize = profile.max_message_size;
+    }
+    if (profile.max_chunk_count != 0)
+    {
+        config.localConnectionConfig.localMaxChunkCount = profile.max_chunk_count;
+    }
+
+#ifdef OPEN62541_VER_1_3
+    if (config.initConnectionFunc == UA_ClientConnectionTCP_init || config.initConnectionFunc == InitConnectionWithTransportProfile)
+    {
+        ClientTransports::Instance().Set(ClientTransportKey(config), profile);
+        config.initConnectionFunc = InitConnectionWithTransportProfile;
+    }
+#elif defined(OPEN62541_VER_1_4)
+    auto* connection_manager = FindTcpConnectionManager(config.eventLoop);
+    if (connection_manager != nullptr)
+    {
+        SetConnectionManagerParameters(*connection_manager, profile);
+        auto& transport = ClientTransports::Instance().Set(connection_manager, profile);
+        if (connection_manager->openConnection != OpenConnectionWithAcknowledge)
+        {
+            transport.original_open_connection = connection_manager->openConnection;
+            connection_manager->openConnection = OpenConnectionWithAcknowledge;
+        }
+    }
+#endif
+    return StatusResults::Good;
+}
+
+StatusResults ReadRequestLimits(UA_Client& client, RequestLimits& limits)
+{
+    UA_SessionState session_state = UA_SESSIONSTATE_CLOSED;
+    UA_Client_getState(&client, nullptr, &session_state, nullptr);
+    if (session_state != UA_SESSIONSTATE_ACTIVATED)
+    {
+        return StatusResults::Fail;
+    }
+
+    const auto* config = UA_Client_getConfig(&client);
+    const auto& connection_config = config->localConnectionConfig;
+    limits.max_message_size = connection_config.localMaxMessageSize;
+    if (connection_config.localMaxChunkCount != 0)
+    {
+        // The server sends the chunks not larger than its send buffer from the Acknowledge message, which is not larger than the receive buffer of the client.
+        auto chunk_payload_size = connection_config.recvBufferSize;
+        ClientTransports::Instance().Access(
+            ClientTransportKey(*config),
+            [&chunk_payload_size](const ClientTransport& transport) { chunk_payload_size = MinLimit(chunk_payload_size, transport.negotiated_send_buffer_size); });
+        if (config->securityMode == UA_MESSAGESECURITYMODE_SIGN || config->securityMode == UA_MESSAGESECURITYMODE_SIGNANDENCRYPT)
+        {
+            chunk_payload_size -= std::min(chunk_payload_size, secured_chunk_overhead);
+        }
+        const auto max_chunks_size = static_cast<u_int64_t>(chunk_payload_size) * connection_config.localMaxChunkCount;
+        limits.max_message_size = MinLimit(limits.max_message_size, static_cast<u_int32_t>(std::min<u_int64_t>(max_chunks_size, std::numeric_limits<u_int32_t>::max())));
+    }
+    limits.max_nodes_per_read = ReadOperationLimit(client, UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD);
+    return StatusResults::Good;
+}
+
+u_int32_t DeriveNumberOfMaxNodesToRequestData(const RequestLimits& limits)
+{
+    u_int32_t number_of_nodes = 0;
+    if (limits.max_nodes_per_read != 0)
+    {
+        number_of_nodes = std::max<u_int32_t>(1, limits.max_nodes_per_read / estimated_attributes_per_node);
+    }
+    if (limits.max_message_size != 0)
+    {
+        number_of_nodes = MinLimit(number_of_nodes, std::max<u_int32_t>(1, limits.max_message_size / estimated_response_bytes_per_node));
+    }
+    return number_of_nodes;
+}
+
+} // namespace nodesetexporter::open62541::transport
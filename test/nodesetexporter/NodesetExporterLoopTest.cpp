@@ -9,6 +9,9 @@
 
 #include "nodesetexporter/NodesetExporterLoop.h"
 #include "LogMacro.h"
+#include "nodesetexporter/common/Strings.h"
+#include "nodesetexporter/encoders/XMLEncoder.h"
+#include "nodesetexporter/open62541/AwaitableWrappers.h"
 #include "nodesetexporter/open62541/UATypesContainer.h"
 
 #include <open62541/types.h>
@@ -17,15 +20,22 @@
 #include <doctest/doctest.h>
 #include <doctest/trompeloeil.hpp>
 
+#include <algorithm>
 #include <random>
+#include <sstream>
+#include <stop_token>
+#include <tuple>
 #include <vector>
 
 using nodesetexporter::NodeIntermediateModel;
 using nodesetexporter::NodesetExporterLoop;
 using nodesetexporter::UATypesContainer;
 using nodesetexporter::VariantsOfAttr;
+using nodesetexporter::common::UaStringToStdString;
 using nodesetexporter::interfaces::IEncoder;
+using nodesetexporter::encoders::XMLEncoder;
 using nodesetexporter::interfaces::IOpen62541;
+using nodesetexporter::open62541::Open62541AwaitableWrapper;
 using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
 
 namespace
@@ -52,6 +62,7 @@ public:
     IMPLEMENT_MOCK0(End);
     IMPLEMENT_MOCK1(AddNamespaces);
     IMPLEMENT_MOCK1(AddAliases);
+    IMPLEMENT_MOCK0(MarkAsPartial);
     IMPLEMENT_MOCK1(AddNodeObject);
     IMPLEMENT_MOCK1(AddNodeObjectType);
     IMPLEMENT_MOCK1(AddNodeVariable);
@@ -1317,6 +1328,125 @@ TEST_SUITE("nodesetexporter")
             MESSAGE("Number of nodes: ", nodes_ids.size(), ", number of nodes to be exported under incoming classes: ", number_of_add_nodes_to_export);
         }
 
+        SUBCASE("The attribute profile excludes the attributes from the requests")
+        {
+            REQUIRE_CALL(open, ReadNodeClasses(_))
+                .WITH(_1.empty() == false)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                     : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(open, ReadNodesAttributes(_))
+                .WITH(_1.empty() == false)
+                .SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                  : _1) {
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_DESCRIPTION));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_WRITEMASK));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_USERWRITEMASK));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_USERACCESSLEVEL));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_HISTORIZING));
+                    CHECK(narr.attrs.contains(UA_ATTRIBUTEID_BROWSENAME));
+                    for (auto& attr : narr.attrs)
+                    {
+                        try
+                        {
+                            attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                        }
+                        catch (std::exception& exc)
+                        {
+                            MESSAGE(exc.what());
+                        }
+                    }
+                })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(open, ReadNodeReferences(_))
+                .WITH(_1.empty() == false)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                     : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(encoder, AddAliases(_)).WITH(_1.empty() == false).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+
+            NodesetExporterLoop exporter_loop(
+                std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+                open,
+                encoder,
+                logger,
+                {.is_perf_timer_enable = false,
+                 .ns0_custom_nodes_ready_to_work = false,
+                 .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+                 .parent_start_node_replacer = parent_start_node_replacer,
+                 .attribute_projection = {.profile = nodesetexporter::common::AttributeProfiles::NodesetMinimal, .custom_attributes = {}}});
+            auto status_result = StatusResults(StatusResults::Fail);
+            CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+            REQUIRE_EQ(number_of_valid_class_nodes_to_export, number_of_add_nodes_to_export);
+            CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+        }
+
+        SUBCASE("The custom attribute profile always keeps the attributes mandatory for NodeSet2")
+        {
+            REQUIRE_CALL(open, ReadNodeClasses(_))
+                .WITH(_1.empty() == false)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                     : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(open, ReadNodesAttributes(_))
+                .WITH(_1.empty() == false)
+                .SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                  : _1) {
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_DESCRIPTION));
+                    CHECK_FALSE(narr.attrs.contains(UA_ATTRIBUTEID_WRITEMASK));
+                    CHECK(narr.attrs.contains(UA_ATTRIBUTEID_BROWSENAME));
+                    CHECK(narr.attrs.contains(UA_ATTRIBUTEID_DISPLAYNAME)); // Not in the custom list
+                    for (auto& attr : narr.attrs)
+                    {
+                        try
+                        {
+                            attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                        }
+                        catch (std::exception& exc)
+                        {
+                            MESSAGE(exc.what());
+                        }
+                    }
+                })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(open, ReadNodeReferences(_))
+                .WITH(_1.empty() == false)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                     : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+
+            REQUIRE_CALL(encoder, AddAliases(_)).WITH(_1.empty() == false).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+
+            NodesetExporterLoop exporter_loop(
+                std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+                open,
+                encoder,
+                logger,
+                {.is_perf_timer_enable = false,
+                 .ns0_custom_nodes_ready_to_work = false,
+                 .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+                 .parent_start_node_replacer = parent_start_node_replacer,
+                 .attribute_projection = {.profile = nodesetexporter::common::AttributeProfiles::Custom, .custom_attributes = {UA_ATTRIBUTEID_VALUE}}});
+            auto status_result = StatusResults(StatusResults::Fail);
+            CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+            REQUIRE_EQ(number_of_valid_class_nodes_to_export, number_of_add_nodes_to_export);
+            CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+        }
+
         SUBCASE("Core test with a limit on a single data request")
         {
             REQUIRE_CALL(open, ReadNodeClasses(_))
@@ -1376,4 +1506,773 @@ TEST_SUITE("nodesetexporter")
             MESSAGE("Number of nodes: ", nodes_ids.size(), ", number of nodes to be exported under incoming classes: ", number_of_add_nodes_to_export);
         }
     }
-}
\ No newline at end of file
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - stop on request") // NOLINT
+    {
+        using trompeloeil::_;
+        trompeloeil::sequence seq;
+        std::stop_source stop_source;
+        size_t number_of_add_nodes_to_export = 0;
+
+        constexpr size_t namespace_array_size = 2;
+        auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+        namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+        namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+
+        // Two objects: ns=2;i=100 is tied to Objects, ns=2;i=101 is tied to ns=2;i=100.
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> nodes_ids;
+        std::map<UATypesContainer<UA_ExpandedNodeId>, NodeDescription> nodes_description;
+        for (const UA_UInt32 numeric_id : {100, 101})
+        {
+            nodes_ids.emplace_back(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID);
+            auto node_desc = std::make_unique<NodeDescription>();
+            node_desc->node_class = UA_NODECLASS_OBJECT;
+            node_desc->attributes.SetBrowseName(1, "vPLC" + std::to_string(numeric_id));
+            node_desc->attributes.SetDisplayName("en", "vPLC" + std::to_string(numeric_id));
+            node_desc->attributes.SetDescription("en", "Description vPLC" + std::to_string(numeric_id));
+            // Ref1 - Type
+            node_desc->references.SetNodeId("i=61");
+            node_desc->references.SetIsForward(true);
+            node_desc->references.SetReferenceTypeId("i=40");
+            node_desc->references.SetNodeClass(UA_NODECLASS_OBJECTTYPE);
+            node_desc->references.AddReferenceToVector();
+            // Ref2 - Reverse reference
+            node_desc->references.SetNodeId(numeric_id == 100 ? "i=85" : "ns=2;i=100");
+            node_desc->references.SetIsForward(false);
+            node_desc->references.SetReferenceTypeId(numeric_id == 100 ? "i=35" : "i=47");
+            node_desc->references.SetNodeClass(UA_NODECLASS_OBJECT);
+            node_desc->references.AddReferenceToVector();
+            nodes_description[nodes_ids.back()] = *node_desc;
+        }
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+
+        MockOpen62541 open(logger);
+        MockEncoder encoder(logger, "nodeset");
+
+        REQUIRE_CALL(encoder, Begin()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+        REQUIRE_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);)
+            .RETURN(StatusResults::Good)
+            .IN_SEQUENCE(seq);
+        REQUIRE_CALL(encoder, AddNamespaces(_)).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+
+        // The export is started inside each SUBCASE, since the expectations live until the end of its scope.
+        const auto start_export = [&]()
+        {
+            NodesetExporterLoop exporter_loop(
+                std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+                open,
+                encoder,
+                logger,
+                {.is_perf_timer_enable = false,
+                 .ns0_custom_nodes_ready_to_work = false,
+                 .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+                 .parent_start_node_replacer = parent_start_node_replacer,
+                 .stop_token = stop_source.get_token()});
+            exporter_loop.SetNumberOfMaxNodesToRequestData(1);
+            auto status_result = StatusResults(StatusResults::Good);
+            CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+            CHECK_EQ(status_result.GetStatus(), StatusResults::Fail);
+            CHECK_EQ(status_result.GetSubStatus(), StatusResults::Cancelled);
+        };
+
+        SUBCASE("The stop is requested before the export of the nodes")
+        {
+            stop_source.request_stop();
+            FORBID_CALL(open, ReadNodeClasses(_));
+            FORBID_CALL(encoder, AddNodeObject(_));
+            FORBID_CALL(encoder, AddAliases(_)); // Nothing was exported, there are no aliases.
+            REQUIRE_CALL(encoder, MarkAsPartial()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+
+            start_export();
+        }
+
+        SUBCASE("The stop is requested during the first batch, the batch is finished")
+        {
+            REQUIRE_CALL(open, ReadNodeClasses(_))
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                     : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+                .RETURN(StatusResults::Good)
+                .TIMES(2); // One node per batch
+            REQUIRE_CALL(open, ReadNodesAttributes(_))
+                .WITH(_1.size() == 1)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                     : _1) {
+                    for (auto& attr : narr.attrs)
+                    {
+                        attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                    }
+                })
+                .LR_SIDE_EFFECT(stop_source.request_stop())
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+            REQUIRE_CALL(open, ReadNodeReferences(_))
+                .WITH(_1.size() == 1)
+                .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                     : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, AddNodeObject(_))
+                .LR_WITH(_1.GetExpNodeId() == nodes_ids.at(0))
+                .LR_SIDE_EFFECT(number_of_add_nodes_to_export++)
+                .RETURN(StatusResults::Good)
+                .IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, MarkAsPartial()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, AddAliases(_)).WITH(_1.empty() == false).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+            REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good).IN_SEQUENCE(seq);
+
+            start_export();
+            // The second node was not exported, since its batch was not started.
+            CHECK_EQ(number_of_add_nodes_to_export, 1);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - type closure") // NOLINT
+    {
+        using trompeloeil::_;
+
+        constexpr size_t namespace_array_size = 2;
+        auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+        namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+        namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+
+        // The list contains only the object ns=2;i=100. Its types are outside the list:
+        // ns=2;i=100 --HasTypeDefinition--> ns=2;i=200 (ObjectType) --HasSubtype(inverse)--> ns=2;i=201 (ObjectType) --HasSubtype(inverse)--> i=58
+        // ns=2;i=200 --HasComponent--> ns=2;i=202 (Variable, instance declaration) with the DataType ns=2;i=300 --HasSubtype(inverse)--> i=29
+        std::map<UATypesContainer<UA_ExpandedNodeId>, NodeDescription> nodes_description;
+        const auto add_node = [&nodes_description](
+                                  UA_UInt32 numeric_id, UA_NodeClass node_class, const std::vector<std::tuple<std::string, std::string, bool, UA_NodeClass>>& refs)
+        {
+            NodeDescription node_desc;
+            node_desc.node_class = node_class;
+            node_desc.attributes.SetBrowseName(2, "Node" + std::to_string(numeric_id));
+            node_desc.attributes.SetDisplayName("en", "Node" + std::to_string(numeric_id));
+            for (const auto& [ref_type, target, is_forward, target_class] : refs)
+            {
+                node_desc.references.SetReferenceTypeId(ref_type);
+                node_desc.references.SetNodeId(target);
+                node_desc.references.SetIsForward(is_forward);
+                node_desc.references.SetNodeClass(target_class);
+                node_desc.references.AddReferenceToVector();
+            }
+            nodes_description[UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID)] = node_desc;
+        };
+        add_node(100, UA_NODECLASS_OBJECT, {{"i=40", "ns=2;i=200", true, UA_NODECLASS_OBJECTTYPE}, {"i=35", "i=85", false, UA_NODECLASS_OBJECT}});
+        add_node(200, UA_NODECLASS_OBJECTTYPE, {{"i=45", "ns=2;i=201", false, UA_NODECLASS_OBJECTTYPE}, {"i=47", "ns=2;i=202", true, UA_NODECLASS_VARIABLE}});
+        add_node(201, UA_NODECLASS_OBJECTTYPE, {{"i=45", "i=58", false, UA_NODECLASS_OBJECTTYPE}});
+        add_node(202, UA_NODECLASS_VARIABLE, {{"i=47", "ns=2;i=200", false, UA_NODECLASS_OBJECTTYPE}, {"i=40", "i=63", true, UA_NODECLASS_VARIABLETYPE}});
+        nodes_description.at(UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, 202), UA_TYPES_EXPANDEDNODEID)).attributes.SetDataType("ns=2;i=300");
+        add_node(300, UA_NODECLASS_DATATYPE, {{"i=45", "i=29", false, UA_NODECLASS_DATATYPE}});
+
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> nodes_ids{UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, 100), UA_TYPES_EXPANDEDNODEID)};
+        std::vector<UA_UInt32> exported_node_ids;
+        const auto add_exported = [&exported_node_ids](const NodeIntermediateModel& node_model)
+        {
+            exported_node_ids.push_back(node_model.GetExpNodeId().GetRef().nodeId.identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
+        };
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+
+        MockOpen62541 open(logger);
+        MockEncoder encoder(logger, "nodeset");
+
+        REQUIRE_CALL(encoder, Begin()).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);)
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNamespaces(_)).RETURN(StatusResults::Good);
+        // The classes of the list before the closure, then the classes of the two exported lists.
+        REQUIRE_CALL(open, ReadNodeClasses(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                 : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+            .RETURN(StatusResults::Good)
+            .TIMES(3);
+        // One Browse per depth of the closure: {100}, {200}, {201, 202}, {300}, then the two exported lists.
+        REQUIRE_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                 : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+            .RETURN(StatusResults::Good)
+            .TIMES(6);
+        // DataType of ns=2;i=202 and DataTypeDefinition of ns=2;i=300 during the closure, then the two exported lists.
+        REQUIRE_CALL(open, ReadNodesAttributes(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                 : _1) {
+                for (auto& attr : narr.attrs)
+                {
+                    attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                }
+            })
+            .RETURN(StatusResults::Good)
+            .TIMES(4);
+        REQUIRE_CALL(encoder, AddNodeDataType(_)).LR_SIDE_EFFECT(add_exported(_1)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNodeObjectType(_)).LR_SIDE_EFFECT(add_exported(_1)).RETURN(StatusResults::Good).TIMES(2);
+        REQUIRE_CALL(encoder, AddNodeVariable(_)).LR_SIDE_EFFECT(add_exported(_1)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNodeObject(_))
+            .LR_SIDE_EFFECT(add_exported(_1))
+            // The reference to the type of the closure is kept.
+            .LR_SIDE_EFFECT(CHECK(std::any_of(
+                _1.GetNodeReferences().begin(),
+                _1.GetNodeReferences().end(),
+                [](const UATypesContainer<UA_ReferenceDescription>& ref) { return ref.GetRef().nodeId.nodeId.namespaceIndex == 2; })))
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddAliases(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good);
+
+        NodesetExporterLoop exporter_loop(
+            std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+            open,
+            encoder,
+            logger,
+            {.is_perf_timer_enable = false,
+             .ns0_custom_nodes_ready_to_work = false,
+             .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+             .parent_start_node_replacer = parent_start_node_replacer,
+             .type_closure = true});
+        exporter_loop.SetNumberOfMaxNodesToRequestData(0);
+        auto status_result = StatusResults(StatusResults::Fail);
+        CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+        CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+        // The deeper rounds of the closure first, the list after the closure.
+        CHECK_EQ(exported_node_ids, std::vector<UA_UInt32>{300, 201, 202, 200, 100});
+    }
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - cross-list deduplication") // NOLINT
+    {
+        using trompeloeil::_;
+
+        constexpr size_t namespace_array_size = 2;
+        auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+        namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+        namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+
+        // The subtrees of the start nodes overlap:
+        // i=85 --Organizes--> ns=2;i=100 --HasComponent--> ns=2;i=101, ns=2;i=102
+        // i=85 --Organizes--> ns=2;i=110 --Organizes--> ns=2;i=101
+        // The start node ns=2;i=101 is in the subtree of ns=2;i=100.
+        std::map<UATypesContainer<UA_ExpandedNodeId>, NodeDescription> nodes_description;
+        const auto add_node = [&nodes_description](
+                                  UA_UInt32 numeric_id, UA_NodeClass node_class, const std::vector<std::tuple<std::string, std::string, bool, UA_NodeClass>>& refs)
+        {
+            NodeDescription node_desc;
+            node_desc.node_class = node_class;
+            node_desc.attributes.SetBrowseName(2, "Node" + std::to_string(numeric_id));
+            node_desc.attributes.SetDisplayName("en", "Node" + std::to_string(numeric_id));
+            if (node_class == UA_NODECLASS_VARIABLE)
+            {
+                node_desc.attributes.SetDataType("i=11");
+            }
+            for (const auto& [ref_type, target, is_forward, target_class] : refs)
+            {
+                node_desc.references.SetReferenceTypeId(ref_type);
+                node_desc.references.SetNodeId(target);
+                node_desc.references.SetIsForward(is_forward);
+                node_desc.references.SetNodeClass(target_class);
+                node_desc.references.AddReferenceToVector();
+            }
+            nodes_description[UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID)] = node_desc;
+        };
+        add_node(
+            100,
+            UA_NODECLASS_OBJECT,
+            {{"i=35", "i=85", false, UA_NODECLASS_OBJECT},
+             {"i=40", "i=58", true, UA_NODECLASS_OBJECTTYPE},
+             {"i=47", "ns=2;i=101", true, UA_NODECLASS_VARIABLE},
+             {"i=47", "ns=2;i=102", true, UA_NODECLASS_VARIABLE}});
+        add_node(
+            101,
+            UA_NODECLASS_VARIABLE,
+            {{"i=47", "ns=2;i=100", false, UA_NODECLASS_OBJECT}, {"i=35", "ns=2;i=110", false, UA_NODECLASS_OBJECT}, {"i=40", "i=63", true, UA_NODECLASS_VARIABLETYPE}});
+        add_node(102, UA_NODECLASS_VARIABLE, {{"i=47", "ns=2;i=100", false, UA_NODECLASS_OBJECT}, {"i=40", "i=63", true, UA_NODECLASS_VARIABLETYPE}});
+        add_node(
+            110,
+            UA_NODECLASS_OBJECT,
+            {{"i=35", "i=85", false, UA_NODECLASS_OBJECT}, {"i=40", "i=58", true, UA_NODECLASS_OBJECTTYPE}, {"i=35", "ns=2;i=101", true, UA_NODECLASS_VARIABLE}});
+
+        const auto node_id = [](UA_UInt32 numeric_id)
+        {
+            return UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID);
+        };
+        std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>> node_ids{
+            {"ns=2;i=100", {node_id(100), node_id(101), node_id(102)}},
+            {"ns=2;i=101", {node_id(101)}},
+            {"ns=2;i=110", {node_id(110), node_id(101)}}};
+
+        const auto has_reference_to = [](const NodeIntermediateModel& node_model, UA_UInt32 numeric_id)
+        {
+            return std::any_of(
+                node_model.GetNodeReferences().begin(),
+                node_model.GetNodeReferences().end(),
+                [numeric_id](const UATypesContainer<UA_ReferenceDescription>& ref)
+                {
+                    return ref.GetRef().nodeId.nodeId.namespaceIndex == 2 && ref.GetRef().nodeId.nodeId.identifier.numeric == numeric_id; // NOLINT(cppcoreguidelines-pro-type-union-access)
+                });
+        };
+        std::vector<std::vector<UA_UInt32>> requested_node_ids;
+        std::vector<UA_UInt32> exported_node_ids;
+        const auto add_exported = [&exported_node_ids](const NodeIntermediateModel& node_model)
+        {
+            exported_node_ids.push_back(node_model.GetExpNodeId().GetRef().nodeId.identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
+        };
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+
+        MockOpen62541 open(logger);
+        MockEncoder encoder(logger, "nodeset");
+
+        REQUIRE_CALL(encoder, Begin()).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);)
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNamespaces(_)).RETURN(StatusResults::Good);
+        // The list of ns=2;i=101 is fully exported by the list of ns=2;i=100, so it is not requested at all.
+        REQUIRE_CALL(open, ReadNodeClasses(_))
+            .LR_SIDE_EFFECT(requested_node_ids.emplace_back())
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                 : _1) {
+                ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class;
+                requested_node_ids.back().push_back(ncs.exp_node_id.GetRef().nodeId.identifier.numeric); // NOLINT(cppcoreguidelines-pro-type-union-access)
+            })
+            .RETURN(StatusResults::Good)
+            .TIMES(2);
+        REQUIRE_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                 : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+            .RETURN(StatusResults::Good)
+            .TIMES(2);
+        REQUIRE_CALL(open, ReadNodesAttributes(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                 : _1) {
+                for (auto& attr : narr.attrs)
+                {
+                    attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                }
+            })
+            .RETURN(StatusResults::Good)
+            .TIMES(2);
+        REQUIRE_CALL(encoder, AddNodeObject(_)).LR_SIDE_EFFECT(add_exported(_1)).RETURN(StatusResults::Good).TIMES(2);
+        REQUIRE_CALL(encoder, AddNodeVariable(_))
+            .LR_SIDE_EFFECT(add_exported(_1))
+            // The reference to the start node of the other list is kept.
+            .LR_SIDE_EFFECT(if (_1.GetExpNodeId().GetRef().nodeId.identifier.numeric == 101) { CHECK(has_reference_to(_1, 110)); }) // NOLINT(cppcoreguidelines-pro-type-union-access)
+            .RETURN(StatusResults::Good)
+            .TIMES(2);
+        REQUIRE_CALL(encoder, AddAliases(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good);
+
+        NodesetExporterLoop exporter_loop(
+            node_ids,
+            open,
+            encoder,
+            logger,
+            {.is_perf_timer_enable = false,
+             .ns0_custom_nodes_ready_to_work = false,
+             .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+             .parent_start_node_replacer = parent_start_node_replacer,
+             .cross_list_deduplication = true});
+        exporter_loop.SetNumberOfMaxNodesToRequestData(0);
+        auto status_result = StatusResults(StatusResults::Fail);
+        CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+        CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+        // Each node is requested and exported once.
+        CHECK_EQ(requested_node_ids, std::vector<std::vector<UA_UInt32>>{{100, 101, 102}, {110}});
+        CHECK_EQ(exported_node_ids, std::vector<UA_UInt32>{100, 101, 102, 110});
+        CHECK_EQ(exporter_loop.GetNumberOfDeduplicatedNodes(), std::map<std::string, size_t>{{"ns=2;i=100", 0}, {"ns=2;i=101", 1}, {"ns=2;i=110", 1}});
+    }
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - values of the large arrays") // NOLINT
+    {
+        using trompeloeil::_;
+
+        constexpr size_t namespace_array_size = 2;
+        auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+        namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+        namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+
+        // i=85 --Organizes--> ns=2;i=100 --HasComponent--> ns=2;i=101 (the array of unknown length), ns=2;i=102 (the scalar)
+        std::map<UATypesContainer<UA_ExpandedNodeId>, NodeDescription> nodes_description;
+        const auto add_node = [&nodes_description](
+                                  UA_UInt32 numeric_id, UA_NodeClass node_class, const std::vector<std::tuple<std::string, std::string, bool, UA_NodeClass>>& refs)
+        {
+            NodeDescription node_desc;
+            node_desc.node_class = node_class;
+            node_desc.attributes.SetBrowseName(2, "Node" + std::to_string(numeric_id));
+            node_desc.attributes.SetDisplayName("en", "Node" + std::to_string(numeric_id));
+            for (const auto& [ref_type, target, is_forward, target_class] : refs)
+            {
+                node_desc.references.SetReferenceTypeId(ref_type);
+                node_desc.references.SetNodeId(target);
+                node_desc.references.SetIsForward(is_forward);
+                node_desc.references.SetNodeClass(target_class);
+                node_desc.references.AddReferenceToVector();
+            }
+            nodes_description[UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID)] = node_desc;
+        };
+        add_node(
+            100,
+            UA_NODECLASS_OBJECT,
+            {{"i=40", "i=58", true, UA_NODECLASS_OBJECTTYPE},
+             {"i=35", "i=85", false, UA_NODECLASS_OBJECT},
+             {"i=47", "ns=2;i=101", true, UA_NODECLASS_VARIABLE},
+             {"i=47", "ns=2;i=102", true, UA_NODECLASS_VARIABLE}});
+        for (const UA_UInt32 numeric_id : {101, 102})
+        {
+            add_node(numeric_id, UA_NODECLASS_VARIABLE, {{"i=47", "ns=2;i=100", false, UA_NODECLASS_OBJECT}, {"i=40", "i=63", true, UA_NODECLASS_VARIABLETYPE}});
+            auto& attributes = nodes_description.at(UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID)).attributes;
+            attributes.SetDataType("i=8");
+            attributes.SetValueScalar(42);
+            attributes.SetValueRank(numeric_id == 101 ? UA_VALUERANK_ONE_DIMENSION : UA_VALUERANK_SCALAR);
+            attributes.SetArrayDimmension(numeric_id == 101 ? std::vector<uint32_t>{0} : std::vector<uint32_t>{});
+        }
+
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> nodes_ids;
+        for (const UA_UInt32 numeric_id : {100, 101, 102})
+        {
+            nodes_ids.emplace_back(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID);
+        }
+        const auto set_attributes = [&nodes_description](std::vector<MockOpen62541::NodeAttributesRequestResponse>& nodes_attr_req_res)
+        {
+            for (auto& narr : nodes_attr_req_res)
+            {
+                for (auto& attr : narr.attrs)
+                {
+                    attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                }
+            }
+        };
+        const auto has_value = [](const MockOpen62541::NodeAttributesRequestResponse& narr) { return narr.attrs.contains(UA_ATTRIBUTEID_VALUE); };
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+
+        MockOpen62541 open(logger);
+        MockEncoder encoder(logger, "nodeset");
+
+        REQUIRE_CALL(encoder, Begin()).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);)
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNamespaces(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeClasses(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                 : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+            .RETURN(StatusResults::Good);
+        // The attributes are requested without the values, then only the value of the scalar is requested.
+        REQUIRE_CALL(open, ReadNodesAttributes(_))
+            .LR_WITH(_1.size() == 3 && std::none_of(_1.begin(), _1.end(), has_value))
+            .LR_SIDE_EFFECT(set_attributes(_1))
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodesAttributes(_))
+            .LR_WITH(_1.size() == 1 && _1.at(0).exp_node_id == nodes_ids.at(2) && has_value(_1.at(0)))
+            .LR_SIDE_EFFECT(set_attributes(_1))
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                 : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNodeObject(_)).RETURN(StatusResults::Good);
+        // The array gets the reader of the parts instead of the value, the scalar gets the value.
+        REQUIRE_CALL(encoder, AddNodeVariable(_))
+            .LR_SIDE_EFFECT(
+                const bool is_array = _1.GetExpNodeId() == nodes_ids.at(1);
+                CHECK_EQ(static_cast<bool>(_1.GetValueChunkReader()), is_array);
+                CHECK_NE(_1.GetAttributes().contains(UA_ATTRIBUTEID_VALUE), is_array);)
+            .RETURN(StatusResults::Good)
+            .TIMES(2);
+        REQUIRE_CALL(encoder, AddAliases(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good);
+
+        NodesetExporterLoop exporter_loop(
+            std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+            open,
+            encoder,
+            logger,
+            {.is_perf_timer_enable = false,
+             .ns0_custom_nodes_ready_to_work = false,
+             .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+             .parent_start_node_replacer = parent_start_node_replacer});
+        exporter_loop.SetNumberOfMaxNodesToRequestData(0);
+        exporter_loop.SetNumberOfMaxArrayElementsToRequestData(10);
+        auto status_result = StatusResults(StatusResults::Fail);
+
+        SUBCASE("The sequential engine")
+        {
+            CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+        }
+
+        SUBCASE("The coroutine engine")
+        {
+            Open62541AwaitableWrapper async_open(open, logger, 1);
+            CHECK_NOTHROW(status_result = exporter_loop.StartCoroutineExport(async_open, 1));
+        }
+
+        CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+    }
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - definitions from the dictionary with both engines") // NOLINT
+    {
+        using trompeloeil::_;
+
+        // The server does not return DataTypeDefinition (Open62541 1.3), the structures are described in the dictionary ns=2;i=200:
+        // ns=2;i=100 (MotorData) --HasEncoding--> ns=2;i=101 --HasDescription--> ns=2;i=102 <--HasComponent-- ns=2;i=200
+        // ns=2;i=110 (MotorLimits) --HasEncoding--> ns=2;i=111 --HasDescription--> ns=2;i=112 <--HasComponent-- ns=2;i=200
+        constexpr auto type_dictionary = R"(<?xml version="1.0" encoding="utf-8"?>
+<opc:TypeDictionary xmlns:opc="http://opcfoundation.org/BinarySchema/" xmlns:ua="http://opcfoundation.org/UA/" xmlns:tns="urn:test:types"
+  DefaultByteOrder="LittleEndian" TargetNamespace="urn:test:types">
+  <opc:Import Namespace="http://opcfoundation.org/UA/"/>
+  <opc:StructuredType Name="MotorLimits" BaseType="ua:ExtensionObject">
+    <opc:Field Name="Min" TypeName="opc:Double"/>
+    <opc:Field Name="Max" TypeName="opc:Double"/>
+  </opc:StructuredType>
+  <opc:StructuredType Name="MotorData" BaseType="ua:ExtensionObject">
+    <opc:Field Name="Speed" TypeName="opc:Float"/>
+    <opc:Field Name="Limits" TypeName="tns:MotorLimits"/>
+  </opc:StructuredType>
+</opc:TypeDictionary>)";
+
+        const auto make_node_id = [](UA_UInt32 numeric_id)
+        {
+            return UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, numeric_id), UA_TYPES_EXPANDEDNODEID);
+        };
+        std::map<UATypesContainer<UA_ExpandedNodeId>, NodeDescription> nodes_description;
+        const auto add_node = [&nodes_description, &make_node_id](
+                                  UA_UInt32 numeric_id,
+                                  UA_NodeClass node_class,
+                                  const std::string& browse_name,
+                                  const std::vector<std::tuple<std::string, std::string, bool, UA_NodeClass, std::string>>& refs)
+        {
+            NodeDescription node_desc;
+            node_desc.node_class = node_class;
+            node_desc.attributes.SetBrowseName(2, browse_name);
+            node_desc.attributes.SetDisplayName("en", browse_name);
+            node_desc.attributes.SetIsAbstract(false);
+            for (const auto& [ref_type, target, is_forward, target_class, target_browse_name] : refs)
+            {
+                node_desc.references.SetReferenceTypeId(ref_type);
+                node_desc.references.SetNodeId(target);
+                node_desc.references.SetIsForward(is_forward);
+                node_desc.references.SetNodeClass(target_class);
+                node_desc.references.SetBrowseName(2, target_browse_name);
+                node_desc.references.AddReferenceToVector();
+            }
+            nodes_description[make_node_id(numeric_id)] = node_desc;
+        };
+        // The exported list
+        add_node(1, UA_NODECLASS_OBJECT, "Motors", {{"i=40", "i=61", true, UA_NODECLASS_OBJECTTYPE, "FolderType"}, {"i=35", "i=85", false, UA_NODECLASS_OBJECT, "Objects"}});
+        add_node(
+            100,
+            UA_NODECLASS_DATATYPE,
+            "MotorData",
+            {{"i=45", "i=22", false, UA_NODECLASS_DATATYPE, "Structure"}, {"i=38", "ns=2;i=101", true, UA_NODECLASS_OBJECT, "Default Binary"}});
+        add_node(
+            110,
+            UA_NODECLASS_DATATYPE,
+            "MotorLimits",
+            {{"i=45", "i=22", false, UA_NODECLASS_DATATYPE, "Structure"}, {"i=38", "ns=2;i=111", true, UA_NODECLASS_OBJECT, "Default Binary"}});
+        // The dictionary
+        for (const auto& [encoding_id, data_type_name] : std::vector<std::pair<UA_UInt32, std::string>>{{101, "MotorData"}, {111, "MotorLimits"}})
+        {
+            add_node(
+                encoding_id,
+                UA_NODECLASS_OBJECT,
+                "Default Binary",
+                {{"i=38", "ns=2;i=" + std::to_string(encoding_id - 1), false, UA_NODECLASS_DATATYPE, data_type_name},
+                 {"i=39", "ns=2;i=" + std::to_string(encoding_id + 1), true, UA_NODECLASS_VARIABLE, data_type_name}});
+            add_node(
+                encoding_id + 1,
+                UA_NODECLASS_VARIABLE,
+                data_type_name,
+                {{"i=39", "ns=2;i=" + std::to_string(encoding_id), false, UA_NODECLASS_OBJECT, "Default Binary"},
+                 {"i=47", "ns=2;i=200", false, UA_NODECLASS_VARIABLE, "TestTypes"}});
+            // The value of the description is the name of the type in the dictionary.
+            nodes_description.at(make_node_id(encoding_id + 1)).attributes.SetValueScalar(data_type_name);
+        }
+        add_node(
+            200,
+            UA_NODECLASS_VARIABLE,
+            "TestTypes",
+            {{"i=47", "ns=2;i=102", true, UA_NODECLASS_VARIABLE, "MotorData"}, {"i=47", "ns=2;i=112", true, UA_NODECLASS_VARIABLE, "MotorLimits"}});
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+        MockOpen62541 open(logger);
+
+        ALLOW_CALL(open, ReadNodeClasses(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs
+                                 : _1) { ncs.node_class = nodes_description.at(ncs.exp_node_id).node_class; })
+            .RETURN(StatusResults::Good);
+        ALLOW_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr
+                                 : _1) { nrrr.references = nodes_description.at(nrrr.exp_node_id).references.GetReferences(); })
+            .RETURN(StatusResults::Good);
+        // DataTypeDefinition is not returned.
+        ALLOW_CALL(open, ReadNodesAttributes(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                 : _1) {
+                for (auto& attr : narr.attrs)
+                {
+                    if (attr.first != UA_ATTRIBUTEID_DATATYPEDEFINITION)
+                    {
+                        attr.second.emplace(nodes_description.at(narr.exp_node_id).attributes.GetWrappAttr(attr.first));
+                    }
+                }
+            })
+            .RETURN(StatusResults::Good);
+        size_t number_of_dictionary_reads = 0;
+        ALLOW_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(
+                if (_1 == make_node_id(200)) {
+                    ++number_of_dictionary_reads;
+                    UA_ByteString dictionary = UA_BYTESTRING(const_cast<char*>(type_dictionary)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                    UA_Variant_setScalarCopy(&_2.GetRef(), &dictionary, &UA_TYPES[UA_TYPES_BYTESTRING]);
+                } else {
+                    constexpr size_t namespace_array_size = 3;
+                    auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+                    namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+                    namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+                    namespace_array[2] = UA_String_fromChars("urn:test:types"); // NOLINT
+                    UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);
+                })
+            .RETURN(StatusResults::Good);
+
+        // One node per batch, so that the batches of the coroutine engine resolve the definitions simultaneously.
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> nodes_ids{make_node_id(1), make_node_id(100), make_node_id(110)};
+        const auto export_nodeset = [&](bool is_coroutine_engine)
+        {
+            std::stringstream out_buffer;
+            XMLEncoder encoder(logger, out_buffer);
+            NodesetExporterLoop exporter_loop(
+                std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{nodes_ids[0].ToString(), nodes_ids}},
+                open,
+                encoder,
+                logger,
+                {.is_perf_timer_enable = false,
+                 .ns0_custom_nodes_ready_to_work = false,
+                 .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+                 .parent_start_node_replacer = parent_start_node_replacer});
+            exporter_loop.SetNumberOfMaxNodesToRequestData(1);
+            auto status_result = StatusResults(StatusResults::Fail);
+            if (is_coroutine_engine)
+            {
+                Open62541AwaitableWrapper async_open(open, logger, 2);
+                CHECK_NOTHROW(status_result = exporter_loop.StartCoroutineExport(async_open, 2));
+            }
+            else
+            {
+                CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+            }
+            CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+            return out_buffer.str();
+        };
+
+        const auto sequential_nodeset = export_nodeset(false);
+        const auto coroutine_nodeset = export_nodeset(true);
+        // Each export requests the dictionary once.
+        CHECK_EQ(number_of_dictionary_reads, 2);
+        // Both structures have the definition.
+        const auto first_definition = sequential_nodeset.find("<Definition ");
+        REQUIRE_NE(first_definition, std::string::npos);
+        CHECK_NE(sequential_nodeset.find("<Definition ", first_definition + 1), std::string::npos);
+        CHECK_EQ(coroutine_nodeset, sequential_nodeset);
+    }
+
+    TEST_CASE("nodesetexporter::NodesetExporterLoop - localized texts in several locales") // NOLINT
+    {
+        using trompeloeil::_;
+
+        constexpr size_t namespace_array_size = 2;
+        auto* namespace_array = static_cast<UA_String*>(UA_Array_new(namespace_array_size, &UA_TYPES[UA_TYPES_STRING]));
+        namespace_array[0] = UA_String_fromChars("http://opcfoundation.org/UA/"); // NOLINT
+        namespace_array[1] = UA_String_fromChars("http://some_opc_server/UA/"); // NOLINT
+
+        // The server supporting the locale "mul" returns all translations of DisplayName in one value, Description has only one locale.
+        const auto node_id = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, 100), UA_TYPES_EXPANDEDNODEID);
+        NodeDescription node_desc;
+        node_desc.node_class = UA_NODECLASS_OBJECT;
+        node_desc.attributes.SetBrowseName(2, "Pump");
+        node_desc.attributes.SetDisplayName("mul", R"({"t":[["en","Pump"],["fr","Pompe"],["de","Pumpe"]]})");
+        node_desc.attributes.SetDescription("en", "The pump");
+        node_desc.references.SetReferenceTypeId("i=40");
+        node_desc.references.SetNodeId("i=58");
+        node_desc.references.SetIsForward(true);
+        node_desc.references.SetNodeClass(UA_NODECLASS_OBJECTTYPE);
+        node_desc.references.AddReferenceToVector();
+        node_desc.references.SetReferenceTypeId("i=35");
+        node_desc.references.SetNodeId("i=85");
+        node_desc.references.SetIsForward(false);
+        node_desc.references.SetNodeClass(UA_NODECLASS_OBJECT);
+        node_desc.references.AddReferenceToVector();
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+
+        MockOpen62541 open(logger);
+        MockEncoder encoder(logger, "nodeset");
+
+        REQUIRE_CALL(encoder, Begin()).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeDataValue(ANY(const UATypesContainer<UA_ExpandedNodeId>&), ANY(UATypesContainer<UA_Variant>&)))
+            .LR_SIDE_EFFECT(UA_Variant_setArray(&_2.GetRef(), namespace_array, namespace_array_size, &UA_TYPES[UA_TYPES_STRING]);)
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddNamespaces(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeClasses(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeClassesRequestResponse& ncs : _1) { ncs.node_class = node_desc.node_class; })
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodesAttributes(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeAttributesRequestResponse& narr
+                                 : _1) {
+                for (auto& attr : narr.attrs)
+                {
+                    attr.second.emplace(node_desc.attributes.GetWrappAttr(attr.first));
+                }
+            })
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(for (MockOpen62541::NodeReferencesRequestResponse& nrrr : _1) { nrrr.references = node_desc.references.GetReferences(); })
+            .RETURN(StatusResults::Good);
+        std::vector<std::pair<std::string, std::string>> display_names;
+        std::pair<std::string, std::string> main_display_name;
+        std::pair<std::string, std::string> description;
+        size_t number_of_descriptions = 0;
+        const auto text_of = [](const std::optional<VariantsOfAttr>& attr)
+        {
+            const auto& text = std::get<UATypesContainer<UA_LocalizedText>>(attr.value()).GetRef();
+            return std::make_pair(UaStringToStdString(text.locale), UaStringToStdString(text.text));
+        };
+        REQUIRE_CALL(encoder, AddNodeObject(_))
+            .LR_SIDE_EFFECT(main_display_name = text_of(_1.GetAttributes().at(UA_ATTRIBUTEID_DISPLAYNAME)))
+            .LR_SIDE_EFFECT(description = text_of(_1.GetAttributes().at(UA_ATTRIBUTEID_DESCRIPTION)))
+            .LR_SIDE_EFFECT(for (const auto& text
+                                 : _1.GetLocalizedTexts(UA_ATTRIBUTEID_DISPLAYNAME)) {
+                display_names.emplace_back(UaStringToStdString(text.GetRef().locale), UaStringToStdString(text.GetRef().text));
+            })
+            .LR_SIDE_EFFECT(number_of_descriptions = _1.GetLocalizedTexts(UA_ATTRIBUTEID_DESCRIPTION).size())
+            .RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, AddAliases(_)).RETURN(StatusResults::Good);
+        REQUIRE_CALL(encoder, End()).RETURN(StatusResults::Good);
+
+        NodesetExporterLoop exporter_loop(
+            std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>>{{node_id.ToString(), {node_id}}},
+            open,
+            encoder,
+            logger,
+            {.is_perf_timer_enable = false,
+             .ns0_custom_nodes_ready_to_work = false,
+             .flat_list_of_nodes = {.is_enable = false, .create_missing_start_node = false, .allow_abstract_variable = false},
+             .parent_start_node_replacer = parent_start_node_replacer,
+             .locales = {"de", "en"}});
+        exporter_loop.SetNumberOfMaxNodesToRequestData(0);
+        auto status_result = StatusResults(StatusResults::Fail);
+        CHECK_NOTHROW(status_result = exporter_loop.StartExport());
+        CHECK_EQ(status_result.GetStatus(), StatusResults::Good);
+
+        // The texts of the export locales in their order, the first one is the main text. The text of the other locale is left as is.
+        CHECK_EQ(main_display_name, std::make_pair(std::string("de"), std::string("Pumpe")));
+        CHECK_EQ(display_names, std::vector<std::pair<std::string, std::string>>{{"de", "Pumpe"}, {"en", "Pump"}});
+        CHECK_EQ(description, std::make_pair(std::string("en"), std::string("The pump")));
+        CHECK_EQ(number_of_descriptions, 0);
+    }
+}
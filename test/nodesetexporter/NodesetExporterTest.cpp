@@ -10,7 +10,10 @@
 #include "LogMacro.h"
 #include "XmlHelperFunctions.h"
 #include "nodesetexporter/logger/LogPlugin.h"
+#include "nodesetexporter/common/PerformanceTimer.h"
 #include "nodesetexporter/open62541/BrowseOperations.h"
+#include "nodesetexporter/open62541/ClientWrappers.h"
+#include "nodesetexporter/open62541/RoundTripVerifier.h"
 #include "nodesetexporter/open62541/UATypesContainer.h"
 
 #include "ex_nodeset.h"
@@ -32,6 +35,9 @@ TEST_LOGGER_INIT
 using LoggerPlugin = nodesetexporter::logger::Open62541LogPlugin;
 using LogLevel = nodesetexporter::common::LogLevel;
 using nodesetexporter::ExportNodesetFromClient;
+using nodesetexporter::common::PerformanceTimer;
+using nodesetexporter::open62541::Open62541ClientWrapper;
+using nodesetexporter::open62541::RoundTripVerifier;
 using nodesetexporter::open62541::UATypesContainer;
 using nodesetexporter::open62541::browseoperations::GrabChildNodeIdsFromStartNodeId;
 using namespace std::literals;
@@ -1206,6 +1212,21 @@ TEST_SUITE("nodesetexporter")
                         // Since there are a lot of elements to compare, I use the function
                         CheckElements(namespaces, aliases, parser);
                     }
+
+                    SUBCASE("Coroutine engine gives the same output as the sequential one")
+                    {
+                        for (const u_int32_t number_of_max_nodes_to_request_data : {0U, 2U, 6U})
+                        {
+                            opt.number_of_max_nodes_to_request_data = number_of_max_nodes_to_request_data;
+                            std::stringstream sequential_buffer;
+                            opt.coroutine_engine = {.is_enable = false, .max_batches_in_flight = 0};
+                            CHECK_NOTHROW(ExportNodesetFromClient(*client, node_id_list_from_start_nodes, "", sequential_buffer, opt));
+                            std::stringstream coroutine_buffer;
+                            opt.coroutine_engine = {.is_enable = true, .max_batches_in_flight = 3};
+                            CHECK_NOTHROW(ExportNodesetFromClient(*client, node_id_list_from_start_nodes, "", coroutine_buffer, opt));
+                            CHECK_EQ(sequential_buffer.str(), coroutine_buffer.str());
+                        }
+                    }
                 }
 
                 SUBCASE("Output to a file.")
@@ -2190,6 +2211,33 @@ TEST_SUITE("nodesetexporter")
             }
         }
 
+        SUBCASE("Round-trip verification: the unloading is loaded back and compared with the server node by node.")
+        {
+            auto perf_timer = PerformanceTimer();
+            const UATypesContainer<UA_ExpandedNodeId> start_node_id(UA_EXPANDEDNODEID("ns=3;i=100"), UA_TYPES_EXPANDEDNODEID);
+            GrabChildNodeIdsFromStartNodeId(client, start_node_id, node_id_list);
+            const auto verified_node_ids = node_id_list;
+            std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>> node_id_list_from_start_nodes{{node_id_list[0].ToString(), std::move(node_id_list)}};
+            REQUIRE_EQ(ExportNodesetFromClient(*client, node_id_list_from_start_nodes, "", out_test_buffer, opt).GetStatus(), nodesetexporter::StatusResults::Good);
+            const auto export_time = perf_timer.GetTimeElapsed();
+
+            Open62541ClientWrapper client_wrapper(*client, nodesetexporter_logger);
+            RoundTripVerifier verifier(client_wrapper, nodesetexporter_logger);
+            verifier.AddPhaseTiming("export", export_time);
+            REQUIRE_EQ(verifier.VerifyDocument(out_test_buffer.str(), verified_node_ids).GetStatus(), nodesetexporter::StatusResults::Good);
+            for (const auto& mismatch : verifier.GetMismatches())
+            {
+                MESSAGE(mismatch.node_id, ": ", mismatch.description);
+            }
+            for (const auto& timing : verifier.GetPhaseTimings())
+            {
+                MESSAGE(timing.phase, ": ", PerformanceTimer::TimeToString(timing.duration));
+            }
+            CHECK_EQ(verifier.GetNumberOfComparedNodes(), verified_node_ids.size());
+            // The transformations of the export made on purpose are also reported, so the mismatches are only displayed.
+            WARN_EQ(verifier.GetNumberOfMismatches(), 0);
+        }
+
         REQUIRE(UA_StatusCode_isGood(UA_Client_disconnect(client)));
         UA_Client_delete(client);
         running = false;
@@ -0,0 +1,64 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/common/ContentHash.h"
+
+#include <doctest/doctest.h>
+
+#include <string>
+
+using ContentHash = nodesetexporter::common::ContentHash;
+
+TEST_SUITE("nodesetexporter::common")
+{
+    TEST_CASE("nodesetexporter::common::ContentHash")
+    {
+        SUBCASE("Reference values of XXH64")
+        {
+            const auto hash_of = [](const std::string& text)
+            {
+                ContentHash hash;
+                hash.Update(text.data(), text.size());
+                return hash.HexDigest();
+            };
+            CHECK_EQ(hash_of(""), "ef46db3751d8e999");
+            CHECK_EQ(hash_of("a"), "d24ec4f1a98c6e5b");
+            CHECK_EQ(hash_of("abc"), "44bc2cf5ad770999");
+        }
+
+        SUBCASE("The result does not depend on the division of the content into the parts")
+        {
+            std::string content;
+            for (size_t index = 0; index < 1000; ++index) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            {
+                content.push_back(static_cast<char>(index * 7)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+            ContentHash whole;
+            whole.Update(content.data(), content.size());
+
+            ContentHash by_parts;
+            for (size_t offset = 0, part = 1; offset < content.size(); offset += part, part = part % 13 + 1) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            {
+                by_parts.Update(content.data() + offset, std::min(part, content.size() - offset)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            CHECK_EQ(whole.Digest(), by_parts.Digest());
+
+            ContentHash by_symbols;
+            for (const auto symbol : content)
+            {
+                by_symbols.Update(symbol);
+            }
+            CHECK_EQ(whole.Digest(), by_symbols.Digest());
+
+            content.back() ^= 1;
+            ContentHash changed;
+            changed.Update(content.data(), content.size());
+            CHECK_NE(whole.Digest(), changed.Digest());
+        }
+    }
+}
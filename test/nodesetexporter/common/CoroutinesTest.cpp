@@ -0,0 +1,180 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/common/Coroutines.h"
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using nodesetexporter::common::coroutines::OrderedTurns;
+using nodesetexporter::common::coroutines::SyncWait;
+using nodesetexporter::common::coroutines::Task;
+using nodesetexporter::common::coroutines::WhenAllBounded;
+
+namespace
+{
+
+/**
+ * @brief Resuming the awaiting coroutine in a separate thread after a delay, imitating the completion of a request.
+ */
+class ResumeInThread
+{
+public:
+    explicit ResumeInThread(std::chrono::milliseconds delay)
+        : m_delay(delay)
+    {
+    }
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) const
+    {
+        std::thread(
+            [awaiting, delay = m_delay]
+            {
+                std::this_thread::sleep_for(delay);
+                awaiting.resume();
+            })
+            .detach();
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    std::chrono::milliseconds m_delay;
+};
+
+Task<int> ReturnValue(int value)
+{
+    co_return value;
+}
+
+Task<int> ThrowError()
+{
+    throw std::runtime_error("Task error");
+    co_return 0;
+}
+
+Task<int> AddValues(int first, int second)
+{
+    auto first_result = co_await ReturnValue(first);
+    auto second_result = co_await ReturnValue(second);
+    co_return first_result + second_result;
+}
+
+Task<int> CountRunning(int value, std::chrono::milliseconds delay, std::atomic_size_t& running, std::atomic_size_t& max_running)
+{
+    auto now_running = ++running;
+    auto prev_max = max_running.load();
+    while (now_running > prev_max && !max_running.compare_exchange_weak(prev_max, now_running))
+    {
+    }
+    co_await ResumeInThread(delay);
+    --running;
+    co_return value;
+}
+
+Task<int> PassTurn(OrderedTurns& turns, size_t turn, std::chrono::milliseconds delay, std::vector<size_t>& passed)
+{
+    co_await ResumeInThread(delay);
+    co_await turns.WaitTurn(turn);
+    passed.push_back(turn); // Protected by the order of turns
+    turns.NextTurn();
+    co_return static_cast<int>(turn);
+}
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::common")
+{
+    TEST_CASE("nodesetexporter::common::coroutines")
+    {
+        SUBCASE("Task and SyncWait")
+        {
+            CHECK_EQ(SyncWait(ReturnValue(5)), 5);
+            CHECK_EQ(SyncWait(AddValues(2, 3)), 5);
+            CHECK_THROWS_AS(SyncWait(ThrowError()), std::runtime_error);
+        }
+
+        SUBCASE("WhenAllBounded keeps the order of results and limits the running tasks")
+        {
+            constexpr size_t max_running_limit = 3;
+            std::atomic_size_t running = 0;
+            std::atomic_size_t max_running = 0;
+            std::vector<Task<int>> tasks;
+            for (int index = 0; index < 10; index++)
+            {
+                // The later tasks complete faster than the earlier ones.
+                tasks.push_back(CountRunning(index, std::chrono::milliseconds(20 - index), running, max_running));
+            }
+            auto results = SyncWait(
+                [](std::vector<Task<int>>&& tasks) -> Task<std::vector<int>>
+                {
+                    co_return co_await WhenAllBounded<int>(std::move(tasks), max_running_limit);
+                }(std::move(tasks)));
+            REQUIRE_EQ(results.size(), 10);
+            for (int index = 0; index < 10; index++)
+            {
+                CHECK_EQ(results.at(index), index);
+            }
+            CHECK_LE(max_running.load(), max_running_limit);
+            CHECK_EQ(running.load(), 0);
+        }
+
+        SUBCASE("WhenAllBounded with synchronous and failed tasks")
+        {
+            std::vector<Task<int>> tasks;
+            tasks.push_back(ReturnValue(1));
+            tasks.push_back(ThrowError());
+            tasks.push_back(ReturnValue(3));
+            CHECK_THROWS_AS(
+                SyncWait(
+                    [](std::vector<Task<int>>&& tasks) -> Task<std::vector<int>>
+                    {
+                        co_return co_await WhenAllBounded<int>(std::move(tasks), 1);
+                    }(std::move(tasks))),
+                std::runtime_error);
+
+            auto empty_results = SyncWait(
+                []() -> Task<std::vector<int>>
+                {
+                    co_return co_await WhenAllBounded<int>({}, 2);
+                }());
+            CHECK(empty_results.empty());
+        }
+
+        SUBCASE("OrderedTurns passes the section in the order of turns")
+        {
+            OrderedTurns turns;
+            std::vector<size_t> passed;
+            std::vector<Task<int>> tasks;
+            for (size_t index = 0; index < 6; index++)
+            {
+                // The later turns reach the section earlier.
+                tasks.push_back(PassTurn(turns, index, std::chrono::milliseconds(30 - 5 * index), passed));
+            }
+            auto results = SyncWait(
+                [](std::vector<Task<int>>&& tasks) -> Task<std::vector<int>>
+                {
+                    co_return co_await WhenAllBounded<int>(std::move(tasks), 6);
+                }(std::move(tasks)));
+            CHECK_EQ(results.size(), 6);
+            CHECK_EQ(passed, std::vector<size_t>{0, 1, 2, 3, 4, 5});
+        }
+    }
+}
@@ -0,0 +1,241 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/encoders/SplitEncoder.h"
+#include "LogMacro.h"
+#include "XmlHelperFunctions.h"
+#include "nodesetexporter/encoders/XMLEncoder.h"
+
+#include <open62541/types.h>
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using LogLevel = nodesetexporter::common::LogLevel;
+using SplitEncoder = ::nodesetexporter::encoders::SplitEncoder;
+using XMLEncoder = ::nodesetexporter::encoders::XMLEncoder;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
+using NodeIntermediateModel = nodesetexporter::open62541::NodeIntermediateModel;
+using ::nodesetexporter::open62541::UATypesContainer;
+using ::nodesetexporter::open62541::VariantsOfAttr;
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::encoders")
+{
+    TEST_CASE("nodesetexporter::encoders::SplitEncoder") // NOLINT
+    {
+        std::string log_message;
+        xmlpp::DomParser parser;
+        xmlpp::XsdValidator valid("UANodeSet.xsd");
+        xmlpp::Attribute::NodeSet xml_nodes;
+
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+        std::stringstream types_buffer;
+        std::stringstream instances_buffer;
+        XMLEncoder types_encoder(logger, types_buffer);
+        XMLEncoder instances_encoder(logger, instances_buffer);
+
+        const std::vector<std::string> namespaces{"urn:types", "urn:instances"}; // ns=1, ns=2
+        const std::map<std::string, UATypesContainer<UA_NodeId>> aliases({{"HasSubtype", UATypesContainer<UA_NodeId>{UA_NODEID("i=45"), UA_TYPES_NODEID}}});
+
+        UA_ReferenceDescription ref_desc_has_subtype;
+        ref_desc_has_subtype.nodeId = UA_EXPANDEDNODEID("i=58");
+        ref_desc_has_subtype.displayName = UA_LOCALIZEDTEXT("", "BaseObjectType");
+        ref_desc_has_subtype.browseName = UA_QUALIFIEDNAME(0, "BaseObjectType");
+        ref_desc_has_subtype.typeDefinition = UA_EXPANDEDNODEID_NULL;
+        ref_desc_has_subtype.nodeClass = UA_NodeClass::UA_NODECLASS_OBJECTTYPE;
+        ref_desc_has_subtype.referenceTypeId = UA_NODEID("i=45"); // HasSubtype
+        ref_desc_has_subtype.isForward = false;
+
+        UA_ReferenceDescription ref_desc_has_type_def;
+        ref_desc_has_type_def.nodeId = UA_EXPANDEDNODEID("ns=1;i=1000");
+        ref_desc_has_type_def.displayName = UA_LOCALIZEDTEXT("", "DeviceType");
+        ref_desc_has_type_def.browseName = UA_QUALIFIEDNAME(1, "DeviceType");
+        ref_desc_has_type_def.typeDefinition = UA_EXPANDEDNODEID_NULL;
+        ref_desc_has_type_def.nodeClass = UA_NodeClass::UA_NODECLASS_OBJECTTYPE;
+        ref_desc_has_type_def.referenceTypeId = UA_NODEID("i=40"); // HasTypeDefinition
+        ref_desc_has_type_def.isForward = true;
+
+        NodeIntermediateModel nim_object_type;
+        nim_object_type.SetExpNodeId(UA_EXPANDEDNODEID("ns=1;i=1000"));
+        nim_object_type.SetNodeReferences({&ref_desc_has_subtype});
+        nim_object_type.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECTTYPE);
+        nim_object_type.SetAttributes(
+            {{UA_ATTRIBUTEID_BROWSENAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(1, "DeviceType"), UA_TYPES_QUALIFIEDNAME)}},
+             {UA_ATTRIBUTEID_DISPLAYNAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT("", "DeviceType"), UA_TYPES_LOCALIZEDTEXT)}}});
+
+        NodeIntermediateModel nim_object;
+        nim_object.SetExpNodeId(UA_EXPANDEDNODEID("ns=2;i=1"));
+        nim_object.SetNodeReferences({&ref_desc_has_type_def});
+        nim_object.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECT);
+        nim_object.SetParentNodeId(UA_EXPANDEDNODEID("i=85"));
+        nim_object.SetAttributes(
+            {{UA_ATTRIBUTEID_BROWSENAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(2, "Device1"), UA_TYPES_QUALIFIEDNAME)}},
+             {UA_ATTRIBUTEID_DISPLAYNAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT("", "Device1"), UA_TYPES_LOCALIZEDTEXT)}}});
+
+        const auto export_nodes = [&](SplitEncoder& split_encoder)
+        {
+            CHECK_EQ(split_encoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObjectType(nim_object_type).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObject(nim_object).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.End().GetStatus(), StatusResults::Good);
+            MESSAGE(types_buffer.str());
+            MESSAGE(instances_buffer.str());
+        };
+
+        SUBCASE("The nodes are routed by the node class, the instances require the model of the types")
+        {
+            SplitEncoder split_encoder(logger, types_encoder, instances_encoder);
+            export_nodes(split_encoder);
+
+            // The document of the types
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:UAObjectType", parser, valid, types_buffer));
+            CHECK_EQ(xml_nodes.size(), 1);
+            CHECK_EQ(GetFindXMLNode("//xmlns:UAObject", parser).size(), 0);
+            CHECK_EQ(GetFindXMLNode("//xmlns:NamespaceUris/xmlns:Uri", parser).size(), namespaces.size());
+            CHECK_EQ(GetFindXMLNode("//xmlns:Aliases/xmlns:Alias", parser).size(), aliases.size());
+            xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model", parser);
+            REQUIRE_EQ(xml_nodes.size(), 1);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Model", "", std::map<std::string, std::string>({{"ModelUri", "urn:types"}})));
+            CHECK_EQ(GetFindXMLNode("//xmlns:Models/xmlns:Model/xmlns:RequiredModel", parser).size(), 1);
+
+            // The document of the instances
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:UAObject", parser, valid, instances_buffer));
+            CHECK_EQ(xml_nodes.size(), 1);
+            CHECK_EQ(GetFindXMLNode("//xmlns:UAObjectType", parser).size(), 0);
+            CHECK_EQ(GetFindXMLNode("//xmlns:NamespaceUris/xmlns:Uri", parser).size(), namespaces.size());
+            CHECK_EQ(GetFindXMLNode("//xmlns:Aliases/xmlns:Alias", parser).size(), aliases.size());
+            xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model", parser);
+            REQUIRE_EQ(xml_nodes.size(), 1);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Model", "", std::map<std::string, std::string>({{"ModelUri", "urn:instances"}})));
+            xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model/xmlns:RequiredModel", parser);
+            REQUIRE_EQ(xml_nodes.size(), 2);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "RequiredModel", "", std::map<std::string, std::string>({{"ModelUri", "urn:types"}})));
+            MESSAGE(log_message);
+        }
+
+        SUBCASE("The model URIs are set explicitly")
+        {
+            SplitEncoder split_encoder(logger, types_encoder, instances_encoder, "urn:my_types", "urn:my_instances");
+            export_nodes(split_encoder);
+
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model/xmlns:RequiredModel", parser, valid, instances_buffer));
+            REQUIRE_EQ(xml_nodes.size(), 2);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "RequiredModel", "", std::map<std::string, std::string>({{"ModelUri", "urn:my_types"}})));
+            MESSAGE(log_message);
+        }
+
+        SUBCASE("The instance declarations are written to the document of the types")
+        {
+            // ns=1;i=1000 (ObjectType) --HasComponent--> ns=1;i=1001 (Variable with a modelling rule) --HasProperty--> ns=1;i=1002 (Variable)
+            UA_ReferenceDescription ref_desc_parent_type;
+            UA_ReferenceDescription_init(&ref_desc_parent_type);
+            ref_desc_parent_type.nodeId = UA_EXPANDEDNODEID("ns=1;i=1000");
+            ref_desc_parent_type.browseName = UA_QUALIFIEDNAME(1, "DeviceType");
+            ref_desc_parent_type.nodeClass = UA_NodeClass::UA_NODECLASS_OBJECTTYPE;
+            ref_desc_parent_type.referenceTypeId = UA_NODEID("i=47"); // HasComponent
+            ref_desc_parent_type.isForward = false;
+            UA_ReferenceDescription ref_desc_modelling_rule;
+            UA_ReferenceDescription_init(&ref_desc_modelling_rule);
+            ref_desc_modelling_rule.nodeId = UA_EXPANDEDNODEID("i=78"); // Mandatory
+            ref_desc_modelling_rule.browseName = UA_QUALIFIEDNAME(0, "Mandatory");
+            ref_desc_modelling_rule.nodeClass = UA_NodeClass::UA_NODECLASS_OBJECT;
+            ref_desc_modelling_rule.referenceTypeId = UA_NODEID("i=37"); // HasModellingRule
+            ref_desc_modelling_rule.isForward = true;
+            UA_ReferenceDescription ref_desc_parent_variable;
+            UA_ReferenceDescription_init(&ref_desc_parent_variable);
+            ref_desc_parent_variable.nodeId = UA_EXPANDEDNODEID("ns=1;i=1001");
+            ref_desc_parent_variable.browseName = UA_QUALIFIEDNAME(1, "Speed");
+            ref_desc_parent_variable.nodeClass = UA_NodeClass::UA_NODECLASS_VARIABLE;
+            ref_desc_parent_variable.referenceTypeId = UA_NODEID("i=46"); // HasProperty
+            ref_desc_parent_variable.isForward = false;
+
+            const auto make_variable = [](const char* node_id, const char* parent_node_id, const char* name, const std::vector<UA_ReferenceDescription*>& references)
+            {
+                NodeIntermediateModel nim_variable;
+                nim_variable.SetExpNodeId(UA_EXPANDEDNODEID(node_id));
+                nim_variable.SetNodeReferences(references);
+                nim_variable.SetNodeClass(UA_NodeClass::UA_NODECLASS_VARIABLE);
+                nim_variable.SetParentNodeId(UA_EXPANDEDNODEID(parent_node_id));
+                nim_variable.SetAttributes(
+                    {{UA_ATTRIBUTEID_BROWSENAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(1, const_cast<char*>(name)), UA_TYPES_QUALIFIEDNAME)}}, // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                     {UA_ATTRIBUTEID_DISPLAYNAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT("", const_cast<char*>(name)), UA_TYPES_LOCALIZEDTEXT)}}}); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                return nim_variable;
+            };
+            const auto nim_declaration = make_variable("ns=1;i=1001", "ns=1;i=1000", "Speed", {&ref_desc_parent_type, &ref_desc_modelling_rule});
+            const auto nim_declaration_property = make_variable("ns=1;i=1002", "ns=1;i=1001", "EURange", {&ref_desc_parent_variable});
+
+            SplitEncoder split_encoder(logger, types_encoder, instances_encoder);
+            CHECK_EQ(split_encoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObjectType(nim_object_type).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeVariable(nim_declaration).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeVariable(nim_declaration_property).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObject(nim_object).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.End().GetStatus(), StatusResults::Good);
+            MESSAGE(types_buffer.str());
+            MESSAGE(instances_buffer.str());
+
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:UAVariable", parser, valid, types_buffer));
+            CHECK_EQ(xml_nodes.size(), 2);
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:UAVariable", parser, valid, instances_buffer));
+            CHECK_EQ(xml_nodes.size(), 0);
+            CHECK_EQ(GetFindXMLNode("//xmlns:UAObject", parser).size(), 1);
+        }
+
+        SUBCASE("The types and the instances in one namespace, the instances require the model of the types")
+        {
+            const std::vector<std::string> one_namespace{"urn:plant"}; // ns=1
+            NodeIntermediateModel nim_object_ns1;
+            nim_object_ns1.SetExpNodeId(UA_EXPANDEDNODEID("ns=1;i=1"));
+            nim_object_ns1.SetNodeReferences({&ref_desc_has_type_def});
+            nim_object_ns1.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECT);
+            nim_object_ns1.SetParentNodeId(UA_EXPANDEDNODEID("i=85"));
+            nim_object_ns1.SetAttributes(
+                {{UA_ATTRIBUTEID_BROWSENAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(1, "Device1"), UA_TYPES_QUALIFIEDNAME)}},
+                 {UA_ATTRIBUTEID_DISPLAYNAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT("", "Device1"), UA_TYPES_LOCALIZEDTEXT)}}});
+
+            SplitEncoder split_encoder(logger, types_encoder, instances_encoder);
+            CHECK_EQ(split_encoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNamespaces(one_namespace).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObjectType(nim_object_type).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddNodeObject(nim_object_ns1).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(split_encoder.End().GetStatus(), StatusResults::Good);
+
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model", parser, valid, types_buffer));
+            REQUIRE_EQ(xml_nodes.size(), 1);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Model", "", std::map<std::string, std::string>({{"ModelUri", "urn:plant"}})));
+
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model", parser, valid, instances_buffer));
+            REQUIRE_EQ(xml_nodes.size(), 1);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Model", "", std::map<std::string, std::string>({{"ModelUri", "urn:plant/Instances"}})));
+            xml_nodes = GetFindXMLNode("//xmlns:Models/xmlns:Model/xmlns:RequiredModel", parser);
+            REQUIRE_EQ(xml_nodes.size(), 2);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "RequiredModel", "", std::map<std::string, std::string>({{"ModelUri", "urn:plant"}})));
+            MESSAGE(log_message);
+        }
+
+        SUBCASE("The consumed attributes are asked from the encoder of the node class")
+        {
+            SplitEncoder split_encoder(logger, types_encoder, instances_encoder);
+            CHECK_EQ(split_encoder.GetConsumedAttributes(UA_NODECLASS_OBJECTTYPE), types_encoder.GetConsumedAttributes(UA_NODECLASS_OBJECTTYPE));
+            CHECK_EQ(split_encoder.GetConsumedAttributes(UA_NODECLASS_VARIABLE), instances_encoder.GetConsumedAttributes(UA_NODECLASS_VARIABLE));
+        }
+    }
+}
@@ -0,0 +1,181 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/encoders/ValidatingEncoder.h"
+#include "LogMacro.h"
+#include "nodesetexporter/encoders/XMLEncoder.h"
+
+#include <open62541/types.h>
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using LogLevel = nodesetexporter::common::LogLevel;
+using ValidatingEncoder = ::nodesetexporter::encoders::ValidatingEncoder;
+using XMLEncoder = ::nodesetexporter::encoders::XMLEncoder;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
+using NodeIntermediateModel = nodesetexporter::open62541::NodeIntermediateModel;
+using ::nodesetexporter::open62541::UATypesContainer;
+using ::nodesetexporter::open62541::VariantsOfAttr;
+
+UATypesContainer<UA_ReferenceDescription> MakeReference(const char* target, UA_UInt32 reference_type, bool is_forward)
+{
+    UATypesContainer<UA_ReferenceDescription> reference(UA_TYPES_REFERENCEDESCRIPTION);
+    const auto target_node_id = UA_EXPANDEDNODEID(target);
+    UA_ExpandedNodeId_copy(&target_node_id, &reference.GetRef().nodeId);
+    reference.GetRef().referenceTypeId = UA_NODEID_NUMERIC(0, reference_type);
+    reference.GetRef().isForward = is_forward;
+    return reference;
+}
+
+NodeIntermediateModel MakeNode(
+    const char* node_id,
+    UA_NodeClass node_class,
+    const char* parent_node_id,
+    std::vector<UATypesContainer<UA_ReferenceDescription>>&& references,
+    UA_UInt16 browse_name_ns = 1)
+{
+    NodeIntermediateModel node;
+    node.SetExpNodeId(UA_EXPANDEDNODEID(node_id));
+    node.SetNodeClass(node_class);
+    if (parent_node_id != nullptr)
+    {
+        node.SetParentNodeId(UA_EXPANDEDNODEID(parent_node_id));
+    }
+    node.SetNodeReferences(std::move(references));
+    std::map<UA_AttributeId, std::optional<VariantsOfAttr>> attributes{
+        {UA_ATTRIBUTEID_BROWSENAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_QualifiedName>(UA_QUALIFIEDNAME(browse_name_ns, const_cast<char*>(node_id)), UA_TYPES_QUALIFIEDNAME)}}, // NOLINT
+        {UA_ATTRIBUTEID_DISPLAYNAME, std::optional<VariantsOfAttr>{UATypesContainer<UA_LocalizedText>(UA_LOCALIZEDTEXT("", const_cast<char*>(node_id)), UA_TYPES_LOCALIZEDTEXT)}}}; // NOLINT
+    if (node_class == UA_NODECLASS_VARIABLE)
+    {
+        attributes.emplace(UA_ATTRIBUTEID_DATATYPE, std::optional<VariantsOfAttr>{UATypesContainer<UA_NodeId>(UA_NODEID("i=8"), UA_TYPES_NODEID)}); // Int64
+    }
+    node.SetAttributes(std::move(attributes));
+    return node;
+}
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::encoders")
+{
+    TEST_CASE("nodesetexporter::encoders::ValidatingEncoder") // NOLINT
+    {
+        Logger logger("test");
+        logger.SetLevel(LogLevel::Debug);
+        std::stringstream out_buffer;
+        XMLEncoder xml_encoder(logger, out_buffer);
+        ValidatingEncoder encoder(logger, xml_encoder);
+
+        const std::vector<std::string> namespaces{"urn:test"}; // ns=1
+        std::map<std::string, UATypesContainer<UA_NodeId>> aliases(
+            {{"Int64", UATypesContainer<UA_NodeId>{UA_NODEID("i=8"), UA_TYPES_NODEID}},
+             {"Organizes", UATypesContainer<UA_NodeId>{UA_NODEID("i=35"), UA_TYPES_NODEID}},
+             {"HasComponent", UATypesContainer<UA_NodeId>{UA_NODEID("i=47"), UA_TYPES_NODEID}},
+             {"HasTypeDefinition", UATypesContainer<UA_NodeId>{UA_NODEID("i=40"), UA_TYPES_NODEID}}});
+
+        auto object = MakeNode(
+            "ns=1;i=1",
+            UA_NODECLASS_OBJECT,
+            "i=85",
+            {MakeReference("i=85", UA_NS0ID_ORGANIZES, false), MakeReference("i=58", UA_NS0ID_HASTYPEDEFINITION, true), MakeReference("ns=1;i=2", UA_NS0ID_HASCOMPONENT, true)});
+        auto variable = MakeNode(
+            "ns=1;i=2",
+            UA_NODECLASS_VARIABLE,
+            "ns=1;i=1",
+            {MakeReference("ns=1;i=1", UA_NS0ID_HASCOMPONENT, false), MakeReference("i=63", UA_NS0ID_HASTYPEDEFINITION, true)});
+
+        const auto export_nodes = [&](const std::vector<const NodeIntermediateModel*>& nodes)
+        {
+            CHECK_EQ(encoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            for (const auto* const node : nodes)
+            {
+                if (node->GetNodeClass() == UA_NODECLASS_OBJECT)
+                {
+                    CHECK_EQ(encoder.AddNodeObject(*node).GetStatus(), StatusResults::Good);
+                }
+                else
+                {
+                    CHECK_EQ(encoder.AddNodeVariable(*node).GetStatus(), StatusResults::Good);
+                }
+            }
+            CHECK_EQ(encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            // The violations do not change the result of the wrapped encoder.
+            CHECK_EQ(encoder.End().GetStatus(), StatusResults::Good);
+            for (const auto& violation : encoder.GetViolations())
+            {
+                MESSAGE(violation.node_id, ": ", violation.description);
+            }
+        };
+
+        SUBCASE("The valid unloading, the reference target is exported after the node")
+        {
+            export_nodes({&object, &variable});
+            CHECK_EQ(encoder.GetNumberOfViolations(), 0);
+            CHECK_FALSE(out_buffer.str().empty());
+        }
+
+        SUBCASE("The reference target is not exported")
+        {
+            export_nodes({&object});
+            REQUIRE_EQ(encoder.GetNumberOfViolations(), 1);
+            CHECK_EQ(encoder.GetViolations().at(0).node_id, "ns=1;i=1");
+            CHECK_NE(encoder.GetViolations().at(0).description.find("ns=1;i=2"), std::string::npos);
+        }
+
+        SUBCASE("The NodeId is not unique")
+        {
+            export_nodes({&object, &variable, &variable});
+            REQUIRE_EQ(encoder.GetNumberOfViolations(), 1);
+            CHECK_EQ(encoder.GetViolations().at(0).node_id, "ns=1;i=2");
+            CHECK_NE(encoder.GetViolations().at(0).description.find("not unique"), std::string::npos);
+        }
+
+        SUBCASE("The alias is not defined")
+        {
+            aliases.erase("Int64");
+            export_nodes({&object, &variable});
+            REQUIRE_EQ(encoder.GetNumberOfViolations(), 1);
+            CHECK_NE(encoder.GetViolations().at(0).description.find("Int64"), std::string::npos);
+        }
+
+        SUBCASE("The namespace index is out of the range")
+        {
+            auto out_of_range = MakeNode("ns=1;i=3", UA_NODECLASS_OBJECT, "i=85", {MakeReference("i=85", UA_NS0ID_ORGANIZES, false)}, 2);
+            export_nodes({&object, &variable, &out_of_range});
+            REQUIRE_EQ(encoder.GetNumberOfViolations(), 1);
+            CHECK_EQ(encoder.GetViolations().at(0).node_id, "ns=1;i=3");
+            CHECK_NE(encoder.GetViolations().at(0).description.find("BrowseName"), std::string::npos);
+        }
+
+        SUBCASE("ParentNodeId has no inverse hierarchical reference")
+        {
+            auto orphan = MakeNode("ns=1;i=4", UA_NODECLASS_VARIABLE, "ns=1;i=1", {MakeReference("i=63", UA_NS0ID_HASTYPEDEFINITION, true)});
+            export_nodes({&object, &variable, &orphan});
+            REQUIRE_EQ(encoder.GetNumberOfViolations(), 1);
+            CHECK_EQ(encoder.GetViolations().at(0).node_id, "ns=1;i=4");
+            CHECK_NE(encoder.GetViolations().at(0).description.find("ParentNodeId"), std::string::npos);
+        }
+
+        SUBCASE("The missing reference targets of the partial unloading are not the violations")
+        {
+            CHECK_EQ(encoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.AddNodeObject(object).GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.MarkAsPartial().GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.End().GetStatus(), StatusResults::Good);
+            CHECK_EQ(encoder.GetNumberOfViolations(), 0);
+        }
+    }
+}
@@ -7,6 +7,7 @@
 //
 
 #include "nodesetexporter/encoders/XMLEncoder.h"
+#include "nodesetexporter/common/PerformanceTimer.h"
 #include "LogMacro.h"
 #include "XmlHelperFunctions.h"
 
@@ -15,6 +16,12 @@
 #include <doctest/doctest.h>
 #include <tinyxml2.h> // Used to generate XML.
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
 namespace
 {
 TEST_LOGGER_INIT
@@ -23,6 +30,7 @@ using LogLevel = nodesetexporter::common::LogLevel;
 using XMLEncoder = ::nodesetexporter::encoders::XMLEncoder;
 using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
 using NodeIntermediateModel = nodesetexporter::open62541::NodeIntermediateModel;
+using PerformanceTimer = nodesetexporter::common::PerformanceTimer;
 using ::nodesetexporter::open62541::UATypesContainer;
 using ::nodesetexporter::open62541::VariantsOfAttr;
 using tinyxml2::XMLDocument;
@@ -523,6 +531,238 @@ TEST_SUITE("nodesetexporter::encoders")
             }
         }
 
+        /*
+         * Partial export marker: a comment at the beginning of UANodeSet, the document must remain valid.
+         */
+        SUBCASE("MarkAsPartial()")
+        {
+            CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.MarkAsPartial().GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+            CHECK_EQ(xmlEncoder.MarkAsPartial().GetStatus(), StatusResults::Fail); // The second one must be unsuccessful.
+            CHECK_EQ(xmlEncoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+            MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+            const auto out_xml = out_test_buffer.str();
+            const auto comment_pos = out_xml.find("<!--PARTIAL EXPORT.");
+            CHECK_NE(comment_pos, std::string::npos);
+            CHECK_LT(comment_pos, out_xml.find("<NamespaceUris>")); // The marker is placed before the content
+
+            xpath = "//xmlns:UANodeSet"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+            MESSAGE("Nodes size = ", xml_nodes.size());
+            CHECK_EQ(xml_nodes.size(), 1);
+        }
+
+        /*
+         * Composition Attribute: ModelUri
+         * Composition of elements: Model, RequiredModel
+         */
+        SUBCASE("AddModels()")
+        {
+            const std::vector<XMLEncoder::ModelTableEntry> models{{namespaces.at(1), {"http://opcfoundation.org/UA/", namespaces.at(0)}}};
+            CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.AddModels(models).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+            CHECK_EQ(xmlEncoder.AddModels(models).GetStatus(), StatusResults::Fail); // The second one must be unsuccessful.
+            CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+            MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+            // Models is placed between NamespaceUris and Aliases even if the aliases were added before, otherwise the schema validation fails.
+            xpath = "//xmlns:Models/xmlns:Model"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+            MESSAGE("Nodes size = ", xml_nodes.size());
+            CHECK_EQ(xml_nodes.size(), 1);
+            if (!xml_nodes.empty())
+            {
+                CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Model", "", std::map<std::string, std::string>({{"ModelUri", namespaces.at(1)}})));
+                MESSAGE(log_message);
+                log_message.clear();
+            }
+
+            xpath = "//xmlns:Models/xmlns:Model/xmlns:RequiredModel"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+            MESSAGE("Nodes size = ", xml_nodes.size());
+            CHECK_EQ(xml_nodes.size(), 2);
+            if (xml_nodes.size() == 2)
+            {
+                CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "RequiredModel", "", std::map<std::string, std::string>({{"ModelUri", namespaces.at(0)}})));
+                MESSAGE(log_message);
+            }
+        }
+
+        /*
+         * The attributes written by the encoder: the attributes of the missing node classes are requested in full.
+         */
+        SUBCASE("GetConsumedAttributes()")
+        {
+            const auto variable_attrs = xmlEncoder.GetConsumedAttributes(UA_NODECLASS_VARIABLE);
+            REQUIRE(variable_attrs.has_value());
+            CHECK(variable_attrs->contains(UA_ATTRIBUTEID_BROWSENAME));
+            CHECK(variable_attrs->contains(UA_ATTRIBUTEID_DATATYPE));
+            CHECK(variable_attrs->contains(UA_ATTRIBUTEID_ACCESSLEVEL));
+            CHECK(variable_attrs->contains(UA_ATTRIBUTEID_VALUE));
+
+            const auto variable_type_attrs = xmlEncoder.GetConsumedAttributes(UA_NODECLASS_VARIABLETYPE);
+            REQUIRE(variable_type_attrs.has_value());
+            CHECK(variable_type_attrs->contains(UA_ATTRIBUTEID_ISABSTRACT));
+            CHECK(variable_type_attrs->contains(UA_ATTRIBUTEID_VALUE));
+
+            const auto data_type_attrs = xmlEncoder.GetConsumedAttributes(UA_NODECLASS_DATATYPE);
+            REQUIRE(data_type_attrs.has_value());
+            CHECK(data_type_attrs->contains(UA_ATTRIBUTEID_DATATYPEDEFINITION));
+
+            CHECK_FALSE(xmlEncoder.GetConsumedAttributes(UA_NODECLASS_METHOD).has_value());
+        }
+
+        /*
+         * The localized attributes are written in all locales of the model.
+         */
+        SUBCASE("AddNodeObject() with several locales")
+        {
+            NodeIntermediateModel nim_object_locales;
+            nim_object_locales.SetExpNodeId(UA_EXPANDEDNODEID("ns=1;i=1"));
+            nim_object_locales.SetNodeReferences({&ref_desc_organize, &ref_desc_has_type_def});
+            nim_object_locales.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECT);
+            nim_object_locales.SetParentNodeId(UA_EXPANDEDNODEID("i=85"));
+            nim_object_locales.SetAttributes(attrs_object);
+            std::vector<UATypesContainer<UA_LocalizedText>> display_names;
+            display_names.emplace_back(UA_LOCALIZEDTEXT("en", "vPLC1"), UA_TYPES_LOCALIZEDTEXT);
+            display_names.emplace_back(UA_LOCALIZEDTEXT("de", "SPS1"), UA_TYPES_LOCALIZEDTEXT);
+            nim_object_locales.SetLocalizedTexts(UA_ATTRIBUTEID_DISPLAYNAME, std::move(display_names));
+
+            CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.AddNodeObject(nim_object_locales).GetStatus(), StatusResults::Good);
+            CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+            MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+            xpath = "/xmlns:UANodeSet/xmlns:UAObject/xmlns:DisplayName"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+            REQUIRE_EQ(xml_nodes.size(), 2);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "DisplayName", "vPLC1", std::map<std::string, std::string>({{"Locale", "en"}})));
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "DisplayName", "SPS1", std::map<std::string, std::string>({{"Locale", "de"}})));
+
+            // The attribute without the locales of the model is written by its value.
+            xpath = "/xmlns:UANodeSet/xmlns:UAObject/xmlns:Description"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+            REQUIRE_EQ(xml_nodes.size(), 1);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Description", "Description vPLC1"));
+            MESSAGE(log_message);
+        }
+
+        /*
+         * The canonical output does not depend on the order of adding the nodes and the references.
+         */
+        SUBCASE("SetCanonicalOutput()")
+        {
+            const auto encode = [&](XMLEncoder& encoder, const std::vector<const NodeIntermediateModel*>& nodes)
+            {
+                encoder.SetCanonicalOutput(true);
+                CHECK_EQ(encoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+                for (const auto* const node : nodes)
+                {
+                    if (node->GetNodeClass() == UA_NODECLASS_OBJECTTYPE)
+                    {
+                        CHECK_EQ(encoder.AddNodeObjectType(*node).GetStatus(), StatusResults::Good);
+                    }
+                    else if (node->GetNodeClass() == UA_NODECLASS_OBJECT)
+                    {
+                        CHECK_EQ(encoder.AddNodeObject(*node).GetStatus(), StatusResults::Good);
+                    }
+                    else
+                    {
+                        CHECK_EQ(encoder.AddNodeVariable(*node).GetStatus(), StatusResults::Good);
+                    }
+                }
+                CHECK_EQ(encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+                CHECK_EQ(encoder.End().GetStatus(), StatusResults::Good);
+            };
+
+            CHECK_FALSE(xmlEncoder.GetContentHash().has_value());
+            encode(xmlEncoder, {&nim_object_type, &nim_variable_scalar, &nim_object});
+            MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+            // The same nodes in another order and with the references in another order.
+            NodeIntermediateModel nim_object_reordered;
+            nim_object_reordered.SetExpNodeId(UA_EXPANDEDNODEID("ns=1;i=1"));
+            nim_object_reordered.SetNodeReferences({&ref_desc_has_property, &ref_desc_has_component, &ref_desc_has_type_def, &ref_desc_organize});
+            nim_object_reordered.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECT);
+            nim_object_reordered.SetParentNodeId(UA_EXPANDEDNODEID("i=85"));
+            nim_object_reordered.SetAttributes(attrs_object);
+            std::stringstream reordered_buffer;
+            XMLEncoder reordered_encoder(logger, reordered_buffer);
+            encode(reordered_encoder, {&nim_object_reordered, &nim_object_type, &nim_variable_scalar});
+
+            CHECK_EQ(out_test_buffer.str(), reordered_buffer.str());
+            REQUIRE(xmlEncoder.GetContentHash().has_value());
+            CHECK_EQ(xmlEncoder.GetContentHash(), reordered_encoder.GetContentHash());
+
+            // The nodes are sorted by NodeId (the numeric identifiers by value).
+            xpath = "/xmlns:UANodeSet/*[@NodeId]"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+            REQUIRE_EQ(xml_nodes.size(), 3);
+            CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[0])->get_attribute_value("NodeId"), "ns=1;i=1");
+            CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[1])->get_attribute_value("NodeId"), "ns=1;i=18");
+            CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[2])->get_attribute_value("NodeId"), "ns=1;i=61");
+
+            // The references are sorted by the reference type.
+            xpath = "//xmlns:UAObject/xmlns:References/xmlns:Reference"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+            REQUIRE_EQ(xml_nodes.size(), 4);
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Reference", "ns=1;i=2", std::map<std::string, std::string>({{"ReferenceType", "HasComponent"}})));
+            CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[3], "Reference", "i=85", std::map<std::string, std::string>({{"ReferenceType", "Organizes"}, {"IsForward", "false"}})));
+            MESSAGE(log_message);
+        }
+
+        /*
+         * The rewrite of the file is skipped if the content hash has not changed.
+         */
+        SUBCASE("SetSkipUnchangedWrite()")
+        {
+            const std::string filename = "xml_encoder_skip_unchanged_write_test.xml";
+            std::remove(filename.c_str());
+            std::remove((filename + ".hash").c_str());
+            const auto encode = [&](const NodeIntermediateModel& node)
+            {
+                XMLEncoder file_encoder(logger, filename);
+                file_encoder.SetCanonicalOutput(true);
+                file_encoder.SetSkipUnchangedWrite(true);
+                CHECK_EQ(file_encoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(file_encoder.AddNamespaces(namespaces).GetStatus(), StatusResults::Good);
+                CHECK_EQ(file_encoder.AddNodeObjectType(node).GetStatus(), StatusResults::Good);
+                CHECK_EQ(file_encoder.AddAliases(aliases).GetStatus(), StatusResults::Good);
+                CHECK_EQ(file_encoder.End().GetStatus(), StatusResults::Good);
+                return file_encoder.IsWriteSkipped();
+            };
+
+            CHECK_FALSE(encode(nim_object_type)); // The first export writes the file and its hash.
+            CHECK(std::filesystem::exists(filename + ".hash"));
+            // The same content is not written to the disk at all.
+            const auto old_write_time = std::filesystem::last_write_time(filename) - std::chrono::hours(1);
+            std::filesystem::last_write_time(filename, old_write_time);
+            CHECK(encode(nim_object_type));
+            CHECK_EQ(std::filesystem::last_write_time(filename), old_write_time);
+            CHECK_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+            NodeIntermediateModel nim_object_type_changed;
+            nim_object_type_changed.SetExpNodeId(UA_EXPANDEDNODEID("ns=1;i=62"));
+            nim_object_type_changed.SetNodeReferences({&ref_desc_has_subtype});
+            nim_object_type_changed.SetNodeClass(UA_NodeClass::UA_NODECLASS_OBJECTTYPE);
+            nim_object_type_changed.SetAttributes(attrs_object_type);
+            CHECK_FALSE(encode(nim_object_type_changed)); // The changed content is written.
+            CHECK_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+            std::filesystem::remove(filename); // The missing file is written even if the hash is the same.
+            CHECK_FALSE(encode(nim_object_type_changed));
+            CHECK(std::filesystem::exists(filename));
+
+            std::remove(filename.c_str());
+            std::remove((filename + ".hash").c_str());
+        }
+
         /*
          * Composition attribute: NodeId, BrowseName, WriteMask, UserWriteMask, ParentNodeId, EventNotifier
          * Composition of elements: DisplayName, Description, References
@@ -851,6 +1091,132 @@ TEST_SUITE("nodesetexporter::encoders")
             }
         }
 
+        /*
+         * Value element: the scalar, the array from the attribute and the array read in parts.
+         */
+        SUBCASE("AddNodeVariable() with Value")
+        {
+            SUBCASE("Scalar")
+            {
+                UA_Double scalar = 21.5; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                UA_Variant scalar_variant;
+                UA_Variant_setScalar(&scalar_variant, &scalar, &UA_TYPES[UA_TYPES_DOUBLE]);
+                auto attrs = attrs_variable_scalar;
+                attrs.insert_or_assign(UA_ATTRIBUTEID_VALUE, std::optional<VariantsOfAttr>{UATypesContainer<UA_Variant>(scalar_variant, UA_TYPES_VARIANT)});
+                nim_variable_scalar.SetAttributes(std::move(attrs));
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeVariable(nim_variable_scalar).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+                xpath = "//xmlns:UAVariable/xmlns:Value/*[local-name()='Double']"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+                MESSAGE("Nodes size = ", xml_nodes.size());
+                REQUIRE_EQ(xml_nodes.size(), 1);
+                CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[0])->get_first_child_text()->get_content(), "21.5");
+            }
+
+            SUBCASE("Array of strings")
+            {
+                std::array<UA_String, 2> strings{UA_STRING_STATIC("first"), UA_STRING_STATIC("second")};
+                UA_Variant array_variant;
+                UA_Variant_setArray(&array_variant, strings.data(), strings.size(), &UA_TYPES[UA_TYPES_STRING]);
+                auto attrs = attrs_variable_scalar;
+                attrs.insert_or_assign(UA_ATTRIBUTEID_VALUE, std::optional<VariantsOfAttr>{UATypesContainer<UA_Variant>(array_variant, UA_TYPES_VARIANT)});
+                nim_variable_scalar.SetAttributes(std::move(attrs));
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeVariable(nim_variable_scalar).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+                xpath = "//xmlns:UAVariable/xmlns:Value/*[local-name()='ListOfString']/*[local-name()='String']"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+                MESSAGE("Nodes size = ", xml_nodes.size());
+                REQUIRE_EQ(xml_nodes.size(), 2);
+                CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[0])->get_first_child_text()->get_content(), "first");
+                CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[1])->get_first_child_text()->get_content(), "second");
+            }
+
+            SUBCASE("Array read in parts")
+            {
+                constexpr size_t chunk_size = 3;
+                constexpr size_t array_size = 7;
+                size_t number_of_chunks = 0;
+                nim_variable_scalar.SetValueChunkReader(
+                    [&number_of_chunks](const NodeIntermediateModel::ValueChunkHandler& handler) -> bool
+                    {
+                        for (size_t first_index = 0; first_index < array_size; first_index += chunk_size)
+                        {
+                            std::vector<UA_Int32> chunk;
+                            for (size_t index = first_index; index < std::min(first_index + chunk_size, array_size); ++index)
+                            {
+                                chunk.push_back(static_cast<UA_Int32>(index));
+                            }
+                            UA_Variant chunk_variant;
+                            UA_Variant_setArray(&chunk_variant, chunk.data(), chunk.size(), &UA_TYPES[UA_TYPES_INT32]);
+                            ++number_of_chunks;
+                            if (!handler(chunk_variant))
+                            {
+                                return false;
+                            }
+                        }
+                        return true;
+                    });
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeVariable(nim_variable_scalar).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(number_of_chunks, 0); // The value is read when the document is written.
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+                CHECK_EQ(number_of_chunks, 3);
+
+                xpath = "//xmlns:UAVariable/xmlns:Value/*[local-name()='ListOfInt32']/*[local-name()='Int32']"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+                MESSAGE("Nodes size = ", xml_nodes.size());
+                REQUIRE_EQ(xml_nodes.size(), array_size);
+                for (size_t index = 0; index < array_size; ++index)
+                {
+                    CHECK_EQ(dynamic_cast<xmlpp::Element*>(xml_nodes[index])->get_first_child_text()->get_content(), std::to_string(index));
+                }
+            }
+
+            SUBCASE("The first part could not be read")
+            {
+                nim_variable_scalar.SetValueChunkReader([](const NodeIntermediateModel::ValueChunkHandler& /*handler*/) -> bool { return false; });
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeVariable(nim_variable_scalar).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                MESSAGE(out_test_buffer.str()); // Output of the generated xml as a result of the encoder functions.
+
+                // Nothing has been written yet, the Value element is skipped.
+                xpath = "//xmlns:UAVariable/xmlns:Value"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser, valid, out_test_buffer));
+                CHECK(xml_nodes.empty());
+            }
+
+            SUBCASE("The reading in parts failed after a part was written")
+            {
+                nim_variable_scalar.SetValueChunkReader(
+                    [](const NodeIntermediateModel::ValueChunkHandler& handler) -> bool
+                    {
+                        UA_Int32 element = 1;
+                        UA_Variant chunk_variant;
+                        UA_Variant_setArray(&chunk_variant, &element, 1, &UA_TYPES[UA_TYPES_INT32]);
+                        static_cast<void>(handler(chunk_variant));
+                        return false; // The next part could not be read.
+                    });
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeVariable(nim_variable_scalar).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                // The written part of the value can't be removed from the output, so the document fails and is not passed to the buffer.
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Fail);
+                CHECK(out_test_buffer.str().empty());
+            }
+        }
+
         /*
          * Composition attribute: NodeId, BrowseName, WriteMask, UserWriteMask, IsAbstract, DataType, ValueRank, ArrayDimensions.
          * Composition of elements: DisplayName, Description, References, Value
@@ -1109,6 +1475,182 @@ TEST_SUITE("nodesetexporter::encoders")
             }
         }
 
+        SUBCASE("AddNodeDataType() with Definition")
+        {
+            auto attrs_data_type_definition = attrs_data_type;
+
+            SUBCASE("Structure")
+            {
+                UATypesContainer<UA_StructureDefinition> definition(UA_TYPES_STRUCTUREDEFINITION);
+                auto& ua_definition = definition.GetRef();
+                ua_definition.baseDataType = UA_NODEID_NUMERIC(0, UA_NS0ID_STRUCTURE);
+                ua_definition.structureType = UA_STRUCTURETYPE_STRUCTURE;
+                ua_definition.fields = static_cast<UA_StructureField*>(UA_Array_new(2, &UA_TYPES[UA_TYPES_STRUCTUREFIELD]));
+                ua_definition.fieldsSize = 2;
+                ua_definition.fields[0].name = UA_String_fromChars("Speed");
+                ua_definition.fields[0].dataType = UA_NODEID_NUMERIC(0, UA_NS0ID_DOUBLE);
+                ua_definition.fields[0].valueRank = UA_VALUERANK_SCALAR;
+                ua_definition.fields[0].description = UA_LOCALIZEDTEXT_ALLOC("en", "Speed of the motor");
+                ua_definition.fields[1].name = UA_String_fromChars("Tags");
+                ua_definition.fields[1].dataType = UA_NODEID_NUMERIC(0, UA_NS0ID_STRING);
+                ua_definition.fields[1].valueRank = UA_VALUERANK_ONE_DIMENSION;
+                attrs_data_type_definition.insert_or_assign(UA_ATTRIBUTEID_DATATYPEDEFINITION, std::optional<VariantsOfAttr>{definition});
+                nim_data_type.SetAttributes(attrs_data_type_definition);
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeDataType(nim_data_type).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                std::string out_xml(out_test_buffer.str());
+                out_xml.erase(out_xml.rfind('\n'));
+                MESSAGE(out_xml); // Output of the generated xml as a result of the encoder functions.
+
+                CHECK_NOTHROW(parser.parse_memory(out_xml));
+                CHECK_NOTHROW(valid.validate(parser.get_document())); // Schematic Validation
+
+                xpath = "//xmlns:UADataType/xmlns:Definition"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), 1);
+                if (!xml_nodes.empty())
+                {
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Definition", "", std::map<std::string, std::string>({{"Name", "My Number"}})));
+                    MESSAGE(log_message);
+                    log_message.clear();
+                }
+
+                xpath = "//xmlns:UADataType/xmlns:Definition/xmlns:Field"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), 2);
+                if (xml_nodes.size() == 2)
+                {
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Field", "", std::map<std::string, std::string>({{"Name", "Speed"}, {"DataType", "Double"}})));
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "Field", "", std::map<std::string, std::string>({{"Name", "Tags"}, {"DataType", "String"}, {"ValueRank", "1"}})));
+                    MESSAGE(log_message);
+                    log_message.clear();
+                }
+
+                xpath = "//xmlns:UADataType/xmlns:Definition/xmlns:Field/xmlns:Description"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), 1);
+                if (!xml_nodes.empty())
+                {
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Description", "Speed of the motor", std::map<std::string, std::string>({{"Locale", "en"}})));
+                    MESSAGE(log_message);
+                    log_message.clear();
+                }
+            }
+
+            SUBCASE("Enumeration")
+            {
+                UATypesContainer<UA_EnumDefinition> definition(UA_TYPES_ENUMDEFINITION);
+                auto& ua_definition = definition.GetRef();
+                ua_definition.fields = static_cast<UA_EnumField*>(UA_Array_new(2, &UA_TYPES[UA_TYPES_ENUMFIELD]));
+                ua_definition.fieldsSize = 2;
+                ua_definition.fields[0].name = UA_String_fromChars("Stopped");
+                ua_definition.fields[0].value = 0;
+                ua_definition.fields[0].displayName = UA_LOCALIZEDTEXT_ALLOC("", "Stopped");
+                ua_definition.fields[1].name = UA_String_fromChars("Running");
+                ua_definition.fields[1].value = 5;
+                attrs_data_type_definition.insert_or_assign(UA_ATTRIBUTEID_DATATYPEDEFINITION, std::optional<VariantsOfAttr>{definition});
+                nim_data_type.SetAttributes(attrs_data_type_definition);
+
+                CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+                CHECK_EQ(xmlEncoder.AddNodeDataType(nim_data_type).GetStatus(), StatusResults::Good); // MAIN TEST METHOD
+                CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+                std::string out_xml(out_test_buffer.str());
+                out_xml.erase(out_xml.rfind('\n'));
+                MESSAGE(out_xml); // Output of the generated xml as a result of the encoder functions.
+
+                CHECK_NOTHROW(parser.parse_memory(out_xml));
+                CHECK_NOTHROW(valid.validate(parser.get_document())); // Schematic Validation
+
+                xpath = "//xmlns:UADataType/xmlns:Definition/xmlns:Field"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), 2);
+                if (xml_nodes.size() == 2)
+                {
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[0], "Field", "", std::map<std::string, std::string>({{"Name", "Stopped"}, {"Value", "0"}})));
+                    CHECK_NOTHROW(CheckXMLNode(log_message, xml_nodes[1], "Field", "", std::map<std::string, std::string>({{"Name", "Running"}, {"Value", "5"}})));
+                    MESSAGE(log_message);
+                    log_message.clear();
+                }
+
+                xpath = "//xmlns:UADataType/xmlns:Definition/xmlns:Field/xmlns:DisplayName"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), 1);
+            }
+        }
+
+        SUBCASE("Attributes of the wrong data type")
+        {
+            // Every tenth optional attribute of the variables has the wrong data type. Such attributes are not written, the encoding continues without the exceptions.
+            constexpr size_t number_of_nodes = 10000;
+            constexpr size_t wrong_type_period = 10;
+            constexpr UA_UInt32 first_node_id = 100000;
+            const std::array optional_attrs{
+                std::pair{UA_ATTRIBUTEID_WRITEMASK, "WriteMask"},
+                std::pair{UA_ATTRIBUTEID_USERWRITEMASK, "UserWriteMask"},
+                std::pair{UA_ATTRIBUTEID_DATATYPE, "DataType"},
+                std::pair{UA_ATTRIBUTEID_VALUERANK, "ValueRank"},
+                std::pair{UA_ATTRIBUTEID_ACCESSLEVEL, "AccessLevel"},
+                std::pair{UA_ATTRIBUTEID_USERACCESSLEVEL, "UserAccessLevel"},
+                std::pair{UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL, "MinimumSamplingInterval"},
+                std::pair{UA_ATTRIBUTEID_HISTORIZING, "Historizing"}};
+            std::array<size_t, optional_attrs.size()> number_of_wrong_attrs{};
+            std::vector<NodeIntermediateModel> nims(number_of_nodes);
+            size_t attr_counter = 0;
+            for (size_t index = 0; index < number_of_nodes; ++index)
+            {
+                auto attrs = attrs_variable_scalar;
+                for (size_t attr_index = 0; attr_index < optional_attrs.size(); ++attr_index)
+                {
+                    if (attr_counter++ % wrong_type_period == 0)
+                    {
+                        // The NodeClass type is not used by these attributes.
+                        attrs.insert_or_assign(optional_attrs.at(attr_index).first, std::optional<VariantsOfAttr>{UA_NodeClass::UA_NODECLASS_UNSPECIFIED});
+                        ++number_of_wrong_attrs.at(attr_index);
+                    }
+                }
+                auto& nim = nims.at(index);
+                nim.SetExpNodeId(UA_EXPANDEDNODEID_NUMERIC(1, first_node_id + static_cast<UA_UInt32>(index)));
+                nim.SetNodeReferences(std::vector<UA_ReferenceDescription*>{&ref_desc_has_component_parent, &ref_desc_has_type_def});
+                nim.SetNodeClass(UA_NodeClass::UA_NODECLASS_VARIABLE);
+                nim.SetParentNodeId(UA_EXPANDEDNODEID("ns=1;i=2"));
+                nim.SetAttributes(std::move(attrs));
+            }
+
+            // The warnings of each wrong attribute are not output, only the encoding is measured.
+            logger.SetLevel(LogLevel::Error);
+            CHECK_EQ(xmlEncoder.Begin().GetStatus(), StatusResults::Good);
+            size_t number_of_failed_nodes = 0;
+            PerformanceTimer timer;
+            for (const auto& nim : nims)
+            {
+                if (xmlEncoder.AddNodeVariable(nim).GetStatus() != StatusResults::Good) // MAIN TEST METHOD
+                {
+                    ++number_of_failed_nodes;
+                }
+            }
+            const auto elapsed = timer.GetTimeElapsed();
+            CHECK_EQ(xmlEncoder.End().GetStatus(), StatusResults::Good);
+            CHECK_EQ(number_of_failed_nodes, 0);
+            MESSAGE("Encoding of ", number_of_nodes, " variables with every ", wrong_type_period, "th optional attribute of the wrong data type: ", PerformanceTimer::TimeToString(elapsed));
+
+            std::string out_xml(out_test_buffer.str());
+            out_xml.erase(out_xml.rfind('\n'));
+            CHECK_NOTHROW(parser.parse_memory(out_xml));
+            CHECK_NOTHROW(valid.validate(parser.get_document())); // Schematic Validation
+
+            xpath = "//xmlns:UAVariable"; // Node to be checked
+            CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+            CHECK_EQ(xml_nodes.size(), number_of_nodes);
+            for (size_t attr_index = 0; attr_index < optional_attrs.size(); ++attr_index)
+            {
+                xpath = std::string("//xmlns:UAVariable[@") + optional_attrs.at(attr_index).second + "]"; // Node to be checked
+                CHECK_NOTHROW(xml_nodes = GetFindXMLNode(xpath, parser));
+                CHECK_EQ(xml_nodes.size(), number_of_nodes - number_of_wrong_attrs.at(attr_index));
+            }
+        }
+
         SUBCASE("Combined Multiple Nodes")
         {
             SUBCASE("Sequential Addition")
@@ -0,0 +1,333 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/AsyncClientWrappers.h"
+#include "LogMacro.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/logger/LogPlugin.h"
+#include "nodesetexporter/open62541/ClientWrappers.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include "ex_nodeset.h"
+#include <open62541/client_config_default.h>
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <doctest/doctest.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using LoggerPlugin = nodesetexporter::logger::Open62541LogPlugin;
+using Open62541ClientWrapper = nodesetexporter::open62541::Open62541ClientWrapper;
+using Open62541AsyncClientWrapper = nodesetexporter::open62541::Open62541AsyncClientWrapper;
+using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
+using NodeAttributesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeAttributesRequestResponse;
+using NodeClassesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeClassesRequestResponse;
+using NodeReferencesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeReferencesRequestResponse;
+using nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::typealiases::VariantsOfAttrToString;
+using namespace std::literals;
+
+constexpr auto SERVER_START_TIMEOUT = 10s;
+volatile std::atomic_bool running = true; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::condition_variable cv_server_started; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex cv_mutex; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+#define CHECK_ERR(res)                                                                                                                                                                                 \
+    if (UA_StatusCode_isBad((res)))                                                                                                                                                                    \
+    {                                                                                                                                                                                                  \
+        MESSAGE("OPC Server has bad status code: ", UA_StatusCode_name((res)));                                                                                                                        \
+        REQUIRE(UA_StatusCode_isGood((res)));                                                                                                                                                          \
+    }
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+auto OpcUaServerStart()
+{
+    return std::thread(
+        []
+        {
+            MESSAGE("Server start.");
+            UA_ServerConfig config = {0};
+            Logger logger("server-test");
+#ifdef OPEN62541_VER_1_3
+            config.logger = LoggerPlugin::Open62541LoggerCreator(logger);
+#elif defined(OPEN62541_VER_1_4)
+            auto logging = LoggerPlugin::Open62541LoggerCreator(logger);
+            config.logging = &logging;
+#endif
+            auto retval = UA_ServerConfig_setDefault(&config);
+            REQUIRE_EQ(retval, UA_STATUSCODE_GOOD);
+            auto* server = UA_Server_newWithConfig(&config);
+            REQUIRE_NE(server, nullptr);
+            CHECK_ERR(ex_nodeset(server)); // TEST NODESET LOADER (HARDCODE)
+            uint64_t callback_id = 0;
+            CHECK_ERR(UA_Server_addTimedCallback(
+                server,
+                [](UA_Server* /*server*/, void*)
+                {
+                    std::lock_guard<std::mutex> locker(cv_mutex);
+                    cv_server_started.notify_all();
+                },
+                nullptr,
+                1000,
+                &callback_id));
+            CHECK_ERR(UA_Server_run(server, reinterpret_cast<volatile const bool*>(&running))); // NOLINT
+            UA_Server_removeRepeatedCallback(server, callback_id);
+
+#ifdef OPEN62541_VER_1_3
+            UA_Server_delete(server);
+#elif defined(OPEN62541_VER_1_4)
+            CHECK_ERR(UA_Server_delete(server));
+#endif
+            MESSAGE("Server down.");
+        });
+}
+
+/**
+ * @brief The simplest event loop of the client for the test: executes the transferred tasks and iterates the client in its own thread.
+ *        While the loop exists, the client must not be used from other threads.
+ */
+class TestClientEventLoop
+{
+public:
+    explicit TestClientEventLoop(UA_Client& client)
+        : m_thread(
+            [this, &client](const std::stop_token& stop)
+            {
+                while (!stop.stop_requested())
+                {
+                    std::deque<std::function<void()>> tasks;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        tasks.swap(m_tasks);
+                    }
+                    for (auto& task : tasks)
+                    {
+                        task();
+                    }
+                    UA_Client_run_iterate(&client, 1);
+                }
+            })
+    {
+    }
+
+    void Dispatch(std::function<void()>&& task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_tasks;
+    std::jthread m_thread; // The last one, so that it stops first
+};
+
+/**
+ * @brief Comparison of references by binary encoding.
+ */
+void CheckReferencesEqual(const std::vector<NodeReferencesRequestResponse>& first, const std::vector<NodeReferencesRequestResponse>& second)
+{
+    REQUIRE_EQ(first.size(), second.size());
+    for (size_t node_index = 0; node_index < first.size(); node_index++)
+    {
+        MESSAGE("parent node_id: ", first.at(node_index).exp_node_id.ToString());
+        REQUIRE_EQ(first.at(node_index).references.size(), second.at(node_index).references.size());
+        for (size_t ref_index = 0; ref_index < first.at(node_index).references.size(); ref_index++)
+        {
+            UA_ByteString b_str1 = {0};
+            UA_ByteString b_str2 = {0};
+            UA_encodeBinary(&first.at(node_index).references.at(ref_index).GetRef(), &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION], &b_str1);
+            UA_encodeBinary(&second.at(node_index).references.at(ref_index).GetRef(), &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION], &b_str2);
+            CHECK(UA_ByteString_equal(&b_str1, &b_str2));
+            UA_ByteString_clear(&b_str1);
+            UA_ByteString_clear(&b_str2);
+        }
+    }
+}
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::Open62541AsyncClientWrapper") // NOLINT
+    {
+        std::unique_lock<std::mutex> locker(cv_mutex);
+        running = true;
+        auto server_thread = OpcUaServerStart();
+        const std::chrono::time_point<std::chrono::system_clock> server_start_timeout = std::chrono::system_clock::now() + SERVER_START_TIMEOUT;
+        REQUIRE_EQ(cv_server_started.wait_until(locker, server_start_timeout), std::cv_status::no_timeout); // I expect the start of the server
+        locker.unlock();
+
+        auto* client = UA_Client_new();
+        auto* cli_config = UA_Client_getConfig(client);
+        Logger cli_logger("client-test");
+#ifdef OPEN62541_VER_1_3
+        cli_config->logger = LoggerPlugin::Open62541LoggerCreator(cli_logger);
+#elif defined(OPEN62541_VER_1_4)
+        auto logging = LoggerPlugin::Open62541LoggerCreator(cli_logger);
+        cli_config->logging = &logging;
+        cli_config->eventLoop->logger = &logging;
+#endif
+        UA_ClientConfig_setDefault(cli_config);
+        REQUIRE(UA_StatusCode_isGood(UA_Client_connect(client, "opc.tcp://localhost:4840")));
+
+        // The results of the synchronous wrapper are the reference for the asynchronous one.
+        auto sync_wrapper = Open62541ClientWrapper(*client, cli_logger);
+
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>> test_nodes{
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=1"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=2"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=8"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=12"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=15"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=17"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=21"), UA_TYPES_EXPANDEDNODEID),
+            UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=500"), UA_TYPES_EXPANDEDNODEID)}; // Non-existent node
+
+        std::vector<NodeReferencesRequestResponse> sync_references;
+        std::vector<NodeClassesRequestResponse> sync_classes;
+        std::vector<NodeAttributesRequestResponse> sync_attributes;
+        for (const auto& node : test_nodes)
+        {
+            sync_references.emplace_back(node);
+            sync_classes.emplace_back(node);
+            sync_attributes.push_back(
+                {node,
+                 {{UA_ATTRIBUTEID_NODECLASS, std::nullopt},
+                  {UA_ATTRIBUTEID_BROWSENAME, std::nullopt},
+                  {UA_ATTRIBUTEID_DISPLAYNAME, std::nullopt},
+                  {UA_ATTRIBUTEID_DESCRIPTION, std::nullopt},
+                  {UA_ATTRIBUTEID_VALUE, std::nullopt},
+                  {UA_ATTRIBUTEID_DATATYPE, std::nullopt}}});
+        }
+        sync_wrapper.SetRequestedMaxReferencesPerNode(1); // Checking the reading of the continuation points
+        REQUIRE_EQ(sync_wrapper.ReadNodeReferences(sync_references).GetStatus(), StatusResults::Good);
+        REQUIRE_EQ(sync_wrapper.ReadNodeClasses(sync_classes).GetStatus(), StatusResults::Good);
+        REQUIRE_EQ(sync_wrapper.ReadNodesAttributes(sync_attributes).GetStatus(), StatusResults::Good);
+
+        {
+            // From this moment the client belongs to the event loop.
+            TestClientEventLoop event_loop(*client);
+            auto async_wrapper = Open62541AsyncClientWrapper(
+                *client,
+                cli_logger,
+                [&event_loop](std::function<void()>&& task)
+                {
+                    event_loop.Dispatch(std::move(task));
+                });
+            async_wrapper.SetRequestedMaxReferencesPerNode(1);
+
+            SUBCASE("Requests are split into parts with a limit of requests in flight")
+            {
+                async_wrapper.SetMaxRequestsInFlight(2);
+                async_wrapper.SetMaxOperationsPerRequest(3);
+
+                std::vector<NodeReferencesRequestResponse> async_references;
+                std::vector<NodeClassesRequestResponse> async_classes;
+                std::vector<NodeAttributesRequestResponse> async_attributes;
+                for (size_t index = 0; index < test_nodes.size(); index++)
+                {
+                    async_references.emplace_back(test_nodes.at(index));
+                    async_classes.emplace_back(test_nodes.at(index));
+                    async_attributes.push_back({test_nodes.at(index), sync_attributes.at(index).attrs});
+                }
+
+                CHECK_EQ(async_wrapper.ReadNodeReferences(async_references).GetStatus(), StatusResults::Good);
+                CheckReferencesEqual(sync_references, async_references);
+
+                CHECK_EQ(async_wrapper.ReadNodeClasses(async_classes).GetStatus(), StatusResults::Good);
+                for (size_t index = 0; index < test_nodes.size(); index++)
+                {
+                    CHECK_EQ(sync_classes.at(index).node_class, async_classes.at(index).node_class);
+                    CHECK_EQ(sync_classes.at(index).result_code, async_classes.at(index).result_code);
+                }
+
+                CHECK_EQ(async_wrapper.ReadNodesAttributes(async_attributes).GetStatus(), StatusResults::Good);
+                for (size_t index = 0; index < test_nodes.size(); index++)
+                {
+                    for (const auto& [attr_id, sync_value] : sync_attributes.at(index).attrs)
+                    {
+                        const auto& async_value = async_attributes.at(index).attrs.at(attr_id);
+                        REQUIRE_EQ(sync_value.has_value(), async_value.has_value());
+                        if (sync_value.has_value())
+                        {
+                            CHECK_EQ(VariantsOfAttrToString(sync_value.value()), VariantsOfAttrToString(async_value.value()));
+                        }
+                    }
+                }
+            }
+
+            SUBCASE("All operations in one request")
+            {
+                async_wrapper.SetMaxRequestsInFlight(1);
+                std::vector<NodeReferencesRequestResponse> async_references;
+                for (const auto& node : test_nodes)
+                {
+                    async_references.emplace_back(node);
+                }
+                CHECK_EQ(async_wrapper.ReadNodeReferences(async_references).GetStatus(), StatusResults::Good);
+                CheckReferencesEqual(sync_references, async_references);
+            }
+
+            SUBCASE("The requests in flight are failed when the event loop stops iterating and disconnects the client")
+            {
+                auto stopped_wrapper = Open62541AsyncClientWrapper(
+                    *client,
+                    cli_logger,
+                    [&event_loop, client](std::function<void()>&& task)
+                    {
+                        event_loop.Dispatch(std::move(task));
+                        // The requests are sent by the task, the disconnection is executed before their responses are received.
+                        event_loop.Dispatch(
+                            [client]
+                            {
+                                UA_Client_disconnect(client);
+                            });
+                    });
+                std::vector<NodeReferencesRequestResponse> async_references;
+                for (const auto& node : test_nodes)
+                {
+                    async_references.emplace_back(node);
+                }
+                CHECK_EQ(stopped_wrapper.ReadNodeReferences(async_references).GetStatus(), StatusResults::Fail); // Does not hang
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(stopped_wrapper.ReadNodeDataValue(test_nodes.at(1), out).GetStatus(), StatusResults::Fail); // The following requests fail at once
+            }
+
+            SUBCASE("ReadNodeDataValue")
+            {
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(async_wrapper.ReadNodeDataValue(test_nodes.at(1), out).GetStatus(), StatusResults::Good);
+                REQUIRE_EQ(out.GetRef().type, &UA_TYPES[UA_TYPES_DOUBLE]);
+                CHECK_EQ(*static_cast<UA_Double*>(out.GetRef().data), 45.52951); // NOLINT
+                CHECK_EQ(async_wrapper.ReadNodeDataValue(test_nodes.at(0), out).GetStatus(), StatusResults::Fail); // The object has no value
+            }
+        }
+
+        REQUIRE(UA_StatusCode_isGood(UA_Client_disconnect(client)));
+        UA_Client_delete(client);
+        running = false;
+        if (server_thread.joinable())
+        {
+            server_thread.join();
+        }
+        sleep(1);
+    }
+}
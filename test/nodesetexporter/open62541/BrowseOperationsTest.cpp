@@ -20,8 +20,17 @@
 
 #include <doctest/doctest.h>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
 #include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -33,6 +42,7 @@ using LoggerPlugin = nodesetexporter::logger::Open62541LogPlugin;
 using StatusResults = ::nodesetexporter::common::statuses::StatusResults<>;
 using nodesetexporter::open62541::UATypesContainer;
 using nodesetexporter::open62541::browseoperations::GrabChildNodeIdsFromStartNodeId;
+using nodesetexporter::open62541::browseoperations::MakeViewDescription;
 using namespace std::literals;
 
 constexpr auto SERVER_START_TIMEOUT = 10s;
@@ -94,6 +104,134 @@ auto OpcUaServerStart()
         });
 }
 
+/**
+ * @brief The TCP proxy to the server, which records the data sent by the client (the connection without the security, the requests are readable).
+ */
+class RecordingProxy // NOLINT(cppcoreguidelines-special-member-functions)
+{
+public:
+    RecordingProxy(uint16_t listen_port, uint16_t server_port)
+        : m_server_port(server_port),
+          m_listen_socket(socket(AF_INET, SOCK_STREAM, 0))
+    {
+        REQUIRE_GE(m_listen_socket, 0);
+        int reuse = 1;
+        setsockopt(m_listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        auto address = LocalAddress(listen_port);
+        REQUIRE_EQ(bind(m_listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        REQUIRE_EQ(listen(m_listen_socket, SOMAXCONN), 0);
+        m_thread = std::jthread(
+            [this](const std::stop_token& stop_token)
+            {
+                Run(stop_token);
+            });
+    }
+
+    ~RecordingProxy()
+    {
+        m_thread.request_stop();
+        m_thread.join();
+        for (const auto socket : m_sockets)
+        {
+            close(socket);
+        }
+        close(m_listen_socket);
+    }
+
+    /**
+     * @brief All the data sent by the client to the server.
+     */
+    std::string GetClientData()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_client_data;
+    }
+
+private:
+    static sockaddr_in LocalAddress(uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    /**
+     * @brief Forwarding of the data of the socket to the other side of the connection.
+     * @return False if the connection is closed.
+     */
+    bool Forward(int from_socket, int to_socket, bool is_from_client)
+    {
+        std::array<char, 65536> buffer{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        const auto size = recv(from_socket, buffer.data(), buffer.size(), 0);
+        if (size <= 0)
+        {
+            return false;
+        }
+        if (is_from_client)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_client_data.append(buffer.data(), static_cast<size_t>(size));
+        }
+        for (ssize_t sent = 0; sent < size;)
+        {
+            const auto result = send(to_socket, buffer.data() + sent, static_cast<size_t>(size - sent), MSG_NOSIGNAL); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (result <= 0)
+            {
+                return false;
+            }
+            sent += result;
+        }
+        return true;
+    }
+
+    // One connection of the client is enough for the test: the client socket and the server socket.
+    void Run(const std::stop_token& stop_token)
+    {
+        bool is_connected = true;
+        while (!stop_token.stop_requested() && is_connected)
+        {
+            std::vector<pollfd> poll_fds{{m_listen_socket, POLLIN, 0}};
+            for (const auto socket : m_sockets)
+            {
+                poll_fds.push_back({socket, POLLIN, 0});
+            }
+            if (poll(poll_fds.data(), poll_fds.size(), 10) <= 0) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            {
+                continue;
+            }
+            if ((poll_fds.at(0).revents & POLLIN) != 0 && m_sockets.empty()) // NOLINT(hicpp-signed-bitwise)
+            {
+                const int client_socket = accept(m_listen_socket, nullptr, nullptr);
+                const int server_socket = socket(AF_INET, SOCK_STREAM, 0);
+                auto address = LocalAddress(m_server_port);
+                REQUIRE_EQ(connect(server_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                m_sockets = {client_socket, server_socket};
+                continue;
+            }
+            if (poll_fds.size() == 3)
+            {
+                if ((poll_fds.at(1).revents & (POLLIN | POLLHUP)) != 0) // NOLINT(hicpp-signed-bitwise)
+                {
+                    is_connected = Forward(m_sockets.at(0), m_sockets.at(1), true);
+                }
+                if (is_connected && (poll_fds.at(2).revents & (POLLIN | POLLHUP)) != 0) // NOLINT(hicpp-signed-bitwise)
+                {
+                    is_connected = Forward(m_sockets.at(1), m_sockets.at(0), false);
+                }
+            }
+        }
+    }
+
+    uint16_t m_server_port;
+    int m_listen_socket;
+    std::vector<int> m_sockets;
+    std::mutex m_mutex;
+    std::string m_client_data;
+    std::jthread m_thread;
+};
+
 } // namespace
 
 TEST_SUITE("idsmart::connector::nodesetexporter::open62541")
@@ -148,6 +286,46 @@ TEST_SUITE("idsmart::connector::nodesetexporter::open62541")
                 CHECK_EQ(out.size(), 1);
             }
 
+            SUBCASE("The View is sent in the Browse requests")
+            {
+                RecordingProxy proxy(4844, 4840); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                auto* proxy_client = UA_Client_new();
+                auto* proxy_cli_config = UA_Client_getConfig(proxy_client);
+#ifdef OPEN62541_VER_1_3
+                proxy_cli_config->logger = LoggerPlugin::Open62541LoggerCreator(cli_logger);
+#elif defined(OPEN62541_VER_1_4)
+                proxy_cli_config->logging = &logging;
+                proxy_cli_config->eventLoop->logger = &logging;
+#endif
+                UA_ClientConfig_setDefault(proxy_cli_config);
+                REQUIRE(UA_StatusCode_isGood(UA_Client_connect(proxy_client, "opc.tcp://localhost:4844")));
+
+                auto startNodeId = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=1"), UA_TYPES_EXPANDEDNODEID);
+                // The distinctive time and version, so the encoded View is not found in the request by chance.
+                const auto view = MakeViewDescription(UA_NODEID_NUMERIC(2, 99999), UA_DateTime{133000000000000000}, 7); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                CHECK_EQ(view.GetRef().viewVersion, 7);
+                std::vector<UATypesContainer<UA_ExpandedNodeId>> out;
+                // Open62541 does not support the Views and rejects the Browse service with the View (BadViewIdUnknown), so the children are not collected.
+                CHECK_EQ(GrabChildNodeIdsFromStartNodeId(proxy_client, startNodeId, out, nullptr, &view.GetRef()), StatusResults::Fail);
+                CHECK_EQ(out.size(), 1);
+
+                // The request contains the whole ViewDescription: the node, the time and the version.
+                UA_ByteString encoded_view = UA_BYTESTRING_NULL;
+                REQUIRE_EQ(UA_encodeBinary(&view.GetRef(), &UA_TYPES[UA_TYPES_VIEWDESCRIPTION], &encoded_view), UA_STATUSCODE_GOOD);
+                const std::string encoded_view_data(reinterpret_cast<const char*>(encoded_view.data), encoded_view.length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                UA_ByteString_clear(&encoded_view);
+                CHECK_NE(proxy.GetClientData().find(encoded_view_data), std::string::npos);
+
+                // The View with the null node is the whole address space, the same as without the View.
+                const auto default_view = MakeViewDescription(UA_NODEID_NULL);
+                out.clear();
+                CHECK_EQ(GrabChildNodeIdsFromStartNodeId(proxy_client, startNodeId, out, nullptr, &default_view.GetRef()), StatusResults::Good);
+                CHECK_EQ(out.size(), 43);
+
+                REQUIRE(UA_StatusCode_isGood(UA_Client_disconnect(proxy_client)));
+                UA_Client_delete(proxy_client);
+            }
+
             REQUIRE(UA_StatusCode_isGood(UA_Client_disconnect(client)));
             UA_Client_delete(client);
             running = false;
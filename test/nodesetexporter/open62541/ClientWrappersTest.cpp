@@ -8,6 +8,7 @@
 
 #include "nodesetexporter/open62541/ClientWrappers.h"
 #include "LogMacro.h"
+#include "nodesetexporter/open62541/BrowseOperations.h"
 #include "nodesetexporter/common/Statuses.h"
 #include "nodesetexporter/logger/LogPlugin.h"
 #include "nodesetexporter/open62541/UATypesContainer.h"
@@ -21,9 +22,19 @@
 
 #include <doctest/doctest.h>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <iostream>
+#include <random>
 #include <set>
+#include <stop_token>
 #include <thread>
 #include <vector>
 
@@ -33,11 +44,13 @@ TEST_LOGGER_INIT
 
 using LoggerPlugin = nodesetexporter::logger::Open62541LogPlugin;
 using Open62541ClientWrapper = nodesetexporter::open62541::Open62541ClientWrapper;
+using SessionRecoveryPolicy = nodesetexporter::open62541::SessionRecoveryPolicy;
 using StatusResults = nodesetexporter::common::statuses::StatusResults<>;
 using NodeAttributesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeAttributesRequestResponse;
 using NodeClassesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeClassesRequestResponse;
 using NodeReferencesRequestResponse = nodesetexporter::interfaces::IOpen62541::NodeReferencesRequestResponse;
 using nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::browseoperations::GrabChildNodeIdsFromStartNodeId;
 using nodesetexporter::open62541::typealiases::VariantsOfAttr;
 using nodesetexporter::open62541::typealiases::VariantsOfAttrToString;
 using namespace std::literals;
@@ -64,6 +77,37 @@ std::string UaStringToStdString(const UA_String& some_string)
     }
 // NOLINTEND(cppcoreguidelines-macro-usage)
 
+// The multi-megabyte array of Double (8 MB) for the reading of the value in parts. Element i is equal to i.
+constexpr size_t large_array_size = 1024 * 1024;
+const UA_NodeId large_array_node_id = UA_NODEID_STRING(1, const_cast<char*>("large_array")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+
+UA_StatusCode AddLargeArrayVariable(UA_Server* server)
+{
+    std::vector<UA_Double> large_array(large_array_size);
+    for (size_t index = 0; index < large_array.size(); ++index)
+    {
+        large_array[index] = static_cast<UA_Double>(index);
+    }
+    UA_UInt32 array_dimensions = large_array_size;
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT(const_cast<char*>(""), const_cast<char*>("large_array")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    attr.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    attr.valueRank = UA_VALUERANK_ONE_DIMENSION;
+    attr.arrayDimensionsSize = 1;
+    attr.arrayDimensions = &array_dimensions;
+    UA_Variant_setArray(&attr.value, large_array.data(), large_array.size(), &UA_TYPES[UA_TYPES_DOUBLE]);
+    return UA_Server_addVariableNode(
+        server,
+        large_array_node_id,
+        UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+        UA_QUALIFIEDNAME(1, const_cast<char*>("large_array")), // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+        attr,
+        nullptr,
+        nullptr);
+}
+
 auto OpcUaServerStart()
 {
     return std::thread(
@@ -86,6 +130,7 @@ auto OpcUaServerStart()
             auto* server = UA_Server_newWithConfig(&config);
             REQUIRE_NE(server, nullptr);
             CHECK_ERR(ex_nodeset(server)); // TEST NODESET LOADER (HARDCODE)
+            CHECK_ERR(AddLargeArrayVariable(server));
             uint64_t callback_id = 0;
             CHECK_ERR(UA_Server_addTimedCallback(
                 server,
@@ -109,6 +154,217 @@ auto OpcUaServerStart()
         });
 }
 
+/**
+ * @brief The TCP proxy between the client and the test server, which kills the connections: on request, after the given number of the bytes
+ *        of the responses (at the random point of the request) or refuses the new connections. Emulates the loss of the connection during the export.
+ */
+class ConnectionKillingProxy // NOLINT(cppcoreguidelines-special-member-functions)
+{
+public:
+    ConnectionKillingProxy(uint16_t listen_port, uint16_t server_port)
+        : m_server_port(server_port),
+          m_listen_socket(socket(AF_INET, SOCK_STREAM, 0))
+    {
+        REQUIRE_GE(m_listen_socket, 0);
+        int reuse = 1;
+        setsockopt(m_listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        auto address = LocalAddress(listen_port);
+        REQUIRE_EQ(bind(m_listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        REQUIRE_EQ(listen(m_listen_socket, SOMAXCONN), 0);
+        m_thread = std::jthread(
+            [this](const std::stop_token& stop_token)
+            {
+                Run(stop_token);
+            });
+    }
+
+    ~ConnectionKillingProxy()
+    {
+        m_thread.request_stop();
+        m_thread.join();
+        CloseConnections();
+        close(m_listen_socket);
+    }
+
+    /**
+     * @brief Closing of all the current connections. Returns after the connections are closed.
+     */
+    void KillConnections()
+    {
+        m_kill_requested = true;
+        while (m_kill_requested)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    /**
+     * @brief Closing of all the connections after the given number of the bytes from the server, once. The rest of the response is lost.
+     */
+    void KillAfterBytes(size_t number_of_bytes)
+    {
+        m_kill_after_bytes = number_of_bytes;
+    }
+
+    /**
+     * @brief The new connections are accepted and closed at once.
+     */
+    void SetRefuse(bool is_refuse)
+    {
+        m_refuse = is_refuse;
+    }
+
+private:
+    struct Connection
+    {
+        int client_socket;
+        int server_socket;
+    };
+
+    static sockaddr_in LocalAddress(uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    void CloseConnections()
+    {
+        for (const auto& connection : m_connections)
+        {
+            close(connection.client_socket);
+            close(connection.server_socket);
+        }
+        m_connections.clear();
+    }
+
+    void Accept()
+    {
+        const int client_socket = accept(m_listen_socket, nullptr, nullptr);
+        if (client_socket < 0)
+        {
+            return;
+        }
+        const int server_socket = socket(AF_INET, SOCK_STREAM, 0);
+        auto address = LocalAddress(m_server_port);
+        if (m_refuse || connect(server_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        {
+            close(server_socket);
+            close(client_socket);
+            return;
+        }
+        m_connections.push_back({client_socket, server_socket});
+    }
+
+    /**
+     * @brief Forwarding of the data of the socket to the other side of the connection.
+     * @return False if the connection is closed.
+     */
+    bool Forward(int from_socket, int to_socket, bool is_from_server)
+    {
+        std::array<char, 65536> buffer{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        auto size = recv(from_socket, buffer.data(), buffer.size(), 0);
+        if (size <= 0)
+        {
+            return false;
+        }
+        bool is_killed = false;
+        const size_t kill_after_bytes = m_kill_after_bytes;
+        if (is_from_server && kill_after_bytes != 0)
+        {
+            if (kill_after_bytes <= static_cast<size_t>(size))
+            {
+                size = static_cast<ssize_t>(kill_after_bytes);
+                m_kill_after_bytes = 0;
+                is_killed = true;
+            }
+            else
+            {
+                m_kill_after_bytes = kill_after_bytes - static_cast<size_t>(size);
+            }
+        }
+        for (ssize_t sent = 0; sent < size;)
+        {
+            const auto result = send(to_socket, buffer.data() + sent, static_cast<size_t>(size - sent), MSG_NOSIGNAL); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (result <= 0)
+            {
+                return false;
+            }
+            sent += result;
+        }
+        if (is_killed)
+        {
+            m_kill_requested = true;
+        }
+        return true;
+    }
+
+    void Run(const std::stop_token& stop_token)
+    {
+        while (!stop_token.stop_requested())
+        {
+            if (m_kill_requested)
+            {
+                CloseConnections();
+                m_kill_requested = false;
+            }
+            std::vector<pollfd> poll_fds{{m_listen_socket, POLLIN, 0}};
+            for (const auto& connection : m_connections)
+            {
+                poll_fds.push_back({connection.client_socket, POLLIN, 0});
+                poll_fds.push_back({connection.server_socket, POLLIN, 0});
+            }
+            if (poll(poll_fds.data(), poll_fds.size(), 10) <= 0) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            {
+                continue;
+            }
+            const size_t number_of_polled_connections = m_connections.size();
+            if ((poll_fds.at(0).revents & POLLIN) != 0) // NOLINT(hicpp-signed-bitwise)
+            {
+                Accept();
+            }
+            std::vector<Connection> alive_connections;
+            for (size_t index = 0; index < number_of_polled_connections; ++index)
+            {
+                const auto& connection = m_connections.at(index);
+                const auto client_events = poll_fds.at(1 + 2 * index).revents;
+                const auto server_events = poll_fds.at(2 + 2 * index).revents;
+                bool is_alive = true;
+                if (client_events != 0)
+                {
+                    is_alive = Forward(connection.client_socket, connection.server_socket, false);
+                }
+                if (is_alive && server_events != 0)
+                {
+                    is_alive = Forward(connection.server_socket, connection.client_socket, true);
+                }
+                if (is_alive)
+                {
+                    alive_connections.push_back(connection);
+                }
+                else
+                {
+                    close(connection.client_socket);
+                    close(connection.server_socket);
+                }
+            }
+            // The connections accepted in this iteration are not polled yet.
+            alive_connections.insert(alive_connections.end(), m_connections.begin() + static_cast<std::ptrdiff_t>(number_of_polled_connections), m_connections.end());
+            m_connections = std::move(alive_connections);
+        }
+    }
+
+    uint16_t m_server_port;
+    int m_listen_socket;
+    std::vector<Connection> m_connections; // Used only in the thread of the proxy
+    std::atomic_bool m_kill_requested{false};
+    std::atomic_bool m_refuse{false};
+    std::atomic_size_t m_kill_after_bytes{0};
+    std::jthread m_thread;
+};
+
 /**
  * @brief A function for comparing two std::optional<VariantsOfAttr> types by a simplified attribute. If there is a mismatch, doctest::CHECK is fired.
  *        First, the missing data is compared, then the comparison is compared based on the attribute.
@@ -557,6 +813,24 @@ TEST_SUITE("nodesetexporter::open62541")
                 }
             }
 
+            SUBCASE("The stop request does not interrupt the continuation points, the references of the batch are complete")
+            {
+                std::stop_source stop_source;
+                stop_source.request_stop();
+                auto stopped_client_wrapper = Open62541ClientWrapper(*client, cli_logger, stop_source.get_token());
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node1));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node2));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node3));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node4));
+                stopped_client_wrapper.SetRequestedMaxReferencesPerNode(1);
+                CHECK_EQ(stopped_client_wrapper.ReadNodeReferences(node_references_structure_lists).GetStatus(), StatusResults::Good);
+                REQUIRE_EQ(node_references_structure_lists.size(), test_node_references_structure_lists.size());
+                for (size_t index = 0; index < node_references_structure_lists.size(); ++index)
+                {
+                    CHECK_EQ(node_references_structure_lists.at(index).references.size(), test_node_references_structure_lists.at(index).references.size());
+                }
+            }
+
             SUBCASE("Request multi-site references with RequestedMaxReferencesPerNode from 0 to 5")
             {
                 for (size_t count_of_ref_per_node = 0; count_of_ref_per_node <= 5; count_of_ref_per_node++)
@@ -682,6 +956,54 @@ TEST_SUITE("nodesetexporter::open62541")
             }
         }
 
+        SUBCASE("ReadNodeDataValueRange")
+        {
+            const UATypesContainer<UA_ExpandedNodeId> large_array_id(UA_EXPANDEDNODEID_NODEID(large_array_node_id), UA_TYPES_EXPANDEDNODEID);
+            constexpr size_t chunk_size = 100000;
+
+            SUBCASE("The multi-megabyte array is read in parts")
+            {
+                size_t total_elements = 0;
+                size_t number_of_chunks = 0;
+                for (size_t first_index = 0;; first_index += chunk_size)
+                {
+                    auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                    REQUIRE_EQ(client_wrapper.ReadNodeDataValueRange(large_array_id, first_index, chunk_size, out).GetStatus(), StatusResults::Good);
+                    if (UA_Variant_isEmpty(&out.GetRef()))
+                    {
+                        break;
+                    }
+                    REQUIRE(UA_Variant_hasArrayType(&out.GetRef(), &UA_TYPES[UA_TYPES_DOUBLE]));
+                    REQUIRE_LE(out.GetRef().arrayLength, chunk_size);
+                    const auto* const data = static_cast<const UA_Double*>(out.GetRef().data);
+                    CHECK_EQ(data[0], static_cast<UA_Double>(first_index)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    CHECK_EQ(data[out.GetRef().arrayLength - 1], static_cast<UA_Double>(first_index + out.GetRef().arrayLength - 1)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    total_elements += out.GetRef().arrayLength;
+                    ++number_of_chunks;
+                    if (out.GetRef().arrayLength < chunk_size)
+                    {
+                        break;
+                    }
+                }
+                CHECK_EQ(total_elements, large_array_size);
+                CHECK_EQ(number_of_chunks, (large_array_size + chunk_size - 1) / chunk_size);
+            }
+
+            SUBCASE("The range after the end of the array is empty")
+            {
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(client_wrapper.ReadNodeDataValueRange(large_array_id, large_array_size, chunk_size, out).GetStatus(), StatusResults::Good);
+                CHECK(UA_Variant_isEmpty(&out.GetRef()));
+            }
+
+            SUBCASE("NO DATA = StatusResults::Fail")
+            {
+                auto test_loca_data = test_read_node_data_val.at("NO_DATA");
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(client_wrapper.ReadNodeDataValueRange(test_loca_data.node_id, 0, chunk_size, out).GetStatus(), StatusResults::Fail);
+            }
+        }
+
         SUBCASE("ReadNodesAtrrubutes")
         {
             std::vector<NodeAttributesRequestResponse> node_attr_structure_lists;
@@ -1065,6 +1387,141 @@ TEST_SUITE("nodesetexporter::open62541")
             }
         }
 
+        SUBCASE("Session recovery")
+        {
+            // The client is connected to the server through the proxy, which kills the connections.
+            ConnectionKillingProxy proxy(4841, 4840); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            auto* proxy_client = UA_Client_new();
+            auto* proxy_cli_config = UA_Client_getConfig(proxy_client);
+#ifdef OPEN62541_VER_1_3
+            proxy_cli_config->logger = LoggerPlugin::Open62541LoggerCreator(cli_logger);
+#elif defined(OPEN62541_VER_1_4)
+            proxy_cli_config->logging = &logging;
+            proxy_cli_config->eventLoop->logger = &logging;
+#endif
+            UA_ClientConfig_setDefault(proxy_cli_config);
+            REQUIRE(UA_StatusCode_isGood(UA_Client_connect(proxy_client, "opc.tcp://localhost:4841")));
+
+            std::stop_source stop_source;
+            auto proxy_client_wrapper = Open62541ClientWrapper(*proxy_client, cli_logger, stop_source.get_token());
+            size_t number_of_reconnections = 0;
+            SessionRecoveryPolicy policy;
+            policy.reconnect = [&](UA_Client& reconnected_client)
+            {
+                ++number_of_reconnections;
+                return UA_Client_connect(&reconnected_client, "opc.tcp://localhost:4841");
+            };
+            policy.retry_budget = 100; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            policy.initial_backoff = 0ms;
+            proxy_client_wrapper.SetSessionRecoveryPolicy(policy);
+
+            const auto check_references = [&](const std::vector<NodeReferencesRequestResponse>& node_references_structure_lists)
+            {
+                REQUIRE_EQ(node_references_structure_lists.size(), test_node_references_structure_lists.size());
+                for (size_t index = 0; index < node_references_structure_lists.size(); ++index)
+                {
+                    // The references received before the loss of the connection are not duplicated.
+                    CHECK_EQ(node_references_structure_lists.at(index).references.size(), test_node_references_structure_lists.at(index).references.size());
+                }
+            };
+            const auto request_references = [&]
+            {
+                std::vector<NodeReferencesRequestResponse> node_references_structure_lists;
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node1));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node2));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node3));
+                node_references_structure_lists.emplace_back(NodeReferencesRequestResponse(test_parent_node4));
+                CHECK_EQ(proxy_client_wrapper.ReadNodeReferences(node_references_structure_lists).GetStatus(), StatusResults::Good);
+                check_references(node_references_structure_lists);
+            };
+
+            SUBCASE("The request is issued again after the connection is killed")
+            {
+                proxy.KillConnections();
+                auto test_loca_data = test_read_node_data_val.at("UA_TYPES_DOUBLE");
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(proxy_client_wrapper.ReadNodeDataValue(test_loca_data.node_id, out).GetStatus(), StatusResults::Good);
+                CHECK_EQ(*static_cast<UA_Double*>(out.GetRef().data), std::get<UA_Double>(test_loca_data.result));
+                CHECK_EQ(proxy_client_wrapper.GetNumberOfRecoveredSessions(), number_of_reconnections);
+            }
+
+            SUBCASE("The browse with the continuation points is issued again from the beginning after the connection is killed at random points")
+            {
+                proxy_client_wrapper.SetRequestedMaxReferencesPerNode(1);
+                std::mt19937 random_generator(42); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                std::uniform_int_distribution<size_t> kill_after_bytes(1, 4096); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                for (size_t iteration = 0; iteration < 10; ++iteration) // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+                {
+                    proxy.KillAfterBytes(kill_after_bytes(random_generator));
+                    request_references();
+                }
+                CHECK_EQ(proxy_client_wrapper.GetNumberOfRecoveredSessions(), number_of_reconnections);
+            }
+
+            SUBCASE("The browsing of the nodes for the export is issued again after the connection is killed")
+            {
+                auto start_node_id = UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID("ns=2;i=1"), UA_TYPES_EXPANDEDNODEID);
+                std::vector<UATypesContainer<UA_ExpandedNodeId>> expected_node_ids;
+                REQUIRE_EQ(GrabChildNodeIdsFromStartNodeId(client, start_node_id, expected_node_ids), StatusResults::Good);
+
+                proxy.KillConnections();
+                std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids;
+                const auto status = GrabChildNodeIdsFromStartNodeId(
+                    proxy_client,
+                    start_node_id,
+                    node_ids,
+                    nullptr,
+                    nullptr,
+                    [&proxy_client_wrapper](const std::function<UA_StatusCode()>& request)
+                    {
+                        return proxy_client_wrapper.CallWithSessionRecovery("Browse", request);
+                    });
+                CHECK_EQ(status, StatusResults::Good);
+                // The children of the node browsed on the killed connection are not lost and not duplicated.
+                CHECK_EQ(node_ids.size(), expected_node_ids.size());
+                CHECK_GT(number_of_reconnections, 0);
+                CHECK_EQ(proxy_client_wrapper.GetNumberOfRecoveredSessions(), number_of_reconnections);
+            }
+
+            SUBCASE("The request fails when the reconnection attempts are exhausted")
+            {
+                proxy.SetRefuse(true);
+                proxy.KillConnections();
+                auto test_loca_data = test_read_node_data_val.at("UA_TYPES_DOUBLE");
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                CHECK_EQ(proxy_client_wrapper.ReadNodeDataValue(test_loca_data.node_id, out).GetStatus(), StatusResults::Fail);
+                CHECK_EQ(number_of_reconnections, policy.max_attempts_per_request);
+                CHECK_EQ(proxy_client_wrapper.GetNumberOfRecoveredSessions(), 0);
+
+                // The export continues after the server is available again.
+                proxy.SetRefuse(false);
+                request_references();
+            }
+
+            SUBCASE("The backoff is interrupted by the stop request")
+            {
+                policy.initial_backoff = 1h;
+                proxy_client_wrapper.SetSessionRecoveryPolicy(policy);
+                proxy.SetRefuse(true);
+                proxy.KillConnections();
+                std::jthread stop_thread(
+                    [&stop_source]
+                    {
+                        std::this_thread::sleep_for(100ms);
+                        stop_source.request_stop();
+                    });
+                auto test_loca_data = test_read_node_data_val.at("UA_TYPES_DOUBLE");
+                auto out = UATypesContainer<UA_Variant>(UA_TYPES_VARIANT);
+                auto result = proxy_client_wrapper.ReadNodeDataValue(test_loca_data.node_id, out);
+                CHECK_EQ(result.GetStatus(), StatusResults::Fail);
+                CHECK_EQ(result.GetSubStatus(), StatusResults::Cancelled);
+                CHECK_EQ(number_of_reconnections, 0);
+            }
+
+            UA_Client_disconnect(proxy_client);
+            UA_Client_delete(proxy_client);
+        }
+
         REQUIRE(UA_StatusCode_isGood(UA_Client_disconnect(client)));
         UA_Client_delete(client);
         running = false;
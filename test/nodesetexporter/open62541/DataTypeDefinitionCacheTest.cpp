@@ -0,0 +1,205 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/DataTypeDefinitionCache.h"
+#include "LogMacro.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <open62541/nodeids.h>
+#include <open62541/types.h>
+#include <open62541/types_generated_handling.h>
+
+#include <doctest/doctest.h>
+#include <doctest/trompeloeil.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using StatusResults = ::nodesetexporter::common::statuses::StatusResults<>;
+using LoggerBase = nodesetexporter::common::LoggerBase<std::string>;
+using nodesetexporter::interfaces::IOpen62541;
+using nodesetexporter::open62541::DataTypeDefinitionCache;
+using nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::typealiases::VariantsOfAttr;
+
+class MockOpen62541 : public trompeloeil::mock_interface<IOpen62541>
+{
+public:
+    explicit MockOpen62541(LoggerBase& logger)
+        : trompeloeil::mock_interface<IOpen62541>(logger)
+    {
+    }
+    IMPLEMENT_MOCK1(ReadNodeClasses);
+    IMPLEMENT_MOCK1(ReadNodeReferences);
+    IMPLEMENT_MOCK1(ReadNodesAttributes);
+    IMPLEMENT_MOCK2(ReadNodeDataValue);
+};
+
+// MotorState is an enumeration without the binary encoding, NoOfTags is the length field of the Tags array.
+constexpr auto test_type_dictionary = R"(<?xml version="1.0" encoding="utf-8"?>
+<opc:TypeDictionary xmlns:opc="http://opcfoundation.org/BinarySchema/" xmlns:ua="http://opcfoundation.org/UA/" xmlns:tns="urn:test:types"
+  DefaultByteOrder="LittleEndian" TargetNamespace="urn:test:types">
+  <opc:Import Namespace="http://opcfoundation.org/UA/"/>
+  <opc:EnumeratedType Name="MotorState" LengthInBits="32">
+    <opc:EnumeratedValue Name="Stopped" Value="0"/>
+    <opc:EnumeratedValue Name="Running" Value="1"/>
+  </opc:EnumeratedType>
+  <opc:StructuredType Name="MotorLimits" BaseType="ua:ExtensionObject">
+    <opc:Field Name="Min" TypeName="opc:Double"/>
+    <opc:Field Name="Max" TypeName="opc:Double"/>
+  </opc:StructuredType>
+  <opc:StructuredType Name="MotorData" BaseType="ua:ExtensionObject">
+    <opc:Field Name="Speed" TypeName="opc:Float"/>
+    <opc:Field Name="NoOfTags" TypeName="opc:Int32"/>
+    <opc:Field Name="Tags" TypeName="opc:String" LengthField="NoOfTags"/>
+    <opc:Field Name="State" TypeName="tns:MotorState"/>
+    <opc:Field Name="Limits" TypeName="tns:MotorLimits"/>
+    <opc:Field Name="Name" TypeName="opc:CharArray"/>
+  </opc:StructuredType>
+</opc:TypeDictionary>)";
+
+UATypesContainer<UA_ExpandedNodeId> MakeNodeId(UA_UInt32 identifier)
+{
+    return UATypesContainer<UA_ExpandedNodeId>(UA_EXPANDEDNODEID_NUMERIC(2, identifier), UA_TYPES_EXPANDEDNODEID);
+}
+
+UATypesContainer<UA_ReferenceDescription> MakeReference(UA_UInt32 reference_type, bool is_forward, UA_UInt32 target, const char* browse_name, UA_NodeClass node_class)
+{
+    UATypesContainer<UA_ReferenceDescription> reference(UA_TYPES_REFERENCEDESCRIPTION);
+    reference.GetRef().referenceTypeId = UA_NODEID_NUMERIC(0, reference_type);
+    reference.GetRef().isForward = is_forward;
+    reference.GetRef().nodeId = UA_EXPANDEDNODEID_NUMERIC(2, target);
+    reference.GetRef().browseName = UA_QUALIFIEDNAME_ALLOC(2, browse_name);
+    reference.GetRef().nodeClass = node_class;
+    return reference;
+}
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::DataTypeDefinitionCache") // NOLINT
+    {
+        using trompeloeil::_;
+        Logger logger("test");
+        logger.SetLevel(nodesetexporter::common::LogLevel::Debug);
+        MockOpen62541 open(logger);
+
+        // MotorData (i=100) and MotorLimits (i=110) are described in the dictionary (i=200), NoDictionaryType (i=120) has no binary encoding.
+        const auto motor_data_id = MakeNodeId(100);
+        const auto motor_limits_id = MakeNodeId(110);
+        const auto no_dictionary_type_id = MakeNodeId(120);
+        std::map<UATypesContainer<UA_ExpandedNodeId>, std::vector<UATypesContainer<UA_ReferenceDescription>>> references{
+            {motor_data_id, {MakeReference(UA_NS0ID_HASSUBTYPE, false, 22, "Structure", UA_NODECLASS_DATATYPE), MakeReference(UA_NS0ID_HASENCODING, true, 101, "Default Binary", UA_NODECLASS_OBJECT)}},
+            {MakeNodeId(101), {MakeReference(UA_NS0ID_HASENCODING, false, 100, "MotorData", UA_NODECLASS_DATATYPE), MakeReference(UA_NS0ID_HASDESCRIPTION, true, 102, "MotorData", UA_NODECLASS_VARIABLE)}},
+            {MakeNodeId(102), {MakeReference(UA_NS0ID_HASDESCRIPTION, false, 101, "Default Binary", UA_NODECLASS_OBJECT), MakeReference(UA_NS0ID_HASCOMPONENT, false, 200, "TestTypes", UA_NODECLASS_VARIABLE)}},
+            {motor_limits_id, {MakeReference(UA_NS0ID_HASENCODING, true, 111, "Default Binary", UA_NODECLASS_OBJECT)}},
+            {MakeNodeId(111), {MakeReference(UA_NS0ID_HASENCODING, false, 110, "MotorLimits", UA_NODECLASS_DATATYPE), MakeReference(UA_NS0ID_HASDESCRIPTION, true, 112, "MotorLimits", UA_NODECLASS_VARIABLE)}},
+            {MakeNodeId(112), {MakeReference(UA_NS0ID_HASDESCRIPTION, false, 111, "Default Binary", UA_NODECLASS_OBJECT), MakeReference(UA_NS0ID_HASCOMPONENT, false, 200, "TestTypes", UA_NODECLASS_VARIABLE)}},
+            {no_dictionary_type_id, {MakeReference(UA_NS0ID_HASSUBTYPE, false, 22, "Structure", UA_NODECLASS_DATATYPE)}},
+            {MakeNodeId(200),
+             {MakeReference(UA_NS0ID_HASPROPERTY, true, 201, "NamespaceUri", UA_NODECLASS_VARIABLE),
+              MakeReference(UA_NS0ID_HASCOMPONENT, true, 102, "MotorData", UA_NODECLASS_VARIABLE),
+              MakeReference(UA_NS0ID_HASCOMPONENT, true, 112, "MotorLimits", UA_NODECLASS_VARIABLE)}}};
+
+        size_t number_of_requests = 0;
+        size_t number_of_dictionary_reads = 0;
+        ALLOW_CALL(open, ReadNodeReferences(_))
+            .LR_SIDE_EFFECT(++number_of_requests)
+            .LR_SIDE_EFFECT(for (IOpen62541::NodeReferencesRequestResponse& nrrr
+                                 : _1) { nrrr.references = references.at(nrrr.exp_node_id); })
+            .RETURN(StatusResults::Good);
+        // The value of the description is the name of the type in the dictionary.
+        ALLOW_CALL(open, ReadNodesAttributes(_))
+            .LR_SIDE_EFFECT(++number_of_requests)
+            .LR_SIDE_EFFECT(for (IOpen62541::NodeAttributesRequestResponse& narr
+                                 : _1) {
+                const std::string type_name = narr.exp_node_id.GetRef().nodeId.identifier.numeric == 102 ? "MotorData" : "MotorLimits"; // NOLINT(cppcoreguidelines-pro-type-union-access)
+                UA_String ua_type_name = UA_STRING(const_cast<char*>(type_name.c_str())); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                UATypesContainer<UA_Variant> value(UA_TYPES_VARIANT);
+                UA_Variant_setScalarCopy(&value.GetRef(), &ua_type_name, &UA_TYPES[UA_TYPES_STRING]);
+                narr.attrs.insert_or_assign(UA_ATTRIBUTEID_VALUE, VariantsOfAttr(value));
+            })
+            .RETURN(StatusResults::Good);
+        ALLOW_CALL(open, ReadNodeDataValue(_, _))
+            .WITH(_1 == MakeNodeId(200))
+            .LR_SIDE_EFFECT(++number_of_requests)
+            .LR_SIDE_EFFECT(++number_of_dictionary_reads)
+            .LR_SIDE_EFFECT(UA_ByteString dictionary = UA_BYTESTRING(const_cast<char*>(test_type_dictionary)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                            UA_Variant_setScalarCopy(&_2.GetRef(), &dictionary, &UA_TYPES[UA_TYPES_BYTESTRING]);)
+            .RETURN(StatusResults::Good);
+
+        DataTypeDefinitionCache cache(open, logger);
+        std::vector<std::optional<VariantsOfAttr>> definitions;
+        REQUIRE_EQ(cache.ResolveFromDictionaries({motor_data_id, motor_limits_id, no_dictionary_type_id}, definitions), StatusResults::Good);
+        REQUIRE_EQ(definitions.size(), 3);
+        CHECK_EQ(number_of_dictionary_reads, 1);
+        CHECK_EQ(cache.GetNumberOfDefinitions(), 2);
+
+        SUBCASE("Structure fields")
+        {
+            REQUIRE(definitions.at(0).has_value());
+            const auto& motor_data = std::get<UATypesContainer<UA_StructureDefinition>>(definitions.at(0).value()).GetRef();
+            CHECK_EQ(motor_data.structureType, UA_STRUCTURETYPE_STRUCTURE);
+            const auto structure_id = UA_NODEID_NUMERIC(0, UA_NS0ID_STRUCTURE);
+            CHECK(UA_NodeId_equal(&motor_data.baseDataType, &structure_id));
+            const auto encoding_id = UA_NODEID_NUMERIC(2, 101);
+            CHECK(UA_NodeId_equal(&motor_data.defaultEncodingId, &encoding_id));
+
+            // The length field of the array is not the field of the definition.
+            REQUIRE_EQ(motor_data.fieldsSize, 5);
+            const std::vector<std::pair<std::string, UA_NodeId>> cmp_fields{
+                {"Speed", UA_NODEID_NUMERIC(0, UA_NS0ID_FLOAT)},
+                {"Tags", UA_NODEID_NUMERIC(0, UA_NS0ID_STRING)},
+                {"State", UA_NODEID_NUMERIC(0, UA_NS0ID_ENUMERATION)},
+                {"Limits", UA_NODEID_NUMERIC(2, 110)},
+                {"Name", UA_NODEID_NUMERIC(0, UA_NS0ID_STRING)}};
+            for (size_t index = 0; index < cmp_fields.size(); ++index)
+            {
+                const auto& field = motor_data.fields[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                CHECK_EQ(std::string(reinterpret_cast<const char*>(field.name.data), field.name.length), cmp_fields.at(index).first); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                CHECK(UA_NodeId_equal(&field.dataType, &cmp_fields.at(index).second));
+                CHECK_EQ(field.valueRank, index == 1 ? UA_VALUERANK_ONE_DIMENSION : UA_VALUERANK_SCALAR);
+                CHECK_FALSE(field.isOptional);
+            }
+
+            REQUIRE(definitions.at(1).has_value());
+            CHECK_EQ(std::get<UATypesContainer<UA_StructureDefinition>>(definitions.at(1).value()).GetRef().fieldsSize, 2);
+            CHECK_FALSE(definitions.at(2).has_value());
+        }
+
+        SUBCASE("The resolved and the missing definitions are not requested again")
+        {
+            const auto number_of_first_requests = number_of_requests;
+            std::vector<std::optional<VariantsOfAttr>> cached_definitions;
+            REQUIRE_EQ(cache.ResolveFromDictionaries({motor_limits_id, no_dictionary_type_id, motor_data_id}, cached_definitions), StatusResults::Good);
+            CHECK_EQ(number_of_requests, number_of_first_requests);
+            REQUIRE_EQ(cached_definitions.size(), 3);
+            CHECK(cached_definitions.at(0).has_value());
+            CHECK_FALSE(cached_definitions.at(1).has_value());
+            CHECK(cached_definitions.at(2).has_value());
+        }
+
+        SUBCASE("Aliases of the field data types")
+        {
+            REQUIRE(definitions.at(0).has_value());
+            const auto& aliases = cache.GetFieldDataTypeAliases(motor_data_id, definitions.at(0).value());
+            REQUIRE_EQ(aliases.size(), 3); // String is used twice, the custom type has no alias
+            CHECK_EQ(aliases.at(0).first, "Float");
+            CHECK_EQ(aliases.at(1).first, "String");
+            CHECK_EQ(aliases.at(2).first, "Enumeration");
+            CHECK_EQ(&cache.GetFieldDataTypeAliases(motor_data_id, definitions.at(0).value()), &aliases); // Calculated once
+        }
+    }
+}
@@ -0,0 +1,125 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/DiscoveryRules.h"
+#include "LogMacro.h"
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::open62541::discovery::DiscoveryFilter;
+using nodesetexporter::open62541::discovery::DiscoveryRule;
+using nodesetexporter::open62541::discovery::GlobMatch;
+using nodesetexporter::open62541::discovery::MakeMaxDepthRule;
+using nodesetexporter::open62541::discovery::ParseDiscoveryRule;
+using nodesetexporter::open62541::discovery::RuleAction;
+using nodesetexporter::open62541::discovery::StatusResults;
+
+TEST_LOGGER_INIT
+
+namespace
+{
+DiscoveryRule Parse(std::string_view text, Logger& logger)
+{
+    DiscoveryRule rule;
+    REQUIRE_EQ(ParseDiscoveryRule(text, rule, logger), StatusResults::Good);
+    return rule;
+}
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::discovery::GlobMatch")
+    {
+        CHECK(GlobMatch("Diagnostics*", "DiagnosticsSummary"));
+        CHECK(GlobMatch("*Debug*", "VendorDebugFolder"));
+        CHECK(GlobMatch("Tag_??", "Tag_01"));
+        CHECK(GlobMatch("*", ""));
+        CHECK_FALSE(GlobMatch("Tag_??", "Tag_1"));
+        CHECK_FALSE(GlobMatch("*Debug", "DebugFolder"));
+        CHECK_FALSE(GlobMatch("", "Tag"));
+    }
+
+    TEST_CASE("nodesetexporter::open62541::discovery::ParseDiscoveryRule")
+    {
+        Logger logger("test");
+        DiscoveryRule rule;
+
+        SUBCASE("The criteria of the rule")
+        {
+            rule = Parse("exclude  name=Diag* ns=2 class=Object|Variable reftype=HasComponent maxdepth=3", logger);
+            CHECK_EQ(rule.action, RuleAction::Exclude);
+            CHECK_EQ(rule.browse_name_glob, "Diag*");
+            CHECK_EQ(rule.namespace_index, 2);
+            CHECK_EQ(rule.node_class_mask, UA_NODECLASS_OBJECT | UA_NODECLASS_VARIABLE);
+            REQUIRE(rule.reference_type_id.has_value());
+            CHECK_EQ(rule.reference_type_id->GetRef().identifier.numeric, UA_NS0ID_HASCOMPONENT); // NOLINT(cppcoreguidelines-pro-type-union-access)
+            CHECK_EQ(rule.max_depth, 3);
+
+            // The value of the NodeId pattern contains '='.
+            rule = Parse("include nodeid=ns=2;s=Debug\\..* reftype=ns=1;i=5000", logger);
+            CHECK_EQ(rule.action, RuleAction::Include);
+            CHECK(rule.node_id_regex.has_value());
+            REQUIRE(rule.reference_type_id.has_value());
+            CHECK_EQ(rule.reference_type_id->GetRef().namespaceIndex, 1);
+        }
+
+        SUBCASE("Invalid rules")
+        {
+            CHECK_EQ(ParseDiscoveryRule("drop name=Diag*", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude color=red", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude name=", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude ns=70000", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude class=Folder", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude nameregex=([a-z", rule, logger), StatusResults::Fail);
+            CHECK_EQ(ParseDiscoveryRule("exclude reftype=NotAReference", rule, logger), StatusResults::Fail);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::open62541::discovery::DiscoveryFilter")
+    {
+        Logger logger("test");
+        const UA_NodeId organizes = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+        const UA_NodeId has_component = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+        const UA_NodeId folder_id = UA_NODEID_STRING(2, const_cast<char*>("Device.Diagnostics")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        const UA_NodeId tag_id = UA_NODEID_STRING(2, const_cast<char*>("Device.Temperature")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        const UA_QualifiedName folder_name = UA_QUALIFIEDNAME(2, const_cast<char*>("Diagnostics")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        const UA_QualifiedName tag_name = UA_QUALIFIEDNAME(2, const_cast<char*>("Temperature")); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+
+        SUBCASE("Without the rules all nodes are accepted")
+        {
+            DiscoveryFilter filter;
+            CHECK_FALSE(filter.IsEnabled());
+            CHECK(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, organizes, 1}));
+        }
+
+        SUBCASE("The first matched rule decides, the hits are counted")
+        {
+            DiscoveryFilter filter({Parse("include name=Diagnostics reftype=HasComponent", logger), Parse("exclude name=Diag*", logger), Parse("exclude nodeid=ns=2;s=.*\\.Temp.*", logger)});
+            REQUIRE(filter.IsEnabled());
+            CHECK(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, has_component, 1}));
+            CHECK_FALSE(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, organizes, 1}));
+            CHECK_FALSE(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, organizes, 2}));
+            CHECK_FALSE(filter.Accept({tag_id, tag_name, UA_NODECLASS_VARIABLE, has_component, 2}));
+            CHECK(filter.Accept({tag_id, folder_name, UA_NODECLASS_VARIABLE, has_component, 2}));
+            CHECK_EQ(filter.GetHits(), std::vector<size_t>{2, 2, 1});
+            filter.ReportHits(logger);
+        }
+
+        SUBCASE("The depth and the node class")
+        {
+            DiscoveryFilter filter({MakeMaxDepthRule(2), Parse("exclude ns=2 class=Variable", logger)});
+            CHECK(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, organizes, 2}));
+            CHECK_FALSE(filter.Accept({folder_id, folder_name, UA_NODECLASS_OBJECT, organizes, 3}));
+            CHECK_FALSE(filter.Accept({tag_id, tag_name, UA_NODECLASS_VARIABLE, has_component, 1}));
+            CHECK_EQ(filter.GetHits(), std::vector<size_t>{1, 1});
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,83 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/ExportEstimator.h"
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::open62541::estimation::batch_memory_budget;
+using nodesetexporter::open62541::estimation::estimated_model_bytes_per_node;
+using nodesetexporter::open62541::estimation::Forecast;
+using nodesetexporter::open62541::estimation::PickBatchSize;
+using nodesetexporter::open62541::estimation::requests_per_batch;
+using nodesetexporter::open62541::estimation::SubtreeCensus;
+using nodesetexporter::open62541::transport::RequestLimits;
+using namespace std::literals;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::estimation::PickBatchSize")
+    {
+        SUBCASE("Without the limits of the server the batch is limited by the memory budget")
+        {
+            CHECK_EQ(PickBatchSize(1e7, RequestLimits{}), batch_memory_budget / estimated_model_bytes_per_node);
+        }
+
+        SUBCASE("The limits of the server decrease the batch")
+        {
+            CHECK_EQ(PickBatchSize(1e7, RequestLimits{0, 1600}), 100);
+        }
+
+        SUBCASE("The small export is made in one batch")
+        {
+            CHECK_EQ(PickBatchSize(42.3, RequestLimits{}), 43);
+            CHECK_EQ(PickBatchSize(0, RequestLimits{0, 1}), 1);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::open62541::estimation::Forecast")
+    {
+        SubtreeCensus census;
+        census.number_of_nodes = 1000;
+        census.nodes_per_class = {{UA_NODECLASS_OBJECT, 100}, {UA_NODECLASS_VARIABLE, 880}, {UA_NODECLASS_METHOD, 20}};
+        census.nodes_per_namespace = {{2, 1000}};
+
+        SUBCASE("The Method nodes are not exported, the configured batch size is kept")
+        {
+            const auto estimate = Forecast(census, RequestLimits{}, 100);
+            CHECK_EQ(estimate.number_of_exported_nodes, doctest::Approx(980));
+            CHECK_EQ(estimate.batch_size, 100);
+            CHECK_EQ(estimate.number_of_requests, doctest::Approx(10 * requests_per_batch));
+            CHECK_GT(estimate.output_bytes, 0);
+            CHECK_GT(estimate.response_bytes, 0);
+            CHECK_GT(estimate.runtime.count(), 0);
+        }
+
+        SUBCASE("The batch size is picked if it is not configured")
+        {
+            const auto estimate = Forecast(census, RequestLimits{}, 0);
+            CHECK_EQ(estimate.batch_size, 980);
+            CHECK_EQ(estimate.number_of_requests, doctest::Approx(requests_per_batch));
+        }
+
+        SUBCASE("The runtime grows with the measured latency of the requests")
+        {
+            const auto unmeasured = Forecast(census, RequestLimits{}, 10);
+            census.number_of_browsed_nodes = 10;
+            census.number_of_browse_requests = 10;
+            census.browse_response_bytes = 1000;
+            census.browse_time = 1s;
+            const auto measured = Forecast(census, RequestLimits{}, 10);
+            // 392 requests with the latency of 100 ms.
+            CHECK_GE(measured.runtime, 39s);
+            CHECK_GT(measured.runtime, unmeasured.runtime);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,115 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/LocalizedTexts.h"
+#include "nodesetexporter/common/Strings.h"
+
+#include <open62541/client_config_default.h>
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::common::UaStringToStdString;
+using nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::locales::ApplySessionLocales;
+using nodesetexporter::open62541::locales::SplitMultiLocaleText;
+using nodesetexporter::open62541::locales::StatusResults;
+
+namespace
+{
+UATypesContainer<UA_LocalizedText> MakeText(const char* locale, const char* text)
+{
+    UATypesContainer<UA_LocalizedText> localized_text(UA_TYPES_LOCALIZEDTEXT);
+    localized_text.GetRef() = UA_LOCALIZEDTEXT_ALLOC(locale, text);
+    return localized_text;
+}
+
+void CheckText(const UATypesContainer<UA_LocalizedText>& text, const std::string& locale, const std::string& value)
+{
+    CHECK_EQ(UaStringToStdString(text.GetRef().locale), locale);
+    CHECK_EQ(UaStringToStdString(text.GetRef().text), value);
+}
+} // namespace
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::locales::SplitMultiLocaleText")
+    {
+        std::vector<UATypesContainer<UA_LocalizedText>> texts;
+
+        SUBCASE("The text of the other locale is returned as is")
+        {
+            REQUIRE_EQ(SplitMultiLocaleText(MakeText("en", "Pump").GetRef(), {"de"}, texts), StatusResults::Good);
+            REQUIRE_EQ(texts.size(), 1);
+            CheckText(texts.at(0), "en", "Pump");
+        }
+
+        SUBCASE("The translations are returned in the order of the requested locales")
+        {
+            const auto text = MakeText("mul", R"({"t":[["en","Pump"],["fr","Pompe"],["de","Pumpe"]]})");
+            REQUIRE_EQ(SplitMultiLocaleText(text.GetRef(), {"de", "en"}, texts), StatusResults::Good);
+            REQUIRE_EQ(texts.size(), 2);
+            CheckText(texts.at(0), "de", "Pumpe");
+            CheckText(texts.at(1), "en", "Pump");
+        }
+
+        SUBCASE("All translations are returned if none of the requested locales is present")
+        {
+            const auto text = MakeText("mul", R"( { "t" : [ ["en", "Pump"], ["fr", "Pompe"] ] } )");
+            REQUIRE_EQ(SplitMultiLocaleText(text.GetRef(), {"ja"}, texts), StatusResults::Good);
+            REQUIRE_EQ(texts.size(), 2);
+            CheckText(texts.at(0), "en", "Pump");
+            CheckText(texts.at(1), "fr", "Pompe");
+
+            REQUIRE_EQ(SplitMultiLocaleText(MakeText("mul", R"({"t":[]})").GetRef(), {}, texts), StatusResults::Good);
+            CHECK(texts.empty());
+        }
+
+        SUBCASE("The escape sequences are decoded")
+        {
+            const auto text = MakeText("mul", R"({"t":[["de","Pumpe \"A\"\n\u00dcberlauf \ud83d\ude00"]]})");
+            REQUIRE_EQ(SplitMultiLocaleText(text.GetRef(), {"de"}, texts), StatusResults::Good);
+            REQUIRE_EQ(texts.size(), 1);
+            CheckText(texts.at(0), "de", "Pumpe \"A\"\n\xC3\x9C" "berlauf \xF0\x9F\x98\x80");
+        }
+
+        SUBCASE("The text in the unexpected form is rejected")
+        {
+            CHECK_EQ(SplitMultiLocaleText(MakeText("mul", "Pump").GetRef(), {"en"}, texts), StatusResults::Fail);
+            CHECK_EQ(SplitMultiLocaleText(MakeText("mul", R"({"t":[["en","Pump"]})").GetRef(), {"en"}, texts), StatusResults::Fail);
+            CHECK_EQ(SplitMultiLocaleText(MakeText("mul", R"({"t":[["en"]]})").GetRef(), {"en"}, texts), StatusResults::Fail);
+            CHECK_EQ(SplitMultiLocaleText(MakeText("mul", R"({"t":[["en","Pump"]]} x)").GetRef(), {"en"}, texts), StatusResults::Fail);
+            CHECK_EQ(SplitMultiLocaleText(MakeText("mul", R"({"t":[["en","\ud83d"]]})").GetRef(), {"en"}, texts), StatusResults::Fail);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::open62541::locales::ApplySessionLocales")
+    {
+        auto* client = UA_Client_new();
+        auto* cli_config = UA_Client_getConfig(client);
+
+        SUBCASE("The locale \"mul\" is requested first")
+        {
+            REQUIRE_EQ(ApplySessionLocales(*cli_config, {"de-DE", "en"}), StatusResults::Good);
+            REQUIRE_EQ(cli_config->sessionLocaleIdsSize, 3);
+            CHECK_EQ(UaStringToStdString(cli_config->sessionLocaleIds[0]), "mul"); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            CHECK_EQ(UaStringToStdString(cli_config->sessionLocaleIds[1]), "de-DE"); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            CHECK_EQ(UaStringToStdString(cli_config->sessionLocaleIds[2]), "en"); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        SUBCASE("The configuration is not changed without the locales or with the empty locale")
+        {
+            const auto size = cli_config->sessionLocaleIdsSize;
+            REQUIRE_EQ(ApplySessionLocales(*cli_config, {}), StatusResults::Good);
+            CHECK_EQ(cli_config->sessionLocaleIdsSize, size);
+            CHECK_EQ(ApplySessionLocales(*cli_config, {"en", ""}), StatusResults::Fail);
+            CHECK_EQ(cli_config->sessionLocaleIdsSize, size);
+        }
+
+        UA_Client_delete(client);
+    }
+}
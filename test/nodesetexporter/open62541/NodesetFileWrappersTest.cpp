@@ -0,0 +1,272 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/NodesetFileWrappers.h"
+#include "LogMacro.h"
+#include "nodesetexporter/NodesetExporter.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <doctest/doctest.h>
+#include <libxml++/libxml++.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using StatusResults = ::nodesetexporter::common::statuses::StatusResults<>;
+using nodesetexporter::ExportNodesetFromNodesetFile;
+using nodesetexporter::interfaces::IOpen62541;
+using nodesetexporter::open62541::Open62541NodesetFileWrapper;
+using nodesetexporter::open62541::UATypesContainer;
+
+// The reference from the object to "temperature" is declared only in the object, the reverse one only in "setpoint".
+constexpr auto test_nodeset = R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns:uax="http://opcfoundation.org/UA/2008/02/Types.xsd" xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <NamespaceUris>
+    <Uri>http://test/file/1</Uri>
+  </NamespaceUris>
+  <Aliases>
+    <Alias Alias="Double">i=11</Alias>
+    <Alias Alias="HasComponent">i=47</Alias>
+    <Alias Alias="HasTypeDefinition">i=40</Alias>
+    <Alias Alias="Organizes">i=35</Alias>
+  </Aliases>
+  <UAObject NodeId="ns=1;i=1" BrowseName="1:Device">
+    <DisplayName>Device</DisplayName>
+    <References>
+      <Reference ReferenceType="Organizes" IsForward="false">i=85</Reference>
+      <Reference ReferenceType="HasTypeDefinition">i=58</Reference>
+      <Reference ReferenceType="HasComponent">ns=1;i=2</Reference>
+      <Reference ReferenceType="HasComponent">ns=1;i=2</Reference>
+    </References>
+  </UAObject>
+  <UAVariable NodeId="ns=1;i=2" BrowseName="1:temperature" DataType="Double" AccessLevel="3">
+    <DisplayName>temperature</DisplayName>
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+    </References>
+    <Value>
+      <uax:Double>45.5</uax:Double>
+    </Value>
+  </UAVariable>
+  <UAVariable NodeId="ns=1;i=3" BrowseName="1:setpoint" DataType="Double" ValueRank="1" ArrayDimensions="2">
+    <DisplayName>setpoint</DisplayName>
+    <References>
+      <Reference ReferenceType="HasComponent" IsForward="false">ns=1;i=1</Reference>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+    </References>
+    <Value>
+      <uax:ListOfDouble>
+        <uax:Double>1.5</uax:Double>
+        <uax:Double>2.5</uax:Double>
+      </uax:ListOfDouble>
+    </Value>
+  </UAVariable>
+</UANodeSet>)";
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::Open62541NodesetFileWrapper") // NOLINT
+    {
+        Logger logger("test");
+        logger.SetLevel(nodesetexporter::common::LogLevel::Debug);
+        Open62541NodesetFileWrapper nodeset_file(logger);
+        REQUIRE_EQ(nodeset_file.LoadFromMemory(test_nodeset), StatusResults::Good);
+        CHECK_EQ(nodeset_file.GetNumberOfNodes(), 3);
+        CHECK_EQ(nodeset_file.GetNamespaceArray(), std::vector<std::string>{"http://opcfoundation.org/UA/", "http://test/file/1"});
+
+        UATypesContainer<UA_ExpandedNodeId> object_id(UA_EXPANDEDNODEID_NUMERIC(1, 1), UA_TYPES_EXPANDEDNODEID);
+        UATypesContainer<UA_ExpandedNodeId> temperature_id(UA_EXPANDEDNODEID_NUMERIC(1, 2), UA_TYPES_EXPANDEDNODEID);
+        UATypesContainer<UA_ExpandedNodeId> setpoint_id(UA_EXPANDEDNODEID_NUMERIC(1, 3), UA_TYPES_EXPANDEDNODEID);
+        UATypesContainer<UA_ExpandedNodeId> unknown_id(UA_EXPANDEDNODEID_NUMERIC(1, 999), UA_TYPES_EXPANDEDNODEID);
+
+        SUBCASE("Node classes")
+        {
+            std::vector<IOpen62541::NodeClassesRequestResponse> node_classes{object_id, temperature_id, unknown_id};
+            REQUIRE_EQ(nodeset_file.ReadNodeClasses(node_classes), StatusResults::Good);
+            CHECK_EQ(node_classes.at(0).node_class, UA_NODECLASS_OBJECT);
+            CHECK_EQ(node_classes.at(0).result_code, UA_STATUSCODE_GOOD);
+            CHECK_EQ(node_classes.at(1).node_class, UA_NODECLASS_VARIABLE);
+            CHECK_EQ(node_classes.at(2).node_class, UA_NODECLASS_UNSPECIFIED);
+            CHECK_EQ(node_classes.at(2).result_code, UA_STATUSCODE_BADNODEIDUNKNOWN);
+        }
+
+        SUBCASE("Attributes with the default values and the values")
+        {
+            std::vector<IOpen62541::NodeAttributesRequestResponse> node_attrs{
+                {temperature_id,
+                 {{UA_ATTRIBUTEID_DATATYPE, std::nullopt},
+                  {UA_ATTRIBUTEID_VALUERANK, std::nullopt},
+                  {UA_ATTRIBUTEID_ACCESSLEVEL, std::nullopt},
+                  {UA_ATTRIBUTEID_HISTORIZING, std::nullopt},
+                  {UA_ATTRIBUTEID_DESCRIPTION, std::nullopt},
+                  {UA_ATTRIBUTEID_VALUE, std::nullopt}}},
+                {setpoint_id, {{UA_ATTRIBUTEID_VALUERANK, std::nullopt}, {UA_ATTRIBUTEID_ARRAYDIMENSIONS, std::nullopt}, {UA_ATTRIBUTEID_VALUE, std::nullopt}}},
+                {object_id, {{UA_ATTRIBUTEID_EVENTNOTIFIER, std::nullopt}, {UA_ATTRIBUTEID_VALUE, std::nullopt}}}};
+            REQUIRE_EQ(nodeset_file.ReadNodesAttributes(node_attrs), StatusResults::Good);
+
+            const auto& temperature_attrs = node_attrs.at(0).attrs;
+            const auto& data_type = std::get<UATypesContainer<UA_NodeId>>(temperature_attrs.at(UA_ATTRIBUTEID_DATATYPE).value());
+            CHECK(UA_NodeId_equal(&data_type.GetRef(), &UA_TYPES[UA_TYPES_DOUBLE].typeId)); // Resolved by the alias
+            CHECK_EQ(std::get<UA_Int32>(temperature_attrs.at(UA_ATTRIBUTEID_VALUERANK).value()), -1);
+            CHECK_EQ(std::get<UA_Byte>(temperature_attrs.at(UA_ATTRIBUTEID_ACCESSLEVEL).value()), 3);
+            CHECK_FALSE(std::get<UA_Boolean>(temperature_attrs.at(UA_ATTRIBUTEID_HISTORIZING).value()));
+            CHECK_EQ(std::get<UATypesContainer<UA_LocalizedText>>(temperature_attrs.at(UA_ATTRIBUTEID_DESCRIPTION).value()).GetRef().text.length, 0);
+            const auto& temperature_value = std::get<UATypesContainer<UA_Variant>>(temperature_attrs.at(UA_ATTRIBUTEID_VALUE).value()).GetRef();
+            REQUIRE(UA_Variant_hasScalarType(&temperature_value, &UA_TYPES[UA_TYPES_DOUBLE]));
+            CHECK_EQ(*static_cast<UA_Double*>(temperature_value.data), doctest::Approx(45.5));
+
+            const auto& setpoint_attrs = node_attrs.at(1).attrs;
+            CHECK_EQ(std::get<UA_Int32>(setpoint_attrs.at(UA_ATTRIBUTEID_VALUERANK).value()), 1);
+            CHECK_EQ(std::get<std::vector<UA_UInt32>>(setpoint_attrs.at(UA_ATTRIBUTEID_ARRAYDIMENSIONS).value()), std::vector<UA_UInt32>{2});
+            const auto& setpoint_value = std::get<UATypesContainer<UA_Variant>>(setpoint_attrs.at(UA_ATTRIBUTEID_VALUE).value()).GetRef();
+            REQUIRE(UA_Variant_hasArrayType(&setpoint_value, &UA_TYPES[UA_TYPES_DOUBLE]));
+            REQUIRE_EQ(setpoint_value.arrayLength, 2);
+            CHECK_EQ(static_cast<UA_Double*>(setpoint_value.data)[1], doctest::Approx(2.5)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            // The attribute not applicable to the class is empty.
+            const auto& object_attrs = node_attrs.at(2).attrs;
+            CHECK_EQ(std::get<UA_Byte>(object_attrs.at(UA_ATTRIBUTEID_EVENTNOTIFIER).value()), 0);
+            CHECK_FALSE(object_attrs.at(UA_ATTRIBUTEID_VALUE).has_value());
+        }
+
+        SUBCASE("References in both directions")
+        {
+            std::vector<IOpen62541::NodeReferencesRequestResponse> node_refs{object_id, temperature_id, unknown_id};
+            REQUIRE_EQ(nodeset_file.ReadNodeReferences(node_refs), StatusResults::Good);
+
+            // Organizes i=85 (inverse), HasTypeDefinition, HasComponent to "temperature" (the duplicate is removed) and to "setpoint" (synthesized)
+            CHECK_EQ(node_refs.at(0).references.size(), 4);
+            size_t has_component_count = 0;
+            for (const auto& ref : node_refs.at(0).references)
+            {
+                if (UA_NodeId_equal(&ref.GetRef().referenceTypeId, &UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT)) == UA_TRUE)
+                {
+                    CHECK(ref.GetRef().isForward);
+                    CHECK_EQ(ref.GetRef().nodeClass, UA_NODECLASS_VARIABLE); // The data of the target node is filled
+                    has_component_count++;
+                }
+            }
+            CHECK_EQ(has_component_count, 2);
+
+            // HasTypeDefinition and the synthesized inverse HasComponent to the object
+            REQUIRE_EQ(node_refs.at(1).references.size(), 2);
+            bool is_inverse_found = false;
+            for (const auto& ref : node_refs.at(1).references)
+            {
+                if (!ref.GetRef().isForward)
+                {
+                    is_inverse_found = true;
+                    CHECK(UA_NodeId_equal(&ref.GetRef().nodeId.nodeId, &object_id.GetRef().nodeId));
+                    CHECK_EQ(ref.GetRef().nodeClass, UA_NODECLASS_OBJECT);
+                }
+            }
+            CHECK(is_inverse_found);
+            CHECK(node_refs.at(2).references.empty());
+        }
+
+        SUBCASE("Collecting the child nodes")
+        {
+            std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids;
+            REQUIRE_EQ(nodeset_file.GrabChildNodeIdsFromStartNodeId(object_id, node_ids), StatusResults::Good);
+            REQUIRE_EQ(node_ids.size(), 3);
+            CHECK_EQ(node_ids.at(0), object_id);
+            CHECK_EQ(node_ids.at(1), temperature_id);
+            CHECK_EQ(node_ids.at(2), setpoint_id);
+
+            node_ids.clear();
+            CHECK_EQ(nodeset_file.GrabChildNodeIdsFromStartNodeId(unknown_id, node_ids), StatusResults::Fail);
+        }
+
+        SUBCASE("Collecting the child nodes with the include/exclude rules")
+        {
+            nodesetexporter::open62541::discovery::DiscoveryRule rule;
+            REQUIRE_EQ(nodesetexporter::open62541::discovery::ParseDiscoveryRule("exclude name=set* class=Variable", rule, logger), StatusResults::Good);
+            nodesetexporter::open62541::discovery::DiscoveryFilter filter({rule});
+            std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids;
+            REQUIRE_EQ(nodeset_file.GrabChildNodeIdsFromStartNodeId(object_id, node_ids, &filter), StatusResults::Good);
+            REQUIRE_EQ(node_ids.size(), 2);
+            CHECK_EQ(node_ids.at(0), object_id);
+            CHECK_EQ(node_ids.at(1), temperature_id);
+            CHECK_EQ(filter.GetHits(), std::vector<size_t>{1});
+
+            // The children of the start node have the depth 1.
+            nodesetexporter::open62541::discovery::DiscoveryFilter depth_filter({nodesetexporter::open62541::discovery::MakeMaxDepthRule(0)});
+            node_ids.clear();
+            REQUIRE_EQ(nodeset_file.GrabChildNodeIdsFromStartNodeId(object_id, node_ids, &depth_filter), StatusResults::Good);
+            CHECK_EQ(node_ids.size(), 1);
+        }
+
+        SUBCASE("Namespace array")
+        {
+            UATypesContainer<UA_ExpandedNodeId> namespace_array_id(UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY), UA_TYPES_EXPANDEDNODEID);
+            UATypesContainer<UA_Variant> namespace_array(UA_TYPES_VARIANT);
+            REQUIRE_EQ(nodeset_file.ReadNodeDataValue(namespace_array_id, namespace_array), StatusResults::Good);
+            REQUIRE(UA_Variant_hasArrayType(&namespace_array.GetRef(), &UA_TYPES[UA_TYPES_STRING]));
+            CHECK_EQ(namespace_array.GetRef().arrayLength, 2);
+        }
+
+        SUBCASE("Part of the array value")
+        {
+            UATypesContainer<UA_Variant> part(UA_TYPES_VARIANT);
+            REQUIRE_EQ(nodeset_file.ReadNodeDataValueRange(setpoint_id, 1, 5, part), StatusResults::Good); // The range is cut by the end of the array
+            REQUIRE(UA_Variant_hasArrayType(&part.GetRef(), &UA_TYPES[UA_TYPES_DOUBLE]));
+            REQUIRE_EQ(part.GetRef().arrayLength, 1);
+            CHECK_EQ(static_cast<UA_Double*>(part.GetRef().data)[0], doctest::Approx(2.5)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            UATypesContainer<UA_Variant> after_end(UA_TYPES_VARIANT);
+            REQUIRE_EQ(nodeset_file.ReadNodeDataValueRange(setpoint_id, 2, 5, after_end), StatusResults::Good);
+            CHECK(UA_Variant_isEmpty(&after_end.GetRef()));
+
+            // The scalar value cannot be read by parts.
+            UATypesContainer<UA_Variant> scalar(UA_TYPES_VARIANT);
+            CHECK_EQ(nodeset_file.ReadNodeDataValueRange(temperature_id, 0, 5, scalar), StatusResults::Fail);
+        }
+
+        SUBCASE("Invalid document")
+        {
+            CHECK_EQ(nodeset_file.LoadFromMemory("<NotNodeSet/>"), StatusResults::Fail);
+            CHECK_EQ(nodeset_file.GetNumberOfNodes(), 0);
+            CHECK_EQ(nodeset_file.LoadFromMemory(R"(<UANodeSet><UAObject BrowseName="1:NoNodeId"/></UANodeSet>)"), StatusResults::Fail);
+            CHECK_EQ(nodeset_file.LoadFromFile("not_existing_nodeset.xml"), StatusResults::Fail);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::open62541::Open62541NodesetFileWrapper - export from the NodeSet file") // NOLINT
+    {
+        Logger logger("test");
+        Open62541NodesetFileWrapper nodeset_file(logger);
+        REQUIRE_EQ(nodeset_file.LoadFromFile("nodeset.xml"), StatusResults::Good);
+
+        // vPLC1 in the namespace indices of the file
+        UATypesContainer<UA_ExpandedNodeId> start_node_id(UA_EXPANDEDNODEID_NUMERIC(1, 1), UA_TYPES_EXPANDEDNODEID);
+        std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids;
+        REQUIRE_EQ(nodeset_file.GrabChildNodeIdsFromStartNodeId(start_node_id, node_ids), StatusResults::Good);
+        CHECK_GT(node_ids.size(), 1);
+
+        std::stringstream out_buffer;
+        nodesetexporter::Options opt;
+        opt.logger = logger;
+        std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>> node_ids_export{{"ns=1;i=1", std::move(node_ids)}};
+        REQUIRE_EQ(ExportNodesetFromNodesetFile(nodeset_file, node_ids_export, "", out_buffer, opt), StatusResults::Good);
+
+        xmlpp::XsdValidator valid("UANodeSet.xsd"); // Schema for XML validation
+        xmlpp::DomParser parser;
+        parser.parse_memory(out_buffer.str());
+        CHECK_NOTHROW(valid.validate(parser.get_document()));
+        CHECK_NE(out_buffer.str().find(R"(BrowseName="1:vPLC1")"), std::string::npos);
+        CHECK_NE(out_buffer.str().find("<Uri>http://test/nodes/1</Uri>"), std::string::npos);
+    }
+}
@@ -0,0 +1,103 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/QuirkFixers.h"
+#include "LogMacro.h"
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::interfaces::IOpen62541;
+using nodesetexporter::open62541::UATypesContainer;
+using nodesetexporter::open62541::quirks::DetectQuirkFixers;
+using nodesetexporter::open62541::quirks::kepserver_quirk_fixer_name;
+using nodesetexporter::open62541::quirks::MakeQuirkFixer;
+using nodesetexporter::open62541::quirks::StatusResults;
+
+TEST_LOGGER_INIT
+
+namespace
+{
+UATypesContainer<UA_ReferenceDescription> MakeReference(const UA_NodeId& reference_type_id, const UA_ExpandedNodeId& target, bool is_forward)
+{
+    UATypesContainer<UA_ReferenceDescription> ref(UA_TYPES_REFERENCEDESCRIPTION);
+    UA_NodeId_copy(&reference_type_id, &ref.GetRef().referenceTypeId);
+    UA_ExpandedNodeId_copy(&target, &ref.GetRef().nodeId);
+    ref.GetRef().isForward = is_forward;
+    return ref;
+}
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-const-cast)
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::quirks::KepServerQuirkFixer")
+    {
+        Logger logger("test");
+        auto quirk_fixer = MakeQuirkFixer(kepserver_quirk_fixer_name, logger);
+        REQUIRE(quirk_fixer);
+        CHECK_EQ(quirk_fixer->GetName(), kepserver_quirk_fixer_name);
+        CHECK_FALSE(MakeQuirkFixer("unknown", logger));
+
+        const auto has_type_definition = UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION);
+        const auto has_component = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+        const UATypesContainer<UA_ExpandedNodeId> tag(UA_EXPANDEDNODEID_STRING(2, const_cast<char*>("Channel1.Device1.Tag1")), UA_TYPES_EXPANDEDNODEID);
+        const UATypesContainer<UA_ExpandedNodeId> channel(UA_EXPANDEDNODEID_STRING(2, const_cast<char*>("Channel1")), UA_TYPES_EXPANDEDNODEID);
+        const UATypesContainer<UA_ExpandedNodeId> device(UA_EXPANDEDNODEID_STRING(2, const_cast<char*>("Channel1.Device1")), UA_TYPES_EXPANDEDNODEID);
+        const UATypesContainer<UA_ExpandedNodeId> numeric(UA_EXPANDEDNODEID_NUMERIC(2, 1000), UA_TYPES_EXPANDEDNODEID); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+        SUBCASE("The abstract type definition is replaced, the inverse references are built from the string identifiers")
+        {
+            std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res{tag, channel, device};
+            node_references_req_res.at(0).references.push_back(MakeReference(has_type_definition, UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_BASEVARIABLETYPE), true));
+            node_references_req_res.at(1).references.push_back(MakeReference(has_component, device.GetRef(), true));
+            // The node with the inverse reference is not changed.
+            node_references_req_res.at(2).references.push_back(MakeReference(has_component, channel.GetRef(), false));
+
+            REQUIRE_EQ(quirk_fixer->FixReferences(node_references_req_res), StatusResults::Good);
+
+            const auto& tag_refs = node_references_req_res.at(0).references;
+            REQUIRE_EQ(tag_refs.size(), 2);
+            CHECK_EQ(tag_refs.at(0).GetRef().nodeId.nodeId.identifier.numeric, UA_NS0ID_BASEDATAVARIABLETYPE); // NOLINT(cppcoreguidelines-pro-type-union-access)
+            CHECK_FALSE(tag_refs.at(1).GetRef().isForward);
+            CHECK(UA_NodeId_equal(&tag_refs.at(1).GetRef().referenceTypeId, &has_component));
+            CHECK(UA_ExpandedNodeId_equal(&tag_refs.at(1).GetRef().nodeId, &device.GetRef()));
+
+            const auto& channel_refs = node_references_req_res.at(1).references;
+            REQUIRE_EQ(channel_refs.size(), 2);
+            const auto objects_folder = UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+            CHECK(UA_ExpandedNodeId_equal(&channel_refs.at(1).GetRef().nodeId, &objects_folder));
+
+            CHECK_EQ(node_references_req_res.at(2).references.size(), 1);
+        }
+
+        SUBCASE("The inverse reference can't be built without the string identifier")
+        {
+            std::vector<IOpen62541::NodeReferencesRequestResponse> node_references_req_res{numeric};
+            node_references_req_res.at(0).references.push_back(MakeReference(has_component, tag.GetRef(), true));
+            CHECK_EQ(quirk_fixer->FixReferences(node_references_req_res), StatusResults::Fail);
+        }
+    }
+
+    TEST_CASE("nodesetexporter::open62541::quirks::DetectQuirkFixers")
+    {
+        UA_BuildInfo build_info;
+        UA_BuildInfo_init(&build_info);
+        CHECK(DetectQuirkFixers(build_info).empty());
+
+        build_info.productName = UA_STRING(const_cast<char*>("open62541 OPC UA Server"));
+        build_info.manufacturerName = UA_STRING(const_cast<char*>("open62541"));
+        CHECK(DetectQuirkFixers(build_info).empty());
+
+        build_info.productName = UA_STRING(const_cast<char*>("KEPServerEX"));
+        CHECK_EQ(DetectQuirkFixers(build_info), std::vector<std::string>{std::string(kepserver_quirk_fixer_name)});
+
+        build_info.productName = UA_STRING(const_cast<char*>("ThingWorx Kepware Server"));
+        CHECK_EQ(DetectQuirkFixers(build_info), std::vector<std::string>{std::string(kepserver_quirk_fixer_name)});
+    }
+}
+// NOLINTEND(cppcoreguidelines-pro-type-const-cast)
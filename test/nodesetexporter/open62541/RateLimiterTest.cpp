@@ -0,0 +1,167 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/RateLimiter.h"
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::open62541::ratelimit::Clock;
+using nodesetexporter::open62541::ratelimit::RateLimiter;
+using nodesetexporter::open62541::ratelimit::RateLimits;
+using nodesetexporter::open62541::ratelimit::Service;
+using namespace std::literals;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::ratelimit::RateLimiter")
+    {
+        const auto start = Clock::now();
+
+        SUBCASE("Without the limits the requests are not delayed")
+        {
+            RateLimiter limiter(RateLimits{}, start);
+            CHECK_FALSE(limiter.IsEnabled());
+            for (size_t index = 0; index < 1000; ++index)
+            {
+                CHECK_EQ(limiter.Acquire(1000, start), Clock::duration::zero());
+                limiter.OnResponse(Service::Read, 1000, 10ms, 1U << 20U, start);
+            }
+        }
+
+        SUBCASE("The requests per second: the burst of one second, then the rate")
+        {
+            RateLimiter limiter(RateLimits{10, 0, 0, false}, start);
+            for (size_t index = 0; index < 10; ++index)
+            {
+                CHECK_EQ(limiter.Acquire(1, start), Clock::duration::zero());
+            }
+            CHECK_EQ(limiter.Acquire(1, start), std::chrono::duration_cast<Clock::duration>(100ms));
+            // The waited request is paid, the next one waits for its own token.
+            CHECK_EQ(limiter.Acquire(1, start + 100ms), std::chrono::duration_cast<Clock::duration>(100ms));
+            CHECK_EQ(limiter.Acquire(1, start + 2s), Clock::duration::zero());
+        }
+
+        SUBCASE("The operations per second: the large request is allowed, the debt delays the next one")
+        {
+            RateLimiter limiter(RateLimits{0, 100, 0, false}, start);
+            CHECK_EQ(limiter.Acquire(50, start), Clock::duration::zero());
+            CHECK_EQ(limiter.Acquire(100, start), std::chrono::duration_cast<Clock::duration>(500ms));
+            CHECK_EQ(limiter.Acquire(0, start + 500ms), Clock::duration::zero());
+        }
+
+        SUBCASE("The bytes per second are taken by the responses")
+        {
+            RateLimiter limiter(RateLimits{0, 0, 1000, false}, start);
+            CHECK(limiter.IsBytesLimited());
+            CHECK_EQ(limiter.Acquire(1, start), Clock::duration::zero());
+            limiter.OnResponse(Service::Read, 1, 1ms, 3000, start);
+            CHECK_EQ(limiter.Acquire(1, start), std::chrono::duration_cast<Clock::duration>(2s));
+            CHECK_EQ(limiter.Acquire(1, start + 2s), Clock::duration::zero());
+        }
+
+        SUBCASE("The adaptive mode reduces the rate when the latency grows and restores it gradually")
+        {
+            RateLimiter limiter(RateLimits{0, 0, 0, true}, start);
+            CHECK(limiter.IsEnabled());
+            auto now = start;
+            for (size_t index = 0; index < 10; ++index)
+            {
+                CHECK_EQ(limiter.Acquire(1, now), Clock::duration::zero());
+                limiter.OnResponse(Service::Read, 100, 20ms, 0, now);
+                now += 20ms;
+            }
+            CHECK_EQ(limiter.GetThrottleFactor(), 1.0);
+
+            // The server is saturated.
+            for (size_t index = 0; index < 20; ++index)
+            {
+                limiter.OnResponse(Service::Read, 100, 500ms, 0, now);
+                now += 500ms;
+            }
+            const auto saturated_factor = limiter.GetThrottleFactor();
+            CHECK_LT(saturated_factor, 1.0);
+            // The pause after the response is proportional to the latency.
+            CHECK_GT(limiter.Acquire(1, now - 500ms), Clock::duration::zero());
+
+            // The server is not saturated again.
+            for (size_t index = 0; index < 100; ++index)
+            {
+                limiter.OnResponse(Service::Read, 100, 20ms, 0, now);
+                now += 1s;
+            }
+            CHECK_EQ(limiter.GetThrottleFactor(), 1.0);
+            CHECK_EQ(limiter.Acquire(1, now), Clock::duration::zero());
+        }
+
+        SUBCASE("The latency is compared with the requests of the same service and of the similar number of the operations")
+        {
+            RateLimiter limiter(RateLimits{0, 0, 0, true}, start);
+            auto now = start;
+            // The single values are read fast, the batches and the browsing of the many nodes are slower, but the server is not saturated.
+            for (size_t index = 0; index < 50; ++index)
+            {
+                limiter.OnResponse(Service::Read, 1, 1ms, 0, now);
+                limiter.OnResponse(Service::Read, 500, 80ms, 0, now);
+                limiter.OnResponse(Service::Browse, 100, 40ms, 0, now);
+                limiter.OnResponse(Service::BrowseNext, 1, 30ms, 0, now);
+                now += 100ms;
+            }
+            CHECK_EQ(limiter.GetThrottleFactor(), 1.0);
+
+            // The batches of the same size become slower.
+            for (size_t index = 0; index < 10; ++index)
+            {
+                limiter.OnResponse(Service::Read, 400, 800ms, 0, now);
+                now += 1s;
+            }
+            CHECK_LT(limiter.GetThrottleFactor(), 1.0);
+        }
+
+        SUBCASE("The rate is restored by the time without the saturation, not by the number of the responses")
+        {
+            RateLimiter limiter(RateLimits{0, 0, 0, true}, start);
+            limiter.OnServerOverload(start);
+            REQUIRE_EQ(limiter.GetThrottleFactor(), 0.5);
+            // The many fast responses within one second.
+            for (size_t index = 1; index <= 100; ++index)
+            {
+                limiter.OnResponse(Service::Read, 1, 1ms, 0, start + 10ms * index);
+            }
+            CHECK_EQ(limiter.GetThrottleFactor(), doctest::Approx(0.5 + nodesetexporter::open62541::ratelimit::throttle_factor_increase_per_second));
+            limiter.OnResponse(Service::Read, 1, 1ms, 0, start + 5s);
+            CHECK_EQ(limiter.GetThrottleFactor(), doctest::Approx(0.5 + 5 * nodesetexporter::open62541::ratelimit::throttle_factor_increase_per_second));
+            limiter.OnResponse(Service::Read, 1, 1ms, 0, start + 9s);
+            CHECK_EQ(limiter.GetThrottleFactor(), 1.0);
+        }
+
+        SUBCASE("The overload of the server halves the rate not more often than once per interval")
+        {
+            RateLimiter limiter(RateLimits{100, 0, 0, true}, start);
+            limiter.OnServerOverload(start);
+            CHECK_EQ(limiter.GetThrottleFactor(), 0.5);
+            limiter.OnServerOverload(start + 100ms);
+            CHECK_EQ(limiter.GetThrottleFactor(), 0.5);
+            limiter.OnServerOverload(start + 1s);
+            CHECK_EQ(limiter.GetThrottleFactor(), 0.25);
+            for (size_t index = 0; index < 100; ++index)
+            {
+                limiter.OnServerOverload(start + 1s * (2 + index));
+            }
+            CHECK_EQ(limiter.GetThrottleFactor(), nodesetexporter::open62541::ratelimit::min_throttle_factor);
+        }
+
+        SUBCASE("Without the adaptive mode the overload of the server is not accounted")
+        {
+            RateLimiter limiter(RateLimits{100, 0, 0, false}, start);
+            limiter.OnServerOverload(start);
+            CHECK_EQ(limiter.GetThrottleFactor(), 1.0);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
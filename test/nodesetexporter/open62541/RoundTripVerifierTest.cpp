@@ -0,0 +1,154 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/RoundTripVerifier.h"
+#include "LogMacro.h"
+#include "nodesetexporter/NodesetExporter.h"
+#include "nodesetexporter/common/Statuses.h"
+#include "nodesetexporter/open62541/NodesetFileWrappers.h"
+#include "nodesetexporter/open62541/UATypesContainer.h"
+
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+TEST_LOGGER_INIT
+
+using StatusResults = ::nodesetexporter::common::statuses::StatusResults<>;
+using nodesetexporter::ExportNodesetFromNodesetFile;
+using nodesetexporter::open62541::Open62541NodesetFileWrapper;
+using nodesetexporter::open62541::RoundTripVerifier;
+using nodesetexporter::open62541::UATypesContainer;
+
+// The data source. The variable "excluded" is not exported, the reference to it from the object is filtered out by the export.
+constexpr auto source_nodeset = R"(<?xml version="1.0" encoding="utf-8"?>
+<UANodeSet xmlns:uax="http://opcfoundation.org/UA/2008/02/Types.xsd" xmlns="http://opcfoundation.org/UA/2011/03/UANodeSet.xsd">
+  <NamespaceUris>
+    <Uri>http://test/roundtrip/1</Uri>
+  </NamespaceUris>
+  <Aliases>
+    <Alias Alias="Double">i=11</Alias>
+    <Alias Alias="HasComponent">i=47</Alias>
+    <Alias Alias="HasTypeDefinition">i=40</Alias>
+    <Alias Alias="Organizes">i=35</Alias>
+  </Aliases>
+  <UAObject NodeId="ns=1;i=1" BrowseName="1:Device">
+    <DisplayName>Device</DisplayName>
+    <References>
+      <Reference ReferenceType="Organizes" IsForward="false">i=85</Reference>
+      <Reference ReferenceType="HasTypeDefinition">i=58</Reference>
+      <Reference ReferenceType="HasComponent">ns=1;i=2</Reference>
+      <Reference ReferenceType="HasComponent">ns=1;i=3</Reference>
+    </References>
+  </UAObject>
+  <UAVariable NodeId="ns=1;i=2" BrowseName="1:temperature" DataType="Double" AccessLevel="3">
+    <DisplayName>temperature</DisplayName>
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+    </References>
+    <Value>
+      <uax:Double>45.5</uax:Double>
+    </Value>
+  </UAVariable>
+  <UAVariable NodeId="ns=1;i=3" BrowseName="1:excluded" DataType="Double">
+    <DisplayName>excluded</DisplayName>
+    <References>
+      <Reference ReferenceType="HasTypeDefinition">i=63</Reference>
+    </References>
+  </UAVariable>
+</UANodeSet>)";
+
+} // namespace
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::RoundTripVerifier") // NOLINT
+    {
+        Logger logger("test");
+        Open62541NodesetFileWrapper source(logger);
+        REQUIRE_EQ(source.LoadFromMemory(source_nodeset), StatusResults::Good);
+
+        const UATypesContainer<UA_ExpandedNodeId> object_id(UA_EXPANDEDNODEID("ns=1;i=1"), UA_TYPES_EXPANDEDNODEID);
+        const UATypesContainer<UA_ExpandedNodeId> variable_id(UA_EXPANDEDNODEID("ns=1;i=2"), UA_TYPES_EXPANDEDNODEID);
+        const UATypesContainer<UA_ExpandedNodeId> excluded_id(UA_EXPANDEDNODEID("ns=1;i=3"), UA_TYPES_EXPANDEDNODEID);
+        const std::vector<UATypesContainer<UA_ExpandedNodeId>> node_ids{object_id, variable_id};
+
+        std::stringstream out_buffer;
+        nodesetexporter::Options opt;
+        opt.logger = logger;
+        std::map<std::string, std::vector<UATypesContainer<UA_ExpandedNodeId>>> node_ids_export{{"ns=1;i=1", node_ids}};
+        REQUIRE_EQ(ExportNodesetFromNodesetFile(source, node_ids_export, "", out_buffer, opt), StatusResults::Good);
+        auto document = out_buffer.str();
+
+        RoundTripVerifier verifier(source, logger, 1); // One node in the batch, so that the batches are checked too.
+        const auto print_mismatches = [&verifier]
+        {
+            for (const auto& mismatch : verifier.GetMismatches())
+            {
+                MESSAGE(mismatch.node_id, ": ", mismatch.description);
+            }
+        };
+
+        SUBCASE("The unloading is identical to the data source")
+        {
+            REQUIRE_EQ(verifier.VerifyDocument(document, node_ids), StatusResults::Good);
+            print_mismatches();
+            CHECK_EQ(verifier.GetNumberOfMismatches(), 0);
+            CHECK_EQ(verifier.GetNumberOfComparedNodes(), 2);
+            CHECK_EQ(verifier.GetNumberOfFilteredReferences(), 1); // Device --> excluded
+
+            std::vector<std::string> phases;
+            for (const auto& timing : verifier.GetPhaseTimings())
+            {
+                MESSAGE(timing.phase, ": ", timing.duration.count(), " ms");
+                phases.push_back(timing.phase);
+            }
+            CHECK_EQ(phases, std::vector<std::string>{"load", "read original", "read re-imported", "diff"});
+        }
+
+        SUBCASE("The attribute is changed in the unloading")
+        {
+            const auto position = document.find(">temperature<");
+            REQUIRE_NE(position, std::string::npos);
+            document.replace(position, std::string(">temperature<").size(), ">changed<");
+            REQUIRE_EQ(verifier.VerifyDocument(document, node_ids), StatusResults::Good);
+            print_mismatches();
+            REQUIRE_EQ(verifier.GetNumberOfMismatches(), 1);
+            CHECK_EQ(verifier.GetMismatches().at(0).node_id, variable_id.ToString());
+            CHECK_NE(verifier.GetMismatches().at(0).description.find("DisplayName"), std::string::npos);
+        }
+
+        SUBCASE("The node is missing in the unloading")
+        {
+            const std::vector<UATypesContainer<UA_ExpandedNodeId>> expected_node_ids{object_id, variable_id, excluded_id};
+            REQUIRE_EQ(verifier.VerifyDocument(document, expected_node_ids), StatusResults::Good);
+            print_mismatches();
+            // The node itself and the reference to it, which is now expected in the unloading.
+            REQUIRE_EQ(verifier.GetNumberOfMismatches(), 2);
+            CHECK_EQ(verifier.GetNumberOfFilteredReferences(), 0);
+            bool is_node_missing = false;
+            bool is_reference_lost = false;
+            for (const auto& mismatch : verifier.GetMismatches())
+            {
+                is_node_missing |= mismatch.node_id == excluded_id.ToString() && mismatch.description.find("missing") != std::string::npos;
+                is_reference_lost |= mismatch.node_id == object_id.ToString() && mismatch.description.find("reference is lost") != std::string::npos;
+            }
+            CHECK(is_node_missing);
+            CHECK(is_reference_lost);
+        }
+
+        SUBCASE("The unloading can't be loaded")
+        {
+            CHECK_EQ(verifier.VerifyDocument("<UANodeSet", node_ids), StatusResults::Fail);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/SecurityProfile.h"
+#include "LogMacro.h"
+
+#include <doctest/doctest.h>
+
+using nodesetexporter::open62541::security::ApplySecurityProfile;
+using nodesetexporter::open62541::security::CryptoOverhead;
+using nodesetexporter::open62541::security::MeasureCryptoOverhead;
+using nodesetexporter::open62541::security::SecurityModeFromName;
+using nodesetexporter::open62541::security::SecurityPolicyUriFromName;
+using nodesetexporter::open62541::security::SecurityProfile;
+using nodesetexporter::open62541::security::StatusResults;
+
+TEST_LOGGER_INIT
+
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::security - names of the policies and the modes")
+    {
+        CHECK_EQ(SecurityPolicyUriFromName("Basic256Sha256"), "http://opcfoundation.org/UA/SecurityPolicy#Basic256Sha256");
+        CHECK_EQ(SecurityPolicyUriFromName("Aes256_Sha256_RsaPss"), "http://opcfoundation.org/UA/SecurityPolicy#Aes256_Sha256_RsaPss");
+        CHECK_FALSE(SecurityPolicyUriFromName("Basic512").has_value());
+
+        CHECK_EQ(SecurityModeFromName("None"), UA_MESSAGESECURITYMODE_NONE);
+        CHECK_EQ(SecurityModeFromName("Sign"), UA_MESSAGESECURITYMODE_SIGN);
+        CHECK_EQ(SecurityModeFromName("SignAndEncrypt"), UA_MESSAGESECURITYMODE_SIGNANDENCRYPT);
+        CHECK_FALSE(SecurityModeFromName("signandencrypt").has_value());
+    }
+
+    TEST_CASE("nodesetexporter::open62541::security - applying of the profile")
+    {
+        Logger logger("test");
+        UA_Client* client = UA_Client_new();
+        REQUIRE_NE(client, nullptr);
+        auto* config = UA_Client_getConfig(client);
+
+        SUBCASE("The security mode None gives the default configuration, the crypto overhead is not measured")
+        {
+            REQUIRE_EQ(ApplySecurityProfile(*config, SecurityProfile{}, logger), StatusResults::Good);
+            CHECK_EQ(config->securityMode, UA_MESSAGESECURITYMODE_NONE);
+            CryptoOverhead overhead;
+            CHECK_EQ(MeasureCryptoOverhead(*config, 1U << 16U, overhead), StatusResults::Fail);
+        }
+
+        SUBCASE("The secured channel requires the certificate and the key")
+        {
+            SecurityProfile profile;
+            profile.security_mode = UA_MESSAGESECURITYMODE_SIGNANDENCRYPT;
+            profile.security_policy_uri = *SecurityPolicyUriFromName("Basic256Sha256");
+            profile.certificate_file = "missing_client_cert.der";
+            profile.private_key_file = "missing_client_key.der";
+            CHECK_EQ(ApplySecurityProfile(*config, profile, logger), StatusResults::Fail);
+        }
+
+        UA_Client_delete(client);
+    }
+}
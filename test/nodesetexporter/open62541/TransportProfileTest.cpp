@@ -0,0 +1,406 @@
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright 2024 (c) Aleksander Rozhkov <aleksprog@hotmail.com>
+//
+
+#include "nodesetexporter/open62541/TransportProfile.h"
+
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <doctest/doctest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using nodesetexporter::open62541::transport::ApplyTransportProfile;
+using nodesetexporter::open62541::transport::DeriveNumberOfMaxNodesToRequestData;
+using nodesetexporter::open62541::transport::ReadRequestLimits;
+using nodesetexporter::open62541::transport::RequestLimits;
+using nodesetexporter::open62541::transport::StatusResults;
+using nodesetexporter::open62541::transport::TransportProfile;
+using namespace std::literals;
+
+namespace
+{
+
+// The send buffer of the test server, it is smaller than the receive buffer of the client, so the server acknowledges the smaller chunks.
+constexpr UA_UInt32 server_buffer_size = 16384;
+constexpr UA_UInt16 server_port = 4842;
+constexpr uint16_t proxy_port = 4843;
+
+/**
+ * @brief The server with the small buffers of the connection, it is run in the thread while the object exists.
+ */
+class SmallBufferServer // NOLINT(cppcoreguidelines-special-member-functions)
+{
+public:
+    SmallBufferServer()
+    {
+        UA_ServerConfig config{};
+        REQUIRE_EQ(UA_ServerConfig_setMinimalCustomBuffer(&config, server_port, nullptr, server_buffer_size, server_buffer_size), UA_STATUSCODE_GOOD);
+        m_server = UA_Server_newWithConfig(&config);
+        REQUIRE_NE(m_server, nullptr);
+        REQUIRE_EQ(UA_Server_run_startup(m_server), UA_STATUSCODE_GOOD);
+        m_thread = std::thread(
+            [this]
+            {
+                while (m_is_running)
+                {
+                    UA_Server_run_iterate(m_server, true);
+                }
+            });
+    }
+
+    ~SmallBufferServer()
+    {
+        m_is_running = false;
+        m_thread.join();
+        UA_Server_run_shutdown(m_server);
+        UA_Server_delete(m_server);
+    }
+
+private:
+    UA_Server* m_server = nullptr;
+    std::atomic_bool m_is_running{true};
+    std::thread m_thread;
+};
+
+/**
+ * @brief The TCP proxy between the client and the server, which delays the data in both directions, emulating the network with the latency.
+ */
+class LatencyProxy // NOLINT(cppcoreguidelines-special-member-functions)
+{
+public:
+    LatencyProxy(uint16_t listen_port, uint16_t target_port, std::chrono::milliseconds latency)
+        : m_target_port(target_port),
+          m_latency(latency),
+          m_listen_socket(socket(AF_INET, SOCK_STREAM, 0))
+    {
+        REQUIRE_GE(m_listen_socket, 0);
+        int reuse = 1;
+        setsockopt(m_listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        auto address = LocalAddress(listen_port);
+        REQUIRE_EQ(bind(m_listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        REQUIRE_EQ(listen(m_listen_socket, SOMAXCONN), 0);
+        m_accept_thread = std::thread([this] { Accept(); });
+    }
+
+    ~LatencyProxy()
+    {
+        m_is_stopped = true;
+        shutdown(m_listen_socket, SHUT_RDWR);
+        m_accept_thread.join();
+        close(m_listen_socket);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto socket : m_sockets)
+        {
+            shutdown(socket, SHUT_RDWR);
+        }
+        for (auto& thread : m_forward_threads)
+        {
+            thread.join();
+        }
+        for (const auto socket : m_sockets)
+        {
+            close(socket);
+        }
+    }
+
+private:
+    static sockaddr_in LocalAddress(uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    void Accept()
+    {
+        while (!m_is_stopped)
+        {
+            const int client_socket = accept(m_listen_socket, nullptr, nullptr);
+            if (client_socket < 0)
+            {
+                return;
+            }
+            const int server_socket = socket(AF_INET, SOCK_STREAM, 0);
+            auto address = LocalAddress(m_target_port);
+            connect(server_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_sockets.push_back(client_socket);
+            m_sockets.push_back(server_socket);
+            m_forward_threads.emplace_back([this, client_socket, server_socket] { Forward(client_socket, server_socket); });
+            m_forward_threads.emplace_back([this, client_socket, server_socket] { Forward(server_socket, client_socket); });
+        }
+    }
+
+    // The data received during the delay is forwarded with the next portion, so each message of the request-response exchange is delayed once.
+    void Forward(int from_socket, int to_socket) const
+    {
+        std::array<char, 65536> buffer{}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        for (;;)
+        {
+            const auto size = recv(from_socket, buffer.data(), buffer.size(), 0);
+            if (size <= 0)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(m_latency);
+            for (ssize_t sent = 0; sent < size;)
+            {
+                const auto result = send(to_socket, buffer.data() + sent, static_cast<size_t>(size - sent), MSG_NOSIGNAL); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                if (result <= 0)
+                {
+                    return;
+                }
+                sent += result;
+            }
+        }
+        shutdown(to_socket, SHUT_WR);
+    }
+
+    uint16_t m_target_port;
+    std::chrono::milliseconds m_latency;
+    int m_listen_socket;
+    std::atomic_bool m_is_stopped{false};
+    std::thread m_accept_thread;
+    std::mutex m_mutex;
+    std::vector<int> m_sockets;
+    std::vector<std::thread> m_forward_threads;
+};
+
+UA_Client* NewClient(const TransportProfile& profile)
+{
+    UA_Client* client = UA_Client_new();
+    REQUIRE_NE(client, nullptr);
+    auto* config = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefault(config);
+    REQUIRE_EQ(ApplyTransportProfile(*config, profile), StatusResults::Good);
+    return client;
+}
+
+/**
+ * @brief Reading of the attributes of the variable node as the export reads them, for the number of the nodes in the requests of batch_size nodes.
+ * @return The number of the requests or 0 if a request failed.
+ */
+size_t ReadAttributesInBatches(UA_Client* client, size_t number_of_nodes, size_t batch_size)
+{
+    static constexpr std::array<UA_AttributeId, 13> variable_attributes{
+        UA_ATTRIBUTEID_BROWSENAME,
+        UA_ATTRIBUTEID_DISPLAYNAME,
+        UA_ATTRIBUTEID_DESCRIPTION,
+        UA_ATTRIBUTEID_WRITEMASK,
+        UA_ATTRIBUTEID_USERWRITEMASK,
+        UA_ATTRIBUTEID_DATATYPE,
+        UA_ATTRIBUTEID_VALUERANK,
+        UA_ATTRIBUTEID_ARRAYDIMENSIONS,
+        UA_ATTRIBUTEID_VALUE,
+        UA_ATTRIBUTEID_ACCESSLEVEL,
+        UA_ATTRIBUTEID_USERACCESSLEVEL,
+        UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
+        UA_ATTRIBUTEID_HISTORIZING};
+    static_assert(variable_attributes.size() == nodesetexporter::open62541::transport::estimated_attributes_per_node);
+    size_t number_of_requests = 0;
+    for (size_t offset = 0; offset < number_of_nodes; offset += batch_size)
+    {
+        std::vector<UA_ReadValueId> read_value_ids;
+        for (size_t index = offset; index < std::min(number_of_nodes, offset + batch_size); ++index)
+        {
+            for (const auto attribute_id : variable_attributes)
+            {
+                auto& read_value_id = read_value_ids.emplace_back();
+                UA_ReadValueId_init(&read_value_id);
+                read_value_id.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY);
+                read_value_id.attributeId = attribute_id;
+            }
+        }
+        UA_ReadRequest request;
+        UA_ReadRequest_init(&request);
+        request.nodesToRead = read_value_ids.data();
+        request.nodesToReadSize = read_value_ids.size();
+        auto response = UA_Client_Service_read(client, request);
+        const auto status = response.responseHeader.serviceResult;
+        UA_ReadResponse_clear(&response);
+        if (status != UA_STATUSCODE_GOOD)
+        {
+            return 0;
+        }
+        ++number_of_requests;
+    }
+    return number_of_requests;
+}
+
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+TEST_SUITE("nodesetexporter::open62541")
+{
+    TEST_CASE("nodesetexporter::open62541::transport")
+    {
+        UA_Client* client = UA_Client_new();
+        REQUIRE_NE(client, nullptr);
+        auto* config = UA_Client_getConfig(client);
+        UA_ClientConfig_setDefault(config);
+        const auto default_connection_config = config->localConnectionConfig;
+
+        SUBCASE("The profile sets the limits of the connection, the zero values leave the defaults")
+        {
+            TransportProfile profile;
+            profile.recv_buffer_size = 1U << 20U;
+            profile.max_chunk_count = 64;
+            REQUIRE_EQ(ApplyTransportProfile(*config, profile), StatusResults::Good);
+            CHECK_EQ(config->localConnectionConfig.recvBufferSize, 1U << 20U);
+            CHECK_EQ(config->localConnectionConfig.localMaxChunkCount, 64);
+            CHECK_EQ(config->localConnectionConfig.sendBufferSize, default_connection_config.sendBufferSize);
+            CHECK_EQ(config->localConnectionConfig.localMaxMessageSize, default_connection_config.localMaxMessageSize);
+        }
+
+        SUBCASE("The larger chunks are requested for the secured channel, if the size is not set")
+        {
+            config->securityMode = UA_MESSAGESECURITYMODE_SIGNANDENCRYPT;
+            REQUIRE_EQ(ApplyTransportProfile(*config, TransportProfile{}), StatusResults::Good);
+            CHECK_EQ(config->localConnectionConfig.recvBufferSize, nodesetexporter::open62541::transport::secured_channel_recv_buffer_size);
+
+            TransportProfile profile;
+            profile.recv_buffer_size = 1U << 16U;
+            REQUIRE_EQ(ApplyTransportProfile(*config, profile), StatusResults::Good);
+            CHECK_EQ(config->localConnectionConfig.recvBufferSize, 1U << 16U);
+        }
+
+        SUBCASE("The buffers smaller than the minimum chunk of the protocol are rejected")
+        {
+            TransportProfile profile;
+            profile.send_buffer_size = 4096;
+            CHECK_EQ(ApplyTransportProfile(*config, profile), StatusResults::Fail);
+            CHECK_EQ(config->localConnectionConfig.sendBufferSize, default_connection_config.sendBufferSize);
+        }
+
+        SUBCASE("The limits can't be read without the session")
+        {
+            RequestLimits limits;
+            CHECK_EQ(ReadRequestLimits(*client, limits), StatusResults::Fail);
+        }
+
+        UA_Client_delete(client);
+    }
+
+    TEST_CASE("nodesetexporter::open62541::transport - the limits negotiated with the server")
+    {
+        const SmallBufferServer server;
+        TransportProfile profile;
+        profile.recv_buffer_size = 1U << 20U;
+        profile.max_chunk_count = 4;
+        profile.socket_recv_buffer_size = 1U << 18U;
+        auto* client = NewClient(profile);
+        // The other client with the other profile does not change the profile of the first one.
+        auto* other_client = NewClient(TransportProfile{.recv_buffer_size = 1U << 16U, .max_chunk_count = 64});
+
+        REQUIRE_EQ(UA_Client_connect(client, "opc.tcp://localhost:4842"), UA_STATUSCODE_GOOD);
+        RequestLimits limits;
+        REQUIRE_EQ(ReadRequestLimits(*client, limits), StatusResults::Good);
+        // The server sends the chunks of its send buffer, not of the receive buffer of the client (1 MB * 4).
+        CHECK_GT(limits.max_message_size, 0U);
+        CHECK_LE(limits.max_message_size, server_buffer_size * 4);
+
+        SUBCASE("The limits are negotiated again after the reconnection")
+        {
+            REQUIRE_EQ(UA_Client_disconnect(client), UA_STATUSCODE_GOOD);
+            REQUIRE_EQ(UA_Client_connect(client, "opc.tcp://localhost:4842"), UA_STATUSCODE_GOOD);
+            RequestLimits reconnected_limits;
+            REQUIRE_EQ(ReadRequestLimits(*client, reconnected_limits), StatusResults::Good);
+            CHECK_EQ(reconnected_limits.max_message_size, limits.max_message_size);
+        }
+
+        SUBCASE("Each client has its own limits")
+        {
+            REQUIRE_EQ(UA_Client_connect(other_client, "opc.tcp://localhost:4842"), UA_STATUSCODE_GOOD);
+            RequestLimits other_limits;
+            REQUIRE_EQ(ReadRequestLimits(*other_client, other_limits), StatusResults::Good);
+            CHECK_LE(other_limits.max_message_size, server_buffer_size * 64);
+            CHECK_GT(other_limits.max_message_size, limits.max_message_size);
+        }
+
+        UA_Client_delete(other_client);
+        UA_Client_delete(client);
+    }
+
+    // The benchmark of the batches of the requests derived from the transport limits through the network with the latency. The times are printed,
+    // the checks compare the numbers of the requests, which define the time when the latency dominates.
+    TEST_CASE("nodesetexporter::open62541::transport - benchmark through the latency proxy")
+    {
+        constexpr size_t number_of_nodes = 400;
+        constexpr size_t small_batch_size = 10;
+        const SmallBufferServer server;
+        const LatencyProxy proxy(proxy_port, server_port, 5ms);
+
+        TransportProfile profile;
+        profile.max_chunk_count = 8;
+        auto* client = NewClient(profile);
+        REQUIRE_EQ(UA_Client_connect(client, "opc.tcp://localhost:4843"), UA_STATUSCODE_GOOD);
+        RequestLimits limits;
+        REQUIRE_EQ(ReadRequestLimits(*client, limits), StatusResults::Good);
+        const auto derived_batch_size = DeriveNumberOfMaxNodesToRequestData(limits);
+        REQUIRE_GT(derived_batch_size, small_batch_size);
+
+        const auto measure = [client](size_t batch_size, size_t& number_of_requests)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            number_of_requests = ReadAttributesInBatches(client, number_of_nodes, batch_size);
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        };
+        size_t small_batch_requests = 0;
+        const auto small_batch_time = measure(small_batch_size, small_batch_requests);
+        size_t derived_batch_requests = 0;
+        const auto derived_batch_time = measure(derived_batch_size, derived_batch_requests);
+        MESSAGE("Latency 5 ms, " + std::to_string(number_of_nodes) + " nodes. Batch of " + std::to_string(small_batch_size) + " nodes: " + std::to_string(small_batch_requests) +
+                " requests, " + std::to_string(small_batch_time.count()) + " ms.");
+        MESSAGE("Batch of " + std::to_string(derived_batch_size) + " nodes derived from the limits (max message size " + std::to_string(limits.max_message_size) +
+                "): " + std::to_string(derived_batch_requests) + " requests, " + std::to_string(derived_batch_time.count()) + " ms.");
+
+        // All the responses of the derived batches fit into the negotiated limits and the requests are much fewer.
+        CHECK_EQ(small_batch_requests, number_of_nodes / small_batch_size);
+        CHECK_GT(derived_batch_requests, 0U);
+        CHECK_LT(derived_batch_requests * 4, small_batch_requests);
+        CHECK_LT(derived_batch_time, small_batch_time);
+
+        UA_Client_delete(client);
+    }
+
+    TEST_CASE("nodesetexporter::open62541::transport::DeriveNumberOfMaxNodesToRequestData")
+    {
+        using nodesetexporter::open62541::transport::estimated_attributes_per_node;
+        using nodesetexporter::open62541::transport::estimated_response_bytes_per_node;
+
+        // No limits - the number of nodes is not limited.
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({0, 0}), 0);
+        // Only the operation limit of the server.
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({0, estimated_attributes_per_node * 100}), 100);
+        // Only the message size.
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({estimated_response_bytes_per_node * 200, 0}), 200);
+        // The smaller of the limits is used.
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({estimated_response_bytes_per_node * 200, estimated_attributes_per_node * 100}), 100);
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({estimated_response_bytes_per_node * 50, estimated_attributes_per_node * 100}), 50);
+        // At least one node per request.
+        CHECK_EQ(DeriveNumberOfMaxNodesToRequestData({1, 1}), 1);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)